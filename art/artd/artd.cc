@@ -43,6 +43,7 @@
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
 #include <type_traits>
 #include <unordered_set>
 #include <utility>
@@ -65,6 +66,7 @@
 #include "android/binder_interface_utils.h"
 #include "android/binder_manager.h"
 #include "android/binder_process.h"
+#include "arch/instruction_set.h"
 #include "base/compiler_filter.h"
 #include "base/file_magic.h"
 #include "base/file_utils.h"
@@ -79,6 +81,8 @@
 #include "base/zip_archive.h"
 #include "cmdline_types.h"
 #include "dex/dex_file_loader.h"
+#include "dexopt_budget.h"
+#include "dexopt_query_cache.h"
 #include "exec_utils.h"
 #include "file_utils.h"
 #include "fstab/fstab.h"
@@ -161,6 +165,80 @@ constexpr int kShortTimeoutSec = 60;  // 1 minute.
 // would take down the system server.
 constexpr int kLongTimeoutSec = 570;  // 9.5 minutes.
 
+// A rough estimate of the memory used by a dex2oat invocation for the background dexopt budget:
+// a fixed overhead plus an amount proportional to the size of the dex file, which is an upper
+// bound of the size of the compressed dex code.
+constexpr int64_t kDex2oatBaseMemoryBytes = 64 * MB;
+constexpr int64_t kDex2oatMemoryPerDexFileByte = 4;
+
+// Returns the identities of the files that the results of `getDexoptStatus` and `getDexoptNeeded`
+// depend on. Keep in sync with the files that `OatFileAssistant` looks at. Returns an error if they
+// cannot be determined, in which case the results must not be cached.
+Result<std::vector<FileIdentity>> GetDexoptQueryInputs(
+    const std::string& dex_file,
+    const std::string& instruction_set,
+    const std::optional<std::string>& class_loader_context,
+    const OatFileAssistantContext& ofa_context) {
+  InstructionSet isa = GetInstructionSetFromString(instruction_set.c_str());
+  if (isa == InstructionSet::kNone) {
+    return Errorf("Instruction set '{}' is invalid", instruction_set);
+  }
+
+  // The dex directory is included because `OatFileAssistant` checks whether it is writable.
+  std::vector<std::string> paths{dex_file, Dirname(dex_file), GetDmFilename(dex_file)};
+  std::string error_msg;
+  std::string odex_path;
+  if (!OatFileAssistant::DexLocationToOdexFilename(dex_file, isa, &odex_path, &error_msg)) {
+    return Error() << error_msg;
+  }
+  paths.push_back(GetVdexFilename(odex_path));
+  paths.push_back(ReplaceFileExtension(odex_path, "art"));
+  paths.push_back(std::move(odex_path));
+  std::string oat_path;
+  if (OatFileAssistant::DexLocationToOatFilename(
+          dex_file,
+          isa,
+          ofa_context.GetRuntimeOptions().deny_art_apex_data_files,
+          &oat_path,
+          &error_msg)) {
+    paths.push_back(GetVdexFilename(oat_path));
+    paths.push_back(ReplaceFileExtension(oat_path, "art"));
+    paths.push_back(std::move(oat_path));
+  }
+
+  if (class_loader_context.has_value()) {
+    std::unique_ptr<ClassLoaderContext> context =
+        ClassLoaderContext::Create(class_loader_context.value());
+    if (context == nullptr) {
+      return Errorf("Class loader context '{}' is invalid", class_loader_context.value());
+    }
+    std::string dex_dir = Dirname(dex_file);
+    for (const std::string& context_element : context->FlattenDexPaths()) {
+      paths.push_back(std::filesystem::path(dex_dir).append(context_element));
+    }
+  }
+
+  std::vector<FileIdentity> inputs;
+  inputs.reserve(paths.size());
+  for (const std::string& path : paths) {
+    inputs.push_back(GetFileIdentity(path));
+  }
+  return inputs;
+}
+
+// Returns the key of a dexopt query in `DexoptQueryCache` for the given arguments.
+std::string GetDexoptQueryKey(const std::string& instruction_set,
+                              const std::optional<std::string>& class_loader_context,
+                              const std::string& extra = "") {
+  // Use '\0' as the separator as it cannot appear in the arguments.
+  std::string key = instruction_set;
+  key += '\0';
+  key += class_loader_context.has_value() ? "+" + class_loader_context.value() : "-";
+  key += '\0';
+  key += extra;
+  return key;
+}
+
 std::optional<int64_t> GetSize(std::string_view path) {
   std::error_code ec;
   int64_t size = std::filesystem::file_size(path, ec);
@@ -568,6 +646,7 @@ ScopedAStatus Artd::deleteArtifacts(const ArtifactsPath& in_artifactsPath, int64
   RETURN_FATAL_IF_ARG_IS_PRE_REBOOT(in_artifactsPath, "artifactsPath");
 
   RawArtifactsPath path = OR_RETURN_FATAL(BuildArtifactsPath(in_artifactsPath));
+  InvalidateDexoptQueryCaches(in_artifactsPath.dexPath);
 
   *_aidl_return = 0;
   *_aidl_return += GetSizeAndDeleteFile(path.oat_path);
@@ -588,6 +667,20 @@ ScopedAStatus Artd::getDexoptStatus(const std::string& in_dexFile,
     return NonFatal("Failed to get runtime options: " + ofa_context.error().message());
   }
 
+  // The inputs are collected before opening the artifacts, so that the result is not cached if
+  // the artifacts change in between.
+  Result<std::vector<FileIdentity>> inputs = GetDexoptQueryInputs(
+      in_dexFile, in_instructionSet, in_classLoaderContext, *ofa_context.value());
+  std::string cache_key = GetDexoptQueryKey(in_instructionSet, in_classLoaderContext);
+  if (inputs.ok()) {
+    std::optional<GetDexoptStatusResult> cached_result =
+        dexopt_status_cache_.Get(in_dexFile, cache_key, inputs.value());
+    if (cached_result.has_value()) {
+      *_aidl_return = std::move(cached_result).value();
+      return ScopedAStatus::ok();
+    }
+  }
+
   std::unique_ptr<ClassLoaderContext> context;
   std::string error_msg;
   auto oat_file_assistant = OatFileAssistant::Create(in_dexFile,
@@ -618,6 +711,9 @@ ScopedAStatus Artd::getDexoptStatus(const std::string& in_dexFile,
   DCHECK(ignored_odex_status == "up-to-date" || ignored_odex_status == "apk-more-recent" ||
          ignored_odex_status == "io-error-no-oat");
 
+  if (inputs.ok()) {
+    dexopt_status_cache_.Put(in_dexFile, cache_key, std::move(inputs).value(), *_aidl_return);
+  }
   return ScopedAStatus::ok();
 }
 
@@ -919,6 +1015,13 @@ ndk::ScopedAStatus Artd::mergeProfiles(const std::vector<ProfilePath>& in_profil
                        props_->GetOrEmpty("dalvik.vm.bgdexopt.new-methods-percent"))
         .AddIf(in_options.forceMerge, "--force-merge-and-analyze")
         .AddIf(in_options.forBootImage, "--boot-image-merge");
+    if (in_options.forBootImage) {
+      // Boot image profiles are merged from the profiles of all apps, so use the threads that
+      // background dexopt would use.
+      args.AddIfNonEmpty("--merge-threads=%s",
+                         props_->GetOrEmpty("dalvik.vm.background-dex2oat-threads",
+                                            "dalvik.vm.dex2oat-threads"));
+    }
   }
 
   art_exec_args.Add("--keep-fds=%s", fd_logger.GetFds()).Add("--").Concat(std::move(args));
@@ -964,6 +1067,22 @@ ndk::ScopedAStatus Artd::getDexoptNeeded(const std::string& in_dexFile,
     return NonFatal("Failed to get runtime options: " + ofa_context.error().message());
   }
 
+  // See `getDexoptStatus`.
+  Result<std::vector<FileIdentity>> inputs = GetDexoptQueryInputs(
+      in_dexFile, in_instructionSet, in_classLoaderContext, *ofa_context.value());
+  std::string cache_key = GetDexoptQueryKey(
+      in_instructionSet,
+      in_classLoaderContext,
+      ART_FORMAT("{}:{}", in_compilerFilter, in_dexoptTrigger));
+  if (inputs.ok()) {
+    std::optional<GetDexoptNeededResult> cached_result =
+        dexopt_needed_cache_.Get(in_dexFile, cache_key, inputs.value());
+    if (cached_result.has_value()) {
+      *_aidl_return = std::move(cached_result).value();
+      return ScopedAStatus::ok();
+    }
+  }
+
   std::unique_ptr<ClassLoaderContext> context;
   std::string error_msg;
   auto oat_file_assistant = OatFileAssistant::Create(in_dexFile,
@@ -992,6 +1111,9 @@ ndk::ScopedAStatus Artd::getDexoptNeeded(const std::string& in_dexFile,
   }
   _aidl_return->hasDexCode = *has_dex_files;
 
+  if (inputs.ok()) {
+    dexopt_needed_cache_.Put(in_dexFile, cache_key, std::move(inputs).value(), *_aidl_return);
+  }
   return ScopedAStatus::ok();
 }
 
@@ -1181,6 +1303,23 @@ ndk::ScopedAStatus Artd::dexopt(
 
   art_exec_args.Add("--keep-fds=%s", fd_logger.GetFds()).Add("--").Concat(std::move(args));
 
+  // Background dexopt calls wait for the resources they need, if a budget is configured, so that
+  // ART Service can run many of them concurrently.
+  std::unique_ptr<DexoptBudget::Reservation> budget_reservation;
+  DexoptBudget* budget =
+      in_priorityClass <= PriorityClass::BACKGROUND ? GetBackgroundDexoptBudget() : nullptr;
+  if (budget != nullptr) {
+    uint64_t wait_start_ms = MilliTime();
+    budget_reservation = budget->Acquire(GetBackgroundDexoptCost(dex_st.st_size),
+                                         [&] { return cancellation_signal->IsCancelled(); });
+    if (budget_reservation == nullptr) {
+      _aidl_return->cancelled = true;
+      return ScopedAStatus::ok();
+    }
+    LOG(INFO) << ART_FORMAT("Waited {}ms for the background dexopt budget",
+                            MilliTime() - wait_start_ms);
+  }
+
   LOG(INFO) << "Running dex2oat: " << Join(art_exec_args.Get(), /*separator=*/" ")
             << "\nOpened FDs: " << fd_logger;
 
@@ -1223,6 +1362,7 @@ ndk::ScopedAStatus Artd::dexopt(
   for (std::string_view path : files_to_delete) {
     size_before_bytes += GetSize(path).value_or(0);
   }
+  InvalidateDexoptQueryCaches(in_dexFile);
   OR_RETURN_NON_FATAL(NewFile::CommitAllOrAbandon(files_to_commit, files_to_delete));
 
   _aidl_return->sizeBytes = size_bytes;
@@ -1309,6 +1449,7 @@ ScopedAStatus Artd::cleanup(const std::vector<ProfilePath>& in_profilesToKeep,
         ListRuntimeArtifactsFiles(android_data, android_expand, runtime_image_path);
     std::move(files.begin(), files.end(), std::inserter(files_to_keep, files_to_keep.end()));
   }
+  InvalidateAllDexoptQueryCaches();
   *_aidl_return = 0;
   for (const std::string& file : ListManagedFiles(android_data, android_expand)) {
     if (files_to_keep.find(file) == files_to_keep.end() &&
@@ -1541,6 +1682,7 @@ ScopedAStatus Artd::commitPreRebootStagedFiles(const std::vector<ArtifactsPath>&
                                                const std::vector<WritableProfilePath>& in_profiles,
                                                bool* _aidl_return) {
   RETURN_FATAL_IF_PRE_REBOOT(options_);
+  InvalidateAllDexoptQueryCaches();
 
   std::vector<std::pair<std::string, std::string>> files_to_move;
   std::vector<std::string> files_to_remove;
@@ -1718,6 +1860,55 @@ bool Artd::UseJitZygoteLocked() {
   return cached_use_jit_zygote_.value();
 }
 
+void Artd::InvalidateDexoptQueryCaches(const std::string& dex_file) {
+  dexopt_status_cache_.Invalidate(dex_file);
+  dexopt_needed_cache_.Invalidate(dex_file);
+}
+
+void Artd::InvalidateAllDexoptQueryCaches() {
+  dexopt_status_cache_.InvalidateAll();
+  dexopt_needed_cache_.InvalidateAll();
+}
+
+DexoptBudget* Artd::GetBackgroundDexoptBudget() {
+  std::lock_guard<std::mutex> lock(cache_mu_);
+  if (!cached_background_dexopt_budget_.has_value()) {
+    int64_t max_cpus = 0;
+    int64_t max_memory_mb = 0;
+    std::string cpu_budget = props_->GetOrEmpty("dalvik.vm.background-dex2oat-cpu-budget");
+    std::string memory_budget = props_->GetOrEmpty("dalvik.vm.background-dex2oat-memory-budget-mb");
+    if (!cpu_budget.empty() && !ParseInt(cpu_budget, &max_cpus, /*min=*/int64_t{0})) {
+      LOG(WARNING) << ART_FORMAT("Invalid background dex2oat CPU budget '{}'", cpu_budget);
+      max_cpus = 0;
+    }
+    if (!memory_budget.empty() && !ParseInt(memory_budget, &max_memory_mb, /*min=*/int64_t{0})) {
+      LOG(WARNING) << ART_FORMAT("Invalid background dex2oat memory budget '{}'", memory_budget);
+      max_memory_mb = 0;
+    }
+    cached_background_dexopt_budget_ =
+        (max_cpus > 0 || max_memory_mb > 0) ?
+            std::make_unique<DexoptBudget>(max_cpus, max_memory_mb * MB) :
+            nullptr;
+  }
+  return cached_background_dexopt_budget_->get();
+}
+
+DexoptBudget::Cost Artd::GetBackgroundDexoptCost(int64_t dex_file_size) {
+  // Keep in sync with `AddPerfConfigFlags`. Without an explicit number of threads, dex2oat uses
+  // one thread per CPU it can run on.
+  int64_t cpus = 0;
+  std::string threads =
+      props_->GetOrEmpty("dalvik.vm.background-dex2oat-threads", "dalvik.vm.dex2oat-threads");
+  if (!ParseInt(threads, &cpus, /*min=*/int64_t{1})) {
+    std::string cpu_set =
+        props_->GetOrEmpty("dalvik.vm.background-dex2oat-cpu-set", "dalvik.vm.dex2oat-cpu-set");
+    cpus = cpu_set.empty() ? static_cast<int64_t>(std::thread::hardware_concurrency()) :
+                             static_cast<int64_t>(Split(cpu_set, ",").size());
+  }
+  return {.cpus = cpus,
+          .memory_bytes = kDex2oatBaseMemoryBytes + dex_file_size * kDex2oatMemoryPerDexFileByte};
+}
+
 const std::string& Artd::GetUserDefinedBootImageLocations() {
   std::lock_guard<std::mutex> lock(cache_mu_);
   return GetUserDefinedBootImageLocationsLocked();
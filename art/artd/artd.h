@@ -38,12 +38,16 @@
 #include "aidl/com/android/server/art/BnArtd.h"
 #include "aidl/com/android/server/art/BnArtdCancellationSignal.h"
 #include "aidl/com/android/server/art/BnArtdNotification.h"
+#include "aidl/com/android/server/art/GetDexoptNeededResult.h"
+#include "aidl/com/android/server/art/GetDexoptStatusResult.h"
 #include "android-base/result.h"
 #include "android-base/thread_annotations.h"
 #include "android-base/unique_fd.h"
 #include "android/binder_auto_utils.h"
 #include "base/os.h"
 #include "base/pidfd.h"
+#include "dexopt_budget.h"
+#include "dexopt_query_cache.h"
 #include "exec_utils.h"
 #include "oat/oat_file_assistant_context.h"
 #include "tools/cmdline_builder.h"
@@ -311,6 +315,17 @@ class Artd : public aidl::com::android::server::art::BnArtd {
   bool DenyArtApexDataFiles() EXCLUDES(cache_mu_);
   bool DenyArtApexDataFilesLocked() REQUIRES(cache_mu_);
 
+  // Drops the cached query results of `dex_file`, or of all dex files. Must be called before
+  // writing or deleting artifacts.
+  void InvalidateDexoptQueryCaches(const std::string& dex_file);
+  void InvalidateAllDexoptQueryCaches();
+
+  // Returns the budget shared by background dexopt calls, or nullptr if none is configured.
+  DexoptBudget* GetBackgroundDexoptBudget() EXCLUDES(cache_mu_);
+
+  // Returns the estimated cost of a background dexopt call for a dex file of the given size.
+  DexoptBudget::Cost GetBackgroundDexoptCost(int64_t dex_file_size);
+
   android::base::Result<int> ExecAndReturnCode(const std::vector<std::string>& arg_vector,
                                                int timeout_sec,
                                                const ExecCallbacks& callbacks = ExecCallbacks(),
@@ -365,6 +380,11 @@ class Artd : public aidl::com::android::server::art::BnArtd {
   std::optional<bool> cached_use_jit_zygote_ GUARDED_BY(cache_mu_);
   std::optional<std::string> cached_user_defined_boot_image_locations_ GUARDED_BY(cache_mu_);
   std::optional<bool> cached_deny_art_apex_data_files_ GUARDED_BY(cache_mu_);
+  std::optional<std::unique_ptr<DexoptBudget>> cached_background_dexopt_budget_
+      GUARDED_BY(cache_mu_);
+
+  DexoptQueryCache<aidl::com::android::server::art::GetDexoptStatusResult> dexopt_status_cache_;
+  DexoptQueryCache<aidl::com::android::server::art::GetDexoptNeededResult> dexopt_needed_cache_;
 
   std::mutex ofa_context_mu_;
   std::unique_ptr<OatFileAssistantContext> ofa_context_ GUARDED_BY(ofa_context_mu_);
@@ -860,6 +860,23 @@ TEST_F(ArtdTest, dexoptPriorityClassBackground) {
   RunDexopt();
 }
 
+TEST_F(ArtdTest, dexoptPriorityClassBackgroundWithBudget) {
+  priority_class_ = PriorityClass::BACKGROUND;
+  EXPECT_CALL(*mock_props_, GetProperty("dalvik.vm.background-dex2oat-cpu-budget"))
+      .WillOnce(Return("4"));
+  EXPECT_CALL(*mock_props_, GetProperty("dalvik.vm.background-dex2oat-memory-budget-mb"))
+      .WillOnce(Return("512"));
+  EXPECT_CALL(*mock_props_, GetProperty("dalvik.vm.background-dex2oat-threads"))
+      .WillRepeatedly(Return("2"));
+  EXPECT_CALL(*mock_exec_utils_,
+              DoExecAndReturnCode(WhenSplitBy("--", _, Contains(Flag("-j", "2"))), _, _))
+      .Times(2)
+      .WillRepeatedly(Return(0));
+  // The budget is released when the call returns, so that the next call can use it.
+  RunDexopt();
+  RunDexopt();
+}
+
 TEST_F(ArtdTest, dexoptDexoptOptions) {
   dexopt_options_ = DexoptOptions{
       .compilationReason = "install",
@@ -2043,11 +2060,14 @@ TEST_F(ArtdTest, mergeProfilesWithOptionsForceMerge) {
 
   CreateFile(dex_file_);
 
+  EXPECT_CALL(*mock_props_, GetProperty("dalvik.vm.background-dex2oat-threads"))
+      .WillOnce(Return("4"));
   EXPECT_CALL(*mock_exec_utils_,
               DoExecAndReturnCode(WhenSplitBy("--",
                                               _,
                                               AllOf(Contains("--force-merge-and-analyze"),
-                                                    Contains("--boot-image-merge"))),
+                                                    Contains("--boot-image-merge"),
+                                                    Contains("--merge-threads=4"))),
                                   _,
                                   _))
       .WillOnce(Return(ProfmanResult::kCompile));
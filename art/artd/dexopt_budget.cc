@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dexopt_budget.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+namespace art {
+namespace artd {
+
+DexoptBudget::Reservation::~Reservation() { budget_->Release(cost_); }
+
+std::unique_ptr<DexoptBudget::Reservation> DexoptBudget::Acquire(
+    const Cost& cost, const std::function<bool()>& is_cancelled) {
+  std::unique_lock<std::mutex> lock(mu_);
+  const uint64_t ticket = next_ticket_++;
+  while (ticket != head_ticket_ || !FitsLocked(cost)) {
+    if (is_cancelled()) {
+      // Leave the queue. Jobs behind this one keep their order, as they only compare their own
+      // ticket with `head_ticket_`.
+      if (ticket == head_ticket_) {
+        ++head_ticket_;
+      } else {
+        cancelled_tickets_.insert(ticket);
+      }
+      SkipCancelledTicketsLocked();
+      cv_.notify_all();
+      return nullptr;
+    }
+    cv_.wait_for(lock, kCancellationCheckInterval);
+  }
+  ++head_ticket_;
+  SkipCancelledTicketsLocked();
+  ++running_jobs_;
+  used_cpus_ += cost.cpus;
+  used_memory_bytes_ += cost.memory_bytes;
+  // The next job in the queue may fit as well.
+  cv_.notify_all();
+  return std::unique_ptr<Reservation>(new Reservation(this, cost));
+}
+
+bool DexoptBudget::FitsLocked(const Cost& cost) {
+  if (running_jobs_ == 0) {
+    return true;
+  }
+  if (max_cpus_ > 0 && used_cpus_ + cost.cpus > max_cpus_) {
+    return false;
+  }
+  if (max_memory_bytes_ > 0 && used_memory_bytes_ + cost.memory_bytes > max_memory_bytes_) {
+    return false;
+  }
+  return true;
+}
+
+void DexoptBudget::SkipCancelledTicketsLocked() {
+  while (cancelled_tickets_.erase(head_ticket_) != 0) {
+    ++head_ticket_;
+  }
+}
+
+void DexoptBudget::Release(const Cost& cost) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    --running_jobs_;
+    used_cpus_ -= cost.cpus;
+    used_memory_bytes_ -= cost.memory_bytes;
+  }
+  cv_.notify_all();
+}
+
+}  // namespace artd
+}  // namespace art
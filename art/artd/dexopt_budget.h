@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_ARTD_DEXOPT_BUDGET_H_
+#define ART_ARTD_DEXOPT_BUDGET_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+#include "android-base/thread_annotations.h"
+
+namespace art {
+namespace artd {
+
+// Limits the CPUs and memory used by concurrent dex2oat invocations.
+//
+// ART Service decides how many dexopt calls run concurrently, without knowing how expensive each
+// of them is. A budget makes each call wait before running dex2oat until the resources it needs
+// are available, so a batch of apps can be dexopted with a high concurrency without overcommitting
+// the device when large apps are compiled together.
+//
+// Jobs are admitted in FIFO order, so that expensive jobs are not starved by cheap ones. A job is
+// always admitted when no other job is running, even if its cost exceeds the budget.
+class DexoptBudget {
+ public:
+  struct Cost {
+    int64_t cpus = 0;
+    int64_t memory_bytes = 0;
+  };
+
+  // The resources reserved for a job. They are returned to the budget on destruction.
+  class Reservation {
+   public:
+    ~Reservation();
+
+    Reservation(const Reservation&) = delete;
+    Reservation& operator=(const Reservation&) = delete;
+
+   private:
+    Reservation(DexoptBudget* budget, const Cost& cost) : budget_(budget), cost_(cost) {}
+
+    DexoptBudget* const budget_;
+    const Cost cost_;
+
+    friend class DexoptBudget;
+  };
+
+  // How often a waiting job checks whether it has been cancelled.
+  static constexpr std::chrono::milliseconds kCancellationCheckInterval{100};
+
+  // `max_cpus` and `max_memory_bytes` are the budgets. A non-positive value means unlimited.
+  DexoptBudget(int64_t max_cpus, int64_t max_memory_bytes)
+      : max_cpus_(max_cpus), max_memory_bytes_(max_memory_bytes) {}
+
+  // Waits until `cost` fits in the budget and reserves it. Returns nullptr if `is_cancelled`
+  // returns true while waiting.
+  std::unique_ptr<Reservation> Acquire(const Cost& cost, const std::function<bool()>& is_cancelled)
+      EXCLUDES(mu_);
+
+ private:
+  bool FitsLocked(const Cost& cost) REQUIRES(mu_);
+  void SkipCancelledTicketsLocked() REQUIRES(mu_);
+  void Release(const Cost& cost) EXCLUDES(mu_);
+
+  const int64_t max_cpus_;
+  const int64_t max_memory_bytes_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  int64_t running_jobs_ GUARDED_BY(mu_) = 0;
+  int64_t used_cpus_ GUARDED_BY(mu_) = 0;
+  int64_t used_memory_bytes_ GUARDED_BY(mu_) = 0;
+  // The ticket of the next job to arrive, and the ticket of the job at the head of the queue.
+  uint64_t next_ticket_ GUARDED_BY(mu_) = 0;
+  uint64_t head_ticket_ GUARDED_BY(mu_) = 0;
+  // The tickets of the jobs that were cancelled while waiting behind the head of the queue.
+  std::unordered_set<uint64_t> cancelled_tickets_ GUARDED_BY(mu_);
+};
+
+}  // namespace artd
+}  // namespace art
+
+#endif  // ART_ARTD_DEXOPT_BUDGET_H_
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dexopt_budget.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace art {
+namespace artd {
+namespace {
+
+using Cost = DexoptBudget::Cost;
+using Reservation = DexoptBudget::Reservation;
+
+constexpr auto kShortWait = std::chrono::milliseconds(200);
+
+bool NotCancelled() { return false; }
+
+TEST(DexoptBudgetTest, AcquireWithinBudget) {
+  DexoptBudget budget(/*max_cpus=*/4, /*max_memory_bytes=*/100);
+  std::unique_ptr<Reservation> r1 = budget.Acquire({.cpus = 2, .memory_bytes = 50}, NotCancelled);
+  std::unique_ptr<Reservation> r2 = budget.Acquire({.cpus = 2, .memory_bytes = 50}, NotCancelled);
+  EXPECT_NE(r1, nullptr);
+  EXPECT_NE(r2, nullptr);
+}
+
+TEST(DexoptBudgetTest, UnlimitedBudget) {
+  DexoptBudget budget(/*max_cpus=*/0, /*max_memory_bytes=*/0);
+  std::unique_ptr<Reservation> r1 = budget.Acquire({.cpus = 8, .memory_bytes = 1000}, NotCancelled);
+  std::unique_ptr<Reservation> r2 = budget.Acquire({.cpus = 8, .memory_bytes = 1000}, NotCancelled);
+  EXPECT_NE(r1, nullptr);
+  EXPECT_NE(r2, nullptr);
+}
+
+TEST(DexoptBudgetTest, AlwaysAdmitsSingleJob) {
+  DexoptBudget budget(/*max_cpus=*/4, /*max_memory_bytes=*/100);
+  EXPECT_NE(budget.Acquire({.cpus = 8, .memory_bytes = 200}, NotCancelled), nullptr);
+}
+
+TEST(DexoptBudgetTest, WaitsForCpus) {
+  DexoptBudget budget(/*max_cpus=*/4, /*max_memory_bytes=*/0);
+  std::unique_ptr<Reservation> r1 = budget.Acquire({.cpus = 3}, NotCancelled);
+  std::atomic<bool> acquired = false;
+  std::thread thread([&] {
+    std::unique_ptr<Reservation> r2 = budget.Acquire({.cpus = 2}, NotCancelled);
+    acquired = true;
+  });
+  std::this_thread::sleep_for(kShortWait);
+  EXPECT_FALSE(acquired);
+  r1.reset();
+  thread.join();
+  EXPECT_TRUE(acquired);
+}
+
+TEST(DexoptBudgetTest, WaitsForMemory) {
+  DexoptBudget budget(/*max_cpus=*/0, /*max_memory_bytes=*/100);
+  std::unique_ptr<Reservation> r1 = budget.Acquire({.memory_bytes = 60}, NotCancelled);
+  std::atomic<bool> acquired = false;
+  std::thread thread([&] {
+    std::unique_ptr<Reservation> r2 = budget.Acquire({.memory_bytes = 60}, NotCancelled);
+    acquired = true;
+  });
+  std::this_thread::sleep_for(kShortWait);
+  EXPECT_FALSE(acquired);
+  r1.reset();
+  thread.join();
+  EXPECT_TRUE(acquired);
+}
+
+TEST(DexoptBudgetTest, FifoOrder) {
+  DexoptBudget budget(/*max_cpus=*/4, /*max_memory_bytes=*/0);
+  std::unique_ptr<Reservation> r1 = budget.Acquire({.cpus = 4}, NotCancelled);
+
+  std::unique_ptr<Reservation> r2;
+  std::atomic<bool> r2_acquired = false;
+  std::thread thread2([&] {
+    r2 = budget.Acquire({.cpus = 4}, NotCancelled);
+    r2_acquired = true;
+  });
+  std::this_thread::sleep_for(kShortWait);
+
+  // This job would fit next to r2, but must not overtake it.
+  std::atomic<bool> r3_acquired = false;
+  std::thread thread3([&] {
+    std::unique_ptr<Reservation> r3 = budget.Acquire({.cpus = 1}, NotCancelled);
+    r3_acquired = true;
+  });
+  std::this_thread::sleep_for(kShortWait);
+  EXPECT_FALSE(r2_acquired);
+  EXPECT_FALSE(r3_acquired);
+
+  r1.reset();
+  thread2.join();
+  EXPECT_TRUE(r2_acquired);
+  std::this_thread::sleep_for(kShortWait);
+  EXPECT_FALSE(r3_acquired);
+
+  r2.reset();
+  thread3.join();
+  EXPECT_TRUE(r3_acquired);
+}
+
+TEST(DexoptBudgetTest, CancelWhileWaiting) {
+  DexoptBudget budget(/*max_cpus=*/4, /*max_memory_bytes=*/0);
+  std::unique_ptr<Reservation> r1 = budget.Acquire({.cpus = 4}, NotCancelled);
+
+  std::atomic<bool> cancelled = false;
+  std::atomic<bool> r2_done = false;
+  std::thread thread2([&] {
+    EXPECT_EQ(budget.Acquire({.cpus = 4}, [&] { return cancelled.load(); }), nullptr);
+    r2_done = true;
+  });
+  std::this_thread::sleep_for(kShortWait);
+
+  // A job queued behind the cancelled one.
+  std::atomic<bool> r3_acquired = false;
+  std::thread thread3([&] {
+    std::unique_ptr<Reservation> r3 = budget.Acquire({.cpus = 4}, NotCancelled);
+    r3_acquired = true;
+  });
+  std::this_thread::sleep_for(kShortWait);
+
+  cancelled = true;
+  thread2.join();
+  EXPECT_TRUE(r2_done);
+  EXPECT_FALSE(r3_acquired);
+
+  r1.reset();
+  thread3.join();
+  EXPECT_TRUE(r3_acquired);
+}
+
+TEST(DexoptBudgetTest, CancelBehindHead) {
+  DexoptBudget budget(/*max_cpus=*/4, /*max_memory_bytes=*/0);
+  std::unique_ptr<Reservation> r1 = budget.Acquire({.cpus = 4}, NotCancelled);
+
+  std::atomic<bool> r2_acquired = false;
+  std::thread thread2([&] {
+    std::unique_ptr<Reservation> r2 = budget.Acquire({.cpus = 4}, NotCancelled);
+    r2_acquired = true;
+  });
+  std::this_thread::sleep_for(kShortWait);
+
+  std::atomic<bool> cancelled = false;
+  std::thread thread3([&] {
+    EXPECT_EQ(budget.Acquire({.cpus = 4}, [&] { return cancelled.load(); }), nullptr);
+  });
+  std::this_thread::sleep_for(kShortWait);
+
+  std::atomic<bool> r4_acquired = false;
+  std::thread thread4([&] {
+    std::unique_ptr<Reservation> r4 = budget.Acquire({.cpus = 4}, NotCancelled);
+    r4_acquired = true;
+  });
+  std::this_thread::sleep_for(kShortWait);
+
+  cancelled = true;
+  thread3.join();
+
+  r1.reset();
+  thread2.join();
+  EXPECT_TRUE(r2_acquired);
+  thread4.join();
+  EXPECT_TRUE(r4_acquired);
+}
+
+}  // namespace
+}  // namespace artd
+}  // namespace art
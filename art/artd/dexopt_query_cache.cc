@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dexopt_query_cache.h"
+
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <string>
+
+namespace art {
+namespace artd {
+
+namespace {
+
+int64_t TimespecToNs(const struct timespec& ts) {
+  return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<int64_t>(ts.tv_nsec);
+}
+
+}  // namespace
+
+FileIdentity GetFileIdentity(const std::string& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    return {};
+  }
+  return {
+      .exists = true,
+      .dev = st.st_dev,
+      .ino = st.st_ino,
+      .mode = st.st_mode,
+      .size = static_cast<int64_t>(st.st_size),
+      .mtime_ns = TimespecToNs(st.st_mtim),
+      .ctime_ns = TimespecToNs(st.st_ctim),
+  };
+}
+
+}  // namespace artd
+}  // namespace art
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_ARTD_DEXOPT_QUERY_CACHE_H_
+#define ART_ARTD_DEXOPT_QUERY_CACHE_H_
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "android-base/thread_annotations.h"
+
+namespace art {
+namespace artd {
+
+// The identity of a file, used to tell whether a file has changed since a query result was
+// computed. A file that does not exist has a default-constructed identity.
+struct FileIdentity {
+  bool exists = false;
+  dev_t dev = 0;
+  ino_t ino = 0;
+  mode_t mode = 0;
+  int64_t size = 0;
+  int64_t mtime_ns = 0;
+  int64_t ctime_ns = 0;
+
+  bool operator==(const FileIdentity&) const = default;
+};
+
+// Returns the identity of the file at `path`.
+FileIdentity GetFileIdentity(const std::string& path);
+
+// Caches the results of queries that inspect the dexopt artifacts of a dex file, such as
+// `getDexoptStatus` and `getDexoptNeeded`, which otherwise open and validate the oat and vdex
+// files on every call.
+//
+// A result is only returned if none of the files it was computed from has changed, according to
+// `FileIdentity`. In addition, artd invalidates the results of a dex file when it writes or deletes
+// its artifacts.
+//
+// This class is thread-safe.
+template <typename T>
+class DexoptQueryCache {
+ public:
+  // The maximum number of cached results, to bound the memory usage. In practice, there is one
+  // result per dex file, ISA and query.
+  static constexpr size_t kMaxEntries = 4096;
+
+  // Returns the result cached for `key` on `dex_file`, if it was computed from files with the
+  // identities `inputs`.
+  std::optional<T> Get(const std::string& dex_file,
+                       const std::string& key,
+                       const std::vector<FileIdentity>& inputs) EXCLUDES(mu_) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = entries_.find(dex_file);
+    if (it == entries_.end()) {
+      return std::nullopt;
+    }
+    auto entry_it = it->second.find(key);
+    if (entry_it == it->second.end() || entry_it->second.inputs != inputs) {
+      return std::nullopt;
+    }
+    return entry_it->second.result;
+  }
+
+  // Caches `result` for `key` on `dex_file`, computed from files with the identities `inputs`.
+  void Put(const std::string& dex_file,
+           const std::string& key,
+           std::vector<FileIdentity>&& inputs,
+           const T& result) EXCLUDES(mu_) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (num_entries_ >= kMaxEntries) {
+      return;
+    }
+    if (entries_[dex_file].insert_or_assign(key, Entry{std::move(inputs), result}).second) {
+      ++num_entries_;
+    }
+  }
+
+  // Drops the results of `dex_file`.
+  void Invalidate(const std::string& dex_file) EXCLUDES(mu_) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = entries_.find(dex_file);
+    if (it != entries_.end()) {
+      num_entries_ -= it->second.size();
+      entries_.erase(it);
+    }
+  }
+
+  // Drops all the results.
+  void InvalidateAll() EXCLUDES(mu_) {
+    std::lock_guard<std::mutex> lock(mu_);
+    entries_.clear();
+    num_entries_ = 0;
+  }
+
+ private:
+  struct Entry {
+    std::vector<FileIdentity> inputs;
+    T result;
+  };
+
+  std::mutex mu_;
+  // Keyed by dex file, then by query key.
+  std::unordered_map<std::string, std::unordered_map<std::string, Entry>> entries_ GUARDED_BY(mu_);
+  size_t num_entries_ GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace artd
+}  // namespace art
+
+#endif  // ART_ARTD_DEXOPT_QUERY_CACHE_H_
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dexopt_query_cache.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "android-base/file.h"
+#include "base/common_art_test.h"
+#include "gtest/gtest.h"
+
+namespace art {
+namespace artd {
+namespace {
+
+using ::android::base::WriteStringToFile;
+
+class DexoptQueryCacheTest : public CommonArtTest {
+ protected:
+  void SetUp() override {
+    CommonArtTest::SetUp();
+    scratch_dir_ = std::make_unique<ScratchDir>();
+    file_ = scratch_dir_->GetPath() + "file";
+  }
+
+  void TearDown() override {
+    scratch_dir_.reset();
+    CommonArtTest::TearDown();
+  }
+
+  std::unique_ptr<ScratchDir> scratch_dir_;
+  std::string file_;
+};
+
+TEST_F(DexoptQueryCacheTest, GetFileIdentity) {
+  EXPECT_FALSE(GetFileIdentity(file_).exists);
+  EXPECT_EQ(GetFileIdentity(file_), FileIdentity());
+
+  ASSERT_TRUE(WriteStringToFile("abc", file_));
+  FileIdentity identity = GetFileIdentity(file_);
+  EXPECT_TRUE(identity.exists);
+  EXPECT_EQ(identity.size, 3);
+  EXPECT_EQ(GetFileIdentity(file_), identity);
+
+  // Replacing the file changes its identity, even if it has the same content.
+  std::string new_file = file_ + ".new";
+  ASSERT_TRUE(WriteStringToFile("abc", new_file));
+  ASSERT_EQ(rename(new_file.c_str(), file_.c_str()), 0);
+  EXPECT_NE(GetFileIdentity(file_), identity);
+}
+
+TEST_F(DexoptQueryCacheTest, GetAndPut) {
+  DexoptQueryCache<int> cache;
+  std::vector<FileIdentity> inputs{GetFileIdentity(file_)};
+  EXPECT_EQ(cache.Get("/a.apk", "key", inputs), std::nullopt);
+
+  cache.Put("/a.apk", "key", std::vector<FileIdentity>(inputs), 1);
+  EXPECT_EQ(cache.Get("/a.apk", "key", inputs), 1);
+  EXPECT_EQ(cache.Get("/a.apk", "other_key", inputs), std::nullopt);
+  EXPECT_EQ(cache.Get("/b.apk", "key", inputs), std::nullopt);
+
+  cache.Put("/a.apk", "key", std::vector<FileIdentity>(inputs), 2);
+  EXPECT_EQ(cache.Get("/a.apk", "key", inputs), 2);
+}
+
+TEST_F(DexoptQueryCacheTest, ChangedInputs) {
+  DexoptQueryCache<int> cache;
+  std::vector<FileIdentity> inputs{GetFileIdentity(file_)};
+  cache.Put("/a.apk", "key", std::vector<FileIdentity>(inputs), 1);
+
+  ASSERT_TRUE(WriteStringToFile("abc", file_));
+  std::vector<FileIdentity> new_inputs{GetFileIdentity(file_)};
+  EXPECT_EQ(cache.Get("/a.apk", "key", new_inputs), std::nullopt);
+}
+
+TEST_F(DexoptQueryCacheTest, Invalidate) {
+  DexoptQueryCache<int> cache;
+  std::vector<FileIdentity> inputs{GetFileIdentity(file_)};
+  cache.Put("/a.apk", "key1", std::vector<FileIdentity>(inputs), 1);
+  cache.Put("/a.apk", "key2", std::vector<FileIdentity>(inputs), 2);
+  cache.Put("/b.apk", "key1", std::vector<FileIdentity>(inputs), 3);
+
+  cache.Invalidate("/a.apk");
+  EXPECT_EQ(cache.Get("/a.apk", "key1", inputs), std::nullopt);
+  EXPECT_EQ(cache.Get("/a.apk", "key2", inputs), std::nullopt);
+  EXPECT_EQ(cache.Get("/b.apk", "key1", inputs), 3);
+
+  cache.InvalidateAll();
+  EXPECT_EQ(cache.Get("/b.apk", "key1", inputs), std::nullopt);
+}
+
+TEST_F(DexoptQueryCacheTest, MaxEntries) {
+  DexoptQueryCache<int> cache;
+  std::vector<FileIdentity> inputs;
+  for (size_t i = 0; i < DexoptQueryCache<int>::kMaxEntries; ++i) {
+    cache.Put("/a.apk", std::to_string(i), std::vector<FileIdentity>(inputs), 1);
+  }
+  cache.Put("/b.apk", "key", std::vector<FileIdentity>(inputs), 2);
+  EXPECT_EQ(cache.Get("/b.apk", "key", inputs), std::nullopt);
+
+  // Invalidating frees up space.
+  cache.Invalidate("/a.apk");
+  cache.Put("/b.apk", "key", std::vector<FileIdentity>(inputs), 2);
+  EXPECT_EQ(cache.Get("/b.apk", "key", inputs), 2);
+}
+
+}  // namespace
+}  // namespace artd
+}  // namespace art
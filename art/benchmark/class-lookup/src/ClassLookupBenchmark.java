@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class ClassLookupBenchmark {
+    private static final int THREAD_COUNT = 4;
+
+    // Classes from the boot class path, found in the frozen sets of the boot class table.
+    private static final String[] BOOT_CLASS_NAMES = {
+        "java.lang.String",
+        "java.util.ArrayList",
+        "java.util.HashMap",
+        "java.util.concurrent.ConcurrentHashMap",
+        "java.io.File",
+        "java.nio.ByteBuffer",
+        "java.lang.reflect.Method",
+        "java.util.regex.Pattern",
+    };
+
+    // Classes from the benchmark dex file, found in the class table of the app class loader.
+    private static final String[] APP_CLASS_NAMES = {
+        "ClassLookupBenchmark",
+        "ClassLookupBenchmark$Lookup",
+    };
+
+    private final ClassLoader loader = ClassLookupBenchmark.class.getClassLoader();
+
+    private volatile int sum;
+
+    public void timeLookupBootClassesSingleThread(int count) throws Exception {
+        new Lookup(BOOT_CLASS_NAMES, count).run();
+    }
+
+    public void timeLookupBootClassesMultiThread(int count) throws Exception {
+        runInThreads(BOOT_CLASS_NAMES, count);
+    }
+
+    public void timeLookupAppClassesMultiThread(int count) throws Exception {
+        runInThreads(APP_CLASS_NAMES, count);
+    }
+
+    private void runInThreads(String[] names, int count) throws Exception {
+        Thread[] threads = new Thread[THREAD_COUNT];
+        for (int i = 0; i < THREAD_COUNT; ++i) {
+            threads[i] = new Thread(new Lookup(names, count));
+        }
+        for (Thread thread : threads) {
+            thread.start();
+        }
+        for (Thread thread : threads) {
+            thread.join();
+        }
+    }
+
+    private class Lookup implements Runnable {
+        private final String[] names;
+        private final int count;
+
+        Lookup(String[] names, int count) {
+            this.names = names;
+            this.count = count;
+        }
+
+        public void run() {
+            int found = 0;
+            try {
+                for (int i = 0; i < count; ++i) {
+                    Class<?> klass = Class.forName(names[i % names.length], false, loader);
+                    found += (klass != null) ? 1 : 0;
+                }
+            } catch (ClassNotFoundException e) {
+                throw new RuntimeException(e);
+            }
+            sum += found;
+        }
+    }
+}
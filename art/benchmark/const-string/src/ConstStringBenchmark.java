@@ -1059,6 +1059,49 @@ public class ConstStringBenchmark {
         }
     }
 
+    // Strings which are interned in the boot image.
+    private static final String[] BOOT_IMAGE_STRINGS = {
+        "java.lang.String", "length", "toString", "hashCode", "equals", "value", "size", "get",
+    };
+
+    private static final int THREAD_COUNT = 4;
+
+    public void timeInternBootImageStringsSingleThread(int count) {
+        new Interner(count).run();
+    }
+
+    public void timeInternBootImageStringsMultiThread(int count) throws Exception {
+        Thread[] threads = new Thread[THREAD_COUNT];
+        for (int i = 0; i < THREAD_COUNT; ++i) {
+            threads[i] = new Thread(new Interner(count));
+        }
+        for (Thread thread : threads) {
+            thread.start();
+        }
+        for (Thread thread : threads) {
+            thread.join();
+        }
+    }
+
+    private static class Interner implements Runnable {
+        // Use copies so that `String.intern()` needs to look them up in the intern table.
+        private final String[] strings = new String[BOOT_IMAGE_STRINGS.length];
+        private final int count;
+
+        Interner(int count) {
+            for (int i = 0; i < strings.length; ++i) {
+                strings[i] = new String(BOOT_IMAGE_STRINGS[i].toCharArray());
+            }
+            this.count = count;
+        }
+
+        public void run() {
+            for (int i = 0; i < count; ++i) {
+                $noinline$foo(strings[i & (strings.length - 1)].intern());
+            }
+        }
+    }
+
     static void $noinline$foo(String s) {
         if (doThrow) { throw new Error(); }
     }
@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.BufferedReader;
+import java.io.FileReader;
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.Arrays;
+
+public class GcReplayBenchmark {
+    private static final int OBJECT = 0;
+    private static final int BYTE_ARRAY = 1;
+    private static final int INT_ARRAY = 2;
+    private static final int OBJECT_ARRAY = 3;
+
+    private static final long PAUSE_SAMPLING_PERIOD_MS = 1L;
+    private static final long RSS_SAMPLING_PERIOD_NS = 100_000_000L;
+
+    // The profile, one entry per allocation.
+    private final int[] types;
+    private final int[] lengths;
+    private final int[] lifetimes;
+
+    // Objects still alive, indexed by the allocation that frees them modulo the length.
+    private final Object[] live;
+
+    private static class Node {
+        Object next;
+        long value;
+    }
+
+    public GcReplayBenchmark() {
+        this(defaultProfile());
+    }
+
+    private GcReplayBenchmark(ArrayList<int[]> profile) {
+        types = new int[profile.size()];
+        lengths = new int[profile.size()];
+        lifetimes = new int[profile.size()];
+        int maxLifetime = 0;
+        for (int i = 0; i < profile.size(); ++i) {
+            types[i] = profile.get(i)[0];
+            lengths[i] = profile.get(i)[1];
+            lifetimes[i] = profile.get(i)[2];
+            maxLifetime = Math.max(maxLifetime, lifetimes[i]);
+        }
+        live = new Object[maxLifetime + 1];
+    }
+
+    public void timeReplay(int count) {
+        for (int i = 0; i < count; ++i) {
+            replay();
+        }
+    }
+
+    // Returns the number of bytes allocated, approximately.
+    private long replay() {
+        long bytes = 0;
+        Object previous = null;
+        for (int i = 0; i < types.length; ++i) {
+            Object object;
+            int length = lengths[i];
+            switch (types[i]) {
+                case BYTE_ARRAY:
+                    object = new byte[length];
+                    bytes += 16 + length;
+                    break;
+                case INT_ARRAY:
+                    object = new int[length];
+                    bytes += 16 + 4L * length;
+                    break;
+                case OBJECT_ARRAY:
+                    Object[] array = new Object[length];
+                    if (length != 0) {
+                        array[0] = previous;
+                    }
+                    object = array;
+                    bytes += 16 + 4L * length;
+                    break;
+                default:
+                    Node node = new Node();
+                    node.next = previous;
+                    object = node;
+                    bytes += 24;
+                    break;
+            }
+            // Keep the object alive for `lifetimes[i]` allocations, by storing it where a later
+            // allocation overwrites it. A lifetime of 0 is garbage right away.
+            if (lifetimes[i] != 0) {
+                live[(i + lifetimes[i]) % live.length] = object;
+            }
+            live[i % live.length] = null;
+            previous = object;
+        }
+        return bytes;
+    }
+
+    // A profile resembling an app at steady state: mostly short-lived small objects, some
+    // medium-lived buffers and a few long-lived arrays.
+    private static ArrayList<int[]> defaultProfile() {
+        ArrayList<int[]> profile = new ArrayList<>();
+        for (int i = 0; i < 100_000; ++i) {
+            if (i % 1000 == 0) {
+                profile.add(new int[] { OBJECT_ARRAY, 1024, 50_000 });
+            } else if (i % 100 == 0) {
+                profile.add(new int[] { BYTE_ARRAY, 8192, 5_000 });
+            } else if (i % 10 == 0) {
+                profile.add(new int[] { INT_ARRAY, 64, 500 });
+            } else {
+                profile.add(new int[] { OBJECT, 0, i % 3 == 0 ? 50 : 0 });
+            }
+        }
+        return profile;
+    }
+
+    private static ArrayList<int[]> readProfile(String fileName) throws IOException {
+        ArrayList<int[]> profile = new ArrayList<>();
+        try (BufferedReader reader = new BufferedReader(new FileReader(fileName))) {
+            String line;
+            while ((line = reader.readLine()) != null) {
+                line = line.trim();
+                if (line.isEmpty() || line.startsWith("#")) {
+                    continue;
+                }
+                String[] fields = line.split("\\s+");
+                if (fields.length != 3) {
+                    throw new IOException("Invalid profile line: " + line);
+                }
+                int type;
+                switch (fields[0]) {
+                    case "object": type = OBJECT; break;
+                    case "byte[]": type = BYTE_ARRAY; break;
+                    case "int[]": type = INT_ARRAY; break;
+                    case "Object[]": type = OBJECT_ARRAY; break;
+                    default: throw new IOException("Invalid allocation type: " + fields[0]);
+                }
+                profile.add(new int[] {
+                        type, Integer.parseInt(fields[1]), Integer.parseInt(fields[2]) });
+            }
+        }
+        return profile;
+    }
+
+    // Records how late a thread that sleeps for 1ms wakes up, which includes the GC pauses.
+    private static class PauseSampler extends Thread {
+        private volatile boolean stopped;
+        private final ArrayList<Long> pausesNs = new ArrayList<>();
+        private final ArrayList<String> rssSamples = new ArrayList<>();
+
+        PauseSampler() {
+            setDaemon(true);
+        }
+
+        @Override
+        public void run() {
+            long startNs = System.nanoTime();
+            long nextRssSampleNs = startNs;
+            while (!stopped) {
+                long beforeNs = System.nanoTime();
+                try {
+                    Thread.sleep(PAUSE_SAMPLING_PERIOD_MS);
+                } catch (InterruptedException e) {
+                    break;
+                }
+                long afterNs = System.nanoTime();
+                long expectedNs = PAUSE_SAMPLING_PERIOD_MS * 1_000_000L;
+                pausesNs.add(Math.max(0L, afterNs - beforeNs - expectedNs));
+                if (afterNs >= nextRssSampleNs) {
+                    rssSamples.add((afterNs - startNs) / 1_000_000L + "ms " + readRssKb() + "kB");
+                    nextRssSampleNs += RSS_SAMPLING_PERIOD_NS;
+                }
+            }
+        }
+
+        void finish() throws InterruptedException {
+            stopped = true;
+            join();
+        }
+    }
+
+    private static long readRssKb() {
+        try (BufferedReader reader = new BufferedReader(new FileReader("/proc/self/statm"))) {
+            String[] fields = reader.readLine().split(" ");
+            return Long.parseLong(fields[1]) * 4;  // Assume 4KiB pages.
+        } catch (IOException | RuntimeException e) {
+            return -1;
+        }
+    }
+
+    private static long percentile(long[] sorted, double fraction) {
+        return sorted[Math.min(sorted.length - 1, (int) (sorted.length * fraction))];
+    }
+
+    // Usage: GcReplayBenchmark [profile-file] [seconds]
+    public static void main(String[] args) throws Exception {
+        GcReplayBenchmark benchmark = new GcReplayBenchmark(
+                args.length > 0 ? readProfile(args[0]) : defaultProfile());
+        long durationNs = (args.length > 1 ? Long.parseLong(args[1]) : 10L) * 1_000_000_000L;
+
+        PauseSampler sampler = new PauseSampler();
+        sampler.start();
+        long bytes = 0;
+        long replays = 0;
+        long startNs = System.nanoTime();
+        long elapsedNs;
+        do {
+            bytes += benchmark.replay();
+            ++replays;
+            elapsedNs = System.nanoTime() - startNs;
+        } while (elapsedNs < durationNs);
+        sampler.finish();
+
+        long[] pauses = new long[sampler.pausesNs.size()];
+        for (int i = 0; i < pauses.length; ++i) {
+            pauses[i] = sampler.pausesNs.get(i);
+        }
+        Arrays.sort(pauses);
+        double seconds = elapsedNs / 1e9;
+        System.out.printf("replays: %d, allocations/s: %.0f, MB/s: %.1f%n",
+                replays, replays * benchmark.types.length / seconds, bytes / seconds / 1e6);
+        if (pauses.length != 0) {
+            System.out.printf("pauses (us): p50 %d, p90 %d, p99 %d, p99.9 %d, max %d%n",
+                    percentile(pauses, 0.5) / 1000, percentile(pauses, 0.9) / 1000,
+                    percentile(pauses, 0.99) / 1000, percentile(pauses, 0.999) / 1000,
+                    pauses[pauses.length - 1] / 1000);
+        }
+        for (String rssSample : sampler.rssSamples) {
+            System.out.println("rss: " + rssSample);
+        }
+    }
+}
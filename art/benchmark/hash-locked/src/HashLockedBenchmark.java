@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class HashLockedBenchmark {
+    private int sum;
+
+    // The object the holder thread locks next, and whether it currently holds it.
+    private volatile Object toHold;
+    private volatile boolean holding;
+    private volatile boolean stop;
+
+    public void timeHashUnlocked(int count) {
+        for (int i = 0; i < count; ++i) {
+            sum += new Object().hashCode();
+        }
+    }
+
+    public void timeHashHeldBySelf(int count) {
+        for (int i = 0; i < count; ++i) {
+            Object o = new Object();
+            synchronized (o) {
+                sum += o.hashCode();
+            }
+        }
+    }
+
+    public void timeHashHeldByOtherThread(int count) throws InterruptedException {
+        Thread holder = new Thread(this::holdObjects);
+        stop = false;
+        holder.start();
+        for (int i = 0; i < count; ++i) {
+            Object o = new Object();
+            toHold = o;
+            while (!holding) {
+                Thread.onSpinWait();
+            }
+            sum += o.hashCode();
+            while (holding) {
+                Thread.onSpinWait();
+            }
+        }
+        stop = true;
+        holder.join();
+    }
+
+    // Lock each published object for a few microseconds, as a short critical section would.
+    private void holdObjects() {
+        while (!stop) {
+            Object o = toHold;
+            if (o == null) {
+                Thread.onSpinWait();
+                continue;
+            }
+            toHold = null;
+            synchronized (o) {
+                holding = true;
+                long end = System.nanoTime() + 2_000;
+                while (System.nanoTime() < end) {
+                    Thread.onSpinWait();
+                }
+            }
+            holding = false;
+        }
+    }
+
+    public static void main(String[] args) throws InterruptedException {
+        HashLockedBenchmark benchmark = new HashLockedBenchmark();
+        final int count = 100_000;
+        long start = System.nanoTime();
+        benchmark.timeHashUnlocked(count);
+        long unlocked = System.nanoTime() - start;
+        start = System.nanoTime();
+        benchmark.timeHashHeldBySelf(count);
+        long heldBySelf = System.nanoTime() - start;
+        start = System.nanoTime();
+        benchmark.timeHashHeldByOtherThread(count);
+        long heldByOtherThread = System.nanoTime() - start;
+        System.out.println("HashUnlocked: " + unlocked / count + " ns");
+        System.out.println("HashHeldBySelf: " + heldBySelf / count + " ns");
+        System.out.println("HashHeldByOtherThread: " + heldByOtherThread / count + " ns");
+    }
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The interface methods below are named so that they all use the same IMT slot.
+public class ImtConflictBenchmark {
+    interface Small0 {
+        int m33();
+        int m78();
+    }
+
+    interface Small1 {
+        int m19();
+        int m42();
+    }
+
+    interface Large0 {
+        int m15();
+        int m83();
+        int m102();
+        int m147();
+        int m170();
+        int m254();
+        int m299();
+        int m338();
+    }
+
+    interface Large1 {
+        int m24();
+        int m69();
+        int m92();
+        int m111();
+        int m156();
+        int m263();
+        int m302();
+        int m347();
+    }
+
+    interface Large2 {
+        int m33();
+        int m78();
+        int m120();
+        int m165();
+        int m204();
+        int m249();
+        int m272();
+        int m311();
+    }
+
+    interface Large3 {
+        int m19();
+        int m42();
+        int m87();
+        int m106();
+        int m174();
+        int m213();
+        int m258();
+        int m281();
+    }
+
+    static class SmallImpl implements Small0, Small1 {
+        public int m33() { return 1; }
+        public int m78() { return 2; }
+        public int m19() { return 3; }
+        public int m42() { return 4; }
+    }
+
+    static class LargeImpl implements Large0, Large1, Large2, Large3 {
+        public int m15() { return 1; }
+        public int m83() { return 2; }
+        public int m102() { return 3; }
+        public int m147() { return 4; }
+        public int m170() { return 5; }
+        public int m254() { return 6; }
+        public int m299() { return 7; }
+        public int m338() { return 8; }
+        public int m24() { return 9; }
+        public int m69() { return 10; }
+        public int m92() { return 11; }
+        public int m111() { return 12; }
+        public int m156() { return 13; }
+        public int m263() { return 14; }
+        public int m302() { return 15; }
+        public int m347() { return 16; }
+        public int m33() { return 17; }
+        public int m78() { return 18; }
+        public int m120() { return 19; }
+        public int m165() { return 20; }
+        public int m204() { return 21; }
+        public int m249() { return 22; }
+        public int m272() { return 23; }
+        public int m311() { return 24; }
+        public int m19() { return 25; }
+        public int m42() { return 26; }
+        public int m87() { return 27; }
+        public int m106() { return 28; }
+        public int m174() { return 29; }
+        public int m213() { return 30; }
+        public int m258() { return 31; }
+        public int m281() { return 32; }
+    }
+
+    private int sum;
+
+    // Call the last interface method of the conflict tables, the slowest one to find with a
+    // linear search.
+    public void timeSmallConflictTable(int count) {
+        Small1 s = new SmallImpl();
+        for (int i = 0; i < count; ++i) {
+            sum += s.m42();
+        }
+    }
+
+    public void timeLargeConflictTable(int count) {
+        Large3 l = new LargeImpl();
+        for (int i = 0; i < count; ++i) {
+            sum += l.m281();
+        }
+    }
+
+    public static void main(String[] args) {
+        ImtConflictBenchmark benchmark = new ImtConflictBenchmark();
+        final int count = 10_000_000;
+        // Fill the conflict tables before timing the calls.
+        benchmark.timeSmallConflictTable(count);
+        benchmark.timeLargeConflictTable(count);
+        long start = System.nanoTime();
+        benchmark.timeSmallConflictTable(count);
+        long small = System.nanoTime() - start;
+        start = System.nanoTime();
+        benchmark.timeLargeConflictTable(count);
+        long large = System.nanoTime() - start;
+        System.out.println("SmallConflictTable: " + small / count + " ns");
+        System.out.println("LargeConflictTable: " + large / count + " ns");
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class InliningBudgetBenchmark {
+    private static final int ITERATIONS = 1000;
+
+    private abstract static class Shape {
+        abstract int area(int scale);
+    }
+
+    private static class Square extends Shape {
+        private final int side;
+
+        Square(int side) {
+            this.side = side;
+        }
+
+        // Larger than the default inlining limit of 32 code units, so that it is only inlined
+        // at a hot call site.
+        @Override
+        int area(int scale) {
+            int s = side * scale;
+            int a = s * s;
+            if (a < 0) {
+                a = -a;
+            }
+            if (scale > 100) {
+                a = (a >> 1) + (a >> 3) + (a >> 5);
+            } else if (scale > 10) {
+                a = (a >> 2) + (a >> 4) + (a >> 6);
+            } else {
+                a = a + (a >> 7) + (a >> 9);
+            }
+            return a ^ (a >>> 16);
+        }
+    }
+
+    private final Shape shape = new Square(3);
+
+    public static int field = 1;
+
+    public void timeHotCallSite(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            for (int j = 0; j < ITERATIONS; ++j) {
+                sum += shape.area(j);
+            }
+        }
+        if (sum == 0) {
+            throw new AssertionError();
+        }
+    }
+
+    public void timeColdPath(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            for (int j = 0; j < ITERATIONS; ++j) {
+                sum += (field < 0) ? rarelyCalled(j) : j;
+            }
+        }
+        if (sum == 0) {
+            throw new AssertionError();
+        }
+    }
+
+    private int rarelyCalled(int x) {
+        return shape.area(x) + shape.area(x + 1) + shape.area(x + 2) + shape.area(x + 3);
+    }
+}
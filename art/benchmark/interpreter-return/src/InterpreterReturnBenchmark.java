@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class InterpreterReturnBenchmark {
+    private static final int CALL_DEPTH = 8;
+
+    private static final Object sharedObject = new Object();
+
+    private int sum;
+
+    public void timeReturnInt(int count) {
+        for (int i = 0; i < count; ++i) {
+            sum += $noinline$returnInt(CALL_DEPTH);
+        }
+    }
+
+    public void timeReturnLong(int count) {
+        for (int i = 0; i < count; ++i) {
+            sum += (int) $noinline$returnLong(CALL_DEPTH);
+        }
+    }
+
+    public void timeReturnObject(int count) {
+        for (int i = 0; i < count; ++i) {
+            if ($noinline$returnObject(CALL_DEPTH) == sharedObject) {
+                sum++;
+            }
+        }
+    }
+
+    // Each level compiles to an invoke followed by `move-result vAA` and `return vAA`.
+    private static int $noinline$returnInt(int depth) {
+        if (depth == 0) {
+            return 1;
+        }
+        return $noinline$returnInt(depth - 1);
+    }
+
+    private static long $noinline$returnLong(int depth) {
+        if (depth == 0) {
+            return 1L;
+        }
+        return $noinline$returnLong(depth - 1);
+    }
+
+    private static Object $noinline$returnObject(int depth) {
+        if (depth == 0) {
+            return sharedObject;
+        }
+        return $noinline$returnObject(depth - 1);
+    }
+}
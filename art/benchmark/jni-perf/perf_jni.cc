@@ -34,6 +34,25 @@ extern "C" JNIEXPORT void JNICALL Java_JniPerfBenchmark_perfSOAUncheckedCall(JNI
   ScopedObjectAccessUnchecked soa(Thread::Current());
 }
 
+extern "C" JNIEXPORT void JNICALL Java_JniPerfBenchmark_perfLocalRefs(JNIEnv* env,
+                                                                      jobject obj,
+                                                                      jint count) {
+  // The references are released in bulk when the native frame is popped on return.
+  for (jint i = 0; i < count; ++i) {
+    env->NewLocalRef(obj);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniPerfBenchmark_perfLocalFrame(JNIEnv* env,
+                                                                       jobject obj,
+                                                                       jint count) {
+  env->PushLocalFrame(count);
+  for (jint i = 0; i < count; ++i) {
+    env->NewLocalRef(obj);
+  }
+  env->PopLocalFrame(nullptr);
+}
+
 }  // namespace
 
 }  // namespace art
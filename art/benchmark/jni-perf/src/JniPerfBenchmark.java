@@ -20,6 +20,8 @@ public class JniPerfBenchmark {
   native void perfJniEmptyCall();
   native void perfSOACall();
   native void perfSOAUncheckedCall();
+  native void perfLocalRefs(int count);
+  native void perfLocalFrame(int count);
 
   public void timeFastJNI(int N) {
     // TODO: This might be an intrinsic.
@@ -46,6 +48,32 @@ public class JniPerfBenchmark {
     }
   }
 
+  // Fits in the initial local reference table.
+  public void timeLocalRefs16(int N) {
+    for (long i = 0; i < N; i++) {
+      perfLocalRefs(16);
+    }
+  }
+
+  // Grows the local reference table over several chained tables.
+  public void timeLocalRefs4096(int N) {
+    for (long i = 0; i < N; i++) {
+      perfLocalRefs(4096);
+    }
+  }
+
+  public void timeLocalFrame16(int N) {
+    for (long i = 0; i < N; i++) {
+      perfLocalFrame(16);
+    }
+  }
+
+  public void timeLocalFrame4096(int N) {
+    for (long i = 0; i < N; i++) {
+      perfLocalFrame(4096);
+    }
+  }
+
   {
     System.loadLibrary("artbenchmark");
   }
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class OsrEntryBenchmark {
+    // Number of iterations of each loop. Small enough for the transition to the compiled loop
+    // to dominate the time of a call.
+    private static final int ITERATIONS = 16;
+
+    public static int field = 1;
+
+    // The methods below are run in the interpreter while they warm up. To measure the OSR
+    // transitions, run with the JIT only compiling OSR code, so that each call starts in nterp
+    // and jumps to the compiled loop at its back edge.
+    public void timeOsrEntryFewRegisters(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += fewRegisters(field);
+        }
+        if (sum == 0) {
+            throw new AssertionError();
+        }
+    }
+
+    public void timeOsrEntryManyRegisters(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += manyRegisters(field);
+        }
+        if (sum == 0) {
+            throw new AssertionError();
+        }
+    }
+
+    private static int fewRegisters(int x) {
+        int a = x;
+        for (int i = 0; i < ITERATIONS; ++i) {
+            a += i;
+        }
+        return a;
+    }
+
+    private static int manyRegisters(int x) {
+        int a = x, b = x + 1, c = x + 2, d = x + 3, e = x + 4, f = x + 5, g = x + 6, h = x + 7;
+        int j = x + 8, k = x + 9, l = x + 10, m = x + 11, n = x + 12, o = x + 13, p = x + 14;
+        int q = x + 15, r = x + 16, s = x + 17, t = x + 18, u = x + 19;
+        for (int i = 0; i < ITERATIONS; ++i) {
+            a += b; b += c; c += d; d += e; e += f; f += g; g += h; h += j; j += k; k += l;
+            l += m; m += n; n += o; o += p; p += q; q += r; r += s; s += t; t += u; u += i;
+        }
+        return a + b + c + d + e + f + g + h + j + k + l + m + n + o + p + q + r + s + t + u;
+    }
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/arena_allocator.h"
+#include "base/malloc_arena_pool.h"
+#include "base/scoped_arena_allocator.h"
+#include "benchmark/benchmark.h"
+
+namespace art {
+
+// The allocation sizes cycle through the sizes of typical compiler IR nodes.
+static constexpr size_t kAllocationSizes[] = { 16u, 24u, 40u, 64u, 96u, 128u, 200u, 256u };
+static constexpr size_t kAllocationsPerIteration = 4096u;
+
+static void BM_ArenaAllocatorAlloc(benchmark::State& state) {
+  MallocArenaPool pool;
+  for (auto _ : state) {
+    ArenaAllocator allocator(&pool);
+    for (size_t i = 0; i != kAllocationsPerIteration; ++i) {
+      benchmark::DoNotOptimize(
+          allocator.Alloc(kAllocationSizes[i % arraysize(kAllocationSizes)]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kAllocationsPerIteration);
+}
+BENCHMARK(BM_ArenaAllocatorAlloc);
+
+static void BM_ScopedArenaAllocatorAlloc(benchmark::State& state) {
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  for (auto _ : state) {
+    ScopedArenaAllocator allocator(&arena_stack);
+    for (size_t i = 0; i != kAllocationsPerIteration; ++i) {
+      benchmark::DoNotOptimize(
+          allocator.Alloc(kAllocationSizes[i % arraysize(kAllocationSizes)]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kAllocationsPerIteration);
+}
+BENCHMARK(BM_ScopedArenaAllocatorAlloc);
+
+}  // namespace art
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include "base/arena_allocator.h"
+#include "base/bit_table.h"
+#include "base/malloc_arena_pool.h"
+#include "base/scoped_arena_allocator.h"
+#include "benchmark/benchmark.h"
+
+namespace art {
+
+static constexpr size_t kNumColumns = 4u;
+
+// Encodes a table resembling the stack maps of a method: small, mostly increasing values.
+static std::vector<uint8_t> EncodeTable(size_t num_rows) {
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+  std::vector<uint8_t> buffer;
+  BitMemoryWriter<std::vector<uint8_t>> writer(&buffer);
+  BitTableBuilderBase<kNumColumns> builder(&allocator);
+  constexpr uint32_t kNoValue = BitTableBase<kNumColumns>::kNoValue;
+  for (uint32_t i = 0; i != num_rows; ++i) {
+    builder.Add({i * 4u, i % 7u, (i * 31u) % 1000u, (i & 1u) != 0u ? i : kNoValue});
+  }
+  builder.Encode(writer);
+  return buffer;
+}
+
+static void BM_BitTableEncode(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(EncodeTable(state.range(0)).data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BitTableEncode)->Arg(16)->Arg(1024);
+
+static void BM_BitTableDecode(benchmark::State& state) {
+  const std::vector<uint8_t> buffer = EncodeTable(state.range(0));
+  for (auto _ : state) {
+    BitMemoryReader reader(buffer.data());
+    BitTableBase<kNumColumns> table(reader);
+    benchmark::DoNotOptimize(table.NumRows());
+  }
+}
+BENCHMARK(BM_BitTableDecode)->Arg(16)->Arg(1024);
+
+static void BM_BitTableGet(benchmark::State& state) {
+  const std::vector<uint8_t> buffer = EncodeTable(state.range(0));
+  BitMemoryReader reader(buffer.data());
+  BitTableBase<kNumColumns> table(reader);
+  for (auto _ : state) {
+    uint32_t sum = 0u;
+    for (uint32_t row = 0; row != table.NumRows(); ++row) {
+      for (uint32_t column = 0; column != kNumColumns; ++column) {
+        sum += table.Get(row, column);
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * kNumColumns);
+}
+BENCHMARK(BM_BitTableGet)->Arg(16)->Arg(1024);
+
+}  // namespace art
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "base/hash_set.h"
+#include "benchmark/benchmark.h"
+
+namespace art {
+
+static std::vector<std::string> MakeStrings(size_t count, const char* prefix) {
+  std::vector<std::string> strings;
+  strings.reserve(count);
+  for (size_t i = 0; i != count; ++i) {
+    strings.push_back(prefix + std::to_string(i * 7919u));
+  }
+  return strings;
+}
+
+static void BM_HashSetStringInsert(benchmark::State& state) {
+  const std::vector<std::string> strings = MakeStrings(state.range(0), "Ljava/lang/Class");
+  for (auto _ : state) {
+    HashSet<std::string> hash_set;
+    for (const std::string& s : strings) {
+      hash_set.insert(s);
+    }
+    benchmark::DoNotOptimize(hash_set.size());
+  }
+  state.SetItemsProcessed(state.iterations() * strings.size());
+}
+BENCHMARK(BM_HashSetStringInsert)->Arg(64)->Arg(4096);
+
+static void BM_HashSetStringFind(benchmark::State& state) {
+  const std::vector<std::string> strings = MakeStrings(state.range(0), "Ljava/lang/Class");
+  const std::vector<std::string> misses = MakeStrings(state.range(0), "Landroid/view/View");
+  HashSet<std::string> hash_set;
+  for (const std::string& s : strings) {
+    hash_set.insert(s);
+  }
+  for (auto _ : state) {
+    for (size_t i = 0; i != strings.size(); ++i) {
+      benchmark::DoNotOptimize(hash_set.find(strings[i]));
+      benchmark::DoNotOptimize(hash_set.find(misses[i]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 2u * strings.size());
+}
+BENCHMARK(BM_HashSetStringFind)->Arg(64)->Arg(4096);
+
+static void BM_HashSetIntegerFind(benchmark::State& state) {
+  HashSet<uint64_t> hash_set;
+  const uint64_t count = static_cast<uint64_t>(state.range(0));
+  // Zero is the empty value of `HashSet<uint64_t>`.
+  for (uint64_t i = 1u; i <= count; ++i) {
+    hash_set.insert(i * 0x9e3779b97f4a7c15u);
+  }
+  for (auto _ : state) {
+    for (uint64_t i = 1u; i <= count; ++i) {
+      benchmark::DoNotOptimize(hash_set.find(i * 0x9e3779b97f4a7c15u));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_HashSetIntegerFind)->Arg(64)->Arg(65536);
+
+}  // namespace art
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "dex/utf-inl.h"
+
+namespace art {
+
+// A type descriptor, which is plain ASCII, and a string with 2-byte and 3-byte sequences.
+static std::string MakeUtf8(bool ascii) {
+  std::string result;
+  while (result.size() < 256u) {
+    result += ascii ? "Landroid/content/res/Resources$Theme;"
+                    : "Gr\xc3\xbc\xc3\x9f\x65 \xe4\xb8\x96\xe7\x95\x8c ";
+  }
+  return result;
+}
+
+static void BM_CountModifiedUtf8Chars(benchmark::State& state) {
+  const std::string utf8 = MakeUtf8(state.range(0) != 0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CountModifiedUtf8Chars(utf8.data(), utf8.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * utf8.size());
+}
+BENCHMARK(BM_CountModifiedUtf8Chars)->ArgName("ascii")->Arg(1)->Arg(0);
+
+static void BM_ConvertModifiedUtf8ToUtf16(benchmark::State& state) {
+  const std::string utf8 = MakeUtf8(state.range(0) != 0);
+  const size_t utf16_length = CountModifiedUtf8Chars(utf8.data(), utf8.size());
+  std::vector<uint16_t> utf16(utf16_length);
+  for (auto _ : state) {
+    ConvertModifiedUtf8ToUtf16(utf16.data(), utf16_length, utf8.data(), utf8.size());
+    benchmark::DoNotOptimize(utf16.data());
+  }
+  state.SetBytesProcessed(state.iterations() * utf8.size());
+}
+BENCHMARK(BM_ConvertModifiedUtf8ToUtf16)->ArgName("ascii")->Arg(1)->Arg(0);
+
+static void BM_ConvertUtf16ToModifiedUtf8(benchmark::State& state) {
+  const std::string utf8 = MakeUtf8(state.range(0) != 0);
+  const size_t utf16_length = CountModifiedUtf8Chars(utf8.data(), utf8.size());
+  std::vector<uint16_t> utf16(utf16_length);
+  ConvertModifiedUtf8ToUtf16(utf16.data(), utf16_length, utf8.data(), utf8.size());
+  std::vector<char> out(CountModifiedUtf8BytesInUtf16(utf16.data(), utf16_length));
+  for (auto _ : state) {
+    ConvertUtf16ToModifiedUtf8(out.data(), out.size(), utf16.data(), utf16_length);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * utf8.size());
+}
+BENCHMARK(BM_ConvertUtf16ToModifiedUtf8)->ArgName("ascii")->Arg(1)->Arg(0);
+
+static void BM_ComputeModifiedUtf8Hash(benchmark::State& state) {
+  const std::string utf8 = MakeUtf8(state.range(0) != 0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ComputeModifiedUtf8Hash(utf8));
+  }
+  state.SetBytesProcessed(state.iterations() * utf8.size());
+}
+BENCHMARK(BM_ComputeModifiedUtf8Hash)->ArgName("ascii")->Arg(1)->Arg(0);
+
+}  // namespace art
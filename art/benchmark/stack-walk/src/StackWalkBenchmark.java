@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class StackWalkBenchmark {
+    private static final int STACK_DEPTH = 100;
+
+    private static final RuntimeException sharedException = new RuntimeException();
+
+    private int sum;
+
+    public void timeFillInStackTrace(int count) {
+        for (int i = 0; i < count; ++i) {
+            sum += $noinline$recurse(STACK_DEPTH, /* mode= */ 0);
+        }
+    }
+
+    public void timeThrowThroughDeepStack(int count) {
+        for (int i = 0; i < count; ++i) {
+            try {
+                $noinline$recurse(STACK_DEPTH, /* mode= */ 1);
+            } catch (RuntimeException e) {
+                sum++;
+            }
+        }
+    }
+
+    public void timeGetStackTrace(int count) {
+        for (int i = 0; i < count; ++i) {
+            sum += $noinline$recurse(STACK_DEPTH, /* mode= */ 2);
+        }
+    }
+
+    public void timeStackWalker(int count) {
+        for (int i = 0; i < count; ++i) {
+            sum += $noinline$recurse(STACK_DEPTH, /* mode= */ 3);
+        }
+    }
+
+    // Keep a few live values across the calls so that the frames have non-trivial stack maps.
+    private static int $noinline$recurse(int depth, int mode) {
+        if (depth == 0) {
+            return $noinline$walk(mode);
+        }
+        int a = depth * 3;
+        long b = (long) depth << 20;
+        Object c = (depth & 1) == 0 ? sharedException : null;
+        int result = $noinline$recurse(depth - 1, mode);
+        return result + a + (int) (b >> 20) + (c != null ? 1 : 0);
+    }
+
+    private static int $noinline$walk(int mode) {
+        switch (mode) {
+            case 0:
+                return new Throwable().getStackTrace().length;
+            case 1:
+                throw sharedException;
+            case 3:
+                return (int) StackWalker.getInstance().walk(frames -> frames.count());
+            default:
+                return Thread.currentThread().getStackTrace().length;
+        }
+    }
+}
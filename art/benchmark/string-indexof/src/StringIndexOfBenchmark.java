@@ -113,6 +113,35 @@ public class StringIndexOfBenchmark {
         }
     }
 
+    // Long strings with the searched character at the end, one compressed and one
+    // uncompressed (it contains a non-Latin-1 character), to measure the bulk search loops.
+    public static final String string256 = string36.repeat(7) + "abc";
+    public static final String string256Utf16 = "\u0100" + string36.repeat(7) + "ab";
+
+    public void timeIndexOfLongCompressed(int count) {
+        final char c = 'c';
+        String s = string256;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, c);
+        }
+    }
+
+    public void timeIndexOfLongUncompressed(int count) {
+        final char c = 'b';
+        String s = string256Utf16;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, c);
+        }
+    }
+
+    public void timeIndexOfLongNotFound(int count) {
+        final char c = '_';
+        String s = string256;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, c);
+        }
+    }
+
     static int $noinline$indexOf(String s, char c) {
         if (doThrow) { throw new Error(); }
         return s.indexOf(c);
@@ -24,6 +24,7 @@ public class StringBuilderAppendBenchmark {
     public static double double2 = 1.0E308;
     public static float float1 = 42.0f;
     public static float float2 = 1.0E38f;
+    public static Object object1 = Integer.valueOf(42);
 
     public void timeAppendStrings(int count) {
         String s1 = string1;
@@ -133,4 +134,17 @@ public class StringBuilderAppendBenchmark {
             throw new AssertionError();
         }
     }
+
+    public void timeAppendStringAndObject(int count) {
+        String s1 = string1;
+        Object o1 = object1;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            String result = s1 + o1;
+            sum += result.length();  // Make sure the append is not optimized away.
+        }
+        if (sum != count * (s1.length() + o1.toString().length())) {
+            throw new AssertionError();
+        }
+    }
 }
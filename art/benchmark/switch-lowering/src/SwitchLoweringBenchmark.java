@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class SwitchLoweringBenchmark {
+    private static final int[] sparseKeys = {
+        -1000000, -4096, -17, 3, 100, 257, 1023, 4000, 65537, 1 << 20, 1 << 24, 1 << 30, 42
+    };
+
+    private static final String[] stringKeys = {
+        "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel",
+        "india", "juliett", "kilo", "lima", "mike", "november", "oscar", "papa", "none"
+    };
+
+    public void timeSparseSwitch(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            for (int key : sparseKeys) {
+                sum += $noinline$sparseSwitch(key);
+            }
+        }
+        if (sum == 42) {
+            System.out.println("Unexpected sum");
+        }
+    }
+
+    public void timeStringSwitch(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            for (String key : stringKeys) {
+                sum += $noinline$stringSwitch(key);
+            }
+        }
+        if (sum == 42) {
+            System.out.println("Unexpected sum");
+        }
+    }
+
+    private static int $noinline$sparseSwitch(int value) {
+        switch (value) {
+            case -1000000: return 1;
+            case -4096: return 2;
+            case -17: return 3;
+            case 3: return 4;
+            case 100: return 5;
+            case 257: return 6;
+            case 1023: return 7;
+            case 4000: return 8;
+            case 65537: return 9;
+            case 1 << 20: return 10;
+            case 1 << 24: return 11;
+            case 1 << 30: return 12;
+            default: return 0;
+        }
+    }
+
+    private static int $noinline$stringSwitch(String value) {
+        switch (value) {
+            case "alpha": return 1;
+            case "bravo": return 2;
+            case "charlie": return 3;
+            case "delta": return 4;
+            case "echo": return 5;
+            case "foxtrot": return 6;
+            case "golf": return 7;
+            case "hotel": return 8;
+            case "india": return 9;
+            case "juliett": return 10;
+            case "kilo": return 11;
+            case "lima": return 12;
+            case "mike": return 13;
+            case "november": return 14;
+            case "oscar": return 15;
+            case "papa": return 16;
+            default: return 0;
+        }
+    }
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class ThreadLifecycleBenchmark {
+  static native boolean attachDetach(int count);
+
+  private static final Runnable EMPTY = new Runnable() {
+    public void run() {}
+  };
+
+  public void timeStartAndJoin(int N) throws InterruptedException {
+    for (int i = 0; i < N; i++) {
+      Thread thread = new Thread(EMPTY);
+      thread.start();
+      thread.join();
+    }
+  }
+
+  // Each native thread reuses the JNIEnv of the previously detached thread, if any.
+  public void timeAttachDetach(int N) {
+    if (!attachDetach(N)) {
+      throw new AssertionError("Failed to attach or detach a native thread");
+    }
+  }
+
+  {
+    System.loadLibrary("artbenchmark");
+  }
+}
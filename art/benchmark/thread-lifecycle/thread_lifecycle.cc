@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+
+#include "jni.h"
+
+namespace art {
+
+namespace {
+
+struct AttachArgs {
+  JavaVM* vm;
+  jint count;
+  bool success;
+};
+
+void* AttachDetachLoop(void* arg) {
+  AttachArgs* args = reinterpret_cast<AttachArgs*>(arg);
+  args->success = true;
+  for (jint i = 0; i < args->count; ++i) {
+    JNIEnv* env = nullptr;
+    if (args->vm->AttachCurrentThread(&env, nullptr) != JNI_OK ||
+        args->vm->DetachCurrentThread() != JNI_OK) {
+      args->success = false;
+      break;
+    }
+  }
+  return nullptr;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_ThreadLifecycleBenchmark_attachDetach(JNIEnv* env,
+                                                                                 jclass,
+                                                                                 jint count) {
+  AttachArgs args = {nullptr, count, false};
+  if (env->GetJavaVM(&args.vm) != JNI_OK) {
+    return JNI_FALSE;
+  }
+  // Attach and detach from a single native thread, like a native thread pool calling into Java.
+  pthread_t thread;
+  if (pthread_create(&thread, nullptr, AttachDetachLoop, &args) != 0 ||
+      pthread_join(thread, nullptr) != 0) {
+    return JNI_FALSE;
+  }
+  return args.success ? JNI_TRUE : JNI_FALSE;
+}
+
+}  // namespace
+
+}  // namespace art
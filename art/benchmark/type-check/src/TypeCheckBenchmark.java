@@ -129,10 +129,66 @@ public class TypeCheckBenchmark {
             throw new Error("Initialization failure!");
         }
     }
+    public void timeInstanceOfManyInterfacesToLast(int count) {
+        int sum = 0;
+        Object[] arr = arrMany;
+        for (int i = 0; i < count; ++i) {
+            if (arr[i & 1023] instanceof Iface9) {
+              ++sum;
+            }
+        }
+        result = sum;
+    }
+
+    public void timeInstanceOfManyInterfacesToMissing(int count) {
+        int sum = 0;
+        Object[] arr = arrMany;
+        for (int i = 0; i < count; ++i) {
+            if (arr[i & 1023] instanceof IfaceMissing) {
+              ++sum;
+            }
+        }
+        result = sum;
+    }
+
+    public void timeIsInstanceManyInterfacesToMissing(int count) {
+        int sum = 0;
+        Object[] arr = arrMany;
+        Class<?> c = missingInterface;
+        for (int i = 0; i < count; ++i) {
+            if (c.isInstance(arr[i & 1023])) {
+              ++sum;
+            }
+        }
+        result = sum;
+    }
+
+    public void timeIsAssignableFromManyInterfacesToLast(int count) {
+        int sum = 0;
+        Class<?> c = lastInterface;
+        for (int i = 0; i < count; ++i) {
+            if (c.isAssignableFrom(ManyInterfaces.class)) {
+              ++sum;
+            }
+        }
+        result = sum;
+    }
+
+    private static Object[] createManyInterfacesArray() {
+        Object[] array = new Object[1024];
+        for (int i = 0; i < array.length; ++i) {
+            array[i] = new ManyInterfaces();
+        }
+        return array;
+    }
+
     Object[] arr1 = createArray(1);
     Object[] arr2 = createArray(2);
     Object[] arr3 = createArray(3);
     Object[] arr9 = createArray(9);
+    Object[] arrMany = createManyInterfacesArray();
+    Class<?> lastInterface = Iface9.class;
+    Class<?> missingInterface = IfaceMissing.class;
     int result;
 }
 
@@ -145,3 +201,17 @@ class Level6 extends Level5 { }
 class Level7 extends Level6 { }
 class Level8 extends Level7 { }
 class Level9 extends Level8 { }
+
+interface Iface0 { }
+interface Iface1 { }
+interface Iface2 { }
+interface Iface3 { }
+interface Iface4 { }
+interface Iface5 { }
+interface Iface6 { }
+interface Iface7 { }
+interface Iface8 { }
+interface Iface9 { }
+interface IfaceMissing { }
+class ManyInterfaces
+    implements Iface0, Iface1, Iface2, Iface3, Iface4, Iface5, Iface6, Iface7, Iface8, Iface9 { }
@@ -78,6 +78,7 @@ CompilerOptions::CompilerOptions()
       resolve_startup_const_strings_(false),
       initialize_app_image_classes_(false),
       check_profiled_methods_(ProfileMethodsCheck::kNone),
+      register_allocation_strategy_(RegisterAllocationStrategy::kLinearScan),
       max_image_block_size_(std::numeric_limits<uint32_t>::max()),
       passes_to_run_(nullptr) {
 }
@@ -91,6 +91,7 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   if (map.Exists(Base::CheckProfiledMethods)) {
     options->check_profiled_methods_ = *map.Get(Base::CheckProfiledMethods);
   }
+  map.AssignIfExists(Base::RegisterAllocationStrategy, &options->register_allocation_strategy_);
   map.AssignIfExists(Base::MaxImageBlockSize, &options->max_image_block_size_);
 
   if (map.Exists(Base::DumpTimings)) {
@@ -170,6 +171,16 @@ NO_INLINE void AddCompilerOptionsArgumentParserOptions(Builder& b) {
                          {"abort", ProfileMethodsCheck::kAbort}})
           .IntoKey(Map::CheckProfiledMethods)
 
+      .Define({"--register-allocation-strategy=_"})
+          .template WithType<RegisterAllocationStrategy>()
+          .WithValueMap({{"linear-scan", RegisterAllocationStrategy::kLinearScan},
+                         {"spill-cost", RegisterAllocationStrategy::kSpillCost},
+                         {"profile-guided", RegisterAllocationStrategy::kProfileGuided}})
+          .WithHelp("Select the register allocator: linear-scan (default), spill-cost which\n"
+                    "evicts the live ranges cheapest to spill, or profile-guided which uses\n"
+                    "spill-cost for the hot methods of the profile only.")
+          .IntoKey(Map::RegisterAllocationStrategy)
+
       .Define({"--dump-timings"})
           .WithHelp("Display a breakdown of where time was spent.")
           .IntoKey(Map::DumpTimings)
@@ -204,6 +215,8 @@ NO_INLINE void AddCompilerOptionsArgumentParserOptions(Builder& b) {
 
       .Define("--dump-init-failures=_")
           .template WithType<std::string>()
+          .WithHelp("Dump to the specified file why image classes could not be initialized at\n"
+                    "compile time, with the descriptor of each class followed by the reason.")
           .IntoKey(Map::DumpInitFailures)
 
       .Define("--dump-cfg=_")
@@ -242,8 +255,7 @@ NO_INLINE void AddCompilerOptionsArgumentParserOptions(Builder& b) {
       .Ignore({
         "--num-dex-methods=_",
         "--top-k-profile-threshold=_",
-        "--large-method-max=_",
-        "--register-allocation-strategy=_"
+        "--large-method-max=_"
       });
   // clang-format on
 }
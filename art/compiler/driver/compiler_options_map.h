@@ -28,6 +28,7 @@
 namespace art HIDDEN {
 
 enum class ProfileMethodsCheck : uint8_t;
+enum class RegisterAllocationStrategy : uint8_t;
 
 // Defines a type-safe heterogeneous key->value map. This is to be used as the base for
 // an extended map.
@@ -135,5 +135,51 @@ TEST_F(OutputStreamTest, BufferedFlush) {
   ASSERT_TRUE(checking_output_stream->flush_called);
 }
 
+TEST_F(OutputStreamTest, BufferedLargeWrites) {
+  struct RecordingOutputStream : OutputStream {
+    RecordingOutputStream() : OutputStream("fake-location") { }
+    ~RecordingOutputStream() override {}
+
+    bool WriteFully(const void* buffer, size_t byte_count) override {
+      const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer);
+      output.insert(output.end(), data, data + byte_count);
+      write_sizes.push_back(byte_count);
+      return true;
+    }
+
+    off_t Seek([[maybe_unused]] off_t offset, [[maybe_unused]] Whence whence) override {
+      LOG(FATAL) << "UNREACHABLE";
+      UNREACHABLE();
+    }
+
+    bool Flush() override {
+      return true;
+    }
+
+    std::vector<uint8_t> output;
+    std::vector<size_t> write_sizes;
+  };
+
+  constexpr size_t kBufferSize = BufferedOutputStream::kBufferSize;
+  std::vector<uint8_t> data(3 * kBufferSize);
+  for (size_t i = 0; i != data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7u);
+  }
+
+  std::unique_ptr<RecordingOutputStream> ros = std::make_unique<RecordingOutputStream>();
+  RecordingOutputStream* recording_output_stream = ros.get();
+  BufferedOutputStream buffered(std::move(ros));
+  // A small write followed by writes larger than the buffer.
+  ASSERT_TRUE(buffered.WriteFully(&data[0], 3u));
+  ASSERT_TRUE(buffered.WriteFully(&data[3u], kBufferSize + 5u));
+  ASSERT_TRUE(buffered.WriteFully(&data[kBufferSize + 8u], 2 * kBufferSize - 8u));
+  ASSERT_TRUE(buffered.Flush());
+
+  EXPECT_EQ(data, recording_output_stream->output);
+  // Partially filled buffers are topped up, so that all writes are full buffers.
+  std::vector<size_t> expected_write_sizes(3u, kBufferSize);
+  EXPECT_EQ(expected_write_sizes, recording_output_stream->write_sizes);
+}
+
 }  // namespace linker
 }  // namespace art
@@ -103,16 +103,30 @@ bool HBasicBlockBuilder::CreateBranchTargets() {
       MaybeCreateBlockAt(dex_pc + instruction.GetTargetOffset());
     } else if (instruction.IsSwitch()) {
       DexSwitchTable table(instruction, dex_pc);
-      for (DexSwitchTableIterator s_it(table); !s_it.Done(); s_it.Advance()) {
-        MaybeCreateBlockAt(dex_pc + s_it.CurrentTargetOffset());
-
-        // Create N-1 blocks where we will insert comparisons of the input value
-        // against the Switch's case keys.
-        if (table.ShouldBuildDecisionTree() && !s_it.IsLast()) {
-          // Store the block under dex_pc of the current key at the switch data
-          // instruction for uniqueness but give it the dex_pc of the SWITCH
-          // instruction which it semantically belongs to.
-          MaybeCreateBlockAt(dex_pc, s_it.GetDexPcForCurrentIndex());
+      if (SwitchDecisionTree::IsBinarySearch(table)) {
+        // Create blocks for all comparisons of the binary search except the root split
+        // which goes to the block of the switch instruction.
+        const size_t num_entries = table.GetNumEntries();
+        for (size_t i = 0; i != num_entries; ++i) {
+          MaybeCreateBlockAt(dex_pc + table.GetEntryAt(num_entries + i));
+          MaybeCreateBlockAt(dex_pc, SwitchDecisionTree::GetKeyDexPc(table, i));
+        }
+        SwitchDecisionTree::VisitSplits(table, [&](size_t lo, size_t mid, size_t hi) {
+          MaybeCreateBlockAt(dex_pc, SwitchDecisionTree::GetRangeDexPc(table, lo, mid));
+          MaybeCreateBlockAt(dex_pc, SwitchDecisionTree::GetRangeDexPc(table, mid, hi));
+        });
+      } else {
+        for (DexSwitchTableIterator s_it(table); !s_it.Done(); s_it.Advance()) {
+          MaybeCreateBlockAt(dex_pc + s_it.CurrentTargetOffset());
+
+          // Create N-1 blocks where we will insert comparisons of the input value
+          // against the Switch's case keys.
+          if (table.ShouldBuildDecisionTree() && !s_it.IsLast()) {
+            // Store the block under dex_pc of the current key at the switch data
+            // instruction for uniqueness but give it the dex_pc of the SWITCH
+            // instruction which it semantically belongs to.
+            MaybeCreateBlockAt(dex_pc, s_it.GetDexPcForCurrentIndex());
+          }
         }
       }
     } else if (instruction.Opcode() == Instruction::MOVE_EXCEPTION) {
@@ -179,6 +193,14 @@ void HBasicBlockBuilder::ConnectBasicBlocks() {
       block->AddSuccessor(graph_->GetExitBlock());
     } else if (instruction.IsSwitch()) {
       DexSwitchTable table(instruction, dex_pc);
+      if (SwitchDecisionTree::IsBinarySearch(table)) {
+        HBasicBlock* default_block =
+            GetBlockAt(std::next(DexInstructionIterator(pair)).DexPc());
+        ConnectSwitchBinarySearch(table, dex_pc, block, default_block);
+        // The basic block ends here. Do not add any more instructions.
+        block = nullptr;
+        continue;
+      }
       for (DexSwitchTableIterator s_it(table); !s_it.Done(); s_it.Advance()) {
         uint32_t target_dex_pc = dex_pc + s_it.CurrentTargetOffset();
         block->AddSuccessor(GetBlockAt(target_dex_pc));
@@ -208,6 +230,38 @@ void HBasicBlockBuilder::ConnectBasicBlocks() {
   graph_->AddBlock(graph_->GetExitBlock());
 }
 
+void HBasicBlockBuilder::ConnectSwitchBinarySearch(const DexSwitchTable& table,
+                                                   uint32_t dex_pc,
+                                                   HBasicBlock* switch_block,
+                                                   HBasicBlock* default_block) {
+  const size_t num_entries = table.GetNumEntries();
+  auto get_range_block = [&](size_t lo, size_t hi) {
+    return (lo == 0u && hi == num_entries)
+        ? switch_block
+        : GetBlockAt(SwitchDecisionTree::GetRangeDexPc(table, lo, hi));
+  };
+  // Splits branch to the lower half if the value is less than the key at `mid`.
+  SwitchDecisionTree::VisitSplits(table, [&](size_t lo, size_t mid, size_t hi) {
+    HBasicBlock* split_block = get_range_block(lo, hi);
+    if (split_block != switch_block) {
+      graph_->AddBlock(split_block);
+    }
+    split_block->AddSuccessor(get_range_block(lo, mid));
+    split_block->AddSuccessor(get_range_block(mid, hi));
+  });
+  // Equality comparisons branch to the case target if equal, to the next comparison otherwise.
+  SwitchDecisionTree::VisitLinearRanges(table, [&](size_t lo, size_t hi) {
+    for (size_t i = lo; i != hi; ++i) {
+      HBasicBlock* case_block = GetBlockAt(SwitchDecisionTree::GetKeyDexPc(table, i));
+      graph_->AddBlock(case_block);
+      case_block->AddSuccessor(GetBlockAt(dex_pc + table.GetEntryAt(num_entries + i)));
+      case_block->AddSuccessor((i + 1u != hi)
+          ? GetBlockAt(SwitchDecisionTree::GetKeyDexPc(table, i + 1u))
+          : default_block);
+    }
+  });
+}
+
 // Returns the TryItem stored for `block` or nullptr if there is no info for it.
 static const dex::TryItem* GetTryItem(
     HBasicBlock* block,
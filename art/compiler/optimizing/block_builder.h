@@ -20,12 +20,82 @@
 #include "base/macros.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
+#include "dex/bytecode_utils.h"
 #include "dex/code_item_accessors.h"
 #include "dex/dex_file.h"
 #include "nodes.h"
 
 namespace art HIDDEN {
 
+// Shape of the binary search decision tree built for large sparse switches. The range of
+// sorted keys is split in halves with a `value < key` comparison until few enough keys are
+// left to compare them for equality one by one, as in the decision tree of small switches.
+// Each comparison gets its own block. The HBasicBlockBuilder stores these blocks under the
+// dex_pc of the compared key in the switch payload for equality comparisons, and under the
+// dex_pc of the corresponding target offset for splits, except for the root split which is
+// in the block of the switch instruction.
+class SwitchDecisionTree {
+ public:
+  static bool IsBinarySearch(const DexSwitchTable& table) {
+    return table.IsSparse() && table.GetNumEntries() > kMaxLinearSearchEntries;
+  }
+
+  // Calls `fn(lo, mid, hi)` for each split of the keys [lo, hi) into [lo, mid) and [mid, hi).
+  template <typename Fn>
+  static void VisitSplits(const DexSwitchTable& table, Fn&& fn) {
+    VisitSplits(0u, table.GetNumEntries(), fn);
+  }
+
+  // Calls `fn(lo, hi)` for each range of keys [lo, hi) that is searched linearly.
+  template <typename Fn>
+  static void VisitLinearRanges(const DexSwitchTable& table, Fn&& fn) {
+    VisitLinearRanges(0u, table.GetNumEntries(), fn);
+  }
+
+  // Returns the dex_pc of the block comparing the value to the key `index`.
+  static uint32_t GetKeyDexPc(const DexSwitchTable& table, size_t index) {
+    return table.GetDexPcForIndex(index);
+  }
+
+  // Returns the dex_pc of the first block of the search in keys [lo, hi).
+  static uint32_t GetRangeDexPc(const DexSwitchTable& table, size_t lo, size_t hi) {
+    DCHECK(lo != 0u || hi != table.GetNumEntries()) << "The root is in the switch block";
+    return (hi - lo <= kMaxLinearSearchEntries)
+        ? GetKeyDexPc(table, lo)
+        : table.GetDexPcForIndex(table.GetNumEntries() + GetMid(lo, hi));
+  }
+
+ private:
+  static size_t GetMid(size_t lo, size_t hi) {
+    return lo + (hi - lo) / 2u;
+  }
+
+  template <typename Fn>
+  static void VisitSplits(size_t lo, size_t hi, Fn& fn) {
+    if (hi - lo > kMaxLinearSearchEntries) {
+      size_t mid = GetMid(lo, hi);
+      fn(lo, mid, hi);
+      VisitSplits(lo, mid, fn);
+      VisitSplits(mid, hi, fn);
+    }
+  }
+
+  template <typename Fn>
+  static void VisitLinearRanges(size_t lo, size_t hi, Fn& fn) {
+    if (hi - lo > kMaxLinearSearchEntries) {
+      size_t mid = GetMid(lo, hi);
+      VisitLinearRanges(lo, mid, fn);
+      VisitLinearRanges(mid, hi, fn);
+    } else {
+      fn(lo, hi);
+    }
+  }
+
+  // The maximum number of keys compared one by one. Sparse switches with more keys are
+  // searched with a binary search first.
+  static constexpr size_t kMaxLinearSearchEntries = 4u;
+};
+
 class HBasicBlockBuilder : public ValueObject {
  public:
   HBasicBlockBuilder(HGraph* graph,
@@ -55,6 +125,10 @@ class HBasicBlockBuilder : public ValueObject {
 
   bool CreateBranchTargets();
   void ConnectBasicBlocks();
+  void ConnectSwitchBinarySearch(const DexSwitchTable& table,
+                                 uint32_t dex_pc,
+                                 HBasicBlock* switch_block,
+                                 HBasicBlock* default_block);
   void InsertTryBoundaryBlocks();
 
   // To ensure branches with negative offsets can always OSR jump to compiled
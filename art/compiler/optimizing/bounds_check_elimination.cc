@@ -509,7 +509,8 @@ class BCEVisitor final : public HGraphVisitor {
 
   BCEVisitor(HGraph* graph,
              const SideEffectsAnalysis& side_effects,
-             HInductionVarAnalysis* induction_analysis)
+             HInductionVarAnalysis* induction_analysis,
+             OptimizingCompilerStats* stats)
       : HGraphVisitor(graph),
         allocator_(graph->GetArenaStack()),
         maps_(graph->GetBlocks().size(),
@@ -528,6 +529,7 @@ class BCEVisitor final : public HGraphVisitor {
         initial_block_size_(graph->GetBlocks().size()),
         side_effects_(side_effects),
         induction_range_(induction_analysis),
+        stats_(stats),
         next_(nullptr) {}
 
   void VisitBasicBlock(HBasicBlock* block) override {
@@ -851,7 +853,7 @@ class BCEVisitor final : public HGraphVisitor {
       ValueRange* index_range = LookupValueRange(index, block);
       if (index_range != nullptr) {
         if (index_range->FitsIn(&array_range)) {
-          ReplaceInstruction(bounds_check, index);
+          RemoveBoundsCheck(bounds_check, MethodCompilationStat::kRemovedBoundsCheck);
           return;
         } else if (index_range->IsConstantValueRange()) {
           // If the non-constant index turns out to have a constant range,
@@ -863,7 +865,7 @@ class BCEVisitor final : public HGraphVisitor {
             ValueBound constant_upper(nullptr, existing_range->GetLower().GetConstant() - 1);
             ValueRange constant_array_range(&allocator_, lower, constant_upper);
             if (index_range->FitsIn(&constant_array_range)) {
-              ReplaceInstruction(bounds_check, index);
+              RemoveBoundsCheck(bounds_check, MethodCompilationStat::kRemovedBoundsCheck);
               return;
             }
           }
@@ -872,7 +874,7 @@ class BCEVisitor final : public HGraphVisitor {
       // Try index range obtained by induction variable analysis.
       // Disables dynamic bce if OOB is certain.
       if (InductionRangeFitsIn(&array_range, bounds_check, &try_dynamic_bce)) {
-        ReplaceInstruction(bounds_check, index);
+        RemoveBoundsCheck(bounds_check, MethodCompilationStat::kRemovedBoundsCheck);
         return;
       }
     } else {
@@ -883,7 +885,7 @@ class BCEVisitor final : public HGraphVisitor {
         return;
       } else if (array_length->IsIntConstant()) {
         if (constant < array_length->AsIntConstant()->GetValue()) {
-          ReplaceInstruction(bounds_check, index);
+          RemoveBoundsCheck(bounds_check, MethodCompilationStat::kRemovedBoundsCheck);
         }
         return;
       }
@@ -894,7 +896,7 @@ class BCEVisitor final : public HGraphVisitor {
         ValueBound lower = existing_range->GetLower();
         DCHECK(lower.IsConstant());
         if (constant < lower.GetConstant()) {
-          ReplaceInstruction(bounds_check, index);
+          RemoveBoundsCheck(bounds_check, MethodCompilationStat::kRemovedBoundsCheck);
           return;
         } else {
           // Existing range isn't strong enough to eliminate the bounds check.
@@ -1487,7 +1489,8 @@ class BCEVisitor final : public HGraphVisitor {
           // Only replace if still in the graph. This avoids visiting the same
           // bounds check twice if it occurred multiple times in the use list.
           if (other_bounds_check->IsInBlock()) {
-            ReplaceInstruction(other_bounds_check, other_bounds_check->InputAt(0));
+            RemoveBoundsCheck(other_bounds_check,
+                              MethodCompilationStat::kRemovedBoundsCheckWithBlockDeoptimization);
           }
         }
       }
@@ -1620,7 +1623,8 @@ class BCEVisitor final : public HGraphVisitor {
                                            &min_lower,
                                            &min_upper);
           }
-          ReplaceInstruction(other_bounds_check, other_index);
+          RemoveBoundsCheck(other_bounds_check,
+                            MethodCompilationStat::kRemovedBoundsCheckWithLoopDeoptimization);
         }
       }
       // In code, using unsigned comparisons:
@@ -1691,7 +1695,8 @@ class BCEVisitor final : public HGraphVisitor {
         return false;
       }
       // Does loop have early-exits? If so, the full range may not be covered by the loop
-      // at runtime and testing the range may apply deoptimization unnecessarily.
+      // at runtime and testing the range may apply deoptimization unnecessarily. Exits that
+      // only throw are not counted (see IsThrowingExit()).
       if (IsEarlyExitLoop(loop)) {
         return false;
       }
@@ -1718,7 +1723,7 @@ class BCEVisitor final : public HGraphVisitor {
     HBlocksInLoopReversePostOrderIterator it_loop(*loop);
     for (it_loop.Advance(); !it_loop.Done(); it_loop.Advance()) {
       for (HBasicBlock* successor : it_loop.Current()->GetSuccessors()) {
-        if (!loop->Contains(*successor)) {
+        if (!loop->Contains(*successor) && !IsThrowingExit(successor)) {
           early_exit_loop_.Put(loop_id, true);
           return true;
         }
@@ -1728,6 +1733,26 @@ class BCEVisitor final : public HGraphVisitor {
     return false;
   }
 
+  /**
+   * Returns true if the block leaves the method by throwing, such as the failed argument
+   * check of an inlined callee. Such exits are exceptional, so the range computed for the
+   * loop still describes its common execution. A deoptimization taken where the loop would
+   * have thrown just lets the interpreter throw instead.
+   */
+  static bool IsThrowingExit(HBasicBlock* block) {
+    HBasicBlock* successor = block->GetSingleSuccessor();
+    if (successor == nullptr || !successor->IsExitBlock()) {
+      return false;
+    }
+    HInstruction* last = block->GetLastInstruction();
+    if (last->IsThrow()) {
+      return true;
+    }
+    // A call that always throws is followed by a goto to the exit block, see
+    // HDeadCodeElimination::SimplifyAlwaysThrows().
+    return last->IsGoto() && last->GetPrevious() != nullptr && last->GetPrevious()->AlwaysThrows();
+  }
+
   /**
    * Returns true if the array length is already loop invariant, or can be made so
    * by handling the null check under the hood of the array length operation.
@@ -2016,6 +2041,12 @@ class BCEVisitor final : public HGraphVisitor {
     return phi;
   }
 
+  /** Helper method to remove a bounds check, recording how it was eliminated. */
+  void RemoveBoundsCheck(HBoundsCheck* bounds_check, MethodCompilationStat stat) {
+    MaybeRecordStat(stats_, stat);
+    ReplaceInstruction(bounds_check, bounds_check->InputAt(0));
+  }
+
   /** Helper method to replace an instruction with another instruction. */
   void ReplaceInstruction(HInstruction* instruction, HInstruction* replacement) {
     // Safe iteration.
@@ -2058,6 +2089,9 @@ class BCEVisitor final : public HGraphVisitor {
   // Range analysis based on induction variables.
   InductionVarRange induction_range_;
 
+  // Compilation statistics, may be null.
+  OptimizingCompilerStats* const stats_;
+
   // Safe iteration.
   HInstruction* next_;
 
@@ -2074,7 +2108,7 @@ bool BoundsCheckElimination::Run() {
   // be bounded by a range at one instruction, it must be true that all uses of
   // that value dominated by that instruction fits in that range. Range of that
   // value can be narrowed further down in the dominator tree.
-  BCEVisitor visitor(graph_, side_effects_, induction_analysis_);
+  BCEVisitor visitor(graph_, side_effects_, induction_analysis_, stats_);
   for (size_t i = 0, size = graph_->GetReversePostOrder().size(); i != size; ++i) {
     HBasicBlock* current = graph_->GetReversePostOrder()[i];
     if (visitor.IsAddedBlock(current)) {
@@ -35,7 +35,7 @@ namespace art HIDDEN {
  */
 class BoundsCheckEliminationTest : public OptimizingUnitTest {
  public:
-  void RunBCE() {
+  void RunBCE(OptimizingCompilerStats* stats = nullptr) {
     graph_->SetHasBoundsChecks(true);
     graph_->BuildDominatorTree();
 
@@ -49,7 +49,7 @@ class BoundsCheckEliminationTest : public OptimizingUnitTest {
     HInductionVarAnalysis induction(graph_);
     induction.Run();
 
-    BoundsCheckElimination(graph_, side_effects, &induction).Run();
+    BoundsCheckElimination(graph_, side_effects, &induction, stats).Run();
   }
 
   HInstruction* BuildSSAGraph1(int initial, int increment, IfCondition cond = kCondGE);
@@ -485,6 +485,52 @@ TEST_F(BoundsCheckEliminationTest, LoopArrayBoundsElimination4c) {
   ASSERT_FALSE(IsRemoved(bounds_check));
 }
 
+// for (int i=0; i<n; i++) { if (flag) throw exception; array[i] = 10; }
+// The throwing exit, as left by an inlined argument check, does not prevent dynamic bce.
+TEST_F(BoundsCheckEliminationTest, LoopArrayBoundsEliminationWithThrowingExit) {
+  HBasicBlock* return_block = InitEntryMainExitGraphWithReturnVoid();
+  auto [pre_header, loop_header, loop_body] = CreateWhileLoop(return_block);
+
+  HInstruction* array = MakeParam(DataType::Type::kReference);
+  HInstruction* n = MakeParam(DataType::Type::kInt32);
+  HInstruction* flag = MakeParam(DataType::Type::kBool);
+  HInstruction* exception = MakeParam(DataType::Type::kReference);
+  HInstruction* constant_10 = graph_->GetIntConstant(10);
+
+  HInstruction* null_check = MakeNullCheck(pre_header, array);
+  HInstruction* array_length = MakeArrayLength(pre_header, null_check);
+
+  // Split the loop body into `loop_body`, which tests the flag, and `store_block`.
+  HBasicBlock* throw_block = AddNewBlock();
+  HBasicBlock* store_block = AddNewBlock();
+  loop_body->RemoveInstruction(loop_body->GetLastInstruction());
+  loop_body->ReplaceSuccessor(loop_header, store_block);
+  loop_body->AddSuccessor(throw_block);
+  loop_body->SwapSuccessors();  // The throw block is the true successor.
+  store_block->AddSuccessor(loop_header);
+  throw_block->AddSuccessor(exit_block_);
+
+  MakeSuspendCheck(loop_header);
+  auto [phi, add] = MakeLinearLoopVar(loop_header, loop_body, /*initial=*/ 0, /*increment=*/ 1);
+  HInstruction* cmp = MakeCondition(loop_header, kCondGE, phi, n);
+  MakeIf(loop_header, cmp);
+
+  MakeIf(loop_body, flag);
+
+  HThrow* throw_insn = new (GetAllocator()) HThrow(exception, kNoDexPc);
+  throw_block->AddInstruction(throw_insn);
+  ManuallyBuildEnvFor(throw_insn, {});
+
+  HInstruction* bounds_check = MakeBoundsCheck(store_block, phi, array_length);
+  MakeArraySet(store_block, null_check, bounds_check, constant_10, DataType::Type::kInt32);
+  MakeGoto(store_block);
+
+  OptimizingCompilerStats stats;
+  RunBCE(&stats);
+  ASSERT_TRUE(IsRemoved(bounds_check));
+  ASSERT_EQ(1u, stats.GetStat(MethodCompilationStat::kRemovedBoundsCheckWithLoopDeoptimization));
+}
+
 // Bubble sort:
 // (Every array access bounds-check can be eliminated.)
 // for (int i=0; i<array.length-1; i++) {
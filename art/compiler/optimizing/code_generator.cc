@@ -159,6 +159,37 @@ ReadBarrierOption CodeGenerator::GetCompilerReadBarrierOption() const {
   return EmitReadBarrier() ? kWithReadBarrier : kWithoutReadBarrier;
 }
 
+// Returns true if `holder` is allocated before `load` in the same block and no instruction in
+// between can reach a safepoint. The GC can start marking, or flip the allocation regions, only
+// at a safepoint, and objects allocated while marking are in the to-space or on the allocation
+// stack, so they stay non-gray until the next safepoint.
+static bool IsAllocatedWithoutSafepointBefore(HInstruction* holder, HInstruction* load) {
+  if (!holder->IsNewInstance() && !holder->IsNewArray()) {
+    return false;
+  }
+  if (holder->GetBlock() != load->GetBlock()) {
+    return false;
+  }
+  for (HInstruction* current = holder->GetNext(); current != load; current = current->GetNext()) {
+    if (current == nullptr || current->GetSideEffects().Includes(SideEffects::CanTriggerGC())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CodeGenerator::EmitReadBarrierForLoad(HInstruction* instruction) const {
+  DCHECK(instruction->IsInstanceFieldGet() ||
+         instruction->IsStaticFieldGet() ||
+         instruction->IsArrayGet()) << instruction->DebugName();
+  DCHECK_EQ(instruction->GetType(), DataType::Type::kReference);
+  if (!EmitReadBarrier()) {
+    return false;
+  }
+  return !kUseBakerReadBarrier ||
+         !IsAllocatedWithoutSafepointBefore(instruction->InputAt(0), instruction);
+}
+
 bool CodeGenerator::ShouldCheckGCCard(DataType::Type type,
                                       HInstruction* value,
                                       WriteBarrierKind write_barrier_kind) const {
@@ -605,6 +636,7 @@ void CodeGenerator::CreateStringBuilderAppendLocations(HStringBuilderAppend* ins
     StringBuilderAppend::Argument arg_type =
         static_cast<StringBuilderAppend::Argument>(f & StringBuilderAppend::kArgMask);
     switch (arg_type) {
+      case StringBuilderAppend::Argument::kObject:
       case StringBuilderAppend::Argument::kStringBuilder:
       case StringBuilderAppend::Argument::kString:
       case StringBuilderAppend::Argument::kCharArray:
@@ -1591,7 +1623,7 @@ LocationSummary* CodeGenerator::CreateThrowingSlowPathLocations(HInstruction* in
   }
   LocationSummary* locations =
       new (GetGraph()->GetAllocator()) LocationSummary(instruction, call_kind);
-  if (can_throw_into_catch_block && compiler_options_.GetImplicitNullChecks()) {
+  if (can_throw_into_catch_block && UseImplicitNullChecks()) {
     locations->SetCustomSlowPathCallerSaves(caller_saves);  // Default: no caller-save registers.
   }
   DCHECK(!instruction->HasUses());
@@ -1599,7 +1631,7 @@ LocationSummary* CodeGenerator::CreateThrowingSlowPathLocations(HInstruction* in
 }
 
 void CodeGenerator::GenerateNullCheck(HNullCheck* instruction) {
-  if (compiler_options_.GetImplicitNullChecks()) {
+  if (UseImplicitNullChecks()) {
     MaybeRecordStat(stats_, MethodCompilationStat::kImplicitNullCheckGenerated);
     GenerateImplicitNullCheck(instruction);
   } else {
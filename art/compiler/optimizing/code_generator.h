@@ -381,11 +381,22 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   void RecordCatchBlockInfo();
 
   const CompilerOptions& GetCompilerOptions() const { return compiler_options_; }
+  // Whether null checks are done by a faulting memory access at the use site.
+  bool UseImplicitNullChecks() const {
+    return compiler_options_.GetImplicitNullChecks() && !GetGraph()->UseExplicitNullChecks();
+  }
   bool EmitReadBarrier() const;
   bool EmitBakerReadBarrier() const;
   bool EmitNonBakerReadBarrier() const;
   ReadBarrierOption GetCompilerReadBarrierOption() const;
 
+  // Returns true if the reference load `instruction` (an `HInstanceFieldGet`, `HStaticFieldGet`
+  // or `HArrayGet`) needs a read barrier. With Baker read barriers, loads from an object
+  // allocated earlier in the same block with no possible safepoint in between do not need one:
+  // the marking state cannot change without a safepoint and a newly allocated object is never
+  // gray, so the fast path would always skip the mark entrypoint.
+  bool EmitReadBarrierForLoad(HInstruction* instruction) const;
+
   // Returns true if we should check the GC card for consistency purposes.
   bool ShouldCheckGCCard(DataType::Type type,
                          HInstruction* value,
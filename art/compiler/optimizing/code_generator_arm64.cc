@@ -2282,7 +2282,8 @@ void LocationsBuilderARM64::HandleFieldGet(HInstruction* instruction,
   DCHECK(instruction->IsInstanceFieldGet() || instruction->IsStaticFieldGet());
 
   bool object_field_get_with_read_barrier =
-      (instruction->GetType() == DataType::Type::kReference) && codegen_->EmitReadBarrier();
+      (instruction->GetType() == DataType::Type::kReference) &&
+      codegen_->EmitReadBarrierForLoad(instruction);
   LocationSummary* locations =
       new (GetGraph()->GetAllocator()) LocationSummary(instruction,
                                                        object_field_get_with_read_barrier
@@ -2324,8 +2325,10 @@ void InstructionCodeGeneratorARM64::HandleFieldGet(HInstruction* instruction,
   DataType::Type load_type = instruction->GetType();
   MemOperand field =
       HeapOperand(InputRegisterAt(instruction, receiver_input), field_info.GetFieldOffset());
+  bool emit_read_barrier =
+      (load_type == DataType::Type::kReference) && codegen_->EmitReadBarrierForLoad(instruction);
 
-  if (load_type == DataType::Type::kReference && codegen_->EmitBakerReadBarrier()) {
+  if (emit_read_barrier && kUseBakerReadBarrier) {
     // Object FieldGet with Baker's read barrier case.
     // /* HeapReference<Object> */ out = *(base + offset)
     Register base = RegisterFrom(base_loc, DataType::Type::kReference);
@@ -2358,11 +2361,12 @@ void InstructionCodeGeneratorARM64::HandleFieldGet(HInstruction* instruction,
       codegen_->Load(load_type, OutputCPURegister(instruction), field);
       codegen_->MaybeRecordImplicitNullCheck(instruction);
     }
-    if (load_type == DataType::Type::kReference) {
-      // If read barriers are enabled, emit read barriers other than
-      // Baker's using a slow path (and also unpoison the loaded
-      // reference, if heap poisoning is enabled).
+    if (emit_read_barrier) {
+      // Emit read barriers other than Baker's using a slow path
+      // (and also unpoison the loaded reference, if heap poisoning is enabled).
       codegen_->MaybeGenerateReadBarrierSlow(instruction, out, out, base_loc, offset);
+    } else if (load_type == DataType::Type::kReference) {
+      GetAssembler()->MaybeUnpoisonHeapReference(WRegisterFrom(out));
     }
   }
 }
@@ -2782,7 +2786,8 @@ void InstructionCodeGeneratorARM64::VisitMultiplyAccumulate(HMultiplyAccumulate*
 
 void LocationsBuilderARM64::VisitArrayGet(HArrayGet* instruction) {
   bool object_array_get_with_read_barrier =
-      (instruction->GetType() == DataType::Type::kReference) && codegen_->EmitReadBarrier();
+      (instruction->GetType() == DataType::Type::kReference) &&
+      codegen_->EmitReadBarrierForLoad(instruction);
   LocationSummary* locations =
       new (GetGraph()->GetAllocator()) LocationSummary(instruction,
                                                        object_array_get_with_read_barrier
@@ -2833,6 +2838,8 @@ void InstructionCodeGeneratorARM64::VisitArrayGet(HArrayGet* instruction) {
                                         instruction->IsStringCharAt();
   MacroAssembler* masm = GetVIXLAssembler();
   UseScratchRegisterScope temps(masm);
+  bool emit_read_barrier =
+      (type == DataType::Type::kReference) && codegen_->EmitReadBarrierForLoad(instruction);
 
   // The non-Baker read barrier instrumentation of object ArrayGet instructions
   // does not support the HIntermediateAddress instruction.
@@ -2840,7 +2847,7 @@ void InstructionCodeGeneratorARM64::VisitArrayGet(HArrayGet* instruction) {
            instruction->GetArray()->IsIntermediateAddress() &&
            codegen_->EmitNonBakerReadBarrier()));
 
-  if (type == DataType::Type::kReference && codegen_->EmitBakerReadBarrier()) {
+  if (emit_read_barrier && kUseBakerReadBarrier) {
     // Object ArrayGet with Baker's read barrier case.
     // Note that a potential implicit null check is handled in the
     // CodeGeneratorARM64::GenerateArrayLoadWithBakerReadBarrier call.
@@ -2939,7 +2946,7 @@ void InstructionCodeGeneratorARM64::VisitArrayGet(HArrayGet* instruction) {
       codegen_->MaybeRecordImplicitNullCheck(instruction);
     }
 
-    if (type == DataType::Type::kReference) {
+    if (emit_read_barrier) {
       static_assert(
           sizeof(mirror::HeapReference<mirror::Object>) == sizeof(int32_t),
           "art::mirror::HeapReference<art::mirror::Object> and int32_t have different sizes.");
@@ -2949,6 +2956,8 @@ void InstructionCodeGeneratorARM64::VisitArrayGet(HArrayGet* instruction) {
       } else {
         codegen_->MaybeGenerateReadBarrierSlow(instruction, out, out, obj_loc, offset, index);
       }
+    } else if (type == DataType::Type::kReference) {
+      GetAssembler()->MaybeUnpoisonHeapReference(WRegisterFrom(out));
     }
   }
 }
@@ -2094,16 +2094,6 @@ void InstructionCodeGeneratorRISCV64::GenTableBasedPackedSwitch(XRegister adjust
   __ Jr(temp);
 }
 
-int32_t InstructionCodeGeneratorRISCV64::VecAddress(LocationSummary* locations,
-                                                    size_t size,
-                                                    /*out*/ XRegister* adjusted_base) {
-  UNUSED(locations);
-  UNUSED(size);
-  UNUSED(adjusted_base);
-  LOG(FATAL) << "Unimplemented";
-  UNREACHABLE();
-}
-
 void LocationsBuilderRISCV64::HandleBinaryOp(HBinaryOperation* instruction) {
   DCHECK_EQ(instruction->InputCount(), 2u);
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
@@ -5506,438 +5496,6 @@ void InstructionCodeGeneratorRISCV64::VisitBitwiseNegatedRight(HBitwiseNegatedRi
   }
 }
 
-void LocationsBuilderRISCV64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecExtractScalar(HVecExtractScalar* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecExtractScalar(HVecExtractScalar* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecReduce(HVecReduce* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecReduce(HVecReduce* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecCnv(HVecCnv* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecCnv(HVecCnv* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecNeg(HVecNeg* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecNeg(HVecNeg* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecAbs(HVecAbs* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecAbs(HVecAbs* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecNot(HVecNot* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecNot(HVecNot* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecAdd(HVecAdd* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecAdd(HVecAdd* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecSub(HVecSub* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecSub(HVecSub* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecMul(HVecMul* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecMul(HVecMul* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecDiv(HVecDiv* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecDiv(HVecDiv* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecMin(HVecMin* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecMin(HVecMin* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecMax(HVecMax* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecMax(HVecMax* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecAnd(HVecAnd* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecAnd(HVecAnd* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecAndNot(HVecAndNot* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecAndNot(HVecAndNot* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecOr(HVecOr* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecOr(HVecOr* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecXor(HVecXor* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecXor(HVecXor* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecSaturationSub(HVecSaturationSub* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecSaturationSub(HVecSaturationSub* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecShl(HVecShl* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecShl(HVecShl* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecShr(HVecShr* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecShr(HVecShr* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecUShr(HVecUShr* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecUShr(HVecUShr* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecSetScalars(HVecSetScalars* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecSetScalars(HVecSetScalars* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecMultiplyAccumulate(HVecMultiplyAccumulate* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecMultiplyAccumulate(
-    HVecMultiplyAccumulate* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecDotProd(HVecDotProd* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecDotProd(HVecDotProd* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecLoad(HVecLoad* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecLoad(HVecLoad* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecStore(HVecStore* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecStore(HVecStore* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecPredSetAll(HVecPredSetAll* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecPredSetAll(HVecPredSetAll* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecPredWhile(HVecPredWhile* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecPredWhile(HVecPredWhile* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecPredToBoolean(HVecPredToBoolean* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecPredToBoolean(HVecPredToBoolean* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecEqual(HVecEqual* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecEqual(HVecEqual* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecNotEqual(HVecNotEqual* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecNotEqual(HVecNotEqual* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecLessThan(HVecLessThan* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecLessThan(HVecLessThan* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecLessThanOrEqual(HVecLessThanOrEqual* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecLessThanOrEqual(HVecLessThanOrEqual* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecGreaterThan(HVecGreaterThan* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecGreaterThan(HVecGreaterThan* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecGreaterThanOrEqual(HVecGreaterThanOrEqual* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecGreaterThanOrEqual(
-    HVecGreaterThanOrEqual* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecBelow(HVecBelow* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecBelow(HVecBelow* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecBelowOrEqual(HVecBelowOrEqual* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecBelowOrEqual(HVecBelowOrEqual* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecAbove(HVecAbove* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecAbove(HVecAbove* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecAboveOrEqual(HVecAboveOrEqual* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecAboveOrEqual(HVecAboveOrEqual* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void LocationsBuilderRISCV64::VisitVecPredNot(HVecPredNot* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
-void InstructionCodeGeneratorRISCV64::VisitVecPredNot(HVecPredNot* instruction) {
-  UNUSED(instruction);
-  LOG(FATAL) << "Unimplemented";
-}
-
 namespace detail {
 
 // Mark which intrinsics we don't have handcrafted code for.
@@ -6263,7 +5821,10 @@ void CodeGeneratorRISCV64::MoveLocation(Location destination,
     DCHECK((destination.IsFpuRegister() && DataType::IsFloatingPointType(dst_type)) ||
            (destination.IsRegister() && !DataType::IsFloatingPointType(dst_type)));
 
-    if (source.IsStackSlot() || source.IsDoubleStackSlot()) {
+    if (source.IsSIMDStackSlot()) {
+      DCHECK(destination.IsFpuRegister());
+      GetInstructionVisitor()->LoadSIMDRegFromStack(destination, source);
+    } else if (source.IsStackSlot() || source.IsDoubleStackSlot()) {
       // Move to GPR/FPR from stack
       if (DataType::IsFloatingPointType(dst_type)) {
         if (DataType::Is64BitType(dst_type)) {
@@ -6316,8 +5877,9 @@ void CodeGeneratorRISCV64::MoveLocation(Location destination,
     } else if (source.IsFpuRegister()) {
       if (destination.IsFpuRegister()) {
         if (GetGraph()->HasSIMD()) {
-          LOG(FATAL) << "Vector extension is unsupported";
-          UNREACHABLE();
+          // The location may hold either a scalar or a vector, so move both.
+          __ FMvD(destination.AsFpuRegister<FRegister>(), source.AsFpuRegister<FRegister>());
+          GetInstructionVisitor()->MoveSIMDRegToSIMDReg(destination, source);
         } else {
           // Move to FPR from FPR
           if (dst_type == DataType::Type::kFloat32) {
@@ -6337,8 +5899,7 @@ void CodeGeneratorRISCV64::MoveLocation(Location destination,
       }
     }
   } else if (destination.IsSIMDStackSlot()) {
-    LOG(FATAL) << "SIMD is unsupported";
-    UNREACHABLE();
+    GetInstructionVisitor()->MoveToSIMDStackSlot(destination, source);
   } else {  // The destination is not a register. It must be a stack slot.
     DCHECK(destination.IsStackSlot() || destination.IsDoubleStackSlot());
     if (source.IsRegister() || source.IsFpuRegister()) {
@@ -6448,22 +6009,26 @@ size_t CodeGeneratorRISCV64::RestoreCoreRegister(size_t stack_index, uint32_t re
 }
 
 size_t CodeGeneratorRISCV64::SaveFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
+  __ FStored(FRegister(reg_id), SP, stack_index);
   if (GetGraph()->HasSIMD()) {
-    // TODO(riscv64): RISC-V vector extension.
-    UNIMPLEMENTED(FATAL) << "Vector extension is unsupported";
-    UNREACHABLE();
+    // Save the paired V register after the scalar value which stack maps expect at
+    // `stack_index`. See `GetSlowPathFPWidth()`.
+    GetInstructionVisitor()->MoveToSIMDStackSlot(
+        Location::SIMDStackSlot(stack_index + kRiscv64FloatRegSizeInBytes),
+        Location::FpuRegisterLocation(reg_id));
+    return kRiscv64FloatRegSizeInBytes + kRiscv64SIMDRegSizeInBytes;
   }
-  __ FStored(FRegister(reg_id), SP, stack_index);
   return kRiscv64FloatRegSizeInBytes;
 }
 
 size_t CodeGeneratorRISCV64::RestoreFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
+  __ FLoadd(FRegister(reg_id), SP, stack_index);
   if (GetGraph()->HasSIMD()) {
-    // TODO(riscv64): RISC-V vector extension.
-    UNIMPLEMENTED(FATAL) << "Vector extension is unsupported";
-    UNREACHABLE();
+    GetInstructionVisitor()->LoadSIMDRegFromStack(
+        Location::FpuRegisterLocation(reg_id),
+        Location::SIMDStackSlot(stack_index + kRiscv64FloatRegSizeInBytes));
+    return kRiscv64FloatRegSizeInBytes + kRiscv64SIMDRegSizeInBytes;
   }
-  __ FLoadd(FRegister(reg_id), SP, stack_index);
   return kRiscv64FloatRegSizeInBytes;
 }
 
@@ -7209,10 +6774,7 @@ void CodeGeneratorRISCV64::SwapLocations(Location loc1, Location loc2, DataType:
   if ((is_slot1 != is_slot2) ||
       (loc2.IsRegister() && loc1.IsRegister()) ||
       (is_fp_reg2 && is_fp_reg1)) {
-    if ((is_fp_reg2 && is_fp_reg1) && GetGraph()->HasSIMD()) {
-      LOG(FATAL) << "Unsupported";
-      UNREACHABLE();
-    }
+    // Note: In graphs with SIMD, moving through FTMP also moves the paired VTMP.
     ScratchRegisterScope srs(GetAssembler());
     Location tmp = (is_fp_reg2 || is_fp_reg1)
         ? Location::FpuRegisterLocation(srs.AllocateFRegister())
@@ -7222,12 +6784,23 @@ void CodeGeneratorRISCV64::SwapLocations(Location loc1, Location loc2, DataType:
     MoveLocation(loc2, tmp, type);
   } else if (is_slot1 && is_slot2) {
     move_resolver_.Exchange(loc1.GetStackIndex(), loc2.GetStackIndex(), loc1.IsDoubleStackSlot());
-  } else if (is_simd1 && is_simd2) {
-    // TODO(riscv64): Add VECTOR/SIMD later.
-    UNIMPLEMENTED(FATAL) << "Vector extension is unsupported";
-  } else if ((is_fp_reg1 && is_simd2) || (is_fp_reg2 && is_simd1)) {
-    // TODO(riscv64): Add VECTOR/SIMD later.
-    UNIMPLEMENTED(FATAL) << "Vector extension is unsupported";
+  } else if ((is_simd1 && is_simd2) ||
+             (is_fp_reg1 && is_simd2) ||
+             (is_fp_reg2 && is_simd1)) {
+    // Reserve FTMP so that nothing else uses the paired VTMP.
+    ScratchRegisterScope srs(GetAssembler());
+    Location tmp = Location::FpuRegisterLocation(srs.AllocateFRegister());
+    DCHECK_EQ(static_cast<uint32_t>(tmp.reg()), static_cast<uint32_t>(VTMP));
+    Location simd_slot = is_simd1 ? loc1 : loc2;
+    Location other = is_simd1 ? loc2 : loc1;
+    InstructionCodeGeneratorRISCV64* visitor = GetInstructionVisitor();
+    visitor->LoadSIMDRegFromStack(tmp, simd_slot);
+    visitor->MoveToSIMDStackSlot(simd_slot, other);
+    if (other.IsSIMDStackSlot()) {
+      visitor->MoveToSIMDStackSlot(other, tmp);
+    } else {
+      visitor->MoveSIMDRegToSIMDReg(other, tmp);
+    }
   } else {
     LOG(FATAL) << "Unimplemented swap between locations " << loc1 << " and " << loc2;
   }
@@ -55,6 +55,13 @@ static_assert(kSignalingNaN == 0x100);
 static_assert(kQuietNaN == 0x200);
 static constexpr int32_t kFClassNaNMinValue = 0x100;
 
+// Vectorized loops use 128-bit vectors, the minimum VLEN guaranteed by the "V" extension.
+// A vector value is allocated an FP register and lives in the V register with the same number,
+// so the V register paired with the reserved FTMP serves as a scratch vector register.
+static constexpr size_t kRiscv64SIMDRegSizeInBytes = 16;
+static constexpr VRegister VTMP = V31;
+static_assert(static_cast<uint32_t>(VTMP) == static_cast<uint32_t>(FTMP));
+
 #define UNIMPLEMENTED_INTRINSIC_LIST_RISCV64(V) \
   V(FP16Ceil)                                   \
   V(FP16Compare)                                \
@@ -301,6 +308,17 @@ class InstructionCodeGeneratorRISCV64 : public InstructionCodeGenerator {
 
   void ShNAdd(XRegister rd, XRegister rs1, XRegister rs2, DataType::Type type);
 
+  // Set `vl` and `vtype` for `vector_length` elements of `type`. Tail elements are agnostic
+  // unless `tail_undisturbed` is requested.
+  void SetVectorConfiguration(DataType::Type type,
+                              size_t vector_length,
+                              bool tail_undisturbed = false);
+
+  // Helpers for moving SIMD values, see `kRiscv64SIMDRegSizeInBytes`.
+  void MoveSIMDRegToSIMDReg(Location destination, Location source);
+  void MoveToSIMDStackSlot(Location destination, Location source);
+  void LoadSIMDRegFromStack(Location destination, Location source);
+
  protected:
   void GenerateClassInitializationCheck(SlowPathCodeRISCV64* slow_path, XRegister class_reg);
   void GenerateBitstringTypeCheckCompare(HTypeCheckInstruction* check, XRegister temp);
@@ -383,9 +401,7 @@ class InstructionCodeGeneratorRISCV64 : public InstructionCodeGenerator {
                                  XRegister temp,
                                  uint32_t num_entries,
                                  HBasicBlock* switch_block);
-  int32_t VecAddress(LocationSummary* locations,
-                     size_t size,
-                     /*out*/ XRegister* adjusted_base);
+  void VecAddress(LocationSummary* locations, DataType::Type type, XRegister rd);
 
   template <typename Reg,
             void (Riscv64Assembler::*opS)(Reg, FRegister, FRegister),
@@ -443,8 +459,10 @@ class CodeGeneratorRISCV64 : public CodeGenerator {
   // Note: In SIMD graphs this should return SIMD register width as all FP and SIMD registers
   // alias and live SIMD registers are forced to be spilled in full size in the slow paths.
   size_t GetSlowPathFPWidth() const override {
-    // Default implementation.
-    return GetCalleePreservedFPWidth();
+    // In graphs with SIMD, both the FP register and its paired V register are saved.
+    return GetGraph()->HasSIMD()
+        ? GetCalleePreservedFPWidth() + kRiscv64SIMDRegSizeInBytes
+        : GetCalleePreservedFPWidth();
   }
 
   size_t GetCalleePreservedFPWidth() const override {
@@ -452,9 +470,10 @@ class CodeGeneratorRISCV64 : public CodeGenerator {
   };
 
   size_t GetSIMDRegisterWidth() const override {
-    // TODO(riscv64): Implement SIMD with the Vector extension.
     // Note: HLoopOptimization calls this function even for an ISA without SIMD support.
-    return kRiscv64FloatRegSizeInBytes;
+    return GetInstructionSetFeatures().HasVector()
+        ? kRiscv64SIMDRegSizeInBytes
+        : kRiscv64FloatRegSizeInBytes;
   };
 
   uintptr_t GetAddressOf(HBasicBlock* block) override {
@@ -0,0 +1,857 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_generator_riscv64.h"
+
+#include "mirror/array-inl.h"
+
+namespace art HIDDEN {
+namespace riscv64 {
+
+// NOLINT on __ macro to suppress wrong warning/fix (misc-macro-parentheses) from clang-tidy.
+#define __ down_cast<Riscv64Assembler*>(GetAssembler())->  // NOLINT
+
+using LengthMultiplier = Riscv64Assembler::LengthMultiplier;
+using SelectedElementWidth = Riscv64Assembler::SelectedElementWidth;
+using VectorMaskAgnostic = Riscv64Assembler::VectorMaskAgnostic;
+using VectorTailAgnostic = Riscv64Assembler::VectorTailAgnostic;
+
+// Vector values live in the V register with the same number as the allocated FP register.
+static VRegister VRegisterFrom(Location location) {
+  DCHECK(location.IsFpuRegister()) << location;
+  return static_cast<VRegister>(location.reg());
+}
+
+static SelectedElementWidth ElementWidthFor(DataType::Type type) {
+  switch (DataType::Size(type)) {
+    case 1u:
+      return SelectedElementWidth::kE8;
+    case 2u:
+      return SelectedElementWidth::kE16;
+    case 4u:
+      return SelectedElementWidth::kE32;
+    case 8u:
+      return SelectedElementWidth::kE64;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << type;
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorRISCV64::SetVectorConfiguration(DataType::Type type,
+                                                             size_t vector_length,
+                                                             bool tail_undisturbed) {
+  DCHECK_EQ(DataType::Size(type) * vector_length, kRiscv64SIMDRegSizeInBytes);
+  VectorTailAgnostic vta =
+      tail_undisturbed ? VectorTailAgnostic::kUndisturbed : VectorTailAgnostic::kAgnostic;
+  uint32_t vtypei = Riscv64Assembler::VTypeiValue(
+      VectorMaskAgnostic::kAgnostic, vta, ElementWidthFor(type), LengthMultiplier::kM1);
+  __ VSetivli(Zero, dchecked_integral_cast<uint32_t>(vector_length), vtypei);
+}
+
+void InstructionCodeGeneratorRISCV64::MoveSIMDRegToSIMDReg(Location destination,
+                                                           Location source) {
+  SetVectorConfiguration(DataType::Type::kInt8, kRiscv64SIMDRegSizeInBytes);
+  __ VMv_vv(VRegisterFrom(destination), VRegisterFrom(source));
+}
+
+void InstructionCodeGeneratorRISCV64::MoveToSIMDStackSlot(Location destination,
+                                                          Location source) {
+  DCHECK(destination.IsSIMDStackSlot());
+  ScratchRegisterScope srs(GetAssembler());
+  XRegister tmp = srs.AllocateXRegister();
+  if (source.IsFpuRegister()) {
+    __ AddConst64(tmp, SP, destination.GetStackIndex());
+    SetVectorConfiguration(DataType::Type::kInt8, kRiscv64SIMDRegSizeInBytes);
+    __ VSe8(VRegisterFrom(source), tmp);
+  } else {
+    DCHECK(source.IsSIMDStackSlot());
+    __ Loadd(tmp, SP, source.GetStackIndex());
+    __ Stored(tmp, SP, destination.GetStackIndex());
+    __ Loadd(tmp, SP, source.GetStackIndex() + kRiscv64DoublewordSize);
+    __ Stored(tmp, SP, destination.GetStackIndex() + kRiscv64DoublewordSize);
+  }
+}
+
+void InstructionCodeGeneratorRISCV64::LoadSIMDRegFromStack(Location destination,
+                                                           Location source) {
+  DCHECK(source.IsSIMDStackSlot());
+  ScratchRegisterScope srs(GetAssembler());
+  XRegister tmp = srs.AllocateXRegister();
+  __ AddConst64(tmp, SP, source.GetStackIndex());
+  SetVectorConfiguration(DataType::Type::kInt8, kRiscv64SIMDRegSizeInBytes);
+  __ VLe8(VRegisterFrom(destination), tmp);
+}
+
+void LocationsBuilderRISCV64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  HInstruction* input = instruction->InputAt(0);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, IsZeroBitPattern(input) ? Location::ConstantLocation(input)
+                                                    : Location::RequiresRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, IsZeroBitPattern(input) ? Location::ConstantLocation(input)
+                                                    : Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  Location src_loc = locations->InAt(0);
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  if (src_loc.IsConstant()) {
+    __ VMv_vi(dst, 0);
+    return;
+  }
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      // Only the low SEW bits of the source register are used.
+      __ VMv_vx(dst, src_loc.AsRegister<XRegister>());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFmv_v_f(dst, src_loc.AsFpuRegister<FRegister>());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecExtractScalar(HVecExtractScalar* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresRegister());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecExtractScalar(HVecExtractScalar* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      // Element 0 is sign-extended to XLEN which is the canonical form of `int` as well.
+      __ VMv_x_s(locations->Out().AsRegister<XRegister>(), src);
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      // A `float` result is NaN-boxed.
+      __ VFmv_f_s(locations->Out().AsFpuRegister<FRegister>(), src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector unary operations.
+static void CreateVecUnOpLocations(ArenaAllocator* allocator, HVecUnaryOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister(),
+                        instruction->IsVecReduce() ? Location::kOutputOverlap
+                                                   : Location::kNoOutputOverlap);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecReduce(HVecReduce* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      DCHECK_EQ(instruction->GetReductionKind(), HVecReduce::kSum);
+      SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+      // The reduction adds all elements of `src` to element 0 of the initial value.
+      __ VMv_s_x(VTMP, Zero);
+      __ VRedsum_vs(dst, src, VTMP);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecCnv(HVecCnv* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecCnv(HVecCnv* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  DataType::Type from = instruction->GetInputType();
+  DataType::Type to = instruction->GetResultType();
+  if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
+    SetVectorConfiguration(from, instruction->GetVectorLength());
+    __ VFcvt_f_x_v(dst, src);
+  } else {
+    LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecNeg(HVecNeg* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecNeg(HVecNeg* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VNeg_v(dst, src);
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFneg_v(dst, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecAbs(HVecAbs* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecAbs(HVecAbs* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderRISCV64::VisitVecNot(HVecNot* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecNot(HVecNot* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:  // special case boolean-not
+      __ VXor_vi(dst, src, 1);
+      break;
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VNot_v(dst, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector binary operations.
+static void CreateVecBinOpLocations(ArenaAllocator* allocator, HVecBinaryOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to generate a vector binary operation with separate integral and FP instructions.
+template <void (Riscv64Assembler::*opInt)(VRegister, VRegister, VRegister, Riscv64Assembler::VM),
+          void (Riscv64Assembler::*opFp)(VRegister, VRegister, VRegister, Riscv64Assembler::VM)>
+static void GenerateVecBinOp(Riscv64Assembler* assembler, HVecBinaryOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      if constexpr (opInt != nullptr) {
+        // Note: The assembler takes `vs2` before `vs1` and computes `vs2 op vs1`.
+        (assembler->*opInt)(dst, lhs, rhs, Riscv64Assembler::VM::kUnmasked);
+        break;
+      }
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      if constexpr (opFp != nullptr) {
+        (assembler->*opFp)(dst, lhs, rhs, Riscv64Assembler::VM::kUnmasked);
+        break;
+      }
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecAdd(HVecAdd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecAdd(HVecAdd* instruction) {
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  GenerateVecBinOp<&Riscv64Assembler::VAdd_vv, &Riscv64Assembler::VFadd_vv>(GetAssembler(),
+                                                                            instruction);
+}
+
+void LocationsBuilderRISCV64::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderRISCV64::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderRISCV64::VisitVecSub(HVecSub* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSub(HVecSub* instruction) {
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  GenerateVecBinOp<&Riscv64Assembler::VSub_vv, &Riscv64Assembler::VFsub_vv>(GetAssembler(),
+                                                                            instruction);
+}
+
+void LocationsBuilderRISCV64::VisitVecSaturationSub(HVecSaturationSub* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSaturationSub(HVecSaturationSub* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderRISCV64::VisitVecMul(HVecMul* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecMul(HVecMul* instruction) {
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  GenerateVecBinOp<&Riscv64Assembler::VMul_vv, &Riscv64Assembler::VFmul_vv>(GetAssembler(),
+                                                                            instruction);
+}
+
+void LocationsBuilderRISCV64::VisitVecDiv(HVecDiv* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecDiv(HVecDiv* instruction) {
+  // Integral division is excluded by the vectorizer as it would need to handle division by zero.
+  DCHECK(DataType::IsFloatingPointType(instruction->GetPackedType()));
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  GenerateVecBinOp<nullptr, &Riscv64Assembler::VFdiv_vv>(GetAssembler(), instruction);
+}
+
+void LocationsBuilderRISCV64::VisitVecMin(HVecMin* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecMin(HVecMin* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderRISCV64::VisitVecMax(HVecMax* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecMax(HVecMax* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderRISCV64::VisitVecAnd(HVecAnd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecAnd(HVecAnd* instruction) {
+  DCHECK(!DataType::IsFloatingPointType(instruction->GetPackedType()));
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  GenerateVecBinOp<&Riscv64Assembler::VAnd_vv, nullptr>(GetAssembler(), instruction);
+}
+
+void LocationsBuilderRISCV64::VisitVecAndNot(HVecAndNot* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecAndNot(HVecAndNot* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderRISCV64::VisitVecOr(HVecOr* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecOr(HVecOr* instruction) {
+  DCHECK(!DataType::IsFloatingPointType(instruction->GetPackedType()));
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  GenerateVecBinOp<&Riscv64Assembler::VOr_vv, nullptr>(GetAssembler(), instruction);
+}
+
+void LocationsBuilderRISCV64::VisitVecXor(HVecXor* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecXor(HVecXor* instruction) {
+  DCHECK(!DataType::IsFloatingPointType(instruction->GetPackedType()));
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  GenerateVecBinOp<&Riscv64Assembler::VXor_vv, nullptr>(GetAssembler(), instruction);
+}
+
+// Helper to set up locations for vector shift operations.
+static void CreateVecShiftLocations(ArenaAllocator* allocator, HVecBinaryOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::ConstantLocation(instruction->InputAt(1)));
+      locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to generate a vector shift by a constant distance.
+template <void (Riscv64Assembler::*opVi)(VRegister, VRegister, uint32_t, Riscv64Assembler::VM),
+          void (Riscv64Assembler::*opVx)(VRegister, VRegister, XRegister, Riscv64Assembler::VM)>
+static void GenerateVecShift(Riscv64Assembler* assembler, HVecBinaryOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  // The distance has been masked to the element size by the vectorizer.
+  int64_t distance = CodeGenerator::GetInt64ValueOf(locations->InAt(1).GetConstant());
+  DCHECK(IsUint<6>(distance)) << distance;
+  if (IsUint<5>(distance)) {
+    (assembler->*opVi)(dst, lhs, dchecked_integral_cast<uint32_t>(distance),
+                       Riscv64Assembler::VM::kUnmasked);
+  } else {
+    ScratchRegisterScope srs(assembler);
+    XRegister tmp = srs.AllocateXRegister();
+    assembler->Li(tmp, distance);
+    (assembler->*opVx)(dst, lhs, tmp, Riscv64Assembler::VM::kUnmasked);
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecShl(HVecShl* instruction) {
+  CreateVecShiftLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecShl(HVecShl* instruction) {
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  GenerateVecShift<&Riscv64Assembler::VSll_vi, &Riscv64Assembler::VSll_vx>(GetAssembler(),
+                                                                           instruction);
+}
+
+void LocationsBuilderRISCV64::VisitVecShr(HVecShr* instruction) {
+  CreateVecShiftLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecShr(HVecShr* instruction) {
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  GenerateVecShift<&Riscv64Assembler::VSra_vi, &Riscv64Assembler::VSra_vx>(GetAssembler(),
+                                                                           instruction);
+}
+
+void LocationsBuilderRISCV64::VisitVecUShr(HVecUShr* instruction) {
+  CreateVecShiftLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecUShr(HVecUShr* instruction) {
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  GenerateVecShift<&Riscv64Assembler::VSrl_vi, &Riscv64Assembler::VSrl_vx>(GetAssembler(),
+                                                                           instruction);
+}
+
+void LocationsBuilderRISCV64::VisitVecSetScalars(HVecSetScalars* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+
+  DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
+
+  HInstruction* input = instruction->InputAt(0);
+  bool is_zero = IsZeroBitPattern(input);
+
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, is_zero ? Location::ConstantLocation(input)
+                                    : Location::RequiresRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, is_zero ? Location::ConstantLocation(input)
+                                    : Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSetScalars(HVecSetScalars* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister dst = VRegisterFrom(locations->Out());
+
+  DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
+
+  // Zero out all other elements first.
+  SetVectorConfiguration(instruction->GetPackedType(), instruction->GetVectorLength());
+  __ VMv_vi(dst, 0);
+
+  // Shorthand for any type of zero.
+  if (IsZeroBitPattern(instruction->InputAt(0))) {
+    return;
+  }
+
+  // Set required elements. The other elements must stay zero, so use an undisturbed tail.
+  SetVectorConfiguration(
+      instruction->GetPackedType(), instruction->GetVectorLength(), /*tail_undisturbed=*/ true);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VMv_s_x(dst, locations->InAt(0).AsRegister<XRegister>());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFmv_s_f(dst, locations->InAt(0).AsFpuRegister<FRegister>());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecMultiplyAccumulate(HVecMultiplyAccumulate* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecMultiplyAccumulate(
+    HVecMultiplyAccumulate* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderRISCV64::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderRISCV64::VisitVecDotProd(HVecDotProd* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecDotProd(HVecDotProd* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+// Helper to set up locations for vector memory operations.
+static void CreateVecMemLocations(ArenaAllocator* allocator,
+                                  HVecMemoryOperation* instruction,
+                                  bool is_load) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::RegisterOrConstant(instruction->InputAt(1)));
+      if (is_load) {
+        locations->SetOut(Location::RequiresFpuRegister());
+      } else {
+        locations->SetInAt(2, Location::RequiresFpuRegister());
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to compute the address of the first accessed array element into `rd`.
+void InstructionCodeGeneratorRISCV64::VecAddress(LocationSummary* locations,
+                                                 DataType::Type type,
+                                                 XRegister rd) {
+  XRegister base = locations->InAt(0).AsRegister<XRegister>();
+  Location index = locations->InAt(1);
+  uint32_t offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+  if (index.IsConstant()) {
+    int64_t element_offset =
+        static_cast<int64_t>(index.GetConstant()->AsIntConstant()->GetValue())
+            << DataType::SizeShift(type);
+    __ AddConst64(rd, base, element_offset + offset);
+  } else {
+    ShNAdd(rd, index.AsRegister<XRegister>(), base, type);
+    __ AddConst64(rd, rd, offset);
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecLoad(HVecLoad* instruction) {
+  CreateVecMemLocations(GetGraph()->GetAllocator(), instruction, /*is_load*/ true);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecLoad(HVecLoad* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DataType::Type type = instruction->GetPackedType();
+  VRegister dst = VRegisterFrom(locations->Out());
+  // String.charAt() with compressed strings is excluded by the vectorizer.
+  DCHECK(!instruction->IsStringCharAt());
+  ScratchRegisterScope srs(GetAssembler());
+  XRegister address = srs.AllocateXRegister();
+  VecAddress(locations, type, address);
+  SetVectorConfiguration(type, instruction->GetVectorLength());
+  switch (DataType::Size(type)) {
+    case 1u:
+      __ VLe8(dst, address);
+      break;
+    case 2u:
+      __ VLe16(dst, address);
+      break;
+    case 4u:
+      __ VLe32(dst, address);
+      break;
+    case 8u:
+      __ VLe64(dst, address);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << type;
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecStore(HVecStore* instruction) {
+  CreateVecMemLocations(GetGraph()->GetAllocator(), instruction, /*is_load*/ false);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecStore(HVecStore* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DataType::Type type = instruction->GetPackedType();
+  VRegister src = VRegisterFrom(locations->InAt(2));
+  ScratchRegisterScope srs(GetAssembler());
+  XRegister address = srs.AllocateXRegister();
+  VecAddress(locations, type, address);
+  SetVectorConfiguration(type, instruction->GetVectorLength());
+  switch (DataType::Size(type)) {
+    case 1u:
+      __ VSe8(src, address);
+      break;
+    case 2u:
+      __ VSe16(src, address);
+      break;
+    case 4u:
+      __ VSe32(src, address);
+      break;
+    case 8u:
+      __ VSe64(src, address);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << type;
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecPredSetAll(HVecPredSetAll* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecPredSetAll(HVecPredSetAll* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderRISCV64::VisitVecPredWhile(HVecPredWhile* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecPredWhile(HVecPredWhile* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderRISCV64::VisitVecPredToBoolean(HVecPredToBoolean* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecPredToBoolean(HVecPredToBoolean* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderRISCV64::VisitVecPredNot(HVecPredNot* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecPredNot(HVecPredNot* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+#define FOR_EACH_VEC_CONDITION_INSTRUCTION(M) \
+  M(VecEqual)                                 \
+  M(VecNotEqual)                              \
+  M(VecLessThan)                              \
+  M(VecLessThanOrEqual)                       \
+  M(VecGreaterThan)                           \
+  M(VecGreaterThanOrEqual)                    \
+  M(VecBelow)                                 \
+  M(VecBelowOrEqual)                          \
+  M(VecAbove)                                 \
+  M(VecAboveOrEqual)
+#define DEFINE_UNIMPLEMENTED_VEC_CONDITION_VISITORS(Name)                        \
+  void LocationsBuilderRISCV64::Visit##Name(H##Name* instruction) {              \
+    LOG(FATAL) << "No SIMD for " << instruction->GetId();                        \
+    UNREACHABLE();                                                               \
+  }                                                                              \
+  void InstructionCodeGeneratorRISCV64::Visit##Name(H##Name* instruction) {      \
+    LOG(FATAL) << "No SIMD for " << instruction->GetId();                        \
+    UNREACHABLE();                                                               \
+  }
+FOR_EACH_VEC_CONDITION_INSTRUCTION(DEFINE_UNIMPLEMENTED_VEC_CONDITION_VISITORS)
+#undef DEFINE_UNIMPLEMENTED_VEC_CONDITION_VISITORS
+#undef FOR_EACH_VEC_CONDITION_INSTRUCTION
+
+#undef __
+
+}  // namespace riscv64
+}  // namespace art
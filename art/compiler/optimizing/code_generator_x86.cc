@@ -6468,7 +6468,7 @@ void InstructionCodeGeneratorX86::VisitUnresolvedStaticFieldSet(
 
 void LocationsBuilderX86::VisitNullCheck(HNullCheck* instruction) {
   LocationSummary* locations = codegen_->CreateThrowingSlowPathLocations(instruction);
-  Location loc = codegen_->GetCompilerOptions().GetImplicitNullChecks()
+  Location loc = codegen_->UseImplicitNullChecks()
       ? Location::RequiresRegister()
       : Location::Any();
   locations->SetInAt(0, loc);
@@ -5784,7 +5784,7 @@ void InstructionCodeGeneratorX86_64::VisitUnresolvedStaticFieldSet(
 
 void LocationsBuilderX86_64::VisitNullCheck(HNullCheck* instruction) {
   LocationSummary* locations = codegen_->CreateThrowingSlowPathLocations(instruction);
-  Location loc = codegen_->GetCompilerOptions().GetImplicitNullChecks()
+  Location loc = codegen_->UseImplicitNullChecks()
       ? Location::RequiresRegister()
       : Location::Any();
   locations->SetInAt(0, loc);
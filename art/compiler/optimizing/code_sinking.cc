@@ -16,6 +16,7 @@
 
 #include "code_sinking.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "android-base/logging.h"
@@ -38,6 +39,7 @@ bool CodeSinking::Run() {
   }
 
   UncommonBranchSinking();
+  ReturningBranchSinking();
   ReturnSinking();
   return true;
 }
@@ -73,6 +75,37 @@ void CodeSinking::UncommonBranchSinking() {
   }
 }
 
+void CodeSinking::ReturningBranchSinking() {
+  HBasicBlock* exit = graph_->GetExitBlock();
+  DCHECK(exit != nullptr);
+
+  // With a single return, all blocks eventually reach it and there is no branch to sink into.
+  // Like `ReturnSinking()`, we do not look through TryBoundary instructions.
+  size_t number_of_returns = std::count_if(
+      exit->GetPredecessors().begin(), exit->GetPredecessors().end(), [](HBasicBlock* pred) {
+        return pred->GetLastInstruction()->IsReturn() || pred->GetLastInstruction()->IsReturnVoid();
+      });
+  if (number_of_returns < 2u) {
+    return;
+  }
+
+  // Sinking code into the branch ending with a return moves allocations (and the stores to them)
+  // that are only used on that path out of the other paths, e.g.
+  //   Foo f = new Foo();
+  //   if (cond) { return f; }
+  //   return null;
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HBasicBlock*> return_blocks(allocator.Adapter(kArenaAllocMisc));
+  for (HBasicBlock* pred : exit->GetPredecessors()) {
+    if (pred->GetLastInstruction()->IsReturn() || pred->GetLastInstruction()->IsReturnVoid()) {
+      return_blocks.push_back(pred);
+    }
+  }
+  for (HBasicBlock* return_block : return_blocks) {
+    SinkCodeToUncommonBranch(return_block);
+  }
+}
+
 static bool IsInterestingInstruction(HInstruction* instruction) {
   // Instructions from the entry graph (for example constants) are never interesting to move.
   if (instruction->GetBlock() == instruction->GetBlock()->GetGraph()->GetEntryBlock()) {
@@ -24,8 +24,8 @@
 namespace art HIDDEN {
 
 /**
- * Optimization pass to move instructions into uncommon branches,
- * when it is safe to do so.
+ * Optimization pass to move instructions into uncommon branches, and into
+ * the returning branches that use them, when it is safe to do so.
  */
 class CodeSinking : public HOptimization {
  public:
@@ -45,6 +45,9 @@ class CodeSinking : public HOptimization {
   // blocks, to these blocks.
   void SinkCodeToUncommonBranch(HBasicBlock* end_block);
 
+  // Tries to sink code to the branches ending with a return, when there are several of them.
+  void ReturningBranchSinking();
+
   // Coalesces the Return/ReturnVoid instructions into one, if we have two or more. We do this to
   // avoid generating the exit frame code several times.
   void ReturnSinking();
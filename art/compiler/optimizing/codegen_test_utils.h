@@ -225,6 +225,12 @@ static void VerifyGeneratedCode(const CodeGenerator& codegen,
   CodeSimulatorContainer simulator(codegen.GetInstructionSet());
   if (simulator.CanSimulate()) {
     Expected result = SimulatorExecute<Expected>(simulator.Get(), f);
+    // Report the number of simulated instructions, for example in the `--gtest_output` XML
+    // report. It is deterministic, so it tracks the effect of compiler changes on the code.
+    ::testing::Test::RecordProperty(
+        std::string(GetInstructionSetString(codegen.GetInstructionSet())) +
+            "_simulated_instructions",
+        std::to_string(simulator.Get()->GetExecutedInstructionCount()));
     if (has_result) {
       ASSERT_EQ(expected, result);
     }
@@ -62,6 +62,13 @@ static constexpr size_t kMaximumNumberOfInstructionsForSmallMethod = 3;
 // to avoid creating large amount of nested environments.
 static constexpr size_t kMaximumNumberOfCumulatedDexRegisters = 32;
 
+// Limits for call sites which the profile reports as hot, where inlining pays off the most.
+static constexpr size_t kMaximumNumberOfTotalInstructionsForHotCallSite =
+    2 * kMaximumNumberOfTotalInstructions;
+static constexpr size_t kMaximumNumberOfCumulatedDexRegistersForHotCallSite =
+    2 * kMaximumNumberOfCumulatedDexRegisters;
+static constexpr size_t kHotCallSiteInlineMaxCodeUnitsFactor = 2;
+
 // Limit recursive call inlining, which do not benefit from too
 // much inlining compared to code locality.
 static constexpr size_t kMaximumNumberOfRecursiveCalls = 4;
@@ -71,12 +78,20 @@ static constexpr size_t kMaximumNumberOfRecursiveCalls = 4;
 // recursive calls at all.
 static constexpr size_t kMaximumNumberOfPolymorphicRecursiveCalls = 0;
 
+// Maximum number of receivers of a megamorphic call for which we inline the target.
+// Receivers are recorded in the inline cache in the order they are first seen, so these
+// tend to be the most common ones.
+static constexpr size_t kMaximumNumberOfMegamorphicInlinedTargets = 3;
+
 // Controls the use of inline caches in AOT mode.
 static constexpr bool kUseAOTInlineCaches = true;
 
 // Controls the use of inlining try catches.
 static constexpr bool kInlineTryCatches = true;
 
+// Controls the scaling of the inlining budgets by the hotness of call sites in the profile.
+static constexpr bool kUseProfileGuidedInliningBudget = true;
+
 // We check for line numbers to make sure the DepthString implementation
 // aligns the output nicely.
 #define LOG_INTERNAL(msg) \
@@ -135,6 +150,31 @@ void HInliner::UpdateInliningBudget() {
   }
 }
 
+size_t HInliner::GetInliningBudget(CallSiteHotness hotness) const {
+  switch (hotness) {
+    case CallSiteHotness::kUnknown:
+      return inlining_budget_;
+    case CallSiteHotness::kHot:
+      if (total_number_of_instructions_ >= kMaximumNumberOfTotalInstructionsForHotCallSite) {
+        return kMaximumNumberOfInstructionsForSmallMethod;
+      }
+      return std::max(
+          inlining_budget_,
+          kMaximumNumberOfTotalInstructionsForHotCallSite - total_number_of_instructions_);
+    case CallSiteHotness::kCold:
+      // Only inline methods which are small enough to not grow the code.
+      return kMaximumNumberOfInstructionsForSmallMethod;
+  }
+  LOG(FATAL) << "Unreachable";
+  UNREACHABLE();
+}
+
+size_t HInliner::GetMaximumNumberOfCumulatedDexRegisters(CallSiteHotness hotness) {
+  return hotness == CallSiteHotness::kHot
+      ? kMaximumNumberOfCumulatedDexRegistersForHotCallSite
+      : kMaximumNumberOfCumulatedDexRegisters;
+}
+
 bool HInliner::Run() {
   if (codegen_->GetCompilerOptions().GetInlineMaxCodeUnits() == 0) {
     // Inlining effectively disabled.
@@ -363,8 +403,11 @@ ArtMethod* HInliner::FindMethodFromCHA(ArtMethod* resolved_method) {
   if (!resolved_method->HasSingleImplementation()) {
     return nullptr;
   }
-  if (Runtime::Current()->IsAotCompiler()) {
-    // No CHA-based devirtulization for AOT compiler (yet).
+  const CompilerOptions& compiler_options = codegen_->GetCompilerOptions();
+  if (Runtime::Current()->IsAotCompiler() &&
+      (compiler_options.IsBootImage() || compiler_options.IsBootImageExtension())) {
+    // No CHA-based devirtualization when compiling the boot classpath, its classes
+    // are subclassed by every app.
     return nullptr;
   }
   if (Runtime::Current()->IsZygote()) {
@@ -394,6 +437,17 @@ ArtMethod* HInliner::FindMethodFromCHA(ArtMethod* resolved_method) {
     // rare occurence.
     return nullptr;
   }
+  if (Runtime::Current()->IsAotCompiler()) {
+    // The AOT code cannot register CHA dependencies, so the devirtualized call is
+    // guarded by an exact type check instead, see `TryInlineFromCHAWithTypeGuard`.
+    // Only do this for app classes, whose hierarchy is mostly known when compiling
+    // the app, and for concrete classes, which can be the exact type of a receiver.
+    ObjPtr<mirror::Class> single_impl_class = single_impl->GetDeclaringClass();
+    if (single_impl_class->IsAbstract() ||
+        !ContainsElement(compiler_options.GetDexFilesForOatFile(), single_impl->GetDexFile())) {
+      return nullptr;
+    }
+  }
   return single_impl;
 }
 
@@ -583,6 +637,9 @@ bool HInliner::TryInlineFromCHA(HInvoke* invoke_instruction) {
     return false;
   }
   LOG_NOTE() << "Try CHA-based inlining of " << method->PrettyMethod();
+  if (Runtime::Current()->IsAotCompiler()) {
+    return TryInlineFromCHAWithTypeGuard(invoke_instruction, method);
+  }
 
   uint32_t dex_pc = invoke_instruction->GetDexPc();
   HInstruction* cursor = invoke_instruction->GetPrevious();
@@ -603,6 +660,21 @@ bool HInliner::TryInlineFromCHA(HInvoke* invoke_instruction) {
   return true;
 }
 
+bool HInliner::TryInlineFromCHAWithTypeGuard(HInvoke* invoke_instruction, ArtMethod* method) {
+  // CHA assumptions made by dex2oat may not hold at runtime: classes loaded later, possibly
+  // by other class loaders, can override `method`. Inline it as if the call site had a
+  // monomorphic inline cache with the declaring class of `method`, so that other receivers
+  // take the original invoke instead of relying on CHA invalidation.
+  StackHandleScope<InlineCache::kIndividualCacheSize> classes(Thread::Current());
+  classes.NewHandle(method->GetDeclaringClass());
+  DCHECK(UseOnlyPolymorphicInliningWithNoDeopt());
+  if (!TryInlinePolymorphicCall(invoke_instruction, classes)) {
+    return false;
+  }
+  MaybeRecordStat(stats_, MethodCompilationStat::kCHAInlineWithTypeGuard);
+  return true;
+}
+
 bool HInliner::UseOnlyPolymorphicInliningWithNoDeopt() {
   // If we are compiling AOT or OSR, pretend the call using inline caches is polymorphic and
   // do not generate a deopt.
@@ -675,11 +747,17 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
     }
 
     case kInlineCacheMegamorphic: {
+      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
+      // The JIT inline cache holds the receivers seen first: emit a type switch for them,
+      // with the original invoke for the other receivers.
+      if (codegen_->GetCompilerOptions().IsJitCompiler() &&
+          TryInlinePolymorphicCall(invoke_instruction, classes, /* is_megamorphic= */ true)) {
+        return true;
+      }
       LOG_FAIL_NO_STAT()
           << "Interface or virtual call to "
           << invoke_instruction->GetMethodReference().PrettyMethod()
           << " is megamorphic and not inlined";
-      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
       return false;
     }
 
@@ -693,9 +771,7 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
   }
 }
 
-HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
-    HInvoke* invoke_instruction,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+InlineCache* HInliner::FindInlineCacheJIT(HInvoke* invoke_instruction) const {
   DCHECK(codegen_->GetCompilerOptions().IsJitCompiler());
 
   ArtMethod* caller = graph_->GetArtMethod();
@@ -720,13 +796,17 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
   if (cache == nullptr) {
     // Check the current graph profiling info.
     profiling_info = graph_->GetProfilingInfo();
-    if (profiling_info == nullptr) {
-      return kInlineCacheNoData;
+    if (profiling_info != nullptr) {
+      cache = profiling_info->GetInlineCache(invoke_instruction->GetDexPc());
     }
-
-    cache = profiling_info->GetInlineCache(invoke_instruction->GetDexPc());
   }
+  return cache;
+}
 
+HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
+    HInvoke* invoke_instruction,
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+  InlineCache* cache = FindInlineCacheJIT(invoke_instruction);
   if (cache == nullptr) {
     // Either we never hit this invoke and we never compiled the callee,
     // or the method wasn't resolved when we performed baseline compilation.
@@ -737,6 +817,44 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
   return GetInlineCacheType(*classes);
 }
 
+HInliner::CallSiteHotness HInliner::GetCallSiteHotness(HInvoke* invoke_instruction) const {
+  if (!kUseProfileGuidedInliningBudget) {
+    return CallSiteHotness::kUnknown;
+  }
+
+  if (codegen_->GetCompilerOptions().IsJitCompiler()) {
+    // Only virtual and interface calls have inline caches.
+    if (!invoke_instruction->IsInvokeVirtual() && !invoke_instruction->IsInvokeInterface()) {
+      return CallSiteHotness::kUnknown;
+    }
+    InlineCache* cache = FindInlineCacheJIT(invoke_instruction);
+    if (cache == nullptr) {
+      return CallSiteHotness::kUnknown;
+    }
+    StackHandleScope<InlineCache::kIndividualCacheSize> classes(Thread::Current());
+    Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(*cache, &classes);
+    // An empty inline cache means the call site never ran while the method was profiled.
+    return (classes.Size() == 0u) ? CallSiteHotness::kCold : CallSiteHotness::kHot;
+  }
+
+  const ProfileCompilationInfo* pci = codegen_->GetCompilerOptions().GetProfileCompilationInfo();
+  if (pci == nullptr) {
+    return CallSiteHotness::kUnknown;
+  }
+  ProfileCompilationInfo::MethodHotness hotness = pci->GetMethodHotness(MethodReference(
+      caller_compilation_unit_.GetDexFile(), caller_compilation_unit_.GetDexMethodIndex()));
+  if (!hotness.IsHot()) {
+    // Inlined callees are usually not hot on their own, they ran inlined in their callers.
+    return (depth_ == 0u) ? CallSiteHotness::kCold : CallSiteHotness::kUnknown;
+  }
+  // The profile records inline caches of the call sites which ran, see GetInlineCacheAOT.
+  const ProfileCompilationInfo::InlineCacheMap* inline_caches = hotness.GetInlineCacheMap();
+  DCHECK(inline_caches != nullptr);
+  return (inline_caches->find(invoke_instruction->GetDexPc()) != inline_caches->end())
+      ? CallSiteHotness::kHot
+      : CallSiteHotness::kUnknown;
+}
+
 HInliner::InlineCacheType HInliner::GetInlineCacheAOT(
     HInvoke* invoke_instruction,
     /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
@@ -1029,11 +1147,14 @@ static void MaybeReplaceAndRemove(HInstruction* new_instruction, HInstruction* o
 
 bool HInliner::TryInlinePolymorphicCall(
     HInvoke* invoke_instruction,
-    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes) {
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+    bool is_megamorphic) {
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
 
-  if (TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
+  // Calling the same target among all types seen is speculated with a deoptimization, which
+  // we do not want for a megamorphic call.
+  if (!is_megamorphic && TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
     return true;
   }
 
@@ -1043,7 +1164,9 @@ bool HInliner::TryInlinePolymorphicCall(
   bool all_targets_inlined = true;
   bool one_target_inlined = false;
   DCHECK_EQ(classes.Capacity(), InlineCache::kIndividualCacheSize);
-  uint8_t number_of_types = classes.Size();
+  uint8_t number_of_types = is_megamorphic
+      ? std::min<size_t>(classes.Size(), kMaximumNumberOfMegamorphicInlinedTargets)
+      : classes.Size();
   for (size_t i = 0; i != number_of_types; ++i) {
     DCHECK(classes.GetReference(i) != nullptr);
     Handle<mirror::Class> handle =
@@ -1066,7 +1189,7 @@ bool HInliner::TryInlinePolymorphicCall(
 
     // In monomorphic cases when UseOnlyPolymorphicInliningWithNoDeopt() is true, we call
     // `TryInlinePolymorphicCall` even though we are monomorphic.
-    const bool actually_monomorphic = number_of_types == 1;
+    const bool actually_monomorphic = !is_megamorphic && number_of_types == 1;
     DCHECK_IMPLIES(actually_monomorphic, UseOnlyPolymorphicInliningWithNoDeopt());
 
     // We only want to limit recursive polymorphic cases, not monomorphic ones.
@@ -1098,7 +1221,8 @@ bool HInliner::TryInlinePolymorphicCall(
 
       // If we have inlined all targets before, and this receiver is the last seen,
       // we deoptimize instead of keeping the original invoke instruction.
-      bool deoptimize = !UseOnlyPolymorphicInliningWithNoDeopt() &&
+      bool deoptimize = !is_megamorphic &&
+          !UseOnlyPolymorphicInliningWithNoDeopt() &&
           all_targets_inlined &&
           (i + 1 == number_of_types);
 
@@ -1125,7 +1249,9 @@ bool HInliner::TryInlinePolymorphicCall(
     return false;
   }
 
-  MaybeRecordStat(stats_, MethodCompilationStat::kInlinedPolymorphicCall);
+  MaybeRecordStat(stats_,
+                  is_megamorphic ? MethodCompilationStat::kInlinedMegamorphicCall
+                                 : MethodCompilationStat::kInlinedPolymorphicCall);
 
   // Lazily run type propagation to get the guards typed.
   run_extra_type_propagation_ = true;
@@ -1550,7 +1676,8 @@ bool HInliner::IsInliningSupported(const HInvoke* invoke_instruction,
 
 bool HInliner::IsInliningEncouraged(const HInvoke* invoke_instruction,
                                     ArtMethod* method,
-                                    const CodeItemDataAccessor& accessor) const {
+                                    const CodeItemDataAccessor& accessor,
+                                    CallSiteHotness hotness) const {
   if (CountRecursiveCallsOf(method) > kMaximumNumberOfRecursiveCalls) {
     LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedRecursiveBudget)
         << "Method "
@@ -1560,6 +1687,9 @@ bool HInliner::IsInliningEncouraged(const HInvoke* invoke_instruction,
   }
 
   size_t inline_max_code_units = codegen_->GetCompilerOptions().GetInlineMaxCodeUnits();
+  if (hotness == CallSiteHotness::kHot) {
+    inline_max_code_units *= kHotCallSiteInlineMaxCodeUnitsFactor;
+  }
   if (accessor.InsnsSizeInCodeUnits() > inline_max_code_units) {
     LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedCodeItem)
         << "Method " << method->PrettyMethod()
@@ -1660,17 +1790,24 @@ bool HInliner::TryBuildAndInline(HInvoke* invoke_instruction,
     return false;
   }
 
-  if (!IsInliningEncouraged(invoke_instruction, method, accessor)) {
+  CallSiteHotness hotness = GetCallSiteHotness(invoke_instruction);
+  if (!IsInliningEncouraged(invoke_instruction, method, accessor, hotness)) {
     return false;
   }
 
   if (!TryBuildAndInlineHelper(
-          invoke_instruction, method, receiver_type, return_replacement, is_speculative)) {
+          invoke_instruction, method, receiver_type, return_replacement, is_speculative, hotness)) {
     return false;
   }
 
   LOG_SUCCESS() << method->PrettyMethod();
+  outermost_graph_->IncrementNumberOfInlinedMethods();
   MaybeRecordStat(stats_, MethodCompilationStat::kInlinedInvoke);
+  if (hotness == CallSiteHotness::kHot) {
+    MaybeRecordStat(stats_, MethodCompilationStat::kInlinedHotCallSite);
+  } else if (hotness == CallSiteHotness::kCold) {
+    MaybeRecordStat(stats_, MethodCompilationStat::kInlinedColdCallSite);
+  }
   if (outermost_graph_ == graph_) {
     MaybeRecordStat(stats_, MethodCompilationStat::kInlinedLastInvoke);
   }
@@ -1981,7 +2118,8 @@ void HInliner::SubstituteArguments(HGraph* callee_graph,
 bool HInliner::CanInlineBody(const HGraph* callee_graph,
                              HInvoke* invoke,
                              size_t* out_number_of_instructions,
-                             bool is_speculative) const {
+                             bool is_speculative,
+                             CallSiteHotness hotness) const {
   ArtMethod* const resolved_method = callee_graph->GetArtMethod();
 
   HBasicBlock* exit_block = callee_graph->GetExitBlock();
@@ -2066,7 +2204,8 @@ bool HInliner::CanInlineBody(const HGraph* callee_graph,
   }
 
   const bool too_many_registers =
-      total_number_of_dex_registers_ > kMaximumNumberOfCumulatedDexRegisters;
+      total_number_of_dex_registers_ > GetMaximumNumberOfCumulatedDexRegisters(hotness);
+  const size_t inlining_budget = GetInliningBudget(hotness);
   bool needs_bss_check = false;
   const bool can_encode_in_stack_map = CanEncodeInlinedMethodInStackMap(
       *outer_compilation_unit_.GetDexFile(), resolved_method, codegen_, &needs_bss_check);
@@ -2096,7 +2235,7 @@ bool HInliner::CanInlineBody(const HGraph* callee_graph,
     for (HInstructionIterator instr_it(block->GetInstructions());
          !instr_it.Done();
          instr_it.Advance()) {
-      if (++number_of_instructions > inlining_budget_) {
+      if (++number_of_instructions > inlining_budget) {
         LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedInstructionBudget)
             << "Method " << resolved_method->PrettyMethod()
             << " is not inlined because the outer method has reached"
@@ -2177,7 +2316,8 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
                                        ArtMethod* resolved_method,
                                        ReferenceTypeInfo receiver_type,
                                        HInstruction** return_replacement,
-                                       bool is_speculative) {
+                                       bool is_speculative,
+                                       CallSiteHotness hotness) {
   DCHECK_IMPLIES(resolved_method->IsStatic(), !receiver_type.IsValid());
   DCHECK_IMPLIES(!resolved_method->IsStatic(), receiver_type.IsValid());
   const dex::CodeItem* code_item = resolved_method->GetCodeItem();
@@ -2280,10 +2420,12 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
                    invoke_instruction->GetEnvironment(),
                    code_item,
                    dex_compilation_unit,
-                   try_catch_inlining_allowed_for_recursive_inline);
+                   try_catch_inlining_allowed_for_recursive_inline,
+                   hotness);
 
   size_t number_of_instructions = 0;
-  if (!CanInlineBody(callee_graph, invoke_instruction, &number_of_instructions, is_speculative)) {
+  if (!CanInlineBody(
+          callee_graph, invoke_instruction, &number_of_instructions, is_speculative, hotness)) {
     return false;
   }
 
@@ -2320,7 +2462,8 @@ void HInliner::RunOptimizations(HGraph* callee_graph,
                                 HEnvironment* caller_environment,
                                 const dex::CodeItem* code_item,
                                 const DexCompilationUnit& dex_compilation_unit,
-                                bool try_catch_inlining_allowed_for_recursive_inline) {
+                                bool try_catch_inlining_allowed_for_recursive_inline,
+                                CallSiteHotness hotness) {
   // Note: if the outermost_graph_ is being compiled OSR, we should not run any
   // optimization that could lead to a HDeoptimize. The following optimizations do not.
   HDeadCodeElimination dce(callee_graph, inline_stats_, "dead_code_elimination$inliner");
@@ -2340,7 +2483,7 @@ void HInliner::RunOptimizations(HGraph* callee_graph,
 
   // Bail early for pathological cases on the environment (for example recursive calls,
   // or too large environment).
-  if (total_number_of_dex_registers_ > kMaximumNumberOfCumulatedDexRegisters) {
+  if (total_number_of_dex_registers_ > GetMaximumNumberOfCumulatedDexRegisters(hotness)) {
     LOG_NOTE() << "Calls in " << callee_graph->GetArtMethod()->PrettyMethod()
              << " will not be inlined because the outer method has reached"
              << " its environment budget limit.";
@@ -2349,7 +2492,7 @@ void HInliner::RunOptimizations(HGraph* callee_graph,
 
   // Bail early if we know we already are over the limit.
   size_t number_of_instructions = CountNumberOfInstructions(callee_graph);
-  if (number_of_instructions > inlining_budget_) {
+  if (number_of_instructions > GetInliningBudget(hotness)) {
     LOG_NOTE() << "Calls in " << callee_graph->GetArtMethod()->PrettyMethod()
              << " will not be inlined because the outer method has reached"
              << " its instruction budget limit. " << number_of_instructions;
@@ -82,6 +82,13 @@ class HInliner : public HOptimization {
     kInlineCacheMissingTypes = 5
   };
 
+  // How often a call site runs according to the profile, which scales the inlining budgets.
+  enum class CallSiteHotness {
+    kUnknown,
+    kHot,
+    kCold,
+  };
+
   bool TryInline(HInvoke* invoke_instruction);
 
   // Try to inline `resolved_method` in place of `invoke_instruction`. `do_rtp` is whether
@@ -105,7 +112,8 @@ class HInliner : public HOptimization {
                                ArtMethod* resolved_method,
                                ReferenceTypeInfo receiver_type,
                                HInstruction** return_replacement,
-                               bool is_speculative)
+                               bool is_speculative,
+                               CallSiteHotness hotness)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Substitutes parameters in the callee graph with their values from the caller.
@@ -120,7 +128,8 @@ class HInliner : public HOptimization {
                         HEnvironment* caller_environment,
                         const dex::CodeItem* code_item,
                         const DexCompilationUnit& dex_compilation_unit,
-                        bool try_catch_inlining_allowed_for_recursive_inline)
+                        bool try_catch_inlining_allowed_for_recursive_inline,
+                        CallSiteHotness hotness)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Try to recognize known simple patterns and replace invoke call with appropriate instructions.
@@ -151,7 +160,8 @@ class HInliner : public HOptimization {
   // inlining should be prevented.
   bool IsInliningEncouraged(const HInvoke* invoke_instruction,
                             art::ArtMethod* method,
-                            const CodeItemDataAccessor& accessor) const
+                            const CodeItemDataAccessor& accessor,
+                            CallSiteHotness hotness) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Inspects the body of a method (callee_graph) and returns whether it can be
@@ -162,7 +172,8 @@ class HInliner : public HOptimization {
   bool CanInlineBody(const HGraph* callee_graph,
                      HInvoke* invoke,
                      size_t* out_number_of_instructions,
-                     bool is_speculative) const
+                     bool is_speculative,
+                     CallSiteHotness hotness) const
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Create a new HInstanceFieldGet.
@@ -184,6 +195,12 @@ class HInliner : public HOptimization {
   bool TryInlineFromCHA(HInvoke* invoke_instruction)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Try inlining the single implementation `method` found by CHA in AOT code, where
+  // the call is guarded by a check of the receiver type with the original invoke as
+  // the fallback, instead of a deoptimization on CHA invalidation.
+  bool TryInlineFromCHAWithTypeGuard(HInvoke* invoke_instruction, ArtMethod* method)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // When we fail inlining `invoke_instruction`, we will try to devirtualize the
   // call.
   bool TryDevirtualize(HInvoke* invoke_instruction,
@@ -191,6 +208,23 @@ class HInliner : public HOptimization {
                        HInvoke** replacement)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return the inline cache of `invoke_instruction` in the JIT profiling infos, or null.
+  InlineCache* FindInlineCacheJIT(HInvoke* invoke_instruction) const
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Return how hot `invoke_instruction` is according to the AOT profile or the JIT inline
+  // caches. Call sites in hot methods with recorded receivers are hot, call sites in methods
+  // which are not hot in the profile, or which never ran in baseline code, are cold.
+  CallSiteHotness GetCallSiteHotness(HInvoke* invoke_instruction) const
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Return the instruction budget for inlining at a call site of the given `hotness`.
+  size_t GetInliningBudget(CallSiteHotness hotness) const;
+
+  // Return the limit of cumulated dex registers for inlining at a call site of the given
+  // `hotness`.
+  static size_t GetMaximumNumberOfCumulatedDexRegisters(CallSiteHotness hotness);
+
   // Try getting the inline cache from JIT code cache.
   // Return true if the inline cache was successfully allocated and the
   // invoke info was found in the profile info.
@@ -220,9 +254,12 @@ class HInliner : public HOptimization {
                                 const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Try to inline targets of a polymorphic call.
+  // Try to inline targets of a polymorphic call. If `is_megamorphic`, the inline cache has
+  // overflowed: only the first receivers are inlined, and the original invoke is kept as the
+  // fallback of the type switch instead of deoptimizing.
   bool TryInlinePolymorphicCall(HInvoke* invoke_instruction,
-                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
+                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+                                bool is_megamorphic = false)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool TryInlinePolymorphicCallToSameTarget(
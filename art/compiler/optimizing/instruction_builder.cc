@@ -35,7 +35,9 @@
 #include "intrinsics_utils.h"
 #include "jit/jit.h"
 #include "jit/profiling_info.h"
+#include "mirror/call_site-inl.h"
 #include "mirror/dex_cache.h"
+#include "mirror/method_handle_impl-inl.h"
 #include "oat/oat_file.h"
 #include "optimizing/data_type.h"
 #include "optimizing_compiler_stats.h"
@@ -815,6 +817,35 @@ static bool IsFallthroughInstruction(const Instruction& instruction,
   return block->GetSingleSuccessor()->GetDexPc() == next_dex_pc;
 }
 
+void HInstructionBuilder::BuildSwitchBinarySearch(const DexSwitchTable& table,
+                                                  HInstruction* value,
+                                                  uint32_t dex_pc) {
+  // See `HBasicBlockBuilder::ConnectSwitchBinarySearch()` for the blocks and their successors.
+  HBasicBlock* switch_block = current_block_;
+  const size_t num_entries = table.GetNumEntries();
+  auto get_range_block = [&](size_t lo, size_t hi) {
+    return (lo == 0u && hi == num_entries)
+        ? switch_block
+        : FindBlockStartingAt(SwitchDecisionTree::GetRangeDexPc(table, lo, hi));
+  };
+  SwitchDecisionTree::VisitSplits(table, [&](size_t lo, size_t mid, size_t hi) {
+    current_block_ = get_range_block(lo, hi);
+    HInstruction* key = graph_->GetIntConstant(table.GetEntryAt(mid));
+    HLessThan* comparison = new (allocator_) HLessThan(value, key, dex_pc);
+    AppendInstruction(comparison);
+    AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
+  });
+  SwitchDecisionTree::VisitLinearRanges(table, [&](size_t lo, size_t hi) {
+    for (size_t i = lo; i != hi; ++i) {
+      current_block_ = FindBlockStartingAt(SwitchDecisionTree::GetKeyDexPc(table, i));
+      HInstruction* key = graph_->GetIntConstant(table.GetEntryAt(i));
+      HEqual* comparison = new (allocator_) HEqual(value, key, dex_pc);
+      AppendInstruction(comparison);
+      AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
+    }
+  });
+}
+
 void HInstructionBuilder::BuildSwitch(const Instruction& instruction, uint32_t dex_pc) {
   HInstruction* value = LoadLocal(instruction.VRegA_31t(), DataType::Type::kInt32);
   DexSwitchTable table(instruction, dex_pc);
@@ -823,6 +854,8 @@ void HInstructionBuilder::BuildSwitch(const Instruction& instruction, uint32_t d
     // Empty Switch. Code falls through to the next block.
     DCHECK(IsFallthroughInstruction(instruction, dex_pc, current_block_));
     AppendInstruction(new (allocator_) HGoto(dex_pc));
+  } else if (SwitchDecisionTree::IsBinarySearch(table)) {
+    BuildSwitchBinarySearch(table, value, dex_pc);
   } else if (table.ShouldBuildDecisionTree()) {
     for (DexSwitchTableIterator it(table); !it.Done(); it.Advance()) {
       HInstruction* case_value = graph_->GetIntConstant(it.CurrentKey());
@@ -1417,6 +1450,18 @@ bool HInstructionBuilder::BuildInvokePolymorphic(uint32_t dex_pc,
       static_cast<Intrinsics>(resolved_method->GetIntrinsic()) ==
           Intrinsics::kMethodHandleInvokeExact;
 
+  if (can_be_intrinsified &&
+      code_generator_->GetCompilerOptions().IsJitCompiler() &&
+      !graph_->IsDebuggable()) {
+    HInvoke* invoke = BuildInvokeForConstantMethodHandle(dex_pc, proto_idx, operands);
+    if (invoke != nullptr) {
+      MaybeRecordStat(compilation_stats_,
+                      MethodCompilationStat::kMethodHandleInvokeExactDevirtualized);
+      NoReceiverInstructionOperands target_operands(&operands);
+      return HandleInvoke(invoke, target_operands, shorty, /* is_unresolved= */ false);
+    }
+  }
+
   uint32_t number_of_other_inputs = can_be_intrinsified ? 1u : 0u;
 
   HInvoke* invoke = new (allocator_) HInvokePolymorphic(allocator_,
@@ -1462,6 +1507,13 @@ bool HInstructionBuilder::BuildInvokeCustom(uint32_t dex_pc,
   const char* shorty = dex_file_->GetShorty(proto_idx);
   DataType::Type return_type = DataType::FromShorty(shorty[0]);
   size_t number_of_arguments = strlen(shorty) - 1;
+  if (code_generator_->GetCompilerOptions().IsJitCompiler() && !graph_->IsDebuggable()) {
+    HInvoke* invoke = BuildInvokeForConstantCallSite(dex_pc, call_site_idx, operands);
+    if (invoke != nullptr) {
+      MaybeRecordStat(compilation_stats_, MethodCompilationStat::kInvokeCustomDevirtualized);
+      return HandleInvoke(invoke, operands, shorty, /* is_unresolved= */ false);
+    }
+  }
   // HInvokeCustom takes a DexNoNoIndex method reference.
   MethodReference method_reference(&graph_->GetDexFile(), dex::kDexNoIndex);
   HInvoke* invoke = new (allocator_) HInvokeCustom(allocator_,
@@ -1475,6 +1527,119 @@ bool HInstructionBuilder::BuildInvokeCustom(uint32_t dex_pc,
   return HandleInvoke(invoke, operands, shorty, /* is_unresolved= */ false);
 }
 
+HInvoke* HInstructionBuilder::BuildInvokeForConstantCallSite(uint32_t dex_pc,
+                                                             uint32_t call_site_idx,
+                                                             const InstructionOperands& operands) {
+  ScopedObjectAccess soa(Thread::Current());
+  // Call sites are only linked at runtime, by the first execution of the invoke-custom.
+  ObjPtr<mirror::CallSite> call_site =
+      dex_compilation_unit_->GetDexCache()->GetResolvedCallSite(call_site_idx);
+  if (call_site == nullptr ||
+      !call_site->GetClass()->DescriptorEquals("Ljava/lang/invoke/ConstantCallSite;")) {
+    return nullptr;
+  }
+  // The target of a constant call site never changes. When it is a direct method handle
+  // to a static method with the same signature as the call site, `invokeExact()` on it
+  // does not convert any argument and is equivalent to an invoke-static of that method.
+  ObjPtr<mirror::MethodHandle> target = call_site->GetTarget();
+  if (target->GetHandleKind() != mirror::MethodHandle::Kind::kInvokeStatic) {
+    return nullptr;
+  }
+  ArtMethod* target_method = target->GetTargetMethod();
+  dex::ProtoIndex proto_idx = dex_file_->GetProtoIndexForCallSite(call_site_idx);
+  if (dex_file_->GetProtoSignature(dex_file_->GetProtoId(proto_idx)) !=
+      target_method->GetSignature()) {
+    return nullptr;
+  }
+  return BuildInvokeForMethodHandleTarget(
+      dex_pc, target_method, dex_file_->GetShorty(proto_idx), operands);
+}
+
+HInvoke* HInstructionBuilder::BuildInvokeForConstantMethodHandle(
+    uint32_t dex_pc, dex::ProtoIndex proto_idx, const InstructionOperands& operands) {
+  // The receiver of `invokeExact()` is the first operand, before the target's arguments.
+  HInstruction* method_handle = LoadLocal(operands.GetOperand(0u), DataType::Type::kReference);
+  if (!method_handle->IsLoadMethodHandle() ||
+      !IsSameDexFile(method_handle->AsLoadMethodHandle()->GetDexFile(), *dex_file_)) {
+    return nullptr;
+  }
+  const dex::MethodHandleItem& method_handle_item =
+      dex_file_->GetMethodHandle(method_handle->AsLoadMethodHandle()->GetMethodHandleIndex());
+  if (static_cast<DexFile::MethodHandleType>(method_handle_item.method_handle_type_) !=
+      DexFile::MethodHandleType::kInvokeStatic) {
+    return nullptr;
+  }
+  // The type of a direct handle to a static method is the prototype of the method. Prototypes
+  // are unique in a dex file, so the call site type matches it exactly if the indexes are equal,
+  // and `invokeExact()` then does not convert any argument.
+  uint32_t target_method_idx = method_handle_item.field_or_method_idx_;
+  if (dex_file_->GetMethodId(target_method_idx).proto_idx_ != proto_idx) {
+    return nullptr;
+  }
+
+  ScopedObjectAccess soa(Thread::Current());
+  // The const-method-handle resolves the target method, and throws before the invoke is reached
+  // if it cannot. Only use a target that has already been resolved by executing it.
+  ArtMethod* target_method = dex_compilation_unit_->GetClassLinker()->LookupResolvedMethod(
+      target_method_idx,
+      dex_compilation_unit_->GetDexCache().Get(),
+      dex_compilation_unit_->GetClassLoader().Get());
+  if (target_method == nullptr || !target_method->IsStatic()) {
+    return nullptr;
+  }
+  NoReceiverInstructionOperands target_operands(&operands);
+  return BuildInvokeForMethodHandleTarget(
+      dex_pc, target_method, dex_file_->GetShorty(proto_idx), target_operands);
+}
+
+HInvoke* HInstructionBuilder::BuildInvokeForMethodHandleTarget(
+    uint32_t dex_pc,
+    ArtMethod* target_method,
+    const char* shorty,
+    const InstructionOperands& operands) {
+  if (target_method->IsNative() || target_method->IsStringConstructor()) {
+    return nullptr;
+  }
+
+  // The target may be in another dex file, so we can only refer to it by its address.
+  HInvokeStaticOrDirect::DispatchInfo dispatch_info =
+      HSharpening::SharpenLoadMethod(target_method,
+                                     /* has_method_id= */ false,
+                                     /* for_interface_call= */ false,
+                                     code_generator_);
+  if (dispatch_info.method_load_kind != MethodLoadKind::kJitDirectAddress &&
+      dispatch_info.method_load_kind != MethodLoadKind::kRecursive) {
+    return nullptr;
+  }
+
+  HInvokeStaticOrDirect::ClinitCheckRequirement clinit_check_requirement;
+  HClinitCheck* clinit_check =
+      ProcessClinitCheckForInvoke(dex_pc, target_method, &clinit_check_requirement);
+  MethodReference target_method_reference(target_method->GetDexFile(),
+                                          target_method->GetDexMethodIndex());
+  HInvokeStaticOrDirect* invoke = new (allocator_) HInvokeStaticOrDirect(
+      allocator_,
+      strlen(shorty) - 1u,
+      operands.GetNumberOfOperands(),
+      DataType::FromShorty(shorty[0]),
+      dex_pc,
+      target_method_reference,
+      target_method,
+      dispatch_info,
+      kStatic,
+      target_method_reference,
+      clinit_check_requirement,
+      /* enable_intrinsic_opt= */ true);
+  if (clinit_check != nullptr) {
+    // Add the class initialization check as last input of `invoke`.
+    DCHECK_EQ(clinit_check_requirement, HInvokeStaticOrDirect::ClinitCheckRequirement::kExplicit);
+    size_t clinit_check_index = invoke->InputCount() - 1u;
+    DCHECK(invoke->InputAt(clinit_check_index) == nullptr);
+    invoke->SetArgumentAt(clinit_check_index, clinit_check);
+  }
+  return invoke;
+}
+
 HNewInstance* HInstructionBuilder::BuildNewInstance(dex::TypeIndex type_index, uint32_t dex_pc) {
   ScopedObjectAccess soa(Thread::Current());
 
@@ -35,6 +35,7 @@ class ArtField;
 class ArtMethod;
 class CodeGenerator;
 class DexCompilationUnit;
+class DexSwitchTable;
 class HBasicBlockBuilder;
 class Instruction;
 class InstructionOperands;
@@ -173,6 +174,26 @@ class HInstructionBuilder : public ValueObject {
                          uint32_t call_site_idx,
                          const InstructionOperands& operands);
 
+  // Builds an invoke-static of the target of an already linked constant call site,
+  // or returns nullptr if the call site cannot be devirtualized.
+  HInvoke* BuildInvokeForConstantCallSite(uint32_t dex_pc,
+                                          uint32_t call_site_idx,
+                                          const InstructionOperands& operands);
+
+  // Builds an invoke-static of the target of `MethodHandle.invokeExact()` on a handle loaded
+  // by const-method-handle, or returns nullptr if the invoke cannot be devirtualized.
+  HInvoke* BuildInvokeForConstantMethodHandle(uint32_t dex_pc,
+                                              dex::ProtoIndex proto_idx,
+                                              const InstructionOperands& operands);
+
+  // Builds an invoke-static of `target_method`, the target of a direct method handle invoked
+  // with the exact type `shorty`, or returns nullptr if it cannot be referenced directly.
+  HInvoke* BuildInvokeForMethodHandleTarget(uint32_t dex_pc,
+                                            ArtMethod* target_method,
+                                            const char* shorty,
+                                            const InstructionOperands& operands)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Builds a new array node.
   HNewArray* BuildNewArray(uint32_t dex_pc, dex::TypeIndex type_index, HInstruction* length);
 
@@ -213,6 +234,7 @@ class HInstructionBuilder : public ValueObject {
 
   // Builds an instruction sequence for a switch statement.
   void BuildSwitch(const Instruction& instruction, uint32_t dex_pc);
+  void BuildSwitchBinarySearch(const DexSwitchTable& table, HInstruction* value, uint32_t dex_pc);
 
   // Builds a `HLoadString` loading the given `string_index`.
   void BuildLoadString(dex::StringIndex string_index, uint32_t dex_pc);
@@ -1098,6 +1098,85 @@ static HInstruction* AllowInMinMax(IfCondition cmp,
   return nullptr;
 }
 
+// Returns the value of the signed comparison `cmp` for operands ordered as `order`
+// (negative, zero or positive), or false for unsigned comparisons.
+static bool EvaluateForOrder(IfCondition cmp, int order, /*out*/ bool* result) {
+  switch (cmp) {
+    case kCondEQ: *result = order == 0; return true;
+    case kCondNE: *result = order != 0; return true;
+    case kCondLT: *result = order < 0; return true;
+    case kCondLE: *result = order <= 0; return true;
+    case kCondGT: *result = order > 0; return true;
+    case kCondGE: *result = order >= 0; return true;
+    default: return false;
+  }
+}
+
+// Returns the int constant the select construct "a <cmp> b ? x : y", where x or y may itself
+// be a select on a condition over the same operands a and b, evaluates to when a and b are
+// ordered as `order`, or nullptr if it cannot be determined.
+static HIntConstant* EvaluateSelectForOrder(HSelect* select,
+                                            HInstruction* a,
+                                            HInstruction* b,
+                                            int order,
+                                            bool allow_nested) {
+  HInstruction* condition = select->GetCondition();
+  if (!condition->IsCondition()) {
+    return nullptr;
+  }
+  int condition_order = order;
+  if (condition->InputAt(0) == b && condition->InputAt(1) == a) {
+    condition_order = -order;
+  } else if (condition->InputAt(0) != a || condition->InputAt(1) != b) {
+    return nullptr;
+  }
+  bool result;
+  if (!EvaluateForOrder(condition->AsCondition()->GetCondition(), condition_order, &result)) {
+    return nullptr;
+  }
+  HInstruction* value = result ? select->GetTrueValue() : select->GetFalseValue();
+  if (value->IsIntConstant()) {
+    return value->AsIntConstant();
+  } else if (allow_nested && value->IsSelect()) {
+    return EvaluateSelectForOrder(value->AsSelect(), a, b, order, /*allow_nested=*/ false);
+  }
+  return nullptr;
+}
+
+// Returns an acceptable COMPARE(a, b) or COMPARE(b, a) replacement for the
+// three-way comparison idiom "a > b ? 1 : (a < b ? -1 : 0)" and its variants,
+// or nullptr if the select construct is not such an idiom.
+static HInstruction* NewIntegralCompare(ArenaAllocator* allocator,
+                                        HSelect* select,
+                                        HInstruction* a,
+                                        HInstruction* b) {
+  DataType::Type type = DataType::Kind(a->GetType());
+  if (select->GetType() != DataType::Type::kInt32 ||
+      (type != DataType::Type::kInt32 && type != DataType::Type::kInt64) ||
+      DataType::Kind(b->GetType()) != type ||
+      (!select->GetTrueValue()->IsSelect() && !select->GetFalseValue()->IsSelect())) {
+    return nullptr;
+  }
+  HIntConstant* less = EvaluateSelectForOrder(select, a, b, -1, /*allow_nested=*/ true);
+  HIntConstant* equal = EvaluateSelectForOrder(select, a, b, 0, /*allow_nested=*/ true);
+  HIntConstant* greater = EvaluateSelectForOrder(select, a, b, 1, /*allow_nested=*/ true);
+  if (less == nullptr || equal == nullptr || greater == nullptr || equal->GetValue() != 0) {
+    return nullptr;
+  }
+  if (less->GetValue() == -1 && greater->GetValue() == 1) {
+    // Found COMPARE(a, b).
+  } else if (less->GetValue() == 1 && greater->GetValue() == -1) {
+    // Found COMPARE(b, a).
+    std::swap(a, b);
+  } else {
+    return nullptr;
+  }
+  HCompare* compare =
+      new (allocator) HCompare(type, a, b, ComparisonBias::kNoBias, select->GetDexPc());
+  select->GetBlock()->InsertInstructionBefore(compare, select);
+  return compare;
+}
+
 void InstructionSimplifierVisitor::VisitSelect(HSelect* select) {
   HInstruction* replace_with = nullptr;
   HInstruction* condition = select->GetCondition();
@@ -1196,6 +1275,13 @@ void InstructionSimplifierVisitor::VisitSelect(HSelect* select) {
           }
         }
       }
+      if (replace_with == nullptr) {
+        // Try to replace the three-way comparison idiom
+        //   a > b ? 1 : (a < b ? -1 : 0)
+        // resulting from two nested diamonds by COMPARE(a, b).
+        replace_with = NewIntegralCompare(
+            GetGraph()->GetAllocator(), select, condition->InputAt(0), condition->InputAt(1));
+      }
     }
   }
 
@@ -3037,12 +3123,21 @@ static bool TryReplaceStringBuilderAppend(CodeGenerator* codegen, HInvoke* invok
   bool seen_to_string = false;
   uint32_t format = 0u;
   uint32_t num_args = 0u;
-  bool has_fp_args = false;
+  bool calls_managed_code = false;
+  // Whether we have seen an instruction that reads or writes memory or can throw between
+  // the append calls seen so far and the StringBuilder.toString().
+  bool seen_side_effects = false;
   HInstruction* args[StringBuilderAppend::kMaxArgs];  // Added in reverse order.
   for (HBackwardInstructionIterator iter(block->GetInstructions()); !iter.Done(); iter.Advance()) {
     HInstruction* user = iter.Current();
     // Instructions of interest apply to `sb`, skip those that do not involve `sb`.
     if (user->InputCount() == 0u || user->InputAt(0u) != sb) {
+      if (seen_to_string &&
+          (user->GetSideEffects().DoesAnyRead() ||
+           user->GetSideEffects().DoesAnyWrite() ||
+           user->CanThrow())) {
+        seen_side_effects = true;
+      }
       continue;
     }
     // We visit the uses in reverse order, so the StringBuilder.toString() must come first.
@@ -3072,9 +3167,25 @@ static bool TryReplaceStringBuilderAppend(CodeGenerator* codegen, HInvoke* invok
       DCHECK(!seen_constructor_fence);
       StringBuilderAppend::Argument arg;
       switch (as_invoke->GetIntrinsic()) {
-        case Intrinsics::kStringBuilderAppendObject:
-          // TODO: Unimplemented, needs to call String.valueOf().
-          return false;
+        case Intrinsics::kStringBuilderAppendObject: {
+          ReferenceTypeInfo rti = as_invoke->InputAt(1)->GetReferenceTypeInfo();
+          if (rti.IsValid()) {
+            ScopedObjectAccess soa(Thread::Current());
+            if (rti.GetTypeHandle().Get() == GetClassRoot<mirror::String>()) {
+              arg = StringBuilderAppend::Argument::kString;
+              break;
+            }
+          }
+          // The runtime calls String.valueOf() which can run arbitrary code in `toString()`.
+          // Moving that call to the StringBuilder.toString() location is correct only if
+          // nothing in between can observe or be observed by that code.
+          if (seen_side_effects) {
+            return false;
+          }
+          arg = StringBuilderAppend::Argument::kObject;
+          calls_managed_code = true;
+          break;
+        }
         case Intrinsics::kStringBuilderAppendString:
           arg = StringBuilderAppend::Argument::kString;
           break;
@@ -3096,11 +3207,11 @@ static bool TryReplaceStringBuilderAppend(CodeGenerator* codegen, HInvoke* invok
           break;
         case Intrinsics::kStringBuilderAppendFloat:
           arg = StringBuilderAppend::Argument::kFloat;
-          has_fp_args = true;
+          calls_managed_code = true;
           break;
         case Intrinsics::kStringBuilderAppendDouble:
           arg = StringBuilderAppend::Argument::kDouble;
-          has_fp_args = true;
+          calls_managed_code = true;
           break;
         case Intrinsics::kStringBuilderAppendCharSequence: {
           ReferenceTypeInfo rti = as_invoke->InputAt(1)->GetReferenceTypeInfo();
@@ -3179,7 +3290,7 @@ static bool TryReplaceStringBuilderAppend(CodeGenerator* codegen, HInvoke* invok
   HIntConstant* fmt = block->GetGraph()->GetIntConstant(static_cast<int32_t>(format));
   ArenaAllocator* allocator = block->GetGraph()->GetAllocator();
   HStringBuilderAppend* append = new (allocator) HStringBuilderAppend(
-      fmt, num_args, number_of_out_vregs, has_fp_args, allocator, invoke->GetDexPc());
+      fmt, num_args, number_of_out_vregs, calls_managed_code, allocator, invoke->GetDexPc());
   append->SetReferenceTypeInfoIfValid(invoke->GetReferenceTypeInfo());
   for (size_t i = 0; i != num_args; ++i) {
     append->SetArgumentAt(i, args[num_args - 1u - i]);
@@ -3262,18 +3373,15 @@ void InstructionSimplifierVisitor::SimplifyVarHandleIntrinsic(HInvoke* invoke) {
 bool InstructionSimplifierVisitor::CanUseKnownImageVarHandle(HInvoke* invoke) {
   // If the `VarHandle` comes from a static final field of an initialized class in an image
   // (boot image or app image), we can do the checks at compile time. We do this optimization
-  // only for AOT and only for field handles when we can avoid all checks. This avoids the
-  // possibility of the code concurrently messing with the `VarHandle` using reflection,
-  // we simply perform the operation with the `VarHandle` as seen at compile time.
-  // TODO: Extend this to arrays to support the `AtomicIntegerArray` class.
+  // only for AOT and only for field and array handles when we can avoid all checks except
+  // the object null check and the array bounds check. This avoids the possibility of the code
+  // concurrently messing with the `VarHandle` using reflection, we simply perform the operation
+  // with the `VarHandle` as seen at compile time.
   const CompilerOptions& compiler_options = codegen_->GetCompilerOptions();
   if (!compiler_options.IsAotCompiler()) {
     return false;
   }
   size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
-  if (expected_coordinates_count == 2u) {
-    return false;
-  }
   HInstruction* var_handle_instruction = invoke->InputAt(0);
   if (var_handle_instruction->IsNullCheck()) {
     var_handle_instruction = var_handle_instruction->InputAt(0);
@@ -3315,10 +3423,13 @@ bool InstructionSimplifierVisitor::CanUseKnownImageVarHandle(HInvoke* invoke) {
     case 0:
       expected_var_handle_class = GetClassRoot<mirror::StaticFieldVarHandle>();
       break;
-    default:
-      DCHECK_EQ(expected_coordinates_count, 1u);
+    case 1:
       expected_var_handle_class = GetClassRoot<mirror::FieldVarHandle>();
       break;
+    default:
+      DCHECK_EQ(expected_coordinates_count, 2u);
+      expected_var_handle_class = GetClassRoot<mirror::ArrayElementVarHandle>();
+      break;
   }
   ObjPtr<mirror::Object> var_handle_object = field->GetObject(declaring_class);
   if (var_handle_object == nullptr || var_handle_object->GetClass() != expected_var_handle_class) {
@@ -3370,6 +3481,12 @@ bool InstructionSimplifierVisitor::CanUseKnownImageVarHandle(HInvoke* invoke) {
         !coordinate0_type->IsAssignableFrom(object_type_info.GetTypeHandle().Get())) {
       return false;
     }
+    // The array class check in the generated code is an exact check. We can avoid it only
+    // if the array class cannot have subtypes, for example for primitive arrays used by the
+    // `AtomicIntegerArray` and `AtomicLongArray` classes. Bounds are still checked at runtime.
+    if (expected_coordinates_count == 2u && !coordinate0_type->CannotBeAssignedFromOtherTypes()) {
+      return false;
+    }
   }
 
   // All required checks passed.
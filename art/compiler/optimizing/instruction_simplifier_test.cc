@@ -239,4 +239,71 @@ INSTANTIATE_TEST_SUITE_P(InstructionSimplifierTest,
                                          InstanceOfKind::kUnrelatedUnloaded,
                                          InstanceOfKind::kSupertype));
 
+// // ENTRY
+// return a > b ? 1 : (a < b ? -1 : 0)
+// // EXIT
+TEST_F(InstructionSimplifierTest, ThreeWayCompareSelect) {
+  HBasicBlock* main = InitEntryMainExitGraph();
+  HInstruction* a = MakeParam(DataType::Type::kInt64);
+  HInstruction* b = MakeParam(DataType::Type::kInt64);
+  HInstruction* lt = MakeCondition(main, kCondLT, a, b);
+  HInstruction* inner = MakeSelect(
+      main, lt, graph_->GetIntConstant(-1), graph_->GetIntConstant(0));
+  HInstruction* gt = MakeCondition(main, kCondGT, a, b);
+  HInstruction* outer = MakeSelect(main, gt, graph_->GetIntConstant(1), inner);
+  HReturn* ret = MakeReturn(main, outer);
+
+  PerformSimplification();
+
+  EXPECT_INS_REMOVED(outer);
+  ASSERT_TRUE(ret->InputAt(0)->IsCompare());
+  HCompare* compare = ret->InputAt(0)->AsCompare();
+  EXPECT_INS_EQ(compare->GetLeft(), a);
+  EXPECT_INS_EQ(compare->GetRight(), b);
+  EXPECT_EQ(compare->GetComparisonType(), DataType::Type::kInt64);
+}
+
+// // ENTRY
+// return a < b ? 1 : (b < a ? -1 : 0)
+// // EXIT
+TEST_F(InstructionSimplifierTest, ThreeWayCompareSelectSwapped) {
+  HBasicBlock* main = InitEntryMainExitGraph();
+  HInstruction* a = MakeParam(DataType::Type::kInt32);
+  HInstruction* b = MakeParam(DataType::Type::kInt32);
+  HInstruction* lt_ba = MakeCondition(main, kCondLT, b, a);
+  HInstruction* inner = MakeSelect(
+      main, lt_ba, graph_->GetIntConstant(-1), graph_->GetIntConstant(0));
+  HInstruction* lt_ab = MakeCondition(main, kCondLT, a, b);
+  HInstruction* outer = MakeSelect(main, lt_ab, graph_->GetIntConstant(1), inner);
+  HReturn* ret = MakeReturn(main, outer);
+
+  PerformSimplification();
+
+  EXPECT_INS_REMOVED(outer);
+  ASSERT_TRUE(ret->InputAt(0)->IsCompare());
+  HCompare* compare = ret->InputAt(0)->AsCompare();
+  EXPECT_INS_EQ(compare->GetLeft(), b);
+  EXPECT_INS_EQ(compare->GetRight(), a);
+}
+
+// // ENTRY
+// return a > b ? 2 : (a < b ? -1 : 0)
+// // EXIT
+TEST_F(InstructionSimplifierTest, ThreeWayCompareSelectNoMatch) {
+  HBasicBlock* main = InitEntryMainExitGraph();
+  HInstruction* a = MakeParam(DataType::Type::kInt32);
+  HInstruction* b = MakeParam(DataType::Type::kInt32);
+  HInstruction* lt = MakeCondition(main, kCondLT, a, b);
+  HInstruction* inner = MakeSelect(
+      main, lt, graph_->GetIntConstant(-1), graph_->GetIntConstant(0));
+  HInstruction* gt = MakeCondition(main, kCondGT, a, b);
+  HInstruction* outer = MakeSelect(main, gt, graph_->GetIntConstant(2), inner);
+  HReturn* ret = MakeReturn(main, outer);
+
+  PerformSimplification();
+
+  EXPECT_INS_RETAINED(outer);
+  EXPECT_INS_EQ(ret->InputAt(0), outer);
+}
+
 }  // namespace art
@@ -3875,11 +3875,14 @@ static void GenerateCodeForCalculationCRC32ValueOfBytes(MacroAssembler* masm,
                                                         const Register& crc,
                                                         const Register& ptr,
                                                         const Register& length,
+                                                        const Register& temp,
                                                         const Register& out) {
   // The algorithm of CRC32 of bytes is:
   //   crc = ~crc
   //   process a few first bytes to make the array 8-byte aligned
-  //   while array has 8 bytes do:
+  //   while array has 16 bytes do:
+  //     crc = crc32_of_8bytes(crc32_of_8bytes(crc, 8_bytes(array)), 8_bytes(array + 8))
+  //   if array has 8 bytes:
   //     crc = crc32_of_8bytes(crc, 8_bytes(array))
   //   if array has 4 bytes:
   //     crc = crc32_of_4bytes(crc, 4_bytes(array))
@@ -3890,7 +3893,7 @@ static void GenerateCodeForCalculationCRC32ValueOfBytes(MacroAssembler* masm,
   //   crc = ~crc
 
   vixl::aarch64::Label loop, done;
-  vixl::aarch64::Label process_4bytes, process_2bytes, process_1byte;
+  vixl::aarch64::Label process_8bytes, process_4bytes, process_2bytes, process_1byte;
   vixl::aarch64::Label aligned2, aligned4, aligned8;
 
   // Use VIXL scratch registers as the VIXL macro assembler won't use them in
@@ -3923,21 +3926,30 @@ static void GenerateCodeForCalculationCRC32ValueOfBytes(MacroAssembler* masm,
   __ Crc32w(out, out, array_elem);
 
   __ Bind(&aligned8);
-  __ Subs(len, len, 8);
-  // If len < 8 go to process data by 4 bytes, 2 bytes and a byte.
-  __ B(&process_4bytes, lo);
+  __ Subs(len, len, 16);
+  // If len < 16 go to process data by 8 bytes, 4 bytes, 2 bytes and a byte.
+  __ B(&process_8bytes, lo);
 
-  // The main loop processing data by 8 bytes.
+  // The main loop processing data by 16 bytes. Loading a pair of registers halves
+  // the number of loads and loop branches per byte; the CRC32 instructions are chained.
   __ Bind(&loop);
-  __ Ldr(array_elem.X(), MemOperand(ptr, 8, PostIndex));
-  __ Subs(len, len, 8);
+  __ Ldp(array_elem.X(), temp, MemOperand(ptr, 16, PostIndex));
+  __ Subs(len, len, 16);
   __ Crc32x(out, out, array_elem.X());
-  // if len >= 8, process the next 8 bytes.
+  __ Crc32x(out, out, temp);
+  // if len >= 16, process the next 16 bytes.
   __ B(&loop, hs);
 
+  // Here len is in the range [-16, -1] and its low four bits hold the number of
+  // remaining bytes. Process 8 bytes if bit 3 is set; the code below only uses bits 0-2.
+  __ Bind(&process_8bytes);
+  __ Tbz(len, 3, &process_4bytes);
+  __ Ldr(array_elem.X(), MemOperand(ptr, 8, PostIndex));
+  __ Crc32x(out, out, array_elem.X());
+
   // Process the data which is less than 8 bytes.
   // The code generated below works with values of len
-  // which come in the range [-8, 0].
+  // which come in the range [-16, -1].
   // The first three bits are used to detect whether 4 bytes or 2 bytes or
   // a byte can be processed.
   // The checking order is from bit 2 to bit 0:
@@ -3984,8 +3996,9 @@ void IntrinsicLocationsBuilderARM64::VisitCRC32UpdateBytes(HInvoke* invoke) {
   locations->SetInAt(1, Location::RequiresRegister());
   locations->SetInAt(2, Location::RegisterOrConstant(invoke->InputAt(2)));
   locations->SetInAt(3, Location::RequiresRegister());
-  locations->AddTemp(Location::RequiresRegister());
-  locations->SetOut(Location::RequiresRegister());
+  locations->AddRegisterTemps(2);
+  // The output is written before all inputs are read.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
 }
 
 // Lower the invoke of CRC32.updateBytes(int crc, byte[] b, int off, int len)
@@ -4021,7 +4034,8 @@ void IntrinsicCodeGeneratorARM64::VisitCRC32UpdateBytes(HInvoke* invoke) {
   Register crc = WRegisterFrom(locations->InAt(0));
   Register out = WRegisterFrom(locations->Out());
 
-  GenerateCodeForCalculationCRC32ValueOfBytes(masm, crc, ptr, length, out);
+  Register temp = XRegisterFrom(locations->GetTemp(1));
+  GenerateCodeForCalculationCRC32ValueOfBytes(masm, crc, ptr, length, temp, out);
 
   __ Bind(slow_path->GetExitLabel());
 }
@@ -4040,8 +4054,9 @@ void IntrinsicLocationsBuilderARM64::VisitCRC32UpdateByteBuffer(HInvoke* invoke)
   locations->SetInAt(1, Location::RequiresRegister());
   locations->SetInAt(2, Location::RequiresRegister());
   locations->SetInAt(3, Location::RequiresRegister());
-  locations->AddTemp(Location::RequiresRegister());
-  locations->SetOut(Location::RequiresRegister());
+  locations->AddRegisterTemps(2);
+  // The output is written before all inputs are read.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
 }
 
 // Lower the invoke of CRC32.updateByteBuffer(int crc, long addr, int off, int len)
@@ -4066,7 +4081,8 @@ void IntrinsicCodeGeneratorARM64::VisitCRC32UpdateByteBuffer(HInvoke* invoke) {
   Register crc = WRegisterFrom(locations->InAt(0));
   Register length = WRegisterFrom(locations->InAt(3));
   Register out = WRegisterFrom(locations->Out());
-  GenerateCodeForCalculationCRC32ValueOfBytes(masm, crc, ptr, length, out);
+  Register temp = XRegisterFrom(locations->GetTemp(1));
+  GenerateCodeForCalculationCRC32ValueOfBytes(masm, crc, ptr, length, temp, out);
 }
 
 void IntrinsicLocationsBuilderARM64::VisitFP16ToFloat(HInvoke* invoke) {
@@ -4699,6 +4715,15 @@ static void GenerateVarHandleArrayChecks(HInvoke* invoke,
 
   UseScratchRegisterScope temps(masm);
   Register temp = temps.AcquireW();
+
+  if (optimizations.GetUseKnownImageVarHandle()) {
+    // The array class has been checked at compile time, see `CanUseKnownImageVarHandle()`.
+    __ Ldr(temp, HeapOperand(object, array_length_offset.Int32Value()));
+    __ Cmp(index, temp);
+    __ B(slow_path->GetEntryLabel(), hs);
+    return;
+  }
+
   Register temp2 = temps.AcquireW();
 
   // Check that the VarHandle references an array, byte array view or ByteBuffer by checking
@@ -4779,8 +4804,9 @@ static VarHandleSlowPathARM64* GenerateVarHandleChecks(HInvoke* invoke,
   size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
   VarHandleOptimizations optimizations(invoke);
   if (optimizations.GetUseKnownImageVarHandle()) {
-    DCHECK_NE(expected_coordinates_count, 2u);
-    if (expected_coordinates_count == 0u || optimizations.GetSkipObjectNullCheck()) {
+    // Array handles always need the slow path for the bounds check.
+    if (expected_coordinates_count == 0u ||
+        (expected_coordinates_count == 1u && optimizations.GetSkipObjectNullCheck())) {
       return nullptr;
     }
   }
@@ -5933,6 +5959,76 @@ void VarHandleSlowPathARM64::EmitByteArrayViewCode(CodeGenerator* codegen_in) {
   __ B(GetExitLabel());
 }
 
+void IntrinsicLocationsBuilderARM64::VisitArraysSupportVectorizedMismatch(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  for (size_t i = 0; i != 6u; ++i) {
+    locations->SetInAt(i, Location::RequiresRegister());
+  }
+  locations->AddRegisterTemps(4);
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysSupportVectorizedMismatch(HInvoke* invoke) {
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register a = WRegisterFrom(locations->InAt(0));
+  Register a_offset = XRegisterFrom(locations->InAt(1));
+  Register b = WRegisterFrom(locations->InAt(2));
+  Register b_offset = XRegisterFrom(locations->InAt(3));
+  Register length = WRegisterFrom(locations->InAt(4));
+  Register log2_scale = XRegisterFrom(locations->InAt(5));
+  Register out = WRegisterFrom(locations->Out());
+
+  Register a_ptr = XRegisterFrom(locations->GetTemp(0));
+  Register b_ptr = XRegisterFrom(locations->GetTemp(1));
+  Register index = XRegisterFrom(locations->GetTemp(2));
+  Register words_end = XRegisterFrom(locations->GetTemp(3));
+
+  UseScratchRegisterScope scratch_scope(masm);
+  Register a_value = scratch_scope.AcquireX();
+  Register b_value = scratch_scope.AcquireX();
+
+  vixl::aarch64::Label loop;
+  vixl::aarch64::Label no_mismatch;
+  vixl::aarch64::Label end;
+
+  // Like `Unsafe`, a null object means that the offset is an absolute address.
+  __ Add(a_ptr, a_offset, Operand(a, UXTW));
+  __ Add(b_ptr, b_offset, Operand(b, UXTW));
+  // Compare whole 8-byte words. The caller checks the remaining elements.
+  __ Mov(words_end.W(), length);
+  __ Lsl(words_end, words_end, log2_scale);
+  __ Bic(words_end, words_end, sizeof(uint64_t) - 1u);
+  __ Mov(index, 0);
+
+  __ Bind(&loop);
+  __ Cmp(index, words_end);
+  __ B(&no_mismatch, hs);
+  __ Ldr(a_value, MemOperand(a_ptr, index));
+  __ Ldr(b_value, MemOperand(b_ptr, index));
+  __ Add(index, index, sizeof(uint64_t));
+  __ Cmp(a_value, b_value);
+  __ B(&loop, eq);
+
+  // Find the first mismatching byte (little-endian) and convert it to an element index.
+  __ Eor(a_value, a_value, b_value);
+  __ Rbit(a_value, a_value);
+  __ Clz(a_value, a_value);
+  __ Sub(index, index, sizeof(uint64_t));
+  __ Add(index, index, Operand(a_value, LSR, WhichPowerOf2(kBitsPerByte)));
+  __ Lsr(out.X(), index, log2_scale);
+  __ B(&end);
+
+  // Return the complement of the number of remaining elements.
+  __ Bind(&no_mismatch);
+  __ Lsr(words_end, words_end, log2_scale);
+  __ Sub(out, length, words_end.W());
+  __ Mvn(out, out);
+  __ Bind(&end);
+}
+
 #define MARK_UNIMPLEMENTED(Name) UNIMPLEMENTED_INTRINSIC(ARM64, Name)
 UNIMPLEMENTED_INTRINSIC_LIST_ARM64(MARK_UNIMPLEMENTED);
 #undef MARK_UNIMPLEMENTED
@@ -4470,6 +4470,14 @@ static void GenerateVarHandleArrayChecks(HInvoke* invoke,
   // Use the offset temporary register. It is not used yet at this point.
   vixl32::Register temp = RegisterFrom(invoke->GetLocations()->GetTemp(0u));
 
+  if (optimizations.GetUseKnownImageVarHandle()) {
+    // The array class has been checked at compile time, see `CanUseKnownImageVarHandle()`.
+    __ Ldr(temp, MemOperand(object, array_length_offset.Int32Value()));
+    __ Cmp(index, temp);
+    __ B(hs, slow_path->GetEntryLabel());
+    return;
+  }
+
   UseScratchRegisterScope temps(assembler->GetVIXLAssembler());
   vixl32::Register temp2 = temps.Acquire();
 
@@ -4550,8 +4558,9 @@ static VarHandleSlowPathARMVIXL* GenerateVarHandleChecks(HInvoke* invoke,
   size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
   VarHandleOptimizations optimizations(invoke);
   if (optimizations.GetUseKnownImageVarHandle()) {
-    DCHECK_NE(expected_coordinates_count, 2u);
-    if (expected_coordinates_count == 0u || optimizations.GetSkipObjectNullCheck()) {
+    // Array handles always need the slow path for the bounds check.
+    if (expected_coordinates_count == 0u ||
+        (expected_coordinates_count == 1u && optimizations.GetSkipObjectNullCheck())) {
       return nullptr;
     }
   }
@@ -3649,6 +3649,14 @@ static void GenerateVarHandleArrayChecks(HInvoke* invoke,
 
   ScratchRegisterScope srs(assembler);
   XRegister temp = srs.AllocateXRegister();
+
+  if (optimizations.GetUseKnownImageVarHandle()) {
+    // The array class has been checked at compile time, see `CanUseKnownImageVarHandle()`.
+    __ Loadw(temp, object, array_length_offset.Int32Value());
+    __ Bgeu(index, temp, slow_path->GetEntryLabel());
+    return;
+  }
+
   XRegister temp2 = srs.AllocateXRegister();
 
   // Check that the VarHandle references an array, byte array view or ByteBuffer by checking
@@ -3726,8 +3734,9 @@ static VarHandleSlowPathRISCV64* GenerateVarHandleChecks(HInvoke* invoke,
   size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
   VarHandleOptimizations optimizations(invoke);
   if (optimizations.GetUseKnownImageVarHandle()) {
-    DCHECK_NE(expected_coordinates_count, 2u);
-    if (expected_coordinates_count == 0u || optimizations.GetSkipObjectNullCheck()) {
+    // Array handles always need the slow path for the bounds check.
+    if (expected_coordinates_count == 0u ||
+        (expected_coordinates_count == 1u && optimizations.GetSkipObjectNullCheck())) {
       return nullptr;
     }
   }
@@ -5733,6 +5742,92 @@ void IntrinsicCodeGeneratorRISCV64::VisitMathCopySignFloat(HInvoke* invoke) {
   GenMathCopySign(codegen_, invoke, DataType::Type::kFloat32);
 }
 
+void IntrinsicLocationsBuilderRISCV64::VisitArraysSupportVectorizedMismatch(HInvoke* invoke) {
+  // The vector loop needs the "V" extension; without it, call the Java implementation.
+  if (!codegen_->GetInstructionSetFeatures().HasVector()) {
+    return;
+  }
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  for (size_t i = 0; i != 6u; ++i) {
+    locations->SetInAt(i, Location::RequiresRegister());
+  }
+  locations->AddRegisterTemps(4);
+  // Floating point temps, used as vector registers with the same numbers.
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitArraysSupportVectorizedMismatch(HInvoke* invoke) {
+  Riscv64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  XRegister a = locations->InAt(0).AsRegister<XRegister>();
+  XRegister a_offset = locations->InAt(1).AsRegister<XRegister>();
+  XRegister b = locations->InAt(2).AsRegister<XRegister>();
+  XRegister b_offset = locations->InAt(3).AsRegister<XRegister>();
+  XRegister length = locations->InAt(4).AsRegister<XRegister>();
+  XRegister log2_scale = locations->InAt(5).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+
+  XRegister a_ptr = locations->GetTemp(0).AsRegister<XRegister>();
+  XRegister b_ptr = locations->GetTemp(1).AsRegister<XRegister>();
+  XRegister remaining = locations->GetTemp(2).AsRegister<XRegister>();
+  XRegister compared = locations->GetTemp(3).AsRegister<XRegister>();
+  VRegister a_data = static_cast<VRegister>(locations->GetTemp(4).reg());
+  VRegister b_data = static_cast<VRegister>(locations->GetTemp(5).reg());
+  VRegister ne_mask = static_cast<VRegister>(locations->GetTemp(6).reg());
+
+  ScratchRegisterScope srs(assembler);
+  XRegister vl = srs.AllocateXRegister();
+  XRegister first = srs.AllocateXRegister();
+
+  Riscv64Label loop;
+  Riscv64Label mismatch;
+  Riscv64Label done;
+  Riscv64Label end;
+
+  // Like `Unsafe`, a null object means that the offset is an absolute address.
+  __ ZextW(a_ptr, a);
+  __ Add(a_ptr, a_ptr, a_offset);
+  __ ZextW(b_ptr, b);
+  __ Add(b_ptr, b_ptr, b_offset);
+  // Compare all elements as bytes, so there is no tail left for the caller to check.
+  __ Sll(remaining, length, log2_scale);
+  __ Li(compared, 0);
+
+  uint32_t vtypei = Riscv64Assembler::VTypeiValue(VectorMaskAgnostic::kAgnostic,
+                                                  VectorTailAgnostic::kAgnostic,
+                                                  SelectedElementWidth::kE8,
+                                                  LengthMultiplier::kM1);
+  __ Bind(&loop);
+  __ Beqz(remaining, &done);
+  __ VSetvli(vl, remaining, vtypei);
+  __ VLe8(a_data, a_ptr);
+  __ VLe8(b_data, b_ptr);
+  __ VMsne_vv(ne_mask, a_data, b_data);
+  __ VFirst_m(first, ne_mask);
+  __ Bgez(first, &mismatch);
+  __ Add(a_ptr, a_ptr, vl);
+  __ Add(b_ptr, b_ptr, vl);
+  __ Add(compared, compared, vl);
+  __ Sub(remaining, remaining, vl);
+  __ J(&loop);
+
+  // Convert the index of the first mismatching byte to an element index.
+  __ Bind(&mismatch);
+  __ Add(out, compared, first);
+  __ Srlw(out, out, log2_scale);
+  __ J(&end);
+
+  // All elements are equal, return the complement of the zero remaining elements.
+  __ Bind(&done);
+  __ Li(out, -1);
+  __ Bind(&end);
+}
+
 #define MARK_UNIMPLEMENTED(Name) UNIMPLEMENTED_INTRINSIC(RISCV64, Name)
 UNIMPLEMENTED_INTRINSIC_LIST_RISCV64(MARK_UNIMPLEMENTED);
 #undef MARK_UNIMPLEMENTED
@@ -3931,6 +3931,13 @@ static void GenerateVarHandleArrayChecks(HInvoke* invoke,
     __ j(kZero, slow_path->GetEntryLabel());
   }
 
+  if (optimizations.GetUseKnownImageVarHandle()) {
+    // The array class has been checked at compile time, see `CanUseKnownImageVarHandle()`.
+    __ cmpl(index, Address(object, array_length_offset.Int32Value()));
+    __ j(kAboveEqual, slow_path->GetEntryLabel());
+    return;
+  }
+
   CpuRegister temp = locations->GetTemp(0).AsRegister<CpuRegister>();
 
   // Check that the VarHandle references an array, byte array view or ByteBuffer by checking
@@ -4007,8 +4014,9 @@ static VarHandleSlowPathX86_64* GenerateVarHandleChecks(HInvoke* invoke,
   size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
   VarHandleOptimizations optimizations(invoke);
   if (optimizations.GetUseKnownImageVarHandle()) {
-    DCHECK_NE(expected_coordinates_count, 2u);
-    if (expected_coordinates_count == 0u || optimizations.GetSkipObjectNullCheck()) {
+    // Array handles always need the slow path for the bounds check.
+    if (expected_coordinates_count == 0u ||
+        (expected_coordinates_count == 1u && optimizations.GetSkipObjectNullCheck())) {
       return nullptr;
     }
   }
@@ -5532,6 +5540,77 @@ void VarHandleSlowPathX86_64::EmitByteArrayViewCode(CodeGeneratorX86_64* codegen
   __ jmp(GetExitLabel());
 }
 
+void IntrinsicLocationsBuilderX86_64::VisitArraysSupportVectorizedMismatch(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  for (size_t i = 0; i != 5u; ++i) {
+    locations->SetInAt(i, Location::RequiresRegister());
+  }
+  // The shift count for variable shifts must be in CL.
+  locations->SetInAt(5, Location::RegisterLocation(RCX));
+  locations->AddRegisterTemps(4);
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysSupportVectorizedMismatch(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister a = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister a_offset = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister b = locations->InAt(2).AsRegister<CpuRegister>();
+  CpuRegister b_offset = locations->InAt(3).AsRegister<CpuRegister>();
+  CpuRegister length = locations->InAt(4).AsRegister<CpuRegister>();
+  CpuRegister log2_scale = locations->InAt(5).AsRegister<CpuRegister>();
+  DCHECK_EQ(log2_scale.AsRegister(), RCX);
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  CpuRegister a_ptr = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister b_ptr = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister index = locations->GetTemp(2).AsRegister<CpuRegister>();
+  CpuRegister words_end = locations->GetTemp(3).AsRegister<CpuRegister>();
+
+  NearLabel loop, no_mismatch, end;
+
+  // Like `Unsafe`, a null object means that the offset is an absolute address.
+  // The 32-bit moves zero-extend the heap references.
+  __ movl(a_ptr, a);
+  __ addq(a_ptr, a_offset);
+  __ movl(b_ptr, b);
+  __ addq(b_ptr, b_offset);
+  // Compare whole 8-byte words. The caller checks the remaining elements.
+  __ movl(words_end, length);
+  __ shlq(words_end, log2_scale);
+  __ andq(words_end, Immediate(-static_cast<int32_t>(sizeof(uint64_t))));
+  __ xorl(index, index);
+
+  // Use `out` for the XOR of the loaded words.
+  __ Bind(&loop);
+  __ cmpq(index, words_end);
+  __ j(kAboveEqual, &no_mismatch);
+  __ movq(out, Address(a_ptr, index, TIMES_1, 0));
+  __ xorq(out, Address(b_ptr, index, TIMES_1, 0));
+  __ addq(index, Immediate(sizeof(uint64_t)));
+  __ testq(out, out);
+  __ j(kEqual, &loop);
+
+  // Find the first mismatching byte (little-endian) and convert it to an element index.
+  __ bsfq(out, out);
+  __ shrq(out, Immediate(WhichPowerOf2(kBitsPerByte)));
+  __ leaq(index, Address(index, out, TIMES_1, -static_cast<int32_t>(sizeof(uint64_t))));
+  __ shrq(index, log2_scale);
+  __ movl(out, index);
+  __ jmp(&end);
+
+  // Return the complement of the number of remaining elements.
+  __ Bind(&no_mismatch);
+  __ shrq(words_end, log2_scale);
+  __ movl(out, length);
+  __ subl(out, words_end);
+  __ notl(out);
+  __ Bind(&end);
+}
+
 #define MARK_UNIMPLEMENTED(Name) UNIMPLEMENTED_INTRINSIC(X86_64, Name)
 UNIMPLEMENTED_INTRINSIC_LIST_X86_64(MARK_UNIMPLEMENTED);
 #undef MARK_UNIMPLEMENTED
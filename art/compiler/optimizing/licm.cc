@@ -16,6 +16,9 @@
 
 #include "licm.h"
 
+#include "base/arena_bit_vector.h"
+#include "base/scoped_arena_allocator.h"
+#include "load_store_analysis.h"
 #include "side_effects_analysis.h"
 
 namespace art HIDDEN {
@@ -78,6 +81,133 @@ static void UpdateLoopPhisIn(HEnvironment* environment, HLoopInformation* info)
   }
 }
 
+static bool IsHeapLoad(HInstruction* instruction) {
+  return instruction->IsInstanceFieldGet() ||
+         instruction->IsStaticFieldGet() ||
+         instruction->IsArrayGet() ||
+         instruction->IsVecLoad();
+}
+
+static bool IsHeapStore(HInstruction* instruction) {
+  return instruction->IsInstanceFieldSet() ||
+         instruction->IsStaticFieldSet() ||
+         instruction->IsArraySet() ||
+         instruction->IsVecStore();
+}
+
+/**
+ * Finer-grained dependence model for heap loads in loops that write to the heap. Rather
+ * than relying on the side effects which only distinguish field and array accesses by type,
+ * this checks whether any store in the loop may alias the location read by the load, using
+ * the heap locations of the load-store analysis. The analysis is only run on demand.
+ */
+class HeapLoadDependence {
+ public:
+  explicit HeapLoadDependence(HGraph* graph)
+      : allocator_(graph->GetArenaStack()),
+        lsa_(graph, /*stats=*/ nullptr, &allocator_),
+        lsa_state_(LsaState::kNotRun),
+        loop_info_(nullptr),
+        loop_has_other_writes_(false),
+        loop_stores_(&allocator_, /*start_bits=*/ 0u, /*expandable=*/ true, kArenaAllocLICM) {}
+
+  // Returns whether the heap load `instruction` may read a location written in the loop
+  // described by `loop_info` and `loop_effects`.
+  bool MayDependOnLoop(HInstruction* instruction,
+                       HLoopInformation* loop_info,
+                       SideEffects loop_effects) {
+    DCHECK(IsHeapLoad(instruction));
+    // Any other dependence, for example on the GC, still prevents hoisting.
+    SideEffects other_loop_effects = loop_effects.Exclusion(SideEffects::AllWrites());
+    if (instruction->GetSideEffects().MayDependOn(other_loop_effects)) {
+      return true;
+    }
+    if (!EnsureHeapLocations()) {
+      return true;
+    }
+    const HeapLocationCollector& collector = lsa_.GetHeapLocationCollector();
+    size_t location = GetHeapLocation(collector, instruction);
+    if (location == HeapLocationCollector::kHeapLocationNotFound) {
+      return true;
+    }
+    if (loop_info != loop_info_) {
+      CollectLoopStores(collector, loop_info);
+    }
+    if (loop_has_other_writes_) {
+      return true;
+    }
+    for (uint32_t stored : loop_stores_.Indexes()) {
+      if (stored == location || collector.MayAlias(stored, location)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  enum class LsaState {
+    kNotRun,
+    kSucceeded,
+    kFailed,
+  };
+
+  bool EnsureHeapLocations() {
+    if (lsa_state_ == LsaState::kNotRun) {
+      lsa_state_ = lsa_.Run() ? LsaState::kSucceeded : LsaState::kFailed;
+    }
+    return lsa_state_ == LsaState::kSucceeded;
+  }
+
+  static size_t GetHeapLocation(const HeapLocationCollector& collector,
+                                HInstruction* instruction) {
+    if (instruction->IsArrayGet() ||
+        instruction->IsArraySet() ||
+        instruction->IsVecLoad() ||
+        instruction->IsVecStore()) {
+      return collector.GetArrayHeapLocation(instruction);
+    }
+    return collector.GetFieldHeapLocation(instruction->InputAt(0), &instruction->GetFieldInfo());
+  }
+
+  void CollectLoopStores(const HeapLocationCollector& collector, HLoopInformation* loop_info) {
+    loop_info_ = loop_info;
+    loop_has_other_writes_ = false;
+    loop_stores_.ClearAllBits();
+    for (HBlocksInLoopIterator it_loop(*loop_info); !it_loop.Done(); it_loop.Advance()) {
+      HBasicBlock* block = it_loop.Current();
+      for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+        HInstruction* instruction = it.Current();
+        if (!instruction->GetSideEffects().DoesAnyWrite()) {
+          continue;
+        }
+        // Calls, monitor operations, volatile stores, etc. may write anywhere or order
+        // the memory accesses around them.
+        if (!IsHeapStore(instruction) ||
+            ((instruction->IsInstanceFieldSet() || instruction->IsStaticFieldSet()) &&
+             instruction->GetFieldInfo().IsVolatile())) {
+          loop_has_other_writes_ = true;
+          return;
+        }
+        size_t location = GetHeapLocation(collector, instruction);
+        if (location == HeapLocationCollector::kHeapLocationNotFound) {
+          loop_has_other_writes_ = true;
+          return;
+        }
+        loop_stores_.SetBit(location);
+      }
+    }
+  }
+
+  ScopedArenaAllocator allocator_;
+  LoadStoreAnalysis lsa_;
+  LsaState lsa_state_;
+
+  // Stores of the loop last passed to `MayDependOnLoop()`.
+  HLoopInformation* loop_info_;
+  bool loop_has_other_writes_;
+  ArenaBitVector loop_stores_;
+};
+
 bool LICM::Run() {
   bool didLICM = false;
   DCHECK(side_effects_.HasRun());
@@ -91,6 +221,8 @@ bool LICM::Run() {
                                                           kArenaAllocLICM);
   }
 
+  HeapLoadDependence heap_load_dependence(graph_);
+
   // Post order visit to visit inner loops before outer loops.
   for (HBasicBlock* block : graph_->GetPostOrder()) {
     if (!block->IsLoopHeader()) {
@@ -101,6 +233,17 @@ bool LICM::Run() {
     HLoopInformation* loop_info = block->GetLoopInformation();
     SideEffects loop_effects = side_effects_.GetLoopEffects(block);
     HBasicBlock* pre_header = loop_info->GetPreHeader();
+    auto may_depend_on_loop = [&](HInstruction* instruction) {
+      if (!instruction->GetSideEffects().MayDependOn(loop_effects)) {
+        return false;
+      }
+      if (!IsHeapLoad(instruction) ||
+          heap_load_dependence.MayDependOnLoop(instruction, loop_info, loop_effects)) {
+        return true;
+      }
+      MaybeRecordStat(stats_, MethodCompilationStat::kLoopInvariantHeapLoadMoved);
+      return false;
+    };
 
     for (HBlocksInLoopIterator it_loop(*loop_info); !it_loop.Done(); it_loop.Advance()) {
       HBasicBlock* inner = it_loop.Current();
@@ -140,11 +283,11 @@ bool LICM::Run() {
                 // in the loop header so far have been hoisted out, we can hoist
                 // the clinit check out also.
                 can_move = true;
-              } else if (!instruction->GetSideEffects().MayDependOn(loop_effects)) {
+              } else if (!may_depend_on_loop(instruction)) {
                 can_move = true;
               }
             }
-          } else if (!instruction->GetSideEffects().MayDependOn(loop_effects)) {
+          } else if (!may_depend_on_loop(instruction)) {
             can_move = true;
           }
         }
@@ -110,6 +110,41 @@ TEST_F(LICMTest, NoFieldHoisting) {
   EXPECT_EQ(set_field->GetBlock(), loop_body_);
 }
 
+TEST_F(LICMTest, FieldHoistingWithNonAliasingStore) {
+  BuildLoop();
+
+  // Populate the loop with instructions: set/get different fields with same types.
+  HInstruction* get_field =
+      MakeIFieldGet(loop_body_, parameter_, DataType::Type::kInt64, MemberOffset(10));
+  HInstruction* set_field =
+      MakeIFieldSet(loop_body_, parameter_, graph_->GetLongConstant(42), MemberOffset(20));
+
+  EXPECT_EQ(get_field->GetBlock(), loop_body_);
+  EXPECT_EQ(set_field->GetBlock(), loop_body_);
+  PerformLICM();
+  EXPECT_EQ(get_field->GetBlock(), loop_preheader_);
+  EXPECT_EQ(set_field->GetBlock(), loop_body_);
+}
+
+TEST_F(LICMTest, NoFieldHoistingWithInvoke) {
+  BuildLoop();
+
+  // Populate the loop with instructions: set/get different fields with same types and
+  // an invoke that may write to any field.
+  HInstruction* get_field =
+      MakeIFieldGet(loop_body_, parameter_, DataType::Type::kInt64, MemberOffset(10));
+  HInstruction* set_field =
+      MakeIFieldSet(loop_body_, parameter_, graph_->GetLongConstant(42), MemberOffset(20));
+  HInstruction* invoke = MakeInvokeStatic(loop_body_, DataType::Type::kVoid, {});
+
+  EXPECT_EQ(get_field->GetBlock(), loop_body_);
+  EXPECT_EQ(set_field->GetBlock(), loop_body_);
+  PerformLICM();
+  EXPECT_EQ(get_field->GetBlock(), loop_body_);
+  EXPECT_EQ(set_field->GetBlock(), loop_body_);
+  EXPECT_EQ(invoke->GetBlock(), loop_body_);
+}
+
 TEST_F(LICMTest, ArrayHoisting) {
   BuildLoop();
 
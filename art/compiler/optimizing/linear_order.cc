@@ -16,6 +16,7 @@
 
 #include "linear_order.h"
 
+#include "base/arena_bit_vector.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 
@@ -54,6 +55,63 @@ static void AddToListForLinearization(ScopedArenaVector<HBasicBlock*>* worklist,
   worklist->insert(insert_pos.base(), block);
 }
 
+// Helper method to move the blocks which can only leave the method by throwing, and the
+// exit block, after all the other blocks. Such blocks are cold, and keeping them out of
+// the way of the hot code improves the instruction cache density of the hot paths.
+//
+// A block is cold if it is not in a loop, does not return and all its successors are cold.
+// All blocks reachable from a cold block are then cold too, so a stable partition keeps
+// the order a reverse post order in which loops are contiguous.
+static void MoveColdBlocksLast(const HGraph* graph,
+                               ScopedArenaAllocator* allocator,
+                               ArrayRef<HBasicBlock*> linear_order) {
+  ArenaBitVector is_cold(
+      allocator, graph->GetBlocks().size(), /* expandable= */ false, kArenaAllocLinearOrder);
+  size_t num_cold = 0u;
+  bool has_cold_block_besides_exit = false;
+  for (HBasicBlock* block : ReverseRange(linear_order)) {
+    bool cold;
+    if (block->IsExitBlock()) {
+      cold = true;
+    } else if (block->IsEntryBlock() ||
+               block->GetLoopInformation() != nullptr ||
+               block->GetSuccessors().empty() ||
+               block->GetLastInstruction()->IsReturn() ||
+               block->GetLastInstruction()->IsReturnVoid()) {
+      cold = false;
+    } else {
+      // Successors that have not been visited yet are back edge targets, which are not cold.
+      cold = std::all_of(block->GetSuccessors().begin(),
+                         block->GetSuccessors().end(),
+                         [&](HBasicBlock* successor) {
+                           return is_cold.IsBitSet(successor->GetBlockId());
+                         });
+      has_cold_block_besides_exit |= cold;
+    }
+    if (cold) {
+      is_cold.SetBit(block->GetBlockId());
+      ++num_cold;
+    }
+  }
+  if (!has_cold_block_besides_exit) {
+    return;
+  }
+
+  ScopedArenaVector<HBasicBlock*> cold_blocks(allocator->Adapter(kArenaAllocLinearOrder));
+  cold_blocks.reserve(num_cold);
+  size_t num_hot = 0u;
+  for (HBasicBlock* block : linear_order) {
+    if (is_cold.IsBitSet(block->GetBlockId())) {
+      cold_blocks.push_back(block);
+    } else {
+      linear_order[num_hot] = block;
+      ++num_hot;
+    }
+  }
+  DCHECK_EQ(num_hot + cold_blocks.size(), linear_order.size());
+  std::copy(cold_blocks.begin(), cold_blocks.end(), linear_order.begin() + num_hot);
+}
+
 // Helper method to validate linear order.
 static bool IsLinearOrderWellFormed(const HGraph* graph, ArrayRef<HBasicBlock*> linear_order) {
   for (HBasicBlock* header : graph->GetBlocks()) {
@@ -87,7 +145,8 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   DCHECK_EQ(linear_order.size(), graph->GetReversePostOrder().size());
   // Create a reverse post ordering with the following properties:
   // - Blocks in a loop are consecutive,
-  // - Back-edge is the last block before loop exits.
+  // - Back-edge is the last block before loop exits,
+  // - Blocks which can only throw are after the other blocks.
   //
   // (1): Record the number of forward predecessors for each block. This is to
   //      ensure the resulting order is reverse post order. We could use the
@@ -127,6 +186,11 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   } while (!worklist.empty());
   DCHECK_EQ(num_added, linear_order.size());
 
+  // (3): Move the cold blocks after the hot ones.
+  if (!graph->HasIrreducibleLoops()) {
+    MoveColdBlocksLast(graph, &allocator, linear_order);
+  }
+
   DCHECK(graph->HasIrreducibleLoops() || IsLinearOrderWellFormed(graph, linear_order));
 }
 
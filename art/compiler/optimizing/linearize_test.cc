@@ -245,4 +245,47 @@ TEST_F(LinearizeTest, CFG7) {
   TestCode(data, blocks);
 }
 
+TEST_F(LinearizeTest, ColdThrowingBlockIsLast) {
+  // Structure of this graph:
+  //            Block0
+  //              |
+  //            Block1
+  //            /    \      <- the throwing block is the fall-through successor
+  //       Block2    Block3
+  //     (throw)    (return)
+  //            \    /
+  //             Exit
+  //
+  // The throwing block is placed after the returning block, just before the exit block.
+  const std::vector<uint16_t> data = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::IF_EQ, 3,
+    Instruction::THROW | 0,
+    Instruction::RETURN_VOID);
+
+  HGraph* graph = CreateCFG(data);
+  std::unique_ptr<CompilerOptions> compiler_options =
+      CommonCompilerTest::CreateCompilerOptions(kRuntimeISA, "default");
+  std::unique_ptr<CodeGenerator> codegen = CodeGenerator::Create(graph, *compiler_options);
+  SsaLivenessAnalysis liveness(graph, codegen.get(), GetScopedAllocator());
+  liveness.Analyze();
+
+  const ArenaVector<HBasicBlock*>& linear_order = graph->GetLinearOrder();
+  size_t throw_index = linear_order.size();
+  size_t return_index = linear_order.size();
+  for (size_t i = 0; i < linear_order.size(); ++i) {
+    HInstruction* last = linear_order[i]->GetLastInstruction();
+    if (last != nullptr && last->IsThrow()) {
+      throw_index = i;
+    } else if (last != nullptr && last->IsReturnVoid()) {
+      return_index = i;
+    }
+  }
+  ASSERT_LT(return_index, linear_order.size());
+  ASSERT_LT(throw_index, linear_order.size());
+  ASSERT_LT(return_index, throw_index);
+  ASSERT_TRUE(linear_order.back()->IsExitBlock());
+  ASSERT_EQ(throw_index + 1u, linear_order.size() - 1u);
+}
+
 }  // namespace art
@@ -205,6 +205,14 @@ class HeapLocationCollector : public HGraphVisitor {
     return heap_locations_.size();
   }
 
+  size_t GetNumberOfReferenceInfos() const {
+    return ref_info_array_.size();
+  }
+
+  ReferenceInfo* GetReferenceInfo(size_t position) const {
+    return ref_info_array_[position];
+  }
+
   HeapLocation* GetHeapLocation(size_t index) const {
     return heap_locations_[index];
   }
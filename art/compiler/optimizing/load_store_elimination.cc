@@ -62,9 +62,6 @@
  *  - In phase 4, we commit the changes, replacing loads marked for elimination
  *    in previous processing and removing stores not marked for keeping. We also
  *    remove allocations that are no longer needed.
- *  - In phase 5, we move allocations which only escape along some executions
- *    closer to their escape points and fixup non-escaping paths with their actual
- *    values, creating PHIs when needed.
  *
  * 1. Walk over blocks and their instructions.
  *
@@ -108,6 +105,12 @@
  *    return/deoptimization.
  *  - Some instructions such as invokes are treated as loading and invalidating
  *    all the heap values, depending on the instruction's side effects.
+ *  - For allocations which escape only along some executions, we record the
+ *    instructions through which they escape. Until such an allocation may have
+ *    escaped, invokes and stores through other references do not invalidate
+ *    its heap values, so that loads on the non-escaping paths can be eliminated.
+ *    Code sinking later moves the allocation and the stores that are still
+ *    needed closer to the escape points.
  *  - SIMD graphs (with VecLoad and VecStore instructions) are also handled. Any
  *    partial overlap access among ArrayGet/ArraySet/VecLoad/Store is seen as
  *    alias and no load/store is eliminated in such case.
@@ -451,6 +454,14 @@ class LSEVisitor final : private HGraphDelegateVisitor {
 
   bool IsEscapingObject(ReferenceInfo* info) { return !info->IsSingletonAndRemovable(); }
 
+  // Record the escapes of allocations which are not singletons, see `HasEscapedAt()`.
+  void FindPartialEscapes();
+
+  // Returns whether the reference of `info` may have escaped before or at `instruction`.
+  // For references which are not allocations that escape only along some executions,
+  // this returns false for singletons and true otherwise.
+  bool HasEscapedAt(ReferenceInfo* info, HInstruction* instruction) const;
+
   PhiPlaceholder GetPhiPlaceholderAt(size_t off) const {
     DCHECK_LT(off, num_phi_placeholders_);
     size_t id = off % heap_location_collector_.GetNumberOfHeapLocations();
@@ -1003,8 +1014,9 @@ class LSEVisitor final : private HGraphDelegateVisitor {
       ReferenceInfo* ref_info = heap_location_collector_.GetHeapLocation(i)->GetReferenceInfo();
       // We don't need to do anything if the reference has not escaped at this point.
       // This is true if we never escape.
-      if (!can_throw_inside_a_try && ref_info->IsSingleton()) {
-        // Singleton references cannot be seen by the callee.
+      if (!can_throw_inside_a_try && !HasEscapedAt(ref_info, instruction)) {
+        // Singleton references, and references which have not escaped yet,
+        // cannot be seen by the callee.
       } else {
         if (can_throw || side_effects.DoesAnyRead() || side_effects.DoesAnyWrite()) {
           // Previous stores may become visible (read) and/or impossible for LSE to track (write).
@@ -1180,6 +1192,21 @@ class LSEVisitor final : private HGraphDelegateVisitor {
 
   ScopedArenaVector<HInstruction*> singleton_new_instances_;
 
+  // The escapes of an allocation which escapes only along some executions.
+  struct PartialEscape {
+    PartialEscape(ScopedArenaAllocator* allocator, size_t num_blocks)
+        : escaped_on_entry(allocator, num_blocks, /*expandable=*/false, kArenaAllocLSE),
+          escapes(allocator->Adapter(kArenaAllocLSE)) {}
+
+    // Blocks which can be entered after the reference has escaped.
+    ArenaBitVector escaped_on_entry;
+    // Instructions through which the reference escapes.
+    ScopedArenaVector<HInstruction*> escapes;
+  };
+
+  // Partial escapes indexed by the position of the `ReferenceInfo`, null if not recorded.
+  ScopedArenaVector<PartialEscape*> partial_escapes_;
+
   // The field infos for each heap location (if relevant).
   ScopedArenaVector<const FieldInfo*> field_infos_;
 
@@ -1293,6 +1320,9 @@ LSEVisitor::LSEVisitor(HGraph* graph,
       phi_placeholder_replacements_(
           num_phi_placeholders_, Value::Invalid(), allocator_.Adapter(kArenaAllocLSE)),
       singleton_new_instances_(allocator_.Adapter(kArenaAllocLSE)),
+      partial_escapes_(heap_location_collector_.GetNumberOfReferenceInfos(),
+                       nullptr,
+                       allocator_.Adapter(kArenaAllocLSE)),
       field_infos_(heap_location_collector_.GetNumberOfHeapLocations(),
                    allocator_.Adapter(kArenaAllocLSE)),
       current_phase_(Phase::kLoadElimination) {}
@@ -1647,6 +1677,8 @@ void LSEVisitor::VisitSetLocation(HInstruction* instruction, size_t idx, HInstru
   record.stored_by = Value::ForInstruction(instruction);
 
   // This store may kill values in other heap locations due to aliasing.
+  ReferenceInfo* ref_info = heap_location_collector_.GetHeapLocation(idx)->GetReferenceInfo();
+  const bool ref_has_escaped = HasEscapedAt(ref_info, instruction);
   for (size_t i = 0u, size = heap_values.size(); i != size; ++i) {
     if (i == idx ||
         heap_values[i].value.IsUnknown() ||
@@ -1654,6 +1686,12 @@ void LSEVisitor::VisitSetLocation(HInstruction* instruction, size_t idx, HInstru
         !heap_location_collector_.MayAlias(i, idx)) {
       continue;
     }
+    ReferenceInfo* other_ref_info = heap_location_collector_.GetHeapLocation(i)->GetReferenceInfo();
+    if (other_ref_info != ref_info &&
+        (!ref_has_escaped || !HasEscapedAt(other_ref_info, instruction))) {
+      // One of the references has not escaped yet, so they cannot be the same object.
+      continue;
+    }
     // Kill heap locations that may alias and keep previous stores to these locations.
     KeepStores(heap_values[i].stored_by);
     heap_values[i].stored_by = Value::Unknown();
@@ -1673,6 +1711,69 @@ void LSEVisitor::VisitBasicBlock(HBasicBlock* block) {
   VisitNonPhiInstructions(block);
 }
 
+void LSEVisitor::FindPartialEscapes() {
+  const size_t num_blocks = GetGraph()->GetBlocks().size();
+  ScopedArenaVector<HBasicBlock*> worklist(allocator_.Adapter(kArenaAllocLSE));
+  for (size_t pos = 0u, size = partial_escapes_.size(); pos != size; ++pos) {
+    ReferenceInfo* ref_info = heap_location_collector_.GetReferenceInfo(pos);
+    HInstruction* reference = ref_info->GetReference();
+    if (ref_info->IsSingleton() ||
+        (!reference->IsNewInstance() && !reference->IsNewArray()) ||
+        (reference->IsNewInstance() && reference->AsNewInstance()->IsFinalizable())) {
+      // Singletons never escape and other references have escaped on method entry.
+      continue;
+    }
+    PartialEscape* partial_escape =
+        new (allocator_.Alloc<PartialEscape>(kArenaAllocLSE)) PartialEscape(&allocator_,
+                                                                            num_blocks);
+    LambdaEscapeVisitor visitor([&](HInstruction* escape) {
+      partial_escape->escapes.push_back(escape);
+      return true;
+    });
+    VisitEscapes(reference, visitor);
+    DCHECK(!partial_escape->escapes.empty());
+    // The reference may have escaped in all blocks reachable from an escaping block.
+    DCHECK(worklist.empty());
+    for (HInstruction* escape : partial_escape->escapes) {
+      worklist.push_back(escape->GetBlock());
+    }
+    while (!worklist.empty()) {
+      HBasicBlock* block = worklist.back();
+      worklist.pop_back();
+      for (HBasicBlock* successor : block->GetSuccessors()) {
+        if (!partial_escape->escaped_on_entry.IsBitSet(successor->GetBlockId())) {
+          partial_escape->escaped_on_entry.SetBit(successor->GetBlockId());
+          worklist.push_back(successor);
+        }
+      }
+    }
+    if (partial_escape->escaped_on_entry.IsBitSet(reference->GetBlock()->GetBlockId())) {
+      // The allocation is in a loop and escapes in it. Do not bother with such allocations.
+      continue;
+    }
+    partial_escapes_[pos] = partial_escape;
+    MaybeRecordStat(stats_, MethodCompilationStat::kPartialLSEPossible);
+  }
+}
+
+bool LSEVisitor::HasEscapedAt(ReferenceInfo* info, HInstruction* instruction) const {
+  PartialEscape* partial_escape = partial_escapes_[info->GetPosition()];
+  if (partial_escape == nullptr) {
+    return !info->IsSingleton();
+  }
+  HBasicBlock* block = instruction->GetBlock();
+  if (partial_escape->escaped_on_entry.IsBitSet(block->GetBlockId())) {
+    return true;
+  }
+  for (HInstruction* escape : partial_escape->escapes) {
+    if (escape->GetBlock() == block &&
+        (escape == instruction || escape->IsPhi() || escape->StrictlyDominates(instruction))) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool LSEVisitor::MayAliasOnBackEdge(HBasicBlock* loop_header, size_t idx1, size_t idx2) const {
   DCHECK_NE(idx1, idx2);
   DCHECK(loop_header->IsLoopHeader());
@@ -2591,6 +2692,9 @@ void LSEVisitor::Run() {
   // remove, we will set it to true in VisitMonitorOperation.
   GetGraph()->SetHasMonitorOperations(false);
 
+  // Record where allocations which escape only along some executions escape.
+  FindPartialEscapes();
+
   // 1. Process blocks and instructions in reverse post order.
   for (HBasicBlock* block : GetGraph()->GetReversePostOrder()) {
     VisitBasicBlock(block);
@@ -2212,4 +2212,109 @@ TEST_F(LoadStoreEliminationTest, DISABLED_PartialLoadPreserved6) {
   EXPECT_INS_RETAINED(call_left);
   EXPECT_INS_RETAINED(call_entry);
 }
+
+// // ENTRY
+// obj = new Obj();
+// obj.field = 1;
+// if (parameter_value) {
+//   // LEFT
+//   // DO NOT ELIMINATE
+//   escape(obj);
+// } else {
+//   // RIGHT
+//   // obj has not escaped yet so the call cannot change obj.field.
+//   noescape();
+//   // ELIMINATE
+//   use(obj.field);
+// }
+// EXIT
+TEST_F(LoadStoreEliminationTest, PartialEscapeLoadAfterInvoke) {
+  ScopedObjectAccess soa(Thread::Current());
+  VariableSizedHandleScope vshs(soa.Self());
+  HBasicBlock* breturn = InitEntryMainExitGraph(&vshs);
+
+  HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+  HInstruction* c1 = graph_->GetIntConstant(1);
+
+  auto [start, left, right] = CreateDiamondPattern(breturn, bool_value);
+
+  // start
+  HInstruction* cls = MakeLoadClass(start);
+  HInstruction* new_inst = MakeNewInstance(start, cls);
+  HInstruction* write_start = MakeIFieldSet(start, new_inst, c1, MemberOffset(32));
+
+  HInstruction* call_left = MakeInvokeStatic(left, DataType::Type::kVoid, { new_inst });
+
+  HInstruction* call_right = MakeInvokeStatic(right, DataType::Type::kVoid, {});
+  HInstruction* read_right =
+      MakeIFieldGet(right, new_inst, DataType::Type::kInt32, MemberOffset(32));
+  HInstruction* use_right = MakeInvokeStatic(right, DataType::Type::kVoid, { read_right });
+
+  MakeReturnVoid(breturn);
+
+  PerformLSE();
+
+  EXPECT_INS_REMOVED(read_right);
+  EXPECT_INS_EQ(use_right->InputAt(0), c1);
+  EXPECT_INS_RETAINED(write_start);
+  EXPECT_INS_RETAINED(new_inst);
+  EXPECT_INS_RETAINED(call_left);
+  EXPECT_INS_RETAINED(call_right);
+}
+
+// // ENTRY
+// obj = new Obj();
+// obj.field = 1;
+// if (parameter_value) {
+//   // LEFT
+//   // DO NOT ELIMINATE
+//   escape(obj);
+//   // DO NOT ELIMINATE
+//   use(obj.field);
+// } else {
+//   // RIGHT
+//   // obj has not escaped yet so `other` cannot be `obj`.
+//   other.field = 2;
+//   // ELIMINATE
+//   use(obj.field);
+// }
+// EXIT
+TEST_F(LoadStoreEliminationTest, PartialEscapeLoadAfterAliasingStore) {
+  ScopedObjectAccess soa(Thread::Current());
+  VariableSizedHandleScope vshs(soa.Self());
+  HBasicBlock* breturn = InitEntryMainExitGraph(&vshs);
+
+  HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+  HInstruction* other = MakeParam(DataType::Type::kReference);
+  HInstruction* c1 = graph_->GetIntConstant(1);
+  HInstruction* c2 = graph_->GetIntConstant(2);
+
+  auto [start, left, right] = CreateDiamondPattern(breturn, bool_value);
+
+  // start
+  HInstruction* cls = MakeLoadClass(start);
+  HInstruction* new_inst = MakeNewInstance(start, cls);
+  HInstruction* write_start = MakeIFieldSet(start, new_inst, c1, MemberOffset(32));
+
+  HInstruction* call_left = MakeInvokeStatic(left, DataType::Type::kVoid, { new_inst });
+  HInstruction* read_left =
+      MakeIFieldGet(left, new_inst, DataType::Type::kInt32, MemberOffset(32));
+  MakeInvokeStatic(left, DataType::Type::kVoid, { read_left });
+
+  HInstruction* write_right = MakeIFieldSet(right, other, c2, MemberOffset(32));
+  HInstruction* read_right =
+      MakeIFieldGet(right, new_inst, DataType::Type::kInt32, MemberOffset(32));
+  HInstruction* use_right = MakeInvokeStatic(right, DataType::Type::kVoid, { read_right });
+
+  MakeReturnVoid(breturn);
+
+  PerformLSE();
+
+  EXPECT_INS_RETAINED(read_left);
+  EXPECT_INS_REMOVED(read_right);
+  EXPECT_INS_EQ(use_right->InputAt(0), c1);
+  EXPECT_INS_RETAINED(write_start);
+  EXPECT_INS_RETAINED(write_right);
+  EXPECT_INS_RETAINED(call_left);
+}
 }  // namespace art
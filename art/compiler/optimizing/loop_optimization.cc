@@ -19,6 +19,7 @@
 #include "arch/arm/instruction_set_features_arm.h"
 #include "arch/arm64/instruction_set_features_arm64.h"
 #include "arch/instruction_set.h"
+#include "arch/riscv64/instruction_set_features_riscv64.h"
 #include "arch/x86/instruction_set_features_x86.h"
 #include "arch/x86_64/instruction_set_features_x86_64.h"
 #include "code_generator.h"
@@ -526,8 +527,8 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
       vector_refs_(nullptr),
       vector_static_peeling_factor_(0),
       vector_dynamic_peeling_candidate_(nullptr),
-      vector_runtime_test_a_(nullptr),
-      vector_runtime_test_b_(nullptr),
+      vector_runtime_tests_(),
+      num_vector_runtime_tests_(0u),
       vector_map_(nullptr),
       vector_permanent_map_(nullptr),
       vector_external_set_(nullptr),
@@ -1139,8 +1140,7 @@ bool HLoopOptimization::CanVectorizeDataFlow(LoopNode* node,
   vector_refs_->clear();
   vector_static_peeling_factor_ = 0;
   vector_dynamic_peeling_candidate_ = nullptr;
-  vector_runtime_test_a_ =
-  vector_runtime_test_b_ = nullptr;
+  num_vector_runtime_tests_ = 0u;
 
   // Traverse the data flow of the loop, in the original program order.
   for (HBlocksInLoopReversePostOrderIterator block_it(*header->GetLoopInformation());
@@ -1213,16 +1213,8 @@ bool HLoopOptimization::CanVectorizeDataFlow(LoopNode* node,
           // Found a[i+x] vs. b[i+y]. Accept if x == y (at worst loop-independent data dependence).
           // Conservatively assume a potential loop-carried data dependence otherwise, avoided by
           // generating an explicit a != b disambiguation runtime test on the two references.
-          if (x != y) {
-            // To avoid excessive overhead, we only accept one a != b test.
-            if (vector_runtime_test_a_ == nullptr) {
-              // First test found.
-              vector_runtime_test_a_ = a;
-              vector_runtime_test_b_ = b;
-            } else if ((vector_runtime_test_a_ != a || vector_runtime_test_b_ != b) &&
-                       (vector_runtime_test_a_ != b || vector_runtime_test_b_ != a)) {
-              return false;  // second test would be needed
-            }
+          if (x != y && !AddArrayRefsDisambiguationTest(a, b)) {
+            return false;  // too many tests would be needed
           }
         }
       }
@@ -1307,15 +1299,10 @@ void HLoopOptimization::VectorizePredicated(LoopNode* node,
   HInstruction* vtc = stc;
   vector_index_ = graph_->GetConstant(induc_type, 0);
   bool needs_disambiguation_test = false;
-  // Generate runtime disambiguation test:
+  // Generate runtime disambiguation tests:
   // vtc = a != b ? vtc : 0;
   if (NeedsArrayRefsDisambiguationTest()) {
-    HInstruction* rt = Insert(
-        preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
-    vtc = Insert(preheader,
-                 new (global_allocator_)
-                 HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
+    vtc = GenerateArrayRefsDisambiguationTest(preheader, vtc, induc_type);
     needs_disambiguation_test = true;
   }
 
@@ -1456,15 +1443,10 @@ void HLoopOptimization::VectorizeTraditional(LoopNode* node,
   }
   vector_index_ = graph_->GetConstant(induc_type, 0);
 
-  // Generate runtime disambiguation test:
+  // Generate runtime disambiguation tests:
   // vtc = a != b ? vtc : 0;
   if (NeedsArrayRefsDisambiguationTest()) {
-    HInstruction* rt = Insert(
-        preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
-    vtc = Insert(preheader,
-                 new (global_allocator_)
-                 HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
+    vtc = GenerateArrayRefsDisambiguationTest(preheader, vtc, induc_type);
     needs_cleanup = true;
   }
 
@@ -1575,6 +1557,35 @@ HPhi* HLoopOptimization::InitializeForNewLoop(HBasicBlock* new_preheader, HInstr
   return phi;
 }
 
+bool HLoopOptimization::AddArrayRefsDisambiguationTest(HInstruction* a, HInstruction* b) {
+  for (size_t i = 0; i != num_vector_runtime_tests_; ++i) {
+    const std::pair<HInstruction*, HInstruction*>& test = vector_runtime_tests_[i];
+    if ((test.first == a && test.second == b) || (test.first == b && test.second == a)) {
+      return true;  // same test already found
+    }
+  }
+  if (num_vector_runtime_tests_ == kMaxNumberOfArrayRefsDisambiguationTests) {
+    return false;
+  }
+  vector_runtime_tests_[num_vector_runtime_tests_++] = std::make_pair(a, b);
+  return true;
+}
+
+HInstruction* HLoopOptimization::GenerateArrayRefsDisambiguationTest(HBasicBlock* preheader,
+                                                                     HInstruction* vtc,
+                                                                     DataType::Type induc_type) {
+  DCHECK(NeedsArrayRefsDisambiguationTest());
+  for (size_t i = 0; i != num_vector_runtime_tests_; ++i) {
+    const std::pair<HInstruction*, HInstruction*>& test = vector_runtime_tests_[i];
+    HInstruction* rt =
+        Insert(preheader, new (global_allocator_) HNotEqual(test.first, test.second));
+    vtc = Insert(preheader,
+                 new (global_allocator_)
+                 HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
+  }
+  return vtc;
+}
+
 void HLoopOptimization::GenerateNewLoopScalarOrTraditional(LoopNode* node,
                                                            HBasicBlock* new_preheader,
                                                            HInstruction* lo,
@@ -2152,7 +2163,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
                              kNoSAD;
             return TrySetVectorLength(type, 8);
           case DataType::Type::kInt32:
-            *restrictions |= kNoDiv | kNoSAD;
+            *restrictions |= kNoDiv | kNoWideSAD;
             return TrySetVectorLength(type, 4);
           case DataType::Type::kInt64:
             *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoSAD;
@@ -2168,6 +2179,46 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
         }  // switch type
       }
       return false;
+    case InstructionSet::kRiscv64:
+      // Allow vectorization for devices with the "V" extension only, using fixed 128-bit
+      // vectors (the minimum VLEN guaranteed by the extension).
+      *restrictions |= kNoIfCond | kNoStringCharAt | kNoAbs | kNoSAD | kNoWideSAD | kNoDotProd;
+      if (features->AsRiscv64InstructionSetFeatures()->HasVector()) {
+        switch (type) {
+          case DataType::Type::kBool:
+          case DataType::Type::kUint8:
+          case DataType::Type::kInt8:
+            *restrictions |= kNoDiv |
+                             kNoSignedHAdd |
+                             kNoUnsignedHAdd |
+                             kNoUnroundedHAdd |
+                             kNoReduction;
+            return TrySetVectorLength(type, 16);
+          case DataType::Type::kUint16:
+          case DataType::Type::kInt16:
+            *restrictions |= kNoDiv |
+                             kNoSignedHAdd |
+                             kNoUnsignedHAdd |
+                             kNoUnroundedHAdd |
+                             kNoReduction;
+            return TrySetVectorLength(type, 8);
+          case DataType::Type::kInt32:
+            *restrictions |= kNoDiv | kNoSignedHAdd | kNoUnsignedHAdd | kNoUnroundedHAdd;
+            return TrySetVectorLength(type, 4);
+          case DataType::Type::kInt64:
+            *restrictions |= kNoDiv | kNoSignedHAdd | kNoUnsignedHAdd | kNoUnroundedHAdd;
+            return TrySetVectorLength(type, 2);
+          case DataType::Type::kFloat32:
+            *restrictions |= kNoReduction;
+            return TrySetVectorLength(type, 4);
+          case DataType::Type::kFloat64:
+            *restrictions |= kNoReduction;
+            return TrySetVectorLength(type, 2);
+          default:
+            break;
+        }  // switch type
+      }
+      return false;
     default:
       return false;
   }  // switch instruction set
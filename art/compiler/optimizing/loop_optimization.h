@@ -17,6 +17,8 @@
 #ifndef ART_COMPILER_OPTIMIZING_LOOP_OPTIMIZATION_H_
 #define ART_COMPILER_OPTIMIZING_LOOP_OPTIMIZATION_H_
 
+#include <utility>
+
 #include "base/macros.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
@@ -388,7 +390,21 @@ class HLoopOptimization : public HOptimization {
                                HInstruction* step);
 
   // Returns whether the vector loop needs runtime disambiguation test for array refs.
-  bool NeedsArrayRefsDisambiguationTest() const { return vector_runtime_test_a_ != nullptr; }
+  bool NeedsArrayRefsDisambiguationTest() const { return num_vector_runtime_tests_ != 0u; }
+
+  // Records that the vector loop needs an a != b runtime test. Returns false if
+  // too many tests would be needed.
+  bool AddArrayRefsDisambiguationTest(HInstruction* a, HInstruction* b);
+
+  // Generates the runtime disambiguation tests in `preheader`:
+  //   vtc = a1 != b1 ? vtc : 0;
+  //   ...
+  //   vtc = an != bn ? vtc : 0;
+  // so that the vector loop is skipped in favor of the cleanup loop when any
+  // pair of array refs is the same array. Returns the new vector trip count.
+  HInstruction* GenerateArrayRefsDisambiguationTest(HBasicBlock* preheader,
+                                                    HInstruction* vtc,
+                                                    DataType::Type induc_type);
 
   bool VectorizeDef(LoopNode* node, HInstruction* instruction, bool generate_code);
   bool VectorizeUse(LoopNode* node,
@@ -538,9 +554,12 @@ class HLoopOptimization : public HOptimization {
   uint32_t vector_static_peeling_factor_;
   const ArrayReference* vector_dynamic_peeling_candidate_;
 
-  // Dynamic data dependence test of the form a != b.
-  HInstruction* vector_runtime_test_a_;
-  HInstruction* vector_runtime_test_b_;
+  // Dynamic data dependence tests of the form a != b. To avoid excessive overhead,
+  // only a few tests are accepted for a loop.
+  static constexpr size_t kMaxNumberOfArrayRefsDisambiguationTests = 4u;
+  std::pair<HInstruction*, HInstruction*>
+      vector_runtime_tests_[kMaxNumberOfArrayRefsDisambiguationTests];
+  size_t num_vector_runtime_tests_;
 
   // Mapping used during vectorization synthesis for both the scalar peeling/cleanup
   // loop (mode is kSequential) and the actual vector loop (mode is kVector). The data
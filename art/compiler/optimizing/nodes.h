@@ -234,6 +234,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         has_irreducible_loops_(false),
         has_direct_critical_native_call_(false),
         has_always_throwing_invokes_(false),
+        use_explicit_null_checks_(false),
         dead_reference_safe_(dead_reference_safe),
         debuggable_(debuggable),
         current_instruction_id_(start_instruction_id),
@@ -242,6 +243,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         invoke_type_(invoke_type),
         in_ssa_form_(false),
         number_of_cha_guards_(0),
+        number_of_inlined_methods_(0),
         instruction_set_(instruction_set),
         cached_null_constant_(nullptr),
         cached_int_constants_(std::less<int32_t>(), allocator->Adapter(kArenaAllocConstantsMap)),
@@ -530,6 +532,9 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   bool HasAlwaysThrowingInvokes() const { return has_always_throwing_invokes_; }
   void SetHasAlwaysThrowingInvokes(bool value) { has_always_throwing_invokes_ = value; }
 
+  bool UseExplicitNullChecks() const { return use_explicit_null_checks_; }
+  void SetUseExplicitNullChecks() { use_explicit_null_checks_ = true; }
+
   ArtMethod* GetArtMethod() const { return art_method_; }
   void SetArtMethod(ArtMethod* method) { art_method_ = method; }
 
@@ -544,6 +549,9 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   void SetNumberOfCHAGuards(uint32_t num) { number_of_cha_guards_ = num; }
   void IncrementNumberOfCHAGuards() { number_of_cha_guards_++; }
 
+  uint32_t GetNumberOfInlinedMethods() const { return number_of_inlined_methods_; }
+  void IncrementNumberOfInlinedMethods() { number_of_inlined_methods_++; }
+
   void SetUsefulOptimizing() { useful_optimizing_ = true; }
   bool IsUsefulOptimizing() const { return useful_optimizing_; }
 
@@ -623,6 +631,10 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // Flag whether the graph contains invokes that always throw.
   bool has_always_throwing_invokes_;
 
+  // Flag whether to use explicit null checks even if the compiler options allow implicit ones,
+  // because the method often throws NullPointerExceptions from implicit null checks.
+  bool use_explicit_null_checks_;
+
   // Is the code known to be robust against eliminating dead references
   // and the effects of early finalization? If false, dead reference variables
   // are kept if they might be visible to the garbage collector.
@@ -657,6 +669,9 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // CHA guard optimization pass when there is no CHA guard left.
   uint32_t number_of_cha_guards_;
 
+  // Number of methods inlined in the graph, including the ones inlined in inlinees.
+  uint32_t number_of_inlined_methods_;
+
   const InstructionSet instruction_set_;
 
   // Cached constants.
@@ -7325,7 +7340,7 @@ class HStringBuilderAppend final : public HVariableInputSizeInstruction {
   HStringBuilderAppend(HIntConstant* format,
                        uint32_t number_of_arguments,
                        uint32_t number_of_out_vregs,
-                       bool has_fp_args,
+                       bool calls_managed_code,
                        ArenaAllocator* allocator,
                        uint32_t dex_pc)
       : HVariableInputSizeInstruction(
@@ -7334,8 +7349,9 @@ class HStringBuilderAppend final : public HVariableInputSizeInstruction {
             SideEffects::CanTriggerGC().Union(
                 // The runtime call may read memory from inputs. It never writes outside
                 // of the newly allocated result object or newly allocated helper objects,
-                // except for float/double arguments where we reuse thread-local helper objects.
-                has_fp_args ? SideEffects::AllWritesAndReads() : SideEffects::AllReads()),
+                // except for float/double arguments where we reuse thread-local helper objects
+                // and for object arguments where we call `String.valueOf()`.
+                calls_managed_code ? SideEffects::AllWritesAndReads() : SideEffects::AllReads()),
             dex_pc,
             allocator,
             number_of_arguments + /* format */ 1u,
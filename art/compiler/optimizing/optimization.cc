@@ -237,7 +237,7 @@ ArenaVector<HOptimization*> ConstructOptimizations(
       case OptimizationPass::kBoundsCheckElimination:
         CHECK(most_recent_side_effects != nullptr && most_recent_induction != nullptr);
         opt = new (allocator) BoundsCheckElimination(
-            graph, *most_recent_side_effects, most_recent_induction, pass_name);
+            graph, *most_recent_side_effects, most_recent_induction, stats, pass_name);
         break;
       //
       // Regular passes.
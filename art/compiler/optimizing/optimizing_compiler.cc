@@ -31,6 +31,7 @@
 #include "base/mutex.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/systrace.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "builder.h"
 #include "code_generator.h"
@@ -48,12 +49,15 @@
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "jit/jit_logger.h"
+#include "jit/jit_persistent_cache.h"
+#include "jit/profiling_info.h"
 #include "jni/quick/jni_compiler.h"
 #include "linker/linker_patch.h"
 #include "nodes.h"
 #include "oat/oat_quick_method_header.h"
 #include "optimizing/write_barrier_elimination.h"
 #include "prepare_for_register_allocation.h"
+#include "profile/profile_compilation_info.h"
 #include "profiling_info_builder.h"
 #include "reference_type_propagation.h"
 #include "register_allocator_linear_scan.h"
@@ -538,7 +542,8 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
           OptDef(OptimizationPass::kInstructionSimplifierRiscv64),
           OptDef(OptimizationPass::kSideEffectsAnalysis),
           OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
-          OptDef(OptimizationPass::kCriticalNativeAbiFixupRiscv64)
+          OptDef(OptimizationPass::kCriticalNativeAbiFixupRiscv64),
+          OptDef(OptimizationPass::kScheduling)
       };
       return RunOptimizations(graph,
                               codegen,
@@ -569,6 +574,8 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
           OptDef(OptimizationPass::kInstructionSimplifierX86_64),
           OptDef(OptimizationPass::kSideEffectsAnalysis),
           OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
+          // Before kX86MemoryOperandGeneration, which relies on the order of instructions.
+          OptDef(OptimizationPass::kScheduling),
           OptDef(OptimizationPass::kX86MemoryOperandGeneration)
       };
       return RunOptimizations(graph,
@@ -586,11 +593,39 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
   }
 }
 
+static RegisterAllocator::Strategy GetRegisterAllocationStrategy(
+    const CompilerOptions& compiler_options,
+    const DexCompilationUnit& dex_compilation_unit,
+    jit::Jit* jit) {
+  switch (compiler_options.GetRegisterAllocationStrategy()) {
+    case RegisterAllocationStrategy::kLinearScan:
+      return RegisterAllocator::kRegisterAllocatorLinearScan;
+    case RegisterAllocationStrategy::kSpillCost:
+      return RegisterAllocator::kRegisterAllocatorSpillCost;
+    case RegisterAllocationStrategy::kProfileGuided: {
+      // The JIT has no profile to look at, and only compiles hot methods with optimizing.
+      const ProfileCompilationInfo* pci = compiler_options.GetProfileCompilationInfo();
+      if (jit == nullptr && pci != nullptr) {
+        ProfileCompilationInfo::MethodHotness hotness = pci->GetMethodHotness(MethodReference(
+            dex_compilation_unit.GetDexFile(), dex_compilation_unit.GetDexMethodIndex()));
+        if (hotness.IsHot()) {
+          return RegisterAllocator::kRegisterAllocatorSpillCost;
+        }
+      }
+      return RegisterAllocator::kRegisterAllocatorLinearScan;
+    }
+  }
+  LOG(FATAL) << "Unreachable";
+  UNREACHABLE();
+}
+
 NO_INLINE  // Avoid increasing caller's frame size by large stack-allocated objects.
 static void AllocateRegisters(HGraph* graph,
                               CodeGenerator* codegen,
                               PassObserver* pass_observer,
-                              OptimizingCompilerStats* stats) {
+                              OptimizingCompilerStats* stats,
+                              RegisterAllocator::Strategy strategy =
+                                  RegisterAllocator::kRegisterAllocatorDefault) {
   {
     PassScope scope(PrepareForRegisterAllocation::kPrepareForRegisterAllocationPassName,
                     pass_observer);
@@ -607,7 +642,7 @@ static void AllocateRegisters(HGraph* graph,
   {
     PassScope scope(RegisterAllocator::kRegisterAllocatorPassName, pass_observer);
     std::unique_ptr<RegisterAllocator> register_allocator =
-        RegisterAllocator::Create(&local_allocator, codegen, liveness);
+        RegisterAllocator::Create(&local_allocator, codegen, liveness, strategy, stats);
     register_allocator->AllocateRegisters();
   }
 }
@@ -842,6 +877,9 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   if (jit != nullptr) {
     ProfilingInfo* info = jit->GetCodeCache()->GetProfilingInfo(method, Thread::Current());
     graph->SetProfilingInfo(info);
+    if (info != nullptr && info->HasFrequentImplicitNullCheckFaults()) {
+      graph->SetUseExplicitNullChecks();
+    }
   }
 
   std::unique_ptr<CodeGenerator> codegen(
@@ -947,7 +985,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   AllocateRegisters(graph,
                     codegen.get(),
                     &pass_observer,
-                    compilation_stats_.get());
+                    compilation_stats_.get(),
+                    GetRegisterAllocationStrategy(compiler_options, dex_compilation_unit, jit));
 
   if (UNLIKELY(codegen->GetFrameSize() > codegen->GetMaximumFrameSize())) {
     SCOPED_TRACE << "Not compiling because of stack frame too large";
@@ -1259,6 +1298,67 @@ bool EncodeArtMethodInInlineInfo([[maybe_unused]] ArtMethod* method) {
   return Runtime::Current() == nullptr || !Runtime::Current()->IsAotCompiler();
 }
 
+// Returns whether the JIT code of `codegen` can be installed in another process, i.e. it does
+// not embed any address, JIT root or assumption that only holds in the current process.
+static bool IsProcessIndependentJitCode(CodeGenerator* codegen) {
+  HGraph* graph = codegen->GetGraph();
+  if (codegen->GetNumberOfJitRoots() != 0u ||
+      !graph->GetCHASingleImplementationList().empty() ||
+      graph->HasShouldDeoptimizeFlag()) {
+    return false;
+  }
+  for (HBasicBlock* block : graph->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->HasEnvironment() && instruction->GetEnvironment()->GetParent() != nullptr) {
+        return false;  // Inlined code.
+      }
+      if (instruction->IsInvoke() && instruction->AsInvoke()->IsIntrinsic()) {
+        return false;
+      }
+      if (instruction->IsInvokeStaticOrDirect()) {
+        MethodLoadKind kind = instruction->AsInvokeStaticOrDirect()->GetMethodLoadKind();
+        if (kind != MethodLoadKind::kRecursive &&
+            kind != MethodLoadKind::kRuntimeCall &&
+            kind != MethodLoadKind::kStringInit) {
+          return false;
+        }
+      } else if (instruction->IsInvokeInterface()) {
+        MethodLoadKind kind = instruction->AsInvokeInterface()->GetHiddenArgumentLoadKind();
+        if (kind != MethodLoadKind::kRecursive && kind != MethodLoadKind::kRuntimeCall) {
+          return false;
+        }
+      } else if (instruction->IsLoadClass()) {
+        HLoadClass::LoadKind kind = instruction->AsLoadClass()->GetLoadKind();
+        if (kind != HLoadClass::LoadKind::kReferrersClass &&
+            kind != HLoadClass::LoadKind::kRuntimeCall) {
+          return false;
+        }
+      } else if (instruction->IsLoadString()) {
+        if (instruction->AsLoadString()->GetLoadKind() != HLoadString::LoadKind::kRuntimeCall) {
+          return false;
+        }
+      } else if (instruction->IsLoadMethodType()) {
+        if (instruction->AsLoadMethodType()->GetLoadKind() !=
+                HLoadMethodType::LoadKind::kRuntimeCall) {
+          return false;
+        }
+      } else if (instruction->IsInstanceOf()) {
+        if (instruction->AsInstanceOf()->GetTypeCheckKind() == TypeCheckKind::kBitstringCheck) {
+          return false;
+        }
+      } else if (instruction->IsCheckCast()) {
+        if (instruction->AsCheckCast()->GetTypeCheckKind() == TypeCheckKind::kBitstringCheck) {
+          return false;
+        }
+      } else if (instruction->IsMethodEntryHook() || instruction->IsMethodExitHook()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 bool OptimizingCompiler::JitCompile(Thread* self,
                                     jit::JitCodeCache* code_cache,
                                     jit::JitMemoryRegion* region,
@@ -1282,6 +1382,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
 
   Runtime* runtime = Runtime::Current();
   ArenaAllocator allocator(runtime->GetJitArenaPool());
+  uint64_t start_ns = NanoTime();
 
   if (UNLIKELY(method->IsNative())) {
     // Use GenericJniTrampoline for critical native methods in debuggable runtimes. We don't
@@ -1367,6 +1468,12 @@ bool OptimizingCompiler::JitCompile(Thread* self,
     }
 
     Runtime::Current()->GetJit()->AddMemoryUsage(method, allocator.BytesUsed());
+    Runtime::Current()->GetJit()->AddCompilationTelemetry(method,
+                                                          compilation_kind,
+                                                          NanoTime() - start_ns,
+                                                          allocator.BytesUsed(),
+                                                          /* inlined_methods= */ 0u,
+                                                          jni_compiled_method.GetCode().size());
     if (jit_logger != nullptr) {
       jit_logger->WriteLog(code, jni_compiled_method.GetCode().size(), method);
     }
@@ -1481,10 +1588,25 @@ bool OptimizingCompiler::JitCompile(Thread* self,
   }
 
   Runtime::Current()->GetJit()->AddMemoryUsage(method, allocator.BytesUsed());
+  Runtime::Current()->GetJit()->AddCompilationTelemetry(
+      method,
+      compilation_kind,
+      NanoTime() - start_ns,
+      allocator.BytesUsed() + arena_stack.ApproximatePeakBytes(),
+      codegen->GetGraph()->GetNumberOfInlinedMethods(),
+      codegen->GetAssembler()->CodeSize());
   if (jit_logger != nullptr) {
     jit_logger->WriteLog(code, codegen->GetAssembler()->CodeSize(), method);
   }
 
+  jit::JitPersistentCache* persistent_cache = Runtime::Current()->GetJit()->GetPersistentCache();
+  if (persistent_cache != nullptr &&
+      compilation_kind == CompilationKind::kOptimized &&
+      !code_cache->IsSharedRegion(*region) &&
+      IsProcessIndependentJitCode(codegen.get())) {
+    persistent_cache->Record(method, codegen->GetCode(), ArrayRef<const uint8_t>(stack_map));
+  }
+
   if (kArenaAllocatorCountAllocations) {
     codegen.reset();  // Release codegen's ScopedArenaAllocator for memory accounting.
     size_t total_allocated = allocator.BytesAllocated() + arena_stack.PeakBytesAllocated();
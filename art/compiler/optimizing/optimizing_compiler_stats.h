@@ -37,9 +37,12 @@ enum class MethodCompilationStat {
   kCompiledIntrinsic,
   kCompiledBytecode,
   kCHAInline,
+  kCHAInlineWithTypeGuard,
   kInlinedInvoke,
   kInlinedLastInvoke,
   kReplacedInvokeWithSimplePattern,
+  kInvokeCustomDevirtualized,
+  kMethodHandleInvokeExactDevirtualized,
   kInstructionSimplifications,
   kInstructionSimplificationsArch,
   kUnresolvedMethod,
@@ -71,6 +74,7 @@ enum class MethodCompilationStat {
   kNotCompiledFrameTooBig,
   kInlinedMonomorphicCall,
   kInlinedPolymorphicCall,
+  kInlinedMegamorphicCall,
   kMonomorphicCall,
   kPolymorphicCall,
   kMegamorphicCall,
@@ -136,6 +140,15 @@ enum class MethodCompilationStat {
   kPartialStoreRemoved,
   kPartialAllocationMoved,
   kDevirtualized,
+  kSpillCostRegisterAllocation,
+  kRegisterAllocatorSpillMove,
+  kRegisterAllocatorReloadMove,
+  kInlinedHotCallSite,
+  kInlinedColdCallSite,
+  kLoopInvariantHeapLoadMoved,
+  kRemovedBoundsCheck,
+  kRemovedBoundsCheckWithLoopDeoptimization,
+  kRemovedBoundsCheckWithBlockDeoptimization,
   kLastStat
 };
 std::ostream& operator<<(std::ostream& os, MethodCompilationStat rhs);
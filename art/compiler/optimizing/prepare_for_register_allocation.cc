@@ -83,7 +83,8 @@ void PrepareForRegisterAllocationVisitor::VisitInstanceOf(HInstanceOf* instance_
 
 void PrepareForRegisterAllocationVisitor::VisitNullCheck(HNullCheck* check) {
   check->ReplaceWith(check->InputAt(0));
-  if (compiler_options_.GetImplicitNullChecks()) {
+  // Keep in sync with `CodeGenerator::UseImplicitNullChecks()`.
+  if (compiler_options_.GetImplicitNullChecks() && !GetGraph()->UseExplicitNullChecks()) {
     HInstruction* next = check->GetNext();
 
     // The `PrepareForRegisterAllocation` pass removes `HBoundType` from the graph,
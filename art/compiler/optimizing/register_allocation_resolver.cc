@@ -19,15 +19,18 @@
 #include "base/bit_vector-inl.h"
 #include "code_generator.h"
 #include "linear_order.h"
+#include "optimizing_compiler_stats.h"
 #include "ssa_liveness_analysis.h"
 
 namespace art HIDDEN {
 
 RegisterAllocationResolver::RegisterAllocationResolver(CodeGenerator* codegen,
-                                                       const SsaLivenessAnalysis& liveness)
+                                                       const SsaLivenessAnalysis& liveness,
+                                                       OptimizingCompilerStats* stats)
       : allocator_(codegen->GetGraph()->GetAllocator()),
         codegen_(codegen),
-        liveness_(liveness) {}
+        liveness_(liveness),
+        stats_(stats) {}
 
 void RegisterAllocationResolver::Resolve(ArrayRef<HInstruction* const> safepoints,
                                          size_t reserved_out_slots,
@@ -510,6 +513,18 @@ void RegisterAllocationResolver::AddMove(HParallelMove* move,
                                          Location destination,
                                          HInstruction* instruction,
                                          DataType::Type type) const {
+  if (source.IsStackSlot() || source.IsDoubleStackSlot() || source.IsSIMDStackSlot()) {
+    if (!destination.IsStackSlot() &&
+        !destination.IsDoubleStackSlot() &&
+        !destination.IsSIMDStackSlot()) {
+      MaybeRecordStat(stats_, MethodCompilationStat::kRegisterAllocatorReloadMove);
+    }
+  } else if (!source.IsConstant() &&
+             (destination.IsStackSlot() ||
+              destination.IsDoubleStackSlot() ||
+              destination.IsSIMDStackSlot())) {
+    MaybeRecordStat(stats_, MethodCompilationStat::kRegisterAllocatorSpillMove);
+  }
   if (type == DataType::Type::kInt64
       && codegen_->ShouldSplitLongMoves()
       // The parallel move resolver knows how to deal with long constants.
@@ -43,8 +43,10 @@ static bool IsLowOfUnalignedPairInterval(LiveInterval* low) {
 
 RegisterAllocatorLinearScan::RegisterAllocatorLinearScan(ScopedArenaAllocator* allocator,
                                                          CodeGenerator* codegen,
-                                                         const SsaLivenessAnalysis& liveness)
-      : RegisterAllocator(allocator, codegen, liveness),
+                                                         const SsaLivenessAnalysis& liveness,
+                                                         bool use_spill_costs,
+                                                         OptimizingCompilerStats* stats)
+      : RegisterAllocator(allocator, codegen, liveness, stats),
         unhandled_core_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         unhandled_fp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         unhandled_(nullptr),
@@ -69,7 +71,8 @@ RegisterAllocatorLinearScan::RegisterAllocatorLinearScan(ScopedArenaAllocator* a
         registers_array_(nullptr),
         blocked_core_registers_(codegen->GetBlockedCoreRegisters()),
         blocked_fp_registers_(codegen->GetBlockedFloatingPointRegisters()),
-        reserved_out_slots_(0) {
+        reserved_out_slots_(0),
+        use_spill_costs_(use_spill_costs) {
   temp_intervals_.reserve(4);
   int_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
   long_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
@@ -85,7 +88,7 @@ RegisterAllocatorLinearScan::~RegisterAllocatorLinearScan() {}
 
 void RegisterAllocatorLinearScan::AllocateRegisters() {
   AllocateRegistersInternal();
-  RegisterAllocationResolver(codegen_, liveness_)
+  RegisterAllocationResolver(codegen_, liveness_, stats_)
       .Resolve(ArrayRef<HInstruction* const>(safepoints_),
                reserved_out_slots_,
                int_spill_slots_.size(),
@@ -929,6 +932,75 @@ int RegisterAllocatorLinearScan::FindAvailableRegister(size_t* next_use, LiveInt
   return reg;
 }
 
+size_t RegisterAllocatorLinearScan::ComputeSpillCost(LiveInterval* interval,
+                                                     size_t position) const {
+  // Weight of a use per level of loop nesting, and the maximum nesting accounted for.
+  static constexpr size_t kLoopWeightShift = 3u;
+  static constexpr size_t kMaxLoopDepth = 4u;
+  size_t cost = 0u;
+  size_t end = interval->GetEnd();
+  for (const UsePosition& use : interval->GetUses()) {
+    size_t use_position = use.GetPosition();
+    if (use_position > end) {
+      break;
+    }
+    if (use_position <= position || !use.RequiresRegister()) {
+      continue;
+    }
+    size_t depth = 0u;
+    if (!use.IsSynthesized()) {
+      for (HLoopInformationOutwardIterator it(*use.GetUser()->GetBlock());
+           !it.Done() && depth != kMaxLoopDepth;
+           it.Advance()) {
+        ++depth;
+      }
+    }
+    cost += static_cast<size_t>(1u) << (depth * kLoopWeightShift);
+  }
+  return cost;
+}
+
+int RegisterAllocatorLinearScan::FindRegisterWithLowestSpillCost(size_t* next_use,
+                                                                 LiveInterval* current,
+                                                                 size_t first_register_use) const {
+  size_t position = current->GetStart();
+  int reg = kNoRegister;
+  size_t reg_cost = 0u;
+  for (size_t i = 0; i < number_of_registers_; ++i) {
+    if (IsBlocked(i) || next_use[i] <= first_register_use) {
+      // The register cannot be given to `current`.
+      continue;
+    }
+    if (next_use[i] == kMaxLifetimePosition) {
+      // A register is free: nothing to spill.
+      return kNoRegister;
+    }
+    size_t cost = 0u;
+    for (LiveInterval* active : active_) {
+      if (!active->IsFixed() && active->GetRegister() == static_cast<int>(i)) {
+        cost += ComputeSpillCost(active, position);
+      }
+    }
+    if (current->IsSplit()) {
+      // Only split intervals can intersect non-fixed inactive intervals, see AllocateBlockedReg.
+      for (LiveInterval* inactive : inactive_) {
+        if (!inactive->IsFixed() &&
+            inactive->GetRegister() == static_cast<int>(i) &&
+            inactive->FirstIntersectionWith(current) != kNoLifetime) {
+          cost += ComputeSpillCost(inactive, position);
+        }
+      }
+    }
+    if (reg == kNoRegister ||
+        cost < reg_cost ||
+        (cost == reg_cost && next_use[i] > next_use[reg])) {
+      reg = i;
+      reg_cost = cost;
+    }
+  }
+  return reg;
+}
+
 // Remove interval and its other half if any. Return iterator to the following element.
 static ArenaVector<LiveInterval*>::iterator RemoveIntervalAndPotentialOtherHalf(
     ScopedArenaVector<LiveInterval*>* intervals, ScopedArenaVector<LiveInterval*>::iterator pos) {
@@ -1065,7 +1137,12 @@ bool RegisterAllocatorLinearScan::AllocateBlockedReg(LiveInterval* current) {
       || (first_register_use >= next_use[GetHighForLowRegister(reg)]);
   } else {
     DCHECK(!current->IsHighInterval());
-    reg = FindAvailableRegister(next_use, current);
+    if (use_spill_costs_) {
+      reg = FindRegisterWithLowestSpillCost(next_use, current, first_register_use);
+    }
+    if (reg == kNoRegister) {
+      reg = FindAvailableRegister(next_use, current);
+    }
     should_spill = (first_register_use >= next_use[reg]);
   }
 
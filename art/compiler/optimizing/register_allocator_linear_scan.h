@@ -41,7 +41,9 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
  public:
   RegisterAllocatorLinearScan(ScopedArenaAllocator* allocator,
                               CodeGenerator* codegen,
-                              const SsaLivenessAnalysis& analysis);
+                              const SsaLivenessAnalysis& analysis,
+                              bool use_spill_costs = false,
+                              OptimizingCompilerStats* stats = nullptr);
   ~RegisterAllocatorLinearScan() override;
 
   void AllocateRegisters() override;
@@ -95,6 +97,17 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
   void DumpAllIntervals(std::ostream& stream) const;
   int FindAvailableRegisterPair(size_t* next_use, size_t starting_at) const;
   int FindAvailableRegister(size_t* next_use, LiveInterval* current) const;
+
+  // Return the register which is cheapest to take away from the intervals holding it for
+  // `current`, among the ones not used before `first_register_use`. Return kNoRegister if
+  // there is none, or if a register is free, leaving the choice to FindAvailableRegister.
+  int FindRegisterWithLowestSpillCost(size_t* next_use,
+                                      LiveInterval* current,
+                                      size_t first_register_use) const;
+
+  // Return the cost of the register uses of `interval` after `position`, each use weighing
+  // more the deeper it is in loops.
+  size_t ComputeSpillCost(LiveInterval* interval, size_t position) const;
   bool IsCallerSaveRegister(int reg) const;
 
   // If any inputs require specific registers, block those registers
@@ -193,6 +206,10 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
   // Slots reserved for out arguments.
   size_t reserved_out_slots_;
 
+  // Whether to evict the blocking interval with the lowest spill cost, see
+  // `RegisterAllocator::kRegisterAllocatorSpillCost`.
+  const bool use_spill_costs_;
+
   ART_FRIEND_TEST(RegisterAllocatorTest, FreeUntil);
   ART_FRIEND_TEST(RegisterAllocatorTest, SpillInactive);
 
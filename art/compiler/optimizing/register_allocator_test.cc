@@ -46,7 +46,8 @@ class RegisterAllocatorTest : public CommonCompilerTest, public OptimizingUnitTe
   }
 
   // Helper functions that make use of the OptimizingUnitTest's members.
-  bool Check(const std::vector<uint16_t>& data);
+  bool Check(const std::vector<uint16_t>& data,
+             RegisterAllocator::Strategy strategy = RegisterAllocator::kRegisterAllocatorDefault);
   HGraph* BuildIfElseWithPhi(HPhi** phi, HInstruction** input1, HInstruction** input2);
   HGraph* BuildFieldReturn(HInstruction** field, HInstruction** ret);
   HGraph* BuildTwoSubs(HInstruction** first_sub, HInstruction** second_sub);
@@ -66,13 +67,14 @@ class RegisterAllocatorTest : public CommonCompilerTest, public OptimizingUnitTe
   std::unique_ptr<CompilerOptions> compiler_options_;
 };
 
-bool RegisterAllocatorTest::Check(const std::vector<uint16_t>& data) {
+bool RegisterAllocatorTest::Check(const std::vector<uint16_t>& data,
+                                  RegisterAllocator::Strategy strategy) {
   HGraph* graph = CreateCFG(data);
   x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
   SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
   liveness.Analyze();
   std::unique_ptr<RegisterAllocator> register_allocator =
-      RegisterAllocator::Create(GetScopedAllocator(), &codegen, liveness);
+      RegisterAllocator::Create(GetScopedAllocator(), &codegen, liveness, strategy);
   register_allocator->AllocateRegisters();
   return register_allocator->Validate(false);
 }
@@ -212,6 +214,7 @@ TEST_F(RegisterAllocatorTest, Loop1) {
     Instruction::RETURN | 1 << 8);
 
   ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(Check(data, RegisterAllocator::kRegisterAllocatorSpillCost));
 }
 
 TEST_F(RegisterAllocatorTest, Loop2) {
@@ -261,6 +264,7 @@ TEST_F(RegisterAllocatorTest, Loop2) {
     Instruction::RETURN | 1 << 8);
 
   ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(Check(data, RegisterAllocator::kRegisterAllocatorSpillCost));
 }
 
 TEST_F(RegisterAllocatorTest, Loop3) {
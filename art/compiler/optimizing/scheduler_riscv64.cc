@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scheduler_riscv64.h"
+
+#include "code_generator_utils.h"
+
+namespace art HIDDEN {
+namespace riscv64 {
+
+// RISC-V instruction latency.
+// These model a simple in-order core, which cannot hide the latencies itself, so the values are
+// closer to the cycle counts seen by a dependent instruction than on the other architectures.
+static constexpr uint32_t kRiscv64MemoryLoadLatency = 3;
+static constexpr uint32_t kRiscv64MemoryStoreLatency = 1;
+
+static constexpr uint32_t kRiscv64CallInternalLatency = 10;
+static constexpr uint32_t kRiscv64CallLatency = 5;
+
+static constexpr uint32_t kRiscv64IntegerOpLatency = 1;
+static constexpr uint32_t kRiscv64FloatingPointOpLatency = 5;
+
+static constexpr uint32_t kRiscv64DivDoubleLatency = 33;
+static constexpr uint32_t kRiscv64DivFloatLatency = 20;
+static constexpr uint32_t kRiscv64DivIntegerLatency = 20;
+static constexpr uint32_t kRiscv64DivLongLatency = 35;
+static constexpr uint32_t kRiscv64LoadStringInternalLatency = 5;
+static constexpr uint32_t kRiscv64MulFloatingPointLatency = 5;
+static constexpr uint32_t kRiscv64MulIntegerLatency = 3;
+static constexpr uint32_t kRiscv64TypeConversionFloatingPointIntegerLatency = 4;
+
+class SchedulingLatencyVisitorRISCV64 final : public SchedulingLatencyVisitor {
+ public:
+  // Default visitor for instructions not handled specifically below.
+  void VisitInstruction([[maybe_unused]] HInstruction*) override {
+    last_visited_latency_ = kRiscv64IntegerOpLatency;
+  }
+
+// We add a second unused parameter to be able to use this macro like the others
+// defined in `nodes.h`.
+#define FOR_EACH_SCHEDULED_COMMON_INSTRUCTION(M)     \
+  M(ArrayGet             , unused)                   \
+  M(ArrayLength          , unused)                   \
+  M(ArraySet             , unused)                   \
+  M(BoundsCheck          , unused)                   \
+  M(Div                  , unused)                   \
+  M(InstanceFieldGet     , unused)                   \
+  M(InstanceOf           , unused)                   \
+  M(LoadString           , unused)                   \
+  M(Mul                  , unused)                   \
+  M(NewArray             , unused)                   \
+  M(NewInstance          , unused)                   \
+  M(Rem                  , unused)                   \
+  M(StaticFieldGet       , unused)                   \
+  M(SuspendCheck         , unused)                   \
+  M(TypeConversion       , unused)
+
+#define FOR_EACH_SCHEDULED_ABSTRACT_INSTRUCTION(M)   \
+  M(BinaryOperation      , unused)                   \
+  M(Invoke               , unused)
+
+#define DECLARE_VISIT_INSTRUCTION(type, unused)  \
+  void Visit##type(H##type* instruction) override;
+
+  FOR_EACH_SCHEDULED_COMMON_INSTRUCTION(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_SCHEDULED_ABSTRACT_INSTRUCTION(DECLARE_VISIT_INSTRUCTION)
+
+#undef DECLARE_VISIT_INSTRUCTION
+
+ private:
+  // Set the latencies of an integer division or remainder, following the code generator.
+  void HandleIntegerDivRem(HBinaryOperation* instruction, bool is_div);
+  // RISC-V has no scaled index addressing mode: take the address computation into account.
+  void HandleArrayAddress(HInstruction* instruction);
+};
+
+void SchedulingLatencyVisitorRISCV64::HandleArrayAddress(HInstruction* instruction) {
+  if (!instruction->InputAt(1)->IsConstant()) {
+    last_visited_internal_latency_ = kRiscv64IntegerOpLatency;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitBinaryOperation(HBinaryOperation* instr) {
+  last_visited_latency_ = DataType::IsFloatingPointType(instr->GetResultType())
+      ? kRiscv64FloatingPointOpLatency
+      : kRiscv64IntegerOpLatency;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitArrayGet(HArrayGet* instruction) {
+  HandleArrayAddress(instruction);
+  last_visited_latency_ = kRiscv64MemoryLoadLatency;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitArrayLength([[maybe_unused]] HArrayLength*) {
+  last_visited_latency_ = kRiscv64MemoryLoadLatency;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitArraySet(HArraySet* instruction) {
+  HandleArrayAddress(instruction);
+  last_visited_latency_ = kRiscv64MemoryStoreLatency;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitBoundsCheck([[maybe_unused]] HBoundsCheck*) {
+  last_visited_internal_latency_ = kRiscv64IntegerOpLatency;
+  // Users do not use any data results.
+  last_visited_latency_ = 0;
+}
+
+void SchedulingLatencyVisitorRISCV64::HandleIntegerDivRem(HBinaryOperation* instruction,
+                                                         bool is_div) {
+  // Follow the code path used by code generation.
+  if (instruction->GetRight()->IsConstant()) {
+    int64_t imm = Int64FromConstant(instruction->GetRight()->AsConstant());
+    if (imm == 0) {
+      last_visited_internal_latency_ = 0;
+      last_visited_latency_ = 0;
+    } else if (imm == 1 || imm == -1) {
+      last_visited_internal_latency_ = 0;
+      last_visited_latency_ = kRiscv64IntegerOpLatency;
+    } else if (IsPowerOfTwo(AbsOrMin(imm))) {
+      last_visited_internal_latency_ = 3 * kRiscv64IntegerOpLatency;
+      last_visited_latency_ = kRiscv64IntegerOpLatency;
+    } else {
+      DCHECK(imm <= -2 || imm >= 2);
+      // High multiplication by a magic number, then shifts and, for the remainder, a
+      // multiplication.
+      last_visited_internal_latency_ = kRiscv64MulIntegerLatency + 3 * kRiscv64IntegerOpLatency;
+      last_visited_latency_ = is_div ? kRiscv64IntegerOpLatency : kRiscv64MulIntegerLatency;
+    }
+  } else {
+    last_visited_latency_ = (instruction->GetResultType() == DataType::Type::kInt64)
+        ? kRiscv64DivLongLatency
+        : kRiscv64DivIntegerLatency;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitDiv(HDiv* instr) {
+  DataType::Type type = instr->GetResultType();
+  switch (type) {
+    case DataType::Type::kFloat32:
+      last_visited_latency_ = kRiscv64DivFloatLatency;
+      break;
+    case DataType::Type::kFloat64:
+      last_visited_latency_ = kRiscv64DivDoubleLatency;
+      break;
+    default:
+      HandleIntegerDivRem(instr, /*is_div=*/ true);
+      break;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitInstanceFieldGet([[maybe_unused]] HInstanceFieldGet*) {
+  last_visited_latency_ = kRiscv64MemoryLoadLatency;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitInstanceOf([[maybe_unused]] HInstanceOf*) {
+  last_visited_internal_latency_ = kRiscv64CallInternalLatency;
+  last_visited_latency_ = kRiscv64IntegerOpLatency;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitInvoke([[maybe_unused]] HInvoke*) {
+  last_visited_internal_latency_ = kRiscv64CallInternalLatency;
+  last_visited_latency_ = kRiscv64CallLatency;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitLoadString([[maybe_unused]] HLoadString*) {
+  last_visited_internal_latency_ = kRiscv64LoadStringInternalLatency;
+  last_visited_latency_ = kRiscv64MemoryLoadLatency;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitMul(HMul* instr) {
+  last_visited_latency_ = DataType::IsFloatingPointType(instr->GetResultType())
+      ? kRiscv64MulFloatingPointLatency
+      : kRiscv64MulIntegerLatency;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitNewArray([[maybe_unused]] HNewArray*) {
+  last_visited_internal_latency_ = kRiscv64IntegerOpLatency + kRiscv64CallInternalLatency;
+  last_visited_latency_ = kRiscv64CallLatency;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitNewInstance([[maybe_unused]] HNewInstance*) {
+  last_visited_internal_latency_ = kRiscv64CallInternalLatency;
+  last_visited_latency_ = kRiscv64CallLatency;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitRem(HRem* instruction) {
+  if (DataType::IsFloatingPointType(instruction->GetResultType())) {
+    // Floating-point remainders call `fmod()`.
+    last_visited_internal_latency_ = kRiscv64CallInternalLatency;
+    last_visited_latency_ = kRiscv64CallLatency;
+  } else {
+    HandleIntegerDivRem(instruction, /*is_div=*/ false);
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitStaticFieldGet([[maybe_unused]] HStaticFieldGet*) {
+  last_visited_latency_ = kRiscv64MemoryLoadLatency;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitSuspendCheck(HSuspendCheck* instruction) {
+  HBasicBlock* block = instruction->GetBlock();
+  DCHECK_IMPLIES(block->GetLoopInformation() == nullptr,
+                 block->IsEntryBlock() && instruction->GetNext()->IsGoto());
+  // Users do not use any data results.
+  last_visited_latency_ = 0;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitTypeConversion(HTypeConversion* instr) {
+  if (DataType::IsFloatingPointType(instr->GetResultType()) ||
+      DataType::IsFloatingPointType(instr->GetInputType())) {
+    last_visited_latency_ = kRiscv64TypeConversionFloatingPointIntegerLatency;
+  } else {
+    last_visited_latency_ = kRiscv64IntegerOpLatency;
+  }
+}
+
+bool HSchedulerRISCV64::IsSchedulable(const HInstruction* instruction) const {
+  switch (instruction->GetKind()) {
+#define SCHEDULABLE_CASE(type, unused)       \
+    case HInstruction::InstructionKind::k##type:  \
+      return true;
+    FOR_EACH_CONCRETE_INSTRUCTION_RISCV64(SCHEDULABLE_CASE)
+    FOR_EACH_SCHEDULED_COMMON_INSTRUCTION(SCHEDULABLE_CASE)
+#undef SCHEDULABLE_CASE
+
+    default:
+      return HScheduler::IsSchedulable(instruction);
+  }
+}
+
+std::pair<SchedulingGraph, ScopedArenaVector<SchedulingNode*>>
+HSchedulerRISCV64::BuildSchedulingGraph(
+    HBasicBlock* block,
+    ScopedArenaAllocator* allocator,
+    const HeapLocationCollector* heap_location_collector) {
+  SchedulingLatencyVisitorRISCV64 latency_visitor;
+  return HScheduler::BuildSchedulingGraph(
+      block, allocator, heap_location_collector, &latency_visitor);
+}
+
+}  // namespace riscv64
+}  // namespace art
@@ -16,6 +16,8 @@
 
 #include "select_generator.h"
 
+#include <algorithm>
+
 #include "optimizing/nodes.h"
 #include "reference_type_propagation.h"
 
@@ -23,6 +25,10 @@ namespace art HIDDEN {
 
 static constexpr size_t kMaxInstructionsInBranch = 1u;
 
+// The maximum number of phis in the merge block of a diamond turned into selects. Each phi
+// allows one more instruction in each branch, as it may use one instruction of each branch.
+static constexpr size_t kMaxPhisInDiamond = 4u;
+
 HSelectGenerator::HSelectGenerator(HGraph* graph,
                                    OptimizingCompilerStats* stats,
                                    const char* name)
@@ -30,15 +36,16 @@ HSelectGenerator::HSelectGenerator(HGraph* graph,
 }
 
 // Returns true if `block` has only one predecessor, ends with a Goto
-// or a Return and contains at most `kMaxInstructionsInBranch` other
-// movable instruction with no side-effects.
-static bool IsSimpleBlock(HBasicBlock* block) {
+// or a Return and contains at most `kMaxPhisInDiamond` other
+// movable instruction with no side-effects, whose number is stored
+// in `num_instructions`.
+static bool IsSimpleBlock(HBasicBlock* block, /*out*/ size_t* num_instructions) {
   if (block->GetPredecessors().size() != 1u) {
     return false;
   }
   DCHECK(block->GetPhis().IsEmpty());
 
-  size_t num_instructions = 0u;
+  *num_instructions = 0u;
   for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
     HInstruction* instruction = it.Current();
     if (instruction->IsControlFlow()) {
@@ -50,7 +57,7 @@ static bool IsSimpleBlock(HBasicBlock* block) {
         // Count one HCondition and HSelect in the same block as a single instruction.
         // This enables finding nested selects.
         continue;
-      } else if (++num_instructions > kMaxInstructionsInBranch) {
+      } else if (++(*num_instructions) > kMaxPhisInDiamond) {
         return false;  // bail as soon as we exceed number of allowed instructions
       }
     } else {
@@ -68,25 +75,6 @@ static bool BlocksMergeTogether(HBasicBlock* block1, HBasicBlock* block2) {
   return block1->GetSingleSuccessor() == block2->GetSingleSuccessor();
 }
 
-// Returns nullptr if `block` has either no phis or there is more than one phi. Otherwise returns
-// that phi.
-static HPhi* GetSinglePhi(HBasicBlock* block, size_t index1, size_t index2) {
-  DCHECK_NE(index1, index2);
-
-  HPhi* select_phi = nullptr;
-  for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
-    HPhi* phi = it.Current()->AsPhi();
-    if (select_phi == nullptr) {
-      // First phi found.
-      select_phi = phi;
-    } else {
-      // More than one phi found, return null.
-      return nullptr;
-    }
-  }
-  return select_phi;
-}
-
 bool HSelectGenerator::TryGenerateSelectSimpleDiamondPattern(
     HBasicBlock* block, ScopedArenaSafeMap<HInstruction*, HSelect*>* cache) {
   DCHECK(block->GetLastInstruction()->IsIf());
@@ -95,13 +83,25 @@ bool HSelectGenerator::TryGenerateSelectSimpleDiamondPattern(
   HBasicBlock* false_block = if_instruction->IfFalseSuccessor();
   DCHECK_NE(true_block, false_block);
 
-  if (!IsSimpleBlock(true_block) ||
-      !IsSimpleBlock(false_block) ||
+  size_t num_true_instructions = 0u;
+  size_t num_false_instructions = 0u;
+  if (!IsSimpleBlock(true_block, &num_true_instructions) ||
+      !IsSimpleBlock(false_block, &num_false_instructions) ||
       !BlocksMergeTogether(true_block, false_block)) {
     return false;
   }
   HBasicBlock* merge_block = true_block->GetSingleSuccessor();
 
+  bool both_successors_return = true_block->IsSingleReturn() && false_block->IsSingleReturn();
+  size_t num_phis = both_successors_return ? 0u : merge_block->GetPhis().CountSize();
+  if ((!both_successors_return && num_phis == 0u) || num_phis > kMaxPhisInDiamond) {
+    return false;
+  }
+  size_t max_instructions = std::max(kMaxInstructionsInBranch, num_phis);
+  if (num_true_instructions > max_instructions || num_false_instructions > max_instructions) {
+    return false;
+  }
+
   // If the branches are not empty, move instructions in front of the If.
   // TODO(dbrazdil): This puts an instruction between If and its condition.
   //                 Implement moving of conditions to first users if possible.
@@ -123,8 +123,7 @@ bool HSelectGenerator::TryGenerateSelectSimpleDiamondPattern(
   size_t predecessor_index_false = merge_block->GetPredecessorIndexOf(false_block);
   DCHECK_NE(predecessor_index_true, predecessor_index_false);
 
-  bool both_successors_return = true_block->IsSingleReturn() && false_block->IsSingleReturn();
-  // TODO(solanes): Extend to support multiple phis? e.g.
+  // Create the Select instructions and insert them in front of the If. With multiple phis, e.g.
   //   int a, b;
   //   if (bool) {
   //     a = 0; b = 1;
@@ -132,46 +131,50 @@ bool HSelectGenerator::TryGenerateSelectSimpleDiamondPattern(
   //     a = 1; b = 2;
   //   }
   //   // use a and b
-  HPhi* phi = GetSinglePhi(merge_block, predecessor_index_true, predecessor_index_false);
-
-  HInstruction* true_value = nullptr;
-  HInstruction* false_value = nullptr;
-  if (both_successors_return) {
-    true_value = true_block->GetFirstInstruction()->InputAt(0);
-    false_value = false_block->GetFirstInstruction()->InputAt(0);
-  } else if (phi != nullptr) {
-    true_value = phi->InputAt(predecessor_index_true);
-    false_value = phi->InputAt(predecessor_index_false);
-  } else {
-    return false;
-  }
-  DCHECK(both_successors_return || phi != nullptr);
-
-  // Create the Select instruction and insert it in front of the If.
+  // each phi gets its own Select of the same condition.
   HInstruction* condition = if_instruction->InputAt(0);
-  HSelect* select = new (graph_->GetAllocator()) HSelect(condition,
-                                                          true_value,
-                                                          false_value,
-                                                          if_instruction->GetDexPc());
+  // The selects created for the diamond, at most one per phi.
+  HSelect* selects[kMaxPhisInDiamond] = {};
+  size_t num_selects = 0u;
   if (both_successors_return) {
+    HInstruction* true_value = true_block->GetFirstInstruction()->InputAt(0);
+    HInstruction* false_value = false_block->GetFirstInstruction()->InputAt(0);
+    HSelect* select = new (graph_->GetAllocator()) HSelect(condition,
+                                                            true_value,
+                                                            false_value,
+                                                            if_instruction->GetDexPc());
     if (true_value->GetType() == DataType::Type::kReference) {
       DCHECK(false_value->GetType() == DataType::Type::kReference);
       ReferenceTypePropagation::FixUpSelectType(select, graph_->GetHandleCache());
     }
-  } else if (phi->GetType() == DataType::Type::kReference) {
-    select->SetReferenceTypeInfoIfValid(phi->GetReferenceTypeInfo());
-  }
-  block->InsertInstructionBefore(select, if_instruction);
-
-  // Remove the true branch which removes the corresponding Phi
-  // input if needed. If left only with the false branch, the Phi is
-  // automatically removed.
-  if (both_successors_return) {
+    block->InsertInstructionBefore(select, if_instruction);
     false_block->GetFirstInstruction()->ReplaceInput(select, 0);
+    selects[num_selects++] = select;
   } else {
-    phi->ReplaceInput(select, predecessor_index_false);
+    for (HInstructionIterator it(merge_block->GetPhis()); !it.Done(); it.Advance()) {
+      HPhi* phi = it.Current()->AsPhi();
+      HInstruction* true_value = phi->InputAt(predecessor_index_true);
+      HInstruction* false_value = phi->InputAt(predecessor_index_false);
+      if (true_value == false_value) {
+        // The phi keeps the same value from both branches, no need for a Select.
+        continue;
+      }
+      HSelect* select = new (graph_->GetAllocator()) HSelect(condition,
+                                                              true_value,
+                                                              false_value,
+                                                              if_instruction->GetDexPc());
+      if (phi->GetType() == DataType::Type::kReference) {
+        select->SetReferenceTypeInfoIfValid(phi->GetReferenceTypeInfo());
+      }
+      block->InsertInstructionBefore(select, if_instruction);
+      phi->ReplaceInput(select, predecessor_index_false);
+      selects[num_selects++] = select;
+    }
   }
 
+  // Remove the true branch which removes the corresponding Phi
+  // inputs if needed. If left only with the false branch, the Phis are
+  // automatically removed.
   bool only_two_predecessors = (merge_block->GetPredecessors().size() == 2u);
   true_block->DisconnectAndDelete();
 
@@ -179,31 +182,34 @@ bool HSelectGenerator::TryGenerateSelectSimpleDiamondPattern(
   DCHECK_EQ(block->GetSingleSuccessor(), false_block);
   block->MergeWith(false_block);
   if (!both_successors_return && only_two_predecessors) {
-    DCHECK_EQ(only_two_predecessors, phi->GetBlock() == nullptr);
+    DCHECK(merge_block->GetPhis().IsEmpty());
     DCHECK_EQ(block->GetSingleSuccessor(), merge_block);
     block->MergeWith(merge_block);
   }
 
-  MaybeRecordStat(stats_, MethodCompilationStat::kSelectGenerated);
-
-  // Very simple way of finding common subexpressions in the generated HSelect statements
-  // (since this runs after GVN). Lookup by condition, and reuse latest one if possible
-  // (due to post order, latest select is most likely replacement). If needed, we could
-  // improve this by e.g. using the operands in the map as well.
-  auto it = cache->find(condition);
-  if (it == cache->end()) {
-    cache->Put(condition, select);
-  } else {
-    // Found cached value. See if latest can replace cached in the HIR.
-    HSelect* cached_select = it->second;
-    DCHECK_EQ(cached_select->GetCondition(), select->GetCondition());
-    if (cached_select->GetTrueValue() == select->GetTrueValue() &&
-        cached_select->GetFalseValue() == select->GetFalseValue() &&
-        select->StrictlyDominates(cached_select)) {
-      cached_select->ReplaceWith(select);
-      cached_select->GetBlock()->RemoveInstruction(cached_select);
+  for (size_t i = 0; i != num_selects; ++i) {
+    HSelect* select = selects[i];
+    MaybeRecordStat(stats_, MethodCompilationStat::kSelectGenerated);
+
+    // Very simple way of finding common subexpressions in the generated HSelect statements
+    // (since this runs after GVN). Lookup by condition, and reuse latest one if possible
+    // (due to post order, latest select is most likely replacement). If needed, we could
+    // improve this by e.g. using the operands in the map as well.
+    auto it = cache->find(condition);
+    if (it == cache->end()) {
+      cache->Put(condition, select);
+    } else {
+      // Found cached value. See if latest can replace cached in the HIR.
+      HSelect* cached_select = it->second;
+      DCHECK_EQ(cached_select->GetCondition(), select->GetCondition());
+      if (cached_select->GetTrueValue() == select->GetTrueValue() &&
+          cached_select->GetFalseValue() == select->GetFalseValue() &&
+          select->StrictlyDominates(cached_select)) {
+        cached_select->ReplaceWith(select);
+        cached_select->GetBlock()->RemoveInstruction(cached_select);
+      }
+      it->second = select;  // always cache latest
     }
-    it->second = select;  // always cache latest
   }
 
   // No need to update dominance information, as we are simplifying
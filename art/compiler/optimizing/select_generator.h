@@ -34,7 +34,9 @@
  *     return FalseValue   return TrueValue
  *
  * The pattern will be simplified if `true_branch` and `false_branch` each
- * contain at most one instruction without any side effects.
+ * contain at most one instruction without any side effects, or one per Phi
+ * when the merge block has multiple Phis. Each of these Phis is replaced by
+ * its own Select of the condition.
  *
  * Blocks are merged into one and Select replaces the If and the Phi.
  *
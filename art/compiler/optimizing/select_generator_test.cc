@@ -71,4 +71,30 @@ TEST_F(SelectGeneratorTest, testAdd) {
   EXPECT_TRUE(phi->GetBlock() == nullptr);
 }
 
+// Test that SelectGenerator generates a select for each phi of the diamond.
+TEST_F(SelectGeneratorTest, testMultiplePhis) {
+  HBasicBlock* return_block = InitEntryMainExitGraphWithReturnVoid();
+  HParameterValue* param = MakeParam(DataType::Type::kInt32);
+  HAdd* instr1 = new (GetAllocator()) HAdd(DataType::Type::kInt32, param, param, /*dex_pc=*/ 0);
+  HPhi* phi1 = ConstructBasicGraphForSelect(return_block, instr1);
+  HSub* instr2 = new (GetAllocator()) HSub(DataType::Type::kInt32, param, param, /*dex_pc=*/ 0);
+  AddOrInsertInstruction(instr1->GetBlock(), instr2);
+  HPhi* phi2 = MakePhi(return_block, {instr2, graph_->GetIntConstant(2)});
+  EXPECT_TRUE(CheckGraphAndTrySelectGenerator());
+  EXPECT_TRUE(phi1->GetBlock() == nullptr);
+  EXPECT_TRUE(phi2->GetBlock() == nullptr);
+}
+
+// Test that SelectGenerator does not hoist more instructions than there are phis.
+TEST_F(SelectGeneratorTest, testTooManyInstructions) {
+  HBasicBlock* return_block = InitEntryMainExitGraphWithReturnVoid();
+  HParameterValue* param = MakeParam(DataType::Type::kInt32);
+  HAdd* instr1 = new (GetAllocator()) HAdd(DataType::Type::kInt32, param, param, /*dex_pc=*/ 0);
+  HAdd* instr2 = new (GetAllocator()) HAdd(DataType::Type::kInt32, param, param, /*dex_pc=*/ 0);
+  HPhi* phi = ConstructBasicGraphForSelect(return_block, instr1);
+  AddOrInsertInstruction(instr1->GetBlock(), instr2);
+  EXPECT_FALSE(CheckGraphAndTrySelectGenerator());
+  EXPECT_FALSE(phi->GetBlock() == nullptr);
+}
+
 }  // namespace art
@@ -374,10 +374,37 @@ void StackMapStream::CreateDexRegisterMap() {
   }
 }
 
+// Sort the register masks and the dex register catalogue, which are referenced only by index
+// and are the same for many methods, and update the references to them. Tables which contain
+// the same rows then encode to identical bits and can be shared across methods by the linker.
+void StackMapStream::CanonicalizeBitTables() {
+  ScopedArenaVector<uint32_t> old_to_new(allocator_->Adapter(kArenaAllocStackMapStream));
+  if (register_masks_.size() > 1u) {
+    register_masks_.SortRows(&old_to_new);
+    for (size_t i = 0; i < stack_maps_.size(); i++) {
+      uint32_t& index = stack_maps_[i][StackMap::kRegisterMaskIndex];
+      if (index != kNoValue) {
+        index = old_to_new[index];
+      }
+    }
+  }
+  if (dex_register_catalog_.size() > 1u) {
+    dex_register_catalog_.SortRows(&old_to_new);
+    for (size_t i = 0; i < dex_register_maps_.size(); i++) {
+      uint32_t& index = dex_register_maps_[i][DexRegisterMapInfo::kCatalogueIndex];
+      if (index != kNoValue) {
+        index = old_to_new[index];
+      }
+    }
+  }
+}
+
 ScopedArenaVector<uint8_t> StackMapStream::Encode() {
   DCHECK(in_stack_map_ == false) << "Mismatched Begin/End calls";
   DCHECK(in_inline_info_ == false) << "Mismatched Begin/End calls";
 
+  CanonicalizeBitTables();
+
   uint32_t flags = 0;
   flags |= (inline_infos_.size() > 0) ? CodeInfo::kHasInlineInfo : 0;
   flags |= baseline_ ? CodeInfo::kIsBaseline : 0;
@@ -107,6 +107,7 @@ class StackMapStream : public DeletableArenaObject<kArenaAllocStackMapStream> {
   static constexpr uint32_t kNoValue = -1;
 
   void CreateDexRegisterMap();
+  void CanonicalizeBitTables();
 
   // Invokes the callback with pointer of each BitTableBuilder field.
   template<typename Callback>
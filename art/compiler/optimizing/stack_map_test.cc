@@ -229,8 +229,8 @@ TEST(StackMapTest, Test2) {
     ASSERT_EQ(18, dex_register_map[0].GetMachineRegister());
     ASSERT_EQ(3, dex_register_map[1].GetMachineRegister());
 
-    DexRegisterLocation location0 = code_info.GetDexRegisterCatalogEntry(2);
-    DexRegisterLocation location1 = code_info.GetDexRegisterCatalogEntry(3);
+    DexRegisterLocation location0 = code_info.GetDexRegisterCatalogEntry(3);
+    DexRegisterLocation location1 = code_info.GetDexRegisterCatalogEntry(5);
     ASSERT_EQ(Kind::kInRegister, location0.GetKind());
     ASSERT_EQ(Kind::kInFpuRegister, location1.GetKind());
     ASSERT_EQ(18, location0.GetValue());
@@ -262,8 +262,8 @@ TEST(StackMapTest, Test2) {
     ASSERT_EQ(6, dex_register_map[0].GetMachineRegister());
     ASSERT_EQ(8, dex_register_map[1].GetMachineRegister());
 
-    DexRegisterLocation location0 = code_info.GetDexRegisterCatalogEntry(4);
-    DexRegisterLocation location1 = code_info.GetDexRegisterCatalogEntry(5);
+    DexRegisterLocation location0 = code_info.GetDexRegisterCatalogEntry(2);
+    DexRegisterLocation location1 = code_info.GetDexRegisterCatalogEntry(4);
     ASSERT_EQ(Kind::kInRegister, location0.GetKind());
     ASSERT_EQ(Kind::kInRegisterHigh, location1.GetKind());
     ASSERT_EQ(6, location0.GetValue());
@@ -295,7 +295,7 @@ TEST(StackMapTest, Test2) {
     ASSERT_EQ(3, dex_register_map[0].GetMachineRegister());
     ASSERT_EQ(1, dex_register_map[1].GetMachineRegister());
 
-    DexRegisterLocation location0 = code_info.GetDexRegisterCatalogEntry(3);
+    DexRegisterLocation location0 = code_info.GetDexRegisterCatalogEntry(5);
     DexRegisterLocation location1 = code_info.GetDexRegisterCatalogEntry(6);
     ASSERT_EQ(Kind::kInFpuRegister, location0.GetKind());
     ASSERT_EQ(Kind::kInFpuRegisterHigh, location1.GetKind());
@@ -765,4 +765,98 @@ TEST(StackMapTest, TestDeduplicateStackMask) {
             stack_map2.GetStackMaskIndex());
 }
 
+TEST(StackMapTest, TestNativePcLookupHints) {
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+  StackMapStream stream(&allocator, kRuntimeISA);
+  stream.BeginMethod(/* frame_size_in_bytes= */ 32,
+                     /* core_spill_mask= */ 0,
+                     /* fp_spill_mask= */ 0,
+                     /* num_dex_registers= */ 0,
+                     /* baseline= */ false,
+                     /* debuggable= */ false);
+
+  // Enough stack maps for the lookups to use hints. One native pc has a debug stack map
+  // before the default one, so a hint for the first of the two rows must not be returned.
+  constexpr uint32_t kNumStackMaps = 2u * CodeInfo::kMinStackMapsForLookupHint;
+  constexpr uint32_t kDebugStackMapIndex = 5u;
+  for (uint32_t i = 0; i != kNumStackMaps; ++i) {
+    uint32_t native_pc = (i + 1u) * 4u * kPcAlign;
+    if (i == kDebugStackMapIndex) {
+      stream.BeginStackMapEntry(i, native_pc, 0, nullptr, StackMap::Kind::Debug);
+      stream.EndStackMapEntry();
+    }
+    stream.BeginStackMapEntry(i, native_pc);
+    stream.EndStackMapEntry();
+  }
+
+  stream.EndMethod((kNumStackMaps + 1u) * 4u * kPcAlign);
+  ScopedArenaVector<uint8_t> memory = stream.Encode();
+
+  CodeInfo code_info(memory.data());
+  ASSERT_EQ(kNumStackMaps + 1u, code_info.GetNumberOfStackMaps());
+
+  // Look up every native pc twice, the second time through the recorded hint.
+  for (size_t pass = 0; pass != 2u; ++pass) {
+    for (uint32_t i = 0; i != kNumStackMaps; ++i) {
+      StackMap stack_map = code_info.GetStackMapForNativePcOffset((i + 1u) * 4u * kPcAlign);
+      ASSERT_TRUE(stack_map.IsValid());
+      ASSERT_EQ(i, stack_map.GetDexPc());
+      ASSERT_EQ(StackMap::Kind::Default, static_cast<StackMap::Kind>(stack_map.GetKind()));
+      ASSERT_EQ(i > kDebugStackMapIndex ? i + 1u : i, stack_map.Row());
+    }
+    ASSERT_FALSE(code_info.GetStackMapForNativePcOffset(2u * kPcAlign).IsValid());
+  }
+}
+
+TEST(StackMapTest, TestCanonicalBitTables) {
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+
+  // Encode two methods which use the same register masks and dex register locations,
+  // in different orders.
+  auto encode = [&](bool reversed) {
+    StackMapStream stream(&allocator, kRuntimeISA);
+    stream.BeginMethod(/* frame_size_in_bytes= */ 32,
+                       /* core_spill_mask= */ 0,
+                       /* fp_spill_mask= */ 0,
+                       /* num_dex_registers= */ 2,
+                       /* baseline= */ false,
+                       /* debuggable= */ false);
+    stream.BeginStackMapEntry(0, 4 * kPcAlign, reversed ? 0xF0 : 0x3);
+    stream.AddDexRegisterEntry(reversed ? Kind::kInRegister : Kind::kInStack, 8);
+    stream.AddDexRegisterEntry(Kind::kConstant, reversed ? 7 : -2);
+    stream.EndStackMapEntry();
+    stream.BeginStackMapEntry(1, 8 * kPcAlign, reversed ? 0x3 : 0xF0);
+    stream.AddDexRegisterEntry(reversed ? Kind::kInStack : Kind::kInRegister, 8);
+    stream.AddDexRegisterEntry(Kind::kConstant, reversed ? -2 : 7);
+    stream.EndStackMapEntry();
+    stream.EndMethod(8 * kPcAlign);
+    return stream.Encode();
+  };
+  ScopedArenaVector<uint8_t> memory1 = encode(/* reversed= */ false);
+  ScopedArenaVector<uint8_t> memory2 = encode(/* reversed= */ true);
+
+  CodeInfo code_info1(memory1.data());
+  CodeInfo code_info2(memory2.data());
+  ASSERT_EQ(4u, code_info1.GetNumberOfLocationCatalogEntries());
+  ASSERT_EQ(4u, code_info2.GetNumberOfLocationCatalogEntries());
+  for (size_t i = 0; i != 4u; ++i) {
+    ASSERT_EQ(code_info1.GetDexRegisterCatalogEntry(i), code_info2.GetDexRegisterCatalogEntry(i));
+  }
+  ASSERT_EQ(code_info1.GetStackMapAt(0).GetRegisterMaskIndex(),
+            code_info2.GetStackMapAt(1).GetRegisterMaskIndex());
+
+  // The references were updated along with the sorted tables.
+  StackMap stack_map = code_info2.GetStackMapAt(0);
+  ASSERT_EQ(0xF0u, code_info2.GetRegisterMaskOf(stack_map));
+  DexRegisterMap dex_register_map = code_info2.GetDexRegisterMapOf(stack_map);
+  ASSERT_EQ(Kind::kInRegister, dex_register_map[0].GetKind());
+  ASSERT_EQ(8, dex_register_map[0].GetMachineRegister());
+  ASSERT_EQ(Kind::kConstant, dex_register_map[1].GetKind());
+  ASSERT_EQ(7, dex_register_map[1].GetConstant());
+}
+
 }  // namespace art
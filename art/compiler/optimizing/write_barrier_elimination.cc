@@ -16,7 +16,10 @@
 
 #include "write_barrier_elimination.h"
 
+#include <algorithm>
+
 #include "base/arena_allocator.h"
+#include "base/array_ref.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 #include "optimizing/nodes.h"
@@ -32,13 +35,20 @@ class WBEVisitor final : public HGraphVisitor {
       : HGraphVisitor(graph),
         scoped_allocator_(graph->GetArenaStack()),
         current_write_barriers_(scoped_allocator_.Adapter(kArenaAllocWBE)),
+        end_write_barriers_(graph->GetBlocks().size(),
+                            ScopedArenaHashMap<HInstruction*, HInstruction*>(
+                                scoped_allocator_.Adapter(kArenaAllocWBE)),
+                            scoped_allocator_.Adapter(kArenaAllocWBE)),
+        visited_blocks_(graph->GetBlocks().size(),
+                        false,
+                        scoped_allocator_.Adapter(kArenaAllocWBE)),
         stats_(stats) {}
 
   void VisitBasicBlock(HBasicBlock* block) override {
-    // We clear the map to perform this optimization only in the same block. Doing it across blocks
-    // would entail non-trivial merging of states.
-    current_write_barriers_.clear();
+    MergePredecessorValues(block);
     VisitNonPhiInstructions(block);
+    end_write_barriers_[block->GetBlockId()] = current_write_barriers_;
+    visited_blocks_[block->GetBlockId()] = true;
   }
 
   void VisitInstanceFieldSet(HInstanceFieldSet* instruction) override {
@@ -57,7 +67,7 @@ class WBEVisitor final : public HGraphVisitor {
       DCHECK(it->second->IsInstanceFieldSet());
       DCHECK(it->second->AsInstanceFieldSet()->GetWriteBarrierKind() !=
              WriteBarrierKind::kDontEmit);
-      DCHECK_EQ(it->second->GetBlock(), instruction->GetBlock());
+      DCHECK(it->second->GetBlock()->Dominates(instruction->GetBlock()));
       it->second->AsInstanceFieldSet()->SetWriteBarrierKind(WriteBarrierKind::kEmitBeingReliedOn);
       instruction->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
       MaybeRecordStat(stats_, MethodCompilationStat::kRemovedWriteBarrier);
@@ -83,7 +93,7 @@ class WBEVisitor final : public HGraphVisitor {
     if (it != current_write_barriers_.end()) {
       DCHECK(it->second->IsStaticFieldSet());
       DCHECK(it->second->AsStaticFieldSet()->GetWriteBarrierKind() != WriteBarrierKind::kDontEmit);
-      DCHECK_EQ(it->second->GetBlock(), instruction->GetBlock());
+      DCHECK(it->second->GetBlock()->Dominates(instruction->GetBlock()));
       it->second->AsStaticFieldSet()->SetWriteBarrierKind(WriteBarrierKind::kEmitBeingReliedOn);
       instruction->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
       MaybeRecordStat(stats_, MethodCompilationStat::kRemovedWriteBarrier);
@@ -111,7 +121,7 @@ class WBEVisitor final : public HGraphVisitor {
     if (it != current_write_barriers_.end()) {
       DCHECK(it->second->IsArraySet());
       DCHECK(it->second->AsArraySet()->GetWriteBarrierKind() != WriteBarrierKind::kDontEmit);
-      DCHECK_EQ(it->second->GetBlock(), instruction->GetBlock());
+      DCHECK(it->second->GetBlock()->Dominates(instruction->GetBlock()));
       it->second->AsArraySet()->SetWriteBarrierKind(WriteBarrierKind::kEmitBeingReliedOn);
       instruction->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
       MaybeRecordStat(stats_, MethodCompilationStat::kRemovedWriteBarrier);
@@ -131,6 +141,37 @@ class WBEVisitor final : public HGraphVisitor {
  private:
   void ClearCurrentValues() { current_write_barriers_.clear(); }
 
+  // Start the block with the write barriers that are live at the end of all its predecessors,
+  // i.e. the same write barrier was emitted on every path to the block and no instruction that can
+  // trigger GC was executed since. We start from scratch at loop headers (where the back edge has
+  // not been visited yet) and at catch blocks (which are entered from the middle of a block).
+  void MergePredecessorValues(HBasicBlock* block) {
+    ClearCurrentValues();
+    const ArrayRef<HBasicBlock* const> predecessors(block->GetPredecessors());
+    if (predecessors.empty() || block->IsCatchBlock()) {
+      return;
+    }
+    for (HBasicBlock* predecessor : predecessors) {
+      if (!visited_blocks_[predecessor->GetBlockId()]) {
+        return;
+      }
+    }
+    for (const auto& entry : end_write_barriers_[predecessors[0]->GetBlockId()]) {
+      bool live_in_all_predecessors = std::all_of(
+          predecessors.begin() + 1u,
+          predecessors.end(),
+          [&](HBasicBlock* predecessor) {
+            const ScopedArenaHashMap<HInstruction*, HInstruction*>& end_values =
+                end_write_barriers_[predecessor->GetBlockId()];
+            auto it = end_values.find(entry.first);
+            return it != end_values.end() && it->second == entry.second;
+          });
+      if (live_in_all_predecessors) {
+        current_write_barriers_.insert(entry);
+      }
+    }
+  }
+
   HInstruction* HuntForOriginalReference(HInstruction* ref) const {
     // An original reference can be transformed by instructions like:
     //   i0 NewArray
@@ -149,6 +190,10 @@ class WBEVisitor final : public HGraphVisitor {
   // `InstructionWhereTheWriteBarrierIs` is used for DCHECKs only.
   ScopedArenaHashMap<HInstruction*, HInstruction*> current_write_barriers_;
 
+  // The `current_write_barriers_` at the end of each visited block, indexed by block id.
+  ScopedArenaVector<ScopedArenaHashMap<HInstruction*, HInstruction*>> end_write_barriers_;
+  ScopedArenaVector<bool> visited_blocks_;
+
   OptimizingCompilerStats* const stats_;
 
   DISALLOW_COPY_AND_ASSIGN(WBEVisitor);
@@ -32,6 +32,10 @@ namespace art HIDDEN {
 //   o.inner_obj3 = io3;
 // We can keep the write barrier for `inner_obj` and remove the other two.
 //
+// This also works across blocks, as long as the write barrier we keep is emitted on every path to
+// the store and no instruction that can trigger GC is executed in between. For example, the
+// stores in both arms of an `if` can rely on a store to the same receiver before the `if`.
+//
 // In order to do this, we set the WriteBarrierKind of the instruction. The instruction's kind are
 // set to kEmitBeingReliedOn (if this write barrier coalesced other write barriers, we don't want to
 // perform the null check optimization), or to kDontEmit (if the write barrier as a whole is not
@@ -73,7 +73,7 @@ X86MemoryOperandGeneration::X86MemoryOperandGeneration(HGraph* graph,
                                                        CodeGenerator* codegen,
                                                        OptimizingCompilerStats* stats)
     : HOptimization(graph, kX86MemoryOperandGenerationPassName, stats),
-      do_implicit_null_checks_(codegen->GetCompilerOptions().GetImplicitNullChecks()) {
+      do_implicit_null_checks_(codegen->UseImplicitNullChecks()) {
 }
 
 bool X86MemoryOperandGeneration::Run() {
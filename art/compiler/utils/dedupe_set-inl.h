@@ -45,6 +45,8 @@ struct DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Stats {
   size_t collision_max = 0u;
   size_t total_probe_distance = 0u;
   size_t total_size = 0u;
+  size_t contended_locks = 0u;
+  uint64_t lock_wait_time_ns = 0u;
 };
 
 template <typename InKey,
@@ -70,15 +72,18 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
   }
 
   const StoreKey* Add(Thread* self, size_t hash, const InKey& in_key) REQUIRES(!lock_) {
-    MutexLock lock(self, lock_);
+    LockAndRecordContention(self);
     HashedKey<InKey> hashed_in_key(hash, &in_key);
     auto it = keys_.find(hashed_in_key);
+    const StoreKey* store_key;
     if (it != keys_.end()) {
       DCHECK(it->Key() != nullptr);
-      return it->Key();
+      store_key = it->Key();
+    } else {
+      store_key = alloc_.Copy(in_key);
+      keys_.insert(HashedKey<StoreKey> { hash, store_key });
     }
-    const StoreKey* store_key = alloc_.Copy(in_key);
-    keys_.insert(HashedKey<StoreKey> { hash, store_key });
+    lock_.ExclusiveUnlock(self);
     return store_key;
   }
 
@@ -97,6 +102,8 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
       // It may have been higher before a re-hash.
       global_stats->total_probe_distance += keys_.TotalProbeDistance();
       global_stats->total_size += keys_.size();
+      global_stats->contended_locks += contended_locks_;
+      global_stats->lock_wait_time_ns += lock_wait_time_ns_;
       for (const HashedKey<StoreKey>& key : keys_) {
         auto it = stats.find(key.Hash());
         if (it == stats.end()) {
@@ -116,6 +123,18 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
   }
 
  private:
+  // Acquire the `lock_`, measuring the time spent waiting for it if it is contended.
+  // The uncontended path does not read the clock.
+  void LockAndRecordContention(Thread* self) ACQUIRE(lock_) {
+    if (LIKELY(lock_.ExclusiveTryLock(self))) {
+      return;
+    }
+    uint64_t wait_start = NanoTime();
+    lock_.ExclusiveLock(self);
+    ++contended_locks_;
+    lock_wait_time_ns_ += NanoTime() - wait_start;
+  }
+
   template <typename T>
   class HashedKey {
    public:
@@ -184,6 +203,8 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
   const std::string lock_name_;
   Mutex lock_;
   HashSet<HashedKey<StoreKey>, ShardEmptyFn, ShardHashFn, ShardPred> keys_ GUARDED_BY(lock_);
+  size_t contended_locks_ GUARDED_BY(lock_) = 0u;
+  uint64_t lock_wait_time_ns_ GUARDED_BY(lock_) = 0u;
 };
 
 template <typename InKey,
@@ -261,12 +282,17 @@ std::string DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::DumpS
     shards_[shard]->UpdateStats(self, &stats);
   }
   return android::base::StringPrintf("%zu collisions, %zu max hash collisions, "
-                                     "%zu/%zu probe distance, %" PRIu64 " ns hash time",
+                                     "%zu/%zu probe distance, %" PRIu64 " ns hash time, "
+                                     "%zu shards, %zu contended locks, "
+                                     "%" PRIu64 " ns lock wait time",
                                      stats.collision_sum,
                                      stats.collision_max,
                                      stats.total_probe_distance,
                                      stats.total_size,
-                                     hash_time_);
+                                     hash_time_,
+                                     static_cast<size_t>(kShard),
+                                     stats.contended_locks,
+                                     stats.lock_wait_time_ns);
 }
 
 
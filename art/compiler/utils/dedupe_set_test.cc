@@ -89,4 +89,30 @@ TEST(DedupeSetTest, Test) {
   }
 }
 
+TEST(DedupeSetTest, Sharded) {
+  Thread* self = Thread::Current();
+  DedupeSetTestAlloc alloc;
+  DedupeSet<ArrayRef<const uint8_t>,
+            std::vector<uint8_t>,
+            DedupeSetTestAlloc,
+            size_t,
+            DedupeSetTestHashFunc,
+            16u> deduplicator("test", alloc);
+
+  // Keys spread over all shards are deduplicated within their shard.
+  static constexpr size_t kNumKeys = 100u;
+  std::vector<const std::vector<uint8_t>*> arrays;
+  for (size_t i = 0; i != kNumKeys; ++i) {
+    uint8_t raw_test[] = { static_cast<uint8_t>(i), 20u, 30u };
+    arrays.push_back(deduplicator.Add(self, ArrayRef<const uint8_t>(raw_test)));
+    ASSERT_NE(arrays.back(), nullptr);
+  }
+  for (size_t i = 0; i != kNumKeys; ++i) {
+    uint8_t raw_test[] = { static_cast<uint8_t>(i), 20u, 30u };
+    ASSERT_EQ(arrays[i], deduplicator.Add(self, ArrayRef<const uint8_t>(raw_test)));
+  }
+  ASSERT_EQ(kNumKeys, deduplicator.Size(self));
+  ASSERT_NE(std::string::npos, deduplicator.DumpStats(self).find("16 shards"));
+}
+
 }  // namespace art
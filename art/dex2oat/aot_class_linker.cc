@@ -256,6 +256,20 @@ void AotClassLinker::SetEnablePublicSdkChecks(bool enabled) {
   }
 }
 
+void AotClassLinker::SetFastNativeMethods(const std::set<std::string, std::less<>>& methods) {
+  fast_native_methods_ = methods;
+}
+
+bool AotClassLinker::IsListedFastNativeMethod(const DexFile& dex_file, uint32_t method_idx) const {
+  if (!fast_native_methods_.empty() &&
+      fast_native_methods_.find(GetFastNativeMethodName(dex_file, method_idx)) !=
+          fast_native_methods_.end()) {
+    return true;
+  }
+  // The dex files of the class loader context may have their own compiled oat files.
+  return ClassLinker::IsListedFastNativeMethod(dex_file, method_idx);
+}
+
 // Transaction support.
 
 bool AotClassLinker::IsActiveTransaction() const {
@@ -18,6 +18,8 @@
 #define ART_DEX2OAT_AOT_CLASS_LINKER_H_
 
 #include <forward_list>
+#include <set>
+#include <string>
 
 #include "base/macros.h"
 #include "sdk_checker.h"
@@ -57,6 +59,9 @@ class AotClassLinker : public ClassLinker {
   // Enable or disable public sdk checks.
   void SetEnablePublicSdkChecks(bool enabled) override;
 
+  // Set the native methods to compile as @FastNative, see `dex2oat --fast-native-methods`.
+  EXPORT void SetFastNativeMethods(const std::set<std::string, std::less<>>& methods);
+
   // Transaction support.
   EXPORT bool IsActiveTransaction() const;
   // EnterTransactionMode may suspend.
@@ -170,9 +175,14 @@ class AotClassLinker : public ClassLinker {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::dex_lock_);
 
+  // Also look up the native methods in the list of the methods we are compiling.
+  bool IsListedFastNativeMethod(const DexFile& dex_file, uint32_t method_idx) const override;
+
  private:
   std::unique_ptr<SdkChecker> sdk_checker_;
 
+  std::set<std::string, std::less<>> fast_native_methods_;
+
   // Transactions used for pre-initializing classes at compilation time.
   // Support nested transactions, maintain a list containing all transactions. Transactions are
   // handled under a stack discipline. Because GC needs to go over all transactions, we choose list
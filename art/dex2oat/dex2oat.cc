@@ -26,6 +26,7 @@
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -806,6 +807,11 @@ class Dex2Oat final {
       Usage("--multi-image specified for app image");
     }
 
+    if (!fast_native_methods_file_.empty() && IsBootImage()) {
+      // The core classes of the primary boot image are loaded before we can set up the list.
+      Usage("--fast-native-methods specified for the primary boot image");
+    }
+
     if (image_fd_ != -1 && compiler_options_->multi_image_) {
       Usage("--single-image not specified for --image-fd");
     }
@@ -1097,6 +1103,7 @@ class Dex2Oat final {
     AssignIfExists(args, M::Profile, &profile_files_);
     AssignIfExists(args, M::ProfileFd, &profile_file_fds_);
     AssignIfExists(args, M::PreloadedClasses, &preloaded_classes_files_);
+    AssignIfExists(args, M::FastNativeMethods, &fast_native_methods_file_);
     AssignIfExists(args, M::PreloadedClassesFds, &preloaded_classes_fds_);
     AssignIfExists(args, M::RuntimeOptions, &runtime_args_);
     AssignIfExists(args, M::SwapFile, &swap_file_name_);
@@ -1463,6 +1470,10 @@ class Dex2Oat final {
       return dex2oat::ReturnCode::kOther;
     }
 
+    if (!PrepareFastNativeMethods()) {
+      return dex2oat::ReturnCode::kOther;
+    }
+
     callbacks_.reset(new QuickCompilerCallbacks(
         // For class verification purposes, boot image extension is the same as boot image.
         (IsBootImage() || IsBootImageExtension())
@@ -1968,6 +1979,10 @@ class Dex2Oat final {
     if (IsAppImage()) {
       AotClassLinker::SetAppImageDexFiles(&compiler_options_->GetDexFilesForOatFile());
     }
+    if (!fast_native_methods_.empty()) {
+      // Before loading the classes, so that the methods have the same flags as their JNI stubs.
+      down_cast<AotClassLinker*>(class_linker)->SetFastNativeMethods(fast_native_methods_);
+    }
 
     // Register dex caches and key them to the class loader so that they only unload when the
     // class loader unloads.
@@ -2146,18 +2161,35 @@ class Dex2Oat final {
         }
       }
 
+      // We need to mirror the layout of the ELF file in the compressed debug-info.
+      // Therefore PrepareDebugInfo() relies on the SetLoadedSectionSizes() call further above.
+      // The debug info must stay alive until the compression is finished, so it is not
+      // moved once prepared.
+      const size_t num_oat_files = oat_files_.size();
+      std::unique_ptr<debug::DebugInfo[]> debug_infos(new debug::DebugInfo[num_oat_files]);
+      // This will perform the compression on background threads while we do other I/O below.
+      // If we hit any ERROR path below, the destructors of these jobs will wait for the
+      // tasks to finish (since they access the `debug_infos` above and other 'Dex2Oat' data).
+      // The jobs are destroyed before the `debug_infos` as they are declared after them.
+      std::vector<std::unique_ptr<ThreadPool>> compression_jobs(num_oat_files);
+      // Compress the mini-debug-info of up to `thread_count_` oat files ahead of the one
+      // being written, so that multi-image compilation compresses them in parallel.
+      size_t num_prepared_debug_infos = 0u;
+      auto prepare_debug_infos = [&](size_t end) {
+        for (end = std::min(end, num_oat_files); num_prepared_debug_infos < end;
+             ++num_prepared_debug_infos) {
+          size_t index = num_prepared_debug_infos;
+          debug_infos[index] = oat_writers_[index]->GetDebugInfo();
+          compression_jobs[index] = elf_writers_[index]->PrepareDebugInfo(debug_infos[index]);
+        }
+      };
+
       for (size_t i = 0, size = oat_files_.size(); i != size; ++i) {
         std::unique_ptr<File>& oat_file = oat_files_[i];
         std::unique_ptr<linker::ElfWriter>& elf_writer = elf_writers_[i];
         std::unique_ptr<linker::OatWriter>& oat_writer = oat_writers_[i];
 
-        // We need to mirror the layout of the ELF file in the compressed debug-info.
-        // Therefore PrepareDebugInfo() relies on the SetLoadedSectionSizes() call further above.
-        debug::DebugInfo debug_info = oat_writer->GetDebugInfo();  // Keep the variable alive.
-        // This will perform the compression on background thread while we do other I/O below.
-        // If we hit any ERROR path below, the destructor of this variable will wait for the
-        // task to finish (since it accesses the 'debug_info' above and other 'Dex2Oat' data).
-        std::unique_ptr<ThreadPool> compression_job = elf_writer->PrepareDebugInfo(debug_info);
+        prepare_debug_infos(i + std::max<size_t>(thread_count_, 1u));
 
         OutputStream* rodata = rodata_[i];
         DCHECK(rodata != nullptr);
@@ -2211,11 +2243,17 @@ class Dex2Oat final {
 
         VLOG(compiler) << "Oat file written successfully: " << oat_filenames_[i];
 
+        compression_jobs[i].reset();
         oat_writer.reset();
         // We may still need the ELF writer later for stripping.
       }
     }
 
+    // The compiled code has been written out and the image writer does not need it.
+    // Release it before writing the image to reduce the peak memory usage.
+    driver_->FreeCompiledMethods();
+    VLOG(compiler) << "After writing oat files: " << driver_->GetMemoryUsageString(false);
+
     return true;
   }
 
@@ -2574,6 +2612,22 @@ class Dex2Oat final {
     return true;
   }
 
+  bool PrepareFastNativeMethods() {
+    if (fast_native_methods_file_.empty()) {
+      return true;
+    }
+    if (!ReadCommentedInputFromFile(
+            fast_native_methods_file_.c_str(), nullptr, &fast_native_methods_)) {
+      return false;
+    }
+    if (!fast_native_methods_.empty()) {
+      // Record the sorted list for the runtime, see `OatFile::IsFastNativeMethod()`.
+      key_value_store_->Put(OatHeader::kFastNativeMethodsKey,
+                            android::base::Join(fast_native_methods_, '\n'));
+    }
+    return true;
+  }
+
   void PruneNonExistentDexFiles() {
     DCHECK_EQ(dex_filenames_.size(), dex_locations_.size());
     size_t kept = 0u;
@@ -2780,7 +2834,8 @@ class Dex2Oat final {
     }
     if (!image_writer_->Write(IsAppImage() ? app_image_fd_ : image_fd_,
                               image_filenames_,
-                              IsAppImage() ? 1u : dex_locations_.size())) {
+                              IsAppImage() ? 1u : dex_locations_.size(),
+                              thread_count_)) {
       LOG(ERROR) << "Failure during image file creation";
       return false;
     }
@@ -2983,6 +3038,8 @@ class Dex2Oat final {
   std::vector<int> profile_file_fds_;
   std::vector<std::string> preloaded_classes_files_;
   std::vector<int> preloaded_classes_fds_;
+  std::string fast_native_methods_file_;
+  std::set<std::string, std::less<>> fast_native_methods_;
   std::unique_ptr<ProfileCompilationInfo> profile_compilation_info_;
   TimingLogger* timings_;
   std::vector<std::vector<const DexFile*>> dex_files_per_oat_file_;
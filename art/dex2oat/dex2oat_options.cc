@@ -272,7 +272,14 @@ static void AddCompilerMappings(Builder& builder) {
       .Define("--preloaded-classes-fds=_")
           .WithType<std::vector<int>>().AppendValues()
           .WithHelp("Specify files containing list of classes preloaded in the zygote.")
-          .IntoKey(M::PreloadedClassesFds);
+          .IntoKey(M::PreloadedClassesFds)
+      .Define("--fast-native-methods=_")
+          .WithType<std::string>()
+          .WithHelp("Specify a file containing a list of native methods to compile as\n"
+                    "@FastNative, one per line, like 'Lcom/example/Foo;->bar(I)I'. The list is\n"
+                    "recorded in the oat file, and the runtime treats the methods as @FastNative\n"
+                    "when it uses the oat file. Synchronized and annotated methods are ignored.")
+          .IntoKey(M::FastNativeMethods);
   // clang-format on
 }
 
@@ -171,6 +171,7 @@ void CompiledMethodStorage::DumpMemoryUsage(std::ostream& os, bool extended) con
     os << "\nCode dedupe: " << dedupe_code_.DumpStats(self);
     os << "\nVmap table dedupe: " << dedupe_vmap_table_.DumpStats(self);
     os << "\nCFI info dedupe: " << dedupe_cfi_info_.DumpStats(self);
+    os << "\nLinker patches dedupe: " << dedupe_linker_patches_.DumpStats(self);
   }
 }
 
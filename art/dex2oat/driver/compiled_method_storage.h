@@ -114,13 +114,17 @@ class CompiledMethodStorage final : public CompiledCodeStorage {
   template <typename T>
   class LengthPrefixedArrayAlloc;
 
+  // Number of lock shards of each dedupe set. Many compiler threads add to the sets
+  // concurrently, so use enough shards to keep lock contention low on large machines.
+  static constexpr size_t kDedupeShards = 64u;
+
   template <typename T>
   using ArrayDedupeSet = DedupeSet<ArrayRef<const T>,
                                    LengthPrefixedArray<T>,
                                    LengthPrefixedArrayAlloc<T>,
                                    size_t,
                                    DedupeHashFunc<const T>,
-                                   4>;
+                                   kDedupeShards>;
 
   // Swap pool and allocator used for native allocations. May be file-backed. Needs to be first
   // as other fields rely on this.
@@ -22,6 +22,9 @@
 #include <malloc.h>  // For mallinfo
 #endif
 
+#include <algorithm>
+#include <functional>
+#include <sstream>
 #include <string_view>
 #include <vector>
 
@@ -86,6 +89,7 @@
 #include "utils/swap_space.h"
 #include "vdex_file.h"
 #include "verifier/class_verifier.h"
+#include "verifier/method_verifier.h"
 #include "verifier/verifier_deps.h"
 #include "verifier/verifier_enums.h"
 #include "well_known_classes-inl.h"
@@ -94,6 +98,10 @@ namespace art {
 
 static constexpr bool kTimeCompileMethod = !kIsDebugBuild;
 
+// Number of slowest method compilations reported with --dump-timings.
+static constexpr size_t kNumberOfSlowestMethodsToReport = 20u;
+static constexpr size_t kNumberOfSlowestPackagesToReport = 20u;
+
 // Print additional info during profile guided compilation.
 static constexpr bool kDebugProfileGuidedCompilation = false;
 
@@ -142,6 +150,14 @@ class CompilerDriver::AOTCompilationStats {
       DumpStat(class_status_count_[i], total - class_status_count_[i], oss.str().c_str());
     }
 
+    uint32_t straight_line_methods;
+    uint32_t code_flow_methods;
+    verifier::MethodVerifier::GetVerificationPathCounts(&straight_line_methods,
+                                                        &code_flow_methods);
+    DumpStat(straight_line_methods,
+             code_flow_methods,
+             "methods verified in a single straight-line pass");
+
     for (size_t i = 0; i <= kMaxInvokeType; i++) {
       std::ostringstream oss;
       oss << static_cast<InvokeType>(i) << " methods were AOT resolved";
@@ -265,7 +281,9 @@ CompilerDriver::CompilerDriver(
       parallel_thread_count_(thread_count),
       stats_(new AOTCompilationStats),
       compiled_method_storage_(swap_fd),
-      max_arena_alloc_(0) {
+      max_arena_alloc_(0),
+      slowest_methods_lock_("compiler driver slowest methods lock"),
+      min_slowest_method_ns_(0u) {
   DCHECK(compiler_options_ != nullptr);
 
   compiled_method_storage_.SetDedupeEnabled(compiler_options_->DeduplicateCode());
@@ -273,12 +291,17 @@ CompilerDriver::CompilerDriver(
 }
 
 CompilerDriver::~CompilerDriver() {
+  FreeCompiledMethods();
+}
+
+void CompilerDriver::FreeCompiledMethods() {
   compiled_methods_.Visit(
       [this]([[maybe_unused]] const DexFileReference& ref, CompiledMethod* method) {
         if (method != nullptr) {
           CompiledMethod::ReleaseSwapAllocatedCompiledMethod(GetCompiledMethodStorage(), method);
         }
       });
+  compiled_methods_.ClearEntries();
 }
 
 
@@ -397,6 +420,7 @@ static void CompileMethodHarness(
       LOG(WARNING) << "Compilation of " << dex_file.PrettyMethod(method_idx)
                    << " took " << PrettyDuration(duration_ns);
     }
+    driver->RecordMethodCompileTime(self, method_ref, class_def_idx, duration_ns);
   }
 
   if (compiled_method != nullptr) {
@@ -488,10 +512,13 @@ static void CompileMethodQuick(
         // Query any JNI optimization annotations such as @FastNative or @CriticalNative.
         access_flags |= annotations::GetNativeMethodAnnotationAccessFlags(
             dex_file, dex_file.GetClassDef(class_def_idx), method_idx);
+        // Or from the list of fast native methods, like the class linker does for the method.
+        ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+        access_flags |=
+            class_linker->GetListedFastNativeAccessFlags(dex_file, method_idx, access_flags);
         const void* boot_jni_stub = nullptr;
         if (!Runtime::Current()->GetHeap()->GetBootImageSpaces().empty()) {
           // Skip the compilation for native method if found an usable boot JNI stub.
-          ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
           std::string_view shorty = dex_file.GetMethodShortyView(dex_file.GetMethodId(method_idx));
           boot_jni_stub = class_linker->FindBootJniStub(access_flags, shorty);
         }
@@ -2244,7 +2271,14 @@ class InitializeClassVisitor : public CompilationVisitor {
 
     ClassStatus old_status = klass->GetStatus();
     // Only try to initialize classes that were successfully verified.
-    if (klass->IsVerified()) {
+    if (!klass->IsVerified()) {
+      if ((is_app_image || is_boot_image || is_boot_image_extension) &&
+          compiler_options.IsImageClass(descriptor)) {
+        std::ostringstream reason;
+        reason << "Class not verified, status " << old_status;
+        ReportInitFailure(descriptor, reason.str());
+      }
+    } else {
       // Attempt to initialize the class but bail if we either need to initialize the super-class
       // or static fields.
       class_linker->EnsureInitialized(self, klass, false, false);
@@ -2280,12 +2314,25 @@ class InitializeClassVisitor : public CompilationVisitor {
 
         bool have_profile = (compiler_options.GetProfileCompilationInfo() != nullptr) &&
             !compiler_options.GetProfileCompilationInfo()->IsEmpty();
+        bool is_image_class = (is_app_image || is_boot_image || is_boot_image_extension) &&
+            compiler_options.IsImageClass(descriptor);
+        if (!klass->IsInitialized() && is_image_class) {
+          if (!try_initialize_with_superclasses) {
+            ReportInitFailure(descriptor,
+                              "A superclass or an interface with default methods was not "
+                              "initialized, or a type in a method signature was not resolved");
+          } else if (too_many_encoded_fields) {
+            std::ostringstream reason;
+            reason << "Too many static fields: " << klass->NumStaticFields() << " > "
+                   << kMaxEncodedFields;
+            ReportInitFailure(descriptor, reason.str());
+          }
+        }
         // If the class was not initialized, we can proceed to see if we can initialize static
         // fields. Limit the max number of encoded fields.
         if (!klass->IsInitialized() &&
-            (is_app_image || is_boot_image || is_boot_image_extension) &&
+            is_image_class &&
             try_initialize_with_superclasses && !too_many_encoded_fields &&
-            compiler_options.IsImageClass(descriptor) &&
             // TODO(b/274077782): remove this test.
             (have_profile || !is_boot_image_extension)) {
           bool can_init_static_fields = false;
@@ -2311,6 +2358,14 @@ class InitializeClassVisitor : public CompilationVisitor {
             // checked when init superclass. Currently keep it because it contains
             // processing of intern strings. Will be removed later when intern strings
             // and clinit are both initialized.
+            if (!can_init_static_fields) {
+              ReportInitFailure(descriptor,
+                                compiler_options.GetDebuggable()
+                                    ? "Class initializers do not run at compile time for "
+                                      "debuggable apps"
+                                    : "A class initializer in the class or its dependencies "
+                                      "requires --initialize-app-image-classes=true");
+            }
           }
 
           if (can_init_static_fields) {
@@ -2427,6 +2482,18 @@ class InitializeClassVisitor : public CompilationVisitor {
   }
 
  private:
+  // Record why an image class could not be initialized at compile time, in the file given
+  // with --dump-init-failures. Classes that fail in their class initializer are recorded with
+  // the exception that aborted the transaction instead.
+  void ReportInitFailure(const char* descriptor, const std::string& reason) const {
+    VLOG(compiler) << "Not initializing " << descriptor << ": " << reason;
+    std::ostream* file_log = manager_->GetCompiler()->GetCompilerOptions().GetInitFailureOutput();
+    if (file_log != nullptr) {
+      *file_log << descriptor << "\n";
+      *file_log << reason << "\n";
+    }
+  }
+
   void InternStrings(Handle<mirror::Class> klass, Handle<mirror::ClassLoader> class_loader)
       REQUIRES_SHARED(Locks::mutator_lock_) {
     DCHECK(manager_->GetCompiler()->GetCompilerOptions().IsBootImage() ||
@@ -2649,6 +2716,27 @@ void CompilerDriver::InitializeClasses(jobject class_loader,
   }
 }
 
+// Returns all class def indexes ordered by the total size of their methods' code, largest first.
+// Classes of equal size keep their dex file order.
+static std::vector<uint16_t> GetClassDefsByDescendingCodeSize(const DexFile& dex_file) {
+  const uint32_t num_class_defs = dex_file.NumClassDefs();
+  std::vector<uint32_t> code_sizes(num_class_defs, 0u);
+  std::vector<uint16_t> class_def_order(num_class_defs);
+  for (uint32_t class_def_index = 0; class_def_index != num_class_defs; ++class_def_index) {
+    class_def_order[class_def_index] = dchecked_integral_cast<uint16_t>(class_def_index);
+    ClassAccessor accessor(dex_file, class_def_index);
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      code_sizes[class_def_index] += method.GetInstructions().InsnsSizeInCodeUnits();
+    }
+  }
+  std::stable_sort(class_def_order.begin(),
+                   class_def_order.end(),
+                   [&code_sizes](uint16_t lhs, uint16_t rhs) {
+                     return code_sizes[lhs] > code_sizes[rhs];
+                   });
+  return class_def_order;
+}
+
 template <typename CompileFn>
 static void CompileDexFile(CompilerDriver* driver,
                            jobject class_loader,
@@ -2671,6 +2759,14 @@ static void CompileDexFile(CompilerDriver* driver,
       ? compiler_options.GetProfileCompilationInfo()->FindDexFile(dex_file)
       : ProfileCompilationInfo::MaxProfileIndex();
 
+  // With multiple threads, compile the classes with the most code first. Otherwise a class
+  // with a huge method can be picked up last and keep one thread busy long after all other
+  // threads have run out of work. The compilation order does not affect the output.
+  std::vector<uint16_t> class_def_order;
+  if (thread_count > 1u) {
+    class_def_order = GetClassDefsByDescendingCodeSize(dex_file);
+  }
+
   auto compile = [&context, &compile_fn, profile_index](size_t class_def_index) {
     const DexFile& dex_file = *context.GetDexFile();
     SCOPED_TRACE << "compile " << dex_file.GetLocation() << "@" << class_def_index;
@@ -2734,7 +2830,17 @@ static void CompileDexFile(CompilerDriver* driver,
                  profile_index);
     }
   };
-  context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+  if (class_def_order.empty()) {
+    context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+  } else {
+    DCHECK_EQ(class_def_order.size(), dex_file.NumClassDefs());
+    context.ForAllLambda(0,
+                         class_def_order.size(),
+                         [&class_def_order, &compile](size_t index) {
+                           compile(class_def_order[index]);
+                         },
+                         thread_count);
+  }
 }
 
 void CompilerDriver::Compile(jobject class_loader,
@@ -2749,8 +2855,15 @@ void CompilerDriver::Compile(jobject class_loader,
             : profile_compilation_info->DumpInfo(dex_files));
   }
 
+  const bool report_times = GetCompilerOptions().GetDumpTimings() || VLOG_IS_ON(compiler);
+  std::ostringstream dex_file_times;
   for (const DexFile* dex_file : dex_files) {
     CHECK(dex_file != nullptr);
+    const uint64_t start_ns = NanoTime();
+    const uint64_t start_cpu_ns = ProcessCpuNanoTime();
+    if (report_times && kTimeCompileMethod) {
+      class_compile_ns_.reset(new std::atomic<uint64_t>[dex_file->NumClassDefs()]());
+    }
     CompileDexFile(this,
                    class_loader,
                    *dex_file,
@@ -2763,9 +2876,123 @@ void CompilerDriver::Compile(jobject class_loader,
     const size_t arena_alloc = arena_pool->GetBytesAllocated();
     max_arena_alloc_ = std::max(arena_alloc, max_arena_alloc_);
     Runtime::Current()->ReclaimArenaPoolMemory();
+    if (report_times) {
+      const uint64_t wall_ns = NanoTime() - start_ns;
+      dex_file_times << "\n  " << dex_file->GetLocation() << ": " << PrettyDuration(wall_ns)
+                     << " wall, " << PrettyDuration(ProcessCpuNanoTime() - start_cpu_ns)
+                     << " cpu, " << PrettySize(arena_alloc) << " arena peak";
+      if (class_compile_ns_ != nullptr) {
+        // Time spent compiling methods relative to the time available on all threads.
+        const uint64_t busy_ns = AccumulatePackageCompileTimes(*dex_file);
+        const uint64_t available_ns = wall_ns * std::max<size_t>(parallel_thread_count_, 1u);
+        dex_file_times << ", " << (busy_ns * 100u / std::max<uint64_t>(available_ns, 1u))
+                       << "% thread utilization";
+        class_compile_ns_.reset();
+      }
+    }
   }
 
   VLOG(compiler) << "Compile: " << GetMemoryUsageString(false);
+  if (report_times) {
+    LOG(INFO) << "Compilation time per dex file:" << dex_file_times.str();
+    DumpSlowestPackages();
+    DumpSlowestMethods(Thread::Current());
+  }
+}
+
+uint64_t CompilerDriver::AccumulatePackageCompileTimes(const DexFile& dex_file) {
+  DCHECK(class_compile_ns_ != nullptr);
+  uint64_t total_ns = 0u;
+  for (ClassAccessor accessor : dex_file.GetClasses()) {
+    const uint64_t class_ns =
+        class_compile_ns_[accessor.GetClassDefIndex()].load(std::memory_order_relaxed);
+    if (class_ns == 0u) {
+      continue;
+    }
+    // The package of "Lcom/example/Foo;" is "com.example".
+    std::string_view descriptor = accessor.GetDescriptorView();
+    size_t last_slash = descriptor.rfind('/');
+    std::string package = (last_slash == std::string_view::npos)
+        ? std::string()
+        : std::string(descriptor.substr(1u, last_slash - 1u));
+    std::replace(package.begin(), package.end(), '/', '.');
+    package_compile_ns_[package] += class_ns;
+    total_ns += class_ns;
+  }
+  return total_ns;
+}
+
+void CompilerDriver::DumpSlowestPackages() const {
+  if (package_compile_ns_.empty()) {
+    return;
+  }
+  std::vector<std::pair<uint64_t, std::string_view>> sorted;
+  sorted.reserve(package_compile_ns_.size());
+  for (const auto& [package, duration_ns] : package_compile_ns_) {
+    sorted.emplace_back(duration_ns, package);
+  }
+  std::sort(sorted.begin(), sorted.end(), std::greater<>());
+  if (sorted.size() > kNumberOfSlowestPackagesToReport) {
+    sorted.resize(kNumberOfSlowestPackagesToReport);
+  }
+  std::ostringstream oss;
+  oss << "Slowest packages to compile:";
+  for (const auto& [duration_ns, package] : sorted) {
+    oss << "\n  " << PrettyDuration(duration_ns) << " "
+        << (package.empty() ? "<default package>" : package);
+  }
+  LOG(INFO) << oss.str();
+}
+
+void CompilerDriver::RecordMethodCompileTime(Thread* self,
+                                             MethodReference method_ref,
+                                             uint16_t class_def_idx,
+                                             uint64_t duration_ns) {
+  if (class_compile_ns_ != nullptr) {
+    class_compile_ns_[class_def_idx].fetch_add(duration_ns, std::memory_order_relaxed);
+  }
+  // Avoid taking the lock for the vast majority of methods that are not among the slowest.
+  if (duration_ns <= min_slowest_method_ns_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  MutexLock mu(self, slowest_methods_lock_);
+  // Keep a min-heap so that the fastest of the recorded methods is at the front.
+  auto cmp = [](const std::pair<uint64_t, MethodReference>& lhs,
+                const std::pair<uint64_t, MethodReference>& rhs) {
+    return lhs.first > rhs.first;
+  };
+  if (slowest_methods_.size() == kNumberOfSlowestMethodsToReport) {
+    if (duration_ns <= slowest_methods_.front().first) {
+      return;
+    }
+    std::pop_heap(slowest_methods_.begin(), slowest_methods_.end(), cmp);
+    slowest_methods_.pop_back();
+  }
+  slowest_methods_.emplace_back(duration_ns, method_ref);
+  std::push_heap(slowest_methods_.begin(), slowest_methods_.end(), cmp);
+  if (slowest_methods_.size() == kNumberOfSlowestMethodsToReport) {
+    min_slowest_method_ns_.store(slowest_methods_.front().first, std::memory_order_relaxed);
+  }
+}
+
+void CompilerDriver::DumpSlowestMethods(Thread* self) {
+  MutexLock mu(self, slowest_methods_lock_);
+  if (slowest_methods_.empty()) {
+    return;
+  }
+  std::vector<std::pair<uint64_t, MethodReference>> sorted(slowest_methods_);
+  std::sort(sorted.begin(),
+            sorted.end(),
+            [](const std::pair<uint64_t, MethodReference>& lhs,
+               const std::pair<uint64_t, MethodReference>& rhs) {
+              return lhs.first > rhs.first;
+            });
+  std::ostringstream oss;
+  oss << "Slowest method compilations:";
+  for (const std::pair<uint64_t, MethodReference>& entry : sorted) {
+    oss << "\n  " << PrettyDuration(entry.first) << " " << entry.second.PrettyMethod();
+  }
+  LOG(INFO) << oss.str();
 }
 
 void CompilerDriver::AddCompiledMethod(const MethodReference& method_ref,
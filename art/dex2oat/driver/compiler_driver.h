@@ -18,6 +18,8 @@
 #define ART_DEX2OAT_DRIVER_COMPILER_DRIVER_H_
 
 #include <atomic>
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -101,6 +103,11 @@ class CompilerDriver {
   void InitializeThreadPools();
   void FreeThreadPools();
 
+  // Release the compiled code and metadata of all methods once they have been
+  // written to the oat files, so that they do not stay resident (or in the swap
+  // file) while the image is written.
+  void FreeCompiledMethods();
+
   void PreCompile(jobject class_loader,
                   const std::vector<const DexFile*>& dex_files,
                   TimingLogger* timings,
@@ -213,6 +220,15 @@ class CompilerDriver {
     number_of_soft_verifier_failures_++;
   }
 
+  // Record the time spent compiling a method, keeping track of the slowest methods
+  // and the time per class which are reported at the end of compilation with
+  // --dump-timings.
+  void RecordMethodCompileTime(Thread* self,
+                               MethodReference method_ref,
+                               uint16_t class_def_idx,
+                               uint64_t duration_ns)
+      REQUIRES(!slowest_methods_lock_);
+
   CompiledMethodStorage* GetCompiledMethodStorage() {
     return &compiled_method_storage_;
   }
@@ -286,6 +302,12 @@ class CompilerDriver {
 
   void CheckThreadPools();
 
+  void DumpSlowestMethods(Thread* self) REQUIRES(!slowest_methods_lock_);
+  // Add the compilation time per class of `dex_file` to the time per package and
+  // return the total time spent compiling methods of the dex file.
+  uint64_t AccumulatePackageCompileTimes(const DexFile& dex_file);
+  void DumpSlowestPackages() const;
+
   // Resolve const string literals that are loaded from dex code. If only_startup_strings is
   // specified, only methods that are marked startup in the profile are resolved.
   void ResolveConstStrings(const std::vector<const DexFile*>& dex_files,
@@ -326,6 +348,19 @@ class CompilerDriver {
 
   size_t max_arena_alloc_;
 
+  // The slowest method compilations, kept as a min-heap on the compilation time.
+  Mutex slowest_methods_lock_;
+  std::vector<std::pair<uint64_t, MethodReference>> slowest_methods_
+      GUARDED_BY(slowest_methods_lock_);
+  // Compilation time of the fastest method in the full `slowest_methods_` heap, zero until full.
+  std::atomic<uint64_t> min_slowest_method_ns_;
+
+  // Compilation time per class def of the dex file being compiled, when reporting
+  // compilation times. Null otherwise.
+  std::unique_ptr<std::atomic<uint64_t>[]> class_compile_ns_;
+  // Total compilation time per package, for the dex files compiled so far.
+  std::map<std::string, uint64_t> package_compile_ns_;
+
   friend class CommonCompilerDriverTest;
   friend class CompileClassVisitor;
   friend class InitializeClassVisitor;
@@ -262,6 +262,7 @@ TEST_F(ImageTest, ImageChecksum) {
         ImageHeader::kStorageModeUncompressed,
         /*max_image_block_size=*/std::numeric_limits<uint32_t>::max(),
         /*update_checksum=*/ true,
+        /*thread_pool=*/ nullptr,
         &error_msg)) << error_msg;
 
     uint32_t first_checksum = image_header.GetImageChecksum();
@@ -278,6 +279,7 @@ TEST_F(ImageTest, ImageChecksum) {
         ImageHeader::kStorageModeUncompressed,
         /*max_image_block_size=*/std::numeric_limits<uint32_t>::max(),
         /*update_checksum=*/ true,
+        /*thread_pool=*/ nullptr,
         &error_msg)) << error_msg;
 
     ASSERT_NE(first_checksum, image_header.GetImageChecksum());
@@ -349,7 +349,8 @@ inline void ImageTest::DoCompile(ImageHeader::StorageMode storage_mode,
 
     bool success_image = writer->Write(File::kInvalidFd,
                                        image_filenames,
-                                       image_filenames.size());
+                                       image_filenames.size(),
+                                       /*thread_count=*/ 2u);
     ASSERT_TRUE(success_image);
   }
 }
@@ -88,6 +88,7 @@
 #include "subtype_check.h"
 #include "thread-current-inl.h"  // For AssertOnly1Thread.
 #include "thread_list.h"         // For AssertOnly1Thread.
+#include "thread_pool.h"
 #include "well_known_classes-inl.h"
 
 using ::art::mirror::Class;
@@ -555,7 +556,8 @@ bool ImageWriter::IsInternedAppImageStringReference(ObjPtr<mirror::Object> refer
 
 bool ImageWriter::Write(int image_fd,
                         const std::vector<std::string>& image_filenames,
-                        size_t component_count) {
+                        size_t component_count,
+                        size_t thread_count) {
   // If image_fd or oat_fd are not File::kInvalidFd then we may have empty strings in
   // image_filenames or oat_filenames.
   CHECK(!image_filenames.empty());
@@ -567,6 +569,13 @@ bool ImageWriter::Write(int image_fd,
 
   Thread* const self = Thread::Current();
   ScopedDebugDisallowReadBarriers sddrb(self);
+  // Worker threads for copying objects and compressing the image. The calling thread
+  // also does work while waiting for the workers.
+  std::unique_ptr<ThreadPool> thread_pool;
+  if (thread_count > 1u) {
+    thread_pool.reset(ThreadPool::Create("Image writer", thread_count - 1u));
+    thread_pool->StartWorkers(self);
+  }
   {
     ScopedObjectAccess soa(self);
     for (size_t i = 0; i < oat_filenames_.size(); ++i) {
@@ -580,7 +589,7 @@ bool ImageWriter::Write(int image_fd,
     // TODO: heap validation can't handle these fix up passes.
     ScopedObjectAccess soa(self);
     Runtime::Current()->GetHeap()->DisableObjectValidation();
-    CopyAndFixupObjects();
+    CopyAndFixupObjects(thread_pool.get());
   }
 
   if (compiler_options_.IsAppImage()) {
@@ -631,6 +640,7 @@ bool ImageWriter::Write(int image_fd,
                                  image_storage_mode_,
                                  compiler_options_.MaxImageBlockSize(),
                                  /* update_checksum= */ true,
+                                 thread_pool.get(),
                                  &error_msg)) {
       LOG(ERROR) << error_msg;
       return false;
@@ -1718,7 +1728,7 @@ class ImageWriter::LayoutHelper::CollectClassesVisitor {
       if (app_class_table != nullptr) {
         ReaderMutexLock lock(self, app_class_table->lock_);
         DCHECK_EQ(app_class_table->classes_.size(), 1u);
-        const ClassTable::ClassSet& app_class_set = app_class_table->classes_[0];
+        const ClassTable::ClassSet& app_class_set = app_class_table->classes_.front();
         DCHECK_GE(app_class_set.size(), image_info.class_table_size_);
         boot_image_classes.reserve(app_class_set.size() - image_info.class_table_size_);
         for (const ClassTable::TableSlot& slot : app_class_set) {
@@ -3058,7 +3068,7 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
       MutexLock lock(Thread::Current(), *Locks::intern_table_lock_);
       CHECK(!temp_intern_table.strong_interns_.tables_.empty());
       // The UnorderedSet was inserted at the beginning.
-      CHECK_EQ(temp_intern_table.strong_interns_.tables_[0].Size(), intern_table.size());
+      CHECK_EQ(temp_intern_table.strong_interns_.tables_.front().Size(), intern_table.size());
     }
   }
 
@@ -3087,7 +3097,7 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
       ReaderMutexLock lock(Thread::Current(), temp_class_table.lock_);
       CHECK(!temp_class_table.classes_.empty());
       // The ClassSet was inserted at the beginning.
-      CHECK_EQ(temp_class_table.classes_[0].size(), table.size());
+      CHECK_EQ(temp_class_table.classes_.front().size(), table.size());
     }
   }
 }
@@ -3155,7 +3165,9 @@ inline Object* ImageWriter::CopyObject(Object* obj) {
   DCHECK_LT(offset, image_info.image_end_);
   const auto* src = reinterpret_cast<const uint8_t*>(obj);
 
-  bool done = image_info.image_bitmap_.Set(dst);  // Mark the obj as live.
+  // Mark the obj as live. Objects may be copied in parallel, so use an atomic update
+  // for bitmap words shared with other objects.
+  bool done = image_info.image_bitmap_.AtomicTestAndSet(dst);
   // Check if the object was already copied, unless the caller indicated that it was not.
   if (kCheckIfDone && done) {
     return nullptr;
@@ -3226,7 +3238,7 @@ class ImageWriter::FixupVisitor {
   mirror::Object* const copy_;
 };
 
-void ImageWriter::CopyAndFixupObjects() {
+void ImageWriter::CopyAndFixupObjects(ThreadPool* thread_pool) {
   // Copy and fix up pointer arrays first as they require special treatment.
   auto method_pointer_array_visitor =
       [&](ObjPtr<mirror::PointerArray> pointer_array) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -3249,11 +3261,38 @@ void ImageWriter::CopyAndFixupObjects() {
     }
   }
 
-  auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
-    DCHECK(obj != nullptr);
-    CopyAndFixupObject(obj);
-  };
-  Runtime::Current()->GetHeap()->VisitObjects(visitor);
+  if (thread_pool == nullptr) {
+    auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+      DCHECK(obj != nullptr);
+      CopyAndFixupObject(obj);
+    };
+    Runtime::Current()->GetHeap()->VisitObjects(visitor);
+  } else {
+    // Each object is copied to the location assigned by CalculateNewObjectOffsets() and
+    // only its own copy is fixed up, so the output does not depend on the order in which
+    // objects are processed. Collect the objects and process them in parallel chunks.
+    dchecked_vector<Object*> objects;
+    auto collect_visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+      DCHECK(obj != nullptr);
+      if (IsImageBinSlotAssigned(obj)) {
+        objects.push_back(obj);
+      }
+    };
+    Runtime::Current()->GetHeap()->VisitObjects(collect_visitor);
+    static constexpr size_t kObjectsPerTask = 4096u;
+    Thread* const self = Thread::Current();
+    for (size_t begin = 0; begin < objects.size(); begin += kObjectsPerTask) {
+      size_t end = std::min(begin + kObjectsPerTask, objects.size());
+      thread_pool->AddTask(self, new FunctionTask([this, &objects, begin, end](Thread* worker) {
+        ScopedObjectAccess soa(worker);
+        ScopedDebugDisallowReadBarriers sddrb(worker);
+        for (size_t i = begin; i != end; ++i) {
+          CopyAndFixupObject(objects[i]);
+        }
+      }));
+    }
+    thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+  }
 
   // Fill the padding objects since they are required for in order traversal of the image space.
   for (ImageInfo& image_info : image_infos_) {
@@ -3551,9 +3590,14 @@ void ImageWriter::CopyAndFixupMethod(ArtMethod* orig,
       // TODO: handle fixup of single-implementation method for abstract method.
       access_flags = ArtMethod::SetHasSingleImplementation(access_flags, /*single_impl=*/ false);
       copy->SetSingleImplementation(nullptr, target_ptr_size_);
-    } else if (mark_memory_shared_methods_ && LIKELY(!ArtMethod::IsIntrinsic(access_flags))) {
-      access_flags = ArtMethod::SetMemorySharedMethod(access_flags);
-      copy->SetHotCounter();
+    } else if (LIKELY(!ArtMethod::IsIntrinsic(access_flags))) {
+      // The single-implementation info computed by CHA in the compiler is only valid for the
+      // classes loaded by the compiler and is not recomputed for image classes at runtime.
+      access_flags = ArtMethod::SetHasSingleImplementation(access_flags, /*single_impl=*/ false);
+      if (mark_memory_shared_methods_) {
+        access_flags = ArtMethod::SetMemorySharedMethod(access_flags);
+        copy->SetHotCounter();
+      }
     }
 
     InstructionSet isa = compiler_options_.GetInstructionSet();
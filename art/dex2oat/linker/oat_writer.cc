@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "arch/arm64/instruction_set_features_arm64.h"
@@ -901,6 +902,11 @@ class OatWriter::InitOatClassesMethodVisitor : public DexMethodVisitor {
 //
 // See also OrderedMethodVisitor.
 struct OatWriter::OrderedMethodData {
+  // Values for `hotness_bits`.
+  static constexpr uint32_t kStartupBit = 4u;
+  static constexpr uint32_t kHotBit = 2u;
+  static constexpr uint32_t kPostStartupBit = 1u;
+
   uint32_t hotness_bits;
   OatClass* oat_class;
   CompiledMethod* compiled_method;
@@ -1070,16 +1076,16 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
         // Note: Bin-to-bin order does not matter. If the kernel does or does not read-ahead
         // any memory, it only goes into the buffer cache and does not grow the PSS until the
         // first time that memory is referenced in the process.
-        constexpr uint32_t kStartupBit = 4u;
-        constexpr uint32_t kHotBit = 2u;
-        constexpr uint32_t kPostStartupBit = 1u;
         hotness_bits =
-            (pci->IsHotMethod(profile_index_, method_index) ? kHotBit : 0u) |
-            (pci->IsStartupMethod(profile_index_, method_index) ? kStartupBit : 0u) |
-            (pci->IsPostStartupMethod(profile_index_, method_index) ? kPostStartupBit : 0u);
+            (pci->IsHotMethod(profile_index_, method_index)
+                ? OrderedMethodData::kHotBit : 0u) |
+            (pci->IsStartupMethod(profile_index_, method_index)
+                ? OrderedMethodData::kStartupBit : 0u) |
+            (pci->IsPostStartupMethod(profile_index_, method_index)
+                ? OrderedMethodData::kPostStartupBit : 0u);
         if (kIsDebugBuild) {
           // Check for bins that are always-empty given a real profile.
-          if (hotness_bits == kHotBit) {
+          if (hotness_bits == OrderedMethodData::kHotBit) {
             // This is not fatal, so only warn.
             LOG(WARNING) << "Method " << method_ref.PrettyMethod() << " was hot but wasn't marked "
                          << "either start-up or post-startup. Possible corrupted profile?";
@@ -2370,6 +2376,13 @@ size_t OatWriter::InitOatCodeDexFiles(size_t offset) {
                   << ordered_method.hotness_bits;
       }
     }
+
+    if (profile_compilation_info_ != nullptr) {
+      RecordStartupCodeEnd();
+      if (VLOG_IS_ON(compiler)) {
+        DumpCodeLayoutStats();
+      }
+    }
   }
 
   if (HasImage()) {
@@ -2385,6 +2398,69 @@ size_t OatWriter::InitOatCodeDexFiles(size_t offset) {
   return offset;
 }
 
+// Report the number of code pages touched by the startup and hot methods, to
+// evaluate the profile-guided code layout. Fewer pages mean fewer page faults
+// during app startup.
+void OatWriter::DumpCodeLayoutStats() const {
+  DCHECK(ordered_methods_ != nullptr);
+  std::set<size_t> startup_pages;
+  std::set<size_t> hot_pages;
+  std::set<size_t> all_pages;
+  size_t num_startup_methods = 0u;
+  size_t num_hot_methods = 0u;
+  for (const OrderedMethodData& method_data : *ordered_methods_) {
+    uint32_t quick_code_offset = relative_patcher_->GetOffset(method_data.method_reference);
+    if (quick_code_offset == 0u) {
+      continue;
+    }
+    // Include the method header, which is read when walking the stack.
+    uint32_t code_offset =
+        quick_code_offset - method_data.compiled_method->GetEntryPointAdjustment();
+    size_t code_size = method_data.compiled_method->GetQuickCode().size();
+    size_t first_page = (code_offset - sizeof(OatQuickMethodHeader)) / kMinPageSize;
+    size_t last_page = (code_offset + code_size - 1u) / kMinPageSize;
+    bool is_startup = (method_data.hotness_bits & OrderedMethodData::kStartupBit) != 0u;
+    bool is_hot = (method_data.hotness_bits & OrderedMethodData::kHotBit) != 0u;
+    num_startup_methods += is_startup ? 1u : 0u;
+    num_hot_methods += is_hot ? 1u : 0u;
+    for (size_t page = first_page; page <= last_page; ++page) {
+      all_pages.insert(page);
+      if (is_startup) {
+        startup_pages.insert(page);
+      }
+      if (is_hot) {
+        hot_pages.insert(page);
+      }
+    }
+  }
+  VLOG(compiler) << "Code layout: " << num_startup_methods << " startup methods in "
+                 << startup_pages.size() << " pages, " << num_hot_methods << " hot methods in "
+                 << hot_pages.size() << " pages, " << all_pages.size() << " code pages total";
+}
+
+// Record the end of the code of the startup methods, which the profile-guided code layout
+// places first, so that the runtime can prefetch the startup code and let the rest of the
+// code be paged in on demand.
+void OatWriter::RecordStartupCodeEnd() {
+  DCHECK(ordered_methods_ != nullptr);
+  uint32_t startup_code_end = 0u;
+  for (const OrderedMethodData& method_data : *ordered_methods_) {
+    if ((method_data.hotness_bits & OrderedMethodData::kStartupBit) == 0u) {
+      continue;
+    }
+    uint32_t quick_code_offset = relative_patcher_->GetOffset(method_data.method_reference);
+    if (quick_code_offset == 0u) {
+      continue;
+    }
+    uint32_t code_offset =
+        quick_code_offset - method_data.compiled_method->GetEntryPointAdjustment();
+    uint32_t code_size = dchecked_integral_cast<uint32_t>(
+        method_data.compiled_method->GetQuickCode().size());
+    startup_code_end = std::max(startup_code_end, code_offset + code_size);
+  }
+  oat_header_->SetStartupCodeEndOffset(startup_code_end);
+}
+
 size_t OatWriter::InitDataImgRelRoLayout(size_t offset) {
   DCHECK_EQ(data_img_rel_ro_size_, 0u);
   if (boot_image_rel_ro_entries_.empty() &&
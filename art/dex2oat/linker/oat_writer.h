@@ -301,6 +301,8 @@ class OatWriter {
   size_t InitBcpBssInfo(size_t offset);
   size_t InitOatCode(size_t offset);
   size_t InitOatCodeDexFiles(size_t offset);
+  void RecordStartupCodeEnd();
+  void DumpCodeLayoutStats() const;
   size_t InitDataImgRelRoLayout(size_t offset);
   void InitBssLayout(InstructionSet instruction_set);
 
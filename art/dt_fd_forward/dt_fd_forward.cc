@@ -480,32 +480,49 @@ class PacketReader {
       return false;
     }
     pkt_->type.cmd.len = len;
-    pkt_->type.cmd.id = ReadInt32();
-    pkt_->type.cmd.flags = ReadByte();
-    if (is_err_) {
-      return false;
-    } else if (is_eof_) {
-      return true;
-    } else if ((pkt_->type.reply.flags & JDWPTRANSPORT_FLAGS_REPLY) == JDWPTRANSPORT_FLAGS_REPLY) {
-      ReadReplyPacket();
+    // Read the rest of the header at once, instead of one field at a time: the id and flags are
+    // followed by the error code of a reply, or the command set and command of a command.
+    uint8_t header[kHeaderRestLen];
+    if (!ReadBytes(header, sizeof(header))) {
+      return !is_err_;
+    }
+    int32_t id;
+    memcpy(&id, header, sizeof(id));
+    pkt_->type.cmd.id = NetworkToHost(id);
+    pkt_->type.cmd.flags = NetworkToHost(static_cast<int8_t>(header[sizeof(id)]));
+    if ((pkt_->type.reply.flags & JDWPTRANSPORT_FLAGS_REPLY) == JDWPTRANSPORT_FLAGS_REPLY) {
+      ReadReplyPacket(header + sizeof(id) + 1u);
     } else {
-      ReadCmdPacket();
+      ReadCmdPacket(header + sizeof(id) + 1u);
     }
     return !is_err_;
   }
 
  private:
-  void ReadReplyPacket() {
-    pkt_->type.reply.errorCode = ReadInt16();
+  // The length of the header after the 4-byte length.
+  static constexpr size_t kHeaderRestLen = 11u - sizeof(int32_t);
+
+  void ReadReplyPacket(const uint8_t* header_end) {
+    int16_t error_code;
+    memcpy(&error_code, header_end, sizeof(error_code));
+    pkt_->type.reply.errorCode = NetworkToHost(error_code);
     pkt_->type.reply.data = ReadRemaining();
   }
 
-  void ReadCmdPacket() {
-    pkt_->type.cmd.cmdSet = ReadByte();
-    pkt_->type.cmd.cmd = ReadByte();
+  void ReadCmdPacket(const uint8_t* header_end) {
+    pkt_->type.cmd.cmdSet = NetworkToHost(static_cast<int8_t>(header_end[0]));
+    pkt_->type.cmd.cmd = NetworkToHost(static_cast<int8_t>(header_end[1]));
     pkt_->type.cmd.data = ReadRemaining();
   }
 
+  bool ReadBytes(void* out, size_t size) {
+    if (is_eof_ || is_err_) {
+      return false;
+    }
+    IOResult res = transport_->ReadFully(out, size);
+    return HandleResult(res, false, [] { return true; });
+  }
+
   // `produceVal` is a function which produces the success value. It'd be a bit
   // syntactically simpler to simply take a `T success`, but doing so invites
   // the possibility of operating on uninitalized data, since we often want to
@@ -555,24 +572,6 @@ class PacketReader {
     }
   }
 
-  jbyte ReadByte() {
-    if (is_eof_ || is_err_) {
-      return -1;
-    }
-    jbyte out;
-    IOResult res = transport_->ReadFully(&out, sizeof(out));
-    return HandleResult(res, static_cast<jbyte>(-1), [&] { return NetworkToHost(out); });
-  }
-
-  jshort ReadInt16() {
-    if (is_eof_ || is_err_) {
-      return -1;
-    }
-    jshort out;
-    IOResult res = transport_->ReadFully(&out, sizeof(out));
-    return HandleResult(res, static_cast<jshort>(-1), [&] { return NetworkToHost(out); });
-  }
-
   jint ReadInt32() {
     if (is_eof_ || is_err_) {
       return -1;
@@ -607,6 +606,8 @@ class PacketWriter {
       : transport_(transport), pkt_(pkt), data_() {}
 
   bool WriteFully() {
+    // Build the packet with a single allocation, it is written with a single write below.
+    data_.reserve(static_cast<size_t>(pkt_->type.cmd.len));
     PushInt32(pkt_->type.cmd.len);
     PushInt32(pkt_->type.cmd.id);
     PushByte(pkt_->type.cmd.flags);
@@ -25,6 +25,7 @@ class SortType(Enum):
   NONE = 'none'
   SIMPLE = 'simple'
   OPT_NEIGHBOURS = 'opt_neighbours'
+  PROBABILITY = 'probability'
 
 
 def merge_same_procnames(entries):
@@ -65,6 +66,19 @@ def opt_neighbours(sort_keys):
   return res
 
 
+def by_probability(sort_keys):
+  # Objects dirty in all processes first, then objects dirty in fewer and fewer
+  # processes. Within the same process count, keep bins with similar usage
+  # patterns next to each other.
+  res = list()
+  by_count = defaultdict(list)
+  for key, objs in sort_keys:
+    by_count[key.bit_count()].append((key, objs))
+  for count in sorted(by_count.keys(), reverse=True):
+    res.extend(opt_neighbours(by_count[count]))
+  return res
+
+
 def process_dirty_entries(entries, sort_type):
   dirty_image_objects = []
 
@@ -93,6 +107,8 @@ def process_dirty_entries(entries, sort_type):
 
   if sort_type == SortType.OPT_NEIGHBOURS:
     sort_keys = opt_neighbours(sort_keys)
+  elif sort_type == SortType.PROBABILITY:
+    sort_keys = by_probability(sort_keys)
 
   dirty_obj_lines = list()
   for idx, (_, objs) in enumerate(sort_keys):
@@ -121,7 +137,9 @@ def main():
       help=(
           'Object sorting type. "simple" puts objects with the same usage'
           ' pattern in the same bins. "opt_neighbours" also tries to put bins'
-          ' with similar usage patterns close to each other.'
+          ' with similar usage patterns close to each other. "probability" puts'
+          ' objects dirty in all processes first, followed by objects dirty in'
+          ' fewer processes, so that rarely dirtied objects share pages.'
       ),
   )
   parser.add_argument(
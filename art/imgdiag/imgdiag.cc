@@ -21,6 +21,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <functional>
 #include <map>
 #include <optional>
@@ -31,6 +32,7 @@
 #include <vector>
 
 #include "android-base/stringprintf.h"
+#include "android-base/strings.h"
 #include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "base/array_ref.h"
@@ -1269,6 +1271,42 @@ class RegionData : public RegionSpecializedBase<T> {
   DISALLOW_COPY_AND_ASSIGN(RegionData);
 };
 
+// Return suffix of the file path after the last /. (e.g. /foo/bar -> bar, bar -> bar)
+std::string BaseName(const std::string& str) {
+  size_t idx = str.rfind('/');
+  if (idx == std::string::npos) {
+    return str;
+  }
+
+  return str.substr(idx + 1);
+}
+
+// Return the image location, stripped of any directories, e.g. "boot.art"
+std::string GetImageLocationBaseName(const std::string& image_location) {
+  return BaseName(std::string(image_location));
+}
+
+// Find the writable memory map for the boot image component `image_location_base_name`.
+std::optional<android::procinfo::MapInfo> FindBootImageMap(
+    const std::vector<android::procinfo::MapInfo>& maps,
+    const std::string& image_location_base_name) {
+  for (const android::procinfo::MapInfo& map_info : maps) {
+    // The map name ends with ']' if it's an anonymous memmap. We need to special case that
+    // to find the boot image map in some cases.
+    if (map_info.name.ends_with(image_location_base_name) ||
+        map_info.name.ends_with(image_location_base_name + "]")) {
+      if ((map_info.flags & PROT_WRITE) != 0) {
+        return map_info;
+      }
+      // In actuality there's more than 1 map, but the second one is read-only.
+      // The one we care about is the write-able map.
+      // The readonly maps are guaranteed to be identical, so its not interesting to compare
+      // them.
+    }
+  }
+  return std::nullopt;
+}
+
 }  // namespace
 
 
@@ -1539,22 +1577,12 @@ class ImgDiagDumper {
                              const std::vector<android::procinfo::MapInfo>& maps,
                              const char* tag) -> std::optional<android::procinfo::MapInfo> {
       // Find the memory map for the current boot image component.
-      for (const android::procinfo::MapInfo& map_info : maps) {
-        // The map name ends with ']' if it's an anonymous memmap. We need to special case that
-        // to find the boot image map in some cases.
-        if (map_info.name.ends_with(image_location_base_name) ||
-            map_info.name.ends_with(image_location_base_name + "]")) {
-          if ((map_info.flags & PROT_WRITE) != 0) {
-            return map_info;
-          }
-          // In actuality there's more than 1 map, but the second one is read-only.
-          // The one we care about is the write-able map.
-          // The readonly maps are guaranteed to be identical, so its not interesting to compare
-          // them.
-        }
+      std::optional<android::procinfo::MapInfo> map_info =
+          FindBootImageMap(maps, image_location_base_name);
+      if (!map_info) {
+        os << "Could not find map for " << image_location_base_name << " in " << tag;
       }
-      os << "Could not find map for " << image_location_base_name << " in " << tag;
-      return std::nullopt;
+      return map_info;
     };
 
     // Find the current boot image mapping.
@@ -1775,21 +1803,6 @@ class ImgDiagDumper {
     }
   }
 
-  // Return suffix of the file path after the last /. (e.g. /foo/bar -> bar, bar -> bar)
-  static std::string BaseName(const std::string& str) {
-    size_t idx = str.rfind('/');
-    if (idx == std::string::npos) {
-      return str;
-    }
-
-    return str.substr(idx + 1);
-  }
-
-  // Return the image location, stripped of any directories, e.g. "boot.art"
-  static std::string GetImageLocationBaseName(const std::string& image_location) {
-    return BaseName(std::string(image_location));
-  }
-
   std::ostream* os_;
   pid_t image_diff_pid_;  // Dump image diff against boot.art if pid is non-negative
   pid_t zygote_diff_pid_;  // Dump image diff against zygote boot.art if pid is non-negative
@@ -1818,15 +1831,274 @@ class ImgDiagDumper {
   DISALLOW_COPY_AND_ASSIGN(ImgDiagDumper);
 };
 
+// Aggregates the dirty objects of the boot image over several processes forked from the same
+// zygote, e.g. all the zygote children, in a single run.
+//
+// The image objects are decoded once per image and shared by all the processes. For each
+// process, the page frame numbers of the whole boot image mapping are read with a single pread
+// of /proc/<pid>/pagemap, and the page counts of the pages that are not shared with the zygote
+// with bulk reads of /proc/kpagecount. Only the objects on these pages are compared.
+class MultiProcessImgDiagDumper {
+ public:
+  MultiProcessImgDiagDumper(std::ostream* os,
+                            pid_t zygote_diff_pid,
+                            const std::vector<pid_t>& image_diff_pids)
+      : os_(os),
+        zygote_diff_pid_(zygote_diff_pid),
+        image_diff_pids_(image_diff_pids) {}
+
+  bool Init() {
+    kpagecount_file_.reset(OS::OpenFileForReading("/proc/kpagecount"));
+    if (kpagecount_file_ == nullptr) {
+      *os_ << "Failed to open /proc/kpagecount for reading";
+      return false;
+    }
+    return true;
+  }
+
+  bool Dump(const ImageHeader& image_header, const std::string& image_location)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    std::ostream& os = *os_;
+    os << "IMAGE LOCATION: " << image_location << "\n\n";
+
+    const std::string image_location_base_name = GetImageLocationBaseName(image_location);
+    const size_t page_size = MemMap::GetPageSize();
+    const size_t image_size = RoundUp(image_header.GetImageSize(), page_size);
+
+    ProcessImage zygote_image;
+    if (!ReadProcessImage(zygote_diff_pid_, image_location_base_name, image_size, &zygote_image)) {
+      return false;
+    }
+
+    DecodeObjects(image_header);
+
+    std::vector<ClassDirtyData> class_data(class_descriptors_.size());
+    // The index in `image_diff_pids_` of the last process with a dirty object of the class.
+    std::vector<size_t> class_last_process(class_descriptors_.size(), image_diff_pids_.size());
+    ProcessImage image;
+    std::vector<bool> page_dirty(image_size / page_size);
+    std::vector<uint64_t> dirty_page_frame_numbers;
+    std::vector<uint64_t> dirty_page_counts;
+    std::string error_msg;
+    for (size_t process = 0; process != image_diff_pids_.size(); ++process) {
+      pid_t pid = image_diff_pids_[process];
+      if (!ReadProcessImage(pid, image_location_base_name, image_size, &image)) {
+        return false;
+      }
+      if (image.map_start != zygote_image.map_start) {
+        os << "Boot map of " << pid << " does not match the zygote boot map: "
+           << "zygote begin " << reinterpret_cast<const void*>(zygote_image.map_start)
+           << ", image begin " << reinterpret_cast<const void*>(image.map_start);
+        return false;
+      }
+
+      // A page is dirty if the process has its own copy of it.
+      dirty_page_frame_numbers.clear();
+      for (size_t i = 0; i != page_dirty.size(); ++i) {
+        page_dirty[i] = image.page_frame_numbers[i] != zygote_image.page_frame_numbers[i] &&
+                        image.page_frame_numbers[i] != 0u;
+        if (page_dirty[i]) {
+          dirty_page_frame_numbers.push_back(image.page_frame_numbers[i]);
+        }
+      }
+      size_t private_dirty_pages = 0;
+      if (!dirty_page_frame_numbers.empty()) {
+        dirty_page_counts.resize(dirty_page_frame_numbers.size());
+        if (!GetPageFlagsOrCounts(*kpagecount_file_,
+                                  ArrayRef<const uint64_t>(dirty_page_frame_numbers),
+                                  ArrayRef<uint64_t>(dirty_page_counts),
+                                  error_msg)) {
+          os << error_msg;
+          return false;
+        }
+        private_dirty_pages = static_cast<size_t>(
+            std::count(dirty_page_counts.begin(), dirty_page_counts.end(), 1u));
+      }
+
+      size_t dirty_objects = 0;
+      for (const ImageObject& object : objects_) {
+        size_t first_page = object.offset / page_size;
+        size_t last_page = (object.offset + object.size - 1u) / page_size;
+        bool on_dirty_page = false;
+        for (size_t page = first_page; page <= last_page && !on_dirty_page; ++page) {
+          on_dirty_page = page_dirty[page];
+        }
+        if (!on_dirty_page ||
+            memcmp(&image.contents[object.offset],
+                   &zygote_image.contents[object.offset],
+                   object.size) == 0) {
+          continue;
+        }
+        ++dirty_objects;
+        ClassDirtyData& data = class_data[object.class_index];
+        ++data.dirty_objects;
+        data.dirty_bytes += object.size;
+        if (class_last_process[object.class_index] != process) {
+          class_last_process[object.class_index] = process;
+          ++data.processes;
+        }
+      }
+      os << "PID " << pid << ": " << dirty_page_frame_numbers.size() << " dirty pages, "
+         << private_dirty_pages << " private dirty pages, " << dirty_objects
+         << " dirty objects\n";
+    }
+
+    std::vector<size_t> sorted_classes;
+    for (size_t i = 0; i != class_data.size(); ++i) {
+      if (class_data[i].dirty_objects != 0u) {
+        sorted_classes.push_back(i);
+      }
+    }
+    std::sort(sorted_classes.begin(), sorted_classes.end(), [&](size_t lhs, size_t rhs) {
+      if (class_data[lhs].dirty_bytes != class_data[rhs].dirty_bytes) {
+        return class_data[lhs].dirty_bytes > class_data[rhs].dirty_bytes;
+      }
+      return class_descriptors_[lhs] < class_descriptors_[rhs];
+    });
+    os << "\n" << sorted_classes.size() << " classes with dirty objects in "
+       << image_diff_pids_.size() << " processes:\n";
+    for (size_t i : sorted_classes) {
+      const ClassDirtyData& data = class_data[i];
+      os << StringPrintf("%12zu bytes %8zu objects %4zu processes  ",
+                         data.dirty_bytes,
+                         data.dirty_objects,
+                         data.processes)
+         << class_descriptors_[i] << "\n";
+    }
+    os << "\n" << std::flush;
+    return true;
+  }
+
+ private:
+  // An object of the local image, relative to the beginning of the image.
+  struct ImageObject {
+    uint32_t offset;
+    uint32_t size;
+    uint32_t class_index;
+  };
+
+  struct ClassDirtyData {
+    size_t dirty_objects = 0;
+    size_t dirty_bytes = 0;
+    size_t processes = 0;
+  };
+
+  // The boot image mapping of a remote process.
+  struct ProcessImage {
+    uintptr_t map_start = 0;
+    std::vector<uint8_t> contents;
+    std::vector<uint64_t> page_frame_numbers;
+  };
+
+  void DecodeObjects(const ImageHeader& image_header) REQUIRES_SHARED(Locks::mutator_lock_) {
+    objects_.clear();
+    class_descriptors_.clear();
+    std::unordered_map<mirror::Class*, uint32_t> class_indexes;
+    uint8_t* image_begin = image_header.GetImageBegin();
+    ImgObjectVisitor visitor([&](mirror::Object* object) REQUIRES_SHARED(Locks::mutator_lock_) {
+      mirror::Class* klass = object->GetClass<kVerifyNone, kWithoutReadBarrier>().Ptr();
+      auto [it, inserted] =
+          class_indexes.emplace(klass, dchecked_integral_cast<uint32_t>(class_indexes.size()));
+      if (inserted) {
+        class_descriptors_.push_back(GetClassDescriptor(klass));
+      }
+      objects_.push_back(ImageObject{
+          dchecked_integral_cast<uint32_t>(reinterpret_cast<uint8_t*>(object) - image_begin),
+          dchecked_integral_cast<uint32_t>(EntrySize(object)),
+          it->second});
+    });
+    image_header.VisitObjects(&visitor, image_begin, image_header.GetPointerSize());
+  }
+
+  bool ReadProcessImage(pid_t pid,
+                        const std::string& image_location_base_name,
+                        size_t image_size,
+                        /*out*/ ProcessImage* image) {
+    std::ostream& os = *os_;
+    std::vector<android::procinfo::MapInfo> proc_maps;
+    if (!android::procinfo::ReadProcessMaps(pid, &proc_maps)) {
+      os << "Could not read process maps for " << pid;
+      return false;
+    }
+    std::optional<android::procinfo::MapInfo> boot_map =
+        FindBootImageMap(proc_maps, image_location_base_name);
+    if (!boot_map) {
+      os << "Could not find map for " << image_location_base_name << " in " << pid;
+      return false;
+    }
+    image->map_start = boot_map->start;
+
+    std::string mem_file_name =
+        StringPrintf("/proc/%ld/mem", static_cast<long>(pid));  // NOLINT [runtime/int]
+    std::unique_ptr<File> mem_file(OS::OpenFileForReading(mem_file_name.c_str()));
+    image->contents.resize(image_size);
+    if (mem_file == nullptr ||
+        !mem_file->PreadFully(image->contents.data(), image_size, boot_map->start)) {
+      os << "Could not fully read file " << mem_file_name;
+      return false;
+    }
+
+    std::string pagemap_file_name =
+        StringPrintf("/proc/%ld/pagemap", static_cast<long>(pid));  // NOLINT [runtime/int]
+    std::unique_ptr<File> pagemap_file(OS::OpenFileForReading(pagemap_file_name.c_str()));
+    if (pagemap_file == nullptr) {
+      os << "Failed to open " << pagemap_file_name << " for reading";
+      return false;
+    }
+    image->page_frame_numbers.resize(image_size / MemMap::GetPageSize());
+    std::string error_msg;
+    if (!GetPageFrameNumbers(*pagemap_file,
+                             boot_map->start / MemMap::GetPageSize(),
+                             ArrayRef<uint64_t>(image->page_frame_numbers),
+                             error_msg)) {
+      os << error_msg;
+      return false;
+    }
+    return true;
+  }
+
+  std::ostream* os_;
+  const pid_t zygote_diff_pid_;
+  const std::vector<pid_t> image_diff_pids_;
+
+  // A File for reading /proc/kpagecount.
+  std::unique_ptr<File> kpagecount_file_;
+
+  // The objects of the current image, in address order, and the descriptors of their classes.
+  std::vector<ImageObject> objects_;
+  std::vector<std::string> class_descriptors_;
+
+  DISALLOW_COPY_AND_ASSIGN(MultiProcessImgDiagDumper);
+};
+
 static int DumpImage(Runtime* runtime,
                      std::ostream* os,
                      pid_t image_diff_pid,
                      pid_t zygote_diff_pid,
+                     const std::vector<pid_t>& image_diff_pids,
                      bool dump_dirty_objects) {
   ScopedObjectAccess soa(Thread::Current());
   gc::Heap* heap = runtime->GetHeap();
   const std::vector<gc::space::ImageSpace*>& image_spaces = heap->GetBootImageSpaces();
   CHECK(!image_spaces.empty());
+  if (!image_diff_pids.empty()) {
+    MultiProcessImgDiagDumper multi_process_dumper(os, zygote_diff_pid, image_diff_pids);
+    if (!multi_process_dumper.Init()) {
+      return EXIT_FAILURE;
+    }
+    for (gc::space::ImageSpace* image_space : image_spaces) {
+      const ImageHeader& image_header = image_space->GetImageHeader();
+      if (!image_header.IsValid()) {
+        fprintf(stderr, "Invalid image header %s\n", image_space->GetImageLocation().c_str());
+        return EXIT_FAILURE;
+      }
+      if (!multi_process_dumper.Dump(image_header, image_space->GetImageLocation())) {
+        return EXIT_FAILURE;
+      }
+    }
+    return EXIT_SUCCESS;
+  }
+
   ImgDiagDumper img_diag_dumper(os,
                                 image_diff_pid,
                                 zygote_diff_pid,
@@ -1891,6 +2163,17 @@ struct ImgDiagArgs : public CmdlineArgs {
         *error_msg = "Zygote diff pid out of range";
         return kParseError;
       }
+    } else if (option.starts_with("--image-diff-pids=")) {
+      std::vector<std::string> pids =
+          android::base::Split(std::string(option.substr(strlen("--image-diff-pids="))), ",");
+      for (const std::string& pid_str : pids) {
+        pid_t pid;
+        if (!android::base::ParseInt(pid_str, &pid)) {
+          *error_msg = "Image diff pid out of range: " + pid_str;
+          return kParseError;
+        }
+        image_diff_pids_.push_back(pid);
+      }
     } else if (option == "--dump-dirty-objects") {
       dump_dirty_objects_ = true;
     } else {
@@ -1909,8 +2192,19 @@ struct ImgDiagArgs : public CmdlineArgs {
 
     // Perform our own checks.
 
-    if (kill(image_diff_pid_,
-             /*sig*/0) != 0) {  // No signal is sent, perform error-checking only.
+    if (!image_diff_pids_.empty()) {
+      if (image_diff_pid_ != -1 || zygote_diff_pid_ < 0) {
+        *error_msg = "--image-diff-pids requires --zygote-diff-pid and excludes --image-diff-pid";
+        return kParseError;
+      }
+      for (pid_t pid : image_diff_pids_) {
+        if (kill(pid, /*sig*/0) != 0) {
+          *error_msg = StringPrintf("Process %d specified does not exist", pid);
+          return kParseError;
+        }
+      }
+    } else if (kill(image_diff_pid_,
+                    /*sig*/0) != 0) {  // No signal is sent, perform error-checking only.
       // Check if the pid exists before proceeding.
       if (errno == ESRCH) {
         *error_msg = "Process specified does not exist";
@@ -1945,6 +2239,10 @@ struct ImgDiagArgs : public CmdlineArgs {
         "  --zygote-diff-pid=<pid>: provide the PID of the zygote whose boot.art you want to diff "
         "against.\n"
         "      Example: --zygote-diff-pid=$(pid zygote)\n"
+        "  --image-diff-pids=<pid>,<pid>,...: diff the boot.art of all the given processes\n"
+        "      against the zygote given with --zygote-diff-pid, and print the dirty objects\n"
+        "      per class aggregated over all of them.\n"
+        "      Example: --image-diff-pids=$(pgrep -P $(pid zygote) | paste -sd,)\n"
         "  --dump-dirty-objects: additionally output dirty objects of interest.\n"
         "\n";
 
@@ -1954,6 +2252,7 @@ struct ImgDiagArgs : public CmdlineArgs {
  public:
   pid_t image_diff_pid_ = -1;
   pid_t zygote_diff_pid_ = -1;
+  std::vector<pid_t> image_diff_pids_;
   bool dump_dirty_objects_ = false;
 };
 
@@ -1965,6 +2264,7 @@ struct ImgDiagMain : public CmdlineMain<ImgDiagArgs> {
                      args_->os_,
                      args_->image_diff_pid_,
                      args_->zygote_diff_pid_,
+                     args_->image_diff_pids_,
                      args_->dump_dirty_objects_) == EXIT_SUCCESS;
   }
 };
@@ -77,23 +77,31 @@ class ImgDiagTest : public CommonRuntimeTest {
 
   // Run imgdiag with a custom boot image location.
   bool Exec(pid_t image_diff_pid, const std::string& boot_image, std::string* error_msg) {
+    // Run imgdiag --image-diff-pid=$image_diff_pid and wait until it's done with a 0 exit code.
+    return Exec({"--image-diff-pid=" + std::to_string(image_diff_pid),
+                 "--zygote-diff-pid=" + std::to_string(image_diff_pid)},
+                boot_image,
+                error_msg);
+  }
+
+  bool Exec(const std::vector<std::string>& pid_args,
+            const std::string& boot_image,
+            std::string* error_msg) {
     // Invoke 'img_diag' against the current process.
     // This should succeed because we have a runtime and so it should
     // be able to map in the boot.art and do a diff for it.
     std::string file_path = GetImgDiagFilePath();
     EXPECT_TRUE(OS::FileExists(file_path.c_str())) << file_path << " should be a valid file path";
 
-    // Run imgdiag --image-diff-pid=$image_diff_pid and wait until it's done with a 0 exit code.
-    std::vector<std::string> exec_argv = {
-        file_path,
-        "--image-diff-pid=" + std::to_string(image_diff_pid),
-        "--zygote-diff-pid=" + std::to_string(image_diff_pid),
+    std::vector<std::string> exec_argv = {file_path};
+    exec_argv.insert(exec_argv.end(), pid_args.begin(), pid_args.end());
+    exec_argv.insert(exec_argv.end(), {
         "--runtime-arg",
         GetClassPathOption("-Xbootclasspath:", GetLibCoreDexFileNames()),
         "--runtime-arg",
         GetClassPathOption("-Xbootclasspath-locations:", GetLibCoreDexLocations()),
         "--boot-image=" + boot_image
-    };
+    });
 
     return ::art::Exec(exec_argv, error_msg);
   }
@@ -103,6 +111,10 @@ class ImgDiagTest : public CommonRuntimeTest {
     return Exec(image_diff_pid, boot_image_location_, error_msg);
   }
 
+  bool ExecDefaultBootImage(const std::vector<std::string>& pid_args, std::string* error_msg) {
+    return Exec(pid_args, boot_image_location_, error_msg);
+  }
+
  private:
   std::string runtime_args_image_;
   std::string boot_image_location_;
@@ -128,6 +140,33 @@ TEST_F(ImgDiagTest, DISABLED_ImageDiffPidSelf) {
                                                           << error_msg;
 }
 
+#if defined (ART_TARGET)
+TEST_F(ImgDiagTest, ImageDiffPidsSelf) {
+#else
+// Can't run this test on the host, it will fail when trying to open /proc/kpagecount
+// because it's root read-only.
+TEST_F(ImgDiagTest, DISABLED_ImageDiffPidsSelf) {
+#endif
+  TEST_DISABLED_ON_VM();
+
+  // Run imgdiag --image-diff-pids=$(self pid),$(self pid) --zygote-diff-pid=$(self pid).
+  std::string self = std::to_string(getpid());
+  std::string error_msg;
+  ASSERT_TRUE(ExecDefaultBootImage(
+      {"--image-diff-pids=" + self + "," + self, "--zygote-diff-pid=" + self}, &error_msg))
+      << "Failed to execute -- because: " << error_msg;
+}
+
+TEST_F(ImgDiagTest, ImageDiffBadPids) {
+  // Run imgdiag --image-diff-pids=$(self pid),some_bad_pid. This should fail.
+  std::string self = std::to_string(getpid());
+  std::string error_msg;
+  ASSERT_FALSE(ExecDefaultBootImage(
+      {"--image-diff-pids=" + self + "," + std::to_string(kImgDiagGuaranteedBadPid),
+       "--zygote-diff-pid=" + self},
+      &error_msg)) << "Incorrectly executed";
+}
+
 TEST_F(ImgDiagTest, ImageDiffBadPid) {
   // Invoke 'img_diag' against a non-existing process. This should fail.
 
@@ -36,6 +36,8 @@ class Allocator {
 
   virtual void* Alloc(size_t) = 0;
   virtual void Free(void*) = 0;
+  // Free with the size of the allocation, for allocators that can reuse the memory.
+  virtual void Free(void* p, [[maybe_unused]] size_t size) { Free(p); }
 
  private:
   DISALLOW_COPY_AND_ASSIGN(Allocator);
@@ -19,12 +19,14 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <iomanip>
 #include <numeric>
 
 #include <android-base/logging.h>
 
 #include "mman.h"
+#include "utils.h"
 
 namespace art {
 
@@ -100,12 +102,14 @@ const char* const ArenaAllocatorStatsImpl<kCount>::kAllocNames[] = {
 template <bool kCount>
 ArenaAllocatorStatsImpl<kCount>::ArenaAllocatorStatsImpl()
     : num_allocations_(0u),
+      bytes_reused_(0u),
       alloc_stats_(kNumArenaAllocKinds, 0u) {
 }
 
 template <bool kCount>
 void ArenaAllocatorStatsImpl<kCount>::Copy(const ArenaAllocatorStatsImpl& other) {
   num_allocations_ = other.num_allocations_;
+  bytes_reused_ = other.bytes_reused_;
   std::copy_n(other.alloc_stats_.begin(), kNumArenaAllocKinds, alloc_stats_.begin());
 }
 
@@ -115,6 +119,11 @@ void ArenaAllocatorStatsImpl<kCount>::RecordAlloc(size_t bytes, ArenaAllocKind k
   ++num_allocations_;
 }
 
+template <bool kCount>
+void ArenaAllocatorStatsImpl<kCount>::RecordReuse(size_t bytes) {
+  bytes_reused_ += bytes;
+}
+
 template <bool kCount>
 size_t ArenaAllocatorStatsImpl<kCount>::NumAllocations() const {
   return num_allocations_;
@@ -126,6 +135,11 @@ size_t ArenaAllocatorStatsImpl<kCount>::BytesAllocated() const {
   return std::accumulate(alloc_stats_.begin(), alloc_stats_.end(), init);
 }
 
+template <bool kCount>
+size_t ArenaAllocatorStatsImpl<kCount>::BytesReused() const {
+  return bytes_reused_;
+}
+
 template <bool kCount>
 void ArenaAllocatorStatsImpl<kCount>::Dump(std::ostream& os, const Arena* first,
                                            ssize_t lost_bytes_adjustment) const {
@@ -142,7 +156,7 @@ void ArenaAllocatorStatsImpl<kCount>::Dump(std::ostream& os, const Arena* first,
   lost_bytes += lost_bytes_adjustment;
   const size_t bytes_allocated = BytesAllocated();
   os << " MEM: used: " << bytes_allocated << ", allocated: " << malloc_bytes
-     << ", lost: " << lost_bytes << "\n";
+     << ", lost: " << lost_bytes << ", reused: " << BytesReused() << "\n";
   size_t num_allocations = NumAllocations();
   if (num_allocations != 0) {
     os << "Number of arenas allocated: " << num_arenas << ", Number of allocations: "
@@ -198,12 +212,18 @@ size_t ArenaAllocator::BytesUsed() const {
   return total;
 }
 
+size_t ArenaPool::CurrentThreadShard() {
+  return GetTid() % kNumFreeArenaShards;
+}
+
 ArenaAllocator::ArenaAllocator(ArenaPool* pool)
   : pool_(pool),
     begin_(nullptr),
     end_(nullptr),
     ptr_(nullptr),
-    arena_head_(nullptr) {
+    arena_head_(nullptr),
+    free_lists_(0u),
+    free_list_heads_() {
 }
 
 void ArenaAllocator::UpdateBytesAllocated() {
@@ -312,6 +332,49 @@ uint8_t* ArenaAllocator::AllocFromNewArenaWithMemoryTool(size_t bytes) {
   return ret;
 }
 
+void ArenaAllocator::AddToFreeList(void* ptr, size_t bytes) {
+  DCHECK_ALIGNED(ptr, kAlignment);
+  DCHECK_ALIGNED(bytes, kAlignment);
+  DCHECK_GE(bytes, kMinFreeListBytes);
+  size_t size_class = std::min(static_cast<size_t>(MostSignificantBit(bytes)) - kMinFreeListShift,
+                               kNumFreeListClasses - 1u);
+  FreeBlock* block = reinterpret_cast<FreeBlock*>(ptr);
+  block->next = free_list_heads_[size_class];
+  block->size = bytes;
+  free_list_heads_[size_class] = block;
+  free_lists_ |= 1u << size_class;
+}
+
+void* ArenaAllocator::AllocFromFreeList(size_t bytes) {
+  DCHECK_GE(bytes, kMinFreeListBytes);
+  DCHECK_NE(free_lists_, 0u);
+  // Every block in the class of `bytes` rounded up to a power of two is big enough.
+  size_t size_class = MinimumBitsToStore(bytes - 1u) - kMinFreeListShift;
+  if (UNLIKELY(size_class >= kNumFreeListClasses)) {
+    return nullptr;
+  }
+  uint32_t candidates = free_lists_ & ~((1u << size_class) - 1u);
+  if (candidates == 0u) {
+    return nullptr;
+  }
+  size_class = CTZ(candidates);
+  FreeBlock* block = free_list_heads_[size_class];
+  DCHECK(block != nullptr);
+  free_list_heads_[size_class] = block->next;
+  if (block->next == nullptr) {
+    free_lists_ &= ~(1u << size_class);
+  }
+  size_t block_size = block->size;
+  DCHECK_GE(block_size, bytes);
+  uint8_t* ret = reinterpret_cast<uint8_t*>(block);
+  if (block_size - bytes >= kMinFreeListBytes) {
+    AddToFreeList(ret + bytes, block_size - bytes);
+  }
+  memset(ret, 0, bytes);
+  ArenaAllocatorStats::RecordReuse(bytes);
+  return ret;
+}
+
 bool ArenaAllocator::Contains(const void* ptr) const {
   if (ptr >= begin_ && ptr < end_) {
     return true;
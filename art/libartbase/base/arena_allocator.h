@@ -20,6 +20,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <mutex>
+
 #include "bit_utils.h"
 #include "debug_stack.h"
 #include "dchecked_vector.h"
@@ -40,6 +42,9 @@ class ArenaAllocatorAdapter;
 
 static constexpr bool kArenaAllocatorCountAllocations = false;
 
+// Reuse large blocks released with `ArenaAllocator::Free()` for later allocations.
+static constexpr bool kArenaAllocatorFreeLists = true;
+
 // Type of allocation for memory tuning.
 enum ArenaAllocKind {
   kArenaAllocMisc,
@@ -121,8 +126,10 @@ class ArenaAllocatorStatsImpl<false> {
 
   void Copy([[maybe_unused]] const ArenaAllocatorStatsImpl& other) {}
   void RecordAlloc([[maybe_unused]] size_t bytes, [[maybe_unused]] ArenaAllocKind kind) {}
+  void RecordReuse([[maybe_unused]] size_t bytes) {}
   size_t NumAllocations() const { return 0u; }
   size_t BytesAllocated() const { return 0u; }
+  size_t BytesReused() const { return 0u; }
   void Dump([[maybe_unused]] std::ostream& os,
             [[maybe_unused]] const Arena* first,
             [[maybe_unused]] ssize_t lost_bytes_adjustment) const {}
@@ -137,12 +144,15 @@ class ArenaAllocatorStatsImpl {
 
   void Copy(const ArenaAllocatorStatsImpl& other);
   void RecordAlloc(size_t bytes, ArenaAllocKind kind);
+  void RecordReuse(size_t bytes);
   size_t NumAllocations() const;
   size_t BytesAllocated() const;
+  size_t BytesReused() const;
   void Dump(std::ostream& os, const Arena* first, ssize_t lost_bytes_adjustment) const;
 
  private:
   size_t num_allocations_;
+  size_t bytes_reused_;  // Bytes of allocations served from the free lists.
   dchecked_vector<size_t> alloc_stats_;  // Bytes used by various allocation kinds.
 
   static const char* const kAllocNames[];
@@ -241,6 +251,18 @@ class ArenaPool {
  protected:
   ArenaPool() = default;
 
+  // Pools keep their free arenas in a few lists with separate locks. A thread returns arenas
+  // to the list of its shard and looks there first when allocating, so compiler threads that
+  // allocate and free arena chains at the same time mostly take different locks.
+  static constexpr size_t kNumFreeArenaShards = 8u;
+
+  struct FreeArenaShard {
+    Arena* free_arenas = nullptr;
+    mutable std::mutex lock;
+  };
+
+  static size_t CurrentThreadShard();
+
  private:
   DISALLOW_COPY_AND_ASSIGN(ArenaPool);
 };
@@ -271,6 +293,12 @@ class ArenaAllocator
     }
     bytes = RoundUp(bytes, kAlignment);
     ArenaAllocatorStats::RecordAlloc(bytes, kind);
+    if (kArenaAllocatorFreeLists && UNLIKELY(bytes >= kMinFreeListBytes) && free_lists_ != 0u) {
+      void* ret = AllocFromFreeList(bytes);
+      if (ret != nullptr) {
+        return ret;
+      }
+    }
     if (UNLIKELY(bytes > static_cast<size_t>(end_ - ptr_))) {
       return AllocFromNewArena(bytes);
     }
@@ -332,6 +360,22 @@ class ArenaAllocator
     return new_ptr;
   }
 
+  // Release memory from `Alloc()` that is no longer used. Blocks of at least
+  // `kMinFreeListBytes` are reused for later allocations of up to their size, smaller blocks
+  // stay unused until the allocator is destroyed. Only the `bytes` passed here are reused, so a
+  // smaller size than the allocated one is fine.
+  void Free(void* ptr, size_t bytes) {
+    if (!kArenaAllocatorFreeLists || UNLIKELY(IsRunningOnMemoryTool())) {
+      MakeInaccessible(ptr, bytes);
+      return;
+    }
+    // Only the full aligned units of the block are reusable.
+    bytes = RoundDown(bytes, kAlignment);
+    if (bytes >= kMinFreeListBytes) {
+      AddToFreeList(ptr, bytes);
+    }
+  }
+
   template <typename T>
   T* Alloc(ArenaAllocKind kind = kArenaAllocMisc) {
     return AllocArray<T>(1, kind);
@@ -381,7 +425,23 @@ class ArenaAllocator
   // Extra bytes required by the memory tool.
   static constexpr size_t kMemoryToolRedZoneBytes = 8u;
 
+  // The smallest block that `Free()` adds to the free lists.
+  static constexpr size_t kMinFreeListBytes = 256u;
+
  private:
+  // Free blocks are kept in power of two size classes. A class holds blocks of at least its
+  // size, and an allocation takes a block from the smallest class that fits it for sure.
+  static constexpr size_t kMinFreeListShift = WhichPowerOf2(kMinFreeListBytes);
+  static constexpr size_t kNumFreeListClasses = BitSizeOf<uint32_t>() - kMinFreeListShift;
+
+  struct FreeBlock {
+    FreeBlock* next;
+    size_t size;
+  };
+
+  void* AllocFromFreeList(size_t bytes);
+  void AddToFreeList(void* ptr, size_t bytes);
+
   void* AllocWithMemoryTool(size_t bytes, ArenaAllocKind kind);
   void* AllocWithMemoryToolAlign16(size_t bytes, ArenaAllocKind kind);
   uint8_t* AllocFromNewArena(size_t bytes);
@@ -394,6 +454,8 @@ class ArenaAllocator
   uint8_t* end_;
   uint8_t* ptr_;
   Arena* arena_head_;
+  uint32_t free_lists_;  // Bit mask of the non-empty size classes.
+  FreeBlock* free_list_heads_[kNumFreeListClasses];
 
   template <typename U>
   friend class ArenaAllocatorAdapter;
@@ -14,8 +14,12 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <cstring>
+
 #include "arena_allocator-inl.h"
 #include "arena_bit_vector.h"
+#include "arena_containers.h"
 #include "base/common_art_test.h"
 #include "gtest/gtest.h"
 #include "malloc_arena_pool.h"
@@ -349,5 +353,60 @@ TEST_F(ArenaAllocatorTest, ReallocAlignment) {
   }
 }
 
+TEST_F(ArenaAllocatorTest, FreeListReuse) {
+  // Freed memory is not reused when running under sanitization.
+  TEST_DISABLED_FOR_MEMORY_TOOL();
+  if (!kArenaAllocatorFreeLists) {
+    printf("WARNING: TEST DISABLED FOR disabled arena free lists\n");
+    return;
+  }
+  const size_t large_size = 4 * ArenaAllocator::kMinFreeListBytes;
+  MallocArenaPool pool;
+  ArenaAllocator allocator(&pool);
+
+  uint8_t* large = reinterpret_cast<uint8_t*>(allocator.Alloc(large_size));
+  memset(large, 0xff, large_size);
+  allocator.Free(large, large_size);
+  // A smaller allocation takes the start of the freed block, zeroed.
+  uint8_t* reused = reinterpret_cast<uint8_t*>(allocator.Alloc(large_size / 2));
+  EXPECT_EQ(large, reused);
+  EXPECT_TRUE(std::all_of(reused, reused + large_size / 2, [](uint8_t b) { return b == 0u; }));
+  // The rest of the block is still available.
+  uint8_t* rest = reinterpret_cast<uint8_t*>(allocator.Alloc(large_size / 2));
+  EXPECT_EQ(large + large_size / 2, rest);
+  EXPECT_TRUE(std::all_of(rest, rest + large_size / 2, [](uint8_t b) { return b == 0u; }));
+
+  // A block that is too small for the request is not used.
+  allocator.Free(rest, large_size / 2);
+  uint8_t* other = reinterpret_cast<uint8_t*>(allocator.Alloc(large_size));
+  EXPECT_NE(rest, other);
+  EXPECT_EQ(rest, allocator.Alloc(large_size / 2));
+
+  // Small blocks are not reused.
+  void* small = allocator.Alloc(ArenaAllocator::kMinFreeListBytes / 2);
+  allocator.Free(small, ArenaAllocator::kMinFreeListBytes / 2);
+  EXPECT_NE(small, allocator.Alloc(ArenaAllocator::kMinFreeListBytes / 2));
+}
+
+TEST_F(ArenaAllocatorTest, FreeListReuseFromVector) {
+  TEST_DISABLED_FOR_MEMORY_TOOL();
+  if (!kArenaAllocatorFreeLists) {
+    printf("WARNING: TEST DISABLED FOR disabled arena free lists\n");
+    return;
+  }
+  MallocArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  // Growing a vector frees the old storage, so the next growth can reuse it.
+  ArenaVector<uint32_t> vector(allocator.Adapter());
+  for (uint32_t i = 0; i != 64 * 1024u; ++i) {
+    vector.push_back(i);
+  }
+  const size_t used = allocator.BytesUsed();
+  const size_t storage_size = vector.capacity() * sizeof(uint32_t);
+  ArenaVector<uint32_t>(allocator.Adapter()).swap(vector);
+  // The freed storage serves later allocations without taking more arena memory.
+  allocator.Alloc(storage_size / 2);
+  EXPECT_EQ(used, allocator.BytesUsed());
+}
 
 }  // namespace art
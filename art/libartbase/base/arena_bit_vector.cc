@@ -69,6 +69,12 @@ class ArenaBitVectorAllocator final : public Allocator, private ArenaBitVectorAl
 
   void Free(void*) override {}  // Nop.
 
+  void Free(void* p, size_t size) override {
+    if constexpr (std::is_same_v<ArenaAlloc, ArenaAllocator>) {
+      allocator_->Free(p, size);
+    }
+  }
+
  private:
   ArenaBitVectorAllocator(ArenaAlloc* allocator, ArenaAllocKind kind)
       : ArenaBitVectorAllocatorKind(kind), allocator_(allocator) { }
@@ -204,7 +204,7 @@ class ArenaAllocatorAdapter : private ArenaAllocatorAdapterKind {
     return allocator_->AllocArray<T>(n, ArenaAllocatorAdapterKind::Kind());
   }
   void deallocate(pointer p, size_type n) {
-    allocator_->MakeInaccessible(p, sizeof(T) * n);
+    allocator_->Free(p, sizeof(T) * n);
   }
 
   template <typename U, typename... Args>
@@ -63,6 +63,11 @@ class BitMemoryRegion final : public ValueObject {
     return bit_size_;
   }
 
+  // Returns the absolute address of the first bit, which identifies the region in memory.
+  uintptr_t GetBitAddress() const {
+    return reinterpret_cast<uintptr_t>(data_) * kBitsPerByte + bit_start_;
+  }
+
   void Resize(size_t bit_size) {
     bit_size_ = bit_size;
   }
@@ -17,6 +17,7 @@
 #ifndef ART_LIBARTBASE_BASE_BIT_TABLE_H_
 #define ART_LIBARTBASE_BASE_BIT_TABLE_H_
 
+#include <algorithm>
 #include <array>
 #include <initializer_list>
 #include <numeric>
@@ -69,6 +70,37 @@ class BitTableBase {
     return table_data_.LoadBits(offset, NumColumnBits(column)) + kValueBias;
   }
 
+  // Load the `kCount` adjacent columns starting at `kFirstColumn`. If they fit in 64 bits, which
+  // is always the case for two columns, they are read with a single `LoadBits()`, that is one or
+  // two word loads, and split in registers instead of locating each column separately.
+  template <uint32_t kFirstColumn, uint32_t kCount>
+  ALWAYS_INLINE std::array<uint32_t, kCount> GetColumns(uint32_t row) const {
+    static_assert(kCount != 0u && kFirstColumn + kCount <= kNumColumns);
+    DCHECK(table_data_.IsValid()) << "Table has not been loaded";
+    DCHECK_LT(row, num_rows_);
+    std::array<uint32_t, kCount> values;
+    size_t offset = row * NumRowBits() + column_offset_[kFirstColumn];
+    size_t num_bits = column_offset_[kFirstColumn + kCount] - column_offset_[kFirstColumn];
+    if (kCount <= 2u || LIKELY(num_bits <= BitSizeOf<uint64_t>())) {
+      uint64_t bits = table_data_.LoadBits<uint64_t>(offset, num_bits);
+      for (uint32_t i = 0; i != kCount; ++i) {
+        uint32_t column_bits = NumColumnBits(kFirstColumn + i);
+        values[i] = static_cast<uint32_t>(bits & MaxInt<uint64_t>(column_bits)) + kValueBias;
+        bits >>= column_bits;
+      }
+    } else {
+      for (uint32_t i = 0; i != kCount; ++i) {
+        values[i] = Get(row, kFirstColumn + i);
+      }
+    }
+    return values;
+  }
+
+  // Load all columns of the row, see `GetColumns()`.
+  ALWAYS_INLINE std::array<uint32_t, kNumColumns> GetRowValues(uint32_t row) const {
+    return GetColumns<0u, kNumColumns>(row);
+  }
+
   ALWAYS_INLINE BitMemoryRegion GetBitMemoryRegion(uint32_t row, uint32_t column = 0) const {
     DCHECK(table_data_.IsValid()) << "Table has not been loaded";
     DCHECK_LT(row, num_rows_);
@@ -89,6 +121,8 @@ class BitTableBase {
 
   size_t DataBitSize() const { return table_data_.size_in_bits(); }
 
+  uintptr_t DataBitAddress() const { return table_data_.GetBitAddress(); }
+
   bool Equals(const BitTableBase& other) const {
     return num_rows_ == other.num_rows_ &&
         std::equal(column_offset_, column_offset_ + kNumColumns, other.column_offset_) &&
@@ -122,6 +156,11 @@ class BitTableAccessor {
     return this->table_ == other.table_ && this->row_ == other.row_;
   }
 
+  template <uint32_t kFirstColumn, uint32_t kCount>
+  ALWAYS_INLINE std::array<uint32_t, kCount> GetColumns() const {
+    return table_->template GetColumns<kFirstColumn, kCount>(row_);
+  }
+
 // Helper macro to create constructors and per-table utilities in derived class.
 #define BIT_TABLE_HEADER(NAME)                                                       \
   using BitTableAccessor<kNumColumns>::BitTableAccessor; /* inherit constructors */  \
@@ -336,6 +375,33 @@ class BitTableBuilderBase {
     return Dedup(&value, /* count */ 1);
   }
 
+  // Sort the rows into a canonical order, so that tables with the same set of rows are encoded
+  // identically regardless of the order in which the rows were added. This lets the encoded
+  // tables be shared across methods (see linker::CodeInfoTableDeduper). Only valid for tables
+  // whose rows are independent, i.e. not referenced as sequences. Fills `old_to_new` with the
+  // new index of each old row. The de-duplication data is cleared, so no rows can be added.
+  void SortRows(/*out*/ ScopedArenaVector<uint32_t>* old_to_new) {
+    ScopedArenaVector<uint32_t> order(size(), rows_.get_allocator());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t lhs, uint32_t rhs) {
+      for (uint32_t c = 0; c < kNumColumns; c++) {
+        if (rows_[lhs][c] != rows_[rhs][c]) {
+          return rows_[lhs][c] < rows_[rhs][c];
+        }
+      }
+      return false;
+    });
+    ScopedArenaVector<Entry> sorted_rows(rows_.get_allocator());
+    sorted_rows.reserve(size());
+    old_to_new->resize(size());
+    for (uint32_t old_index : order) {
+      (*old_to_new)[old_index] = sorted_rows.size();
+      sorted_rows.push_back(rows_[old_index]);
+    }
+    rows_.swap(sorted_rows);
+    dedup_.clear();
+  }
+
   // Calculate the column bit widths based on the current data.
   void Measure(/*out*/ uint32_t* column_bits) const {
     uint32_t max_column_value[kNumColumns];
@@ -23,6 +23,7 @@
 #include "base/arena_allocator.h"
 #include "base/bit_utils.h"
 #include "base/malloc_arena_pool.h"
+#include "base/time_utils.h"
 
 namespace art {
 
@@ -192,4 +193,82 @@ TEST(BitTableTest, TestCollisions) {
   EXPECT_EQ(2u, builder2.size());
 }
 
+TEST(BitTableTest, TestGetColumns) {
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+
+  // Rows of 7 + 32 + 0 + 17 + 32 bits. Two columns always fit in one load, all of them do not.
+  constexpr uint32_t kNoValue = -1;
+  for (size_t start_bit_offset = 0; start_bit_offset <= 64; start_bit_offset += 13) {
+    std::vector<uint8_t> buffer;
+    BitMemoryWriter<std::vector<uint8_t>> writer(&buffer, start_bit_offset);
+    BitTableBuilderBase<5> builder(&allocator);
+    for (uint32_t i = 0; i != 100u; ++i) {
+      uint32_t last = (i == 42u) ? kNoValue : ~i;
+      builder.Add({i, 0xfedcba98u - i, kNoValue, (i * 7919u) % 100000u, last});
+    }
+    builder.Encode(writer);
+
+    BitMemoryReader reader(buffer.data(), start_bit_offset);
+    BitTableBase<5> table(reader);
+    ASSERT_EQ(100u, table.NumRows());
+    ASSERT_EQ(7u, table.NumColumnBits(0));
+    ASSERT_EQ(32u, table.NumColumnBits(1));
+    ASSERT_EQ(32u, table.NumColumnBits(4));
+    for (uint32_t row = 0; row != table.NumRows(); ++row) {
+      std::array<uint32_t, 5> values = table.GetRowValues(row);
+      for (uint32_t column = 0; column != 5u; ++column) {
+        EXPECT_EQ(table.Get(row, column), values[column]) << row << " " << column;
+      }
+      std::array<uint32_t, 2> first = table.GetColumns<0, 2>(row);
+      EXPECT_EQ(table.Get(row, 0), first[0]);
+      EXPECT_EQ(table.Get(row, 1), first[1]);
+      std::array<uint32_t, 3> last = table.GetColumns<2, 3>(row);
+      EXPECT_EQ(kNoValue, last[0]);
+      EXPECT_EQ(table.Get(row, 3), last[1]);
+      EXPECT_EQ(table.Get(row, 4), last[2]);
+    }
+  }
+}
+
+// Compare reading two adjacent columns with `Get()` and with `GetColumns()`.
+TEST(BitTableTest, GetColumnsSpeed) {
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+
+  static constexpr uint32_t kNumRows = 1000u;
+  static constexpr uint32_t kPasses = 1000u;
+  std::vector<uint8_t> buffer;
+  BitMemoryWriter<std::vector<uint8_t>> writer(&buffer);
+  BitTableBuilderBase<3> builder(&allocator);
+  for (uint32_t i = 0; i != kNumRows; ++i) {
+    builder.Add({i % 3u, i * 4u, i});
+  }
+  builder.Encode(writer);
+  BitMemoryReader reader(buffer.data());
+  BitTableBase<3> table(reader);
+
+  uint64_t sum = 0u;
+  uint64_t start = NanoTime();
+  for (uint32_t pass = 0; pass != kPasses; ++pass) {
+    for (uint32_t row = 0; row != kNumRows; ++row) {
+      sum += table.Get(row, 0) ^ table.Get(row, 1);
+    }
+  }
+  uint64_t get_time = NanoTime() - start;
+  start = NanoTime();
+  for (uint32_t pass = 0; pass != kPasses; ++pass) {
+    for (uint32_t row = 0; row != kNumRows; ++row) {
+      auto [kind, pc] = table.GetColumns<0, 2>(row);
+      sum -= kind ^ pc;
+    }
+  }
+  uint64_t get_columns_time = NanoTime() - start;
+  EXPECT_EQ(0u, sum);
+  LOG(INFO) << "Get: " << PrettyDuration(get_time)
+            << ", GetColumns: " << PrettyDuration(get_columns_time);
+}
+
 }  // namespace art
@@ -58,7 +58,7 @@ BitVector::BitVector(const BitVector& src,
 BitVector::~BitVector() {
   if (storage_ != nullptr) {
     // Only free if we haven't been moved out of.
-    allocator_->Free(storage_);
+    allocator_->Free(storage_, storage_size_ * kWordBytes);
   }
 }
 
@@ -359,7 +359,7 @@ void BitVector::EnsureSize(uint32_t idx) {
     // TODO: collect stats on space wasted because of resize.
 
     // Free old storage.
-    allocator_->Free(storage_);
+    allocator_->Free(storage_, storage_size_ * kWordBytes);
 
     // Set fields.
     storage_ = new_storage;
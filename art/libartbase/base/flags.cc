@@ -103,7 +103,8 @@ Flag<Value>::Flag(const std::string& name, Value default_value, FlagType type) :
              GeneratePhenotypeName(name),
              type),
     initialized_{false},
-    default_{default_value} {
+    default_{default_value},
+    properties_loaded_{false} {
   ALL_FLAGS.push_front(this);
 }
 
@@ -117,12 +118,22 @@ void Flag<Value>::Reload() {
   initialized_ = true;
 
   // The cmdline flags are loaded by the parsed_options infra. No action needed here.
-  if (type_ == FlagType::kCmdlineOnly) {
-    return;
+  // The properties are loaded lazily by `LoadProperties()`.
+  std::lock_guard<std::mutex> lock(properties_lock_);
+  from_system_property_ = std::nullopt;
+  from_server_setting_ = std::nullopt;
+  properties_loaded_.store(type_ == FlagType::kCmdlineOnly, std::memory_order_release);
+}
+
+template <typename Value>
+void Flag<Value>::LoadProperties() const {
+  DCHECK(type_ != FlagType::kCmdlineOnly);
+  std::lock_guard<std::mutex> lock(properties_lock_);
+  if (properties_loaded_.load(std::memory_order_relaxed)) {
+    return;  // Loaded by another thread.
   }
 
   // Load system properties.
-  from_system_property_ = std::nullopt;
   const std::string sysprop = ::android::base::GetProperty(system_property_name_, kUndefinedValue);
   if (sysprop != kUndefinedValue) {
     if (!ParseValue(sysprop, &from_system_property_)) {
@@ -131,7 +142,6 @@ void Flag<Value>::Reload() {
   }
 
   // Load the server-side configuration.
-  from_server_setting_ = std::nullopt;
   const std::string server_config =
       ::android::base::GetProperty(server_setting_name_, kUndefinedValue);
   if (server_config != kUndefinedValue) {
@@ -139,6 +149,8 @@ void Flag<Value>::Reload() {
       LOG(ERROR) << "Failed to parse " << server_setting_name_ << "=" << server_config;
     }
   }
+
+  properties_loaded_.store(true, std::memory_order_release);
 }
 
 template <typename Value>
@@ -17,7 +17,9 @@
 #ifndef ART_LIBARTBASE_BASE_FLAGS_H_
 #define ART_LIBARTBASE_BASE_FLAGS_H_
 
+#include <atomic>
 #include <forward_list>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <variant>
@@ -196,6 +198,9 @@ class Flag : public FlagBase {
   // Returns the value and the origin of that value for the given flag.
   ALWAYS_INLINE std::pair<Value, FlagOrigin> GetValueAndOrigin() const {
     DCHECK(initialized_);
+    if (UNLIKELY(!properties_loaded_.load(std::memory_order_acquire))) {
+      LoadProperties();
+    }
     if (from_server_setting_.has_value()) {
       return std::pair{from_server_setting_.value(), FlagOrigin::kServerSetting};
     }
@@ -216,14 +221,22 @@ class Flag : public FlagBase {
 
   // Reload the server-configured value and system property values. In general this should not be
   // used directly, but it can be used to support reloading the value without restarting the device.
+  //
+  // The properties are only read when the value is first needed, so that the processes which do
+  // not use a flag, e.g. most dex2oat invocations, do not pay for the property lookups.
   void Reload() override;
 
  private:
+  // Read the server-configured value and system property values, if not done already.
+  void LoadProperties() const;
+
   bool initialized_;
   const Value default_;
   std::optional<Value> from_command_line_;
-  std::optional<Value> from_system_property_;
-  std::optional<Value> from_server_setting_;
+  mutable std::optional<Value> from_system_property_;
+  mutable std::optional<Value> from_server_setting_;
+  mutable std::atomic<bool> properties_loaded_;
+  mutable std::mutex properties_lock_;
 
   friend class TestFlag;
 };
@@ -54,6 +54,7 @@ class TestFlag {
   }
 
   void AssertSysPropValue(bool has_value, int expected) {
+    LoadProperties();
     ASSERT_EQ(flag_->from_system_property_.has_value(), has_value);
     if (has_value) {
       ASSERT_EQ(flag_->from_system_property_.value(), expected);
@@ -61,12 +62,17 @@ class TestFlag {
   }
 
   void AssertServerSettingValue(bool has_value, int expected) {
+    LoadProperties();
     ASSERT_EQ(flag_->from_server_setting_.has_value(), has_value);
     if (has_value) {
       ASSERT_EQ(flag_->from_server_setting_.value(), expected);
     }
   }
 
+  void AssertPropertiesLoaded(bool loaded) {
+    ASSERT_EQ(flag_->properties_loaded_.load(), loaded);
+  }
+
   void AssertDefaultValue(int expected) {
     ASSERT_EQ(flag_->default_, expected);
   }
@@ -88,6 +94,11 @@ class TestFlag {
   }
 
  private:
+  // The properties are loaded lazily, on the first read of the value.
+  void LoadProperties() {
+    flag_->GetValue();
+  }
+
   std::unique_ptr<ScratchFile> tmp_file_;
   std::unique_ptr<Flag<int>> flag_;
   std::string flag_name_;
@@ -224,6 +235,23 @@ TEST_F(FlagsTestsWithCmdLine, FlagsTestsGetValueCmdline) {
   ASSERT_EQ(test_flag_->Value(), 1);
 }
 
+// Validate that the properties are only read when the value is first needed.
+TEST_F(FlagsTests, ValidateLazyLoad) {
+  FlagBase::ReloadAllFlags("test");
+  test_flag_->AssertPropertiesLoaded(false);
+
+  if (!android::base::SetProperty(test_flag_->SystemProperty(), "2")) {
+    LOG(ERROR) << "Release does not support property setting, skipping test: "
+        << test_flag_->SystemProperty();
+    return;
+  }
+
+  int value = test_flag_->Value();
+  android::base::SetProperty(test_flag_->SystemProperty(), "");
+  ASSERT_EQ(value, 2);
+  test_flag_->AssertPropertiesLoaded(true);
+}
+
 // Validate that cmdline only flags don't read system properties.
 TEST_F(FlagsTestsCmdLineOnly, CmdlineOnlyFlags) {
   if (!android::base::SetProperty(test_flag_->SystemProperty(), "2")) {
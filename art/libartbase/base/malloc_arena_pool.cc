@@ -24,6 +24,7 @@
 
 #include <android-base/logging.h>
 #include "arena_allocator-inl.h"
+#include "mem_map.h"
 #include "mman.h"
 
 namespace art {
@@ -82,7 +83,8 @@ void Arena::Reset() {
   }
 }
 
-MallocArenaPool::MallocArenaPool() : free_arenas_(nullptr) {
+MallocArenaPool::MallocArenaPool(bool populate_new_arenas)
+    : populate_new_arenas_(populate_new_arenas) {
 }
 
 MallocArenaPool::~MallocArenaPool() {
@@ -90,45 +92,65 @@ MallocArenaPool::~MallocArenaPool() {
 }
 
 void MallocArenaPool::ReclaimMemory() {
-  while (free_arenas_ != nullptr) {
-    Arena* arena = free_arenas_;
-    free_arenas_ = free_arenas_->next_;
-    delete arena;
+  for (FreeArenaShard& shard : shards_) {
+    while (shard.free_arenas != nullptr) {
+      Arena* arena = shard.free_arenas;
+      shard.free_arenas = arena->next_;
+      delete arena;
+    }
   }
 }
 
 void MallocArenaPool::LockReclaimMemory() {
-  std::lock_guard<std::mutex> lock(lock_);
-  ReclaimMemory();
+  for (FreeArenaShard& shard : shards_) {
+    Arena* arenas;
+    {
+      std::lock_guard<std::mutex> lock(shard.lock);
+      arenas = shard.free_arenas;
+      shard.free_arenas = nullptr;
+    }
+    while (arenas != nullptr) {
+      Arena* arena = arenas;
+      arenas = arena->next_;
+      delete arena;
+    }
+  }
 }
 
 Arena* MallocArenaPool::AllocArena(size_t size) {
   Arena* ret = nullptr;
-  {
-    std::lock_guard<std::mutex> lock(lock_);
+  // Look at the shard of this thread first, then steal from the others.
+  const size_t first_shard = CurrentThreadShard();
+  for (size_t i = 0; i != kNumFreeArenaShards && ret == nullptr; ++i) {
+    FreeArenaShard& shard = shards_[(first_shard + i) % kNumFreeArenaShards];
+    std::lock_guard<std::mutex> lock(shard.lock);
+    Arena*& free_arenas = shard.free_arenas;
     // We used to check only the first free arena but we're now checking two.
     //
     // FIXME: This is a workaround for `oatdump` running out of memory because of an allocation
     // pattern where we would allocate a large arena (more than the default size) and then a
     // normal one (default size) and then return them to the pool together, with the normal one
-    // passed as `first` to `FreeArenaChain()`, thus becoming the first in the `free_arenas_`
+    // passed as `first` to `FreeArenaChain()`, thus becoming the first in the free arena
     // list. Since we checked only the first arena, doing this repeatedly would never reuse the
     // existing freed larger arenas and they would just accumulate in the free arena list until
     // running out of memory. This workaround allows reusing the second arena in the list, thus
     // fixing the problem for this specific allocation pattern. Similar allocation patterns
     // with three or more arenas can still result in out of memory issues.
-    if (free_arenas_ != nullptr && LIKELY(free_arenas_->Size() >= size)) {
-      ret = free_arenas_;
-      free_arenas_ = free_arenas_->next_;
-    } else if (free_arenas_ != nullptr &&
-               free_arenas_->next_ != nullptr &&
-               free_arenas_->next_->Size() >= size) {
-      ret = free_arenas_->next_;
-      free_arenas_->next_ = free_arenas_->next_->next_;
+    if (free_arenas != nullptr && LIKELY(free_arenas->Size() >= size)) {
+      ret = free_arenas;
+      free_arenas = free_arenas->next_;
+    } else if (free_arenas != nullptr &&
+               free_arenas->next_ != nullptr &&
+               free_arenas->next_->Size() >= size) {
+      ret = free_arenas->next_;
+      free_arenas->next_ = free_arenas->next_->next_;
     }
   }
   if (ret == nullptr) {
     ret = new MallocArena(size);
+    if (populate_new_arenas_) {
+      PopulatePagesForWrite(ret->Begin(), ret->Size());
+    }
   }
   ret->Reset();
   return ret;
@@ -140,9 +162,11 @@ void MallocArenaPool::TrimMaps() {
 
 size_t MallocArenaPool::GetBytesAllocated() const {
   size_t total = 0;
-  std::lock_guard<std::mutex> lock(lock_);
-  for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
-    total += arena->GetBytesAllocated();
+  for (const FreeArenaShard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.lock);
+    for (Arena* arena = shard.free_arenas; arena != nullptr; arena = arena->next_) {
+      total += arena->GetBytesAllocated();
+    }
   }
   return total;
 }
@@ -169,9 +193,10 @@ void MallocArenaPool::FreeArenaChain(Arena* first) {
     while (last->next_ != nullptr) {
       last = last->next_;
     }
-    std::lock_guard<std::mutex> lock(lock_);
-    last->next_ = free_arenas_;
-    free_arenas_ = first;
+    FreeArenaShard& shard = shards_[CurrentThreadShard()];
+    std::lock_guard<std::mutex> lock(shard.lock);
+    last->next_ = shard.free_arenas;
+    shard.free_arenas = first;
   }
 }
 
@@ -25,7 +25,9 @@ namespace art {
 
 class MallocArenaPool final : public ArenaPool {
  public:
-  MallocArenaPool();
+  // With `populate_new_arenas`, the pages of newly allocated arenas are faulted in at once, for
+  // users such as dex2oat that fill most of their arenas.
+  explicit MallocArenaPool(bool populate_new_arenas = false);
   ~MallocArenaPool();
   Arena* AllocArena(size_t size) override;
   void FreeArenaChain(Arena* first) override;
@@ -36,9 +38,10 @@ class MallocArenaPool final : public ArenaPool {
   void TrimMaps() override;
 
  private:
-  Arena* free_arenas_;
-  // Use a std::mutex here as Arenas are at the bottom of the lock hierarchy when malloc is used.
-  mutable std::mutex lock_;
+  // The shard locks are std::mutex as Arenas are at the bottom of the lock hierarchy when
+  // malloc is used.
+  FreeArenaShard shards_[kNumFreeArenaShards];
+  const bool populate_new_arenas_;
 
   DISALLOW_COPY_AND_ASSIGN(MallocArenaPool);
 };
@@ -45,6 +45,10 @@
 #define MAP_ANONYMOUS MAP_ANON
 #endif
 
+#if defined(__linux__) && !defined(MADV_POPULATE_WRITE)
+#define MADV_POPULATE_WRITE 23
+#endif
+
 namespace art {
 
 using android::base::StringPrintf;
@@ -861,6 +865,22 @@ void MemMap::FillWithZero(bool release_eagerly) {
   }
 }
 
+bool MemMap::AdviseHugePages() {
+#if defined(__linux__)
+  if (base_begin_ != nullptr || base_size_ != 0) {
+    if (madvise(base_begin_, base_size_, MADV_HUGEPAGE) == 0) {
+      return true;
+    }
+    PLOG(WARNING) << "madvise(MADV_HUGEPAGE) failed for " << name_;
+  }
+#endif
+  return false;
+}
+
+bool MemMap::PopulateForWrite() {
+  return PopulatePagesForWrite(base_begin_, base_size_);
+}
+
 int MemMap::MadviseDontFork() {
 #if defined(__linux__)
   if (base_begin_ != nullptr || base_size_ != 0) {
@@ -1350,6 +1370,36 @@ void ZeroMemory(void* address, size_t length, bool release_eagerly) {
 #endif  // _WIN32
 }
 
+void ZeroAndReleaseHugePages(void* address, size_t length) {
+  const size_t huge_page_size = MemMap::GetHugePageSize();
+  uint8_t* const mem_begin = reinterpret_cast<uint8_t*>(address);
+  uint8_t* const mem_end = mem_begin + length;
+  uint8_t* const huge_page_begin = AlignUp(mem_begin, huge_page_size);
+  uint8_t* const huge_page_end = AlignDown(mem_end, huge_page_size);
+  if (huge_page_begin >= huge_page_end) {
+    ZeroMemory(address, length, /* release_eagerly= */ false);
+    return;
+  }
+  ZeroMemory(mem_begin, huge_page_begin - mem_begin, /* release_eagerly= */ false);
+  ZeroMemory(huge_page_begin, huge_page_end - huge_page_begin, /* release_eagerly= */ true);
+  ZeroMemory(huge_page_end, mem_end - huge_page_end, /* release_eagerly= */ false);
+}
+
+bool PopulatePagesForWrite(void* address, size_t length) {
+  uint8_t* const mem_begin = reinterpret_cast<uint8_t*>(address);
+  uint8_t* const page_begin = AlignUp(mem_begin, MemMap::GetPageSize());
+  uint8_t* const page_end = AlignDown(mem_begin + length, MemMap::GetPageSize());
+  if (page_begin >= page_end) {
+    return true;
+  }
+#if defined(__linux__)
+  // Older kernels fail with EINVAL, the pages are then faulted in on first access as usual.
+  return madvise(page_begin, page_end - page_begin, MADV_POPULATE_WRITE) == 0;
+#else
+  return false;
+#endif
+}
+
 void MemMap::AlignBy(size_t alignment, bool align_both_ends) {
   CHECK_EQ(begin_, base_begin_) << "Unsupported";
   CHECK_EQ(size_, base_size_) << "Unsupported";
@@ -279,6 +279,11 @@ class MemMap {
     FillWithZero(/* release_eagerly= */ true);
   }
   int MadviseDontFork();
+  // Ask the kernel to back the mapping with transparent huge pages. Returns false if the kernel
+  // does not support them.
+  bool AdviseHugePages();
+  // Fault in all pages of the mapping for writing, see `PopulatePagesForWrite()`.
+  bool PopulateForWrite();
 
   int GetProtect() const {
     return prot_;
@@ -374,6 +379,11 @@ class MemMap {
   // 'redzone_size_ == 0' indicates that we are not using memory-tool on this mapping.
   size_t GetRedzoneSize() const { return redzone_size_; }
 
+  // Size of the transparent huge pages, which are mapped by a single page middle directory entry.
+  static size_t GetHugePageSize() {
+    return (GetPageSize() / sizeof(uint64_t)) * GetPageSize();
+  }
+
 #ifdef ART_PAGE_SIZE_AGNOSTIC
   static inline size_t GetPageSize() {
     DCHECK_NE(page_size_, 0u);
@@ -492,6 +502,15 @@ void ZeroMemory(void* address, size_t length, bool release_eagerly);
 inline void ZeroAndReleaseMemory(void* address, size_t length) {
   ZeroMemory(address, length, /* release_eagerly= */ true);
 }
+// Like ZeroAndReleaseMemory(), but only release the huge pages fully within the range. Releasing
+// part of a transparent huge page splits it, so the partial huge pages at either end are zeroed
+// in place instead.
+void ZeroAndReleaseHugePages(void* address, size_t length);
+// Fault in the whole pages within the range for writing with a single system call, instead of
+// taking a page fault on the first write to each page. Use this only for memory that is about to
+// be written, private file mappings get private copies of the populated pages. Returns false if
+// the kernel does not support it (Linux 5.14 and above do).
+bool PopulatePagesForWrite(void* address, size_t length);
 
 }  // namespace art
 
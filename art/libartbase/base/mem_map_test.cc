@@ -890,6 +890,58 @@ TEST_F(MemMapTest, Reservation) {
   ASSERT_FALSE(map2.IsValid());
 }
 
+TEST_F(MemMapTest, ZeroAndReleaseHugePages) {
+  CommonInit();
+  const size_t huge_page_size = MemMap::GetHugePageSize();
+  std::string error_msg;
+  MemMap map = MemMap::MapAnonymousAligned("ZeroAndReleaseHugePages",
+                                           3 * huge_page_size,
+                                           PROT_READ | PROT_WRITE,
+                                           /*low_4gb=*/ false,
+                                           huge_page_size,
+                                           &error_msg);
+  ASSERT_TRUE(map.IsValid()) << error_msg;
+  map.AdviseHugePages();
+  memset(map.Begin(), 0xFF, map.Size());
+  // Clear a range covering only the middle huge page entirely, and parts of the others.
+  const size_t offset = huge_page_size / 2;
+  const size_t length = 2 * huge_page_size;
+  ZeroAndReleaseHugePages(map.Begin() + offset, length);
+  for (size_t i = 0; i < map.Size(); i += MemMap::GetPageSize()) {
+    const bool cleared = i >= offset && i < offset + length;
+    EXPECT_EQ(map.Begin()[i], cleared ? 0u : 0xFFu) << i;
+  }
+}
+
+TEST_F(MemMapTest, PopulateForWrite) {
+  CommonInit();
+  const size_t page_size = MemMap::GetPageSize();
+  std::string error_msg;
+  MemMap map = MemMap::MapAnonymous("PopulateForWrite",
+                                    4 * page_size,
+                                    PROT_READ | PROT_WRITE,
+                                    /*low_4gb=*/ false,
+                                    &error_msg);
+  ASSERT_TRUE(map.IsValid()) << error_msg;
+  if (!map.PopulateForWrite()) {
+    GTEST_SKIP() << "MADV_POPULATE_WRITE is not supported";
+  }
+#if defined(__linux__)
+  unsigned char vec[4];
+  ASSERT_EQ(mincore(map.Begin(), map.Size(), vec), 0);
+  for (unsigned char resident : vec) {
+    EXPECT_NE(resident & 1u, 0u);
+  }
+#endif
+  // The populated pages are still zero and writable.
+  for (size_t i = 0; i < map.Size(); i += page_size) {
+    EXPECT_EQ(map.Begin()[i], 0u) << i;
+    map.Begin()[i] = 1u;
+  }
+  // A range with no whole page is trivially populated.
+  EXPECT_TRUE(PopulatePagesForWrite(map.Begin() + 1, page_size - 2));
+}
+
 }  // namespace art
 
 namespace {
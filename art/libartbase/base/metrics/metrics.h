@@ -19,8 +19,10 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <limits>
 #include <optional>
 #include <sstream>
 #include <string_view>
@@ -30,7 +32,9 @@
 #include "android-base/logging.h"
 #include "base/bit_utils.h"
 #include "base/macros.h"
+#include "base/systrace.h"
 #include "base/time_utils.h"
+#include "base/utils.h"
 #include "jni.h"
 #include "tinyxml2.h"
 
@@ -41,9 +45,9 @@
 
 // Metrics reported as Event Metrics.
 #define ART_EVENT_METRICS(METRIC)                                   \
-  METRIC(ClassLoadingTotalTime, MetricsCounter)                     \
-  METRIC(ClassVerificationTotalTime, MetricsCounter)                \
-  METRIC(ClassVerificationCount, MetricsCounter)                    \
+  METRIC(ClassLoadingTotalTime, MetricsShardedCounter)              \
+  METRIC(ClassVerificationTotalTime, MetricsShardedCounter)         \
+  METRIC(ClassVerificationCount, MetricsShardedCounter)             \
   METRIC(WorldStopTimeDuringGCAvg, MetricsAverage)                  \
   METRIC(YoungGcCount, MetricsCounter)                              \
   METRIC(FullGcCount, MetricsCounter)                               \
@@ -55,6 +59,12 @@
   METRIC(FullGcTracingThroughputAvg, MetricsAverage)                \
   METRIC(JitMethodCompileTotalTime, MetricsCounter)                 \
   METRIC(JitMethodCompileCount, MetricsCounter)                     \
+  METRIC(JitBaselineCompileTime, MetricsHistogram, 15, 0, 100'000)  \
+  METRIC(JitOptimizedCompileTime, MetricsHistogram, 15, 0, 100'000) \
+  METRIC(JitOsrCompileTime, MetricsHistogram, 15, 0, 100'000)       \
+  METRIC(JitCompileArenaKb, MetricsHistogram, 15, 0, 65'536)        \
+  METRIC(JitCompileInlinedMethods, MetricsHistogram, 15, 0, 256)    \
+  METRIC(JitCompileCodeSize, MetricsHistogram, 15, 0, 65'536)       \
   METRIC(YoungGcCollectionTime, MetricsHistogram, 15, 0, 60'000)    \
   METRIC(FullGcCollectionTime, MetricsHistogram, 15, 0, 60'000)     \
   METRIC(YoungGcThroughput, MetricsHistogram, 15, 0, 10'000)        \
@@ -68,27 +78,48 @@
   METRIC(YoungGcDuration, MetricsCounter)                           \
   METRIC(FullGcScannedBytes, MetricsCounter)                        \
   METRIC(FullGcFreedBytes, MetricsCounter)                          \
-  METRIC(FullGcDuration, MetricsCounter)
+  METRIC(FullGcDuration, MetricsCounter)                            \
+  METRIC(SoftReferenceProcessedCount, MetricsCounter)               \
+  METRIC(WeakReferenceProcessedCount, MetricsCounter)               \
+  METRIC(FinalizerReferenceProcessedCount, MetricsCounter)          \
+  METRIC(PhantomReferenceProcessedCount, MetricsCounter)            \
+  METRIC(SoftReferenceProcessingTime, MetricsCounter)               \
+  METRIC(WeakReferenceProcessingTime, MetricsCounter)               \
+  METRIC(FinalizerReferenceProcessingTime, MetricsCounter)          \
+  METRIC(PhantomReferenceProcessingTime, MetricsCounter)            \
+  METRIC(GcPauseTime, MetricsLogHistogram)                          \
+  METRIC(JitTimeToOptimizedCode, MetricsLogHistogram)               \
+  METRIC(StartupReleasedImageMetadataBytes, MetricsCounter)         \
+  METRIC(StartupReleasedLinearAllocBytes, MetricsCounter)           \
+  METRIC(StartupReleasedArenaPoolBytes, MetricsCounter)            \
+  METRIC(StartupRuntimeInitTime, MetricsCounter)                    \
+  METRIC(StartupHeapCreationTime, MetricsCounter)                   \
+  METRIC(StartupBootImageMappedKb, MetricsCounter)                  \
+  METRIC(StartupClassLinkerInitTime, MetricsCounter)                \
+  METRIC(StartupJitCreationTime, MetricsCounter)                    \
+  METRIC(LockContentionWaitTime, MetricsLogHistogram)               \
+  METRIC(StringsFromUtf16Count, MetricsShardedCounter)              \
+  METRIC(StringsFromUtf16CompressedCount, MetricsShardedCounter)
 
 // Increasing counter metrics, reported as Value Metrics in delta increments.
-#define ART_VALUE_METRICS(METRIC)                              \
-  METRIC(GcWorldStopTimeDelta, MetricsDeltaCounter)            \
-  METRIC(GcWorldStopCountDelta, MetricsDeltaCounter)           \
-  METRIC(YoungGcScannedBytesDelta, MetricsDeltaCounter)        \
-  METRIC(YoungGcFreedBytesDelta, MetricsDeltaCounter)          \
-  METRIC(YoungGcDurationDelta, MetricsDeltaCounter)            \
-  METRIC(FullGcScannedBytesDelta, MetricsDeltaCounter)         \
-  METRIC(FullGcFreedBytesDelta, MetricsDeltaCounter)           \
-  METRIC(FullGcDurationDelta, MetricsDeltaCounter)             \
-  METRIC(JitMethodCompileTotalTimeDelta, MetricsDeltaCounter)  \
-  METRIC(JitMethodCompileCountDelta, MetricsDeltaCounter)      \
-  METRIC(ClassVerificationTotalTimeDelta, MetricsDeltaCounter) \
-  METRIC(ClassVerificationCountDelta, MetricsDeltaCounter)     \
-  METRIC(ClassLoadingTotalTimeDelta, MetricsDeltaCounter)      \
-  METRIC(TotalBytesAllocatedDelta, MetricsDeltaCounter)        \
-  METRIC(TotalGcCollectionTimeDelta, MetricsDeltaCounter)      \
-  METRIC(YoungGcCountDelta, MetricsDeltaCounter)               \
-  METRIC(FullGcCountDelta, MetricsDeltaCounter)                \
+#define ART_VALUE_METRICS(METRIC)                                     \
+  METRIC(GcWorldStopTimeDelta, MetricsDeltaCounter)                   \
+  METRIC(GcWorldStopCountDelta, MetricsDeltaCounter)                  \
+  METRIC(YoungGcScannedBytesDelta, MetricsDeltaCounter)               \
+  METRIC(YoungGcFreedBytesDelta, MetricsDeltaCounter)                 \
+  METRIC(YoungGcDurationDelta, MetricsDeltaCounter)                   \
+  METRIC(FullGcScannedBytesDelta, MetricsDeltaCounter)                \
+  METRIC(FullGcFreedBytesDelta, MetricsDeltaCounter)                  \
+  METRIC(FullGcDurationDelta, MetricsDeltaCounter)                    \
+  METRIC(JitMethodCompileTotalTimeDelta, MetricsDeltaCounter)         \
+  METRIC(JitMethodCompileCountDelta, MetricsDeltaCounter)             \
+  METRIC(ClassVerificationTotalTimeDelta, MetricsShardedDeltaCounter) \
+  METRIC(ClassVerificationCountDelta, MetricsShardedDeltaCounter)     \
+  METRIC(ClassLoadingTotalTimeDelta, MetricsShardedDeltaCounter)      \
+  METRIC(TotalBytesAllocatedDelta, MetricsDeltaCounter)               \
+  METRIC(TotalGcCollectionTimeDelta, MetricsDeltaCounter)             \
+  METRIC(YoungGcCountDelta, MetricsDeltaCounter)                      \
+  METRIC(FullGcCountDelta, MetricsDeltaCounter)                       \
   METRIC(TimeElapsedDelta, MetricsDeltaCounter)
 
 #define ART_METRICS(METRIC) \
@@ -279,6 +310,13 @@ class MetricsBackend {
                                int64_t maximum_value,
                                const std::vector<uint32_t>& buckets) = 0;
 
+  // Called by the metrics reporter to report a log-linear histogram, see `MetricsLogHistogram`.
+  // The buckets only depend on `sub_bucket_bits`, so reports can be merged by adding them. Backends
+  // that have no place for these histograms ignore them.
+  virtual void ReportLogHistogram([[maybe_unused]] DatumId histogram_type,
+                                  [[maybe_unused]] size_t sub_bucket_bits,
+                                  [[maybe_unused]] const std::vector<uint32_t>& buckets) {}
+
   // Called by the metrics reporter to indicate that the current metrics report is complete.
   virtual void EndReport() = 0;
 
@@ -286,8 +324,14 @@ class MetricsBackend {
   friend class MetricsCounter;
   template <DatumId counter_type, typename T>
   friend class MetricsDeltaCounter;
+  template <DatumId counter_type, typename T>
+  friend class MetricsShardedCounter;
+  template <DatumId counter_type, typename T>
+  friend class MetricsShardedDeltaCounter;
   template <DatumId histogram_type, size_t num_buckets, int64_t low_value, int64_t high_value>
   friend class MetricsHistogram;
+  template <DatumId histogram_type, size_t sub_bucket_bits>
+  friend class MetricsLogHistogram;
   template <DatumId datum_id, typename T, const T& AccumulatorFunction(const T&, const T&)>
   friend class MetricsAccumulator;
   template <DatumId datum_id, typename T>
@@ -438,6 +482,111 @@ class MetricsDeltaCounter : public MetricsBase<T> {
   friend class ArtMetrics;
 };
 
+// Atomic counter storage for metrics that many threads update at the same time, such as class
+// loading and verification during startup. Each thread adds to one of a few shards, picked by
+// thread id and each on its own cache line, so that the updates do not all contend on one atomic.
+// Reading sums the shards, which only the reporter does.
+template <typename T>
+class ShardedAtomicCounter {
+ public:
+  constexpr ShardedAtomicCounter() {}
+
+  void Add(T value) {
+    shards_[GetTid() % kNumShards].value.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  T Load() const {
+    T sum = 0;
+    for (const Shard& shard : shards_) {
+      sum += shard.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+  // Return the value and reset it. Concurrent additions are either returned or kept.
+  T Exchange() {
+    T sum = 0;
+    for (Shard& shard : shards_) {
+      sum += shard.value.exchange(0, std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+  void Reset() {
+    for (Shard& shard : shards_) {
+      shard.value.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  static constexpr size_t kNumShards = 8u;
+  static constexpr size_t kShardAlignment = 64u;  // A cache line on all supported targets.
+
+  struct alignas(kShardAlignment) Shard {
+    std::atomic<T> value{0};
+  };
+
+  std::array<Shard, kNumShards> shards_;
+  static_assert(std::atomic<T>::is_always_lock_free);
+};
+
+// A `MetricsCounter` for values that many threads update at the same time.
+template <DatumId counter_type, typename T = uint64_t>
+class MetricsShardedCounter final : public MetricsBase<T> {
+ public:
+  using value_t = T;
+  constexpr MetricsShardedCounter() {}
+
+  void AddOne() { Add(1u); }
+  void Add(value_t value) override { value_.Add(value); }
+
+  void Report(const std::vector<MetricsBackend*>& backends) const {
+    for (MetricsBackend* backend : backends) {
+      backend->ReportCounter(counter_type, Value());
+    }
+  }
+
+ protected:
+  void Reset() { value_.Reset(); }
+  value_t Value() const { return value_.Load(); }
+
+ private:
+  bool IsNull() const override { return Value() == 0; }
+
+  ShardedAtomicCounter<value_t> value_;
+
+  friend class ArtMetrics;
+};
+
+// A `MetricsDeltaCounter` for values that many threads update at the same time.
+template <DatumId datum_id, typename T = uint64_t>
+class MetricsShardedDeltaCounter final : public MetricsBase<T> {
+ public:
+  using value_t = T;
+  constexpr MetricsShardedDeltaCounter() {}
+
+  void Add(value_t value) override { value_.Add(value); }
+  void AddOne() { Add(1u); }
+
+  void ReportAndReset(const std::vector<MetricsBackend*>& backends) {
+    value_t value = value_.Exchange();
+    for (MetricsBackend* backend : backends) {
+      backend->ReportCounter(datum_id, value);
+    }
+  }
+
+  void Reset() { value_.Reset(); }
+
+ private:
+  value_t Value() const { return value_.Load(); }
+
+  bool IsNull() const override { return Value() == 0; }
+
+  ShardedAtomicCounter<value_t> value_;
+
+  friend class ArtMetrics;
+};
+
 template <DatumId histogram_type_,
           size_t num_buckets_,
           int64_t minimum_value_,
@@ -508,6 +657,97 @@ class MetricsHistogram final : public MetricsBase<int64_t> {
   friend class ArtMetrics;
 };
 
+// Bucket layout of `MetricsLogHistogram`. Values below `2^sub_bucket_bits` have a bucket each,
+// and every higher power of two range is split in `2^sub_bucket_bits` buckets of equal size.
+constexpr size_t LogHistogramNumBuckets(size_t sub_bucket_bits) {
+  return (BitSizeOf<uint32_t>() + 1u - sub_bucket_bits) << sub_bucket_bits;
+}
+
+constexpr size_t LogHistogramBucketIndex(uint32_t value, size_t sub_bucket_bits) {
+  const uint32_t num_sub_buckets = 1u << sub_bucket_bits;
+  if (value < num_sub_buckets) {
+    return value;
+  }
+  const size_t shift = static_cast<size_t>(MostSignificantBit(value)) - sub_bucket_bits;
+  return ((shift + 1u) << sub_bucket_bits) + (value >> shift) - num_sub_buckets;
+}
+
+// The smallest value in the bucket, or 2^32 for the end of the last bucket.
+constexpr uint64_t LogHistogramBucketLowerBound(size_t index, size_t sub_bucket_bits) {
+  const uint64_t num_sub_buckets = UINT64_C(1) << sub_bucket_bits;
+  if (index < num_sub_buckets) {
+    return index;
+  }
+  const size_t shift = (index >> sub_bucket_bits) - 1u;
+  return (num_sub_buckets + (index & (num_sub_buckets - 1u))) << shift;
+}
+
+// Return the highest value of the bucket that holds the given percentile of the values, which is
+// within a relative error of `2^-sub_bucket_bits` of the exact percentile. Returns 0 if there are
+// no values.
+uint64_t LogHistogramPercentile(const std::vector<uint32_t>& buckets,
+                                size_t sub_bucket_bits,
+                                double percentile);
+
+// A histogram with log-linear buckets, in the style of HDR histograms, for latencies where the
+// tail matters, such as GC pauses. Unlike `MetricsHistogram`, which clamps values outside of a
+// fixed linear range, it keeps the p99 of values from 0 to 2^32 - 1 accurate to within
+// `2^-sub_bucket_bits`. The bucket layout is the same for all histograms with the same
+// `sub_bucket_bits`, so reports from different processes can be merged without losing accuracy.
+template <DatumId histogram_type_, size_t sub_bucket_bits_ = 4u>
+class MetricsLogHistogram final : public MetricsBase<int64_t> {
+  static_assert(sub_bucket_bits_ >= 1u && sub_bucket_bits_ <= 8u);
+
+ public:
+  using value_t = uint32_t;
+  static constexpr size_t kNumBuckets = LogHistogramNumBuckets(sub_bucket_bits_);
+
+  constexpr MetricsLogHistogram() : buckets_{} {}
+
+  void Add(int64_t value) override {
+    // Negative values are clamped to 0, values that do not fit in 32 bits to the last bucket.
+    uint32_t clamped_value = static_cast<uint32_t>(
+        std::clamp<int64_t>(value, 0, std::numeric_limits<uint32_t>::max()));
+    buckets_[LogHistogramBucketIndex(clamped_value, sub_bucket_bits_)].fetch_add(
+        1u, std::memory_order_relaxed);
+  }
+
+  void Report(const std::vector<MetricsBackend*>& backends) const {
+    std::vector<value_t> buckets = GetBuckets();
+    for (MetricsBackend* backend : backends) {
+      backend->ReportLogHistogram(histogram_type_, sub_bucket_bits_, buckets);
+    }
+  }
+
+ protected:
+  void Reset() {
+    for (auto& bucket : buckets_) {
+      bucket.store(0u, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  std::vector<value_t> GetBuckets() const {
+    std::vector<value_t> buckets;
+    buckets.reserve(kNumBuckets);
+    for (const auto& bucket : buckets_) {
+      buckets.push_back(bucket.load(std::memory_order_relaxed));
+    }
+    return buckets;
+  }
+
+  bool IsNull() const override {
+    return std::all_of(buckets_.begin(), buckets_.end(), [](const std::atomic<value_t>& bucket) {
+      return bucket.load(std::memory_order_relaxed) == 0u;
+    });
+  }
+
+  std::array<std::atomic<value_t>, kNumBuckets> buckets_;
+  static_assert(std::atomic<value_t>::is_always_lock_free);
+
+  friend class ArtMetrics;
+};
+
 template <DatumId datum_id, typename T, const T& AccumulatorFunction(const T&, const T&)>
 class MetricsAccumulator final : MetricsBase<T> {
  public:
@@ -566,6 +806,9 @@ class MetricsFormatter {
                                      int64_t low_value,
                                      int64_t high_value,
                                      const std::vector<uint32_t>& buckets) = 0;
+  virtual void FormatReportLogHistogram(DatumId histogram_type,
+                                        size_t sub_bucket_bits,
+                                        const std::vector<uint32_t>& buckets) = 0;
   virtual std::string GetAndResetBuffer() = 0;
 
  protected:
@@ -587,6 +830,10 @@ class TextFormatter : public MetricsFormatter {
                              int64_t high_value,
                              const std::vector<uint32_t>& buckets) override;
 
+  void FormatReportLogHistogram(DatumId histogram_type,
+                                size_t sub_bucket_bits,
+                                const std::vector<uint32_t>& buckets) override;
+
   void FormatEndReport() override;
 
   std::string GetAndResetBuffer() override;
@@ -610,6 +857,10 @@ class XmlFormatter : public MetricsFormatter {
                              int64_t high_value,
                              const std::vector<uint32_t>& buckets) override;
 
+  void FormatReportLogHistogram(DatumId histogram_type,
+                                size_t sub_bucket_bits,
+                                const std::vector<uint32_t>& buckets) override;
+
   void FormatEndReport() override;
 
   std::string GetAndResetBuffer() override;
@@ -638,6 +889,10 @@ class StringBackend : public MetricsBackend {
                        int64_t high_value,
                        const std::vector<uint32_t>& buckets) override;
 
+  void ReportLogHistogram(DatumId histogram_type,
+                          size_t sub_bucket_bits,
+                          const std::vector<uint32_t>& buckets) override;
+
   void EndReport() override;
 
   std::string GetAndResetBuffer();
@@ -742,6 +997,29 @@ class AutoTimer {
   Metric* metric_;
 };
 
+/**
+ * A phase of the runtime startup, such as loading the boot image or creating the JIT.
+ *
+ * The phase is emitted as a trace section through libartpalette, and its duration in
+ * microseconds is added to `metric`, so that the startup timeline is available both in traces
+ * and in the reported metrics:
+ *
+ *     {
+ *       ScopedStartupPhase phase{"CreateJit", GetMetrics()->StartupJitCreationTime()};
+ *       CreateJit();
+ *     }
+ */
+template <typename Metric>
+class ScopedStartupPhase {
+ public:
+  ScopedStartupPhase(const char* name, Metric* metric) : trace_(name), timer_(metric) {}
+
+ private:
+  // The timer is destroyed first, so it does not include the end of the trace section.
+  ScopedTrace trace_;
+  AutoTimer<Metric> timer_;
+};
+
 /**
  * This struct contains all of the metrics that ART reports.
  */
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <cmath>
+#include <numeric>
 #include <sstream>
 
 #include "android-base/file.h"
@@ -57,6 +59,28 @@ SessionData SessionData::CreateDefault() {
   };
 }
 
+uint64_t LogHistogramPercentile(const std::vector<uint32_t>& buckets,
+                                size_t sub_bucket_bits,
+                                double percentile) {
+  DCHECK_GE(percentile, 0.0);
+  DCHECK_LE(percentile, 1.0);
+  uint64_t total = std::accumulate(buckets.begin(), buckets.end(), UINT64_C(0));
+  if (total == 0u) {
+    return 0u;
+  }
+  uint64_t rank = std::max<uint64_t>(
+      static_cast<uint64_t>(std::ceil(percentile * static_cast<double>(total))), 1u);
+  uint64_t seen = 0u;
+  for (size_t i = 0; i != buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return LogHistogramBucketLowerBound(i + 1u, sub_bucket_bits) - 1u;
+    }
+  }
+  LOG(FATAL) << "Unreachable";
+  UNREACHABLE();
+}
+
 ArtMetrics::ArtMetrics()
     : beginning_timestamp_{MilliTime()},
       last_report_timestamp_{beginning_timestamp_}
@@ -136,6 +160,12 @@ void StringBackend::ReportHistogram(DatumId histogram_type,
   formatter_->FormatReportHistogram(histogram_type, minimum_value_, maximum_value_, buckets);
 }
 
+void StringBackend::ReportLogHistogram(DatumId histogram_type,
+                                       size_t sub_bucket_bits,
+                                       const std::vector<uint32_t>& buckets) {
+  formatter_->FormatReportLogHistogram(histogram_type, sub_bucket_bits, buckets);
+}
+
 void TextFormatter::FormatBeginReport(uint64_t timestamp_since_start_ms,
                                       const std::optional<SessionData>& session_data) {
   os_ << "\n*** ART internal metrics ***\n";
@@ -178,6 +208,20 @@ void TextFormatter::FormatReportHistogram(DatumId histogram_type,
   }
 }
 
+void TextFormatter::FormatReportLogHistogram(DatumId histogram_type,
+                                             size_t sub_bucket_bits,
+                                             const std::vector<uint32_t>& buckets) {
+  uint64_t count = std::accumulate(buckets.begin(), buckets.end(), UINT64_C(0));
+  os_ << "    " << DatumName(histogram_type) << ": count = " << count;
+  if (count != 0u) {
+    os_ << ", p50 = " << LogHistogramPercentile(buckets, sub_bucket_bits, 0.5)
+        << ", p90 = " << LogHistogramPercentile(buckets, sub_bucket_bits, 0.9)
+        << ", p99 = " << LogHistogramPercentile(buckets, sub_bucket_bits, 0.99)
+        << ", max = " << LogHistogramPercentile(buckets, sub_bucket_bits, 1.0);
+  }
+  os_ << "\n";
+}
+
 void TextFormatter::FormatEndReport() {
   os_ << "*** Done dumping ART internal metrics ***\n";
 }
@@ -239,6 +283,27 @@ void XmlFormatter::FormatReportHistogram(DatumId histogram_type,
   }
 }
 
+void XmlFormatter::FormatReportLogHistogram(DatumId histogram_type,
+                                            size_t sub_bucket_bits,
+                                            const std::vector<uint32_t>& buckets) {
+  tinyxml2::XMLElement* metrics = document_.RootElement()->FirstChildElement("metrics");
+
+  tinyxml2::XMLElement* histogram =
+      metrics->InsertNewChildElement(DatumName(histogram_type).data());
+  histogram->InsertNewChildElement("counter_type")->SetText("log_histogram");
+  histogram->InsertNewChildElement("sub_bucket_bits")
+      ->SetText(static_cast<uint64_t>(sub_bucket_bits));
+  histogram->InsertNewChildElement("p50")
+      ->SetText(LogHistogramPercentile(buckets, sub_bucket_bits, 0.5));
+  histogram->InsertNewChildElement("p99")
+      ->SetText(LogHistogramPercentile(buckets, sub_bucket_bits, 0.99));
+
+  tinyxml2::XMLElement* buckets_element = histogram->InsertNewChildElement("buckets");
+  for (const auto& count : buckets) {
+    buckets_element->InsertNewChildElement("bucket")->SetText(count);
+  }
+}
+
 void XmlFormatter::FormatEndReport() {}
 
 std::string XmlFormatter::GetAndResetBuffer() {
@@ -16,6 +16,12 @@
 
 #include "metrics.h"
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <vector>
+
 #include "base/macros.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -180,6 +186,92 @@ TEST_F(MetricsTest, HistogramOutOfRangeTest) {
   EXPECT_EQ(2u, buckets[1u]);
 }
 
+TEST_F(MetricsTest, ShardedCounter) {
+  MetricsShardedCounter<DatumId::kClassVerificationTotalTime> counter;
+  EXPECT_EQ(0u, CounterValue(counter));
+
+  // Updates from all threads are counted, whichever shard they go to.
+  constexpr size_t kNumThreads = 16u;
+  constexpr uint64_t kNumAdds = 1000u;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([&counter]() {
+      for (uint64_t j = 0; j != kNumAdds; ++j) {
+        counter.Add(2u);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  counter.AddOne();
+  EXPECT_EQ(kNumThreads * kNumAdds * 2u + 1u, CounterValue(counter));
+}
+
+TEST_F(MetricsTest, LogHistogramBuckets) {
+  constexpr size_t kSubBucketBits = 4u;
+  constexpr size_t kNumBuckets = LogHistogramNumBuckets(kSubBucketBits);
+  // Small values have a bucket each.
+  for (uint32_t value = 0; value != 32u; ++value) {
+    EXPECT_EQ(value, LogHistogramBucketIndex(value, kSubBucketBits));
+  }
+  // Then there are 16 buckets per power of two.
+  EXPECT_EQ(32u, LogHistogramBucketIndex(32u, kSubBucketBits));
+  EXPECT_EQ(32u, LogHistogramBucketIndex(33u, kSubBucketBits));
+  EXPECT_EQ(33u, LogHistogramBucketIndex(34u, kSubBucketBits));
+  EXPECT_EQ(kNumBuckets - 1u,
+            LogHistogramBucketIndex(std::numeric_limits<uint32_t>::max(), kSubBucketBits));
+  // The buckets cover all 32-bit values without gaps.
+  EXPECT_EQ(0u, LogHistogramBucketLowerBound(0u, kSubBucketBits));
+  EXPECT_EQ(UINT64_C(1) << 32, LogHistogramBucketLowerBound(kNumBuckets, kSubBucketBits));
+  for (size_t i = 1; i != kNumBuckets; ++i) {
+    uint64_t lower_bound = LogHistogramBucketLowerBound(i, kSubBucketBits);
+    ASSERT_LT(LogHistogramBucketLowerBound(i - 1u, kSubBucketBits), lower_bound);
+    ASSERT_EQ(i, LogHistogramBucketIndex(static_cast<uint32_t>(lower_bound), kSubBucketBits));
+    ASSERT_EQ(i - 1u,
+              LogHistogramBucketIndex(static_cast<uint32_t>(lower_bound - 1u), kSubBucketBits));
+  }
+}
+
+TEST_F(MetricsTest, LogHistogramPercentiles) {
+  MetricsLogHistogram<DatumId::kGcPauseTime> histogram;
+  EXPECT_EQ(0u, LogHistogramPercentile(GetBuckets(histogram), 4u, 0.99));
+
+  // Pauses from 1us to 10000us, with a long tail that a linear histogram would clamp.
+  std::vector<int64_t> values;
+  for (int64_t value = 1; value <= 10000; ++value) {
+    values.push_back(value);
+  }
+  values.push_back(-5);
+  values.push_back(INT64_C(1) << 40);
+  for (int64_t value : values) {
+    histogram.Add(value);
+  }
+  std::vector<uint32_t> buckets = GetBuckets(histogram);
+  EXPECT_EQ(values.size(), std::accumulate(buckets.begin(), buckets.end(), UINT64_C(0)));
+  EXPECT_EQ(1u, buckets[0]);
+
+  std::sort(values.begin(), values.end());
+  for (double percentile : {0.5, 0.9, 0.99}) {
+    size_t rank = static_cast<size_t>(std::ceil(percentile * static_cast<double>(values.size())));
+    uint64_t exact = static_cast<uint64_t>(values[rank - 1u]);
+    uint64_t estimate = LogHistogramPercentile(buckets, 4u, percentile);
+    EXPECT_GE(estimate, exact) << percentile;
+    EXPECT_LE(estimate, exact + exact / 16u) << percentile;
+  }
+  EXPECT_EQ(std::numeric_limits<uint32_t>::max(), LogHistogramPercentile(buckets, 4u, 1.0));
+
+  // Histograms are merged by adding the buckets.
+  MetricsLogHistogram<DatumId::kGcPauseTime> other_histogram;
+  other_histogram.Add(100);
+  std::vector<uint32_t> merged = GetBuckets(other_histogram);
+  for (size_t i = 0; i != merged.size(); ++i) {
+    merged[i] += buckets[i];
+  }
+  EXPECT_EQ(buckets[LogHistogramBucketIndex(100u, 4u)] + 1u,
+            merged[LogHistogramBucketIndex(100u, 4u)]);
+}
+
 // Test adding values to ArtMetrics and reporting them through a test backend.
 TEST_F(MetricsTest, ArtMetricsReport) {
   ArtMetrics metrics;
@@ -292,6 +384,13 @@ TEST_F(MetricsTest, ResetMetrics) {
       }
       EXPECT_TRUE(nonzero) << "Unexpected value for histogram " << DatumName(histogram_type);
     }
+
+    void ReportLogHistogram(DatumId histogram_type,
+                            [[maybe_unused]] size_t sub_bucket_bits,
+                            const std::vector<uint32_t>& buckets) override {
+      EXPECT_TRUE(std::any_of(buckets.begin(), buckets.end(), [](uint32_t b) { return b != 0u; }))
+          << "Unexpected value for histogram " << DatumName(histogram_type);
+    }
   } non_zero_backend;
 
   // Make sure the metrics all have a nonzero value.
@@ -319,6 +418,14 @@ TEST_F(MetricsTest, ResetMetrics) {
         EXPECT_EQ(value, 0u) << "Unexpected value for histogram " << DatumName(histogram_type);
       }
     }
+
+    void ReportLogHistogram(DatumId histogram_type,
+                            [[maybe_unused]] size_t sub_bucket_bits,
+                            const std::vector<uint32_t>& buckets) override {
+      for (const auto value : buckets) {
+        EXPECT_EQ(value, 0u) << "Unexpected value for histogram " << DatumName(histogram_type);
+      }
+    }
   } zero_backend;
 
   metrics.ReportAllMetricsAndResetValueMetrics({&zero_backend});
@@ -342,12 +449,19 @@ TEST_F(MetricsTest, KeepEventMetricsResetValueMetricsAfterReporting) {
                          [[maybe_unused]] int64_t minimum_value,
                          [[maybe_unused]] int64_t maximum_value,
                          const std::vector<uint32_t>& buckets) override {
-      EXPECT_NE(buckets[0], 0u) << "Unexpected value for bucket 0 for histogram "
-                                << DatumName(histogram_type);
-      for (size_t i = 1; i < buckets.size(); i++) {
-        EXPECT_EQ(buckets[i], 0u) << "Unexpected value for bucket " << i << " for histogram "
-                                  << DatumName(histogram_type);
-      }
+      // The one value is in a single bucket, which depends on the histogram's range.
+      EXPECT_EQ(std::accumulate(buckets.begin(), buckets.end(), 0u), 1u)
+          << "Unexpected values for histogram " << DatumName(histogram_type);
+      EXPECT_EQ(std::count(buckets.begin(), buckets.end(), 0u),
+                static_cast<ptrdiff_t>(buckets.size() - 1u))
+          << "Unexpected buckets for histogram " << DatumName(histogram_type);
+    }
+
+    void ReportLogHistogram(DatumId histogram_type,
+                            [[maybe_unused]] size_t sub_bucket_bits,
+                            const std::vector<uint32_t>& buckets) override {
+      EXPECT_EQ(buckets[LogHistogramBucketIndex(42u, sub_bucket_bits)], 1u)
+          << "Unexpected value for histogram " << DatumName(histogram_type);
     }
   } first_backend;
 
@@ -390,12 +504,19 @@ TEST_F(MetricsTest, KeepEventMetricsResetValueMetricsAfterReporting) {
                          [[maybe_unused]] int64_t minimum_value,
                          [[maybe_unused]] int64_t maximum_value,
                          const std::vector<uint32_t>& buckets) override {
-      EXPECT_NE(buckets[0], 0u) << "Unexpected value for bucket 0 for histogram "
-                                << DatumName(histogram_type);
-      for (size_t i = 1; i < buckets.size(); i++) {
-        EXPECT_EQ(buckets[i], 0u) << "Unexpected value for bucket " << i << " for histogram "
-                                  << DatumName(histogram_type);
-      }
+      // The one value is in a single bucket, which depends on the histogram's range.
+      EXPECT_EQ(std::accumulate(buckets.begin(), buckets.end(), 0u), 1u)
+          << "Unexpected values for histogram " << DatumName(histogram_type);
+      EXPECT_EQ(std::count(buckets.begin(), buckets.end(), 0u),
+                static_cast<ptrdiff_t>(buckets.size() - 1u))
+          << "Unexpected buckets for histogram " << DatumName(histogram_type);
+    }
+
+    void ReportLogHistogram(DatumId histogram_type,
+                            [[maybe_unused]] size_t sub_bucket_bits,
+                            const std::vector<uint32_t>& buckets) override {
+      EXPECT_EQ(buckets[LogHistogramBucketIndex(42u, sub_bucket_bits)], 1u)
+          << "Unexpected value for histogram " << DatumName(histogram_type);
     }
   } second_backend;
 
@@ -431,6 +552,20 @@ TEST(TextFormatterTest, ReportMetrics_WithBuckets) {
             "*** Done dumping ART internal metrics ***\n");
 }
 
+TEST(TextFormatterTest, ReportMetrics_LogHistogram) {
+  TextFormatter text_formatter;
+  std::vector<uint32_t> buckets(LogHistogramNumBuckets(4u), 0u);
+  buckets[LogHistogramBucketIndex(10u, 4u)] = 98u;
+  buckets[LogHistogramBucketIndex(1000u, 4u)] = 2u;
+
+  text_formatter.FormatReportLogHistogram(DatumId::kGcPauseTime, 4u, buckets);
+  text_formatter.FormatReportLogHistogram(DatumId::kJitTimeToOptimizedCode, 4u, {});
+
+  ASSERT_EQ(text_formatter.GetAndResetBuffer(),
+            "    GcPauseTime: count = 100, p50 = 10, p90 = 10, p99 = 1023, max = 1023\n"
+            "    JitTimeToOptimizedCode: count = 0\n");
+}
+
 TEST(TextFormatterTest, ReportMetrics_NoBuckets) {
   TextFormatter text_formatter;
   SessionData session_data{
@@ -79,6 +79,23 @@ std::vector<uint32_t> GetBuckets(
   return buckets;
 }
 
+template <DatumId histogram_type, size_t sub_bucket_bits>
+std::vector<uint32_t> GetBuckets(
+    const MetricsLogHistogram<histogram_type, sub_bucket_bits>& histogram) {
+  std::vector<uint32_t> buckets;
+  struct LogHistogramBackend : public TestBackendBase {
+    explicit LogHistogramBackend(std::vector<uint32_t>* buckets) : buckets_{buckets} {}
+
+    void ReportLogHistogram(DatumId, size_t, const std::vector<uint32_t>& buckets) override {
+      *buckets_ = buckets;
+    }
+
+    std::vector<uint32_t>* buckets_;
+  } backend{&buckets};
+  histogram.Report({&backend});
+  return buckets;
+}
+
 }  // namespace test
 }  // namespace metrics
 }  // namespace art
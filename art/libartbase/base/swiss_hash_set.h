@@ -0,0 +1,521 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_LIBARTBASE_BASE_SWISS_HASH_SET_H_
+#define ART_LIBARTBASE_BASE_SWISS_HASH_SET_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <android-base/logging.h>
+
+#include "bit_utils.h"
+#include "hash_set.h"
+#include "macros.h"
+
+namespace art {
+
+// Open addressing hash set in the style of the Abseil "Swiss tables". Each slot has a one-byte
+// control word holding either 7 bits of the hash of its element, or a marker for empty and
+// erased slots. Lookups probe groups of eight control words at a time with SWAR (SIMD within a
+// register) matching, and only touch the elements whose control word matches. `HashSet<>`
+// compares full elements on every probe, which is slower for lookup-heavy tables with large or
+// indirect (pointer or `GcRoot<>`) elements.
+//
+// The interface follows `HashSet<>`, with the same template arguments. The `EmptyFn` is not used
+// since the control words track the empty slots, so there is no reserved empty value. Unlike
+// `HashSet<>` this does not support preallocated buffers or `WriteToMemory()`, the image layout
+// of the runtime tables stays a `HashSet<>`.
+template <class T,
+          class EmptyFn = DefaultEmptyFn<T>,
+          class HashFn = DefaultHashFn<T>,
+          class Pred = DefaultPred<T>,
+          class Alloc = std::allocator<T>>
+class SwissHashSet {
+ public:
+  using value_type = T;
+  using allocator_type = Alloc;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = HashSetIterator<T, SwissHashSet>;
+  using const_iterator = HashSetIterator<const T, const SwissHashSet>;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+
+  // Number of control words matched at a time.
+  static constexpr size_t kGroupWidth = 8u;
+
+  void clear() {
+    DeallocateStorage();
+    num_elements_ = 0u;
+  }
+
+  SwissHashSet() : SwissHashSet(allocator_type()) {}
+  explicit SwissHashSet(const allocator_type& alloc) noexcept
+      : SwissHashSet(HashFn(), Pred(), alloc) {}
+
+  SwissHashSet(const HashFn& hashfn, const Pred& pred) noexcept
+      : SwissHashSet(hashfn, pred, allocator_type()) {}
+  SwissHashSet(const HashFn& hashfn, const Pred& pred, const allocator_type& alloc) noexcept
+      : allocfn_(alloc),
+        hashfn_(hashfn),
+        pred_(pred),
+        num_elements_(0u),
+        capacity_(0u),
+        growth_left_(0u),
+        ctrl_(nullptr),
+        slots_(nullptr) {}
+
+  SwissHashSet(const SwissHashSet& other)
+      : SwissHashSet(other.hashfn_, other.pred_, other.allocfn_) {
+    reserve(other.size());
+    for (const T& element : other) {
+      PutWithHash(element, hashfn_(element));
+    }
+  }
+
+  // noexcept required so that the move constructor is used instead of copy constructor.
+  SwissHashSet(SwissHashSet&& other) noexcept
+      : allocfn_(std::move(other.allocfn_)),
+        hashfn_(std::move(other.hashfn_)),
+        pred_(std::move(other.pred_)),
+        num_elements_(other.num_elements_),
+        capacity_(other.capacity_),
+        growth_left_(other.growth_left_),
+        ctrl_(other.ctrl_),
+        slots_(other.slots_) {
+    other.num_elements_ = 0u;
+    other.capacity_ = 0u;
+    other.growth_left_ = 0u;
+    other.ctrl_ = nullptr;
+    other.slots_ = nullptr;
+  }
+
+  ~SwissHashSet() {
+    DeallocateStorage();
+  }
+
+  SwissHashSet& operator=(SwissHashSet&& other) noexcept {
+    SwissHashSet(std::move(other)).swap(*this);  // NOLINT [runtime/explicit] [5]
+    return *this;
+  }
+
+  SwissHashSet& operator=(const SwissHashSet& other) {
+    SwissHashSet(other).swap(*this);  // NOLINT(runtime/explicit)
+    return *this;
+  }
+
+  iterator begin() {
+    iterator ret(this, 0);
+    if (capacity_ != 0 && IsFreeSlot(ret.index_)) {
+      ++ret;  // Skip all the empty slots.
+    }
+    return ret;
+  }
+
+  const_iterator begin() const {
+    const_iterator ret(this, 0);
+    if (capacity_ != 0 && IsFreeSlot(ret.index_)) {
+      ++ret;  // Skip all the empty slots.
+    }
+    return ret;
+  }
+
+  iterator end() {
+    return iterator(this, NumBuckets());
+  }
+
+  const_iterator end() const {
+    return const_iterator(this, NumBuckets());
+  }
+
+  size_t size() const {
+    return num_elements_;
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  // Erased slots become tombstones, unless no probe for another element could have gone past
+  // them, so erasing does not move elements and iteration never visits an element twice.
+  iterator erase(iterator it) {
+    const size_t index = it.index_;
+    DCHECK(!IsFreeSlot(index));
+    std::allocator_traits<allocator_type>::destroy(allocfn_, std::addressof(slots_[index]));
+    // A probe only continues past a group that has no empty slot. If there is no run of
+    // `kGroupWidth` non-empty slots through `index`, no group containing `index` was ever full.
+    const size_t before = (index - kGroupWidth) & (capacity_ - 1u);
+    const uint64_t empty_before = MatchEmpty(LoadGroup(before));
+    const uint64_t empty_after = MatchEmpty(LoadGroup(index));
+    const bool was_never_full =
+        empty_before != 0u &&
+        empty_after != 0u &&
+        (CTZ(empty_after) / kBitsPerByte) + (CLZ(empty_before) / kBitsPerByte) < kGroupWidth;
+    if (was_never_full) {
+      SetCtrl(index, kEmpty);
+      ++growth_left_;
+    } else {
+      SetCtrl(index, kDeleted);
+    }
+    --num_elements_;
+    ++it;
+    return it;
+  }
+
+  // Find an element, returns end() if not found. Allows custom key (K) types, like `HashSet<>`.
+  template <typename K>
+  iterator find(const K& key) {
+    return FindWithHash(key, hashfn_(key));
+  }
+
+  template <typename K>
+  const_iterator find(const K& key) const {
+    return FindWithHash(key, hashfn_(key));
+  }
+
+  template <typename K>
+  iterator FindWithHash(const K& key, size_t hash) {
+    return iterator(this, FindIndex(key, hash));
+  }
+
+  template <typename K>
+  const_iterator FindWithHash(const K& key, size_t hash) const {
+    return const_iterator(this, FindIndex(key, hash));
+  }
+
+  std::pair<iterator, bool> insert([[maybe_unused]] const_iterator hint, const T& element) {
+    return insert(element);
+  }
+  std::pair<iterator, bool> insert([[maybe_unused]] const_iterator hint, T&& element) {
+    return insert(std::move(element));
+  }
+
+  std::pair<iterator, bool> insert(const T& element) {
+    return InsertWithHash(element, hashfn_(element));
+  }
+  std::pair<iterator, bool> insert(T&& element) {
+    return InsertWithHash(std::move(element), hashfn_(element));
+  }
+
+  template <typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
+  std::pair<iterator, bool> InsertWithHash(U&& element, size_t hash) {
+    DCHECK_EQ(hash, hashfn_(element));
+    size_t index = FindIndex(element, hash);
+    if (index != NumBuckets()) {
+      return std::make_pair(iterator(this, index), false);
+    }
+    index = PrepareInsert(Mix(hash));
+    std::allocator_traits<allocator_type>::construct(
+        allocfn_, std::addressof(slots_[index]), std::forward<U>(element));
+    return std::make_pair(iterator(this, index), true);
+  }
+
+  // Insert an element known not to be in the `SwissHashSet<>`.
+  void Put(const T& element) {
+    return PutWithHash(element, hashfn_(element));
+  }
+  void Put(T&& element) {
+    return PutWithHash(std::move(element), hashfn_(element));
+  }
+
+  template <typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
+  void PutWithHash(U&& element, size_t hash) {
+    DCHECK_EQ(hash, hashfn_(element));
+    DCHECK(FindIndex(element, hash) == NumBuckets());
+    size_t index = PrepareInsert(Mix(hash));
+    std::allocator_traits<allocator_type>::construct(
+        allocfn_, std::addressof(slots_[index]), std::forward<U>(element));
+  }
+
+  void swap(SwissHashSet& other) {
+    // Use argument-dependent lookup with fall-back to std::swap() for function objects.
+    using std::swap;
+    swap(allocfn_, other.allocfn_);
+    swap(hashfn_, other.hashfn_);
+    swap(pred_, other.pred_);
+    std::swap(num_elements_, other.num_elements_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(growth_left_, other.growth_left_);
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(slots_, other.slots_);
+  }
+
+  allocator_type get_allocator() const {
+    return allocfn_;
+  }
+
+  // Reserve enough room to insert until size() == num_elements without requiring to grow the
+  // hash set. No-op if the hash set is already large enough to do this.
+  void reserve(size_t num_elements) {
+    if (num_elements_ + growth_left_ >= num_elements) {
+      return;
+    }
+    size_t capacity = kGroupWidth;
+    while (MaxElements(capacity) < num_elements) {
+      capacity *= 2u;
+    }
+    // Also drops the tombstones if the current capacity is enough.
+    Resize(std::max(capacity, capacity_));
+  }
+
+  double CalculateLoadFactor() const {
+    return static_cast<double>(size()) / static_cast<double>(NumBuckets());
+  }
+
+  size_t NumBuckets() const {
+    return capacity_;
+  }
+
+ private:
+  using CtrlAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<uint8_t>;
+
+  // Control words. A full slot holds the low 7 bits of the mixed hash, so the top bit tells
+  // full slots apart from empty and erased ones.
+  static constexpr uint8_t kEmpty = 0x80u;
+  static constexpr uint8_t kDeleted = 0xfeu;
+  static constexpr uint8_t kHashMask = 0x7fu;
+
+  static constexpr uint64_t kLsbs = UINT64_C(0x0101010101010101);
+  static constexpr uint64_t kMsbs = UINT64_C(0x8080808080808080);
+
+  // Spread the bits of weak hashes, such as the identity `std::hash<>` of integers and
+  // pointers, over both the control word and the probe start.
+  static ALWAYS_INLINE size_t Mix(size_t hash) {
+    uint64_t mixed = static_cast<uint64_t>(hash) * UINT64_C(0x9e3779b97f4a7c15);
+    return static_cast<size_t>(mixed ^ (mixed >> 32));
+  }
+
+  static ALWAYS_INLINE uint8_t H2(size_t mixed) {
+    return mixed & kHashMask;
+  }
+
+  // Load factor of 7/8. There is always an empty slot, so probing terminates.
+  static constexpr size_t MaxElements(size_t capacity) {
+    return capacity - capacity / 8u;
+  }
+
+  ALWAYS_INLINE size_t ProbeStart(size_t mixed) const {
+    return (mixed >> 7) & (capacity_ - 1u);
+  }
+
+  // The control words are little-endian in the loaded group, the first slot is the lowest byte.
+  ALWAYS_INLINE uint64_t LoadGroup(size_t index) const {
+    static_assert(kGroupWidth == sizeof(uint64_t));
+    uint64_t group;
+    memcpy(&group, ctrl_ + index, sizeof(group));
+    return group;
+  }
+
+  // The matching bytes have their top bit set. There can be false positives for bytes following
+  // a matching one, they fail the element comparison.
+  static ALWAYS_INLINE uint64_t MatchH2(uint64_t group, uint8_t h2) {
+    uint64_t x = group ^ (kLsbs * h2);
+    return (x - kLsbs) & ~x & kMsbs;
+  }
+
+  static ALWAYS_INLINE uint64_t MatchEmpty(uint64_t group) {
+    // Only `kEmpty` has the top bit set and the next one clear.
+    return group & (~group << 6) & kMsbs;
+  }
+
+  static ALWAYS_INLINE uint64_t MatchEmptyOrDeleted(uint64_t group) {
+    return group & kMsbs;
+  }
+
+  static ALWAYS_INLINE size_t LowestMatch(uint64_t match) {
+    return CTZ(match) / kBitsPerByte;
+  }
+
+  // The control words of the first group are cloned after the last slot, so that groups can
+  // be loaded from any slot without wrapping around.
+  ALWAYS_INLINE void SetCtrl(size_t index, uint8_t ctrl) {
+    ctrl_[index] = ctrl;
+    if (index < kGroupWidth) {
+      ctrl_[capacity_ + index] = ctrl;
+    }
+  }
+
+  T& ElementForIndex(size_t index) {
+    DCHECK_LT(index, NumBuckets());
+    DCHECK(!IsFreeSlot(index));
+    return slots_[index];
+  }
+
+  const T& ElementForIndex(size_t index) const {
+    DCHECK_LT(index, NumBuckets());
+    DCHECK(!IsFreeSlot(index));
+    return slots_[index];
+  }
+
+  bool IsFreeSlot(size_t index) const {
+    return (ctrl_[index] & ~kHashMask) != 0u;
+  }
+
+  // Find the slot for an element, or return NumBuckets() if not found, so that
+  // iterator(this, FindIndex(...)) == end().
+  template <typename K>
+  ALWAYS_INLINE size_t FindIndex(const K& element, size_t hash) const {
+    DCHECK_EQ(hashfn_(element), hash);
+    if (UNLIKELY(capacity_ == 0u)) {
+      return 0u;
+    }
+    const size_t mixed = Mix(hash);
+    const uint8_t h2 = H2(mixed);
+    const size_t mask = capacity_ - 1u;
+    size_t index = ProbeStart(mixed);
+    // Triangular probing over groups visits every group of a power of two sized table.
+    for (size_t step = kGroupWidth; ; step += kGroupWidth) {
+      const uint64_t group = LoadGroup(index);
+      for (uint64_t match = MatchH2(group, h2); match != 0u; match &= match - 1u) {
+        const size_t slot = (index + LowestMatch(match)) & mask;
+        if (LIKELY(pred_(slots_[slot], element))) {
+          return slot;
+        }
+      }
+      if (LIKELY(MatchEmpty(group) != 0u)) {
+        return capacity_;
+      }
+      DCHECK_LE(step, capacity_);
+      index = (index + step) & mask;
+    }
+  }
+
+  ALWAYS_INLINE size_t FindFirstNonFull(size_t mixed) const {
+    DCHECK_NE(capacity_, 0u);
+    const size_t mask = capacity_ - 1u;
+    size_t index = ProbeStart(mixed);
+    for (size_t step = kGroupWidth; ; step += kGroupWidth) {
+      const uint64_t match = MatchEmptyOrDeleted(LoadGroup(index));
+      if (LIKELY(match != 0u)) {
+        return (index + LowestMatch(match)) & mask;
+      }
+      DCHECK_LE(step, capacity_);
+      index = (index + step) & mask;
+    }
+  }
+
+  // Claim a slot for a new element with the given mixed hash, growing the table if needed.
+  size_t PrepareInsert(size_t mixed) {
+    size_t index = (capacity_ != 0u) ? FindFirstNonFull(mixed) : 0u;
+    // Reusing a tombstone does not need to grow the table.
+    if (UNLIKELY(growth_left_ == 0u) && (capacity_ == 0u || ctrl_[index] != kDeleted)) {
+      if (capacity_ != 0u && num_elements_ <= MaxElements(capacity_) / 2u) {
+        // At least half of the claimed slots are tombstones, drop them.
+        Resize(capacity_);
+      } else {
+        Resize(capacity_ != 0u ? capacity_ * 2u : kGroupWidth);
+      }
+      index = FindFirstNonFull(mixed);
+    }
+    if (ctrl_[index] == kEmpty) {
+      DCHECK_NE(growth_left_, 0u);
+      --growth_left_;
+    }
+    SetCtrl(index, H2(mixed));
+    ++num_elements_;
+    return index;
+  }
+
+  // Move all elements to a new table of `new_capacity` slots, dropping the tombstones.
+  void Resize(size_t new_capacity) {
+    DCHECK(IsPowerOfTwo(new_capacity));
+    DCHECK_GE(new_capacity, kGroupWidth);
+    DCHECK_LE(num_elements_, MaxElements(new_capacity));
+    uint8_t* const old_ctrl = ctrl_;
+    T* const old_slots = slots_;
+    const size_t old_capacity = capacity_;
+    AllocateStorage(new_capacity);
+    for (size_t i = 0; i != old_capacity; ++i) {
+      if ((old_ctrl[i] & ~kHashMask) == 0u) {
+        T& element = old_slots[i];
+        const size_t mixed = Mix(hashfn_(element));
+        const size_t index = FindFirstNonFull(mixed);
+        SetCtrl(index, H2(mixed));
+        std::allocator_traits<allocator_type>::construct(
+            allocfn_, std::addressof(slots_[index]), std::move(element));
+        std::allocator_traits<allocator_type>::destroy(allocfn_, std::addressof(element));
+      }
+    }
+    growth_left_ = MaxElements(new_capacity) - num_elements_;
+    if (old_capacity != 0u) {
+      CtrlAlloc(allocfn_).deallocate(old_ctrl, old_capacity + kGroupWidth);
+      allocfn_.deallocate(old_slots, old_capacity);
+    }
+  }
+
+  // Allocate the control words and uninitialized slots.
+  void AllocateStorage(size_t capacity) {
+    capacity_ = capacity;
+    ctrl_ = CtrlAlloc(allocfn_).allocate(capacity + kGroupWidth);
+    memset(ctrl_, kEmpty, capacity + kGroupWidth);
+    slots_ = allocfn_.allocate(capacity);
+  }
+
+  void DeallocateStorage() {
+    if (capacity_ != 0u) {
+      for (size_t i = 0; i != capacity_; ++i) {
+        if (!IsFreeSlot(i)) {
+          std::allocator_traits<allocator_type>::destroy(allocfn_, std::addressof(slots_[i]));
+        }
+      }
+      CtrlAlloc(allocfn_).deallocate(ctrl_, capacity_ + kGroupWidth);
+      allocfn_.deallocate(slots_, capacity_);
+    }
+    ctrl_ = nullptr;
+    slots_ = nullptr;
+    capacity_ = 0u;
+    growth_left_ = 0u;
+  }
+
+  size_t NextNonEmptySlot(size_t index) const {
+    const size_t num_buckets = NumBuckets();
+    DCHECK_LT(index, num_buckets);
+    do {
+      ++index;
+    } while (index < num_buckets && IsFreeSlot(index));
+    return index;
+  }
+
+  Alloc allocfn_;  // Allocator function.
+  HashFn hashfn_;  // Hashing function.
+  Pred pred_;  // Equals function.
+  size_t num_elements_;  // Number of inserted elements.
+  size_t capacity_;  // Number of slots, a power of two or zero.
+  size_t growth_left_;  // Number of empty slots that can be filled before growing.
+  uint8_t* ctrl_;  // Control words, `capacity_ + kGroupWidth` of them.
+  T* slots_;  // Element storage, only the full slots are constructed.
+
+  template <class Elem, class HashSetType>
+  friend class HashSetIterator;
+};
+
+template <class T, class EmptyFn, class HashFn, class Pred, class Alloc>
+void swap(SwissHashSet<T, EmptyFn, HashFn, Pred, Alloc>& lhs,
+          SwissHashSet<T, EmptyFn, HashFn, Pred, Alloc>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace art
+
+#endif  // ART_LIBARTBASE_BASE_SWISS_HASH_SET_H_
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "swiss_hash_set.h"
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "hash_set.h"
+#include "time_utils.h"
+
+namespace art {
+
+class SwissHashSetTest : public testing::Test {
+ public:
+  SwissHashSetTest() : seed_(97421), unique_number_(0) {}
+
+  std::string RandomString(size_t len) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < len; ++i) {
+      oss << static_cast<char>('A' + PRand() % 64);
+    }
+    oss << " " << unique_number_++;
+    return oss.str();
+  }
+
+  size_t PRand() {  // Pseudo random.
+    seed_ = seed_ * 1103515245 + 12345;
+    return seed_;
+  }
+
+ private:
+  size_t seed_;
+  size_t unique_number_;
+};
+
+TEST_F(SwissHashSetTest, TestSmoke) {
+  SwissHashSet<std::string> hash_set;
+  const std::string test_string = "hello world 1234";
+  ASSERT_TRUE(hash_set.empty());
+  ASSERT_EQ(hash_set.size(), 0U);
+  ASSERT_TRUE(hash_set.find(test_string) == hash_set.end());
+  auto [it, inserted] = hash_set.insert(test_string);
+  ASSERT_TRUE(inserted);
+  ASSERT_EQ(*it, test_string);
+  ASSERT_FALSE(hash_set.insert(test_string).second);
+  ASSERT_EQ(hash_set.size(), 1U);
+  ASSERT_EQ(*hash_set.find(test_string), test_string);
+  // The empty string is a valid element, there is no reserved empty value.
+  ASSERT_TRUE(hash_set.insert(std::string()).second);
+  ASSERT_EQ(hash_set.size(), 2U);
+  hash_set.erase(hash_set.find(test_string));
+  ASSERT_TRUE(hash_set.find(test_string) == hash_set.end());
+  ASSERT_FALSE(hash_set.find(std::string()) == hash_set.end());
+  ASSERT_EQ(hash_set.size(), 1U);
+}
+
+TEST_F(SwissHashSetTest, TestIterator) {
+  SwissHashSet<size_t> hash_set;
+  ASSERT_TRUE(hash_set.begin() == hash_set.end());
+  static constexpr size_t count = 1000;
+  for (size_t i = 0; i < count; ++i) {
+    hash_set.insert(i);
+  }
+  size_t total = 0;
+  size_t visited = 0;
+  for (size_t element : hash_set) {
+    total += element;
+    ++visited;
+  }
+  ASSERT_EQ(visited, count);
+  ASSERT_EQ(total, count * (count - 1) / 2);
+  // Erasing while iterating visits every remaining element once.
+  for (auto it = hash_set.begin(); it != hash_set.end();) {
+    if (*it % 2 == 0) {
+      it = hash_set.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ASSERT_EQ(hash_set.size(), count / 2);
+  for (size_t element : hash_set) {
+    ASSERT_EQ(element % 2, 1U);
+  }
+}
+
+TEST_F(SwissHashSetTest, TestStress) {
+  SwissHashSet<std::string> hash_set;
+  std::unordered_set<std::string> std_set;
+  std::vector<std::string> strings;
+  static constexpr size_t string_count = 2000;
+  static constexpr size_t operations = 100000;
+  static constexpr size_t target_size = 500;
+  for (size_t i = 0; i < string_count; ++i) {
+    strings.push_back(RandomString(i % 10 + 1));
+  }
+  // Erasing and inserting many times around a fixed size exercises the tombstone reuse.
+  for (size_t i = 0; i < operations; ++i) {
+    ASSERT_EQ(hash_set.size(), std_set.size());
+    const std::string& s = strings[PRand() % string_count];
+    if (PRand() % (2 * target_size) >= hash_set.size()) {
+      ASSERT_EQ(hash_set.insert(s).second, std_set.insert(s).second);
+      ASSERT_EQ(*hash_set.find(s), s);
+    } else {
+      auto it1 = hash_set.find(s);
+      auto it2 = std_set.find(s);
+      ASSERT_EQ(it1 == hash_set.end(), it2 == std_set.end());
+      if (it1 != hash_set.end()) {
+        hash_set.erase(it1);
+        std_set.erase(it2);
+      }
+    }
+  }
+  for (const std::string& s : strings) {
+    ASSERT_EQ(hash_set.find(s) == hash_set.end(), std_set.find(s) == std_set.end());
+  }
+  ASSERT_LT(hash_set.NumBuckets(), 8 * target_size);
+}
+
+TEST_F(SwissHashSetTest, TestCopyAndSwap) {
+  SwissHashSet<std::string> hash_seta;
+  SwissHashSet<std::string> hash_setb;
+  hash_seta.insert("TEST");
+  hash_setb.insert("TEST2");
+  SwissHashSet<std::string> hash_setc(hash_seta);
+  ASSERT_EQ(hash_setc.size(), 1U);
+  ASSERT_EQ(*hash_setc.begin(), "TEST");
+  hash_seta.swap(hash_setb);
+  ASSERT_EQ(*hash_seta.begin(), "TEST2");
+  ASSERT_EQ(*hash_setb.begin(), "TEST");
+  SwissHashSet<std::string> hash_setd(std::move(hash_seta));
+  ASSERT_TRUE(hash_seta.empty());  // NOLINT - checking the state after move.
+  ASSERT_EQ(*hash_setd.begin(), "TEST2");
+  hash_setd = hash_setc;
+  ASSERT_EQ(*hash_setd.begin(), "TEST");
+}
+
+TEST_F(SwissHashSetTest, TestReserve) {
+  SwissHashSet<size_t> hash_set;
+  hash_set.reserve(1000u);
+  const size_t num_buckets = hash_set.NumBuckets();
+  ASSERT_GE(num_buckets, 1000u);
+  for (size_t i = 0; i != 1000u; ++i) {
+    hash_set.Put(i);
+  }
+  ASSERT_EQ(num_buckets, hash_set.NumBuckets());
+  ASSERT_LT(hash_set.CalculateLoadFactor(), 1.0);
+}
+
+TEST_F(SwissHashSetTest, StringSearchStringView) {
+  SwissHashSet<std::string> hash_set;
+  std::string str = "some_string";
+  hash_set.insert(str);
+  auto it = hash_set.find(std::string_view(str));
+  ASSERT_TRUE(it != hash_set.end());
+  ASSERT_EQ(str, *it);
+}
+
+struct IsEmptyFnString {
+  void MakeEmpty(std::string& item) const {
+    item.clear();
+  }
+  bool IsEmpty(const std::string& item) const {
+    return item.empty();
+  }
+};
+
+// Compare lookups with `HashSet<>`, for elements that are expensive to compare.
+TEST_F(SwissHashSetTest, Speed) {
+  static constexpr size_t kCount = 100000;
+  static constexpr size_t kLookups = 1000000;
+  std::vector<std::string> strings;
+  for (size_t i = 0; i != kCount; ++i) {
+    strings.push_back(RandomString(16));
+  }
+  HashSet<std::string, IsEmptyFnString> hash_set;
+  SwissHashSet<std::string> swiss_hash_set;
+  for (size_t i = 0; i != kCount; i += 2) {
+    hash_set.insert(strings[i]);
+    swiss_hash_set.insert(strings[i]);
+  }
+  size_t found = 0u;
+  uint64_t start = NanoTime();
+  for (size_t i = 0; i != kLookups; ++i) {
+    found += (hash_set.find(strings[i % kCount]) != hash_set.end()) ? 1u : 0u;
+  }
+  uint64_t hash_set_time = NanoTime() - start;
+  start = NanoTime();
+  for (size_t i = 0; i != kLookups; ++i) {
+    found -= (swiss_hash_set.find(strings[i % kCount]) != swiss_hash_set.end()) ? 1u : 0u;
+  }
+  uint64_t swiss_hash_set_time = NanoTime() - start;
+  EXPECT_EQ(found, 0u);
+  LOG(INFO) << "HashSet lookups: " << PrettyDuration(hash_set_time)
+            << ", SwissHashSet lookups: " << PrettyDuration(swiss_hash_set_time);
+}
+
+}  // namespace art
@@ -73,6 +73,9 @@ class ZipEntry {
   bool IsUncompressed();
   bool IsAlignedTo(size_t alignment) const;
 
+  // Offset of the entry data from the start of the zip archive.
+  uint64_t GetOffset() const;
+
  private:
   ZipEntry(ZipArchiveHandle handle,
            ::ZipEntry* zip_entry,
@@ -122,6 +122,36 @@ class MemMapContainer : public DexFileContainer {
   DISALLOW_COPY_AND_ASSIGN(MemMapContainer);
 };
 
+// Refers to an uncompressed entry of a zip archive held in memory by another container,
+// which it keeps alive.
+class ZipEntryInMemoryContainer : public DexFileContainer {
+ public:
+  ZipEntryInMemoryContainer(std::shared_ptr<DexFileContainer> parent,
+                            const uint8_t* begin,
+                            size_t size)
+      : parent_(std::move(parent)), begin_(begin), end_(begin + size) {
+    DCHECK(parent_->IsReadOnly());
+    DCHECK_LE(parent_->Begin(), begin_);
+    DCHECK_LE(end_, parent_->End());
+  }
+
+  bool IsReadOnly() const override { return true; }
+
+  bool EnableWrite() override { return false; }
+
+  bool DisableWrite() override { return false; }
+
+  const uint8_t* Begin() const override { return begin_; }
+
+  const uint8_t* End() const override { return end_; }
+
+ private:
+  const std::shared_ptr<DexFileContainer> parent_;
+  const uint8_t* const begin_;
+  const uint8_t* const end_;
+  DISALLOW_COPY_AND_ASSIGN(ZipEntryInMemoryContainer);
+};
+
 }  // namespace
 
 const File DexFileLoader::kInvalidFile;
@@ -526,10 +556,27 @@ bool DexFileLoader::OpenFromZipEntry(const ZipArchive& zip_archive,
     return false;
   }
 
+  std::shared_ptr<DexFileContainer> container;
+  if (!file_->IsValid() && root_container_ != nullptr && root_container_->IsReadOnly() &&
+      zip_entry->IsUncompressed()) {
+    // The zip archive is in memory, so refer to the data of uncompressed entries there
+    // rather than copying it.
+    uint64_t offset = zip_entry->GetOffset();
+    uint32_t length = zip_entry->GetUncompressedLength();
+    if (offset <= root_container_->Size() &&
+        length <= root_container_->Size() - offset &&
+        IsAligned<alignof(DexFile::Header)>(root_container_->Begin() + offset)) {
+      container = std::make_shared<ZipEntryInMemoryContainer>(
+          root_container_, root_container_->Begin() + offset, length);
+    }
+  }
+
   CHECK(MemMap::IsInitialized());
   MemMap map;
   bool is_file_map = false;
-  if (file_->IsValid() && zip_entry->IsUncompressed()) {
+  if (container != nullptr) {
+    // Already in memory.
+  } else if (file_->IsValid() && zip_entry->IsUncompressed()) {
     if (!zip_entry->IsAlignedTo(alignof(DexFile::Header))) {
       // Do not mmap unaligned ZIP entries because
       // doing so would fail dex verification which requires 4 byte alignment.
@@ -547,22 +594,26 @@ bool DexFileLoader::OpenFromZipEntry(const ZipArchive& zip_archive,
       is_file_map = true;
     }
   }
-  if (!map.IsValid()) {
+  if (container == nullptr && !map.IsValid()) {
     DEXFILE_SCOPED_TRACE(std::string("Extract dex file ") + location);
 
     // Default path for compressed ZIP entries,
     // and fallback for stored ZIP entries.
     map = zip_entry->ExtractToMemMap(location.c_str(), entry_name, error_msg);
   }
-  if (!map.IsValid()) {
-    *error_msg = StringPrintf("Failed to extract '%s' from '%s': %s", entry_name, location.c_str(),
-                              error_msg->c_str());
-    *error_code = DexFileLoaderErrorCode::kExtractToMemoryError;
-    return false;
+  if (container == nullptr) {
+    if (!map.IsValid()) {
+      *error_msg = StringPrintf("Failed to extract '%s' from '%s': %s",
+                                entry_name,
+                                location.c_str(),
+                                error_msg->c_str());
+      *error_code = DexFileLoaderErrorCode::kExtractToMemoryError;
+      return false;
+    }
+    container = std::make_shared<MemMapContainer>(std::move(map), is_file_map);
   }
-  auto container = std::make_shared<MemMapContainer>(std::move(map), is_file_map);
   container->SetIsZip();
-  if (!container->DisableWrite()) {
+  if (!container->IsReadOnly() && !container->DisableWrite()) {
     *error_msg = StringPrintf("Failed to make dex file '%s' read only", location.c_str());
     *error_code = DexFileLoaderErrorCode::kMakeReadOnlyError;
     return false;
@@ -227,6 +227,28 @@ static const char kRawZipThreeDexFiles[] =
   "ACACAAALABgAAAAAAAAAAACgge4CAABjbGFzc2VzLmRleFVUBQADAWPlV3V4CwABBOQDAQAEiBMA"
   "AFBLBQYAAAAAAwADAPUAAABkBAAAAAA=";
 
+// kRawDex stored uncompressed as classes.dex, with the data aligned to 4 bytes.
+static const char kRawZipUncompressedAligned[] =
+  "UEsDBBQAAAAAAAAAIUj4CtPziAMAAIgDAAALAAcAY2xhc3Nlcy5kZXg12QMAAAAAZGV4CjAzNQAQ"
+  "edgAe7gM1B/WHsWJ6L7lGAISGC7yjD2IAwAAcAAAAHhWNBIAAAAAAAAAAMQCAAAPAAAAcAAAAAcA"
+  "AACsAAAAAgAAAMgAAAABAAAA4AAAAAMAAADoAAAAAgAAAAABAABIAgAAQAEAAK4BAAC2AQAAvQEA"
+  "AM0BAADXAQAA+wEAABsCAAA+AgAAUgIAAF8CAABiAgAAZgIAAHMCAAB5AgAAgQIAAAIAAAADAAAA"
+  "BAAAAAUAAAAGAAAABwAAAAkAAAAJAAAABgAAAAAAAAAKAAAABgAAAKgBAAAAAAEADQAAAAAAAQAA"
+  "AAAAAQAAAAAAAAAFAAAAAAAAAAAAAAAAAAAABQAAAAAAAAAIAAAAiAEAAKsCAAAAAAAAAQAAAAAA"
+  "AAAFAAAAAAAAAAgAAACYAQAAuAIAAAAAAAACAAAAlAIAAJoCAAABAAAAowIAAAIAAgABAAAAiAIA"
+  "AAYAAABbAQAAcBACAAAADgABAAEAAQAAAI4CAAAEAAAAcBACAAAADgBAAQAAAAAAAAAAAAAAAAAA"
+  "TAEAAAAAAAAAAAAAAAAAAAEAAAABAAY8aW5pdD4ABUlubmVyAA5MTmVzdGVkJElubmVyOwAITE5l"
+  "c3RlZDsAIkxkYWx2aWsvYW5ub3RhdGlvbi9FbmNsb3NpbmdDbGFzczsAHkxkYWx2aWsvYW5ub3Rh"
+  "dGlvbi9Jbm5lckNsYXNzOwAhTGRhbHZpay9hbm5vdGF0aW9uL01lbWJlckNsYXNzZXM7ABJMamF2"
+  "YS9sYW5nL09iamVjdDsAC05lc3RlZC5qYXZhAAFWAAJWTAALYWNjZXNzRmxhZ3MABG5hbWUABnRo"
+  "aXMkMAAFdmFsdWUAAgEABw4AAQAHDjwAAgIBDhgBAgMCCwQADBcBAgQBDhwBGAAAAQEAAJAgAICA"
+  "BNQCAAABAAGAgATwAgAAEAAAAAAAAAABAAAAAAAAAAEAAAAPAAAAcAAAAAIAAAAHAAAArAAAAAMA"
+  "AAACAAAAyAAAAAQAAAABAAAA4AAAAAUAAAADAAAA6AAAAAYAAAACAAAAAAEAAAMQAAACAAAAQAEA"
+  "AAEgAAACAAAAVAEAAAYgAAACAAAAiAEAAAEQAAABAAAAqAEAAAIgAAAPAAAArgEAAAMgAAACAAAA"
+  "iAIAAAQgAAADAAAAlAIAAAAgAAACAAAAqwIAAAAQAAABAAAAxAIAAFBLAQIUAxQAAAAAAAAAIUj4"
+  "CtPziAMAAIgDAAALAAcAAAAAAAAAAACAAQAAAABjbGFzc2VzLmRleDXZAwAAAABQSwUGAAAAAAEA"
+  "AQBAAAAAuAMAAAAA";
+
 static const char kRawDexBadMapOffset[] =
   "ZGV4CjAzNQAZKGSz85r+tXJ1I24FYi+FpQtWbXtelAmoAQAAcAAAAHhWNBIAAAAAAAAAAEAwIBAF"
   "AAAAcAAAAAMAAACEAAAAAQAAAJAAAAAAAAAAAAAAAAIAAACcAAAAAQAAAKwAAADcAAAAzAAAAOQA"
@@ -597,6 +619,24 @@ TEST_F(DexFileLoaderTest, ZipOpenThreeDexFiles) {
   EXPECT_EQ(dex_files.size(), 3u);
 }
 
+TEST_F(DexFileLoaderTest, ZipOpenUncompressedInMemory) {
+  std::vector<uint8_t> dex_bytes;
+  std::vector<std::unique_ptr<const DexFile>> dex_files;
+  DexFileLoaderErrorCode error_code;
+  std::string error_msg;
+  ASSERT_TRUE(OpenDexFilesBase64(kRawZipUncompressedAligned,
+                                 kLocationString,
+                                 &dex_bytes,
+                                 &dex_files,
+                                 &error_code,
+                                 &error_msg)) << error_msg;
+  ASSERT_EQ(dex_files.size(), 1u);
+  // The dex file refers to the entry data in the zip archive instead of a copy.
+  EXPECT_GE(dex_files[0]->Begin(), dex_bytes.data());
+  EXPECT_LT(dex_files[0]->Begin(), dex_bytes.data() + dex_bytes.size());
+  EXPECT_TRUE(dex_files[0]->IsReadOnly());
+}
+
 TEST_F(DexFileLoaderTest, OpenDexBadMapOffset) {
   std::vector<uint8_t> dex_bytes;
   std::unique_ptr<const DexFile> raw =
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <bitset>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <stack>
@@ -1772,6 +1773,15 @@ bool DexFileVerifier::CheckIntraCodeItem() {
   return true;
 }
 
+// Returns whether all bytes of `word` encode non-nul ASCII characters (bit pattern 0xxx,
+// except 0), which need no further checks.
+static ALWAYS_INLINE bool IsNonNulAsciiWord(uint64_t word) {
+  constexpr uint64_t kLowBits = UINT64_C(0x0101010101010101);
+  constexpr uint64_t kHighBits = UINT64_C(0x8080808080808080);
+  // A byte has the high bit set in `word - kLowBits` and clear in `word` only if it is 0.
+  return ((word | ((word - kLowBits) & ~word)) & kHighBits) == 0u;
+}
+
 bool DexFileVerifier::CheckIntraStringDataItem() {
   DECODE_UNSIGNED_CHECKED_FROM(ptr_, size);
   const uint8_t* file_end = EndOfFile();
@@ -1786,6 +1796,17 @@ bool DexFileVerifier::CheckIntraStringDataItem() {
 
   for (uint32_t i = 0; i < size; i++) {
     CHECK_LT(i, size);  // b/15014252 Prevents hitting the impossible case below
+    // Most string data is ASCII, so check eight characters at a time when possible.
+    // Each remaining character takes at least one of the bytes subtracted above.
+    if (size - i >= sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, ptr_, sizeof(word));
+      if (IsNonNulAsciiWord(word)) {
+        ptr_ += sizeof(uint64_t);
+        i += sizeof(uint64_t) - 1u;
+        continue;
+      }
+    }
     uint8_t byte = *(ptr_++);
 
     // Switch on the high 4 bits.
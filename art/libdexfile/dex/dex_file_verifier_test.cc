@@ -18,6 +18,7 @@
 
 #include <zlib.h>
 
+#include <cstring>
 #include <functional>
 #include <memory>
 
@@ -174,6 +175,44 @@ TEST_F(DexFileVerifierTest, MethodId) {
       "Bad index for method_id.name");
 }
 
+// Returns a writable pointer to the character at `pos` of the first string of the dex
+// file with at least 16 characters, all of them ASCII.
+static char* GetLongAsciiStringChar(DexFile* dex_file, size_t pos) {
+  CHECK_LT(pos, 16u);
+  for (uint32_t i = 0; i < dex_file->NumStringIds(); ++i) {
+    uint32_t utf16_length;
+    const char* data =
+        dex_file->GetStringDataAndUtf16Length(dex::StringIndex(i), &utf16_length);
+    if (utf16_length >= 16u && strlen(data) == utf16_length) {
+      return const_cast<char*>(data) + pos;
+    }
+  }
+  LOG(FATAL) << "No long ASCII string";
+  UNREACHABLE();
+}
+
+TEST_F(DexFileVerifierTest, StringData) {
+  // Invalid bytes following a run of eight ASCII characters.
+  VerifyModification(
+      kGoodTestDex,
+      "string_data_illegal_start_byte",
+      [](DexFile* dex_file) { *GetLongAsciiStringChar(dex_file, 10) = '\x80'; },
+      "Illegal start byte 80 in string data");
+
+  VerifyModification(
+      kGoodTestDex,
+      "string_data_nul",
+      [](DexFile* dex_file) { *GetLongAsciiStringChar(dex_file, 10) = '\0'; },
+      "String data shorter than indicated utf16_size");
+
+  // Invalid bytes within the first eight ASCII characters.
+  VerifyModification(
+      kGoodTestDex,
+      "string_data_illegal_start_byte_in_word",
+      [](DexFile* dex_file) { *GetLongAsciiStringChar(dex_file, 3) = '\xff'; },
+      "Illegal start byte ff in string data");
+}
+
 TEST_F(DexFileVerifierTest, InitCachingWithUnicode) {
   static const char kInitWithUnicode[] =
       "ZGV4CjAzNQDhN60rgMnSK13MoRscTuD+NZe7f6rIkHAAAgAAcAAAAHhWNBIAAAAAAAAAAGwBAAAJ"
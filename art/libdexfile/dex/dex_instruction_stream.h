@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_LIBDEXFILE_DEX_DEX_INSTRUCTION_STREAM_H_
+#define ART_LIBDEXFILE_DEX_DEX_INSTRUCTION_STREAM_H_
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <android-base/logging.h>
+
+#include "base/macros.h"
+#include "code_item_accessors.h"
+#include "dex_instruction-inl.h"
+
+namespace art {
+
+// Instructions of a code item decoded once into a struct of arrays of dex pcs, opcodes and
+// vA/vB/vC operands. `Instruction::VRegA()` and friends switch on the instruction format on
+// every call; analyses that visit instructions many times, or that only need the opcodes and
+// operands, can share one decoded stream instead.
+//
+// The `Allocator` is rebound for each array, so the compiler can keep the stream in an arena
+// with `ArenaAllocator::Adapter()`.
+template <typename Allocator = std::allocator<uint32_t>>
+class DexInstructionStream {
+ public:
+  explicit DexInstructionStream(const Allocator& allocator = Allocator())
+      : dex_pcs_(allocator),
+        opcodes_(allocator),
+        vreg_a_(allocator),
+        vreg_b_(allocator),
+        vreg_c_(allocator) {}
+
+  explicit DexInstructionStream(const CodeItemInstructionAccessor& accessor,
+                                const Allocator& allocator = Allocator())
+      : DexInstructionStream(allocator) {
+    Decode(accessor);
+  }
+
+  void Decode(const CodeItemInstructionAccessor& accessor) {
+    Decode(accessor.Insns(), accessor.InsnsSizeInCodeUnits());
+  }
+
+  // Decode the instructions in `insns`, replacing the previous contents of the stream. Decoding
+  // stops at the first instruction that does not fit in `insns_size_in_code_units`, so this is
+  // safe to use on unverified code.
+  void Decode(const uint16_t* insns, uint32_t insns_size_in_code_units) {
+    dex_pcs_.clear();
+    opcodes_.clear();
+    vreg_a_.clear();
+    vreg_b_.clear();
+    vreg_c_.clear();
+    insns_ = insns;
+    insns_size_in_code_units_ = insns_size_in_code_units;
+    uint32_t dex_pc = 0u;
+    while (dex_pc < insns_size_in_code_units) {
+      const Instruction* inst = Instruction::At(insns + dex_pc);
+      const uint32_t available = insns_size_in_code_units - dex_pc;
+      if (inst->CodeUnitsRequiredForSizeComputation() > available ||
+          inst->SizeInCodeUnits() > available) {
+        break;
+      }
+      DecodeInstruction(*inst, dex_pc);
+      dex_pc += inst->SizeInCodeUnits();
+    }
+    end_dex_pc_ = dex_pc;
+  }
+
+  size_t Size() const {
+    return dex_pcs_.size();
+  }
+
+  bool IsEmpty() const {
+    return dex_pcs_.empty();
+  }
+
+  uint32_t DexPc(size_t index) const {
+    DCHECK_LT(index, Size());
+    return dex_pcs_[index];
+  }
+
+  Instruction::Code Opcode(size_t index) const {
+    DCHECK_LT(index, Size());
+    return static_cast<Instruction::Code>(opcodes_[index]);
+  }
+
+  Instruction::Format FormatOf(size_t index) const {
+    return Instruction::FormatOf(Opcode(index));
+  }
+
+  // The operands, as returned by `Instruction::VRegA()`, `VRegB()` and `VRegC()`. They are 0
+  // for instructions whose format does not have the operand.
+  int32_t VRegA(size_t index) const {
+    DCHECK_LT(index, Size());
+    return vreg_a_[index];
+  }
+
+  int32_t VRegB(size_t index) const {
+    DCHECK_LT(index, Size());
+    return vreg_b_[index];
+  }
+
+  int32_t VRegC(size_t index) const {
+    DCHECK_LT(index, Size());
+    return vreg_c_[index];
+  }
+
+  size_t SizeInCodeUnits(size_t index) const {
+    DCHECK_LT(index, Size());
+    uint32_t next_dex_pc = (index + 1u != Size()) ? dex_pcs_[index + 1u] : end_dex_pc_;
+    return next_dex_pc - dex_pcs_[index];
+  }
+
+  // The undecoded instruction, for the less common operands such as the wide vB of
+  // `const-wide`, vH, or the argument registers of invokes.
+  const Instruction& InstructionAt(size_t index) const {
+    return *Instruction::At(insns_ + DexPc(index));
+  }
+
+  // Return the index of the instruction at `dex_pc`, or `Size()` if no decoded instruction
+  // starts there.
+  size_t IndexOf(uint32_t dex_pc) const {
+    auto it = std::lower_bound(dex_pcs_.begin(), dex_pcs_.end(), dex_pc);
+    return (it != dex_pcs_.end() && *it == dex_pc) ? it - dex_pcs_.begin() : Size();
+  }
+
+  // Whether all of the code item was decoded.
+  bool IsComplete() const {
+    return end_dex_pc_ == insns_size_in_code_units_;
+  }
+
+ private:
+  template <typename T>
+  using Vector =
+      std::vector<T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>;
+
+  ALWAYS_INLINE void DecodeInstruction(const Instruction& inst, uint32_t dex_pc) {
+    const uint16_t inst_data = inst.Fetch16(0);
+    const Instruction::Code opcode = inst.Opcode(inst_data);
+    const Instruction::Format format = Instruction::FormatOf(opcode);
+    int32_t vreg_a = 0;
+    int32_t vreg_b = 0;
+    int32_t vreg_c = 0;
+    // One switch per instruction instead of one per accessor call.
+    switch (format) {
+      case Instruction::k10x:
+        // Also the format of the payload pseudo-instructions, which have no operands.
+      case Instruction::k10t:
+      case Instruction::k11x:
+      case Instruction::k20t:
+      case Instruction::k30t:
+        vreg_a = inst.VRegA(format, inst_data);
+        break;
+      case Instruction::k11n:
+      case Instruction::k12x:
+      case Instruction::k21c:
+      case Instruction::k21h:
+      case Instruction::k21s:
+      case Instruction::k21t:
+      case Instruction::k22x:
+      case Instruction::k31c:
+      case Instruction::k31i:
+      case Instruction::k31t:
+      case Instruction::k32x:
+      case Instruction::k51l:
+        vreg_a = inst.VRegA(format, inst_data);
+        vreg_b = inst.VRegB(format, inst_data);
+        break;
+      case Instruction::k22b:
+      case Instruction::k22c:
+      case Instruction::k22s:
+      case Instruction::k22t:
+      case Instruction::k23x:
+      case Instruction::k35c:
+      case Instruction::k3rc:
+      case Instruction::k45cc:
+      case Instruction::k4rcc:
+        vreg_a = inst.VRegA(format, inst_data);
+        vreg_b = inst.VRegB(format, inst_data);
+        vreg_c = inst.VRegC(format);
+        break;
+      case Instruction::kInvalidFormat:
+        break;
+    }
+    dex_pcs_.push_back(dex_pc);
+    opcodes_.push_back(static_cast<uint8_t>(opcode));
+    vreg_a_.push_back(vreg_a);
+    vreg_b_.push_back(vreg_b);
+    vreg_c_.push_back(vreg_c);
+  }
+
+  const uint16_t* insns_ = nullptr;
+  uint32_t insns_size_in_code_units_ = 0u;
+  uint32_t end_dex_pc_ = 0u;
+
+  Vector<uint32_t> dex_pcs_;
+  Vector<uint8_t> opcodes_;
+  Vector<int32_t> vreg_a_;
+  Vector<int32_t> vreg_b_;
+  Vector<int32_t> vreg_c_;
+
+  DISALLOW_COPY_AND_ASSIGN(DexInstructionStream);
+};
+
+}  // namespace art
+
+#endif  // ART_LIBDEXFILE_DEX_DEX_INSTRUCTION_STREAM_H_
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dex_instruction_stream.h"
+
+#include <iterator>
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+static const uint16_t kCode[] = {
+    0x3112,                                    // const/4 v1, #+3
+    0x0090, 0x0201,                            // add-int v0, v1, v2
+    0x0218, 0x5678, 0x1234, 0x0000, 0x0000,    // const-wide v2, #+0x12345678
+    0x2071, 0x0007, 0x0021,                    // invoke-static {v1, v2}, meth@7
+    0x000e,                                    // return-void
+};
+
+TEST(DexInstructionStream, Decode) {
+  DexInstructionStream<> stream;
+  stream.Decode(kCode, std::size(kCode));
+  ASSERT_EQ(5u, stream.Size());
+  EXPECT_TRUE(stream.IsComplete());
+
+  EXPECT_EQ(Instruction::CONST_4, stream.Opcode(0));
+  EXPECT_EQ(1, stream.VRegA(0));
+  EXPECT_EQ(3, stream.VRegB(0));
+
+  EXPECT_EQ(Instruction::ADD_INT, stream.Opcode(1));
+  EXPECT_EQ(1u, stream.DexPc(1));
+  EXPECT_EQ(0, stream.VRegA(1));
+  EXPECT_EQ(1, stream.VRegB(1));
+  EXPECT_EQ(2, stream.VRegC(1));
+
+  EXPECT_EQ(Instruction::CONST_WIDE, stream.Opcode(2));
+  EXPECT_EQ(5u, stream.SizeInCodeUnits(2));
+  EXPECT_EQ(0x12345678u, stream.InstructionAt(2).WideVRegB());
+
+  EXPECT_EQ(Instruction::INVOKE_STATIC, stream.Opcode(3));
+  EXPECT_EQ(8u, stream.DexPc(3));
+  EXPECT_EQ(2, stream.VRegA(3));
+  EXPECT_EQ(7, stream.VRegB(3));
+  EXPECT_EQ(1, stream.VRegC(3));
+
+  EXPECT_EQ(Instruction::RETURN_VOID, stream.Opcode(4));
+  EXPECT_EQ(1u, stream.SizeInCodeUnits(4));
+
+  // The decoded operands match the per-call accessors.
+  for (size_t i = 0; i != stream.Size(); ++i) {
+    const Instruction& inst = stream.InstructionAt(i);
+    EXPECT_EQ(inst.Opcode(), stream.Opcode(i));
+    EXPECT_EQ(inst.SizeInCodeUnits(), stream.SizeInCodeUnits(i));
+    EXPECT_EQ(inst.VRegA(), stream.VRegA(i));
+    EXPECT_EQ(inst.HasVRegB() ? inst.VRegB() : 0, stream.VRegB(i));
+    EXPECT_EQ(inst.HasVRegC() ? inst.VRegC() : 0, stream.VRegC(i));
+    EXPECT_EQ(i, stream.IndexOf(stream.DexPc(i)));
+  }
+  // No instruction starts in the middle of `const-wide`.
+  EXPECT_EQ(stream.Size(), stream.IndexOf(4u));
+}
+
+TEST(DexInstructionStream, Truncated) {
+  // Cut the code in the middle of the invoke.
+  DexInstructionStream<> stream;
+  stream.Decode(kCode, 10u);
+  EXPECT_EQ(3u, stream.Size());
+  EXPECT_FALSE(stream.IsComplete());
+  EXPECT_EQ(5u, stream.SizeInCodeUnits(2));
+
+  // Decoding again replaces the previous instructions.
+  stream.Decode(kCode, 1u);
+  EXPECT_EQ(1u, stream.Size());
+  EXPECT_TRUE(stream.IsComplete());
+  stream.Decode(kCode, 0u);
+  EXPECT_TRUE(stream.IsEmpty());
+}
+
+}  // namespace art
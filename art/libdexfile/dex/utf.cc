@@ -20,6 +20,8 @@
 #include <android-base/stringprintf.h>
 #include <android-base/strings.h>
 
+#include <cstring>
+
 #include "base/casts.h"
 #include "utf-inl.h"
 
@@ -27,6 +29,32 @@ namespace art {
 
 using android::base::StringAppendF;
 
+// Modified UTF-8 data is mostly ASCII, so the functions below look for runs of ASCII
+// characters, which need no decoding, by checking eight bytes at a time.
+static constexpr size_t kAsciiWordSize = sizeof(uint64_t);
+
+static ALWAYS_INLINE bool IsAsciiWord(const char* utf8) {
+  uint64_t word;
+  memcpy(&word, utf8, sizeof(word));
+  return (word & UINT64_C(0x8080808080808080)) == 0u;
+}
+
+// Powers of the hash multiplier, to hash several characters with a short dependency chain.
+static constexpr uint32_t kHashMultiplier2 = 31u * 31u;
+static constexpr uint32_t kHashMultiplier3 = kHashMultiplier2 * 31u;
+static constexpr uint32_t kHashMultiplier4 = kHashMultiplier3 * 31u;
+
+// Equivalent to four steps of `hash = hash * 31 + c` with the characters at `chars`.
+template <typename CharType>
+static ALWAYS_INLINE uint32_t UpdateHashWithFourChars(uint32_t hash, const CharType* chars) {
+  using UnsignedCharType = std::make_unsigned_t<CharType>;
+  return hash * kHashMultiplier4 +
+         static_cast<UnsignedCharType>(chars[0]) * kHashMultiplier3 +
+         static_cast<UnsignedCharType>(chars[1]) * kHashMultiplier2 +
+         static_cast<UnsignedCharType>(chars[2]) * 31u +
+         static_cast<UnsignedCharType>(chars[3]);
+}
+
 // This is used only from debugger and test code.
 size_t CountModifiedUtf8Chars(const char* utf8) {
   return CountModifiedUtf8Chars(utf8, strlen(utf8));
@@ -52,6 +80,11 @@ size_t CountModifiedUtf8Chars(const char* utf8, size_t byte_count) {
   size_t len = 0;
   const char* end = utf8 + byte_count;
   for (; utf8 < end; ++utf8) {
+    if (static_cast<size_t>(end - utf8) >= kAsciiWordSize && IsAsciiWord(utf8)) {
+      len += kAsciiWordSize;
+      utf8 += kAsciiWordSize - 1u;  // The loop increment moves past the last character.
+      continue;
+    }
     int ic = *utf8;
     len++;
     if (LIKELY((ic & 0x80) == 0)) {
@@ -110,6 +143,13 @@ void ConvertModifiedUtf8ToUtf16(uint16_t* utf16_data_out, size_t out_chars,
 
   // String contains non-ASCII characters.
   for (const char *p = in_start; p < in_end;) {
+    if (static_cast<size_t>(in_end - p) >= kAsciiWordSize && IsAsciiWord(p)) {
+      for (size_t i = 0; i != kAsciiWordSize; ++i) {
+        *out_p++ = static_cast<uint16_t>(p[i]);
+      }
+      p += kAsciiWordSize;
+      continue;
+    }
     const uint32_t ch = GetUtf16FromUtf8(&p);
     const uint16_t leading = GetLeadingUtf16Char(ch);
     const uint16_t trailing = GetTrailingUtf16Char(ch);
@@ -143,6 +183,14 @@ void ConvertUtf16ToModifiedUtf8(char* utf8_out, size_t byte_count,
 int32_t ComputeUtf16HashFromModifiedUtf8(const char* utf8, size_t utf16_length) {
   uint32_t hash = 0;
   while (utf16_length != 0u) {
+    // Each UTF-16 character takes at least one byte, so the next eight bytes are readable.
+    if (utf16_length >= kAsciiWordSize && IsAsciiWord(utf8)) {
+      hash = UpdateHashWithFourChars(hash, utf8);
+      hash = UpdateHashWithFourChars(hash, utf8 + 4u);
+      utf8 += kAsciiWordSize;
+      utf16_length -= kAsciiWordSize;
+      continue;
+    }
     const uint32_t pair = GetUtf16FromUtf8(&utf8);
     const uint16_t first = GetLeadingUtf16Char(pair);
     hash = hash * 31 + first;
@@ -158,16 +206,16 @@ int32_t ComputeUtf16HashFromModifiedUtf8(const char* utf8, size_t utf16_length)
 }
 
 uint32_t ComputeModifiedUtf8Hash(const char* chars) {
-  uint32_t hash = StartModifiedUtf8Hash();
-  while (*chars != '\0') {
-    hash = UpdateModifiedUtf8Hash(hash, *chars);
-    ++chars;
-  }
-  return hash;
+  return ComputeModifiedUtf8Hash(std::string_view(chars));
 }
 
 uint32_t ComputeModifiedUtf8Hash(std::string_view chars) {
-  return UpdateModifiedUtf8Hash(StartModifiedUtf8Hash(), chars);
+  uint32_t hash = StartModifiedUtf8Hash();
+  size_t i = 0u;
+  for (; chars.size() - i >= 4u; i += 4u) {
+    hash = UpdateHashWithFourChars(hash, chars.data() + i);
+  }
+  return UpdateModifiedUtf8Hash(hash, chars.substr(i));
 }
 
 int CompareModifiedUtf8ToUtf16AsCodePointValues(const char* utf8, const uint16_t* utf16,
@@ -17,6 +17,7 @@
 #include "utf.h"
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include <android-base/stringprintf.h>
@@ -387,6 +388,51 @@ TEST_F(UtfTest, NonAscii) {
   EXPECT_EQ(static_cast<uint8_t>(kNonAsciiCharacter), hash);
 }
 
+// Checks the functions with ASCII fast paths against the character by character decoding
+// for strings mixing runs of ASCII characters of all lengths with multi-byte sequences.
+TEST_F(UtfTest, MixedAsciiRuns) {
+  const std::vector<std::string> kSequences = {
+      "\xc4\x81",                  // Two byte encoding.
+      "\xc0\x80",                  // Two byte encoding of 0.
+      "\xed\xbb\xb0",              // Three byte encoding.
+      "\xf0\x90\xa0\x82",          // Four byte encoding.
+  };
+  for (const std::string& sequence : kSequences) {
+    for (size_t ascii_length = 0u; ascii_length != 20u; ++ascii_length) {
+      std::string utf8;
+      for (size_t i = 0u; i != 3u; ++i) {
+        for (size_t j = 0u; j != ascii_length + i; ++j) {
+          utf8 += static_cast<char>('a' + (i + j) % 26u);
+        }
+        utf8 += sequence;
+      }
+
+      std::vector<uint16_t> expected;
+      for (const char* p = utf8.c_str(); *p != '\0';) {
+        uint32_t pair = GetUtf16FromUtf8(&p);
+        expected.push_back(GetLeadingUtf16Char(pair));
+        if (GetTrailingUtf16Char(pair) != 0u) {
+          expected.push_back(GetTrailingUtf16Char(pair));
+        }
+      }
+
+      ASSERT_EQ(expected.size(), CountModifiedUtf8Chars(utf8.c_str(), utf8.size()));
+      std::vector<uint16_t> utf16(expected.size());
+      ConvertModifiedUtf8ToUtf16(utf16.data(), utf16.size(), utf8.c_str(), utf8.size());
+      EXPECT_EQ(expected, utf16);
+      EXPECT_EQ(ComputeUtf16Hash(expected.data(), expected.size()),
+                ComputeUtf16HashFromModifiedUtf8(utf8.c_str(), expected.size()));
+
+      uint32_t expected_hash = StartModifiedUtf8Hash();
+      for (char c : utf8) {
+        expected_hash = UpdateModifiedUtf8Hash(expected_hash, c);
+      }
+      EXPECT_EQ(expected_hash, ComputeModifiedUtf8Hash(utf8));
+      EXPECT_EQ(expected_hash, ComputeModifiedUtf8Hash(utf8.c_str()));
+    }
+  }
+}
+
 TEST_F(UtfTest, PrintableStringUtf8) {
   // Note: This is UTF-8, not Modified-UTF-8.
   const uint8_t kTestSequence[] = { 0xf0, 0x90, 0x80, 0x80, 0 };
@@ -23,6 +23,7 @@ namespace art {
 BufferedOutputStream::BufferedOutputStream(std::unique_ptr<OutputStream> out)
     : OutputStream(out->GetLocation()),  // Before out is moved to out_.
       out_(std::move(out)),
+      buffer_(new uint8_t[kBufferSize]),
       used_(0) {}
 
 BufferedOutputStream::~BufferedOutputStream() {
@@ -30,18 +31,24 @@ BufferedOutputStream::~BufferedOutputStream() {
 }
 
 bool BufferedOutputStream::WriteFully(const void* buffer, size_t byte_count) {
-  if (byte_count > kBufferSize) {
-    if (!FlushBuffer()) {
-      return false;
-    }
-    return out_->WriteFully(buffer, byte_count);
-  }
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(buffer);
   if (used_ + byte_count > kBufferSize) {
-    if (!FlushBuffer()) {
-      return false;
+    // Top up a partially filled buffer, so that we do not issue a small write
+    // followed by a large one.
+    if (used_ != 0u) {
+      size_t chunk = kBufferSize - used_;
+      memcpy(&buffer_[used_], src, chunk);
+      used_ = kBufferSize;
+      src += chunk;
+      byte_count -= chunk;
+      if (!FlushBuffer()) {
+        return false;
+      }
+    }
+    if (byte_count >= kBufferSize) {
+      return out_->WriteFully(src, byte_count);
     }
   }
-  const uint8_t* src = reinterpret_cast<const uint8_t*>(buffer);
   memcpy(&buffer_[used_], src, byte_count);
   used_ += byte_count;
   return true;
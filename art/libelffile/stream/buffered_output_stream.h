@@ -25,8 +25,14 @@
 
 namespace art {
 
+// Output stream that collects small writes into large writes of the underlying
+// stream, to reduce the number of system calls when writing to a file.
 class BufferedOutputStream final : public OutputStream {
  public:
+  // Writes to the underlying stream are done in chunks of this size, except
+  // before a seek or a flush.
+  static constexpr size_t kBufferSize = 256 * KB;
+
   explicit BufferedOutputStream(std::unique_ptr<OutputStream> out);
 
   ~BufferedOutputStream() override;
@@ -38,12 +44,10 @@ class BufferedOutputStream final : public OutputStream {
   bool Flush() override;
 
  private:
-  static const size_t kBufferSize = 8 * KB;
-
   bool FlushBuffer();
 
   std::unique_ptr<OutputStream> const out_;
-  uint8_t buffer_[kBufferSize];
+  std::unique_ptr<uint8_t[]> const buffer_;
   size_t used_;
 
   DISALLOW_COPY_AND_ASSIGN(BufferedOutputStream);
@@ -25,6 +25,7 @@
 #include <stdio.h>
 
 #include <algorithm>
+#include <chrono>
 #include <optional>
 #include <regex>
 #include <string>
@@ -209,6 +210,7 @@ Result<NativeLoaderNamespace*> LibraryNamespaces::Create(JNIEnv* env,
                                                          jstring library_path_j,
                                                          jstring permitted_path_j,
                                                          jstring uses_library_list_j) {
+  const auto start_time = std::chrono::steady_clock::now();
   std::string library_path;  // empty string by default.
 
   if (library_path_j != nullptr) {
@@ -351,7 +353,7 @@ Result<NativeLoaderNamespace*> LibraryNamespaces::Create(JNIEnv* env,
   // ... and link to other namespaces to allow access to some public libraries
   bool is_bridged = app_ns->IsBridged();
 
-  Result<NativeLoaderNamespace> system_ns = NativeLoaderNamespace::GetSystemNamespace(is_bridged);
+  Result<NativeLoaderNamespace> system_ns = GetSystemNamespace(is_bridged);
   if (!system_ns.ok()) {
     return system_ns.error();
   }
@@ -362,8 +364,7 @@ Result<NativeLoaderNamespace*> LibraryNamespaces::Create(JNIEnv* env,
   }
 
   for (const auto&[apex_ns_name, public_libs] : apex_public_libraries()) {
-    Result<NativeLoaderNamespace> ns =
-        NativeLoaderNamespace::GetExportedNamespace(apex_ns_name, is_bridged);
+    Result<NativeLoaderNamespace> ns = GetExportedNamespace(apex_ns_name, is_bridged);
     // Even if APEX namespace is visible, it may not be available to bridged.
     if (ns.ok()) {
       linked = app_ns->Link(&ns.value(), public_libs);
@@ -375,8 +376,7 @@ Result<NativeLoaderNamespace*> LibraryNamespaces::Create(JNIEnv* env,
 
   // Give access to VNDK-SP libraries from the 'vndk' namespace for unbundled vendor apps.
   if (unbundled_app_domain == API_DOMAIN_VENDOR && !vndksp_libraries_vendor().empty()) {
-    Result<NativeLoaderNamespace> vndk_ns =
-        NativeLoaderNamespace::GetExportedNamespace(kVndkNamespaceName, is_bridged);
+    Result<NativeLoaderNamespace> vndk_ns = GetExportedNamespace(kVndkNamespaceName, is_bridged);
     if (vndk_ns.ok()) {
       linked = app_ns->Link(&vndk_ns.value(), vndksp_libraries_vendor());
       if (!linked.ok()) {
@@ -388,7 +388,7 @@ Result<NativeLoaderNamespace*> LibraryNamespaces::Create(JNIEnv* env,
   // Give access to VNDK-SP libraries from the 'vndk_product' namespace for unbundled product apps.
   if (unbundled_app_domain == API_DOMAIN_PRODUCT && !vndksp_libraries_product().empty()) {
     Result<NativeLoaderNamespace> vndk_ns =
-        NativeLoaderNamespace::GetExportedNamespace(kVndkProductNamespaceName, is_bridged);
+        GetExportedNamespace(kVndkProductNamespaceName, is_bridged);
     if (vndk_ns.ok()) {
       linked = app_ns->Link(&vndk_ns.value(), vndksp_libraries_product());
       if (!linked.ok()) {
@@ -403,7 +403,7 @@ Result<NativeLoaderNamespace*> LibraryNamespaces::Create(JNIEnv* env,
       const std::string& jni_libs = apex_jni_libraries(apex_ns_name.value());
       if (jni_libs != "") {
         Result<NativeLoaderNamespace> apex_ns =
-            NativeLoaderNamespace::GetExportedNamespace(apex_ns_name.value(), is_bridged);
+            GetExportedNamespace(apex_ns_name.value(), is_bridged);
         if (apex_ns.ok()) {
           linked = app_ns->Link(&apex_ns.value(), jni_libs);
           if (!linked.ok()) {
@@ -418,7 +418,7 @@ Result<NativeLoaderNamespace*> LibraryNamespaces::Create(JNIEnv* env,
       filter_public_libraries(target_sdk_version, uses_libraries, vendor_public_libraries());
   if (!vendor_libs.empty()) {
     Result<NativeLoaderNamespace> vendor_ns =
-        NativeLoaderNamespace::GetExportedNamespace(kVendorNamespaceName, is_bridged);
+        GetExportedNamespace(kVendorNamespaceName, is_bridged);
     // when vendor_ns is not configured, link to the system namespace
     Result<NativeLoaderNamespace> target_ns = vendor_ns.ok() ? vendor_ns : system_ns;
     if (target_ns.ok()) {
@@ -433,9 +433,8 @@ Result<NativeLoaderNamespace*> LibraryNamespaces::Create(JNIEnv* env,
       filter_public_libraries(target_sdk_version, uses_libraries, product_public_libraries());
   if (!product_libs.empty()) {
     Result<NativeLoaderNamespace> target_ns =
-        is_product_treblelized()
-            ? NativeLoaderNamespace::GetExportedNamespace(kProductNamespaceName, is_bridged)
-            : system_ns;
+        is_product_treblelized() ? GetExportedNamespace(kProductNamespaceName, is_bridged)
+                                 : system_ns;
     if (target_ns.ok()) {
       linked = app_ns->Link(&target_ns.value(), product_libs);
       if (!linked.ok()) {
@@ -454,9 +453,37 @@ Result<NativeLoaderNamespace*> LibraryNamespaces::Create(JNIEnv* env,
   if (is_main_classloader) {
     app_main_namespace_ = &emplaced.second;
   }
+  ALOGD("Configured %s in %lld us",
+        namespace_name.c_str(),
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::steady_clock::now() - start_time)
+                                   .count()));
   return &emplaced.second;
 }
 
+Result<NativeLoaderNamespace> LibraryNamespaces::GetExportedNamespace(const std::string& name,
+                                                                      bool is_bridged) {
+  auto it = exported_namespaces_.find({name, is_bridged});
+  if (it == exported_namespaces_.end()) {
+    it = exported_namespaces_
+             .emplace(std::make_pair(name, is_bridged),
+                      NativeLoaderNamespace::GetExportedNamespace(name, is_bridged))
+             .first;
+  }
+  return it->second;
+}
+
+Result<NativeLoaderNamespace> LibraryNamespaces::GetSystemNamespace(bool is_bridged) {
+  auto it = exported_namespaces_.find({"", is_bridged});
+  if (it == exported_namespaces_.end()) {
+    it = exported_namespaces_
+             .emplace(std::make_pair(std::string(), is_bridged),
+                      NativeLoaderNamespace::GetSystemNamespace(is_bridged))
+             .first;
+  }
+  return it->second;
+}
+
 NativeLoaderNamespace* LibraryNamespaces::FindNamespaceByClassLoader(JNIEnv* env,
                                                                      jobject class_loader) {
   auto it = std::find_if(namespaces_.begin(), namespaces_.end(),
@@ -22,9 +22,11 @@
 #endif
 
 #include <list>
+#include <map>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 
 #include "android-base/result.h"
 #include "jni.h"
@@ -75,6 +77,7 @@ class LibraryNamespaces {
   void Initialize();
   void Reset() {
     namespaces_.clear();
+    exported_namespaces_.clear();
     initialized_ = false;
     app_main_namespace_ = nullptr;
   }
@@ -93,9 +96,17 @@ class LibraryNamespaces {
   Result<void> InitPublicNamespace(const char* library_path);
   NativeLoaderNamespace* FindParentNamespaceByClassLoader(JNIEnv* env, jobject class_loader);
 
+  // Same as the NativeLoaderNamespace functions, but the results are cached. The exported
+  // namespaces come from the linker configuration, which does not change in the process, and every
+  // new class loader namespace is linked to the same ones.
+  Result<NativeLoaderNamespace> GetExportedNamespace(const std::string& name, bool is_bridged);
+  Result<NativeLoaderNamespace> GetSystemNamespace(bool is_bridged);
+
   bool initialized_;
   NativeLoaderNamespace* app_main_namespace_;
   std::list<std::pair<jweak, NativeLoaderNamespace>> namespaces_;
+  // Keyed by namespace name and whether it is bridged. The system namespace uses an empty name.
+  std::map<std::pair<std::string, bool>, Result<NativeLoaderNamespace>> exported_namespaces_;
 };
 
 std::optional<std::string> FindApexNamespaceName(const std::string& location);
@@ -684,6 +684,33 @@ TEST_P(NativeLoaderTest_Create, TwoApks) {
   }
 }
 
+TEST_P(NativeLoaderTest_Create, ExportedNamespacesAreLookedUpOnce) {
+  SetExpectations();
+  const std::string second_app_class_loader = "second_app_classloader";
+  const std::string second_app_dex_path = "/data/app/bar/classes.dex";
+  const std::string second_app_library_path = "/data/app/bar/" LIB_DIR "/arm";
+
+  // Both namespaces are linked to the ART namespace, but it is only looked up once.
+  EXPECT_CALL(*mock, mock_get_exported_namespace(Eq(IsBridged()), StrEq("com_android_art")))
+      .WillOnce(Return(namespaces["com_android_art"]));
+
+  ON_CALL(*jni_mock, JniObject_getParent(StrEq(second_app_class_loader)))
+      .WillByDefault(Return(nullptr));
+  EXPECT_CALL(*mock, mock_create_namespace(
+                         Eq(IsBridged()), _, nullptr, StrEq(second_app_library_path), _, _, _))
+      .WillOnce(Return(TO_MOCK_NAMESPACE(TO_ANDROID_NAMESPACE(second_app_dex_path.c_str()))));
+  EXPECT_CALL(*mock, mock_link_namespaces(Eq(IsBridged()), NsEq(second_app_dex_path.c_str()), _, _))
+      .WillRepeatedly(Return(true));
+
+  RunTest();
+  jstring err = CreateClassLoaderNamespace(
+      env(), target_sdk_version, env()->NewStringUTF(second_app_class_loader.c_str()),
+      /*is_shared=*/ false, env()->NewStringUTF(second_app_dex_path.c_str()),
+      env()->NewStringUTF(second_app_library_path.c_str()),
+      /*permitted_path=*/ nullptr, /*uses_library_list=*/ nullptr);
+  EXPECT_EQ(err, nullptr) << "Error is: " << std::string(ScopedUtfChars(env(), err).c_str());
+}
+
 INSTANTIATE_TEST_SUITE_P(NativeLoaderTests_Create, NativeLoaderTest_Create, testing::Bool());
 
 const std::function<Result<bool>(const struct ConfigEntry&)> always_true =
@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mapped_profile.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "android-base/file.h"
+#include "android-base/stringprintf.h"
+#include "base/bit_utils.h"
+#include "base/globals.h"
+#include "base/systrace.h"
+#include "dex/dex_file.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+
+const uint8_t MappedProfile::kMagic[4] = { 'p', 'm', 'p', '\0' };
+const uint8_t MappedProfile::kVersion[4] = { '0', '0', '1', '\0' };
+
+// The arrays are aligned so that they can be read in place.
+static constexpr size_t kArrayAlignment = alignof(uint32_t);
+
+bool MappedProfile::Write(const ProfileCompilationInfo& info,
+                          int fd,
+                          /*out*/std::string* error_msg) {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  const size_t number_of_dex_files = info.info_.size();
+  std::vector<DexFileEntry> entries(number_of_dex_files);
+  std::vector<std::vector<uint16_t>> classes(number_of_dex_files);
+  size_t offset = sizeof(Header) + number_of_dex_files * sizeof(DexFileEntry);
+  for (size_t i = 0; i != number_of_dex_files; ++i) {
+    const ProfileCompilationInfo::DexFileData& dex_data = *info.info_[i];
+    DexFileEntry& entry = entries[i];
+    entry.checksum = dex_data.checksum;
+    entry.num_type_ids = dex_data.num_type_ids;
+    entry.num_method_ids = dex_data.num_method_ids;
+    // The method map and class set are ordered, so the arrays are sorted.
+    for (dex::TypeIndex type_index : dex_data.class_set) {
+      // Drop the extra descriptors, see the class comment.
+      if (type_index.index_ < dex_data.num_type_ids) {
+        classes[i].push_back(type_index.index_);
+      }
+    }
+    entry.hot_methods_offset = dchecked_integral_cast<uint32_t>(offset);
+    entry.number_of_hot_methods = dchecked_integral_cast<uint32_t>(dex_data.method_map.size());
+    offset = RoundUp(offset + entry.number_of_hot_methods * sizeof(uint16_t), kArrayAlignment);
+    entry.classes_offset = dchecked_integral_cast<uint32_t>(offset);
+    entry.number_of_classes = dchecked_integral_cast<uint32_t>(classes[i].size());
+    offset = RoundUp(offset + entry.number_of_classes * sizeof(uint16_t), kArrayAlignment);
+    entry.bitmap_offset = dchecked_integral_cast<uint32_t>(offset);
+    entry.bitmap_size = dchecked_integral_cast<uint32_t>(dex_data.bitmap_storage.size());
+    offset = RoundUp(offset + entry.bitmap_size, kArrayAlignment);
+  }
+  for (size_t i = 0; i != number_of_dex_files; ++i) {
+    entries[i].profile_key_offset = dchecked_integral_cast<uint32_t>(offset);
+    entries[i].profile_key_size =
+        dchecked_integral_cast<uint32_t>(info.info_[i]->profile_key.size());
+    offset += entries[i].profile_key_size;
+  }
+  if (!IsUint<32>(offset)) {
+    *error_msg = StringPrintf("Profile too large for the mapped format: %zu bytes", offset);
+    return false;
+  }
+
+  std::vector<uint8_t> buffer(offset, 0u);
+  Header header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  memcpy(header.version, kVersion, sizeof(kVersion));
+  header.flags = info.IsForBootImage() ? kFlagForBootImage : 0u;
+  header.number_of_dex_files = dchecked_integral_cast<uint32_t>(number_of_dex_files);
+  header.file_size = dchecked_integral_cast<uint32_t>(offset);
+  memcpy(buffer.data(), &header, sizeof(header));
+  memcpy(buffer.data() + sizeof(Header), entries.data(), entries.size() * sizeof(DexFileEntry));
+  for (size_t i = 0; i != number_of_dex_files; ++i) {
+    const ProfileCompilationInfo::DexFileData& dex_data = *info.info_[i];
+    const DexFileEntry& entry = entries[i];
+    uint16_t* hot_methods = reinterpret_cast<uint16_t*>(buffer.data() + entry.hot_methods_offset);
+    for (const auto& method_entry : dex_data.method_map) {
+      *hot_methods++ = method_entry.first;
+    }
+    std::copy(classes[i].begin(),
+              classes[i].end(),
+              reinterpret_cast<uint16_t*>(buffer.data() + entry.classes_offset));
+    std::copy(dex_data.bitmap_storage.begin(),
+              dex_data.bitmap_storage.end(),
+              buffer.data() + entry.bitmap_offset);
+    memcpy(buffer.data() + entry.profile_key_offset,
+           dex_data.profile_key.data(),
+           entry.profile_key_size);
+  }
+
+  if (!android::base::WriteFully(fd, buffer.data(), buffer.size())) {
+    *error_msg = StringPrintf("Failed to write mapped profile: %s", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool MappedProfile::IsMappedProfile(int fd) {
+  uint8_t magic[sizeof(kMagic)];
+  return android::base::ReadFullyAtOffset(fd, magic, sizeof(magic), /*offset=*/0) &&
+         memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+std::unique_ptr<MappedProfile> MappedProfile::Open(int fd, /*out*/std::string* error_msg) {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    *error_msg = StringPrintf("Failed to stat profile: %s", strerror(errno));
+    return nullptr;
+  }
+  if (static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    *error_msg = StringPrintf("Profile too small: %zu bytes", static_cast<size_t>(st.st_size));
+    return nullptr;
+  }
+  MemMap map = MemMap::MapFile(static_cast<size_t>(st.st_size),
+                               PROT_READ,
+                               MAP_PRIVATE,
+                               fd,
+                               /*start=*/0,
+                               /*low_4gb=*/false,
+                               "mapped profile",
+                               error_msg);
+  if (!map.IsValid()) {
+    return nullptr;
+  }
+  std::unique_ptr<MappedProfile> profile(new MappedProfile(std::move(map)));
+  if (!profile->Verify(error_msg)) {
+    return nullptr;
+  }
+  return profile;
+}
+
+// Check that all the data is within the file. The contents of the arrays are not checked, as
+// that would mean reading the whole file; lookups do not rely on them for memory safety.
+bool MappedProfile::Verify(/*out*/std::string* error_msg) const {
+  const Header& header = GetHeader();
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    *error_msg = "Bad mapped profile magic";
+    return false;
+  }
+  if (memcmp(header.version, kVersion, sizeof(kVersion)) != 0) {
+    *error_msg = "Unsupported mapped profile version";
+    return false;
+  }
+  const uint64_t size = map_.Size();
+  if (header.file_size != size) {
+    *error_msg = StringPrintf("Bad mapped profile size %u, expected %zu",
+                              header.file_size,
+                              map_.Size());
+    return false;
+  }
+  if (sizeof(Header) + uint64_t{header.number_of_dex_files} * sizeof(DexFileEntry) > size) {
+    *error_msg = StringPrintf("Truncated mapped profile with %u dex files",
+                              header.number_of_dex_files);
+    return false;
+  }
+  auto in_file = [size](uint32_t offset, uint64_t byte_count, size_t alignment) {
+    return IsAlignedParam(offset, alignment) && offset + byte_count <= size;
+  };
+  for (size_t i = 0; i != header.number_of_dex_files; ++i) {
+    const DexFileEntry& entry = GetDexFileEntry(i);
+    if (entry.num_method_ids > std::numeric_limits<uint16_t>::max() + 1u ||
+        !in_file(entry.hot_methods_offset,
+                 uint64_t{entry.number_of_hot_methods} * sizeof(uint16_t),
+                 alignof(uint16_t)) ||
+        !in_file(entry.classes_offset,
+                 uint64_t{entry.number_of_classes} * sizeof(uint16_t),
+                 alignof(uint16_t)) ||
+        !in_file(entry.bitmap_offset, entry.bitmap_size, /*alignment=*/1u) ||
+        !in_file(entry.profile_key_offset, entry.profile_key_size, /*alignment=*/1u) ||
+        entry.bitmap_size != ProfileCompilationInfo::DexFileData::ComputeBitmapStorage(
+                                 IsForBootImage(), entry.num_method_ids)) {
+      *error_msg = StringPrintf("Bad data for dex file %zu in mapped profile", i);
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string_view MappedProfile::GetProfileKey(size_t dex_index) const {
+  const DexFileEntry& entry = GetDexFileEntry(dex_index);
+  return std::string_view(reinterpret_cast<const char*>(map_.Begin() + entry.profile_key_offset),
+                          entry.profile_key_size);
+}
+
+uint32_t MappedProfile::GetNumberOfMethods() const {
+  uint32_t total = 0u;
+  for (size_t i = 0, size = GetNumberOfDexFiles(); i != size; ++i) {
+    total += GetDexFileEntry(i).number_of_hot_methods;
+  }
+  return total;
+}
+
+uint32_t MappedProfile::GetNumberOfResolvedClasses() const {
+  uint32_t total = 0u;
+  for (size_t i = 0, size = GetNumberOfDexFiles(); i != size; ++i) {
+    total += GetDexFileEntry(i).number_of_classes;
+  }
+  return total;
+}
+
+size_t MappedProfile::FindDexFile(const DexFile& dex_file,
+                                  const ProfileSampleAnnotation& annotation) const {
+  // Same as `ProfileCompilationInfo::FindDexDataUsingAnnotations()`.
+  const size_t number_of_dex_files = GetNumberOfDexFiles();
+  if (annotation == ProfileSampleAnnotation::kNone) {
+    std::string_view base_key =
+        ProfileCompilationInfo::GetProfileDexFileBaseKeyView(dex_file.GetLocation());
+    for (size_t i = 0; i != number_of_dex_files; ++i) {
+      if (base_key == ProfileCompilationInfo::GetBaseKeyViewFromAugmentedKey(GetProfileKey(i))) {
+        return GetDexChecksum(i) == dex_file.GetLocationChecksum() ? i : kDexFileNotFound;
+      }
+    }
+  } else {
+    std::string profile_key =
+        ProfileCompilationInfo::GetProfileDexFileAugmentedKey(dex_file.GetLocation(), annotation);
+    for (size_t i = 0; i != number_of_dex_files; ++i) {
+      if (profile_key == GetProfileKey(i)) {
+        return GetDexChecksum(i) == dex_file.GetLocationChecksum() ? i : kDexFileNotFound;
+      }
+    }
+  }
+  return kDexFileNotFound;
+}
+
+MappedProfile::MethodHotness MappedProfile::GetMethodHotness(size_t dex_index,
+                                                             uint32_t method_index) const {
+  const DexFileEntry& entry = GetDexFileEntry(dex_index);
+  MethodHotness hotness;
+  if (method_index >= entry.num_method_ids) {
+    return hotness;
+  }
+  ArrayRef<const uint16_t> hot_methods = GetHotMethods(entry);
+  if (std::binary_search(hot_methods.begin(), hot_methods.end(), method_index)) {
+    hotness.AddFlag(MethodHotness::kFlagHot);
+  }
+  // The bitmap is [startup bitmap][post startup bitmap][AmStartup][...], with no bits for
+  // `kFlagHot`, see `ProfileCompilationInfo::DexFileData::MethodFlagBitmapIndex()`.
+  const uint8_t* bitmap = map_.Begin() + entry.bitmap_offset;
+  const uint32_t last_flag =
+      IsForBootImage() ? MethodHotness::kFlagLastBoot : MethodHotness::kFlagLastRegular;
+  for (uint32_t flag = MethodHotness::kFlagStartup; flag <= last_flag; flag <<= 1) {
+    size_t bit = method_index + (WhichPowerOf2(flag) - 1u) * entry.num_method_ids;
+    if ((bitmap[bit / kBitsPerByte] & (1u << (bit % kBitsPerByte))) != 0u) {
+      hotness.AddFlag(static_cast<MethodHotness::Flag>(flag));
+    }
+  }
+  return hotness;
+}
+
+bool MappedProfile::ContainsClass(size_t dex_index, dex::TypeIndex type_idx) const {
+  ArrayRef<const uint16_t> classes = GetClasses(GetDexFileEntry(dex_index));
+  return std::binary_search(classes.begin(), classes.end(), type_idx.index_);
+}
+
+MappedProfile::MethodHotness MappedProfile::GetMethodHotness(
+    const MethodReference& method_ref,
+    const ProfileSampleAnnotation& annotation) const {
+  size_t dex_index = FindDexFile(*method_ref.dex_file, annotation);
+  return dex_index != kDexFileNotFound ? GetMethodHotness(dex_index, method_ref.index)
+                                       : MethodHotness();
+}
+
+bool MappedProfile::ContainsClass(const DexFile& dex_file,
+                                  dex::TypeIndex type_idx,
+                                  const ProfileSampleAnnotation& annotation) const {
+  size_t dex_index = FindDexFile(dex_file, annotation);
+  return dex_index != kDexFileNotFound && ContainsClass(dex_index, type_idx);
+}
+
+bool MappedProfile::GetClassesAndMethods(
+    const DexFile& dex_file,
+    /*out*/std::set<dex::TypeIndex>* class_set,
+    /*out*/std::set<uint16_t>* hot_method_set,
+    /*out*/std::set<uint16_t>* startup_method_set,
+    /*out*/std::set<uint16_t>* post_startup_method_method_set,
+    const ProfileSampleAnnotation& annotation) const {
+  size_t dex_index = FindDexFile(dex_file, annotation);
+  if (dex_index == kDexFileNotFound) {
+    return false;
+  }
+  const DexFileEntry& entry = GetDexFileEntry(dex_index);
+  ArrayRef<const uint16_t> hot_methods = GetHotMethods(entry);
+  hot_method_set->insert(hot_methods.begin(), hot_methods.end());
+  for (uint32_t method_idx = 0; method_idx < entry.num_method_ids; ++method_idx) {
+    MethodHotness hotness = GetMethodHotness(dex_index, method_idx);
+    if (hotness.IsStartup()) {
+      startup_method_set->insert(method_idx);
+    }
+    if (hotness.IsPostStartup()) {
+      post_startup_method_method_set->insert(method_idx);
+    }
+  }
+  for (uint16_t type_index : GetClasses(entry)) {
+    class_set->insert(dex::TypeIndex(type_index));
+  }
+  return true;
+}
+
+}  // namespace art
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_LIBPROFILE_PROFILE_MAPPED_PROFILE_H_
+#define ART_LIBPROFILE_PROFILE_MAPPED_PROFILE_H_
+
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+
+#include "base/array_ref.h"
+#include "base/macros.h"
+#include "base/mem_map.h"
+#include "dex/dex_file_types.h"
+#include "dex/method_reference.h"
+#include "profile_compilation_info.h"
+
+namespace art {
+
+class DexFile;
+
+/**
+ * A read-only profile that is queried in place, without decompressing or parsing it.
+ *
+ * `ProfileCompilationInfo::Load()` inflates the profile and builds maps and sets for every dex
+ * file, which is a large part of the cost of dex2oat, profman and artd invocations that only want
+ * to know which methods and classes are in the profile. A mapped profile is a flat file that is
+ * mmap-ed and used as is. The data of each dex file is:
+ *   - a sorted array of the hot method indexes,
+ *   - the method flag bitmap, with the same layout as in `ProfileCompilationInfo`,
+ *   - a sorted array of the class type indexes.
+ *
+ * Inline caches are not stored, and neither are classes that are not in the `TypeId`s of their
+ * dex file (the "extra descriptors" of `ProfileCompilationInfo`); users that need them load the
+ * full profile. All offsets are relative to the start of the file and all values are stored in
+ * the byte order of the device, which is little-endian on all supported targets.
+ *
+ * File layout:
+ *   Header
+ *   DexFileEntry[number_of_dex_files]
+ *   per dex file: uint16_t hot_methods[], uint16_t classes[], uint8_t bitmap[]
+ *   profile keys
+ */
+class MappedProfile {
+ public:
+  using MethodHotness = ProfileCompilationInfo::MethodHotness;
+  using ProfileSampleAnnotation = ProfileCompilationInfo::ProfileSampleAnnotation;
+
+  static const uint8_t kMagic[4];
+  static const uint8_t kVersion[4];
+
+  // Write `info` to `fd` in the mapped format.
+  static bool Write(const ProfileCompilationInfo& info, int fd, /*out*/std::string* error_msg);
+
+  // Map the profile in `fd`. Returns null if the file is not a valid mapped profile.
+  static std::unique_ptr<MappedProfile> Open(int fd, /*out*/std::string* error_msg);
+
+  // Returns whether the file starts with the magic of mapped profiles. The file offset is not
+  // changed.
+  static bool IsMappedProfile(int fd);
+
+  bool IsForBootImage() const {
+    return (GetHeader().flags & kFlagForBootImage) != 0u;
+  }
+
+  size_t GetNumberOfDexFiles() const {
+    return GetHeader().number_of_dex_files;
+  }
+
+  std::string_view GetProfileKey(size_t dex_index) const;
+
+  uint32_t GetDexChecksum(size_t dex_index) const {
+    return GetDexFileEntry(dex_index).checksum;
+  }
+
+  // Return the total number of hot methods and of classes.
+  uint32_t GetNumberOfMethods() const;
+  uint32_t GetNumberOfResolvedClasses() const;
+
+  // Same as the `ProfileCompilationInfo` functions, except that the returned hotness has no
+  // inline caches. See `ProfileCompilationInfo::GetMethodHotness()` for the annotations.
+  MethodHotness GetMethodHotness(
+      const MethodReference& method_ref,
+      const ProfileSampleAnnotation& annotation = ProfileSampleAnnotation::kNone) const;
+  bool ContainsClass(
+      const DexFile& dex_file,
+      dex::TypeIndex type_idx,
+      const ProfileSampleAnnotation& annotation = ProfileSampleAnnotation::kNone) const;
+  bool GetClassesAndMethods(
+      const DexFile& dex_file,
+      /*out*/std::set<dex::TypeIndex>* class_set,
+      /*out*/std::set<uint16_t>* hot_method_set,
+      /*out*/std::set<uint16_t>* startup_method_set,
+      /*out*/std::set<uint16_t>* post_startup_method_method_set,
+      const ProfileSampleAnnotation& annotation = ProfileSampleAnnotation::kNone) const;
+
+  // Queries by index in the profile, for dex files found with `FindDexFile()`.
+  static constexpr size_t kDexFileNotFound = static_cast<size_t>(-1);
+  size_t FindDexFile(const DexFile& dex_file, const ProfileSampleAnnotation& annotation) const;
+  MethodHotness GetMethodHotness(size_t dex_index, uint32_t method_index) const;
+  bool ContainsClass(size_t dex_index, dex::TypeIndex type_idx) const;
+
+ private:
+  static constexpr uint32_t kFlagForBootImage = 1u << 0;
+
+  struct Header {
+    uint8_t magic[4];
+    uint8_t version[4];
+    uint32_t flags;
+    uint32_t number_of_dex_files;
+    uint32_t file_size;
+  };
+
+  struct DexFileEntry {
+    uint32_t profile_key_offset;
+    uint32_t profile_key_size;
+    uint32_t checksum;
+    uint32_t num_type_ids;
+    uint32_t num_method_ids;
+    uint32_t hot_methods_offset;
+    uint32_t number_of_hot_methods;
+    uint32_t classes_offset;
+    uint32_t number_of_classes;
+    uint32_t bitmap_offset;
+    uint32_t bitmap_size;
+  };
+
+  explicit MappedProfile(MemMap&& map) : map_(std::move(map)) {}
+
+  bool Verify(/*out*/std::string* error_msg) const;
+
+  const Header& GetHeader() const {
+    return *reinterpret_cast<const Header*>(map_.Begin());
+  }
+
+  const DexFileEntry& GetDexFileEntry(size_t dex_index) const {
+    DCHECK_LT(dex_index, GetNumberOfDexFiles());
+    return reinterpret_cast<const DexFileEntry*>(map_.Begin() + sizeof(Header))[dex_index];
+  }
+
+  template <typename T>
+  ArrayRef<const T> GetArray(uint32_t offset, uint32_t size) const {
+    return ArrayRef<const T>(reinterpret_cast<const T*>(map_.Begin() + offset), size);
+  }
+
+  ArrayRef<const uint16_t> GetHotMethods(const DexFileEntry& entry) const {
+    return GetArray<uint16_t>(entry.hot_methods_offset, entry.number_of_hot_methods);
+  }
+
+  ArrayRef<const uint16_t> GetClasses(const DexFileEntry& entry) const {
+    return GetArray<uint16_t>(entry.classes_offset, entry.number_of_classes);
+  }
+
+  MemMap map_;
+
+  DISALLOW_COPY_AND_ASSIGN(MappedProfile);
+};
+
+}  // namespace art
+
+#endif  // ART_LIBPROFILE_PROFILE_MAPPED_PROFILE_H_
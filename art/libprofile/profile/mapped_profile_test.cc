@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "base/common_art_test.h"
+#include "base/unix_file/fd_file.h"
+#include "dex/dex_file.h"
+#include "dex/method_reference.h"
+#include "profile/mapped_profile.h"
+#include "profile/profile_compilation_info.h"
+#include "profile/profile_test_helper.h"
+
+namespace art {
+
+class MappedProfileTest : public CommonArtTest, public ProfileTestHelper {
+ public:
+  void SetUp() override {
+    CommonArtTest::SetUp();
+    dex1 = BuildDex("location1", /*location_checksum=*/ 1, "LUnique1;", /*num_method_ids=*/ 101);
+    dex2 = BuildDex("location2", /*location_checksum=*/ 2, "LUnique2;", /*num_method_ids=*/ 102);
+    dex1_checksum_missmatch = BuildDex("location1",
+                                       /*location_checksum=*/ 12,
+                                       "LUnique1;",
+                                       /*num_method_ids=*/ 101);
+  }
+
+ protected:
+  // Check that the mapped profile answers the queries like the original one.
+  void CheckSameQueries(
+      const ProfileCompilationInfo& expected,
+      const ProfileCompilationInfo& mapped,
+      const DexFile* dex,
+      const ProfileSampleAnnotation& annotation = ProfileSampleAnnotation::kNone) {
+    for (uint32_t method_idx = 0; method_idx != dex->NumMethodIds(); ++method_idx) {
+      MethodReference ref(dex, method_idx);
+      EXPECT_EQ(expected.GetMethodHotness(ref, annotation).GetFlags(),
+                mapped.GetMethodHotness(ref, annotation).GetFlags()) << method_idx;
+    }
+    for (uint32_t type_idx = 0; type_idx != dex->NumTypeIds(); ++type_idx) {
+      dex::TypeIndex type_index(type_idx);
+      EXPECT_EQ(expected.ContainsClass(*dex, type_index, annotation),
+                mapped.ContainsClass(*dex, type_index, annotation)) << type_idx;
+    }
+    std::set<dex::TypeIndex> expected_classes, mapped_classes;
+    std::set<uint16_t> expected_hot, mapped_hot;
+    std::set<uint16_t> expected_startup, mapped_startup;
+    std::set<uint16_t> expected_post_startup, mapped_post_startup;
+    ASSERT_EQ(expected.GetClassesAndMethods(*dex,
+                                            &expected_classes,
+                                            &expected_hot,
+                                            &expected_startup,
+                                            &expected_post_startup,
+                                            annotation),
+              mapped.GetClassesAndMethods(*dex,
+                                          &mapped_classes,
+                                          &mapped_hot,
+                                          &mapped_startup,
+                                          &mapped_post_startup,
+                                          annotation));
+    EXPECT_EQ(expected_classes, mapped_classes);
+    EXPECT_EQ(expected_hot, mapped_hot);
+    EXPECT_EQ(expected_startup, mapped_startup);
+    EXPECT_EQ(expected_post_startup, mapped_post_startup);
+  }
+
+  const DexFile* dex1;
+  const DexFile* dex2;
+  const DexFile* dex1_checksum_missmatch;
+};
+
+TEST_F(MappedProfileTest, SaveAndMapEmpty) {
+  ScratchFile profile;
+  ProfileCompilationInfo saved_info;
+  std::string error;
+  ASSERT_TRUE(saved_info.SaveMapped(profile.GetFd(), &error)) << error;
+  ASSERT_TRUE(MappedProfile::IsMappedProfile(profile.GetFd()));
+
+  ProfileCompilationInfo mapped_info;
+  ASSERT_TRUE(mapped_info.LoadMapped(profile.GetFd(), &error)) << error;
+  ASSERT_TRUE(mapped_info.IsMapped());
+  ASSERT_TRUE(mapped_info.IsEmpty());
+  ASSERT_FALSE(mapped_info.GetMethodHotness(MethodReference(dex1, 0)).IsInProfile());
+}
+
+TEST_F(MappedProfileTest, SaveAndMap) {
+  ProfileCompilationInfo saved_info;
+  for (uint16_t i = 0; i < 10; ++i) {
+    ASSERT_TRUE(AddMethod(&saved_info, dex1, /*method_idx=*/ i));
+    ASSERT_TRUE(AddMethod(&saved_info, dex2, /*method_idx=*/ 2 * i));
+  }
+  ASSERT_TRUE(AddMethod(&saved_info, dex1, /*method_idx=*/ 50, Hotness::kFlagStartup));
+  ASSERT_TRUE(AddMethod(&saved_info, dex1, /*method_idx=*/ 51, Hotness::kFlagPostStartup));
+  ASSERT_TRUE(AddMethod(&saved_info,
+                        dex2,
+                        /*method_idx=*/ 101,
+                        static_cast<Hotness::Flag>(Hotness::kFlagHot | Hotness::kFlagStartup)));
+  ASSERT_TRUE(AddClass(&saved_info, dex1, dex::TypeIndex(0)));
+  ASSERT_TRUE(AddClass(&saved_info, dex1, dex::TypeIndex(3)));
+  ASSERT_TRUE(AddClass(&saved_info, dex2, dex::TypeIndex(7)));
+
+  ScratchFile profile;
+  std::string error;
+  ASSERT_TRUE(saved_info.SaveMapped(profile.GetFd(), &error)) << error;
+
+  ProfileCompilationInfo mapped_info;
+  ASSERT_TRUE(mapped_info.LoadMapped(profile.GetFd(), &error)) << error;
+  ASSERT_TRUE(mapped_info.SameVersion(saved_info));
+  ASSERT_EQ(saved_info.GetNumberOfMethods(), mapped_info.GetNumberOfMethods());
+  ASSERT_EQ(saved_info.GetNumberOfResolvedClasses(), mapped_info.GetNumberOfResolvedClasses());
+  CheckSameQueries(saved_info, mapped_info, dex1);
+  CheckSameQueries(saved_info, mapped_info, dex2);
+
+  // The checksum must match.
+  ASSERT_FALSE(
+      mapped_info.GetMethodHotness(MethodReference(dex1_checksum_missmatch, 0)).IsInProfile());
+  ASSERT_FALSE(mapped_info.ContainsClass(*dex1_checksum_missmatch, dex::TypeIndex(0)));
+}
+
+TEST_F(MappedProfileTest, SaveAndMapBootImage) {
+  ProfileCompilationInfo saved_info(/*for_boot_image=*/ true);
+  ProfileSampleAnnotation psa1("com.package1");
+  ProfileSampleAnnotation psa2("com.package2");
+  ASSERT_TRUE(AddMethod(&saved_info,
+                        dex1,
+                        /*method_idx=*/ 1,
+                        static_cast<Hotness::Flag>(Hotness::kFlagHot | Hotness::kFlagAmStartup),
+                        psa1));
+  ASSERT_TRUE(AddMethod(&saved_info, dex1, /*method_idx=*/ 2, Hotness::kFlagLastBoot, psa1));
+  ASSERT_TRUE(AddMethod(&saved_info, dex1, /*method_idx=*/ 3, Hotness::kFlagStartupBin, psa2));
+  ASSERT_TRUE(AddClass(&saved_info, dex1, dex::TypeIndex(2), psa2));
+
+  ScratchFile profile;
+  std::string error;
+  ASSERT_TRUE(saved_info.SaveMapped(profile.GetFd(), &error)) << error;
+
+  ProfileCompilationInfo mapped_info;
+  ASSERT_TRUE(mapped_info.LoadMapped(profile.GetFd(), &error)) << error;
+  ASSERT_TRUE(mapped_info.IsForBootImage());
+  CheckSameQueries(saved_info, mapped_info, dex1, psa1);
+  CheckSameQueries(saved_info, mapped_info, dex1, psa2);
+  CheckSameQueries(saved_info, mapped_info, dex1);
+}
+
+TEST_F(MappedProfileTest, RejectInvalid) {
+  ProfileCompilationInfo saved_info;
+  ASSERT_TRUE(AddMethod(&saved_info, dex1, /*method_idx=*/ 1));
+  std::string error;
+
+  // A regular profile is not a mapped profile.
+  ScratchFile regular_profile;
+  ASSERT_TRUE(saved_info.Save(regular_profile.GetFd()));
+  ASSERT_FALSE(MappedProfile::IsMappedProfile(regular_profile.GetFd()));
+  ProfileCompilationInfo info1;
+  ASSERT_FALSE(info1.LoadMapped(regular_profile.GetFd(), &error));
+  ASSERT_FALSE(info1.IsMapped());
+
+  // A truncated profile.
+  ScratchFile truncated_profile;
+  ASSERT_TRUE(saved_info.SaveMapped(truncated_profile.GetFd(), &error)) << error;
+  int64_t length = truncated_profile.GetFile()->GetLength();
+  ASSERT_EQ(0, truncated_profile.GetFile()->SetLength(length - 1));
+  ProfileCompilationInfo info2;
+  ASSERT_FALSE(info2.LoadMapped(truncated_profile.GetFd(), &error));
+
+  // A profile with a bad magic.
+  ScratchFile bad_magic_profile;
+  ASSERT_TRUE(saved_info.SaveMapped(bad_magic_profile.GetFd(), &error)) << error;
+  const char bad_magic = 'x';
+  ASSERT_TRUE(bad_magic_profile.GetFile()->PwriteFully(&bad_magic, 1u, /*offset=*/ 0u));
+  ASSERT_FALSE(MappedProfile::IsMappedProfile(bad_magic_profile.GetFd()));
+  ProfileCompilationInfo info3;
+  ASSERT_FALSE(info3.LoadMapped(bad_magic_profile.GetFd(), &error));
+
+  // Mapping requires an empty profile.
+  ScratchFile profile;
+  ASSERT_TRUE(saved_info.SaveMapped(profile.GetFd(), &error)) << error;
+  ASSERT_FALSE(saved_info.LoadMapped(profile.GetFd(), &error));
+}
+
+}  // namespace art
@@ -61,6 +61,7 @@
 #include "dex/descriptors_names.h"
 #include "dex/dex_file_loader.h"
 #include "dex/dex_instruction-inl.h"
+#include "mapped_profile.h"
 
 #ifdef ART_TARGET_ANDROID
 #include "android-modules-utils/sdk_level.h"
@@ -1027,6 +1028,7 @@ bool ProfileCompilationInfo::Save(int fd, bool flush) {
   uint64_t start = NanoTime();
   ScopedTrace trace(__PRETTY_FUNCTION__);
   DCHECK_GE(fd, 0);
+  DCHECK(!IsMapped());
 
   // Collect uncompressed section sizes.
   // Use `uint64_t` and assume this cannot overflow as we would have run out of memory.
@@ -1220,6 +1222,31 @@ bool ProfileCompilationInfo::Save(int fd, bool flush) {
   return true;
 }
 
+bool ProfileCompilationInfo::SaveMapped(int fd, /*out*/std::string* error_msg) const {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  DCHECK_GE(fd, 0);
+  DCHECK(!IsMapped());
+  return MappedProfile::Write(*this, fd, error_msg);
+}
+
+bool ProfileCompilationInfo::LoadMapped(int fd, /*out*/std::string* error_msg) {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  DCHECK_GE(fd, 0);
+  if (!IsEmpty() || IsMapped()) {
+    *error_msg = "Cannot map a profile into a non-empty profile";
+    return false;
+  }
+  std::unique_ptr<MappedProfile> mapped_profile = MappedProfile::Open(fd, error_msg);
+  if (mapped_profile == nullptr) {
+    return false;
+  }
+  memcpy(version_,
+         mapped_profile->IsForBootImage() ? kProfileVersionForBootImage : kProfileVersion,
+         kProfileVersionSize);
+  mapped_profile_ = std::move(mapped_profile);
+  return true;
+}
+
 ProfileCompilationInfo::DexFileData* ProfileCompilationInfo::GetOrAddDexFileData(
     const std::string& profile_key,
     uint32_t checksum,
@@ -1962,6 +1989,8 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
 
 bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other,
                                        bool merge_classes) {
+  DCHECK(!IsMapped());
+  DCHECK(!other.IsMapped());
   if (!SameVersion(other)) {
     LOG(WARNING) << "Cannot merge different profile versions";
     return false;
@@ -2093,6 +2122,9 @@ bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other,
 ProfileCompilationInfo::MethodHotness ProfileCompilationInfo::GetMethodHotness(
     const MethodReference& method_ref,
     const ProfileSampleAnnotation& annotation) const {
+  if (IsMapped()) {
+    return mapped_profile_->GetMethodHotness(method_ref, annotation);
+  }
   const DexFileData* dex_data = FindDexDataUsingAnnotations(method_ref.dex_file, annotation);
   return dex_data != nullptr
       ? dex_data->GetHotnessInfo(method_ref.index)
@@ -2102,11 +2134,17 @@ ProfileCompilationInfo::MethodHotness ProfileCompilationInfo::GetMethodHotness(
 bool ProfileCompilationInfo::ContainsClass(const DexFile& dex_file,
                                            dex::TypeIndex type_idx,
                                            const ProfileSampleAnnotation& annotation) const {
+  if (IsMapped()) {
+    return mapped_profile_->ContainsClass(dex_file, type_idx, annotation);
+  }
   const DexFileData* dex_data = FindDexDataUsingAnnotations(&dex_file, annotation);
   return (dex_data != nullptr) && dex_data->ContainsClass(type_idx);
 }
 
 uint32_t ProfileCompilationInfo::GetNumberOfMethods() const {
+  if (IsMapped()) {
+    return mapped_profile_->GetNumberOfMethods();
+  }
   uint32_t total = 0;
   for (const std::unique_ptr<DexFileData>& dex_data : info_) {
     total += dex_data->method_map.size();
@@ -2115,6 +2153,9 @@ uint32_t ProfileCompilationInfo::GetNumberOfMethods() const {
 }
 
 uint32_t ProfileCompilationInfo::GetNumberOfResolvedClasses() const {
+  if (IsMapped()) {
+    return mapped_profile_->GetNumberOfResolvedClasses();
+  }
   uint32_t total = 0;
   for (const std::unique_ptr<DexFileData>& dex_data : info_) {
     total += dex_data->class_set.size();
@@ -2236,6 +2277,14 @@ bool ProfileCompilationInfo::GetClassesAndMethods(
     /*out*/std::set<uint16_t>* startup_method_set,
     /*out*/std::set<uint16_t>* post_startup_method_method_set,
     const ProfileSampleAnnotation& annotation) const {
+  if (IsMapped()) {
+    return mapped_profile_->GetClassesAndMethods(dex_file,
+                                                 class_set,
+                                                 hot_method_set,
+                                                 startup_method_set,
+                                                 post_startup_method_method_set,
+                                                 annotation);
+  }
   std::set<std::string> ret;
   const DexFileData* dex_data = FindDexDataUsingAnnotations(&dex_file, annotation);
   if (dex_data == nullptr) {
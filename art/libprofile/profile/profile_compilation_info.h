@@ -76,6 +76,7 @@ struct ProfileMethodInfo {
 };
 
 class FlattenProfileData;
+class MappedProfile;
 
 /**
  * Profile information in a format suitable to be queried by the compiler and
@@ -476,6 +477,21 @@ class ProfileCompilationInfo {
   // Save the profile data to the given file descriptor.
   bool Save(int fd, bool flush = false);
 
+  // Save the profile data to the given file descriptor in the mapped format, see `MappedProfile`.
+  // Inline caches and extra descriptors are not saved.
+  bool SaveMapped(int fd, /*out*/std::string* error_msg) const;
+
+  // Use the mapped profile in `fd` for the queries, without loading it. The current profile must
+  // be empty. Only `GetMethodHotness()`, `ContainsClass()` and `GetClassesAndMethods()` for dex
+  // files, the method and class counts and `IsEmpty()` are supported on such a profile, and the
+  // returned hotness has no inline caches. It cannot be saved or merged.
+  bool LoadMapped(int fd, /*out*/std::string* error_msg);
+
+  // Returns whether the queries are answered from a mapped profile.
+  bool IsMapped() const {
+    return mapped_profile_ != nullptr;
+  }
+
   // Save the current profile into the given file. Overwrites any existing data.
   bool Save(const std::string& filename, uint64_t* bytes_written, bool flush = false);
 
@@ -1073,6 +1089,7 @@ class ProfileCompilationInfo {
   friend class CompilerDriverProfileTest;
   friend class ProfileAssistantTest;
   friend class Dex2oatLayoutTest;
+  friend class MappedProfile;
 
   MallocArenaPool default_arena_pool_;
   ArenaAllocator allocator_;
@@ -1094,6 +1111,9 @@ class ProfileCompilationInfo {
 
   // The version of the profile.
   uint8_t version_[kProfileVersionSize];
+
+  // The mapped profile used for the queries, if any. See `LoadMapped()`.
+  std::unique_ptr<MappedProfile> mapped_profile_;
 };
 
 /**
@@ -19,6 +19,7 @@
 #include <sys/stat.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <fstream>
 #include <iomanip>
@@ -26,7 +27,9 @@
 #include <map>
 #include <optional>
 #include <set>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -353,7 +356,8 @@ class OatDumperOptions {
                    const char* app_image,
                    const char* oat_filename,
                    const char* dex_filename,
-                   uint32_t addr2instr)
+                   uint32_t addr2instr,
+                   size_t thread_count)
       : dump_vmap_(dump_vmap),
         dump_code_info_stack_maps_(dump_code_info_stack_maps),
         disassemble_code_(disassemble_code),
@@ -369,6 +373,7 @@ class OatDumperOptions {
         oat_filename_(oat_filename != nullptr ? std::make_optional(oat_filename) : std::nullopt),
         dex_filename_(dex_filename != nullptr ? std::make_optional(dex_filename) : std::nullopt),
         addr2instr_(addr2instr),
+        thread_count_(thread_count),
         class_loader_(nullptr) {}
 
   const bool dump_vmap_;
@@ -386,6 +391,7 @@ class OatDumperOptions {
   const std::optional<std::string> oat_filename_;
   const std::optional<std::string> dex_filename_;
   uint32_t addr2instr_;
+  const size_t thread_count_;
   Handle<mirror::ClassLoader>* class_loader_;
 };
 
@@ -402,20 +408,12 @@ class OatDumper {
     CHECK(options_.method_filter_ != nullptr);
 
     std::string error_msg;
-    const uint8_t* elf_begin = oat_file.ComputeElfBegin(&error_msg);
-    DCHECK_NE(elf_begin, nullptr) << error_msg;
-    DCHECK_GE(oat_file.Begin(), elf_begin);
-    oat_offset_ = reinterpret_cast<size_t>(oat_file.Begin()) - reinterpret_cast<size_t>(elf_begin);
+    elf_begin_ = oat_file.ComputeElfBegin(&error_msg);
+    DCHECK_NE(elf_begin_, nullptr) << error_msg;
+    DCHECK_GE(oat_file.Begin(), elf_begin_);
+    oat_offset_ = reinterpret_cast<size_t>(oat_file.Begin()) - reinterpret_cast<size_t>(elf_begin_);
 
-    disassembler_ = Disassembler::Create(
-        instruction_set_,
-        new DisassemblerOptions(options_.absolute_addresses_,
-                                elf_begin,
-                                oat_file.End(),
-                                /* can_read_literals_= */ true,
-                                Is64BitInstructionSet(instruction_set_) ?
-                                    &Thread::DumpThreadOffset<PointerSize::k64> :
-                                    &Thread::DumpThreadOffset<PointerSize::k32>));
+    disassembler_ = CreateDisassembler();
 
     AddAllOffsets();
   }
@@ -428,6 +426,18 @@ class OatDumper {
     return instruction_set_;
   }
 
+  Disassembler* CreateDisassembler() const {
+    return Disassembler::Create(
+        instruction_set_,
+        new DisassemblerOptions(options_.absolute_addresses_,
+                                elf_begin_,
+                                oat_file_.End(),
+                                /* can_read_literals_= */ true,
+                                Is64BitInstructionSet(instruction_set_) ?
+                                    &Thread::DumpThreadOffset<PointerSize::k64> :
+                                    &Thread::DumpThreadOffset<PointerSize::k32>));
+  }
+
   using DexFileUniqV = std::vector<std::unique_ptr<const DexFile>>;
 
   bool Dump(std::ostream& os) {
@@ -484,6 +494,8 @@ class OatDumper {
                            GetQuickToInterpreterBridgeOffset);
     DUMP_OAT_HEADER_OFFSET("NTERP_TRAMPOLINE",
                            GetNterpTrampolineOffset);
+    DUMP_OAT_HEADER_OFFSET("STARTUP CODE END",
+                           GetStartupCodeEndOffset);
 #undef DUMP_OAT_HEADER_OFFSET
 
     // Print the key-value store.
@@ -710,7 +722,8 @@ class OatDumper {
 
         // inspired by DumpOatMethod
         for (const ClassAccessor::Method& method : accessor.GetMethods()) {
-          uint32_t code_offset = oat_class.GetOatMethod(class_method_index).GetCodeOffset();
+          const OatFile::OatMethod oat_method = oat_class.GetOatMethod(class_method_index);
+          uint32_t code_offset = oat_method.GetCodeOffset();
           class_method_index++;
 
           uint32_t dex_method_idx = method.GetIndex();
@@ -721,9 +734,22 @@ class OatDumper {
 
           std::string pretty_method = dex_file->PrettyMethod(dex_method_idx, true);
 
-          os << StringPrintf("{\"method\":\"%s\",\"offset\":\"0x%08zx\"}\n",
+          // The CodeInfo size only counts the bit tables owned by this method, not the ones
+          // deduplicated with other methods.
+          size_t code_info_size = 0u;
+          if (oat_method.GetQuickCode() != nullptr && oat_method.GetVmapTable() != nullptr) {
+            Stats code_info_stats;
+            CodeInfo::CollectSizeStats(oat_method.GetVmapTable(), code_info_stats);
+            code_info_size = static_cast<size_t>(code_info_stats.Value());
+          }
+
+          os << StringPrintf("{\"method\":\"%s\",\"offset\":\"0x%08zx\",\"dex_file\":\"%s\","
+                             "\"code_size\":%u,\"code_info_size\":%zu}\n",
                              pretty_method.c_str(),
-                             AdjustOffset(code_offset));
+                             AdjustOffset(code_offset),
+                             dex_file->GetLocation().c_str(),
+                             oat_method.GetQuickCodeSize(),
+                             code_info_size);
         }
       }
     }
@@ -917,6 +943,15 @@ class OatDumper {
       return false;
     }
 
+    disassembly_cache_.clear();
+    if (options_.thread_count_ > 1u &&
+        options_.disassemble_code_ &&
+        !options_.list_classes_ &&
+        !options_.list_methods_ &&
+        resolved_addr2instr_ == 0u) {
+      PrepareDisassembly(oat_dex_file, *dex_file);
+    }
+
     // Print lookup table, if it exists.
     if (oat_dex_file.GetLookupTableData() != nullptr) {
       uint32_t table_offset = dchecked_integral_cast<uint32_t>(
@@ -1540,22 +1575,42 @@ class OatDumper {
     if (code_size == 0 || quick_code == nullptr) {
       vios->Stream() << "NO CODE!\n";
       return;
-    } else if (!bad_input && IsMethodGeneratedByOptimizingCompiler(oat_method,
-                                                                   code_item_accessor)) {
+    }
+    bool use_code_info =
+        !bad_input && IsMethodGeneratedByOptimizingCompiler(oat_method, code_item_accessor);
+    if (use_code_info && AddStatsObject(oat_method.GetVmapTable())) {
+      CodeInfo::CollectSizeStats(oat_method.GetVmapTable(), stats_["CodeInfo"]);
+    }
+    if (use_code_info && code_size == oat_method.GetQuickCodeSize()) {
+      auto it = disassembly_cache_.find(quick_code);
+      if (it != disassembly_cache_.end()) {
+        vios->Stream() << it->second;
+        return;
+      }
+    }
+    DisassembleCode(vios, disassembler_, oat_method, use_code_info, code_size);
+  }
+
+  // Disassembles `code_size` bytes of the code of `oat_method` and, if `use_code_info`,
+  // the stack maps at their native pc. This does not touch any state of the `OatDumper`,
+  // so it can run concurrently for different methods with different disassemblers.
+  void DisassembleCode(VariableIndentationOutputStream* vios,
+                       Disassembler* disassembler,
+                       const OatFile::OatMethod& oat_method,
+                       bool use_code_info,
+                       size_t code_size) const {
+    const uint8_t* quick_native_pc = reinterpret_cast<const uint8_t*>(oat_method.GetQuickCode());
+    if (use_code_info) {
       // The optimizing compiler outputs its CodeInfo data in the vmap table.
       CodeInfo code_info(oat_method.GetVmapTable());
-      if (AddStatsObject(oat_method.GetVmapTable())) {
-        code_info.CollectSizeStats(oat_method.GetVmapTable(), stats_["CodeInfo"]);
-      }
       std::unordered_map<uint32_t, std::vector<StackMap>> stack_maps;
       for (const StackMap& it : code_info.GetStackMaps()) {
         stack_maps[it.GetNativePcOffset(instruction_set_)].push_back(it);
       }
 
-      const uint8_t* quick_native_pc = reinterpret_cast<const uint8_t*>(quick_code);
       size_t offset = 0;
       while (offset < code_size) {
-        offset += disassembler_->Dump(vios->Stream(), quick_native_pc + offset);
+        offset += disassembler->Dump(vios->Stream(), quick_native_pc + offset);
         auto it = stack_maps.find(offset);
         if (it != stack_maps.end()) {
           ScopedIndentation indent1(vios);
@@ -1567,14 +1622,81 @@ class OatDumper {
       }
       DCHECK_EQ(stack_maps.size(), 0u);  // Check that all stack maps have been printed.
     } else {
-      const uint8_t* quick_native_pc = reinterpret_cast<const uint8_t*>(quick_code);
       size_t offset = 0;
       while (offset < code_size) {
-        offset += disassembler_->Dump(vios->Stream(), quick_native_pc + offset);
+        offset += disassembler->Dump(vios->Stream(), quick_native_pc + offset);
       }
     }
   }
 
+  // Disassembles the methods of `dex_file` that `DumpOatDexFile()` is going to print on
+  // `options_.thread_count_` threads, so that `DumpCode()` only needs to copy the output.
+  // Only the methods with valid code are disassembled here, the others are left to `DumpCode()`.
+  void PrepareDisassembly(const OatDexFile& oat_dex_file, const DexFile& dex_file) {
+    struct DisassemblyJob {
+      OatFile::OatMethod oat_method;
+      std::string output;
+    };
+    std::vector<DisassemblyJob> jobs;
+    std::unordered_set<const void*> seen_code;
+    for (ClassAccessor accessor : dex_file.GetClasses()) {
+      if (DescriptorToDot(accessor.GetDescriptor()).find(options_.class_filter_) ==
+              std::string::npos) {
+        continue;
+      }
+      const OatFile::OatClass oat_class = oat_dex_file.GetOatClass(accessor.GetClassDefIndex());
+      uint32_t class_method_index = 0;
+      for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+        const OatFile::OatMethod oat_method = oat_class.GetOatMethod(class_method_index);
+        class_method_index++;
+        std::string method_name = dex_file.GetMethodName(dex_file.GetMethodId(method.GetIndex()));
+        if (method_name.find(options_.method_filter_) == std::string::npos) {
+          continue;
+        }
+        const void* code = oat_method.GetQuickCode();
+        uint32_t code_size = oat_method.GetQuickCodeSize();
+        uint32_t aligned_code_begin = AlignCodeOffset(oat_method.GetCodeOffset());
+        CodeItemDataAccessor code_item_accessor(dex_file, method.GetCodeItem());
+        if (code == nullptr ||
+            code_size == 0u ||
+            code_size > kMaxCodeSize ||
+            aligned_code_begin + code_size > oat_file_.Size() ||
+            !IsMethodGeneratedByOptimizingCompiler(oat_method, code_item_accessor) ||
+            !seen_code.insert(code).second) {
+          continue;
+        }
+        jobs.push_back(DisassemblyJob{oat_method, std::string()});
+      }
+    }
+
+    size_t thread_count = std::min(options_.thread_count_, jobs.size());
+    std::atomic<size_t> next_job(0u);
+    auto worker = [&]() {
+      std::unique_ptr<Disassembler> disassembler(CreateDisassembler());
+      for (size_t i = next_job.fetch_add(1u); i < jobs.size(); i = next_job.fetch_add(1u)) {
+        std::ostringstream oss;
+        VariableIndentationOutputStream vios(&oss);
+        DisassembleCode(&vios,
+                        disassembler.get(),
+                        jobs[i].oat_method,
+                        /*use_code_info=*/ true,
+                        jobs[i].oat_method.GetQuickCodeSize());
+        jobs[i].output = oss.str();
+      }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+      threads.emplace_back(worker);
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+
+    for (DisassemblyJob& job : jobs) {
+      disassembly_cache_.emplace(job.oat_method.GetQuickCode(), std::move(job.output));
+    }
+  }
+
   std::pair<const uint8_t*, const uint8_t*> GetBootImageLiveObjectsDataRange(gc::Heap* heap) const
       REQUIRES_SHARED(Locks::mutator_lock_) {
     const std::vector<gc::space::ImageSpace*>& boot_image_spaces = heap->GetBootImageSpaces();
@@ -1783,7 +1905,11 @@ class OatDumper {
   uint32_t resolved_addr2instr_;
   const InstructionSet instruction_set_;
   std::set<uintptr_t> offsets_;
+  const uint8_t* elf_begin_;
   Disassembler* disassembler_;
+  // Disassembly of the methods of the current dex file, by code pointer, see
+  // `PrepareDisassembly()`.
+  std::unordered_map<const void*, std::string> disassembly_cache_;
   Stats stats_;
   std::unordered_set<const void*> seen_stats_objects_;
 };
@@ -3207,6 +3333,12 @@ struct OatdumpArgs : public CmdlineArgs {
         *error_msg = "Address conversion failed";
         return kParseError;
       }
+    } else if (option.starts_with("-j")) {
+      if (!android::base::ParseUint(raw_option + strlen("-j"), &thread_count_) ||
+          thread_count_ == 0u) {
+        *error_msg = "Thread count conversion failed";
+        return kParseError;
+      }
     } else if (option.starts_with("--app-image=")) {
       app_image_ = raw_option + strlen("--app-image=");
     } else if (option.starts_with("--app-oat=")) {
@@ -3363,6 +3495,8 @@ Options:
         "\n"
         "  --dump-method-and-offset-as-json: dumps fully qualified method names and\n"
         "                                    signatures ONLY, in a standard json format.\n"
+        "                                    Each line also has the dex file location, the\n"
+        "                                    code size and the CodeInfo size of the method.\n"
         "      Example: --dump-method-and-offset-as-json\n"
         "\n"
         "  --export-dex-to=<directory>: may be used to export oat embedded dex files.\n"
@@ -3372,6 +3506,10 @@ Options:
         "                          address (e.g. PC from crash dump)\n"
         "      Example: --addr2instr=0x00001a3b\n"
         "\n"
+        "  -j<count>: disassemble the methods of each dex file on <count> threads before\n"
+        "             dumping them. The output is the same as with a single thread.\n"
+        "      Example: -j8\n"
+        "\n"
         "  --dump-imt=<file.txt>: output IMT collisions (if any) for the given receiver\n"
         "                         types and interface methods in the given file. The file\n"
         "                         is read line-wise, where each line should either be a class\n"
@@ -3421,6 +3559,7 @@ Options:
   bool imt_stat_dump_ = false;
   bool dump_method_and_offset_as_json = false;
   uint32_t addr2instr_ = 0;
+  size_t thread_count_ = 1;
   const char* export_dex_location_ = nullptr;
   const char* app_image_ = nullptr;
   const char* app_oat_ = nullptr;
@@ -3449,7 +3588,8 @@ struct OatdumpMain : public CmdlineMain<OatdumpArgs> {
                                                    args_->app_image_,
                                                    args_->oat_filename_,
                                                    args_->dex_filename_,
-                                                   args_->addr2instr_));
+                                                   args_->addr2instr_,
+                                                   args_->thread_count_));
 
     switch (mode) {
       case OatDumpMode::kDumpImt:
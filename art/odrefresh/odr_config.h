@@ -56,7 +56,8 @@ const std::unordered_set<std::string> kIgnoredSystemProperties{
     "dalvik.vm.restore-dex2oat-cpu-set",
     "dalvik.vm.restore-dex2oat-threads",
     "dalvik.vm.background-dex2oat-cpu-set",
-    "dalvik.vm.background-dex2oat-threads"};
+    "dalvik.vm.background-dex2oat-threads",
+    "dalvik.vm.boot-dex2oat-parallel-jobs"};
 
 struct SystemPropertyConfig {
   const char* name;
@@ -140,6 +141,7 @@ class OdrConfig final {
   std::string boot_classpath_;
   std::string artifact_dir_;
   std::string standalone_system_server_jars_;
+  std::string build_fingerprint_;
   bool compilation_os_mode_ = false;
   bool minimal_ = false;
   bool only_boot_images_ = false;
@@ -235,6 +237,7 @@ class OdrConfig final {
   const std::string& GetSystemServerCompilerFilter() const {
     return system_server_compiler_filter_;
   }
+  const std::string& GetBuildFingerprint() const { return build_fingerprint_; }
   bool GetCompilationOsMode() const { return compilation_os_mode_; }
   bool GetMinimal() const { return minimal_; }
   bool GetOnlyBootImages() const { return only_boot_images_; }
@@ -285,6 +288,8 @@ class OdrConfig final {
     standalone_system_server_jars_ = jars;
   }
 
+  void SetBuildFingerprint(const std::string& fingerprint) { build_fingerprint_ = fingerprint; }
+
   void SetCompilationOsMode(bool value) { compilation_os_mode_ = value; }
 
   void SetMinimal(bool value) { minimal_ = value; }
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "odr_job_queue.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace art {
+namespace odrefresh {
+
+OdrJobQueue::OdrJobQueue(size_t max_parallel_jobs)
+    : max_parallel_jobs_(std::max<size_t>(max_parallel_jobs, 1)) {}
+
+void OdrJobQueue::Add(std::function<void()> job) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  jobs_.push_back(std::move(job));
+  cond_.notify_one();
+}
+
+void OdrJobQueue::Run() {
+  std::vector<std::thread> threads;
+  threads.reserve(max_parallel_jobs_ - 1);
+  for (size_t i = 1; i < max_parallel_jobs_; ++i) {
+    threads.emplace_back(&OdrJobQueue::RunJobs, this);
+  }
+  RunJobs();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+void OdrJobQueue::RunJobs() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    // Wait for a job, unless there is none left and no running job can add more.
+    cond_.wait(lock, [&]() { return !jobs_.empty() || number_of_running_jobs_ == 0; });
+    if (jobs_.empty()) {
+      // Wake up the other threads so that they return too.
+      cond_.notify_all();
+      return;
+    }
+    std::function<void()> job = std::move(jobs_.front());
+    jobs_.pop_front();
+    ++number_of_running_jobs_;
+    lock.unlock();
+    job();
+    lock.lock();
+    --number_of_running_jobs_;
+    if (number_of_running_jobs_ == 0) {
+      cond_.notify_all();
+    }
+  }
+}
+
+}  // namespace odrefresh
+}  // namespace art
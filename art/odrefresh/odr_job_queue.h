@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_ODREFRESH_ODR_JOB_QUEUE_H_
+#define ART_ODREFRESH_ODR_JOB_QUEUE_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace art {
+namespace odrefresh {
+
+// Runs compilation jobs on up to `max_parallel_jobs` threads.
+//
+// A job that other jobs depend on adds them when it is done, so that independent jobs run
+// concurrently while dependent ones wait for their dependencies. Jobs are started in the order
+// they were added, so with a single thread everything runs in the order of a sequential loop.
+class OdrJobQueue final {
+ public:
+  explicit OdrJobQueue(size_t max_parallel_jobs);
+
+  // Adds a job. Can be called by running jobs.
+  void Add(std::function<void()> job);
+
+  // Runs all the jobs, including the ones added by jobs, on the calling thread and up to
+  // `max_parallel_jobs - 1` other threads. Returns when all the jobs are done.
+  void Run();
+
+  size_t GetMaxParallelJobs() const { return max_parallel_jobs_; }
+
+ private:
+  void RunJobs();
+
+  const size_t max_parallel_jobs_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<std::function<void()>> jobs_;
+  size_t number_of_running_jobs_ = 0;
+};
+
+}  // namespace odrefresh
+}  // namespace art
+
+#endif  // ART_ODREFRESH_ODR_JOB_QUEUE_H_
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "odr_job_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace art {
+namespace odrefresh {
+
+using ::testing::ElementsAre;
+
+TEST(OdrJobQueueTest, SingleThreadRunsJobsInOrder) {
+  OdrJobQueue queue(/*max_parallel_jobs=*/1);
+  std::vector<int> order;
+  queue.Add([&]() {
+    order.push_back(1);
+    // Dependent jobs run after the jobs already in the queue.
+    queue.Add([&]() { order.push_back(4); });
+    queue.Add([&]() { order.push_back(5); });
+  });
+  queue.Add([&]() { order.push_back(2); });
+  queue.Add([&]() { order.push_back(3); });
+  queue.Run();
+  EXPECT_THAT(order, ElementsAre(1, 2, 3, 4, 5));
+}
+
+TEST(OdrJobQueueTest, RunsAllJobs) {
+  OdrJobQueue queue(/*max_parallel_jobs=*/4);
+  std::atomic<int> count = 0;
+  for (int i = 0; i < 8; ++i) {
+    queue.Add([&]() {
+      ++count;
+      for (int j = 0; j < 4; ++j) {
+        queue.Add([&]() { ++count; });
+      }
+    });
+  }
+  queue.Run();
+  EXPECT_EQ(count, 8 * 5);
+}
+
+TEST(OdrJobQueueTest, RespectsMaxParallelJobs) {
+  OdrJobQueue queue(/*max_parallel_jobs=*/3);
+  std::atomic<int> running = 0;
+  std::atomic<int> max_running = 0;
+  for (int i = 0; i < 12; ++i) {
+    queue.Add([&]() {
+      int current = ++running;
+      int expected = max_running.load();
+      while (current > expected && !max_running.compare_exchange_weak(expected, current)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      --running;
+    });
+  }
+  queue.Run();
+  EXPECT_LE(max_running, 3);
+  EXPECT_GE(max_running, 1);
+}
+
+TEST(OdrJobQueueTest, Empty) {
+  OdrJobQueue queue(/*max_parallel_jobs=*/2);
+  queue.Run();
+}
+
+}  // namespace odrefresh
+}  // namespace art
@@ -42,6 +42,7 @@
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ostream>
 #include <set>
@@ -99,6 +100,7 @@ using ::android::base::Basename;
 using ::android::base::Dirname;
 using ::android::base::Join;
 using ::android::base::ParseInt;
+using ::android::base::ParseUint;
 using ::android::base::Result;
 using ::android::base::ScopeGuard;
 using ::android::base::SetProperty;
@@ -319,13 +321,43 @@ Result<void> CheckSystemServerComponents(
       });
 }
 
+// Returns the checksums of `cached_component` if it was generated for a file with the given stat
+// info, or nullptr if they must be recomputed.
+template <typename T>
+const std::string* GetCachedChecksums(const T* cached_component,
+                                      uint64_t size,
+                                      uint64_t inode,
+                                      int64_t mtime_ns) {
+  if (cached_component == nullptr || cached_component->getSize() != size ||
+      !cached_component->hasInode() || cached_component->getInode() != inode ||
+      !cached_component->hasMtimeNs() || cached_component->getMtimeNs() != mtime_ns) {
+    return nullptr;
+  }
+  return &cached_component->getChecksums();
+}
+
+// Generates the components for `jars`. If `cached_components` is not null, the checksums of the
+// jars whose path, size, inode and modification time match the cached component are taken from it
+// instead of being computed, which avoids opening the jars. The caller must make sure that the
+// cached stat info can be trusted, see `OnDeviceRefresh::CanReuseCachedChecksums`.
 template <typename T>
 std::vector<T> GenerateComponents(
     const std::vector<std::string>& jars,
-    const std::function<T(const std::string& path, uint64_t size, const std::string& checksum)>&
-        custom_generator) {
+    const std::vector<T>* cached_components,
+    const std::function<T(const std::string& path,
+                          uint64_t size,
+                          const std::string& checksum,
+                          uint64_t inode,
+                          int64_t mtime_ns)>& custom_generator) {
   std::vector<T> components;
 
+  std::unordered_map<std::string_view, const T*> cached_components_map;
+  if (cached_components != nullptr) {
+    for (const T& cached_component : *cached_components) {
+      cached_components_map.emplace(cached_component.getFile(), &cached_component);
+    }
+  }
+
   for (const std::string& path : jars) {
     std::string actual_path = RewriteParentDirectoryIfNeeded(path);
     struct stat sb;
@@ -333,19 +365,31 @@ std::vector<T> GenerateComponents(
       PLOG(ERROR) << "Failed to stat component: " << QuotePath(actual_path);
       return {};
     }
+    const uint64_t size = static_cast<uint64_t>(sb.st_size);
+    const uint64_t inode = static_cast<uint64_t>(sb.st_ino);
+    const int64_t mtime_ns = static_cast<int64_t>(sb.st_mtim.tv_sec) * 1'000'000'000 +
+                             static_cast<int64_t>(sb.st_mtim.tv_nsec);
 
-    std::optional<uint32_t> checksum;
-    std::string error_msg;
-    ArtDexFileLoader dex_loader(actual_path);
-    if (!dex_loader.GetMultiDexChecksum(&checksum, &error_msg)) {
-      LOG(ERROR) << "Failed to get multi-dex checksum: " << error_msg;
-      return {};
-    }
+    auto it = cached_components_map.find(path);
+    const std::string* cached_checksums = GetCachedChecksums(
+        it != cached_components_map.end() ? it->second : nullptr, size, inode, mtime_ns);
 
-    const std::string checksum_str =
-        checksum.has_value() ? StringPrintf("%08x", checksum.value()) : std::string();
+    std::string checksum_str;
+    if (cached_checksums != nullptr) {
+      checksum_str = *cached_checksums;
+    } else {
+      std::optional<uint32_t> checksum;
+      std::string error_msg;
+      ArtDexFileLoader dex_loader(actual_path);
+      if (!dex_loader.GetMultiDexChecksum(&checksum, &error_msg)) {
+        LOG(ERROR) << "Failed to get multi-dex checksum: " << error_msg;
+        return {};
+      }
+      checksum_str =
+          checksum.has_value() ? StringPrintf("%08x", checksum.value()) : std::string();
+    }
 
-    Result<T> component = custom_generator(path, static_cast<uint64_t>(sb.st_size), checksum_str);
+    Result<T> component = custom_generator(path, size, checksum_str, inode, mtime_ns);
     if (!component.ok()) {
       LOG(ERROR) << "Failed to generate component: " << component.error();
       return {};
@@ -357,10 +401,18 @@ std::vector<T> GenerateComponents(
   return components;
 }
 
-std::vector<art_apex::Component> GenerateComponents(const std::vector<std::string>& jars) {
+std::vector<art_apex::Component> GenerateComponents(
+    const std::vector<std::string>& jars,
+    const std::vector<art_apex::Component>* cached_components) {
   return GenerateComponents<art_apex::Component>(
-      jars, [](const std::string& path, uint64_t size, const std::string& checksum) {
-        return art_apex::Component{path, size, checksum};
+      jars,
+      cached_components,
+      [](const std::string& path,
+         uint64_t size,
+         const std::string& checksum,
+         uint64_t inode,
+         int64_t mtime_ns) {
+        return art_apex::Component{path, size, checksum, inode, mtime_ns};
       });
 }
 
@@ -448,6 +500,23 @@ Result<void> AddDex2OatConcurrencyArguments(/*inout*/ CmdlineBuilder& args,
   return {};
 }
 
+// Returns the maximum number of dex2oat invocations to run at the same time. Each invocation uses
+// the threads and the CPU set of `AddDex2OatConcurrencyArguments`, so the devices that run several
+// jobs should scale the threads down accordingly. CompOS always compiles one artifact at a time.
+size_t GetMaxParallelDex2oatJobs(bool is_compilation_os,
+                                 const OdrSystemProperties& system_properties) {
+  if (is_compilation_os) {
+    return 1;
+  }
+  std::string value = system_properties.GetOrEmpty("dalvik.vm.boot-dex2oat-parallel-jobs");
+  size_t max_parallel_jobs = 1;
+  if (!value.empty() && !ParseUint(value, &max_parallel_jobs, /*max=*/size_t{16})) {
+    LOG(WARNING) << ART_FORMAT("Invalid number of parallel dex2oat jobs '{}'", value);
+    return 1;
+  }
+  return std::max<size_t>(max_parallel_jobs, 1);
+}
+
 void AddDex2OatDebugInfo(/*inout*/ CmdlineBuilder& args) {
   args.Add("--generate-mini-debug-info");
   args.Add("--strip");
@@ -855,7 +924,10 @@ NO_INLINE Result<void> OnDeviceRefresh::WriteCacheInfo() const {
       {art_apex::Classpath(bcp_components)},
       {art_apex::Classpath(dex2oat_bcp_components)},
       {art_apex::SystemServerComponents(system_server_components)},
-      config_.GetCompilationOsMode() ? std::make_optional(true) : std::nullopt));
+      config_.GetCompilationOsMode() ? std::make_optional(true) : std::nullopt,
+      config_.GetBuildFingerprint().empty() ?
+          std::nullopt :
+          std::make_optional(config_.GetBuildFingerprint())));
 
   art_apex::write(out, *info);
   out.close();
@@ -874,24 +946,39 @@ static void ReportNextBootAnimationProgress(uint32_t current_compilation,
   SetProperty("service.bootanim.progress", std::to_string(value));
 }
 
-std::vector<art_apex::Component> OnDeviceRefresh::GenerateBootClasspathComponents() const {
-  return GenerateComponents(boot_classpath_jars_);
+std::vector<art_apex::Component> OnDeviceRefresh::GenerateBootClasspathComponents(
+    const std::vector<art_apex::Component>* cached_components) const {
+  return GenerateComponents(boot_classpath_jars_, cached_components);
 }
 
-std::vector<art_apex::Component> OnDeviceRefresh::GenerateDex2oatBootClasspathComponents() const {
-  return GenerateComponents(dex2oat_boot_classpath_jars_);
+std::vector<art_apex::Component> OnDeviceRefresh::GenerateDex2oatBootClasspathComponents(
+    const std::vector<art_apex::Component>* cached_components) const {
+  return GenerateComponents(dex2oat_boot_classpath_jars_, cached_components);
 }
 
-std::vector<art_apex::SystemServerComponent> OnDeviceRefresh::GenerateSystemServerComponents()
-    const {
+std::vector<art_apex::SystemServerComponent> OnDeviceRefresh::GenerateSystemServerComponents(
+    const std::vector<art_apex::SystemServerComponent>* cached_components) const {
   return GenerateComponents<art_apex::SystemServerComponent>(
       all_systemserver_jars_,
-      [&](const std::string& path, uint64_t size, const std::string& checksum) {
+      cached_components,
+      [&](const std::string& path,
+          uint64_t size,
+          const std::string& checksum,
+          uint64_t inode,
+          int64_t mtime_ns) {
         bool isInClasspath = ContainsElement(systemserver_classpath_jars_, path);
-        return art_apex::SystemServerComponent{path, size, checksum, isInClasspath};
+        return art_apex::SystemServerComponent{
+            path, size, checksum, inode, mtime_ns, isInClasspath};
       });
 }
 
+bool OnDeviceRefresh::CanReuseCachedChecksums(const art_apex::CacheInfo& cache_info) const {
+  // Images set fixed modification times on their files, so the same inode and modification time
+  // may describe a different file after an OTA. The build fingerprint changes on every OTA.
+  return !config_.GetBuildFingerprint().empty() && cache_info.hasBuildFingerprint() &&
+         cache_info.getBuildFingerprint() == config_.GetBuildFingerprint();
+}
+
 std::vector<std::string> OnDeviceRefresh::GetArtBcpJars() const {
   std::string art_root = GetArtRoot() + "/";
   std::vector<std::string> art_bcp_jars;
@@ -1295,8 +1382,10 @@ WARN_UNUSED PreconditionCheckResult OnDeviceRefresh::CheckPreconditionForData(
   //
   // The boot class components may change unexpectedly, for example an OTA could update
   // framework.jar.
-  const std::vector<art_apex::Component> current_dex2oat_bcp_components =
-      GenerateDex2oatBootClasspathComponents();
+  //
+  // Computing the checksums requires opening every jar, so the checksums in the cache info are
+  // reused for the files that have not been replaced since it was written.
+  const bool reuse_checksums = CanReuseCachedChecksums(cache_info.value());
 
   const art_apex::Classpath* cached_dex2oat_bcp_components =
       cache_info->getFirstDex2oatBootClasspath();
@@ -1305,6 +1394,10 @@ WARN_UNUSED PreconditionCheckResult OnDeviceRefresh::CheckPreconditionForData(
     return PreconditionCheckResult::NoneOk(OdrMetrics::Trigger::kApexVersionMismatch);
   }
 
+  const std::vector<art_apex::Component> current_dex2oat_bcp_components =
+      GenerateDex2oatBootClasspathComponents(
+          reuse_checksums ? &cached_dex2oat_bcp_components->getComponent() : nullptr);
+
   Result<void> result = CheckComponents(current_dex2oat_bcp_components,
                                         cached_dex2oat_bcp_components->getComponent());
   if (!result.ok()) {
@@ -1345,8 +1438,6 @@ WARN_UNUSED PreconditionCheckResult OnDeviceRefresh::CheckPreconditionForData(
     }
   }
 
-  const std::vector<art_apex::Component> current_bcp_components = GenerateBootClasspathComponents();
-
   const art_apex::Classpath* cached_bcp_components = cache_info->getFirstBootClasspath();
   if (cached_bcp_components == nullptr) {
     LOG(INFO) << "Missing BootClasspath components.";
@@ -1354,6 +1445,9 @@ WARN_UNUSED PreconditionCheckResult OnDeviceRefresh::CheckPreconditionForData(
         OdrMetrics::Trigger::kApexVersionMismatch);
   }
 
+  const std::vector<art_apex::Component> current_bcp_components = GenerateBootClasspathComponents(
+      reuse_checksums ? &cached_bcp_components->getComponent() : nullptr);
+
   result = CheckComponents(current_bcp_components, cached_bcp_components->getComponent());
   if (!result.ok()) {
     LOG(INFO) << "BootClasspath components mismatch: " << result.error();
@@ -1372,9 +1466,6 @@ WARN_UNUSED PreconditionCheckResult OnDeviceRefresh::CheckPreconditionForData(
   //
   // The system_server components may change unexpectedly, for example an OTA could update
   // services.jar.
-  const std::vector<art_apex::SystemServerComponent> current_system_server_components =
-      GenerateSystemServerComponents();
-
   const art_apex::SystemServerComponents* cached_system_server_components =
       cache_info->getFirstSystemServerComponents();
   if (cached_system_server_components == nullptr) {
@@ -1382,6 +1473,10 @@ WARN_UNUSED PreconditionCheckResult OnDeviceRefresh::CheckPreconditionForData(
     return PreconditionCheckResult::SystemServerNotOk(OdrMetrics::Trigger::kApexVersionMismatch);
   }
 
+  const std::vector<art_apex::SystemServerComponent> current_system_server_components =
+      GenerateSystemServerComponents(
+          reuse_checksums ? &cached_system_server_components->getComponent() : nullptr);
+
   result = CheckSystemServerComponents(current_system_server_components,
                                        cached_system_server_components->getComponent());
   if (!result.ok()) {
@@ -2094,39 +2189,46 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oatForSystemServer(
                     readonly_files_raii);
 }
 
-WARN_UNUSED CompilationResult
-OnDeviceRefresh::CompileSystemServer(const std::string& staging_dir,
-                                     const std::set<std::string>& system_server_jars_to_compile,
-                                     const std::function<void()>& on_dex2oat_success) const {
+void OnDeviceRefresh::CompileSystemServer(
+    const std::string& staging_dir,
+    const std::set<std::string>& system_server_jars_to_compile,
+    const std::function<void()>& on_dex2oat_success,
+    OdrJobQueue& jobs,
+    /*out*/ std::vector<CompilationResult>* results) const {
   DCHECK(!system_server_jars_to_compile.empty());
 
-  CompilationResult result = CompilationResult::Ok();
   std::vector<std::string> classloader_context;
 
   if (!check_compilation_space_()) {
     LOG(ERROR) << "Compilation of system_server failed: Insufficient space";
-    return CompilationResult::Error(OdrMetrics::Status::kNoSpace, "Insufficient space");
+    results->push_back(
+        CompilationResult::Error(OdrMetrics::Status::kNoSpace, "Insufficient space"));
+    return;
   }
 
+  // Reserve the results first, so that the jobs do not see them move.
+  size_t first_result = results->size();
+  results->resize(first_result + system_server_jars_to_compile.size(), CompilationResult::Ok());
+  size_t result_index = first_result;
   for (const std::string& jar : all_systemserver_jars_) {
     if (ContainsElement(system_server_jars_to_compile, jar)) {
-      CompilationResult current_result =
-          RunDex2oatForSystemServer(staging_dir, jar, classloader_context);
-      result.Merge(current_result);
-
-      if (current_result.IsOk()) {
-        on_dex2oat_success();
-      } else {
-        LOG(ERROR) << ART_FORMAT("Compilation of {} failed: {}", Basename(jar), result.error_msg);
-      }
+      CompilationResult* result = &(*results)[result_index++];
+      jobs.Add([this, &staging_dir, &on_dex2oat_success, result, jar, classloader_context]() {
+        *result = RunDex2oatForSystemServer(staging_dir, jar, classloader_context);
+        if (result->IsOk()) {
+          on_dex2oat_success();
+        } else {
+          LOG(ERROR) << ART_FORMAT(
+              "Compilation of {} failed: {}", Basename(jar), result->error_msg);
+        }
+      });
     }
 
     if (ContainsElement(systemserver_classpath_jars_, jar)) {
       classloader_context.emplace_back(jar);
     }
   }
-
-  return result;
+  DCHECK_EQ(result_index, results->size());
 }
 
 WARN_UNUSED ExitCode OnDeviceRefresh::Compile(OdrMetrics& metrics,
@@ -2186,7 +2288,9 @@ WARN_UNUSED ExitCode OnDeviceRefresh::Compile(OdrMetrics& metrics,
   uint32_t dex2oat_invocation_count = 0;
   uint32_t total_dex2oat_invocation_count = compilation_options.CompilationUnitCount();
   ReportNextBootAnimationProgress(dex2oat_invocation_count, total_dex2oat_invocation_count);
-  auto advance_animation_progress = [&]() {
+  std::mutex animation_progress_mutex;
+  std::function<void()> advance_animation_progress = [&]() {
+    std::lock_guard<std::mutex> lock(animation_progress_mutex);
     ReportNextBootAnimationProgress(++dex2oat_invocation_count, total_dex2oat_invocation_count);
   };
 
@@ -2194,16 +2298,55 @@ WARN_UNUSED ExitCode OnDeviceRefresh::Compile(OdrMetrics& metrics,
   DCHECK(!bcp_instruction_sets.empty() && bcp_instruction_sets.size() <= 2);
   InstructionSet system_server_isa = config_.GetSystemServerIsa();
 
+  // The compilations form a dependency graph: the boot images of each ISA are compiled one after
+  // the other, as each extension depends on the previous boot images, and the system server jars
+  // depend on the boot images of the system server ISA only. Independent compilations run in
+  // parallel, up to the configured number of dex2oat invocations.
+  OdrJobQueue jobs(GetMaxParallelDex2oatJobs(config_.GetCompilationOsMode(),
+                                             config_.GetSystemProperties()));
+  const bool compile_system_server = !compilation_options.system_server_jars_to_compile.empty() &&
+                                     !config_.GetOnlyBootImages();
+  std::vector<CompilationResult> ss_results;
+  auto compile_system_server_jars = [&]() {
+    CompileSystemServer(staging_dir,
+                        compilation_options.system_server_jars_to_compile,
+                        advance_animation_progress,
+                        jobs,
+                        &ss_results);
+  };
+
+  const std::vector<std::pair<InstructionSet, BootImages>>& boot_images_to_generate_for_isas =
+      compilation_options.boot_images_to_generate_for_isas;
+  std::vector<CompilationResult> bcp_results(boot_images_to_generate_for_isas.size(),
+                                             CompilationResult::Ok());
+  bool system_server_waits_for_bcp = false;
+  for (size_t i = 0; i != bcp_results.size(); ++i) {
+    bool is_system_server_isa = boot_images_to_generate_for_isas[i].first == system_server_isa;
+    system_server_waits_for_bcp |= is_system_server_isa;
+    jobs.Add([&, i, is_system_server_isa]() {
+      const auto& [isa, boot_images_to_generate] = boot_images_to_generate_for_isas[i];
+      bcp_results[i] = CompileBootClasspath(
+          staging_dir, isa, boot_images_to_generate, advance_animation_progress);
+      // Don't compile system server if the compilation of BCP failed.
+      if (is_system_server_isa && bcp_results[i].IsOk() && compile_system_server) {
+        compile_system_server_jars();
+      }
+    });
+  }
+  if (!system_server_waits_for_bcp && compile_system_server) {
+    compile_system_server_jars();
+  }
+  jobs.Run();
+
   bool system_server_isa_failed = false;
   std::optional<std::pair<OdrMetrics::Stage, OdrMetrics::Status>> first_failure;
 
-  for (const auto& [isa, boot_images_to_generate] :
-       compilation_options.boot_images_to_generate_for_isas) {
+  for (size_t i = 0; i != bcp_results.size(); ++i) {
+    const auto& [isa, boot_images_to_generate] = boot_images_to_generate_for_isas[i];
     OdrMetrics::Stage stage = (isa == bcp_instruction_sets.front()) ?
                                   OdrMetrics::Stage::kPrimaryBootClasspath :
                                   OdrMetrics::Stage::kSecondaryBootClasspath;
-    CompilationResult bcp_result =
-        CompileBootClasspath(staging_dir, isa, boot_images_to_generate, advance_animation_progress);
+    const CompilationResult& bcp_result = bcp_results[i];
     metrics.SetDex2OatResult(stage, bcp_result.elapsed_time_ms, bcp_result.dex2oat_result);
     metrics.SetBcpCompilationType(stage, boot_images_to_generate.GetTypeForMetrics());
     if (!bcp_result.IsOk()) {
@@ -2214,12 +2357,12 @@ WARN_UNUSED ExitCode OnDeviceRefresh::Compile(OdrMetrics& metrics,
     }
   }
 
-  // Don't compile system server if the compilation of BCP failed.
-  if (!system_server_isa_failed && !compilation_options.system_server_jars_to_compile.empty() &&
-      !config_.GetOnlyBootImages()) {
+  if (!system_server_isa_failed && compile_system_server) {
     OdrMetrics::Stage stage = OdrMetrics::Stage::kSystemServerClasspath;
-    CompilationResult ss_result = CompileSystemServer(
-        staging_dir, compilation_options.system_server_jars_to_compile, advance_animation_progress);
+    CompilationResult ss_result = CompilationResult::Ok();
+    for (const CompilationResult& result : ss_results) {
+      ss_result.Merge(result);
+    }
     metrics.SetDex2OatResult(stage, ss_result.elapsed_time_ms, ss_result.dex2oat_result);
     if (!ss_result.IsOk()) {
       first_failure = first_failure.value_or(std::make_pair(stage, ss_result.status));
@@ -34,6 +34,7 @@
 #include "exec_utils.h"
 #include "odr_artifacts.h"
 #include "odr_config.h"
+#include "odr_job_queue.h"
 #include "odr_metrics.h"
 #include "odrefresh/odrefresh.h"
 #include "tools/cmdline_builder.h"
@@ -206,11 +207,21 @@ class OnDeviceRefresh final {
   // Writes ART APEX cache information to `kOnDeviceRefreshOdrefreshArtifactDirectory`.
   android::base::Result<void> WriteCacheInfo() const;
 
-  std::vector<com::android::art::Component> GenerateBootClasspathComponents() const;
+  // The `Generate*Components` functions take the checksums of unchanged jars from
+  // `cached_components`, if not null. See `CanReuseCachedChecksums`.
+  std::vector<com::android::art::Component> GenerateBootClasspathComponents(
+      const std::vector<com::android::art::Component>* cached_components = nullptr) const;
 
-  std::vector<com::android::art::Component> GenerateDex2oatBootClasspathComponents() const;
+  std::vector<com::android::art::Component> GenerateDex2oatBootClasspathComponents(
+      const std::vector<com::android::art::Component>* cached_components = nullptr) const;
 
-  std::vector<com::android::art::SystemServerComponent> GenerateSystemServerComponents() const;
+  std::vector<com::android::art::SystemServerComponent> GenerateSystemServerComponents(
+      const std::vector<com::android::art::SystemServerComponent>* cached_components =
+          nullptr) const;
+
+  // Returns true if the stat info of the components in `cache_info` can be trusted to identify
+  // unchanged jars, so that their checksums need not be recomputed.
+  bool CanReuseCachedChecksums(const com::android::art::CacheInfo& cache_info) const;
 
   // Returns the list of BCP jars in the ART module.
   std::vector<std::string> GetArtBcpJars() const;
@@ -361,10 +372,15 @@ class OnDeviceRefresh final {
                             const std::string& dex_file,
                             const std::vector<std::string>& classloader_context) const;
 
-  WARN_UNUSED CompilationResult
-  CompileSystemServer(const std::string& staging_dir,
-                      const std::set<std::string>& system_server_jars_to_compile,
-                      const std::function<void()>& on_dex2oat_success) const;
+  // Adds jobs to `jobs` that compile the given system server jars. The jars do not depend on each
+  // other's artifacts, as the class loader context only refers to the dex files, so they can be
+  // compiled concurrently. The result of each compilation is appended to `results` in classpath
+  // order, before the jobs run, and set when its job is done.
+  void CompileSystemServer(const std::string& staging_dir,
+                           const std::set<std::string>& system_server_jars_to_compile,
+                           const std::function<void()>& on_dex2oat_success,
+                           OdrJobQueue& jobs,
+                           /*out*/ std::vector<CompilationResult>* results) const;
 
   // Configuration to use.
   const OdrConfig& config_;
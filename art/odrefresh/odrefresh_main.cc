@@ -199,6 +199,8 @@ int InitializeConfig(int argc, char** argv, OdrConfig* config) {
     config->SetRefresh(false);
   }
 
+  config->SetBuildFingerprint(GetProperty("ro.build.fingerprint", /*default_value=*/""));
+
   return n;
 }
 
@@ -583,6 +583,102 @@ TEST_F(OdRefreshTest, ContinueWhenSystemServerCompilationFailed) {
       ExitCode::kCompilationFailed);
 }
 
+TEST_F(OdRefreshTest, ParallelCompilation) {
+  config_.MutableSystemProperties()->emplace("dalvik.vm.boot-dex2oat-parallel-jobs", "4");
+
+  EXPECT_CALL(*mock_exec_utils_,
+              DoExecAndReturnCode(AllOf(Contains("--instruction-set=x86_64"),
+                                        Contains(Flag("--dex-file=", core_oj_jar_)))))
+      .WillOnce(Return(0));
+  EXPECT_CALL(*mock_exec_utils_,
+              DoExecAndReturnCode(AllOf(Contains("--instruction-set=x86_64"),
+                                        Contains(Flag("--dex-file=", conscrypt_jar_)))))
+      .WillOnce(Return(0));
+  EXPECT_CALL(*mock_exec_utils_,
+              DoExecAndReturnCode(AllOf(Contains("--instruction-set=x86"),
+                                        Contains(Flag("--dex-file=", core_oj_jar_)))))
+      .WillOnce(Return(0));
+  EXPECT_CALL(*mock_exec_utils_,
+              DoExecAndReturnCode(AllOf(Contains("--instruction-set=x86"),
+                                        Contains(Flag("--dex-file=", conscrypt_jar_)))))
+      .WillOnce(Return(0));
+
+  // The class loader contexts are the same as with sequential compilation.
+  EXPECT_CALL(*mock_exec_utils_,
+              DoExecAndReturnCode(AllOf(Contains(Flag("--dex-file=", location_provider_jar_)),
+                                        Contains("--class-loader-context=PCL[]"))))
+      .WillOnce(Return(0));
+  EXPECT_CALL(
+      *mock_exec_utils_,
+      DoExecAndReturnCode(AllOf(
+          Contains(Flag("--dex-file=", services_jar_)),
+          Contains(Flag("--class-loader-context=", ART_FORMAT("PCL[{}]", location_provider_jar_))),
+          Contains(Flag("--class-loader-context-fds=", FdOf(location_provider_jar_))))))
+      .WillOnce(Return(0));
+  EXPECT_CALL(
+      *mock_exec_utils_,
+      DoExecAndReturnCode(AllOf(
+          Contains(Flag("--dex-file=", services_foo_jar_)),
+          Contains(Flag("--class-loader-context=",
+                        ART_FORMAT("PCL[];PCL[{}:{}]", location_provider_jar_, services_jar_))))))
+      .WillOnce(Return(0));
+  EXPECT_CALL(
+      *mock_exec_utils_,
+      DoExecAndReturnCode(AllOf(
+          Contains(Flag("--dex-file=", services_bar_jar_)),
+          Contains(Flag("--class-loader-context=",
+                        ART_FORMAT("PCL[];PCL[{}:{}]", location_provider_jar_, services_jar_))))))
+      .WillOnce(Return(0));
+
+  EXPECT_EQ(odrefresh_->Compile(
+                *metrics_,
+                CompilationOptions{
+                    .boot_images_to_generate_for_isas{
+                        {InstructionSet::kX86_64,
+                         {.primary_boot_image = true, .boot_image_mainline_extension = true}},
+                        {InstructionSet::kX86,
+                         {.primary_boot_image = true, .boot_image_mainline_extension = true}}},
+                    .system_server_jars_to_compile = odrefresh_->AllSystemServerJars(),
+                }),
+            ExitCode::kCompilationSuccess);
+}
+
+TEST_F(OdRefreshTest, ParallelCompilationWaitsForSystemServerBcp) {
+  config_.MutableSystemProperties()->emplace("dalvik.vm.boot-dex2oat-parallel-jobs", "4");
+
+  // Simulate that the compilation of BCP for the system server ISA fails, including the minimal
+  // boot image.
+  EXPECT_CALL(*mock_exec_utils_,
+              DoExecAndReturnCode(AllOf(Contains("--instruction-set=x86_64"),
+                                        Contains(Flag("--dex-file=", core_oj_jar_)))))
+      .Times(2)
+      .WillRepeatedly(Return(1));
+
+  // The other ISA is not affected.
+  EXPECT_CALL(*mock_exec_utils_, DoExecAndReturnCode(Contains("--instruction-set=x86")))
+      .Times(2)
+      .WillRepeatedly(Return(0));
+
+  // System server is not compiled, even though it could start while the other ISA compiles.
+  EXPECT_CALL(*mock_exec_utils_,
+              DoExecAndReturnCode(Contains(Flag("--dex-file=", location_provider_jar_))))
+      .Times(0);
+  EXPECT_CALL(*mock_exec_utils_, DoExecAndReturnCode(Contains(Flag("--dex-file=", services_jar_))))
+      .Times(0);
+
+  EXPECT_EQ(odrefresh_->Compile(
+                *metrics_,
+                CompilationOptions{
+                    .boot_images_to_generate_for_isas{
+                        {InstructionSet::kX86_64,
+                         {.primary_boot_image = true, .boot_image_mainline_extension = true}},
+                        {InstructionSet::kX86,
+                         {.primary_boot_image = true, .boot_image_mainline_extension = true}}},
+                    .system_server_jars_to_compile = odrefresh_->AllSystemServerJars(),
+                }),
+            ExitCode::kCompilationFailed);
+}
+
 // Test setup: The compiler filter is explicitly set to "speed-profile". Use it regardless of
 // whether the profile exists or not. Dex2oat will fall back to "verify" if the profile doesn't
 // exist.
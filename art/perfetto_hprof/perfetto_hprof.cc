@@ -40,6 +40,7 @@
 #include "android-base/properties.h"
 #include "base/fast_exit.h"
 #include "base/systrace.h"
+#include "base/time_utils.h"
 #include "gc/heap-visit-objects-inl.h"
 #include "gc/heap.h"
 #include "gc/scoped_gc_critical_section.h"
@@ -1003,6 +1004,7 @@ void ForkAndRun(art::Thread* self,
   std::optional<art::gc::ScopedGCCriticalSection> gcs(std::in_place, self, art::gc::kGcCauseHprof,
                                                       art::gc::kCollectorTypeHprof);
 
+  uint64_t suspend_start_ns = art::NanoTime();
   std::optional<art::ScopedSuspendAll> ssa(std::in_place, __FUNCTION__, /* long_suspend=*/ true);
 
   // Optimistically get the thread_list_lock_ to avoid the child process deadlocking
@@ -1014,16 +1016,23 @@ void ForkAndRun(art::Thread* self,
   }
   if (pid != 0) {
     // Parent
+    // Report how long the application was paused for the dump. With the IMMEDIATELY policy this
+    // is the time to suspend all threads and fork, which grows with the size of the page tables
+    // to copy but not with the time the child takes to walk the heap.
+    auto resume_parent = [&]() {
+      ssa.reset();
+      gcs.reset();
+      LOG(INFO) << "forked " << pid << " for " << parent_pid << ", application paused for "
+                << art::PrettyDuration(art::NanoTime() - suspend_start_ns);
+    };
     if (resume_parent_policy == ResumeParentPolicy::IMMEDIATELY) {
       // Stop the thread suspension as soon as possible to allow the rest of the application to
       // continue while we waitpid here.
-      ssa.reset();
-      gcs.reset();
+      resume_parent();
     }
     parent_runnable(pid);
     if (resume_parent_policy != ResumeParentPolicy::IMMEDIATELY) {
-      ssa.reset();
-      gcs.reset();
+      resume_parent();
     }
     return;
   }
@@ -16,6 +16,7 @@
 
 #include "boot_image_profile.h"
 
+#include <algorithm>
 #include <memory>
 #include <set>
 
@@ -27,6 +28,7 @@
 #include "dex/type_reference.h"
 #include "profile/profile_compilation_info.h"
 #include "inline_cache_format_util.h"
+#include "sharded_merge.h"
 
 namespace art {
 
@@ -209,16 +211,36 @@ bool GenerateBootImageProfile(
 
   bool generate_preloaded_classes = !preloaded_classes_out_path.empty();
 
-  std::unique_ptr<FlattenProfileData> flattend_data(new FlattenProfileData());
-  for (const std::string& profile_file : profile_files) {
-    ProfileCompilationInfo profile(/*for_boot_image=*/ true);
-    if (!profile.Load(profile_file, /*clear_if_invalid=*/ false)) {
-      LOG(ERROR) << "Profile is not a valid: " << profile_file;
-      return false;
-    }
-    std::unique_ptr<FlattenProfileData> currentData = profile.ExtractProfileData(dex_files);
-    flattend_data->MergeData(*currentData);
+  // Each shard of the input profiles is flattened on its own thread, one profile at a time, and
+  // the shards are then merged in order. `FlattenProfileData::MergeData()` is associative, so the
+  // result is the same as with a sequential merge.
+  std::vector<std::unique_ptr<FlattenProfileData>> shards(
+      GetNumberOfShards(profile_files.size(), options.num_threads));
+  std::vector<uint8_t> shard_failed(shards.size(), 0u);
+  ShardedMerge(
+      profile_files.size(),
+      options.num_threads,
+      [&](size_t shard_index, size_t begin, size_t end) {
+        shards[shard_index].reset(new FlattenProfileData());
+        for (size_t i = begin; i < end; ++i) {
+          ProfileCompilationInfo profile(/*for_boot_image=*/ true);
+          if (!profile.Load(profile_files[i], /*clear_if_invalid=*/ false)) {
+            LOG(ERROR) << "Profile is not a valid: " << profile_files[i];
+            shard_failed[shard_index] = 1u;
+            return;
+          }
+          std::unique_ptr<FlattenProfileData> currentData = profile.ExtractProfileData(dex_files);
+          shards[shard_index]->MergeData(*currentData);
+        }
+      },
+      [&](size_t left_index, size_t right_index) {
+        shards[left_index]->MergeData(*shards[right_index]);
+        shards[right_index].reset();
+      });
+  if (std::find(shard_failed.begin(), shard_failed.end(), 1u) != shard_failed.end()) {
+    return false;
   }
+  std::unique_ptr<FlattenProfileData> flattend_data = std::move(shards[0]);
 
   // We want the output sorted by the method/class name.
   // So we use an intermediate map for that.
@@ -67,6 +67,9 @@ struct BootImageOptions {
 
   // The set of classes that should not be preloaded in Zygote
   std::set<std::string> preloaded_classes_denylist;
+
+  // The number of threads used to load and flatten the input profiles.
+  uint32_t num_threads = 1;
 };
 
 // Generate a boot image profile according to the specified options.
@@ -16,9 +16,13 @@
 
 #include "profile_assistant.h"
 
+#include <memory>
+#include <optional>
+
 #include "base/os.h"
 #include "base/unix_file/fd_file.h"
 #include "profman/profman_result.h"
+#include "sharded_merge.h"
 
 namespace art {
 
@@ -27,30 +31,16 @@ namespace art {
 static constexpr const uint32_t kMinNewMethodsForCompilation = 100;
 static constexpr const uint32_t kMinNewClassesForCompilation = 50;
 
-ProfmanResult::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
+// Merge the profiles [begin, end) into `info`. Returns the error for the first profile that
+// cannot be loaded or merged, if any.
+static std::optional<ProfmanResult::ProcessingResult> MergeProfiles(
     const std::vector<ScopedFlock>& profile_files,
-    const ScopedFlock& reference_profile_file,
+    size_t begin,
+    size_t end,
     const ProfileCompilationInfo::ProfileLoadFilterFn& filter_fn,
-    const Options& options) {
-  ProfileCompilationInfo info(options.IsBootImageMerge());
-
-  // Load the reference profile.
-  if (!info.Load(reference_profile_file->Fd(), /*merge_classes=*/ true, filter_fn)) {
-    LOG(WARNING) << "Could not load reference profile file";
-    return ProfmanResult::kErrorBadProfiles;
-  }
-
-  if (options.IsBootImageMerge() && !info.IsForBootImage()) {
-    LOG(WARNING) << "Requested merge for boot image profile but the reference profile is regular.";
-    return ProfmanResult::kErrorBadProfiles;
-  }
-
-  // Store the current state of the reference profile before merging with the current profiles.
-  uint32_t number_of_methods = info.GetNumberOfMethods();
-  uint32_t number_of_classes = info.GetNumberOfResolvedClasses();
-
-  // Merge all current profiles.
-  for (size_t i = 0; i < profile_files.size(); i++) {
+    const ProfileAssistant::Options& options,
+    ProfileCompilationInfo* info) {
+  for (size_t i = begin; i < end; i++) {
     ProfileCompilationInfo cur_info(options.IsBootImageMerge());
     if (!cur_info.Load(profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn)) {
       LOG(WARNING) << "Could not load profile file at index " << i;
@@ -68,11 +58,74 @@ ProfmanResult::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
       return ProfmanResult::kErrorBadProfiles;
     }
 
-    if (!info.MergeWith(cur_info)) {
+    if (!info->MergeWith(cur_info)) {
       LOG(WARNING) << "Could not merge profile file at index " << i;
       return ProfmanResult::kErrorBadProfiles;
     }
   }
+  return std::nullopt;
+}
+
+ProfmanResult::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
+    const std::vector<ScopedFlock>& profile_files,
+    const ScopedFlock& reference_profile_file,
+    const ProfileCompilationInfo::ProfileLoadFilterFn& filter_fn,
+    const Options& options) {
+  ProfileCompilationInfo info(options.IsBootImageMerge());
+
+  // Load the reference profile.
+  if (!info.Load(reference_profile_file->Fd(), /*merge_classes=*/ true, filter_fn)) {
+    LOG(WARNING) << "Could not load reference profile file";
+    return ProfmanResult::kErrorBadProfiles;
+  }
+
+  if (options.IsBootImageMerge() && !info.IsForBootImage()) {
+    LOG(WARNING) << "Requested merge for boot image profile but the reference profile is regular.";
+    return ProfmanResult::kErrorBadProfiles;
+  }
+
+  // Store the current state of the reference profile before merging with the current profiles.
+  uint32_t number_of_methods = info.GetNumberOfMethods();
+  uint32_t number_of_classes = info.GetNumberOfResolvedClasses();
+
+  // Merge all current profiles. The first shard is merged directly into the reference profile,
+  // the others into profiles of their own, which are then merged in order. This gives the same
+  // result, and reports the same error, as merging the profiles one by one.
+  struct Shard {
+    ProfileCompilationInfo* info = nullptr;
+    std::unique_ptr<ProfileCompilationInfo> storage;
+    std::optional<ProfmanResult::ProcessingResult> error;
+  };
+  std::vector<Shard> shards(GetNumberOfShards(profile_files.size(), options.GetNumThreads()));
+  ShardedMerge(
+      profile_files.size(),
+      options.GetNumThreads(),
+      [&](size_t shard_index, size_t begin, size_t end) {
+        Shard& shard = shards[shard_index];
+        if (shard_index == 0u) {
+          shard.info = &info;
+        } else {
+          shard.storage = std::make_unique<ProfileCompilationInfo>(options.IsBootImageMerge());
+          shard.info = shard.storage.get();
+        }
+        shard.error = MergeProfiles(profile_files, begin, end, filter_fn, options, shard.info);
+      },
+      [&](size_t left_index, size_t right_index) {
+        Shard& left = shards[left_index];
+        Shard& right = shards[right_index];
+        if (!left.error.has_value()) {
+          if (right.error.has_value()) {
+            left.error = right.error;
+          } else if (!left.info->MergeWith(*right.info)) {
+            LOG(WARNING) << "Could not merge profile files";
+            left.error = ProfmanResult::kErrorBadProfiles;
+          }
+        }
+        right.storage.reset();
+      });
+  if (shards[0].error.has_value()) {
+    return shards[0].error.value();
+  }
 
   // If we perform a forced merge do not analyze the difference between profiles.
   if (!options.IsForceMerge()) {
@@ -34,6 +34,7 @@ class ProfileAssistant {
     static constexpr bool kBootImageMergeDefault = false;
     static constexpr uint32_t kMinNewMethodsPercentChangeForCompilation = 2;
     static constexpr uint32_t kMinNewClassesPercentChangeForCompilation = 2;
+    static constexpr uint32_t kNumThreadsDefault = 1;
 
     Options()
         : force_merge_(kForceMergeDefault),
@@ -42,7 +43,8 @@ class ProfileAssistant {
           min_new_methods_percent_change_for_compilation_(
               kMinNewMethodsPercentChangeForCompilation),
           min_new_classes_percent_change_for_compilation_(
-              kMinNewClassesPercentChangeForCompilation) {
+              kMinNewClassesPercentChangeForCompilation),
+          num_threads_(kNumThreadsDefault) {
     }
 
     // Only for S and T uses. U+ should use `IsForceMergeAndAnalyze`.
@@ -55,6 +57,7 @@ class ProfileAssistant {
     uint32_t GetMinNewClassesPercentChangeForCompilation() const {
         return min_new_classes_percent_change_for_compilation_;
     }
+    uint32_t GetNumThreads() const { return num_threads_; }
 
     void SetForceMerge(bool value) { force_merge_ = value; }
     void SetForceMergeAndAnalyze(bool value) { force_merge_and_analyze_ = value; }
@@ -65,6 +68,7 @@ class ProfileAssistant {
     void SetMinNewClassesPercentChangeForCompilation(uint32_t value) {
       min_new_classes_percent_change_for_compilation_ = value;
     }
+    void SetNumThreads(uint32_t value) { num_threads_ = value; }
 
    private:
     // If true, performs a forced merge, without analyzing if there is a significant difference
@@ -81,6 +85,9 @@ class ProfileAssistant {
     bool boot_image_merge_;
     uint32_t min_new_methods_percent_change_for_compilation_;
     uint32_t min_new_classes_percent_change_for_compilation_;
+    // The number of threads used to load and merge the current profiles. With more than one
+    // thread, `filter_fn` is called concurrently.
+    uint32_t num_threads_;
   };
 
   // Process the profile information present in the given files. Returns one of
@@ -1520,6 +1520,68 @@ TEST_F(ProfileAssistantTest, MergeProfilesWithDifferentDexOrder) {
   CheckProfileInfo(profile1, info1);
 }
 
+TEST_F(ProfileAssistantTest, MergeProfilesWithThreads) {
+  static constexpr size_t kNumberOfProfiles = 7;
+  const DexFile* dex_files[] = { dex1, dex2, dex3, dex4 };
+  std::vector<std::unique_ptr<ScratchFile>> profiles;
+  std::vector<std::unique_ptr<ProfileCompilationInfo>> infos;
+  std::vector<int> profile_fds;
+  for (uint16_t i = 0; i != kNumberOfProfiles; ++i) {
+    profiles.push_back(std::make_unique<ScratchFile>());
+    infos.push_back(std::make_unique<ProfileCompilationInfo>());
+    // Use overlapping methods and a different dex file order in each profile.
+    SetupProfile(dex_files[i % 4],
+                 dex_files[(i + 1) % 4],
+                 /*number_of_methods=*/ 50,
+                 /*number_of_classes=*/ i,
+                 *profiles.back(),
+                 infos.back().get(),
+                 /*start_method_index=*/ 20 * i);
+    profile_fds.push_back(GetFd(*profiles.back()));
+  }
+  ScratchFile reference_profile;
+  ProfileCompilationInfo reference_info;
+  SetupProfile(dex3, dex1, /*number_of_methods=*/ 30, /*number_of_classes=*/ 0, reference_profile,
+      &reference_info);
+
+  ASSERT_EQ(ProfmanResult::kCompile,
+            ProcessProfiles(profile_fds, GetFd(reference_profile), {"--merge-threads=3"}));
+
+  // The result must be the same as a sequential merge.
+  ProfileCompilationInfo result;
+  ASSERT_TRUE(result.Load(GetFd(reference_profile)));
+  ProfileCompilationInfo expected;
+  ASSERT_TRUE(expected.MergeWith(reference_info));
+  for (const std::unique_ptr<ProfileCompilationInfo>& info : infos) {
+    ASSERT_TRUE(expected.MergeWith(*info));
+  }
+  ASSERT_TRUE(expected.Equals(result));
+}
+
+TEST_F(ProfileAssistantTest, FailProcessingBecauseOfProfilesWithThreads) {
+  ScratchFile profile1;
+  ScratchFile profile2;
+  ScratchFile profile3;
+  ScratchFile reference_profile;
+
+  std::vector<int> profile_fds({GetFd(profile1), GetFd(profile2), GetFd(profile3)});
+  int reference_profile_fd = GetFd(reference_profile);
+
+  // The mismatching checksums are only found when merging the shards.
+  ProfileCompilationInfo info1;
+  SetupProfile(dex1, dex2, /*number_of_methods=*/ 100, 0, profile1, &info1);
+  ProfileCompilationInfo info2;
+  SetupProfile(dex3, dex4, /*number_of_methods=*/ 100, 0, profile2, &info2);
+  ProfileCompilationInfo info3;
+  SetupProfile(dex1_checksum_missmatch, dex2, /*number_of_methods=*/ 100, 0, profile3, &info3);
+
+  ASSERT_EQ(ProfmanResult::kErrorBadProfiles,
+            ProcessProfiles(profile_fds, reference_profile_fd, {"--merge-threads=3"}));
+
+  // Reference profile files must still remain empty.
+  ASSERT_EQ(0, reference_profile.GetFile()->GetLength());
+}
+
 TEST_F(ProfileAssistantTest, TestProfileCreateWithSubtype) {
   // Create the profile content.
   std::vector<std::string> profile_methods = {
@@ -198,6 +198,9 @@ NO_RETURN static void Usage(const char *fmt, ...) {
   UsageError("      the min percent of new methods to trigger a compilation.");
   UsageError("  --min-new-classes-percent-change=percentage between 0 and 100 (default 2)");
   UsageError("      the min percent of new classes to trigger a compilation.");
+  UsageError("  --merge-threads=<number>: the number of threads used to load and merge the");
+  UsageError("      input profiles, when merging profiles or generating a boot image profile.");
+  UsageError("      Default: 1.");
   UsageError("");
 
   exit(ProfmanResult::kErrorUsage);
@@ -463,6 +466,11 @@ class ProfMan final {
                         100u);
         profile_assistant_options_.SetMinNewClassesPercentChangeForCompilation(
             min_new_classes_percent_change);
+      } else if (option.starts_with("--merge-threads=")) {
+        uint32_t merge_threads;
+        ParseUintOption(raw_option, "--merge-threads=", &merge_threads, 1u);
+        profile_assistant_options_.SetNumThreads(merge_threads);
+        boot_image_options_.num_threads = merge_threads;
       } else if (option == "--copy-and-update-profile-key") {
         copy_and_update_profile_key_ = true;
       } else if (option == "--boot-image-merge") {
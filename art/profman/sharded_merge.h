@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_PROFMAN_SHARDED_MERGE_H_
+#define ART_PROFMAN_SHARDED_MERGE_H_
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace art {
+
+// Runs `fn(index)` for every index in [0, count), on `count` threads.
+template <typename Fn>
+void RunOnThreads(size_t count, const Fn& fn) {
+  std::vector<std::thread> threads;
+  threads.reserve(count);
+  for (size_t i = 1; i < count; ++i) {
+    threads.emplace_back(fn, i);
+  }
+  if (count != 0u) {
+    fn(0u);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+// Returns the number of shards `ShardedMerge()` uses for `num_items` items.
+inline size_t GetNumberOfShards(size_t num_items, size_t num_threads) {
+  return std::max<size_t>(1u, std::min(num_items, num_threads));
+}
+
+// Merges `num_items` items with up to `num_threads` threads.
+//
+// The items are split into `GetNumberOfShards()` shards of contiguous items, and
+// `process_shard(shard, begin, end)` merges the items [begin, end) into the shard, with one thread
+// per shard. Then the shards are merged with a tree reduction, where `merge_shards(left, right)`
+// merges shard `right` into shard `left`, with `left < right` and all the shards in between
+// already merged into `left`. In the end, all the items are merged into shard 0, in the same
+// order as a sequential merge, so the result is the same if the merge is associative. Each thread
+// only needs to hold the item it is merging and its shard in memory.
+//
+// Shard 0 is processed on the calling thread, and with a single shard no thread is created.
+template <typename ProcessShardFn, typename MergeShardsFn>
+void ShardedMerge(size_t num_items,
+                  size_t num_threads,
+                  const ProcessShardFn& process_shard,
+                  const MergeShardsFn& merge_shards) {
+  const size_t num_shards = GetNumberOfShards(num_items, num_threads);
+  RunOnThreads(num_shards, [&](size_t shard) {
+    process_shard(shard, shard * num_items / num_shards, (shard + 1u) * num_items / num_shards);
+  });
+  for (size_t stride = 1u; stride < num_shards; stride *= 2u) {
+    // Merge shard `2 * stride * i + stride` into shard `2 * stride * i`.
+    const size_t num_merges = (num_shards - stride + 2u * stride - 1u) / (2u * stride);
+    RunOnThreads(num_merges, [&](size_t i) {
+      merge_shards(2u * stride * i, 2u * stride * i + stride);
+    });
+  }
+}
+
+}  // namespace art
+
+#endif  // ART_PROFMAN_SHARDED_MERGE_H_
@@ -36,6 +36,7 @@
 #include "dex/signature-inl.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
 #include "gc/accounting/card_table-inl.h"
+#include "gc/heap.h"
 #include "hidden_api.h"
 #include "interpreter/interpreter.h"
 #include "intrinsics_enum.h"
@@ -320,15 +321,32 @@ uint32_t ArtMethod::FindDexMethodIndexInOtherDexFile(const DexFile& other_dexfil
 
 uint32_t ArtMethod::FindCatchBlock(Handle<mirror::Class> exception_type,
                                    uint32_t dex_pc, bool* has_no_move_exception) {
-  // Set aside the exception while we resolve its type.
   Thread* self = Thread::Current();
+  CodeItemDataAccessor accessor(DexInstructionData());
+  // Repeated throws of the same exception type from the same instruction find the
+  // handler in the thread-local cache, without resolving the handler types again.
+  const void* dex_instruction = &accessor.InstructionAt(dex_pc);
+  CatchBlockCache* cache = self->GetCatchBlockCache();
+  uint32_t cached_dex_pc;
+  bool cached_has_no_move_exception;
+  if (cache->Get(Runtime::Current()->GetHeap()->GetCurrentGcNum(),
+                 dex_instruction,
+                 exception_type.Get(),
+                 &cached_dex_pc,
+                 &cached_has_no_move_exception)) {
+    if (cached_dex_pc != dex::kDexNoIndex) {
+      *has_no_move_exception = cached_has_no_move_exception;
+    }
+    return cached_dex_pc;
+  }
+  // Set aside the exception while we resolve its type.
   StackHandleScope<1> hs(self);
   Handle<mirror::Throwable> exception(hs.NewHandle(self->GetException()));
   self->ClearException();
   // Default to handler not found.
   uint32_t found_dex_pc = dex::kDexNoIndex;
+  bool cacheable = true;
   // Iterate over the catch handlers associated with dex_pc.
-  CodeItemDataAccessor accessor(DexInstructionData());
   for (CatchHandlerIterator it(accessor, dex_pc); it.HasNext(); it.Next()) {
     dex::TypeIndex iter_type_idx = it.GetHandlerTypeIndex();
     // Catch all case
@@ -343,6 +361,7 @@ uint32_t ArtMethod::FindCatchBlock(Handle<mirror::Class> exception_type,
       // removed by a pro-guard like tool.
       // Note: this is not RI behavior. RI would have failed when loading the class.
       self->ClearException();
+      cacheable = false;
       LOG(WARNING) << "Unresolved exception class when finding catch block: "
         << DescriptorToDot(GetTypeDescriptorFromTypeIdx(iter_type_idx));
     } else if (iter_exception_type->IsAssignableFrom(exception_type.Get())) {
@@ -354,6 +373,15 @@ uint32_t ArtMethod::FindCatchBlock(Handle<mirror::Class> exception_type,
     const Instruction& first_catch_instr = accessor.InstructionAt(found_dex_pc);
     *has_no_move_exception = (first_catch_instr.Opcode() != Instruction::MOVE_EXCEPTION);
   }
+  if (cacheable) {
+    // Resolving the handler types may have suspended and run a GC, so use the current
+    // GC number. The exception class is held by the handle and has not moved.
+    cache->Set(Runtime::Current()->GetHeap()->GetCurrentGcNum(),
+               dex_instruction,
+               exception_type.Get(),
+               found_dex_pc,
+               found_dex_pc != dex::kDexNoIndex && *has_no_move_exception);
+  }
   // Put the exception back.
   if (exception != nullptr) {
     self->SetException(exception.Get());
@@ -35,6 +35,7 @@
 #include "dex/primitive.h"
 #include "interpreter/mterp/nterp.h"
 #include "gc_root.h"
+#include "imt_conflict_table.h"
 #include "intrinsics_enum.h"
 #include "obj_ptr.h"
 #include "offsets.h"
@@ -47,7 +48,6 @@ class CodeItemDebugInfoAccessor;
 class CodeItemInstructionAccessor;
 class DexFile;
 template<class T> class Handle;
-class ImtConflictTable;
 enum InvokeType : uint32_t;
 union JValue;
 template<typename T> class LengthPrefixedArray;
@@ -815,6 +815,10 @@ class EXPORT ArtMethod final {
 
   ImtConflictTable* GetImtConflictTable(PointerSize pointer_size) const {
     DCHECK(IsRuntimeMethod());
+    ImtConflictHashIndex* hash_index = GetImtConflictHashIndex(pointer_size);
+    if (hash_index != nullptr) {
+      return hash_index->GetTable();
+    }
     return reinterpret_cast<ImtConflictTable*>(GetDataPtrSize(pointer_size));
   }
 
@@ -824,6 +828,27 @@ class EXPORT ArtMethod final {
     SetDataPtrSize(table, pointer_size);
   }
 
+  // Return the hash index of the conflict table, or null if the table has none.
+  ImtConflictHashIndex* GetImtConflictHashIndex(PointerSize pointer_size) const {
+    DCHECK(IsRuntimeMethod());
+    uintptr_t data = reinterpret_cast<uintptr_t>(GetDataPtrSize(pointer_size));
+    if ((data & ImtConflictHashIndex::kTag) == 0u) {
+      return nullptr;
+    }
+    DCHECK_EQ(pointer_size, kRuntimePointerSize);
+    return reinterpret_cast<ImtConflictHashIndex*>(data - ImtConflictHashIndex::kTag);
+  }
+
+  // Set the conflict table to the table of `hash_index`, searched with the index.
+  ALWAYS_INLINE void SetImtConflictHashIndex(ImtConflictHashIndex* hash_index,
+                                             PointerSize pointer_size)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(IsRuntimeMethod());
+    DCHECK_EQ(pointer_size, kRuntimePointerSize);
+    uintptr_t data = reinterpret_cast<uintptr_t>(hash_index) | ImtConflictHashIndex::kTag;
+    SetDataPtrSize(reinterpret_cast<void*>(data), pointer_size);
+  }
+
   ALWAYS_INLINE bool HasSingleImplementation() REQUIRES_SHARED(Locks::mutator_lock_);
 
   ALWAYS_INLINE void SetHasSingleImplementation(bool single_impl)
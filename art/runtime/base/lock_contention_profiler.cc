@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lock_contention_profiler.h"
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+#include "base/metrics/metrics.h"
+#include "base/time_utils.h"
+#include "mutex.h"
+#include "runtime.h"
+
+namespace art HIDDEN {
+
+namespace {
+
+// 25% precision is enough to see where the wait times of a lock level are.
+constexpr size_t kSubBucketBits = 2u;
+constexpr size_t kNumBuckets = metrics::LogHistogramNumBuckets(kSubBucketBits);
+constexpr size_t kMaxCallSites = 8u;
+
+struct CallSite {
+  std::atomic<const void*> pc;
+  std::atomic<uint32_t> count;
+};
+
+// The samples of a lock level. The updates are relaxed and the dump may see a partial update,
+// which is fine for a profile.
+struct LockLevelProfile {
+  // The name of the first sampled mutex of this level, most levels have a single mutex.
+  std::atomic<const char*> name;
+  std::array<std::atomic<uint32_t>, kNumBuckets> wait_us_buckets;
+  std::atomic<uint64_t> total_wait_ns;
+  std::array<CallSite, kMaxCallSites> call_sites;
+  // Samples whose call site did not fit in `call_sites`.
+  std::atomic<uint32_t> other_call_sites_count;
+};
+
+// Zero-initialized, so the pages of the lock levels never sampled are not dirtied.
+LockLevelProfile gLockLevelProfiles[kLockLevelCount];
+
+void RecordCallSite(LockLevelProfile* profile, const void* call_site) {
+  for (CallSite& entry : profile->call_sites) {
+    const void* pc = entry.pc.load(std::memory_order_relaxed);
+    if (pc == nullptr &&
+        entry.pc.compare_exchange_strong(pc, call_site, std::memory_order_relaxed)) {
+      pc = call_site;
+    }
+    if (pc == call_site) {
+      entry.count.fetch_add(1u, std::memory_order_relaxed);
+      return;
+    }
+  }
+  profile->other_call_sites_count.fetch_add(1u, std::memory_order_relaxed);
+}
+
+// Print the call site as "library+offset", which can be symbolized offline, and the nearest
+// symbol when there is one.
+void DumpCallSite(std::ostream& os, const void* pc) {
+  Dl_info info;
+  if (dladdr(pc, &info) != 0 && info.dli_fname != nullptr) {
+    os << info.dli_fname << "+0x" << std::hex
+       << (reinterpret_cast<uintptr_t>(pc) - reinterpret_cast<uintptr_t>(info.dli_fbase))
+       << std::dec;
+    if (info.dli_sname != nullptr) {
+      os << " (" << info.dli_sname << ")";
+    }
+  } else {
+    os << pc;
+  }
+}
+
+}  // namespace
+
+std::atomic<uint32_t> LockContentionProfiler::sampling_interval_(0u);
+std::atomic<uint32_t> LockContentionProfiler::contention_count_(0u);
+
+void LockContentionProfiler::SetSamplingInterval(uint32_t interval) {
+  sampling_interval_.store(interval, std::memory_order_relaxed);
+}
+
+void LockContentionProfiler::RecordContention(const BaseMutex* mutex,
+                                              LockLevel level,
+                                              const void* call_site,
+                                              uint64_t wait_ns) {
+  LockLevelProfile* profile = &gLockLevelProfiles[level];
+  const char* name = nullptr;
+  profile->name.compare_exchange_strong(name, mutex->GetName(), std::memory_order_relaxed);
+  uint64_t wait_us = wait_ns / 1000u;
+  uint32_t clamped_wait_us = static_cast<uint32_t>(
+      std::min<uint64_t>(wait_us, std::numeric_limits<uint32_t>::max()));
+  profile->wait_us_buckets[metrics::LogHistogramBucketIndex(clamped_wait_us, kSubBucketBits)]
+      .fetch_add(1u, std::memory_order_relaxed);
+  profile->total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+  RecordCallSite(profile, call_site);
+  Runtime* runtime = Runtime::Current();
+  if (runtime != nullptr) {
+    runtime->GetMetrics()->LockContentionWaitTime()->Add(static_cast<int64_t>(wait_us));
+  }
+}
+
+void LockContentionProfiler::Dump(std::ostream& os) {
+  uint32_t interval = sampling_interval_.load(std::memory_order_relaxed);
+  if (interval == 0u) {
+    return;
+  }
+  os << "Lock contention profile (sampling 1/" << interval << " contentions):\n";
+  for (size_t level = 0; level != kLockLevelCount; ++level) {
+    const LockLevelProfile& profile = gLockLevelProfiles[level];
+    std::vector<uint32_t> buckets;
+    buckets.reserve(kNumBuckets);
+    uint64_t count = 0u;
+    for (const std::atomic<uint32_t>& bucket : profile.wait_us_buckets) {
+      buckets.push_back(bucket.load(std::memory_order_relaxed));
+      count += buckets.back();
+    }
+    if (count == 0u) {
+      continue;
+    }
+    const char* name = profile.name.load(std::memory_order_relaxed);
+    os << "  " << static_cast<LockLevel>(level) << " (" << (name != nullptr ? name : "?") << "): "
+       << count << " samples, total wait "
+       << PrettyDuration(profile.total_wait_ns.load(std::memory_order_relaxed))
+       << ", wait us p50=" << metrics::LogHistogramPercentile(buckets, kSubBucketBits, 0.5)
+       << " p90=" << metrics::LogHistogramPercentile(buckets, kSubBucketBits, 0.9)
+       << " p99=" << metrics::LogHistogramPercentile(buckets, kSubBucketBits, 0.99)
+       << " max=" << metrics::LogHistogramPercentile(buckets, kSubBucketBits, 1.0) << "\n";
+    for (const CallSite& entry : profile.call_sites) {
+      const void* pc = entry.pc.load(std::memory_order_relaxed);
+      if (pc != nullptr) {
+        os << "    " << entry.count.load(std::memory_order_relaxed) << " at ";
+        DumpCallSite(os, pc);
+        os << "\n";
+      }
+    }
+    uint32_t other_count = profile.other_call_sites_count.load(std::memory_order_relaxed);
+    if (other_count != 0u) {
+      os << "    " << other_count << " at other call sites\n";
+    }
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_BASE_LOCK_CONTENTION_PROFILER_H_
+#define ART_RUNTIME_BASE_LOCK_CONTENTION_PROFILER_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <iosfwd>
+
+#include "base/locks.h"
+#include "base/macros.h"
+
+namespace art HIDDEN {
+
+// Samples the contentions of all the `BaseMutex`es and aggregates them per lock level, with a
+// histogram of the wait times and the most frequent call sites of the contenders. Unlike the
+// contention log of `kLogLockContentions`, it is available in release builds: it is disabled by
+// default, and when enabled with -XX:LockContentionSamplingInterval=N it only times one out of N
+// contentions, which already wait for the owner of the lock. The profile is dumped on SIGQUIT and
+// the wait times are also added to the LockContentionWaitTime metric.
+class LockContentionProfiler {
+ public:
+  // Sample one out of `interval` contentions, or none if `interval` is 0.
+  static void SetSamplingInterval(uint32_t interval);
+
+  ALWAYS_INLINE static bool ShouldSample() {
+    uint32_t interval = sampling_interval_.load(std::memory_order_relaxed);
+    return UNLIKELY(interval != 0u) &&
+           contention_count_.fetch_add(1u, std::memory_order_relaxed) % interval == 0u;
+  }
+
+  // Record a sampled contention of `mutex` at `call_site`, which waited for `wait_ns`.
+  static void RecordContention(const BaseMutex* mutex,
+                               LockLevel level,
+                               const void* call_site,
+                               uint64_t wait_ns);
+
+  static void Dump(std::ostream& os);
+
+ private:
+  static std::atomic<uint32_t> sampling_interval_;
+  static std::atomic<uint32_t> contention_count_;
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_BASE_LOCK_CONTENTION_PROFILER_H_
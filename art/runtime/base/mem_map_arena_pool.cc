@@ -92,7 +92,7 @@ void MemMapArena::Release() {
 MemMapArenaPool::MemMapArenaPool(bool low_4gb, const char* name)
     : low_4gb_(low_4gb),
       name_(name),
-      free_arenas_(nullptr) {
+      retained_bytes_(0u) {
   MemMap::Init();
 }
 
@@ -101,25 +101,46 @@ MemMapArenaPool::~MemMapArenaPool() {
 }
 
 void MemMapArenaPool::ReclaimMemory() {
-  while (free_arenas_ != nullptr) {
-    Arena* arena = free_arenas_;
-    free_arenas_ = free_arenas_->next_;
-    delete arena;
+  for (FreeArenaShard& shard : shards_) {
+    while (shard.free_arenas != nullptr) {
+      Arena* arena = shard.free_arenas;
+      shard.free_arenas = arena->next_;
+      delete arena;
+    }
   }
 }
 
 void MemMapArenaPool::LockReclaimMemory() {
-  std::lock_guard<std::mutex> lock(lock_);
-  ReclaimMemory();
+  for (FreeArenaShard& shard : shards_) {
+    Arena* arenas;
+    {
+      std::lock_guard<std::mutex> lock(shard.lock);
+      arenas = shard.free_arenas;
+      shard.free_arenas = nullptr;
+    }
+    while (arenas != nullptr) {
+      Arena* arena = arenas;
+      arenas = arena->next_;
+      delete arena;
+    }
+  }
 }
 
 Arena* MemMapArenaPool::AllocArena(size_t size) {
   Arena* ret = nullptr;
-  {
-    std::lock_guard<std::mutex> lock(lock_);
-    if (free_arenas_ != nullptr && LIKELY(free_arenas_->Size() >= size)) {
-      ret = free_arenas_;
-      free_arenas_ = free_arenas_->next_;
+  // Look at the shard of this thread first, then steal from the others.
+  const size_t first_shard = CurrentThreadShard();
+  for (size_t i = 0; i != kNumFreeArenaShards && ret == nullptr; ++i) {
+    FreeArenaShard& shard = shards_[(first_shard + i) % kNumFreeArenaShards];
+    std::lock_guard<std::mutex> lock(shard.lock);
+    // Take the first free arena that is large enough, so that requests larger than the
+    // default arena size reuse previously freed large arenas instead of mapping new ones.
+    for (Arena** it = &shard.free_arenas; *it != nullptr; it = &(*it)->next_) {
+      if ((*it)->Size() >= size) {
+        ret = *it;
+        *it = ret->next_;
+        break;
+      }
     }
   }
   if (ret == nullptr) {
@@ -131,17 +152,28 @@ Arena* MemMapArenaPool::AllocArena(size_t size) {
 
 void MemMapArenaPool::TrimMaps() {
   ScopedTrace trace(__PRETTY_FUNCTION__);
-  std::lock_guard<std::mutex> lock(lock_);
-  for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
-    arena->Release();
+  const size_t retained_bytes = retained_bytes_.load(std::memory_order_relaxed);
+  // The budget is shared by all shards, starting with the most recently freed arenas of each.
+  size_t retained = 0u;
+  for (FreeArenaShard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.lock);
+    for (Arena* arena = shard.free_arenas; arena != nullptr; arena = arena->next_) {
+      if (retained + arena->Size() <= retained_bytes) {
+        retained += arena->Size();
+        continue;
+      }
+      arena->Release();
+    }
   }
 }
 
 size_t MemMapArenaPool::GetBytesAllocated() const {
   size_t total = 0;
-  std::lock_guard<std::mutex> lock(lock_);
-  for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
-    total += arena->GetBytesAllocated();
+  for (const FreeArenaShard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.lock);
+    for (Arena* arena = shard.free_arenas; arena != nullptr; arena = arena->next_) {
+      total += arena->GetBytesAllocated();
+    }
   }
   return total;
 }
@@ -168,9 +200,10 @@ void MemMapArenaPool::FreeArenaChain(Arena* first) {
     while (last->next_ != nullptr) {
       last = last->next_;
     }
-    std::lock_guard<std::mutex> lock(lock_);
-    last->next_ = free_arenas_;
-    free_arenas_ = first;
+    FreeArenaShard& shard = shards_[CurrentThreadShard()];
+    std::lock_guard<std::mutex> lock(shard.lock);
+    last->next_ = shard.free_arenas;
+    shard.free_arenas = first;
   }
 }
 
@@ -17,6 +17,9 @@
 #ifndef ART_RUNTIME_BASE_MEM_MAP_ARENA_POOL_H_
 #define ART_RUNTIME_BASE_MEM_MAP_ARENA_POOL_H_
 
+#include <atomic>
+#include <mutex>
+
 #include "base/arena_allocator.h"
 
 namespace art HIDDEN {
@@ -31,15 +34,22 @@ class MemMapArenaPool final : public ArenaPool {
   void ReclaimMemory() override;
   void LockReclaimMemory() override;
   // Trim the maps in arenas by madvising, used by JIT to reduce memory usage.
+  // The most recently freed arenas, up to the retained bytes, are kept resident.
   void TrimMaps() override;
 
+  // Set how many bytes of free arenas `TrimMaps` keeps resident, so that the next
+  // allocations reuse them without faulting pages in again.
+  void SetRetainedBytes(size_t retained_bytes) {
+    retained_bytes_.store(retained_bytes, std::memory_order_relaxed);
+  }
+
  private:
   const bool low_4gb_;
   const char* name_;
-  Arena* free_arenas_;
-  // Use a std::mutex here as Arenas are second-from-the-bottom when using MemMaps, and MemMap
-  // itself uses std::mutex scoped to within an allocate/free only.
-  mutable std::mutex lock_;
+  std::atomic<size_t> retained_bytes_;
+  // The shard locks are std::mutex as Arenas are second-from-the-bottom when using MemMaps, and
+  // MemMap itself uses std::mutex scoped to within an allocate/free only.
+  FreeArenaShard shards_[kNumFreeArenaShards];
 
   DISALLOW_COPY_AND_ASSIGN(MemMapArenaPool);
 };
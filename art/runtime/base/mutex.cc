@@ -28,6 +28,7 @@
 #include "base/systrace.h"
 #include "base/time_utils.h"
 #include "base/value_object.h"
+#include "lock_contention_profiler.h"
 #include "monitor.h"
 #include "mutex-inl.h"
 #include "scoped_thread_state_change-inl.h"
@@ -123,16 +124,18 @@ static void BackOff(uint32_t i) {
 // short time interval, on the order of kernel context-switch time, passes.
 // Return true if the predicate test succeeded, false if we timed out.
 template<typename Pred>
-static inline bool WaitBrieflyFor(AtomicInteger* testLoc, Thread* self, Pred pred) {
+static inline bool WaitBrieflyFor(AtomicInteger* testLoc,
+                                  Thread* self,
+                                  Pred pred,
+                                  uint32_t max_iters = Mutex::kDefaultMaxWaitIterations) {
   // TODO: Tune these parameters correctly. BackOff(3) should take on the order of 100 cycles. So
   // this should result in retrying <= 10 times, usually waiting around 100 cycles each. The
   // maximum delay should be significantly less than the expected futex() context switch time, so
   // there should be little danger of this worsening things appreciably. If the lock was only
   // held briefly by a running thread, this should help immensely.
   static constexpr uint32_t kMaxBackOff = 3;  // Should probably be <= kSpinMax above.
-  static constexpr uint32_t kMaxIters = 50;
   JNIEnvExt* const env = self == nullptr ? nullptr : self->GetJniEnv();
-  for (uint32_t i = 1; i <= kMaxIters; ++i) {
+  for (uint32_t i = 1; i <= max_iters; ++i) {
     BackOff(std::min(i, kMaxBackOff));
     if (pred(testLoc->load(std::memory_order_relaxed))) {
       return true;
@@ -169,11 +172,16 @@ class ScopedAllMutexesLock final {
 // Scoped class that generates events at the beginning and end of lock contention.
 class ScopedContentionRecorder final : public ValueObject {
  public:
-  ScopedContentionRecorder(BaseMutex* mutex, uint64_t blocked_tid, uint64_t owner_tid)
-      : mutex_(kLogLockContentions ? mutex : nullptr),
+  ScopedContentionRecorder(BaseMutex* mutex,
+                           uint64_t blocked_tid,
+                           uint64_t owner_tid,
+                           const void* call_site)
+      : sampled_(LockContentionProfiler::ShouldSample()),
+        mutex_(kLogLockContentions || sampled_ ? mutex : nullptr),
         blocked_tid_(kLogLockContentions ? blocked_tid : 0),
         owner_tid_(kLogLockContentions ? owner_tid : 0),
-        start_nano_time_(kLogLockContentions ? NanoTime() : 0) {
+        call_site_(call_site),
+        start_nano_time_(kLogLockContentions || sampled_ ? NanoTime() : 0) {
     if (ATraceEnabled()) {
       std::string msg = StringPrintf("Lock contention on %s (owner tid: %" PRIu64 ")",
                                      mutex->GetName(), owner_tid);
@@ -183,16 +191,24 @@ class ScopedContentionRecorder final : public ValueObject {
 
   ~ScopedContentionRecorder() {
     ATraceEnd();
-    if (kLogLockContentions) {
-      uint64_t end_nano_time = NanoTime();
-      mutex_->RecordContention(blocked_tid_, owner_tid_, end_nano_time - start_nano_time_);
+    if (kLogLockContentions || sampled_) {
+      uint64_t wait_time = NanoTime() - start_nano_time_;
+      if (kLogLockContentions) {
+        mutex_->RecordContention(blocked_tid_, owner_tid_, wait_time);
+      }
+      if (sampled_) {
+        LockContentionProfiler::RecordContention(mutex_, mutex_->level_, call_site_, wait_time);
+      }
     }
   }
 
  private:
+  const bool sampled_;
   BaseMutex* const mutex_;
   const uint64_t blocked_tid_;
   const uint64_t owner_tid_;
+  // The caller of the lock function, for the contention profile.
+  const void* const call_site_;
   const uint64_t start_nano_time_;
 };
 
@@ -464,7 +480,8 @@ void Mutex::ExclusiveLock(Thread* self) {
       } else {
         // Failed to acquire, hang up.
         // We don't hold the mutex: GetExclusiveOwnerTid() is usually, but not always, correct.
-        ScopedContentionRecorder scr(this, SafeGetTid(self), GetExclusiveOwnerTid());
+        ScopedContentionRecorder scr(
+            this, SafeGetTid(self), GetExclusiveOwnerTid(), __builtin_return_address(0));
         // Empirically, it appears important to spin again each time through the loop; if we
         // bother to go to sleep and wake up, we should be fairly persistent in trying for the
         // lock.
@@ -634,7 +651,7 @@ bool Mutex::ExclusiveTryLock(Thread* self) {
 template bool Mutex::ExclusiveTryLock<false>(Thread* self);
 template bool Mutex::ExclusiveTryLock<true>(Thread* self);
 
-bool Mutex::ExclusiveTryLockWithSpinning(Thread* self) {
+bool Mutex::ExclusiveTryLockWithSpinning(Thread* self, uint32_t max_wait_iterations) {
   // Spin a small number of times, since this affects our ability to respond to suspension
   // requests. We spin repeatedly only if the mutex repeatedly becomes available and unavailable
   // in rapid succession, and then we will typically not spin for the maximal period.
@@ -644,10 +661,14 @@ bool Mutex::ExclusiveTryLockWithSpinning(Thread* self) {
       return true;
     }
 #if ART_USE_FUTEXES
-    if (!WaitBrieflyFor(&state_and_contenders_, self,
-            [](int32_t v) { return (v & kHeldMask) == 0; })) {
+    if (!WaitBrieflyFor(&state_and_contenders_,
+                        self,
+                        [](int32_t v) { return (v & kHeldMask) == 0; },
+                        max_wait_iterations)) {
       return false;
     }
+#else
+    UNUSED(max_wait_iterations);
 #endif
   }
   return ExclusiveTryLock(self);
@@ -806,7 +827,8 @@ void ReaderWriterMutex::ExclusiveLock(Thread* self) {
       done = state_.CompareAndSetWeakAcquire(0 /* cur_state*/, -1 /* new state */);
     } else {
       // Failed to acquire, hang up.
-      ScopedContentionRecorder scr(this, SafeGetTid(self), GetExclusiveOwnerTid());
+      ScopedContentionRecorder scr(
+          this, SafeGetTid(self), GetExclusiveOwnerTid(), __builtin_return_address(0));
       if (!WaitBrieflyFor(&state_, self, [](int32_t v) { return v == 0; })) {
         num_contenders_.fetch_add(1);
         if (UNLIKELY(should_respond_to_empty_checkpoint_request_)) {
@@ -885,7 +907,8 @@ bool ReaderWriterMutex::ExclusiveLockWithTimeout(Thread* self, int64_t ms, int32
       if (!ComputeRelativeTimeSpec(&rel_ts, end_abs_ts, now_abs_ts)) {
         return false;  // Timed out.
       }
-      ScopedContentionRecorder scr(this, SafeGetTid(self), GetExclusiveOwnerTid());
+      ScopedContentionRecorder scr(
+          this, SafeGetTid(self), GetExclusiveOwnerTid(), __builtin_return_address(0));
       if (!WaitBrieflyFor(&state_, self, [](int32_t v) { return v == 0; })) {
         num_contenders_.fetch_add(1);
         if (UNLIKELY(should_respond_to_empty_checkpoint_request_)) {
@@ -930,7 +953,8 @@ bool ReaderWriterMutex::ExclusiveLockWithTimeout(Thread* self, int64_t ms, int32
 #if ART_USE_FUTEXES
 void ReaderWriterMutex::HandleSharedLockContention(Thread* self, int32_t cur_state) {
   // Owner holds it exclusively, hang up.
-  ScopedContentionRecorder scr(this, SafeGetTid(self), GetExclusiveOwnerTid());
+  ScopedContentionRecorder scr(
+      this, SafeGetTid(self), GetExclusiveOwnerTid(), __builtin_return_address(0));
   if (!WaitBrieflyFor(&state_, self, [](int32_t v) { return v >= 0; })) {
     num_contenders_.fetch_add(1);
     if (UNLIKELY(should_respond_to_empty_checkpoint_request_)) {
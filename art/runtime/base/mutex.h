@@ -190,8 +190,12 @@ class EXPORT LOCKABLE Mutex : public BaseMutex {
   template <bool kCheck = kDebugLocking>
   bool ExclusiveTryLock(Thread* self) TRY_ACQUIRE(true);
   bool TryLock(Thread* self) TRY_ACQUIRE(true) { return ExclusiveTryLock(self); }
-  // Equivalent to ExclusiveTryLock, but retry for a short period before giving up.
-  bool ExclusiveTryLockWithSpinning(Thread* self) TRY_ACQUIRE(true);
+  // Equivalent to ExclusiveTryLock, but retry for a short period before giving up. Each wait for
+  // the mutex to be released spins at most `max_wait_iterations` times.
+  static constexpr uint32_t kDefaultMaxWaitIterations = 50;
+  bool ExclusiveTryLockWithSpinning(Thread* self,
+                                    uint32_t max_wait_iterations = kDefaultMaxWaitIterations)
+      TRY_ACQUIRE(true);
 
   // Release exclusive access.
   void ExclusiveUnlock(Thread* self) RELEASE();
@@ -16,6 +16,9 @@
 
 #include "mutex-inl.h"
 
+#include <sstream>
+
+#include "base/lock_contention_profiler.h"
 #include "common_runtime_test.h"
 #include "thread-current-inl.h"
 
@@ -179,4 +182,24 @@ TEST_F(MutexTest, SharedTryLockUnlock) {
   SharedTryLockUnlockTest();
 }
 
+TEST_F(MutexTest, LockContentionProfile) {
+  Mutex mu("profiled test mutex", kGenericBottomLock);
+  std::ostringstream disabled_oss;
+  LockContentionProfiler::Dump(disabled_oss);
+  EXPECT_EQ("", disabled_oss.str());
+
+  LockContentionProfiler::SetSamplingInterval(1u);
+  EXPECT_TRUE(LockContentionProfiler::ShouldSample());
+  LockContentionProfiler::RecordContention(&mu, kGenericBottomLock, nullptr, 2'000'000u);
+  std::ostringstream oss;
+  LockContentionProfiler::Dump(oss);
+  LockContentionProfiler::SetSamplingInterval(0u);
+  EXPECT_FALSE(LockContentionProfiler::ShouldSample());
+
+  std::ostringstream level_oss;
+  level_oss << kGenericBottomLock;
+  EXPECT_NE(std::string::npos, oss.str().find("Lock contention profile")) << oss.str();
+  EXPECT_NE(std::string::npos, oss.str().find(level_oss.str())) << oss.str();
+}
+
 }  // namespace art
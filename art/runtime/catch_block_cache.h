@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_CATCH_BLOCK_CACHE_H_
+#define ART_RUNTIME_CATCH_BLOCK_CACHE_H_
+
+#include <array>
+#include <cstdint>
+
+#include "base/bit_utils.h"
+#include "base/casts.h"
+#include "base/macros.h"
+#include "dex/dex_file_types.h"
+
+namespace art HIDDEN {
+
+// Small thread-local cache of the results of `ArtMethod::FindCatchBlock()`, so that
+// code throwing the same exception type from the same instruction again and again
+// does not walk the catch handlers and resolve their types for every throw.
+//
+// The key is the address of the throwing dex instruction, as for the interpreter
+// cache, and the exception class. Code items are only shared by methods of the same
+// dex file, which resolve handler types the same way. The entries hold class and
+// dex instruction addresses, so they are only valid for one GC cycle: the cache is
+// cleared when the GC sweeps the interpreter caches, when dex files are unloaded,
+// and when the number of completed GCs changes. All operations must be done from
+// the owning thread, or at a point when the owning thread is suspended.
+class CatchBlockCache {
+ public:
+  static constexpr size_t kSize = 32;
+
+  CatchBlockCache() {
+    Clear();
+  }
+
+  void Clear() {
+    data_.fill(Entry{});
+  }
+
+  // Look up the handler for `exception_class` thrown at `dex_instruction`, for caches
+  // filled during the GC cycle `gc_num`. The found handler is `dex::kDexNoIndex` if
+  // the exception is not caught in this method.
+  ALWAYS_INLINE bool Get(uint32_t gc_num,
+                         const void* dex_instruction,
+                         const void* exception_class,
+                         /*out*/ uint32_t* handler_dex_pc,
+                         /*out*/ bool* has_no_move_exception) {
+    if (UNLIKELY(gc_num != gc_num_)) {
+      Clear();
+      gc_num_ = gc_num;
+      return false;
+    }
+    const Entry& entry = data_[IndexOf(dex_instruction, exception_class)];
+    if (entry.dex_instruction != dex_instruction ||
+        entry.exception_class != CompressClass(exception_class)) {
+      return false;
+    }
+    *handler_dex_pc = entry.handler_dex_pc;
+    *has_no_move_exception = entry.has_no_move_exception;
+    return true;
+  }
+
+  ALWAYS_INLINE void Set(uint32_t gc_num,
+                         const void* dex_instruction,
+                         const void* exception_class,
+                         uint32_t handler_dex_pc,
+                         bool has_no_move_exception) {
+    if (UNLIKELY(gc_num != gc_num_)) {
+      Clear();
+      gc_num_ = gc_num;
+    }
+    Entry& entry = data_[IndexOf(dex_instruction, exception_class)];
+    entry.dex_instruction = dex_instruction;
+    entry.exception_class = CompressClass(exception_class);
+    entry.handler_dex_pc = handler_dex_pc;
+    entry.has_no_move_exception = has_no_move_exception;
+  }
+
+ private:
+  // A cleared entry never matches a non-null instruction.
+  struct Entry {
+    const void* dex_instruction = nullptr;
+    uint32_t exception_class = 0u;
+    uint32_t handler_dex_pc = dex::kDexNoIndex;
+    bool has_no_move_exception = false;
+  };
+
+  // Heap references are 32-bit.
+  static ALWAYS_INLINE uint32_t CompressClass(const void* klass) {
+    return dchecked_integral_cast<uint32_t>(reinterpret_cast<uintptr_t>(klass));
+  }
+
+  static ALWAYS_INLINE size_t IndexOf(const void* dex_instruction, const void* exception_class) {
+    static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
+    // Dex instructions are 2-byte aligned and classes 8-byte aligned.
+    uint32_t hash = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(dex_instruction) >> 1) ^
+                    (CompressClass(exception_class) >> 3);
+    return (hash ^ (hash >> 7) ^ (hash >> 13)) & (kSize - 1);
+  }
+
+  std::array<Entry, kSize> data_;
+  uint32_t gc_num_ = 0u;
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_CATCH_BLOCK_CACHE_H_
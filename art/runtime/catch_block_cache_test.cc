@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "catch_block_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace art HIDDEN {
+
+static const void* FakeInstruction(uintptr_t index) {
+  // Dex instructions are 2-byte aligned, and the cache only uses the address.
+  return reinterpret_cast<const void*>(0x20000u + index * 2u);
+}
+
+static const void* FakeClass(uintptr_t index) {
+  // Classes are 8-byte aligned, and the cache only uses the address.
+  return reinterpret_cast<const void*>(0x10000u + index * 8u);
+}
+
+TEST(CatchBlockCacheTest, GetAndSet) {
+  CatchBlockCache cache;
+  uint32_t handler_dex_pc = 0u;
+  bool has_no_move_exception = false;
+  EXPECT_FALSE(cache.Get(/*gc_num=*/ 0u,
+                         FakeInstruction(1),
+                         FakeClass(1),
+                         &handler_dex_pc,
+                         &has_no_move_exception));
+
+  cache.Set(/*gc_num=*/ 0u,
+            FakeInstruction(1),
+            FakeClass(1),
+            /*handler_dex_pc=*/ 12u,
+            /*has_no_move_exception=*/ true);
+  cache.Set(/*gc_num=*/ 0u,
+            FakeInstruction(2),
+            FakeClass(1),
+            dex::kDexNoIndex,
+            /*has_no_move_exception=*/ false);
+  ASSERT_TRUE(cache.Get(/*gc_num=*/ 0u,
+                        FakeInstruction(1),
+                        FakeClass(1),
+                        &handler_dex_pc,
+                        &has_no_move_exception));
+  EXPECT_EQ(12u, handler_dex_pc);
+  EXPECT_TRUE(has_no_move_exception);
+  // Misses in the method are cached too.
+  ASSERT_TRUE(cache.Get(/*gc_num=*/ 0u,
+                        FakeInstruction(2),
+                        FakeClass(1),
+                        &handler_dex_pc,
+                        &has_no_move_exception));
+  EXPECT_EQ(dex::kDexNoIndex, handler_dex_pc);
+
+  // The key is the (instruction, exception class) pair.
+  EXPECT_FALSE(cache.Get(/*gc_num=*/ 0u,
+                         FakeInstruction(1),
+                         FakeClass(2),
+                         &handler_dex_pc,
+                         &has_no_move_exception));
+  EXPECT_FALSE(cache.Get(/*gc_num=*/ 0u,
+                         FakeInstruction(3),
+                         FakeClass(1),
+                         &handler_dex_pc,
+                         &has_no_move_exception));
+}
+
+TEST(CatchBlockCacheTest, Invalidation) {
+  CatchBlockCache cache;
+  uint32_t handler_dex_pc = 0u;
+  bool has_no_move_exception = false;
+  cache.Set(/*gc_num=*/ 0u,
+            FakeInstruction(1),
+            FakeClass(1),
+            /*handler_dex_pc=*/ 12u,
+            /*has_no_move_exception=*/ false);
+  cache.Clear();
+  EXPECT_FALSE(cache.Get(/*gc_num=*/ 0u,
+                         FakeInstruction(1),
+                         FakeClass(1),
+                         &handler_dex_pc,
+                         &has_no_move_exception));
+
+  // Entries from a previous GC cycle are dropped.
+  cache.Set(/*gc_num=*/ 0u,
+            FakeInstruction(1),
+            FakeClass(1),
+            /*handler_dex_pc=*/ 12u,
+            /*has_no_move_exception=*/ false);
+  EXPECT_FALSE(cache.Get(/*gc_num=*/ 1u,
+                         FakeInstruction(1),
+                         FakeClass(1),
+                         &handler_dex_pc,
+                         &has_no_move_exception));
+  EXPECT_FALSE(cache.Get(/*gc_num=*/ 0u,
+                         FakeInstruction(1),
+                         FakeClass(1),
+                         &handler_dex_pc,
+                         &has_no_move_exception));
+}
+
+}  // namespace art
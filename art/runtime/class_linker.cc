@@ -430,6 +430,37 @@ const void* ClassLinker::FindBootJniStub(JniStubKey key) {
   }
 }
 
+uint32_t ClassLinker::GetListedFastNativeAccessFlags(const DexFile& dex_file,
+                                                     uint32_t method_idx,
+                                                     uint32_t access_flags) const {
+  DCHECK_NE(access_flags & kAccNative, 0u);
+  if ((access_flags & (kAccFastNative | kAccCriticalNative | kAccSynchronized)) != 0u) {
+    // The annotations take precedence, and synchronized methods cannot be @FastNative.
+    return 0u;
+  }
+  return IsListedFastNativeMethod(dex_file, method_idx) ? kAccFastNative : 0u;
+}
+
+std::string ClassLinker::GetFastNativeMethodName(const DexFile& dex_file, uint32_t method_idx) {
+  const dex::MethodId& method_id = dex_file.GetMethodId(method_idx);
+  std::string name(dex_file.GetMethodDeclaringClassDescriptorView(method_id));
+  name += "->";
+  name += dex_file.GetMethodNameView(method_id);
+  name += dex_file.GetMethodSignature(method_id).ToString();
+  return name;
+}
+
+bool ClassLinker::IsListedFastNativeMethod(const DexFile& dex_file, uint32_t method_idx) const {
+  const OatDexFile* oat_dex_file = dex_file.GetOatDexFile();
+  if (oat_dex_file == nullptr ||
+      oat_dex_file->GetOatFile() == nullptr ||
+      !oat_dex_file->GetOatFile()->HasFastNativeMethods()) {
+    return false;
+  }
+  return oat_dex_file->GetOatFile()->IsFastNativeMethod(
+      GetFastNativeMethodName(dex_file, method_idx));
+}
+
 ClassLinker::VisiblyInitializedCallback* ClassLinker::MarkClassInitialized(
     Thread* self, Handle<mirror::Class> klass) {
   if (kRuntimeISA == InstructionSet::kX86 || kRuntimeISA == InstructionSet::kX86_64) {
@@ -640,8 +671,10 @@ ClassLinker::ClassLinker(InternTable* intern_table, bool fast_class_not_found_ex
       critical_native_code_with_clinit_check_(),
       boot_image_jni_stubs_(JniStubKeyHash(Runtime::Current()->GetInstructionSet()),
                             JniStubKeyEquals(Runtime::Current()->GetInstructionSet())),
-      cha_(Runtime::Current()->IsAotCompiler() ? nullptr : new ClassHierarchyAnalysis()) {
-  // For CHA disabled during Aot, see b/34193647.
+      cha_(Runtime::Current()->IsCompilingBootImage() ? nullptr : new ClassHierarchyAnalysis()) {
+  // For CHA disabled when compiling the boot image, see b/34193647. When compiling apps, the
+  // compiler uses CHA for devirtualized calls guarded by a type check, and the image writer
+  // clears the single-implementation info of the methods it writes.
 
   CHECK(intern_table_ != nullptr);
   static_assert(kFindArrayCacheSize == arraysize(find_array_class_cache_),
@@ -4187,6 +4220,7 @@ void ClassLinker::LoadMethod(const DexFile& dex_file,
       access_flags |=
           annotations::GetNativeMethodAnnotationAccessFlags(dex_file, *method_annotations);
     }
+    access_flags |= GetListedFastNativeAccessFlags(dex_file, dex_method_idx, access_flags);
     dst->SetAccessFlags(access_flags);
     DCHECK(!dst->IsAbstract());
     DCHECK(!dst->HasCodeItem());
@@ -4220,9 +4254,13 @@ void ClassLinker::LoadMethod(const DexFile& dex_file,
     }
   }
 
+  // With sampling hotness, methods use the memory shared method counting in all processes, so
+  // that invocations do not write the `ArtMethod`.
   if ((access_flags & kAccAbstract) == 0u &&
-      Runtime::Current()->IsZygote() &&
-      !Runtime::Current()->GetJITOptions()->GetProfileSaverOptions().GetProfileBootClassPath()) {
+      ((Runtime::Current()->IsZygote() &&
+        !Runtime::Current()->GetJITOptions()->GetProfileSaverOptions().GetProfileBootClassPath()) ||
+       (!Runtime::Current()->IsAotCompiler() &&
+        Runtime::Current()->GetJITOptions()->UseSamplingHotness()))) {
     DCHECK(!ArtMethod::IsAbstract(access_flags));
     DCHECK(!ArtMethod::IsIntrinsic(access_flags));
     dst->SetMemorySharedMethod();
@@ -4489,6 +4527,10 @@ ObjPtr<mirror::DexCache> ClassLinker::RegisterDexFile(const DexFile& dex_file,
   }
   VLOG(class_linker) << "Registered dex file " << dex_file.GetLocation();
   PaletteNotifyDexFileLoaded(dex_file.GetLocation().c_str());
+  if (h_class_loader != nullptr) {
+    Runtime::Current()->GetOatFileManager().PreResolveBssEntriesInBackground(dex_file,
+                                                                             h_class_loader.Get());
+  }
   return h_dex_cache.Get();
 }
 
@@ -6673,6 +6715,13 @@ static ObjPtr<mirror::Class> GetImtOwner(ObjPtr<mirror::Class> klass)
   return nullptr;
 }
 
+// Whether to search a conflict table with `num_entries` entries with a hash index. Images
+// only contain plain tables, so the AOT compiler never creates hash indexes.
+static bool UseImtConflictHashIndex(size_t num_entries) {
+  return num_entries >= ImtConflictHashIndex::kMinEntries &&
+         !Runtime::Current()->IsAotCompiler();
+}
+
 ArtMethod* ClassLinker::AddMethodToConflictTable(ObjPtr<mirror::Class> klass,
                                                  ArtMethod* conflict_method,
                                                  ArtMethod* interface_method,
@@ -6700,10 +6749,18 @@ ArtMethod* ClassLinker::AddMethodToConflictTable(ObjPtr<mirror::Class> klass,
 
   // Allocate a new table. Note that we will leak this table at the next conflict,
   // but that's a tradeoff compared to making the table fixed size.
-  void* data = linear_alloc->Alloc(
-      Thread::Current(),
-      ImtConflictTable::ComputeSizeWithOneMoreEntry(current_table, image_pointer_size_),
-      LinearAllocKind::kNoGCRoots);
+  const size_t num_entries = current_table->NumEntries(image_pointer_size_) + 1u;
+  ImtConflictHashIndex* hash_index = nullptr;
+  void* data;
+  if (UseImtConflictHashIndex(num_entries)) {
+    hash_index = CreateImtConflictHashIndex(num_entries, linear_alloc);
+    data = (hash_index != nullptr) ? hash_index->GetTable() : nullptr;
+  } else {
+    data = linear_alloc->Alloc(
+        Thread::Current(),
+        ImtConflictTable::ComputeSizeWithOneMoreEntry(current_table, image_pointer_size_),
+        LinearAllocKind::kNoGCRoots);
+  }
   if (data == nullptr) {
     LOG(ERROR) << "Failed to allocate conflict table";
     return conflict_method;
@@ -6712,6 +6769,9 @@ ArtMethod* ClassLinker::AddMethodToConflictTable(ObjPtr<mirror::Class> klass,
                                                             interface_method,
                                                             method,
                                                             image_pointer_size_);
+  if (hash_index != nullptr) {
+    hash_index->Fill();
+  }
 
   // Do a fence to ensure threads see the data in the table before it is assigned
   // to the conflict method.
@@ -6719,7 +6779,11 @@ ArtMethod* ClassLinker::AddMethodToConflictTable(ObjPtr<mirror::Class> klass,
   // memory from the LinearAlloc, but that's a tradeoff compared to using
   // atomic operations.
   std::atomic_thread_fence(std::memory_order_release);
-  new_conflict_method->SetImtConflictTable(new_table, image_pointer_size_);
+  if (hash_index != nullptr) {
+    new_conflict_method->SetImtConflictHashIndex(hash_index, image_pointer_size_);
+  } else {
+    new_conflict_method->SetImtConflictTable(new_table, image_pointer_size_);
+  }
   return new_conflict_method;
 }
 
@@ -6826,6 +6890,25 @@ ImtConflictTable* ClassLinker::CreateImtConflictTable(size_t count, LinearAlloc*
   return CreateImtConflictTable(count, linear_alloc, image_pointer_size_);
 }
 
+ImtConflictHashIndex* ClassLinker::CreateImtConflictHashIndex(size_t count,
+                                                             LinearAlloc* linear_alloc) {
+  DCHECK(!Runtime::Current()->IsAotCompiler());
+  DCHECK_EQ(image_pointer_size_, kRuntimePointerSize);
+  const size_t hash_index_size = ImtConflictHashIndex::ComputeSize(count);
+  void* data = linear_alloc->Alloc(
+      Thread::Current(),
+      hash_index_size + ImtConflictTable::ComputeSize(count, kRuntimePointerSize),
+      LinearAllocKind::kNoGCRoots);
+  if (data == nullptr) {
+    return nullptr;
+  }
+  ImtConflictHashIndex* hash_index = new (data) ImtConflictHashIndex(count);
+  DCHECK_EQ(reinterpret_cast<uint8_t*>(hash_index->GetTable()),
+            reinterpret_cast<uint8_t*>(data) + hash_index_size);
+  new (hash_index->GetTable()) ImtConflictTable(count, kRuntimePointerSize);
+  return hash_index;
+}
+
 void ClassLinker::FillIMTFromIfTable(ObjPtr<mirror::IfTable> if_table,
                                      ArtMethod* unimplemented_method,
                                      ArtMethod* imt_conflict_method,
@@ -6887,11 +6970,22 @@ void ClassLinker::FillIMTFromIfTable(ObjPtr<mirror::IfTable> if_table,
     for (size_t i = 0; i < ImTable::kSize; ++i) {
       size_t conflicts = conflict_counts[i];
       if (imt[i] == imt_conflict_method) {
-        ImtConflictTable* new_table = CreateImtConflictTable(conflicts, linear_alloc);
+        ImtConflictHashIndex* hash_index = nullptr;
+        ImtConflictTable* new_table;
+        if (UseImtConflictHashIndex(conflicts)) {
+          hash_index = CreateImtConflictHashIndex(conflicts, linear_alloc);
+          new_table = (hash_index != nullptr) ? hash_index->GetTable() : nullptr;
+        } else {
+          new_table = CreateImtConflictTable(conflicts, linear_alloc);
+        }
         if (new_table != nullptr) {
           ArtMethod* new_conflict_method =
               Runtime::Current()->CreateImtConflictMethod(linear_alloc);
-          new_conflict_method->SetImtConflictTable(new_table, image_pointer_size_);
+          if (hash_index != nullptr) {
+            new_conflict_method->SetImtConflictHashIndex(hash_index, image_pointer_size_);
+          } else {
+            new_conflict_method->SetImtConflictTable(new_table, image_pointer_size_);
+          }
           imt[i] = new_conflict_method;
         } else {
           LOG(ERROR) << "Failed to allocate conflict table";
@@ -6930,6 +7024,18 @@ void ClassLinker::FillIMTFromIfTable(ObjPtr<mirror::IfTable> if_table,
         table->SetImplementationMethod(num_entries, image_pointer_size_, implementation_method);
       }
     }
+
+    // Index the complete tables.
+    for (size_t i = 0; i < ImTable::kSize; ++i) {
+      if (imt[i]->IsRuntimeMethod() &&
+          imt[i] != unimplemented_method &&
+          imt[i] != imt_conflict_method) {
+        ImtConflictHashIndex* hash_index = imt[i]->GetImtConflictHashIndex(image_pointer_size_);
+        if (hash_index != nullptr) {
+          hash_index->Fill();
+        }
+      }
+    }
   }
 }
 
@@ -10678,6 +10784,17 @@ void ClassLinker::DumpForSigQuit(std::ostream& os) {
   ReaderMutexLock mu(soa.Self(), *Locks::classlinker_classes_lock_);
   os << "Zygote loaded classes=" << NumZygoteClasses() << " post zygote classes="
      << NumNonZygoteClasses() << "\n";
+  // The footprint of the class metadata, mainly the ArtMethod and ArtField arrays.
+  std::array<size_t, kNumLinearAllocKinds> linear_alloc_bytes = {};
+  Runtime::Current()->GetLinearAlloc()->AddAllocatedBytes(&linear_alloc_bytes);
+  for (const ClassLoaderData& data : class_loaders_) {
+    data.allocator->AddAllocatedBytes(&linear_alloc_bytes);
+  }
+  os << "LinearAlloc bytes:";
+  for (size_t i = 0; i != kNumLinearAllocKinds; ++i) {
+    os << " " << static_cast<LinearAllocKind>(i) << "=" << linear_alloc_bytes[i];
+  }
+  os << "\n";
   ReaderMutexLock mu2(soa.Self(), *Locks::dex_lock_);
   os << "Dumping registered class loaders\n";
   size_t class_loader_index = 0;
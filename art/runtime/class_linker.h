@@ -55,6 +55,7 @@ enum class ClassRoot : uint32_t;
 class ClassTable;
 class DexFile;
 template<class T> class Handle;
+class ImtConflictHashIndex;
 class ImtConflictTable;
 template<typename T> class LengthPrefixedArray;
 template<class T> class MutableHandle;
@@ -753,6 +754,9 @@ class ClassLinker {
                                                   LinearAlloc* linear_alloc,
                                                   PointerSize pointer_size);
 
+  // Create a conflict table with a specified capacity together with its hash index, which
+  // must be filled once the table is complete. Only for the runtime, not the AOT compiler.
+  ImtConflictHashIndex* CreateImtConflictHashIndex(size_t count, LinearAlloc* linear_alloc);
 
   // Create the IMT and conflict tables for a class.
   EXPORT void FillIMTAndConflictTables(ObjPtr<mirror::Class> klass)
@@ -974,7 +978,22 @@ class ClassLinker {
 
   const void* FindBootJniStub(JniStubKey key);
 
+  // Returns kAccFastNative if the native method `method_idx` is compiled as @FastNative without
+  // the annotation, see `IsListedFastNativeMethod()`, and 0 otherwise. The `access_flags` must
+  // include the flags from the annotations.
+  EXPORT uint32_t GetListedFastNativeAccessFlags(const DexFile& dex_file,
+                                                 uint32_t method_idx,
+                                                 uint32_t access_flags) const;
+
+  // Returns the name of a method in the lists of fast native methods, like "LFoo;->bar(I)V".
+  static std::string GetFastNativeMethodName(const DexFile& dex_file, uint32_t method_idx);
+
  protected:
+  // Returns whether the native method `method_idx` is in the list of fast native methods of the
+  // oat file of `dex_file`, which is the list dex2oat compiled its JNI stubs with, so that the
+  // stubs and the flags of the methods always agree.
+  virtual bool IsListedFastNativeMethod(const DexFile& dex_file, uint32_t method_idx) const;
+
   EXPORT virtual bool InitializeClass(Thread* self,
                                       Handle<mirror::Class> klass,
                                       bool can_run_clinit,
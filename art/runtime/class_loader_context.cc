@@ -40,6 +40,7 @@
 #include "mirror/object.h"
 #include "mirror/object_array-alloc-inl.h"
 #include "nativehelper/scoped_local_ref.h"
+#include "oat/dex_checksum_cache.h"
 #include "oat/oat_file_assistant.h"
 #include "obj_ptr-inl.h"
 #include "runtime.h"
@@ -477,10 +478,10 @@ bool ClassLoaderContext::OpenDexFiles(const std::string& classpath_dir,
       std::string error_msg;
       std::optional<uint32_t> dex_checksum;
       if (only_read_checksums) {
-        bool zip_file_only_contains_uncompress_dex;
-        ArtDexFileLoader dex_file_loader(&file, location);
-        if (!dex_file_loader.GetMultiDexChecksum(
-                &dex_checksum, &error_msg, &zip_file_only_contains_uncompress_dex)) {
+        // The same context elements are checked for every class loader and dexopt query, so use
+        // the checksums cached for unchanged files.
+        if (!DexChecksumCache::GetInstance().GetMultiDexChecksum(
+                location, file.Fd(), &dex_checksum, &error_msg)) {
           LOG(WARNING) << "Could not get dex checksums for location " << location
                        << ", fd=" << file.Fd();
           dex_files_state_ = kDexFilesOpenFailed;
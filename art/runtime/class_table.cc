@@ -16,6 +16,8 @@
 
 #include "class_table-inl.h"
 
+#include <iterator>
+
 #include "base/stl_util.h"
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"
@@ -23,7 +25,9 @@
 
 namespace art HIDDEN {
 
-ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock),
+      frozen_sets_(nullptr) {
   Runtime* const runtime = Runtime::Current();
   classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
                               runtime->GetHashTableMaxLoadFactor()));
@@ -36,6 +40,19 @@ void ClassTable::FreezeSnapshot() {
   const ClassSet& last_set = classes_.back();
   ClassSet new_set(last_set.GetMinLoadFactor(), last_set.GetMaxLoadFactor());
   classes_.push_back(std::move(new_set));
+  PublishFrozenSets();
+}
+
+void ClassTable::PublishFrozenSets() {
+  DCHECK(!classes_.empty());
+  std::unique_ptr<FrozenClassSets> frozen_sets(new FrozenClassSets());
+  frozen_sets->reserve(classes_.size() - 1u);
+  for (auto it = classes_.begin(), end = std::prev(classes_.end()); it != end; ++it) {
+    frozen_sets->push_back(&*it);
+  }
+  // Release the contents of the frozen sets to lock-free readers.
+  frozen_sets_.store(frozen_sets.get(), std::memory_order_release);
+  published_frozen_sets_.push_back(std::move(frozen_sets));
 }
 
 ObjPtr<mirror::Class> ClassTable::UpdateClass(ObjPtr<mirror::Class> klass, size_t hash) {
@@ -79,8 +96,8 @@ size_t ClassTable::CountDefiningLoaderClasses(ObjPtr<mirror::ClassLoader> defini
 size_t ClassTable::NumZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader) const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
-  for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += CountDefiningLoaderClasses(defining_loader, classes_[i]);
+  for (auto it = classes_.begin(), end = std::prev(classes_.end()); it != end; ++it) {
+    sum += CountDefiningLoaderClasses(defining_loader, *it);
   }
   return sum;
 }
@@ -93,8 +110,8 @@ size_t ClassTable::NumNonZygoteClasses(ObjPtr<mirror::ClassLoader> defining_load
 size_t ClassTable::NumReferencedZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
-  for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += classes_[i].size();
+  for (auto it = classes_.begin(), end = std::prev(classes_.end()); it != end; ++it) {
+    sum += it->size();
   }
   return sum;
 }
@@ -104,14 +121,39 @@ size_t ClassTable::NumReferencedNonZygoteClasses() const {
   return classes_.back().size();
 }
 
+ObjPtr<mirror::Class> ClassTable::LookupInFrozenSets(const FrozenClassSets* frozen_sets,
+                                                     const DescriptorHashPair& pair,
+                                                     size_t hash) {
+  // Search from the last table. For prebuilt boot images, this helps by searching the
+  // large table from the framework boot image extension compiled as single-image before
+  // the individual small tables from the primary boot image compiled as multi-image.
+  for (const ClassSet* class_set : ReverseRange(*frozen_sets)) {
+    auto it = class_set->FindWithHash(pair, hash);
+    if (it != class_set->end()) {
+      return it->Read();
+    }
+  }
+  return nullptr;
+}
+
 ObjPtr<mirror::Class> ClassTable::Lookup(std::string_view descriptor, size_t hash) {
   DescriptorHashPair pair(descriptor, hash);
+  // The frozen sets are never modified, so search them first without taking the lock,
+  // so that lookups of boot image and app image classes from many threads do not
+  // contend on `lock_`.
+  const FrozenClassSets* frozen_sets = frozen_sets_.load(std::memory_order_acquire);
+  if (frozen_sets != nullptr) {
+    ObjPtr<mirror::Class> result = LookupInFrozenSets(frozen_sets, pair, hash);
+    if (result != nullptr) {
+      return result;
+    }
+  }
   ReaderMutexLock mu(Thread::Current(), lock_);
-  // Search from the last table, assuming that apps shall search for their own classes
-  // more often than for boot image classes. For prebuilt boot images, this also helps
-  // by searching the large table from the framework boot image extension compiled as
-  // single-image before the individual small tables from the primary boot image
-  // compiled as multi-image.
+  if (LIKELY(frozen_sets_.load(std::memory_order_relaxed) == frozen_sets)) {
+    auto it = classes_.back().FindWithHash(pair, hash);
+    return (it != classes_.back().end()) ? it->Read() : nullptr;
+  }
+  // The sets were frozen or added concurrently, search all of them.
   for (ClassSet& class_set : ReverseRange(classes_)) {
     auto it = class_set.FindWithHash(pair, hash);
     if (it != class_set.end()) {
@@ -178,7 +220,8 @@ void ClassTable::AddClassSet(ClassSet&& set) {
   // the number of searched frozen tables and not search them again.
   // TODO: Make use of this in `ClassLinker::FindClass()`.
   DCHECK(!classes_.empty());
-  classes_.insert(classes_.end() - 1, std::move(set));
+  classes_.insert(std::prev(classes_.end()), std::move(set));
+  PublishFrozenSets();
 }
 
 void ClassTable::ClearStrongRoots() {
@@ -17,6 +17,9 @@
 #ifndef ART_RUNTIME_CLASS_TABLE_H_
 #define ART_RUNTIME_CLASS_TABLE_H_
 
+#include <atomic>
+#include <list>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -286,10 +289,31 @@ class ClassTable {
       REQUIRES(lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Frozen class sets, in the order of `classes_`, which can be searched without holding `lock_`.
+  using FrozenClassSets = std::vector<const ClassSet*>;
+
+  // Search the frozen class sets without holding `lock_`.
+  ObjPtr<mirror::Class> LookupInFrozenSets(const FrozenClassSets* frozen_sets,
+                                           const DescriptorHashPair& pair,
+                                           size_t hash)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Publish the frozen sets of `classes_` for lock-free lookups.
+  void PublishFrozenSets() REQUIRES(lock_);
+
   // Lock to guard inserting and removing.
   mutable ReaderWriterMutex lock_;
-  // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
-  std::vector<ClassSet> classes_ GUARDED_BY(lock_);
+  // We have a list to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
+  // All the sets but the last one are never modified, and a list keeps their addresses stable
+  // so that they can be searched without holding `lock_`.
+  std::list<ClassSet> classes_ GUARDED_BY(lock_);
+  // The current frozen sets, replaced when a set is frozen or added. Lookups that race with the
+  // replacement fall back to searching all of `classes_` with `lock_` held.
+  std::atomic<const FrozenClassSets*> frozen_sets_;
+  // All the published frozen sets, which are kept until the class table is deleted since
+  // lock-free readers may still be using an old one. There are few of them, one per image
+  // and one per zygote snapshot.
+  std::vector<std::unique_ptr<const FrozenClassSets>> published_frozen_sets_ GUARDED_BY(lock_);
   // Extra strong roots that can be either dex files or dex caches. Dex files used by the class
   // loader which may not be owned by the class loader must be held strongly live. Also dex caches
   // are held live to prevent them being unloading once they have classes in them.
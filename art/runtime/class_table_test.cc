@@ -159,5 +159,44 @@ TEST_F(ClassTableTest, ClassTable) {
   // TODO: Add tests for UpdateClass, InsertOatFile.
 }
 
+TEST_F(ClassTableTest, LookupInFrozenSets) {
+  ScopedObjectAccess soa(Thread::Current());
+  jobject jclass_loader = LoadDex("XandY");
+  VariableSizedHandleScope hs(soa.Self());
+  Handle<ClassLoader> class_loader(hs.NewHandle(soa.Decode<ClassLoader>(jclass_loader)));
+  Handle<mirror::Class> h_X = hs.NewHandle(FindClass("LX;", class_loader));
+  Handle<mirror::Class> h_Y = hs.NewHandle(FindClass("LY;", class_loader));
+  ClassTable table;
+
+  // Lookups search the frozen sets without the lock, and the active set with it.
+  table.Insert(h_X.Get());
+  table.FreezeSnapshot();
+  EXPECT_OBJ_PTR_EQ(table.LookupByDescriptor(h_X.Get()), h_X.Get());
+  EXPECT_TRUE(table.LookupByDescriptor(h_Y.Get()) == nullptr);
+  table.Insert(h_Y.Get());
+  EXPECT_OBJ_PTR_EQ(table.LookupByDescriptor(h_Y.Get()), h_Y.Get());
+
+  // Freezing again publishes a new set of frozen sets that contains both classes.
+  table.FreezeSnapshot();
+  EXPECT_EQ(table.NumReferencedZygoteClasses(), 2u);
+  EXPECT_EQ(table.NumReferencedNonZygoteClasses(), 0u);
+  EXPECT_OBJ_PTR_EQ(table.LookupByDescriptor(h_X.Get()), h_X.Get());
+  EXPECT_OBJ_PTR_EQ(table.LookupByDescriptor(h_Y.Get()), h_Y.Get());
+  EXPECT_TRUE(table.Lookup("NOT_THERE", ComputeModifiedUtf8Hash("NOT_THERE")) == nullptr);
+
+  // Sets read from memory are added before the active set and are also frozen.
+  ClassTable::ClassSet temp_set;
+  temp_set.insert(ClassTable::TableSlot(h_X.Get()));
+  const size_t count = temp_set.WriteToMemory(nullptr);
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[count]());
+  ASSERT_EQ(temp_set.WriteToMemory(&buffer[0]), count);
+  ClassTable table2;
+  table2.Insert(h_Y.Get());
+  EXPECT_EQ(table2.ReadFromMemory(&buffer[0]), count);
+  EXPECT_EQ(table2.NumReferencedZygoteClasses(), 1u);
+  EXPECT_OBJ_PTR_EQ(table2.LookupByDescriptor(h_X.Get()), h_X.Get());
+  EXPECT_OBJ_PTR_EQ(table2.LookupByDescriptor(h_Y.Get()), h_Y.Get());
+}
+
 }  // namespace mirror
 }  // namespace art
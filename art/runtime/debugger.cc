@@ -943,6 +943,8 @@ jbyteArray Dbg::GetRecentAllocations() {
 
   Thread* self = Thread::Current();
   std::vector<uint8_t> bytes;
+  // Include the records still pending in the thread-local buffers when sampling.
+  gc::AllocRecordObjectMap::FlushThreadLocalBuffers(self);
   {
     MutexLock mu(self, *Locks::alloc_tracker_lock_);
     gc::AllocRecordObjectMap* records = Runtime::Current()->GetHeap()->GetAllocationRecords();
@@ -20,8 +20,13 @@
 #include "dex/code_item_accessors-inl.h"
 #include "dex/dex_instruction-inl.h"
 #include "common_throws.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
+#include "jit/profiling_info.h"
 #include "mirror/object-inl.h"
 #include "nth_caller_visitor.h"
+#include "runtime.h"
+#include "stack.h"
 #include "thread.h"
 #include "well_known_classes.h"
 
@@ -80,10 +85,40 @@ extern "C" Context* artThrowNullPointerExceptionFromCode(Thread* self)
   return context.release();
 }
 
+// Record the fault of an implicit null check in the `ProfilingInfo` of the compiled method
+// on top of the stack, so that the JIT can use explicit null checks when compiling it again.
+static void RecordImplicitNullCheckFault(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return;
+  }
+  ArtMethod* method = nullptr;
+  StackVisitor::WalkStack(
+      [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+        ArtMethod* m = stack_visitor->GetMethod();
+        if (m == nullptr || m->IsRuntimeMethod()) {
+          return true;
+        }
+        method = m;
+        return false;
+      },
+      self,
+      /* context= */ nullptr,
+      art::StackVisitor::StackWalkKind::kSkipInlinedFrames);
+  if (method == nullptr) {
+    return;
+  }
+  ProfilingInfo* info = jit->GetCodeCache()->GetProfilingInfo(method, self);
+  if (info != nullptr) {
+    info->AddImplicitNullCheckFault();
+  }
+}
+
 // Installed by a signal handler to throw a NPE exception.
 extern "C" Context* artThrowNullPointerExceptionFromSignal(uintptr_t addr, Thread* self)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   ScopedQuickEntrypointChecks sqec(self);
+  RecordImplicitNullCheckFault(self);
   ThrowNullPointerExceptionFromDexPC(/* check_address= */ true, addr);
   std::unique_ptr<Context> context = self->QuickDeliverException();
   DCHECK(context != nullptr);
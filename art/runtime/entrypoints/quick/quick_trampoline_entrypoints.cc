@@ -1121,7 +1121,7 @@ static void DumpB74410240ClassData(ObjPtr<mirror::Class> klass)
   const char* descriptor = klass->GetDescriptor(&storage);
   LOG(FATAL_WITHOUT_ABORT) << "  " << DescribeLoaders(klass->GetClassLoader(), descriptor);
   const OatDexFile* oat_dex_file = klass->GetDexFile().GetOatDexFile();
-  if (oat_dex_file != nullptr) {
+  if (oat_dex_file != nullptr && oat_dex_file->GetOatFile() != nullptr) {
     const OatFile* oat_file = oat_dex_file->GetOatFile();
     const char* dex2oat_cmdline =
         oat_file->GetOatHeader().GetStoreValueByKey(OatHeader::kDex2OatCmdLineKey);
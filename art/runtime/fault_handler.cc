@@ -66,6 +66,7 @@ static bool art_sigbus_handler(int sig, siginfo_t* info, void* context) {
 FaultManager::FaultManager()
     : generated_code_ranges_lock_("FaultHandler generated code ranges lock",
                                   LockLevel::kGenericBottomLock),
+      last_hit_range_(nullptr),
       initialized_(false) {}
 
 FaultManager::~FaultManager() {
@@ -188,6 +189,7 @@ void FaultManager::Shutdown() {
     MutexLock lock(Thread::Current(), generated_code_ranges_lock_);
     GeneratedCodeRange* range = generated_code_ranges_.load(std::memory_order_acquire);
     generated_code_ranges_.store(nullptr, std::memory_order_release);
+    last_hit_range_.store(nullptr, std::memory_order_relaxed);
     while (range != nullptr) {
       GeneratedCodeRange* next_range = range->next.load(std::memory_order_relaxed);
       std::less<GeneratedCodeRange*> less;
@@ -427,22 +429,35 @@ void FaultManager::RemoveGeneratedCodeRange(const void* start, size_t size) {
         // retained nodes, if any.
         before->store(next, std::memory_order_relaxed);
       }
+      GeneratedCodeRange* expected = range;
+      last_hit_range_.compare_exchange_strong(expected, nullptr, std::memory_order_relaxed);
     }
   }
   CHECK(range != nullptr);
   DCHECK_EQ(range->start, start);
   CHECK_EQ(range->size, size);
 
+  // Run a checkpoint before deleting the range to ensure that no thread holds a
+  // pointer to the removed range while walking the list in `IsInGeneratedCode()`.
+  // That walk is guarded by checking that the thread is `Runnable`, so any walk
+  // started before the removal shall be done when running the checkpoint and the
+  // checkpoint also ensures the correct memory visibility of `next` links,
+  // so the thread shall not see the pointer during future walks.
+  WaitForGeneratedCodeRangeWalks(self);
+  // A walk that started before the removal may have stored the removed range as
+  // `last_hit_range_` after we cleared it above. No later walk can find the range,
+  // so clear it again and, if it was set, wait for the threads that may have read it.
+  GeneratedCodeRange* expected = range;
+  if (last_hit_range_.compare_exchange_strong(expected, nullptr, std::memory_order_relaxed)) {
+    WaitForGeneratedCodeRangeWalks(self);
+  }
+  FreeGeneratedCodeRange(range);
+}
+
+void FaultManager::WaitForGeneratedCodeRangeWalks(Thread* self) {
   Runtime* runtime = Runtime::Current();
   CHECK(runtime != nullptr);
   if (runtime->IsStarted() && runtime->GetThreadList() != nullptr) {
-    // Run a checkpoint before deleting the range to ensure that no thread holds a
-    // pointer to the removed range while walking the list in `IsInGeneratedCode()`.
-    // That walk is guarded by checking that the thread is `Runnable`, so any walk
-    // started before the removal shall be done when running the checkpoint and the
-    // checkpoint also ensures the correct memory visibility of `next` links,
-    // so the thread shall not see the pointer during future walks.
-
     // This function is currently called in different mutex and thread states.
     // Semi-space GC performs the cleanup during its `MarkingPhase()` while holding
     // the mutator exclusively, so we do not need a checkpoint. All other GCs perform
@@ -470,7 +485,6 @@ void FaultManager::RemoveGeneratedCodeRange(const void* start, size_t size) {
       }
     }
   }
-  FreeGeneratedCodeRange(range);
 }
 
 // This function is called within the signal handler. It checks that the thread
@@ -505,10 +519,19 @@ bool FaultManager::IsInGeneratedCode(siginfo_t* siginfo, void* context) {
     return false;
   }
 
+  GeneratedCodeRange* last_hit_range = last_hit_range_.load(std::memory_order_acquire);
+  if (last_hit_range != nullptr &&
+      fault_pc - reinterpret_cast<uintptr_t>(last_hit_range->start) < last_hit_range->size) {
+    return true;
+  }
+
   // Walk over the list of registered code ranges.
   GeneratedCodeRange* range = generated_code_ranges_.load(std::memory_order_acquire);
   while (range != nullptr) {
     if (fault_pc - reinterpret_cast<uintptr_t>(range->start) < range->size) {
+      if (range != last_hit_range) {
+        last_hit_range_.store(range, std::memory_order_release);
+      }
       return true;
     }
     // We may or may not see ranges that were concurrently removed, depending
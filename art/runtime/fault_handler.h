@@ -86,6 +86,10 @@ class FaultManager {
       REQUIRES(generated_code_ranges_lock_);
   void FreeGeneratedCodeRange(GeneratedCodeRange* range) REQUIRES(!generated_code_ranges_lock_);
 
+  // Wait until no thread is walking the generated code ranges in `IsInGeneratedCode()` with
+  // a view of the ranges from before the last removal.
+  void WaitForGeneratedCodeRangeWalks(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // The HandleFaultByOtherHandlers function is only called by HandleFault function for generated code.
   bool HandleFaultByOtherHandlers(int sig, siginfo_t* info, void* context)
                                   NO_THREAD_SAFETY_ANALYSIS;
@@ -102,6 +106,11 @@ class FaultManager {
   Mutex generated_code_ranges_lock_;
   std::atomic<GeneratedCodeRange*> generated_code_ranges_ GUARDED_BY(generated_code_ranges_lock_);
 
+  // The range that contained the last fault PC found by `IsInGeneratedCode()`. Implicit checks
+  // usually keep faulting in the same range (the JIT code cache or the boot image code), so it
+  // is checked before walking the list. Cleared when the range is removed.
+  std::atomic<GeneratedCodeRange*> last_hit_range_;
+
   std::vector<FaultHandler*> generated_code_handlers_;
   std::vector<FaultHandler*> other_handlers_;
   bool initialized_;
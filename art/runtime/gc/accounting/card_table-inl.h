@@ -25,6 +25,7 @@
 #include "base/bit_utils.h"
 #include "base/mem_map.h"
 #include "space_bitmap.h"
+#include "thread_pool.h"
 
 namespace art HIDDEN {
 namespace gc {
@@ -182,8 +183,21 @@ inline void CardTable::ModifyCardsAtomic(uint8_t* scan_begin,
     uint8_t new_bytes[sizeof(uintptr_t)];
   };
 
-  // TODO: Parallelize.
+  static constexpr size_t kWordsPerCacheLine = kCardsPerCacheLine / sizeof(uintptr_t);
   while (word_cur < word_end) {
+    // Most of the card table is clean. Skip clean cache lines with a single OR-reduction, which
+    // the compiler turns into vector loads and compares.
+    if (IsAligned<kCardsPerCacheLine>(word_cur) &&
+        static_cast<size_t>(word_end - word_cur) >= kWordsPerCacheLine) {
+      uintptr_t line = 0;
+      for (size_t i = 0; i < kWordsPerCacheLine; ++i) {
+        line |= word_cur[i];
+      }
+      if (line == 0) {
+        word_cur += kWordsPerCacheLine;
+        continue;
+      }
+    }
     while (true) {
       expected_word = *word_cur;
       static_assert(kCardClean == 0);
@@ -209,6 +223,42 @@ inline void CardTable::ModifyCardsAtomic(uint8_t* scan_begin,
   }
 }
 
+template <typename Visitor, typename ModifiedVisitor>
+inline void CardTable::ModifyCardsAtomicParallel(Thread* self,
+                                                 ThreadPool* thread_pool,
+                                                 uint8_t* scan_begin,
+                                                 uint8_t* scan_end,
+                                                 const Visitor& visitor,
+                                                 const ModifiedVisitor& modified) {
+  static constexpr size_t kChunkBytes = kParallelCardChunkSize * kCardSize;
+  const size_t num_threads = thread_pool != nullptr ? thread_pool->GetThreadCount() : 0u;
+  if (num_threads == 0 || static_cast<size_t>(scan_end - scan_begin) < 2 * kChunkBytes) {
+    ModifyCardsAtomic(scan_begin, scan_end, visitor, modified);
+    return;
+  }
+  // Chunk boundaries must be card aligned so that no card gets visited twice.
+  uint8_t* const aligned_begin = AlignDown(scan_begin, kCardSize);
+  const size_t num_chunks = RoundUp(scan_end - aligned_begin, kChunkBytes) / kChunkBytes;
+  std::atomic<size_t> next_chunk(0);
+  auto work = [&](Thread*) {
+    for (size_t chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+         chunk < num_chunks;
+         chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) {
+      uint8_t* begin = std::max(scan_begin, aligned_begin + chunk * kChunkBytes);
+      uint8_t* end = std::min(scan_end, aligned_begin + (chunk + 1) * kChunkBytes);
+      ModifyCardsAtomic(begin, end, visitor, modified);
+    }
+  };
+  const size_t num_tasks = std::min(num_threads, num_chunks - 1);
+  for (size_t i = 0; i < num_tasks; ++i) {
+    thread_pool->AddTask(self, new FunctionTask(work));
+  }
+  thread_pool->StartWorkers(self);
+  work(self);
+  thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+  thread_pool->StopWorkers(self);
+}
+
 inline void* CardTable::AddrFromCard(const uint8_t *card_addr) const {
   DCHECK(IsValidCard(card_addr))
     << " card_addr: " << reinterpret_cast<const void*>(card_addr)
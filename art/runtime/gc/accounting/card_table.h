@@ -25,6 +25,9 @@
 
 namespace art HIDDEN {
 
+class Thread;
+class ThreadPool;
+
 namespace mirror {
 class Object;
 }  // namespace mirror
@@ -51,6 +54,10 @@ class CardTable {
   static constexpr uint8_t kCardClean = 0x0;
   static constexpr uint8_t kCardDirty = 0x70;
   static constexpr uint8_t kCardAged = kCardDirty - 1;
+  // ModifyCardsAtomic() checks this many cards at once to skip clean runs quickly.
+  static constexpr size_t kCardsPerCacheLine = 64;
+  // Number of cards per task in ModifyCardsAtomicParallel(). Covers 64MB of heap.
+  static constexpr size_t kParallelCardChunkSize = 64 * KB;
 
   static CardTable* Create(const uint8_t* heap_begin, size_t heap_capacity);
   ~CardTable();
@@ -114,6 +121,17 @@ class CardTable {
                          const Visitor& visitor,
                          const ModifiedVisitor& modified);
 
+  // Same as ModifyCardsAtomic(), but splits the range into chunks processed by the given thread
+  // pool and the calling thread. The visitor must be safe to call concurrently. Falls back to
+  // ModifyCardsAtomic() if there is no thread pool or the range is small.
+  template <typename Visitor, typename ModifiedVisitor>
+  void ModifyCardsAtomicParallel(Thread* self,
+                                 ThreadPool* thread_pool,
+                                 uint8_t* scan_begin,
+                                 uint8_t* scan_end,
+                                 const Visitor& visitor,
+                                 const ModifiedVisitor& modified);
+
   // For every dirty at least minumum age between begin and end invoke the visitor with the
   // specified argument. Returns how many cards the visitor was run on.
   template <bool kClearCard, typename Visitor>
@@ -142,6 +160,10 @@ class CardTable {
 
   bool AddrIsInCardTable(const void* addr) const;
 
+  // Back the card table with transparent huge pages. ClearCardRange() then only releases whole
+  // huge pages, so that they are not split.
+  void EnableHugePages();
+
  private:
   CardTable(MemMap&& mem_map, uint8_t* biased_begin, size_t offset);
 
@@ -160,6 +182,8 @@ class CardTable {
   // Card table doesn't begin at the beginning of the mem_map_, instead it is displaced by offset
   // to allow the byte value of `biased_begin_` to equal `kCardDirty`.
   const size_t offset_;
+  // Whether the card table is backed by transparent huge pages.
+  bool use_huge_pages_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(CardTable);
 };
@@ -145,6 +145,33 @@ TEST_F(CardTableTest, TestModifyCardsAtomic) {
   }
 }
 
+// Mostly clean card table, to exercise skipping of clean cache lines.
+TEST_F(CardTableTest, TestModifyCardsAtomicSparse) {
+  CommonSetup();
+  static constexpr size_t kStride = 97;
+  size_t num_dirty = 0;
+  for (uint8_t* addr = HeapBegin(); addr < HeapLimit(); addr += kStride * CardTable::kCardSize) {
+    card_table_->MarkCard(addr);
+    ++num_dirty;
+  }
+  size_t num_modified = 0;
+  card_table_->ModifyCardsAtomic(
+      HeapBegin(),
+      HeapLimit(),
+      AgeCardVisitor(),
+      [&num_modified](uint8_t* /*card*/, uint8_t expected_value, uint8_t new_value) {
+        EXPECT_EQ(expected_value, CardTable::kCardDirty);
+        EXPECT_EQ(new_value, CardTable::kCardAged);
+        ++num_modified;
+      });
+  EXPECT_EQ(num_dirty, num_modified);
+  size_t i = 0;
+  for (uint8_t* addr = HeapBegin(); addr < HeapLimit(); addr += CardTable::kCardSize, ++i) {
+    EXPECT_EQ(card_table_->GetCard(reinterpret_cast<mirror::Object*>(addr)),
+              (i % kStride == 0) ? CardTable::kCardAged : CardTable::kCardClean);
+  }
+}
+
 // TODO: Add test for CardTable::Scan.
 }  // namespace accounting
 }  // namespace gc
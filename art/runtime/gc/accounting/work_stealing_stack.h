@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_ACCOUNTING_WORK_STEALING_STACK_H_
+#define ART_RUNTIME_GC_ACCOUNTING_WORK_STEALING_STACK_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <memory>
+
+#include <android-base/logging.h>
+
+#include "base/bit_utils.h"
+#include "base/macros.h"
+
+// This implements a fixed-capacity work-stealing deque, as described in
+// "Dynamic Circular Work-Stealing Deque" by Chase and Lev, using the C11
+// memory-model formulation from "Correct and Efficient Work-Stealing for Weak
+// Memory Models" by Le et al.
+// - Push() and Pop() may only be called by the owner thread, and operate on the
+//   bottom end (LIFO).
+// - Steal() may be called by any thread, and operates on the top end (FIFO).
+// Unlike the paper, the buffer is never grown. Push() returns false when the
+// deque is full and the caller is expected to spill the element elsewhere.
+
+namespace art HIDDEN {
+namespace gc {
+namespace accounting {
+
+template <typename T>
+class WorkStealingStack {
+ public:
+  // Capacity must be a power of 2.
+  explicit WorkStealingStack(size_t capacity)
+      : top_(0), bottom_(0), mask_(capacity - 1), buffer_(new std::atomic<T*>[capacity]) {
+    DCHECK(IsPowerOfTwo(capacity));
+  }
+
+  // Owner thread only.
+  bool Push(T* value) {
+    ssize_t bottom = bottom_.load(std::memory_order_relaxed);
+    ssize_t top = top_.load(std::memory_order_acquire);
+    if (UNLIKELY(bottom - top > static_cast<ssize_t>(mask_))) {
+      return false;
+    }
+    buffer_[bottom & mask_].store(value, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Owner thread only. Returns null if empty.
+  T* Pop() {
+    ssize_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    ssize_t top = top_.load(std::memory_order_relaxed);
+    T* value = nullptr;
+    if (top <= bottom) {
+      value = buffer_[bottom & mask_].load(std::memory_order_relaxed);
+      if (top == bottom) {
+        // Last element. Race with thieves for it.
+        if (!top_.compare_exchange_strong(
+                top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+          value = nullptr;
+        }
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+  // Any thread. Returns null if empty or if the race with another thief or the
+  // owner was lost.
+  T* Steal() {
+    ssize_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    ssize_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top < bottom) {
+      T* value = buffer_[top & mask_].load(std::memory_order_relaxed);
+      if (top_.compare_exchange_strong(
+              top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return value;
+      }
+    }
+    return nullptr;
+  }
+
+  // Approximate when called by a thread other than the owner.
+  bool IsEmpty() const {
+    return bottom_.load(std::memory_order_acquire) <= top_.load(std::memory_order_acquire);
+  }
+
+  size_t Capacity() const {
+    return mask_ + 1;
+  }
+
+ private:
+  std::atomic<ssize_t> top_;
+  std::atomic<ssize_t> bottom_;
+  const size_t mask_;
+  std::unique_ptr<std::atomic<T*>[]> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingStack);
+};
+
+}  // namespace accounting
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_ACCOUNTING_WORK_STEALING_STACK_H_
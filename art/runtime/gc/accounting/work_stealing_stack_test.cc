@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "work_stealing_stack.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace art HIDDEN {
+namespace gc {
+namespace accounting {
+
+TEST(WorkStealingStackTest, PushPopSteal) {
+  static constexpr size_t kCapacity = 16;
+  std::vector<int> values(kCapacity);
+  WorkStealingStack<int> stack(kCapacity);
+  EXPECT_TRUE(stack.IsEmpty());
+  EXPECT_EQ(stack.Pop(), nullptr);
+  EXPECT_EQ(stack.Steal(), nullptr);
+  for (size_t i = 0; i < kCapacity; i++) {
+    EXPECT_TRUE(stack.Push(&values[i]));
+  }
+  // Full.
+  int extra;
+  EXPECT_FALSE(stack.Push(&extra));
+  // Owner pops from the bottom, thieves steal from the top.
+  EXPECT_EQ(stack.Pop(), &values[kCapacity - 1]);
+  EXPECT_EQ(stack.Steal(), &values[0]);
+  EXPECT_TRUE(stack.Push(&extra));
+  EXPECT_EQ(stack.Pop(), &extra);
+  for (size_t i = kCapacity - 2; i > 0; i--) {
+    EXPECT_EQ(stack.Pop(), &values[i]);
+  }
+  EXPECT_TRUE(stack.IsEmpty());
+  EXPECT_EQ(stack.Pop(), nullptr);
+}
+
+TEST(WorkStealingStackTest, ConcurrentSteal) {
+  static constexpr size_t kCapacity = 1024;
+  static constexpr size_t kNumValues = 100000;
+  static constexpr size_t kNumThieves = 4;
+  std::vector<int> values(kNumValues);
+  std::vector<std::atomic<int>> seen(kNumValues);
+  WorkStealingStack<int> stack(kCapacity);
+  std::atomic<bool> done(false);
+  auto record = [&](int* value) {
+    seen[value - values.data()].fetch_add(1, std::memory_order_relaxed);
+  };
+
+  std::vector<std::thread> thieves;
+  for (size_t i = 0; i < kNumThieves; i++) {
+    thieves.emplace_back([&]() {
+      while (!done.load(std::memory_order_acquire) || !stack.IsEmpty()) {
+        int* value = stack.Steal();
+        if (value != nullptr) {
+          record(value);
+        }
+      }
+    });
+  }
+  for (size_t i = 0; i < kNumValues; i++) {
+    while (!stack.Push(&values[i])) {
+      int* value = stack.Pop();
+      if (value != nullptr) {
+        record(value);
+      }
+    }
+    if (i % 3 == 0) {
+      int* value = stack.Pop();
+      if (value != nullptr) {
+        record(value);
+      }
+    }
+  }
+  for (int* value = stack.Pop(); value != nullptr; value = stack.Pop()) {
+    record(value);
+  }
+  done.store(true, std::memory_order_release);
+  for (std::thread& thief : thieves) {
+    thief.join();
+  }
+  // Every element must have been handed out exactly once.
+  for (size_t i = 0; i < kNumValues; i++) {
+    EXPECT_EQ(seen[i].load(std::memory_order_relaxed), 1) << i;
+  }
+}
+
+}  // namespace accounting
+}  // namespace gc
+}  // namespace art
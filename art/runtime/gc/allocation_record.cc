@@ -17,13 +17,17 @@
 #include "allocation_record.h"
 
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/logging.h"  // For VLOG
 #include "base/pointer_size.h"
 #include "base/stl_util.h"
+#include "gc/heap.h"
 #include "obj_ptr-inl.h"
 #include "object_callbacks.h"
+#include "scoped_thread_state_change-inl.h"
 #include "stack.h"
 #include "thread-inl.h"  // For GetWeakRefAccessEnabled().
+#include "thread_list.h"
 
 #include <android-base/properties.h>
 
@@ -54,6 +58,35 @@ void AllocRecordObjectMap::SetMaxStackDepth(size_t max_stack_depth) {
   max_stack_depth_ = max_stack_depth;
 }
 
+void AllocRecordObjectMap::SetSampleInterval(size_t sample_interval) {
+  sample_interval_ = sample_interval;
+}
+
+AllocRecordThreadLocalBuffer::AllocRecordThreadLocalBuffer(uint32_t seed, size_t sample_interval)
+    : bytes_until_sample_(0), rng_(seed) {
+  entries_.reserve(kCapacity);
+  PickNextSample(sample_interval);
+}
+
+void AllocRecordThreadLocalBuffer::PickNextSample(size_t sample_interval) {
+  DCHECK_NE(sample_interval, 0u);
+  std::exponential_distribution<double> dist(1.0 / static_cast<double>(sample_interval));
+  // Never sample twice for the same byte.
+  bytes_until_sample_ = std::max<size_t>(1u, static_cast<size_t>(dist(rng_)));
+}
+
+void AllocRecordThreadLocalBuffer::VisitRoots(RootVisitor* visitor, uint32_t thread_id) {
+  BufferedRootVisitor<kDefaultBufferedRootCount> buffered_visitor(
+      visitor, RootInfo(kRootDebugger, thread_id));
+  for (Entry& entry : entries_) {
+    buffered_visitor.VisitRootIfNonNull(entry.obj);
+    buffered_visitor.VisitRootIfNonNull(entry.klass);
+    for (size_t i = 0, depth = entry.trace.GetDepth(); i < depth; ++i) {
+      entry.trace.GetStackElement(i).GetMethod()->VisitRoots(buffered_visitor, kRuntimePointerSize);
+    }
+  }
+}
+
 AllocRecordObjectMap::~AllocRecordObjectMap() {
   Clear();
 }
@@ -69,20 +102,21 @@ void AllocRecordObjectMap::VisitRoots(RootVisitor* visitor) {
   size_t count = recent_record_max_;
   // Only visit the last recent_record_max_ number of allocation records in entries_ and mark the
   // klass_ fields as strong roots.
-  for (auto it = entries_.rbegin(), end = entries_.rend(); it != end; ++it) {
+  for (auto it = entries_.rbegin(), end = entries_.rend(); count > 0 && it != end; ++it) {
     AllocRecord& record = it->second;
-    if (count > 0) {
-      buffered_visitor.VisitRootIfNonNull(record.GetClassGcRoot());
-      --count;
-    }
-    // Visit all of the stack frames to make sure no methods in the stack traces get unloaded by
-    // class unloading.
-    for (size_t i = 0, depth = record.GetDepth(); i < depth; ++i) {
-      const AllocRecordStackTraceElement& element = record.StackElement(i);
+    buffered_visitor.VisitRootIfNonNull(record.GetClassGcRoot());
+    --count;
+  }
+  // Visit all of the stack frames to make sure no methods in the stack traces get unloaded by
+  // class unloading. Each shared trace only needs to be visited once.
+  stack_traces_.VisitTraces([&](const AllocRecordStackTrace& trace)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (size_t i = 0, depth = trace.GetDepth(); i < depth; ++i) {
+      const AllocRecordStackTraceElement& element = trace.GetStackElement(i);
       DCHECK(element.GetMethod() != nullptr);
       element.GetMethod()->VisitRoots(buffered_visitor, kRuntimePointerSize);
     }
-  }
+  });
 }
 
 static inline void SweepClassObject(AllocRecord* record, IsMarkedVisitor* visitor)
@@ -122,6 +156,7 @@ void AllocRecordObjectMap::SweepAllocationRecords(IsMarkedVisitor* visitor) {
         SweepClassObject(&record, visitor);
         ++it;
       } else {
+        stack_traces_.Release(record.GetStackTrace());
         it = entries_.erase(it);
         ++count_deleted;
       }
@@ -136,6 +171,8 @@ void AllocRecordObjectMap::SweepAllocationRecords(IsMarkedVisitor* visitor) {
   }
   VLOG(heap) << "Deleted " << count_deleted << " allocation records";
   VLOG(heap) << "Updated " << count_moved << " allocation records";
+  VLOG(heap) << "Keeping " << stack_traces_.Size() << " unique stack traces for "
+             << entries_.size() << " allocation records";
 }
 
 void AllocRecordObjectMap::AllowNewAllocationRecords() {
@@ -169,11 +206,20 @@ void AllocRecordObjectMap::SetAllocTrackingEnabled(bool enable) {
       }
       CHECK(records != nullptr);
       records->SetMaxStackDepth(heap->GetAllocTrackerStackDepth());
+      size_t sample_interval = heap->GetAllocTrackerSampleInterval();
+      if (sample_interval == 0) {
+        sample_interval = android::base::GetUintProperty<size_t>(kSampleIntervalProperty, 0u);
+      }
+      records->SetSampleInterval(sample_interval);
       size_t sz = sizeof(AllocRecordStackTraceElement) * records->max_stack_depth_ +
                   sizeof(AllocRecord) + sizeof(AllocRecordStackTrace);
       LOG(INFO) << "Enabling alloc tracker (" << records->alloc_record_max_ << " entries of "
                 << records->max_stack_depth_ << " frames, taking up to "
                 << PrettySize(sz * records->alloc_record_max_) << ")";
+      if (sample_interval != 0) {
+        LOG(INFO) << "Sampling one allocation every " << PrettySize(sample_interval)
+                  << " on average";
+      }
     }
     Runtime::Current()->GetInstrumentation()->InstrumentQuickAllocEntryPoints();
     {
@@ -193,14 +239,103 @@ void AllocRecordObjectMap::SetAllocTrackingEnabled(bool enable) {
       AllocRecordObjectMap* records = heap->GetAllocationRecords();
       records->Clear();
     }
+    // Drop the records still pending in the thread-local buffers.
+    FlushThreadLocalBuffers(self);
     // If an allocation comes in before we uninstrument, we will safely drop it on the floor.
     Runtime::Current()->GetInstrumentation()->UninstrumentQuickAllocEntryPoints();
   }
 }
 
+class FlushAllocRecordsClosure : public Closure {
+ public:
+  explicit FlushAllocRecordsClosure(Barrier* barrier) : barrier_(barrier) {}
+
+  void Run(Thread* thread) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    Thread* self = Thread::Current();
+    AllocRecordObjectMap::FlushThreadLocalBuffer(self, thread);
+    // If thread is a running mutator, then act on behalf of the flushing thread.
+    // See the code in ThreadList::RunCheckpoint.
+    barrier_->Pass(self);
+  }
+
+ private:
+  Barrier* const barrier_;
+};
+
+void AllocRecordObjectMap::FlushThreadLocalBuffers(Thread* self) {
+  ScopedObjectAccess soa(self);
+  Barrier barrier(0);
+  FlushAllocRecordsClosure closure(&barrier);
+  size_t barrier_count = Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
+  ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
+  if (barrier_count != 0) {
+    barrier.Increment(self, barrier_count);
+  }
+}
+
+void AllocRecordObjectMap::MergeThreadLocalBuffers(Thread* self) {
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  for (Thread* thread : Runtime::Current()->GetThreadList()->GetList()) {
+    AllocRecordThreadLocalBuffer* buffer = thread->GetAllocRecordBuffer();
+    if (buffer != nullptr) {
+      MergeThreadLocalBufferLocked(buffer);
+    }
+  }
+}
+
+void AllocRecordObjectMap::MergeThreadLocalBufferLocked(AllocRecordThreadLocalBuffer* buffer) {
+  // Records of one thread stay in allocation order, but they may be merged after more recent
+  // records of other threads.
+  for (AllocRecordThreadLocalBuffer::Entry& entry : buffer->entries_) {
+    Put(entry.obj.Read(), entry.byte_count, entry.klass.Read(), std::move(entry.trace));
+  }
+  buffer->Clear();
+}
+
+void AllocRecordObjectMap::FlushThreadLocalBuffer(Thread* self, Thread* thread) {
+  AllocRecordThreadLocalBuffer* buffer = thread->GetAllocRecordBuffer();
+  if (buffer == nullptr || buffer->Size() == 0) {
+    return;
+  }
+  MutexLock mu(self, *Locks::alloc_tracker_lock_);
+  Heap* const heap = Runtime::Current()->GetHeap();
+  if (!heap->IsAllocTrackingEnabled()) {
+    buffer->Clear();
+    return;
+  }
+  AllocRecordObjectMap* records = heap->GetAllocationRecords();
+  // The pending objects are strong roots, but once merged they become weak roots. Wait for GC's
+  // sweeping to complete, as in RecordAllocation().
+  while (UNLIKELY((!gUseReadBarrier && !records->allow_new_record_) ||
+                  (gUseReadBarrier && !self->GetWeakRefAccessEnabled()))) {
+    self->CheckEmptyCheckpointFromWeakRefAccess(Locks::alloc_tracker_lock_);
+    records->new_record_condition_.WaitHoldingLocks(self);
+  }
+  if (!heap->IsAllocTrackingEnabled()) {
+    buffer->Clear();
+    return;
+  }
+  records->MergeThreadLocalBufferLocked(buffer);
+}
+
 void AllocRecordObjectMap::RecordAllocation(Thread* self,
                                             ObjPtr<mirror::Object>* obj,
                                             size_t byte_count) {
+  const size_t sample_interval = sample_interval_;
+  AllocRecordThreadLocalBuffer* buffer = nullptr;
+  if (sample_interval != 0) {
+    buffer = self->GetAllocRecordBuffer();
+    if (UNLIKELY(buffer == nullptr)) {
+      buffer = new AllocRecordThreadLocalBuffer(static_cast<uint32_t>(self->GetTid()),
+                                                sample_interval);
+      self->SetAllocRecordBuffer(buffer);
+    }
+    if (LIKELY(!buffer->ShouldSample(byte_count, sample_interval))) {
+      return;
+    }
+  }
+
   // Get stack trace outside of lock in case there are allocations during the stack walk.
   // b/27858645.
   AllocRecordStackTrace trace;
@@ -226,6 +361,21 @@ void AllocRecordObjectMap::RecordAllocation(Thread* self,
         art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
   }
 
+  if (buffer != nullptr) {
+    Heap* const heap = Runtime::Current()->GetHeap();
+    if (!heap->IsAllocTrackingEnabled()) {
+      return;
+    }
+    // Allocations during the stack walk may have added records, but a full buffer is always
+    // merged right away.
+    trace.SetTid(self->GetTid());
+    buffer->Add(obj->Ptr(), byte_count, (*obj)->GetClass(), std::move(trace));
+    if (buffer->IsFull()) {
+      FlushThreadLocalBuffer(self, self);
+    }
+    return;
+  }
+
   MutexLock mu(self, *Locks::alloc_tracker_lock_);
   Heap* const heap = Runtime::Current()->GetHeap();
   if (!heap->IsAllocTrackingEnabled()) {
@@ -258,12 +408,13 @@ void AllocRecordObjectMap::RecordAllocation(Thread* self,
   trace.SetTid(self->GetTid());
 
   // Add the record.
-  Put(obj->Ptr(), AllocRecord(byte_count, (*obj)->GetClass(), std::move(trace)));
+  Put(obj->Ptr(), byte_count, (*obj)->GetClass(), std::move(trace));
   DCHECK_LE(Size(), alloc_record_max_);
 }
 
 void AllocRecordObjectMap::Clear() {
   entries_.clear();
+  stack_traces_.Clear();
 }
 
 AllocRecordObjectMap::AllocRecordObjectMap()
@@ -19,6 +19,9 @@
 
 #include <list>
 #include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/mutex.h"
@@ -29,6 +32,7 @@ namespace art HIDDEN {
 
 class ArtMethod;
 class IsMarkedVisitor;
+class RootVisitor;
 class Thread;
 
 namespace mirror {
@@ -38,6 +42,8 @@ class Object;
 
 namespace gc {
 
+class AllocRecordThreadLocalBuffer;
+
 class AllocRecordStackTraceElement {
  public:
   int32_t ComputeLineNumber() const REQUIRES_SHARED(Locks::mutator_lock_);
@@ -154,18 +160,66 @@ template <typename T> struct EqAllocRecordTypesPtr {
   }
 };
 
+// Hash-consed stack traces shared by the allocation records with identical stacks. Each trace is
+// reference counted by the records using it, and freed with the last one.
+class AllocRecordStackTraceTable {
+ public:
+  AllocRecordStackTraceTable() = default;
+
+  // Returns the canonical copy of `trace`, and takes a reference to it.
+  const AllocRecordStackTrace* Intern(AllocRecordStackTrace&& trace) {
+    auto it = traces_.try_emplace(std::move(trace), 0u).first;
+    ++it->second;
+    return &it->first;
+  }
+
+  // Drops a reference taken by Intern().
+  void Release(const AllocRecordStackTrace* trace) {
+    auto it = traces_.find(*trace);
+    DCHECK(it != traces_.end());
+    DCHECK_EQ(&it->first, trace);
+    DCHECK_NE(it->second, 0u);
+    if (--it->second == 0u) {
+      traces_.erase(it);
+    }
+  }
+
+  // Visits each unique trace once.
+  template <typename Visitor>
+  void VisitTraces(Visitor&& visitor) const {
+    for (const auto& entry : traces_) {
+      visitor(entry.first);
+    }
+  }
+
+  size_t Size() const {
+    return traces_.size();
+  }
+
+  void Clear() {
+    traces_.clear();
+  }
+
+ private:
+  // Keys of an unordered_map have stable addresses, which the records point to.
+  std::unordered_map<AllocRecordStackTrace, size_t, HashAllocRecordTypes> traces_;
+
+  DISALLOW_COPY_AND_ASSIGN(AllocRecordStackTraceTable);
+};
+
 class AllocRecord {
  public:
-  // All instances of AllocRecord should be managed by an instance of AllocRecordObjectMap.
-  AllocRecord(size_t count, mirror::Class* klass, AllocRecordStackTrace&& trace)
-      : byte_count_(count), klass_(klass), trace_(std::move(trace)) {}
+  // All instances of AllocRecord should be managed by an instance of AllocRecordObjectMap, which
+  // owns the interned `trace`.
+  AllocRecord(size_t count, mirror::Class* klass, const AllocRecordStackTrace* trace)
+      : byte_count_(count), klass_(klass), trace_(trace) {}
 
   size_t GetDepth() const {
-    return trace_.GetDepth();
+    return trace_->GetDepth();
   }
 
   const AllocRecordStackTrace* GetStackTrace() const {
-    return &trace_;
+    return trace_;
   }
 
   size_t ByteCount() const {
@@ -173,7 +227,7 @@ class AllocRecord {
   }
 
   pid_t GetTid() const {
-    return trace_.GetTid();
+    return trace_->GetTid();
   }
 
   mirror::Class* GetClass() const REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -188,15 +242,15 @@ class AllocRecord {
   }
 
   const AllocRecordStackTraceElement& StackElement(size_t index) const {
-    return trace_.GetStackElement(index);
+    return trace_->GetStackElement(index);
   }
 
  private:
   const size_t byte_count_;
   // The klass_ could be a strong or weak root for GC
   GcRoot<mirror::Class> klass_;
-  // TODO: Share between alloc records with identical stack traces.
-  AllocRecordStackTrace trace_;
+  // Shared with the other records with the same stack, see AllocRecordStackTraceTable.
+  const AllocRecordStackTrace* const trace_;
 };
 
 class AllocRecordObjectMap {
@@ -205,6 +259,9 @@ class AllocRecordObjectMap {
   static constexpr size_t kDefaultNumRecentRecords = 64 * 1024 - 1;
   static constexpr size_t kDefaultAllocStackDepth = 16;
   static constexpr size_t kMaxSupportedStackDepth = 128;
+  // System property for the mean number of bytes between sampled allocations, used unless the
+  // heap has its own sample interval. Zero means every allocation is recorded.
+  static constexpr const char* kSampleIntervalProperty = "dalvik.vm.allocTrackerSampleInterval";
 
   // GcRoot<mirror::Object> pointers in the list are weak roots, and the last recent_record_max_
   // number of AllocRecord::klass_ pointers are strong roots (and the rest of klass_ pointers are
@@ -216,27 +273,61 @@ class AllocRecordObjectMap {
 
   // Caller needs to check that it is enabled before calling since we read the stack trace before
   // checking the enabled boolean.
+  // When sampling, only allocations picked by the thread's sampler walk the stack, and their
+  // records go to the thread's AllocRecordThreadLocalBuffer without taking the lock. Full buffers
+  // are merged into the map by their thread; readers merge the rest with
+  // FlushThreadLocalBuffers() or MergeThreadLocalBuffers().
   EXPORT void RecordAllocation(Thread* self, ObjPtr<mirror::Object>* obj, size_t byte_count)
       REQUIRES(!Locks::alloc_tracker_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
   static void SetAllocTrackingEnabled(bool enabled) REQUIRES(!Locks::alloc_tracker_lock_);
 
+  // Merge the pending records of all threads into the map, using a checkpoint. Records are
+  // dropped if allocation tracking is disabled.
+  static void FlushThreadLocalBuffers(Thread* self)
+      REQUIRES(!Locks::alloc_tracker_lock_, !Locks::thread_list_lock_);
+
+  // Same as above, for callers which have suspended all other threads.
+  void MergeThreadLocalBuffers(Thread* self)
+      REQUIRES(Locks::mutator_lock_, Locks::alloc_tracker_lock_);
+
+  // Merge the pending records of `thread` into the map. `self` is either `thread`, or the thread
+  // running a checkpoint on behalf of the suspended `thread`.
+  static void FlushThreadLocalBuffer(Thread* self, Thread* thread)
+      REQUIRES(!Locks::alloc_tracker_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Mean number of bytes between sampled allocations, zero if every allocation is recorded.
+  size_t GetSampleInterval() const {
+    return sample_interval_;
+  }
+
   AllocRecordObjectMap() REQUIRES(Locks::alloc_tracker_lock_);
   ~AllocRecordObjectMap();
 
-  void Put(mirror::Object* obj, AllocRecord&& record)
+  void Put(mirror::Object* obj,
+           size_t byte_count,
+           mirror::Class* klass,
+           AllocRecordStackTrace&& trace)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::alloc_tracker_lock_) {
     if (entries_.size() == alloc_record_max_) {
+      stack_traces_.Release(entries_.front().second.GetStackTrace());
       entries_.pop_front();
     }
-    entries_.push_back(EntryPair(GcRoot<mirror::Object>(obj), std::move(record)));
+    const AllocRecordStackTrace* interned_trace = stack_traces_.Intern(std::move(trace));
+    entries_.push_back(
+        EntryPair(GcRoot<mirror::Object>(obj), AllocRecord(byte_count, klass, interned_trace)));
   }
 
   size_t Size() const REQUIRES_SHARED(Locks::alloc_tracker_lock_) {
     return entries_.size();
   }
 
+  // Number of distinct stack traces of the records.
+  size_t GetNumStackTraces() const REQUIRES_SHARED(Locks::alloc_tracker_lock_) {
+    return stack_traces_.Size();
+  }
+
   size_t GetRecentAllocationSize() const REQUIRES_SHARED(Locks::alloc_tracker_lock_) {
     CHECK_LE(recent_record_max_, alloc_record_max_);
     size_t sz = entries_.size();
@@ -297,12 +388,86 @@ class AllocRecordObjectMap {
   size_t alloc_record_max_ GUARDED_BY(Locks::alloc_tracker_lock_) = kDefaultNumAllocRecords;
   size_t recent_record_max_ GUARDED_BY(Locks::alloc_tracker_lock_) = kDefaultNumRecentRecords;
   size_t max_stack_depth_ = kDefaultAllocStackDepth;
+  size_t sample_interval_ = 0;
   bool allow_new_record_ GUARDED_BY(Locks::alloc_tracker_lock_) = true;
   ConditionVariable new_record_condition_ GUARDED_BY(Locks::alloc_tracker_lock_);
   // see the comment in typedef of EntryList
   EntryList entries_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  // The stack traces of entries_.
+  AllocRecordStackTraceTable stack_traces_ GUARDED_BY(Locks::alloc_tracker_lock_);
 
   void SetMaxStackDepth(size_t max_stack_depth) REQUIRES(Locks::alloc_tracker_lock_);
+  void SetSampleInterval(size_t sample_interval) REQUIRES(Locks::alloc_tracker_lock_);
+  void MergeThreadLocalBufferLocked(AllocRecordThreadLocalBuffer* buffer)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::alloc_tracker_lock_);
+};
+
+// Allocation records of one thread that are not yet in the AllocRecordObjectMap, and the state of
+// the thread's allocation sampler. Only accessed by its thread, or on its behalf in a checkpoint.
+// The pending objects and classes are strong roots, visited as part of the thread's roots, which
+// keeps at most kCapacity recently allocated objects alive until the buffer is merged.
+class AllocRecordThreadLocalBuffer {
+ public:
+  static constexpr size_t kCapacity = 64;
+
+  AllocRecordThreadLocalBuffer(uint32_t seed, size_t sample_interval);
+
+  // Returns true if the allocation of `byte_count` bytes should be sampled. Sample points are
+  // Poisson distributed over the allocated bytes, i.e. the number of bytes between them follows
+  // an exponential distribution with a mean of `sample_interval`, so that allocations are
+  // sampled with a probability proportional to their size independently of allocation patterns.
+  bool ShouldSample(size_t byte_count, size_t sample_interval) {
+    if (LIKELY(bytes_until_sample_ > byte_count)) {
+      bytes_until_sample_ -= byte_count;
+      return false;
+    }
+    PickNextSample(sample_interval);
+    return true;
+  }
+
+  void Add(mirror::Object* obj,
+           size_t byte_count,
+           mirror::Class* klass,
+           AllocRecordStackTrace&& trace) REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(!IsFull());
+    entries_.push_back(Entry{GcRoot<mirror::Object>(obj),
+                             GcRoot<mirror::Class>(klass),
+                             byte_count,
+                             std::move(trace)});
+  }
+
+  bool IsFull() const {
+    return entries_.size() == kCapacity;
+  }
+
+  size_t Size() const {
+    return entries_.size();
+  }
+
+  void Clear() {
+    entries_.clear();
+  }
+
+  void VisitRoots(RootVisitor* visitor, uint32_t thread_id) REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  // A record not yet interned in the AllocRecordObjectMap.
+  struct Entry {
+    GcRoot<mirror::Object> obj;
+    GcRoot<mirror::Class> klass;
+    size_t byte_count;
+    AllocRecordStackTrace trace;
+  };
+
+  void PickNextSample(size_t sample_interval);
+
+  size_t bytes_until_sample_;
+  std::minstd_rand rng_;
+  std::vector<Entry> entries_;
+
+  friend class AllocRecordObjectMap;
+
+  DISALLOW_COPY_AND_ASSIGN(AllocRecordThreadLocalBuffer);
 };
 
 }  // namespace gc
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "allocation_record.h"
+
+#include "class_linker-inl.h"
+#include "common_runtime_test.h"
+#include "gc/heap.h"
+#include "handle_scope-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/object_array-alloc-inl.h"
+#include "mirror/object_array-inl.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art HIDDEN {
+namespace gc {
+
+class AllocationRecordTest : public CommonRuntimeTest {
+ protected:
+  AllocationRecordTest() {
+    use_boot_image_ = true;  // Make the Runtime creation cheaper.
+  }
+};
+
+TEST_F(AllocationRecordTest, SamplingRate) {
+  static constexpr size_t kSampleInterval = 4 * KB;
+  static constexpr size_t kAllocationSize = 48;
+  static constexpr size_t kNumAllocations = 1000000;
+  AllocRecordThreadLocalBuffer buffer(/*seed=*/ 1, kSampleInterval);
+  size_t num_samples = 0;
+  for (size_t i = 0; i < kNumAllocations; ++i) {
+    if (buffer.ShouldSample(kAllocationSize, kSampleInterval)) {
+      ++num_samples;
+    }
+  }
+  const double expected = static_cast<double>(kNumAllocations * kAllocationSize) / kSampleInterval;
+  EXPECT_NEAR(static_cast<double>(num_samples), expected, expected * 0.05);
+
+  // Allocations larger than the interval are almost always sampled.
+  num_samples = 0;
+  for (size_t i = 0; i < 1000; ++i) {
+    if (buffer.ShouldSample(64 * kSampleInterval, kSampleInterval)) {
+      ++num_samples;
+    }
+  }
+  EXPECT_GE(num_samples, 990u);
+}
+
+TEST_F(AllocationRecordTest, StackTraceTable) {
+  ArtMethod* const kMethod1 = reinterpret_cast<ArtMethod*>(0x1000);
+  ArtMethod* const kMethod2 = reinterpret_cast<ArtMethod*>(0x2000);
+  auto make_trace = [](pid_t tid, std::initializer_list<AllocRecordStackTraceElement> frames) {
+    AllocRecordStackTrace trace;
+    trace.SetTid(tid);
+    for (const AllocRecordStackTraceElement& frame : frames) {
+      trace.AddStackElement(frame);
+    }
+    return trace;
+  };
+  AllocRecordStackTraceTable table;
+  const AllocRecordStackTrace* a =
+      table.Intern(make_trace(1, {{kMethod1, 3u}, {kMethod2, 7u}}));
+  const AllocRecordStackTrace* b =
+      table.Intern(make_trace(1, {{kMethod1, 3u}, {kMethod2, 7u}}));
+  const AllocRecordStackTrace* c =
+      table.Intern(make_trace(1, {{kMethod1, 4u}, {kMethod2, 7u}}));
+  const AllocRecordStackTrace* d =
+      table.Intern(make_trace(2, {{kMethod1, 3u}, {kMethod2, 7u}}));
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_NE(a, d);
+  EXPECT_EQ(table.Size(), 3u);
+  EXPECT_EQ(a->GetDepth(), 2u);
+  EXPECT_EQ(a->GetStackElement(1).GetDexPc(), 7u);
+
+  table.Release(a);
+  EXPECT_EQ(table.Size(), 3u);
+  table.Release(b);
+  EXPECT_EQ(table.Size(), 2u);
+  // A released trace is recreated on demand.
+  const AllocRecordStackTrace* e =
+      table.Intern(make_trace(1, {{kMethod1, 3u}, {kMethod2, 7u}}));
+  EXPECT_EQ(table.Size(), 3u);
+  EXPECT_EQ(e->GetStackElement(0).GetMethod(), kMethod1);
+  table.Release(c);
+  table.Release(d);
+  table.Release(e);
+  EXPECT_EQ(table.Size(), 0u);
+}
+
+TEST_F(AllocationRecordTest, SampledTracking) {
+  static constexpr size_t kNumAllocations = 20000;
+  Thread* self = Thread::Current();
+  Heap* heap = Runtime::Current()->GetHeap();
+  heap->SetAllocTrackerSampleInterval(4 * KB);
+  AllocRecordObjectMap::SetAllocTrackingEnabled(true);
+  {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<1> hs(self);
+    Handle<mirror::Class> c(
+        hs.NewHandle(class_linker_->FindSystemClass(self, "[Ljava/lang/Object;")));
+    for (size_t i = 0; i < kNumAllocations; ++i) {
+      ASSERT_TRUE(mirror::ObjectArray<mirror::Object>::Alloc(self, c.Get(), 4) != nullptr);
+    }
+    ASSERT_TRUE(self->GetAllocRecordBuffer() != nullptr);
+    EXPECT_LT(self->GetAllocRecordBuffer()->Size(), AllocRecordThreadLocalBuffer::kCapacity);
+  }
+  AllocRecordObjectMap::FlushThreadLocalBuffers(self);
+  {
+    ScopedObjectAccess soa(self);
+    EXPECT_EQ(self->GetAllocRecordBuffer()->Size(), 0u);
+    MutexLock mu(self, *Locks::alloc_tracker_lock_);
+    AllocRecordObjectMap* records = heap->GetAllocationRecords();
+    EXPECT_EQ(records->GetSampleInterval(), 4 * KB);
+    EXPECT_GT(records->Size(), 0u);
+    EXPECT_LT(records->Size(), kNumAllocations / 4);
+    // All the allocations come from the same stack.
+    EXPECT_EQ(records->GetNumStackTraces(), 1u);
+  }
+  AllocRecordObjectMap::SetAllocTrackingEnabled(false);
+  heap->SetAllocTrackerSampleInterval(0);
+}
+
+}  // namespace gc
+}  // namespace art
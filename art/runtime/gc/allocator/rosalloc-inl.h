@@ -101,6 +101,14 @@ inline void* RosAlloc::AllocFromThreadLocalRun(Thread* self, size_t size,
 
 inline size_t RosAlloc::MaxBytesBulkAllocatedFor(size_t size) {
   if (UNLIKELY(!IsSizeForThreadLocal(size))) {
+    if (size <= kLargeSizeThreshold) {
+      size_t bracket_size;
+      size_t idx = SizeToIndexAndBracketSize(size, &bracket_size);
+      if (IsMagazineSizeBracket(idx)) {
+        // A magazine refill.
+        return (kMagazineCapacity + 1) * bracket_size;
+      }
+    }
     return size;
   }
   size_t bracket_size;
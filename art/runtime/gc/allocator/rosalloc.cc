@@ -18,6 +18,7 @@
 
 #include <list>
 #include <map>
+#include <optional>
 #include <sstream>
 #include <vector>
 
@@ -733,6 +734,18 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
     }
     *bytes_allocated = bracket_size;
     *usable_size = bracket_size;
+  } else if (IsMagazineSizeBracket(idx)) {
+    slot_addr = AllocFromMagazine(self, idx, bytes_tl_bulk_allocated);
+    if (kTraceRosAlloc) {
+      LOG(INFO) << "RosAlloc::AllocFromRun() magazine : 0x" << std::hex
+                << reinterpret_cast<intptr_t>(slot_addr)
+                << "-0x" << (reinterpret_cast<intptr_t>(slot_addr) + bracket_size)
+                << "(" << std::dec << (bracket_size) << ")";
+    }
+    if (LIKELY(slot_addr != nullptr)) {
+      *bytes_allocated = bracket_size;
+      *usable_size = bracket_size;
+    }
   } else {
     // Use the (shared) current run.
     MutexLock mu(self, *size_bracket_locks_[idx]);
@@ -753,6 +766,57 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
   return slot_addr;
 }
 
+void* RosAlloc::AllocFromMagazine(Thread* self, size_t idx, size_t* bytes_tl_bulk_allocated) {
+  DCHECK(IsMagazineSizeBracket(idx));
+  const size_t magazine_idx = idx - kNumThreadLocalSizeBrackets;
+  void** magazine = self->GetRosAllocMagazine(magazine_idx);
+  size_t magazine_size = self->GetRosAllocMagazineSize(magazine_idx);
+  if (LIKELY(magazine_size != 0)) {
+    // The slot was counted when the magazine was refilled.
+    --magazine_size;
+    self->SetRosAllocMagazineSize(magazine_idx, magazine_size);
+    *bytes_tl_bulk_allocated = 0;
+    return magazine[magazine_size];
+  }
+  MutexLock mu(self, *size_bracket_locks_[idx]);
+  void* slot_addr = AllocFromCurrentRunUnlocked(self, idx);
+  if (UNLIKELY(slot_addr == nullptr)) {
+    return nullptr;
+  }
+  // Only take the slots left in the current run so that a refill never allocates a new run.
+  Run* current_run = current_runs_[idx];
+  while (magazine_size < kMagazineCapacity) {
+    void* extra_slot = current_run->AllocSlot();
+    if (extra_slot == nullptr) {
+      break;
+    }
+    magazine[magazine_size++] = extra_slot;
+  }
+  self->SetRosAllocMagazineSize(magazine_idx, magazine_size);
+  // Account for the cached slots ahead of time, like for thread-local runs.
+  *bytes_tl_bulk_allocated = (magazine_size + 1) * bracketSizes[idx];
+  return slot_addr;
+}
+
+std::unordered_set<void*> RosAlloc::GetMagazineSlots(Thread* self) {
+  std::unordered_set<void*> magazine_slots;
+  if (!kUseMagazines) {
+    return magazine_slots;
+  }
+  // Callers that suspended all threads may already hold the thread list lock.
+  std::optional<MutexLock> mu;
+  if (!Locks::thread_list_lock_->IsExclusiveHeld(self)) {
+    mu.emplace(self, *Locks::thread_list_lock_);
+  }
+  for (Thread* thread : Runtime::Current()->GetThreadList()->GetList()) {
+    for (size_t i = 0; i < kNumMagazineSizeBrackets; ++i) {
+      void** magazine = thread->GetRosAllocMagazine(i);
+      magazine_slots.insert(magazine, magazine + thread->GetRosAllocMagazineSize(i));
+    }
+  }
+  return magazine_slots;
+}
+
 size_t RosAlloc::FreeFromRun(Thread* self, void* ptr, Run* run) {
   DCHECK_EQ(run->magic_num_, kMagicNum);
   DCHECK_LT(run, ptr);
@@ -962,7 +1026,7 @@ inline void RosAlloc::Run::ZeroData() {
 }
 
 void RosAlloc::Run::InspectAllSlots(void (*handler)(void* start, void* end, size_t used_bytes, void* callback_arg),
-                                    void* arg) {
+                                    void* arg, const std::unordered_set<void*>& magazine_slots) {
   size_t idx = size_bracket_idx_;
   uint8_t* slot_base = reinterpret_cast<uint8_t*>(this) + headerSizes[idx];
   size_t num_slots = numOfSlots[idx];
@@ -986,7 +1050,7 @@ void RosAlloc::Run::InspectAllSlots(void (*handler)(void* start, void* end, size
   }
   for (size_t slot_idx = 0; slot_idx < num_slots; ++slot_idx) {
     uint8_t* slot_addr = slot_base + slot_idx * bracket_size;
-    if (!is_free[slot_idx]) {
+    if (!is_free[slot_idx] && magazine_slots.find(slot_addr) == magazine_slots.end()) {
       handler(slot_addr, slot_addr + bracket_size, bracket_size, arg);
     } else {
       handler(slot_addr, slot_addr + bracket_size, 0, arg);
@@ -1397,6 +1461,8 @@ void RosAlloc::InspectAll(void (*handler)(void* start, void* end, size_t used_by
   if (handler == nullptr) {
     return;
   }
+  // Slots cached in the magazines aren't allocated objects.
+  const std::unordered_set<void*> magazine_slots = GetMagazineSlots(Thread::Current());
   MutexLock mu(Thread::Current(), lock_);
   size_t pm_end = page_map_size_;
   size_t i = 0;
@@ -1459,7 +1525,7 @@ void RosAlloc::InspectAll(void (*handler)(void* start, void* end, size_t used_by
         DCHECK_EQ(run->magic_num_, kMagicNum);
         // The dedicated full run doesn't contain any real allocations, don't visit the slots in
         // there.
-        run->InspectAllSlots(handler, arg);
+        run->InspectAllSlots(handler, arg, magazine_slots);
         size_t num_pages = numOfPages[run->size_bracket_idx_];
         if (kIsDebugBuild) {
           for (size_t j = i + 1; j < i + num_pages; ++j) {
@@ -1531,6 +1597,18 @@ size_t RosAlloc::RevokeThreadLocalRuns(Thread* thread) {
       RevokeRun(self, idx, thread_local_run);
     }
   }
+  if (kUseMagazines) {
+    // Return the cached slots to their runs. Avoid racing with BulkFree() like Free() does.
+    ReaderMutexLock rmu(self, bulk_free_lock_);
+    for (size_t i = 0; i < kNumMagazineSizeBrackets; ++i) {
+      void** magazine = thread->GetRosAllocMagazine(i);
+      const size_t magazine_size = thread->GetRosAllocMagazineSize(i);
+      thread->SetRosAllocMagazineSize(i, 0);
+      for (size_t j = 0; j < magazine_size; ++j) {
+        free_bytes += FreeInternal(self, magazine[j]);
+      }
+    }
+  }
   return free_bytes;
 }
 
@@ -1598,6 +1676,9 @@ void RosAlloc::AssertThreadLocalRunsAreRevoked(Thread* thread) {
       Run* thread_local_run = reinterpret_cast<Run*>(thread->GetRosAllocRun(idx));
       DCHECK(thread_local_run == nullptr || thread_local_run == dedicated_full_run_);
     }
+    for (size_t i = 0; i < kNumMagazineSizeBrackets; ++i) {
+      DCHECK_EQ(thread->GetRosAllocMagazineSize(i), 0u);
+    }
   }
 }
 
@@ -1858,12 +1939,16 @@ void RosAlloc::Verify() {
     }
   }
   // Call Verify() here for the lock order.
+  const std::unordered_set<void*> magazine_slots = GetMagazineSlots(self);
   for (auto& run : runs) {
-    run->Verify(self, this, is_running_on_memory_tool_);
+    run->Verify(self, this, is_running_on_memory_tool_, magazine_slots);
   }
 }
 
-void RosAlloc::Run::Verify(Thread* self, RosAlloc* rosalloc, bool running_on_memory_tool) {
+void RosAlloc::Run::Verify(Thread* self,
+                           RosAlloc* rosalloc,
+                           bool running_on_memory_tool,
+                           const std::unordered_set<void*>& magazine_slots) {
   DCHECK_EQ(magic_num_, kMagicNum) << "Bad magic number : " << Dump();
   const size_t idx = size_bracket_idx_;
   CHECK_LT(idx, kNumOfSizeBrackets) << "Out of range size bracket index : " << Dump();
@@ -1958,10 +2043,11 @@ void RosAlloc::Run::Verify(Thread* self, RosAlloc* rosalloc, bool running_on_mem
   }
   for (size_t slot_idx = 0; slot_idx < num_slots; ++slot_idx) {
     uint8_t* slot_addr = slot_base + slot_idx * bracket_size;
+    const bool is_cached = magazine_slots.find(slot_addr) != magazine_slots.end();
     if (running_on_memory_tool) {
       slot_addr += ::art::gc::space::kDefaultMemoryToolRedZoneBytes;
     }
-    if (!is_free[slot_idx]) {
+    if (!is_free[slot_idx] && !is_cached) {
       // The slot is allocated
       mirror::Object* obj = reinterpret_cast<mirror::Object*>(slot_addr);
       size_t obj_size = obj->SizeOf();
@@ -447,11 +447,16 @@ class RosAlloc {
     // Zero the run's header and the slot headers.
     void ZeroHeaderAndSlotHeaders();
     // Iterate over all the slots and apply the given function.
-    void InspectAllSlots(void (*handler)(void* start, void* end, size_t used_bytes, void* callback_arg), void* arg);
+    // Slots in magazine_slots are reported as free.
+    void InspectAllSlots(void (*handler)(void* start, void* end, size_t used_bytes, void* callback_arg), void* arg,
+                         const std::unordered_set<void*>& magazine_slots);
     // Dump the run metadata for debugging.
     std::string Dump();
     // Verify for debugging.
-    void Verify(Thread* self, RosAlloc* rosalloc, bool running_on_memory_tool)
+    void Verify(Thread* self,
+                RosAlloc* rosalloc,
+                bool running_on_memory_tool,
+                const std::unordered_set<void*>& magazine_slots)
         REQUIRES(Locks::mutator_lock_)
         REQUIRES(Locks::thread_list_lock_);
 
@@ -669,6 +674,21 @@ class RosAlloc {
   // This should be equal to bracketSizes[kNumThreadLocalSizeBrackets - 1].
   static constexpr size_t kMaxThreadLocalBracketSize = 128;
 
+  // For the size brackets right above the thread-local ones, each thread caches a small magazine
+  // of slots carved out of the shared current run, so that only one in kMagazineCapacity + 1
+  // allocations takes the bracket lock. Unlike thread-local runs, this bounds the per-thread
+  // footprint to kMagazineCapacity slots per bracket. The magazines are flushed with the
+  // thread-local runs.
+  static constexpr bool kUseMagazines = true;
+  // Sync these with the size of Thread::rosalloc_magazine_slots_.
+  static constexpr size_t kNumMagazineSizeBrackets = 8;
+  static constexpr size_t kMagazineCapacity = 8;
+  static_assert(kNumMagazineSizeBrackets == kNumRosAllocMagazineSizeBracketsInThread,
+                "Mismatch between kNumMagazineSizeBrackets and "
+                "kNumRosAllocMagazineSizeBracketsInThread");
+  static_assert(kMagazineCapacity == kRosAllocMagazineCapacityInThread,
+                "Mismatch between kMagazineCapacity and kRosAllocMagazineCapacityInThread");
+
   // We use regular (8 or 16-bytes increment) runs for the size brackets whose indexes are less than
   // this index.
   static const size_t kNumRegularSizeBrackets = 40;
@@ -792,6 +812,17 @@ class RosAlloc {
                                  size_t* usable_size, size_t* bytes_tl_bulk_allocated)
       REQUIRES(!lock_);
   void* AllocFromCurrentRunUnlocked(Thread* self, size_t idx) REQUIRES(!lock_);
+  // Allocates a slot from the thread's magazine for the size bracket, refilling the magazine
+  // from the current run if it's empty.
+  void* AllocFromMagazine(Thread* self, size_t idx, size_t* bytes_tl_bulk_allocated)
+      REQUIRES(!lock_);
+  static bool IsMagazineSizeBracket(size_t idx) {
+    return kUseMagazines && idx >= kNumThreadLocalSizeBrackets &&
+        idx < kNumThreadLocalSizeBrackets + kNumMagazineSizeBrackets;
+  }
+  // Returns the slots cached in the magazines of all threads. Only meaningful if the mutators are
+  // suspended.
+  std::unordered_set<void*> GetMagazineSlots(Thread* self) REQUIRES(!lock_);
 
   // Returns the bracket size.
   size_t FreeFromRun(Thread* self, void* ptr, Run* run)
@@ -362,10 +362,12 @@ void ConcurrentCopying::BindBitmaps() {
         }
         if (young_gen_) {
           // Age all of the cards for the region space so that we know which evac regions to scan.
-          heap_->GetCardTable()->ModifyCardsAtomic(space->Begin(),
-                                                   space->End(),
-                                                   AgeCardVisitor(),
-                                                   VoidFunctor());
+          heap_->GetCardTable()->ModifyCardsAtomicParallel(self,
+                                                           heap_->GetThreadPool(),
+                                                           space->Begin(),
+                                                           space->End(),
+                                                           AgeCardVisitor(),
+                                                           VoidFunctor());
         } else {
           // In a full-heap GC cycle, the card-table corresponding to region-space and
           // non-moving space can be cleared, because this cycle only needs to
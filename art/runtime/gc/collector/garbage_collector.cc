@@ -84,6 +84,26 @@ void TraceGCMetric(const char* name, int64_t value) {
   ATraceIntegerValue(name, value);
 }
 
+// Report the durations of the top level phases of a GC iteration via the ATrace interface, one
+// counter per phase. Nested phases are already visible as slices.
+void TraceGCPhases(const TimingLogger& timings) {
+  const std::vector<TimingLogger::Timing>& splits = timings.GetTimings();
+  TimingLogger::TimingData timing_data = timings.CalculateTimingData();
+  size_t depth = 0;
+  for (size_t i = 0; i < splits.size(); ++i) {
+    if (splits[i].IsEndTiming()) {
+      DCHECK_NE(depth, 0u);
+      --depth;
+      continue;
+    }
+    if (depth == 0) {
+      std::string counter_name = std::string("gc_phase_us ") + splits[i].GetName();
+      TraceGCMetric(counter_name.c_str(), NsToUs(timing_data.GetTotalTime(i)));
+    }
+    ++depth;
+  }
+}
+
 }  // namespace
 
 Iteration::Iteration()
@@ -136,6 +156,11 @@ GarbageCollector::GarbageCollector(Heap* heap, const std::string& name)
 
 void GarbageCollector::RegisterPause(uint64_t nano_length) {
   GetCurrentIteration()->pause_times_.push_back(nano_length);
+  if (UNLIKELY(ATraceEnabled())) {
+    // Report each pause as a spike at its end, so that it lines up with the frames it delayed.
+    TraceGCMetric("gc_pause_us", NsToUs(nano_length));
+    TraceGCMetric("gc_pause_us", 0);
+  }
 }
 
 uint64_t GarbageCollector::ExtractRssFromMincore(
@@ -228,12 +253,15 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   }
   total_time_ns_ += duration_ns;
   uint64_t total_pause_time_ns = 0;
+  uint64_t max_pause_time_ns = 0;
+  metrics::ArtMetrics* metrics = runtime->GetMetrics();
   for (uint64_t pause_time : current_iteration->GetPauseTimes()) {
     MutexLock mu(self, pause_histogram_lock_);
     pause_histogram_.AdjustAndAddValue(pause_time);
     total_pause_time_ns += pause_time;
+    max_pause_time_ns = std::max(max_pause_time_ns, pause_time);
+    metrics->GcPauseTime()->Add(static_cast<int64_t>(pause_time / 1'000));
   }
-  metrics::ArtMetrics* metrics = runtime->GetMetrics();
   // Report STW pause time in microseconds.
   const uint64_t total_pause_time_us = total_pause_time_ns / 1'000;
   metrics->WorldStopTimeDuringGCAvg()->Add(total_pause_time_us);
@@ -274,6 +302,16 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   TraceGCMetric("freed_normal_object_bytes", current_iteration->GetFreedBytes());
   TraceGCMetric("freed_large_object_bytes", current_iteration->GetFreedLargeObjectBytes());
   TraceGCMetric("freed_bytes", freed_bytes);
+  if (UNLIKELY(ATraceEnabled())) {
+    TraceGCMetric("freed_objects", current_iteration->GetFreedObjects());
+    TraceGCMetric("freed_large_objects", current_iteration->GetFreedLargeObjects());
+    TraceGCMetric("scanned_bytes", current_iteration->GetScannedBytes());
+    TraceGCMetric("gc_duration_us", NsToUs(duration_ns));
+    TraceGCMetric("gc_pause_count", current_iteration->GetPauseTimes().size());
+    TraceGCMetric("gc_pause_total_us", NsToUs(total_pause_time_ns));
+    TraceGCMetric("gc_pause_max_us", NsToUs(max_pause_time_ns));
+    TraceGCPhases(*GetTimings());
+  }
 
   is_transaction_active_ = false;
 }
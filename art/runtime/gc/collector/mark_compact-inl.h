@@ -37,9 +37,16 @@ inline void MarkCompact::UpdateClassAfterObjectMap(mirror::Object* obj) {
   }
 }
 
-template <size_t kAlignment>
+template <size_t kAlignment> template <bool kAtomic>
 inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_t begin,
                                                                         size_t size) {
+  auto set_bits = [](uintptr_t* word, uintptr_t bits) {
+    if (kAtomic) {
+      reinterpret_cast<std::atomic<uintptr_t>*>(word)->fetch_or(bits, std::memory_order_relaxed);
+    } else {
+      *word |= bits;
+    }
+  };
   const uintptr_t begin_bit_idx = MemRangeBitmap::BitIndexFromAddr(begin);
   DCHECK(!Bitmap::TestBit(begin_bit_idx));
   // Range to set bit: [begin, end]
@@ -52,18 +59,19 @@ inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_
   // Bits that needs to be set in the first word, if it's not also the last word
   mask = ~(mask - 1);
   if (diff > 0) {
-    *begin_bm_address |= mask;
+    set_bits(begin_bm_address, mask);
     mask = ~0;
     // Even though memset can handle the (diff == 1) case but we should avoid the
     // overhead of a function call for this, highly likely (as most of the objects
     // are small), case.
     if (diff > 1) {
-      // Set all intermediate bits to 1.
+      // Set all intermediate bits to 1. These words are exclusively covered by
+      // this object, so no atomicity is required.
       std::memset(static_cast<void*>(begin_bm_address + 1), 0xff, (diff - 1) * sizeof(uintptr_t));
     }
   }
   uintptr_t end_mask = Bitmap::BitIndexToMask(end_bit_idx);
-  *end_bm_address |= mask & (end_mask | (end_mask - 1));
+  set_bits(end_bm_address, mask & (end_mask | (end_mask - 1)));
   return begin_bit_idx;
 }
 
@@ -201,10 +209,10 @@ inline bool MarkCompact::IsOnAllocStack(mirror::Object* ref) {
   return stack->Contains(ref);
 }
 
-inline void MarkCompact::UpdateRef(mirror::Object* obj,
-                                   MemberOffset offset,
-                                   uint8_t* begin,
-                                   uint8_t* end) {
+inline mirror::Object* MarkCompact::UpdateRef(mirror::Object* obj,
+                                              MemberOffset offset,
+                                              uint8_t* begin,
+                                              uint8_t* end) {
   mirror::Object* old_ref = obj->GetFieldObject<
       mirror::Object, kVerifyNone, kWithoutReadBarrier, /*kIsVolatile*/false>(offset);
   if (kIsDebugBuild) {
@@ -240,6 +248,7 @@ inline void MarkCompact::UpdateRef(mirror::Object* obj,
             offset,
             new_ref);
   }
+  return new_ref;
 }
 
 inline bool MarkCompact::VerifyRootSingleUpdate(void* root,
@@ -279,7 +288,9 @@ inline bool MarkCompact::VerifyRootSingleUpdate(void* root,
                         << oss.str();
       }
     }
+    // Old-generation objects are not recorded in the live-words bitmap.
     DCHECK(reinterpret_cast<uint8_t*>(old_ref) >= black_allocations_begin_ ||
+           reinterpret_cast<uint8_t*>(old_ref) < old_gen_end_ ||
            live_words_bitmap_->Test(old_ref))
         << "ref=" << old_ref << " <" << mirror::Object::PrettyTypeOf(old_ref) << "> RootInfo ["
         << info << "]";
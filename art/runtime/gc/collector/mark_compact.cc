@@ -45,6 +45,7 @@
 #include "base/systrace.h"
 #include "base/utils.h"
 #include "gc/accounting/mod_union_table-inl.h"
+#include "gc/accounting/work_stealing_stack.h"
 #include "gc/collector_type.h"
 #include "gc/reference_processor.h"
 #include "gc/space/bump_pointer_space.h"
@@ -57,6 +58,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "sigchain.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 
 #ifdef ART_TARGET_ANDROID
 #include "android-modules-utils/sdk_level.h"
@@ -330,6 +332,15 @@ static constexpr bool kVerifyRootsMarked = kIsDebugBuild;
 // of mutator threads trying to access the moving-space during one compaction
 // phase.
 static constexpr size_t kMutatorCompactionBufferCount = 2048;
+// Number of to-space pages claimed by a compaction worker in one go. Kept small
+// so that workers and gc-thread don't end up contending over the last chunk.
+static constexpr size_t kCompactionWorkerChunkPages = 8;
+// Capacity of each thread's work-stealing stack during parallel marking.
+// Objects which don't fit are kept in a thread-local overflow vector.
+static constexpr size_t kParallelMarkStackSize = 4 * KB;
+// Number of objects claimed at once from the shared mark-stack by a parallel
+// marking thread.
+static constexpr size_t kParallelMarkStackChunkSize = 128;
 // Minimum from-space chunk to be madvised (during concurrent compaction) in one go.
 // Choose a reasonable size to avoid making too many batched ioctl and madvise calls.
 static constexpr ssize_t kMinFromSpaceMadviseSize = 8 * MB;
@@ -438,7 +449,7 @@ size_t MarkCompact::InitializeInfoMap(uint8_t* p, size_t moving_space_sz) {
   return total;
 }
 
-MarkCompact::MarkCompact(Heap* heap)
+MarkCompact::MarkCompact(Heap* heap, bool use_generational)
     : GarbageCollector(heap, "concurrent mark compact"),
       gc_barrier_(0),
       lock_("mark compact lock", kGenericBottomLock),
@@ -447,9 +458,14 @@ MarkCompact::MarkCompact(Heap* heap)
       moving_space_begin_(bump_pointer_space_->Begin()),
       moving_space_end_(bump_pointer_space_->Limit()),
       black_dense_end_(moving_space_begin_),
+      old_gen_end_(moving_space_begin_),
+      old_gen_objects_(0),
+      young_gc_count_(0),
       uffd_(kFdUnused),
       sigbus_in_progress_count_{kSigbusCounterCompactionDoneMask, kSigbusCounterCompactionDoneMask},
       compacting_(false),
+      use_generational_(use_generational),
+      young_gen_(false),
       marking_done_(false),
       uffd_initialized_(false),
       clamp_info_map_status_(ClampInfoStatus::kClampInfoNotDone) {
@@ -523,24 +539,52 @@ MarkCompact::MarkCompact(Heap* heap)
   linear_alloc_spaces_data_.reserve(1);
 
   // Initialize GC metrics.
-  metrics::ArtMetrics* metrics = GetMetrics();
-  // The mark-compact collector supports only full-heap collections at the moment.
-  gc_time_histogram_ = metrics->FullGcCollectionTime();
-  metrics_gc_count_ = metrics->FullGcCount();
-  metrics_gc_count_delta_ = metrics->FullGcCountDelta();
-  gc_throughput_histogram_ = metrics->FullGcThroughput();
-  gc_tracing_throughput_hist_ = metrics->FullGcTracingThroughput();
-  gc_throughput_avg_ = metrics->FullGcThroughputAvg();
-  gc_tracing_throughput_avg_ = metrics->FullGcTracingThroughputAvg();
-  gc_scanned_bytes_ = metrics->FullGcScannedBytes();
-  gc_scanned_bytes_delta_ = metrics->FullGcScannedBytesDelta();
-  gc_freed_bytes_ = metrics->FullGcFreedBytes();
-  gc_freed_bytes_delta_ = metrics->FullGcFreedBytesDelta();
-  gc_duration_ = metrics->FullGcDuration();
-  gc_duration_delta_ = metrics->FullGcDurationDelta();
+  SetYoungGen(/*young_gen=*/false);
   are_metrics_initialized_ = true;
 }
 
+MarkCompact::~MarkCompact() {}
+
+void MarkCompact::SetYoungGen(bool young_gen) {
+  // A young cycle requires an old generation established by a preceding cycle.
+  // Zygote performs only full collections as its heap is compacted into the
+  // zygote space at fork.
+  young_gen_ = young_gen && use_generational_ && old_gen_end_ > moving_space_begin_ &&
+               !Runtime::Current()->IsZygote();
+  // The same collector instance performs both young and full cycles. Point
+  // the metrics at the ones corresponding to the upcoming cycle.
+  metrics::ArtMetrics* metrics = GetMetrics();
+  if (young_gen_) {
+    gc_time_histogram_ = metrics->YoungGcCollectionTime();
+    metrics_gc_count_ = metrics->YoungGcCount();
+    metrics_gc_count_delta_ = metrics->YoungGcCountDelta();
+    gc_throughput_histogram_ = metrics->YoungGcThroughput();
+    gc_tracing_throughput_hist_ = metrics->YoungGcTracingThroughput();
+    gc_throughput_avg_ = metrics->YoungGcThroughputAvg();
+    gc_tracing_throughput_avg_ = metrics->YoungGcTracingThroughputAvg();
+    gc_scanned_bytes_ = metrics->YoungGcScannedBytes();
+    gc_scanned_bytes_delta_ = metrics->YoungGcScannedBytesDelta();
+    gc_freed_bytes_ = metrics->YoungGcFreedBytes();
+    gc_freed_bytes_delta_ = metrics->YoungGcFreedBytesDelta();
+    gc_duration_ = metrics->YoungGcDuration();
+    gc_duration_delta_ = metrics->YoungGcDurationDelta();
+  } else {
+    gc_time_histogram_ = metrics->FullGcCollectionTime();
+    metrics_gc_count_ = metrics->FullGcCount();
+    metrics_gc_count_delta_ = metrics->FullGcCountDelta();
+    gc_throughput_histogram_ = metrics->FullGcThroughput();
+    gc_tracing_throughput_hist_ = metrics->FullGcTracingThroughput();
+    gc_throughput_avg_ = metrics->FullGcThroughputAvg();
+    gc_tracing_throughput_avg_ = metrics->FullGcTracingThroughputAvg();
+    gc_scanned_bytes_ = metrics->FullGcScannedBytes();
+    gc_scanned_bytes_delta_ = metrics->FullGcScannedBytesDelta();
+    gc_freed_bytes_ = metrics->FullGcFreedBytes();
+    gc_freed_bytes_delta_ = metrics->FullGcFreedBytesDelta();
+    gc_duration_ = metrics->FullGcDuration();
+    gc_duration_delta_ = metrics->FullGcDurationDelta();
+  }
+}
+
 void MarkCompact::AddLinearAllocSpaceData(uint8_t* begin, size_t len) {
   DCHECK_ALIGNED_PARAM(begin, gPageSize);
   DCHECK_ALIGNED_PARAM(len, gPageSize);
@@ -642,6 +686,27 @@ void MarkCompact::PrepareCardTableForMarking(bool clear_alloc_space_cards) {
             },
             /* card modified visitor */ VoidFunctor());
       }
+    } else if (clear_alloc_space_cards && young_gen_) {
+      CHECK(!space->IsZygoteSpace());
+      CHECK(!space->IsImageSpace());
+      // In a young cycle, the old generation of moving space and the entire
+      // non-moving space are not traced. Age their cards so that the objects
+      // referring to young objects get scanned in ScanOldGenObjects(), while
+      // mutations during marking get recorded as dirty cards.
+      card_table->ModifyCardsAtomicParallel(Thread::Current(),
+                                            heap_->GetThreadPool(),
+                                            space->Begin(),
+                                            space->End(),
+                                            AgeCardVisitor(),
+                                            /* card modified visitor */ VoidFunctor());
+      if (space != bump_pointer_space_) {
+        CHECK_EQ(space, heap_->GetNonMovingSpace());
+        DCHECK_EQ(space->GetGcRetentionPolicy(), space::kGcRetentionPolicyAlwaysCollect);
+        // Treat all the live objects as marked so that they are not swept.
+        space->AsContinuousMemMapAllocSpace()->BindLiveToMarkBitmap();
+        non_moving_space_ = space;
+        non_moving_space_bitmap_ = space->GetMarkBitmap();
+      }
     } else if (clear_alloc_space_cards) {
       CHECK(!space->IsZygoteSpace());
       CHECK(!space->IsImageSpace());
@@ -667,6 +732,13 @@ void MarkCompact::PrepareCardTableForMarking(bool clear_alloc_space_cards) {
           /* card modified visitor */ VoidFunctor());
     }
   }
+  if (clear_alloc_space_cards && young_gen_) {
+    // Large objects which survived the previous cycle are considered old.
+    for (const auto& space : GetHeap()->GetDiscontinuousSpaces()) {
+      CHECK(space->IsLargeObjectSpace());
+      space->AsLargeObjectSpace()->CopyLiveToMarked();
+    }
+  }
 }
 
 void MarkCompact::MarkZygoteLargeObjects() {
@@ -703,14 +775,25 @@ void MarkCompact::InitializePhase() {
   freed_objects_ = 0;
   // The first buffer is used by gc-thread.
   compaction_buffer_counter_.store(1, std::memory_order_relaxed);
+  compaction_worker_page_idx_.store(0, std::memory_order_relaxed);
   black_allocations_begin_ = bump_pointer_space_->Limit();
   DCHECK_EQ(moving_space_begin_, bump_pointer_space_->Begin());
   from_space_slide_diff_ = from_space_begin_ - moving_space_begin_;
   moving_space_end_ = bump_pointer_space_->Limit();
-  if (black_dense_end_ > moving_space_begin_) {
-    moving_space_bitmap_->Clear();
+  if (young_gen_) {
+    // Retain the mark-bits of the old generation. They were exclusively set
+    // for old-generation objects in the previous cycle's FinishPhase().
+    DCHECK_GT(old_gen_end_, moving_space_begin_);
+    DCHECK_LE(old_gen_end_, moving_space_end_);
+    black_dense_end_ = old_gen_end_;
+  } else {
+    if (black_dense_end_ > moving_space_begin_) {
+      moving_space_bitmap_->Clear();
+    }
+    black_dense_end_ = moving_space_begin_;
+    old_gen_end_ = moving_space_begin_;
+    old_gen_objects_ = 0;
   }
-  black_dense_end_ = moving_space_begin_;
   // TODO: Would it suffice to read it once in the constructor, which is called
   // in zygote process?
   pointer_size_ = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
@@ -753,6 +836,7 @@ void MarkCompact::RunPhases() {
   Thread* self = Thread::Current();
   thread_running_gc_ = self;
   Runtime* runtime = Runtime::Current();
+  MaybeCreateCompactionThreadPool(self);
   InitializePhase();
   GetHeap()->PreGcVerification(this);
   {
@@ -967,19 +1051,24 @@ bool MarkCompact::PrepareForCompaction() {
   // of the corresponding chunk. For old-to-new address computation we need
   // every element to reflect total live-bytes till the corresponding chunk.
 
-  size_t black_dense_idx = 0;
+  // In a young cycle the old generation is never compacted. Its chunks don't
+  // have live-bytes computed, so the black-dense region search starts after it.
+  const size_t old_gen_idx = (old_gen_end_ - moving_space_begin_) / kOffsetChunkSize;
+  DCHECK(young_gen_ || old_gen_idx == 0);
+  DCHECK_ALIGNED_PARAM(old_gen_end_, gPageSize);
+  size_t black_dense_idx = old_gen_idx;
   GcCause gc_cause = GetCurrentIteration()->GetGcCause();
-  if (gc_cause != kGcCauseExplicit && gc_cause != kGcCauseCollectorTransition &&
-      !GetCurrentIteration()->GetClearSoftReferences()) {
+  if (young_gen_ || (gc_cause != kGcCauseExplicit && gc_cause != kGcCauseCollectorTransition &&
+                     !GetCurrentIteration()->GetClearSoftReferences())) {
     uint64_t live_bytes = 0, total_bytes = 0;
     size_t aligned_vec_len = RoundUp(vector_len, chunk_info_per_page);
-    size_t num_pages = aligned_vec_len / chunk_info_per_page;
+    size_t num_pages = (aligned_vec_len - old_gen_idx) / chunk_info_per_page;
     size_t threshold_passing_marker = 0;  // In number of pages
     std::vector<uint32_t> pages_live_bytes;
     pages_live_bytes.reserve(num_pages);
     // Identify the largest chunk towards the beginning of moving space which
     // passes the black-dense threshold.
-    for (size_t i = 0; i < aligned_vec_len; i += chunk_info_per_page) {
+    for (size_t i = old_gen_idx; i < aligned_vec_len; i += chunk_info_per_page) {
       uint32_t page_live_bytes = 0;
       for (size_t j = 0; j < chunk_info_per_page; j++) {
         page_live_bytes += chunk_info_vec_[i + j];
@@ -998,7 +1087,7 @@ bool MarkCompact::PrepareForCompaction() {
           pages_live_bytes.rbegin() + (num_pages - threshold_passing_marker),
           pages_live_bytes.rend(),
           [](uint32_t bytes) { return bytes * 100U >= gPageSize * kBlackDenseRegionThreshold; });
-      black_dense_idx = (pages_live_bytes.rend() - iter) * chunk_info_per_page;
+      black_dense_idx += (pages_live_bytes.rend() - iter) * chunk_info_per_page;
     }
     black_dense_end_ = moving_space_begin_ + black_dense_idx * kOffsetChunkSize;
     DCHECK_ALIGNED_PARAM(black_dense_end_, gPageSize);
@@ -1016,6 +1105,9 @@ bool MarkCompact::PrepareForCompaction() {
           std::min(black_dense_end_, reinterpret_cast<uint8_t*>(iter->second.AsMirrorPtr()));
       black_dense_end_ = AlignDown(black_dense_end_, gPageSize);
     }
+    // Only objects discovered in this cycle, which are outside the old
+    // generation, are recorded in class_after_obj_map_.
+    DCHECK_GE(black_dense_end_, old_gen_end_);
     black_dense_idx = (black_dense_end_ - moving_space_begin_) / kOffsetChunkSize;
     DCHECK_LE(black_dense_idx, vector_len);
     if (black_dense_idx == vector_len) {
@@ -1050,7 +1142,8 @@ bool MarkCompact::PrepareForCompaction() {
                       chunk_info_vec_ + black_dense_idx,
                       black_dense_idx * kOffsetChunkSize);
   total_bytes += chunk_info_vec_[vector_len - 1];
-  post_compact_end_ = AlignUp(moving_space_begin_ + total_bytes, gPageSize);
+  post_compact_objs_end_ = moving_space_begin_ + total_bytes;
+  post_compact_end_ = AlignUp(post_compact_objs_end_, gPageSize);
   CHECK_EQ(post_compact_end_, moving_space_begin_ + moving_first_objs_count_ * gPageSize)
       << "moving_first_objs_count_:" << moving_first_objs_count_
       << " black_dense_idx:" << black_dense_idx << " vector_len:" << vector_len
@@ -1137,7 +1230,15 @@ void MarkCompact::MarkingPause() {
     }
     // Fetch only the accumulated objects-allocated count as it is guaranteed to
     // be up-to-date after the TLAB revocation above.
-    freed_objects_ += bump_pointer_space_->GetAccumulatedObjectsAllocated();
+    int32_t objects_allocated = bump_pointer_space_->GetAccumulatedObjectsAllocated();
+    freed_objects_ += objects_allocated;
+    if (young_gen_) {
+      // Old-generation objects are neither marked nor freed in this cycle.
+      freed_objects_ -= old_gen_objects_;
+    }
+    // Number of objects retained, if nothing is freed. Adjusted for the freed
+    // ones in UpdateOldGen().
+    old_gen_objects_ = objects_allocated;
     // Capture 'end' of moving-space at this point. Every allocation beyond this
     // point will be considered as black.
     // Align-up to page boundary so that black allocations happen from next page
@@ -1149,6 +1250,9 @@ void MarkCompact::MarkingPause() {
     // Re-mark root set. Doesn't include thread-roots as they are already marked
     // above.
     ReMarkRoots(runtime);
+    if (young_gen_) {
+      MarkNonMovingSpaceAllocStack();
+    }
     // Scan dirty objects.
     RecursiveMarkDirtyObjects(/*paused*/ true, accounting::CardTable::kCardDirty);
     {
@@ -1257,16 +1361,20 @@ void MarkCompact::ReclaimPhase() {
 template <bool kCheckBegin, bool kCheckEnd>
 class MarkCompact::RefsUpdateVisitor {
  public:
+  // If 'card_addr' is not null, then its card is dirtied if any of the updated
+  // references point into the next cycle's young generation.
   explicit RefsUpdateVisitor(MarkCompact* collector,
                              mirror::Object* obj,
                              uint8_t* begin,
-                             uint8_t* end)
+                             uint8_t* end,
+                             uint8_t* card_addr = nullptr)
       : collector_(collector),
         moving_space_begin_(collector->black_dense_end_),
         moving_space_end_(collector->moving_space_end_),
         obj_(obj),
         begin_(begin),
-        end_(end) {
+        end_(end),
+        card_addr_(card_addr) {
     DCHECK(!kCheckBegin || begin != nullptr);
     DCHECK(!kCheckEnd || end != nullptr);
   }
@@ -1281,7 +1389,7 @@ class MarkCompact::RefsUpdateVisitor {
       update = (!kCheckBegin || ref >= begin_) && (!kCheckEnd || ref < end_);
     }
     if (update) {
-      collector_->UpdateRef(obj_, offset, moving_space_begin_, moving_space_end_);
+      MaybeDirtyCard(collector_->UpdateRef(obj_, offset, moving_space_begin_, moving_space_end_));
     }
   }
 
@@ -1294,7 +1402,7 @@ class MarkCompact::RefsUpdateVisitor {
                   [[maybe_unused]] bool is_static,
                   [[maybe_unused]] bool is_obj_array) const ALWAYS_INLINE
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES_SHARED(Locks::heap_bitmap_lock_) {
-    collector_->UpdateRef(obj_, offset, moving_space_begin_, moving_space_end_);
+    MaybeDirtyCard(collector_->UpdateRef(obj_, offset, moving_space_begin_, moving_space_end_));
   }
 
   void VisitRootIfNonNull(mirror::CompressedReference<mirror::Object>* root) const
@@ -1312,12 +1420,19 @@ class MarkCompact::RefsUpdateVisitor {
   }
 
  private:
+  void MaybeDirtyCard(mirror::Object* new_ref) const ALWAYS_INLINE {
+    if (card_addr_ != nullptr && collector_->IsPostCompactYoungRef(new_ref)) {
+      collector_->heap_->GetCardTable()->MarkCard(card_addr_);
+    }
+  }
+
   MarkCompact* const collector_;
   uint8_t* const moving_space_begin_;
   uint8_t* const moving_space_end_;
   mirror::Object* const obj_;
   uint8_t* const begin_;
   uint8_t* const end_;
+  uint8_t* const card_addr_;
 };
 
 bool MarkCompact::IsValidObject(mirror::Object* obj) const {
@@ -1343,7 +1458,8 @@ void MarkCompact::VerifyObject(mirror::Object* ref, Callback& callback) const {
           << " post_compact_end=" << static_cast<void*>(post_compact_end_)
           << " pre_compact_klass=" << pre_compact_klass
           << " black_allocations_begin=" << static_cast<void*>(black_allocations_begin_);
-      CHECK(live_words_bitmap_->Test(pre_compact_klass));
+      CHECK(reinterpret_cast<uint8_t*>(pre_compact_klass) < old_gen_end_ ||
+            live_words_bitmap_->Test(pre_compact_klass));
     }
     if (!IsValidObject(ref)) {
       std::ostringstream oss;
@@ -1375,6 +1491,7 @@ void MarkCompact::VerifyObject(mirror::Object* ref, Callback& callback) const {
 void MarkCompact::CompactPage(mirror::Object* obj,
                               uint32_t offset,
                               uint8_t* addr,
+                              uint8_t* to_space_page,
                               bool needs_memset_zero) {
   DCHECK(moving_space_bitmap_->Test(obj)
          && live_words_bitmap_->Test(obj));
@@ -1386,6 +1503,13 @@ void MarkCompact::CompactPage(mirror::Object* obj,
                                            << " post_compact_addr="
                                            << static_cast<void*>(post_compact_end_);
   uint8_t* const start_addr = addr;
+  // In generational mode, the moving-space cards were cleared in the
+  // compaction pause. Dirty the cards, at the post-compact address, of the
+  // objects which refer to the young generation of the next cycle.
+  auto card_addr = [this, start_addr, to_space_page](mirror::Object* ref) -> uint8_t* {
+    return use_generational_ ? to_space_page + (reinterpret_cast<uint8_t*>(ref) - start_addr)
+                             : nullptr;
+  };
   // How many distinct live-strides do we have.
   size_t stride_count = 0;
   uint8_t* last_stride = addr;
@@ -1441,14 +1565,16 @@ void MarkCompact::CompactPage(mirror::Object* obj,
       RefsUpdateVisitor</*kCheckBegin*/true, /*kCheckEnd*/false> visitor(this,
                                                                          to_ref,
                                                                          start_addr,
-                                                                         nullptr);
+                                                                         nullptr,
+                                                                         card_addr(to_ref));
       obj_size = obj->VisitRefsForCompaction</*kFetchObjSize*/true, /*kVisitNativeRoots*/false>(
               visitor, MemberOffset(offset_within_obj), MemberOffset(-1));
     } else {
       RefsUpdateVisitor</*kCheckBegin*/true, /*kCheckEnd*/true> visitor(this,
                                                                         to_ref,
                                                                         start_addr,
-                                                                        start_addr + gPageSize);
+                                                                        start_addr + gPageSize,
+                                                                        card_addr(to_ref));
       obj_size = obj->VisitRefsForCompaction</*kFetchObjSize*/true, /*kVisitNativeRoots*/false>(
               visitor, MemberOffset(offset_within_obj), MemberOffset(offset_within_obj
                                                                      + gPageSize));
@@ -1492,7 +1618,7 @@ void MarkCompact::CompactPage(mirror::Object* obj,
     mirror::Object* ref = reinterpret_cast<mirror::Object*>(addr + bytes_done);
     VerifyObject(ref, verify_obj_callback);
     RefsUpdateVisitor</*kCheckBegin*/false, /*kCheckEnd*/false>
-            visitor(this, ref, nullptr, nullptr);
+            visitor(this, ref, nullptr, nullptr, card_addr(ref));
     obj_size = ref->VisitRefsForCompaction(visitor, MemberOffset(0), MemberOffset(-1));
     obj_size = RoundUp(obj_size, kAlignment);
     bytes_done += obj_size;
@@ -1510,7 +1636,7 @@ void MarkCompact::CompactPage(mirror::Object* obj,
     obj = reinterpret_cast<mirror::Object*>(from_addr);
     VerifyObject(ref, verify_obj_callback);
     RefsUpdateVisitor</*kCheckBegin*/false, /*kCheckEnd*/true>
-            visitor(this, ref, nullptr, start_addr + gPageSize);
+            visitor(this, ref, nullptr, start_addr + gPageSize, card_addr(ref));
     obj_size = obj->VisitRefsForCompaction(visitor,
                                            MemberOffset(0),
                                            MemberOffset(end_addr - (addr + bytes_done)));
@@ -2141,7 +2267,11 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
         page,
         /*map_immediately=*/page == reserve_page,
         [&]() REQUIRES_SHARED(Locks::mutator_lock_) {
-          CompactPage(first_obj, pre_compact_offset_moving_space_[idx], page, kMode == kCopyMode);
+          CompactPage(first_obj,
+                      pre_compact_offset_moving_space_[idx],
+                      page,
+                      to_space_end,
+                      kMode == kCopyMode);
         });
     if (kMode == kCopyMode && (!success || page == reserve_page) && end_idx_for_mapping - idx > 1) {
       // map the pages in the following address as they can't be mapped with the
@@ -2286,6 +2416,13 @@ void MarkCompact::UpdateNonMovingPage(mirror::Object* first,
   mirror::Object* curr_obj = first;
   uint8_t* from_page = page + from_space_diff;
   uint8_t* from_page_end = from_page + gPageSize;
+  // Black-dense pages of the moving space had their cards cleared in the
+  // compaction pause in generational mode. Objects don't move here, so their
+  // cards are dirtied at the same address.
+  const bool dirty_cards = use_generational_ && bitmap == moving_space_bitmap_;
+  auto card_addr = [dirty_cards](mirror::Object* obj) -> uint8_t* {
+    return dirty_cards ? reinterpret_cast<uint8_t*>(obj) : nullptr;
+  };
   bitmap->VisitMarkedRange(
       reinterpret_cast<uintptr_t>(first) + mirror::kObjectHeaderSize,
       reinterpret_cast<uintptr_t>(page + gPageSize),
@@ -2294,7 +2431,7 @@ void MarkCompact::UpdateNonMovingPage(mirror::Object* first,
             reinterpret_cast<uint8_t*>(curr_obj) + from_space_diff);
         if (reinterpret_cast<uint8_t*>(curr_obj) < page) {
           RefsUpdateVisitor</*kCheckBegin*/ true, /*kCheckEnd*/ false> visitor(
-              this, from_obj, from_page, from_page_end);
+              this, from_obj, from_page, from_page_end, card_addr(curr_obj));
           MemberOffset begin_offset(page - reinterpret_cast<uint8_t*>(curr_obj));
           // Native roots shouldn't be visited as they are done when this
           // object's beginning was visited in the preceding page.
@@ -2302,7 +2439,7 @@ void MarkCompact::UpdateNonMovingPage(mirror::Object* first,
               visitor, begin_offset, MemberOffset(-1));
         } else {
           RefsUpdateVisitor</*kCheckBegin*/ false, /*kCheckEnd*/ false> visitor(
-              this, from_obj, from_page, from_page_end);
+              this, from_obj, from_page, from_page_end, card_addr(curr_obj));
           from_obj->VisitRefsForCompaction</*kFetchObjSize*/ false>(
               visitor, MemberOffset(0), MemberOffset(-1));
         }
@@ -2314,12 +2451,12 @@ void MarkCompact::UpdateNonMovingPage(mirror::Object* first,
   MemberOffset end_offset(page + gPageSize - reinterpret_cast<uint8_t*>(curr_obj));
   if (reinterpret_cast<uint8_t*>(curr_obj) < page) {
     RefsUpdateVisitor</*kCheckBegin*/ true, /*kCheckEnd*/ true> visitor(
-        this, from_obj, from_page, from_page_end);
+        this, from_obj, from_page, from_page_end, card_addr(curr_obj));
     from_obj->VisitRefsForCompaction</*kFetchObjSize*/ false, /*kVisitNativeRoots*/ false>(
         visitor, MemberOffset(page - reinterpret_cast<uint8_t*>(curr_obj)), end_offset);
   } else {
     RefsUpdateVisitor</*kCheckBegin*/ false, /*kCheckEnd*/ true> visitor(
-        this, from_obj, from_page, from_page_end);
+        this, from_obj, from_page, from_page_end, card_addr(curr_obj));
     from_obj->VisitRefsForCompaction</*kFetchObjSize*/ false>(visitor, MemberOffset(0), end_offset);
   }
 }
@@ -2803,6 +2940,14 @@ void MarkCompact::CompactionPause() {
     // 3. In the corresponding page, if the first-object vector needs updating
     // then do so.
     UpdateNonMovingSpaceBlackAllocations();
+    if (use_generational_) {
+      // Moving-space cards refer to pre-compact addresses and are meaningless
+      // past this point. The cards of old-generation objects which refer to
+      // young objects are dirtied again while updating references during
+      // compaction. Mutators dirty cards at post-compact addresses after the
+      // pause.
+      heap_->GetCardTable()->ClearCardRange(moving_space_begin_, moving_space_end_);
+    }
     // This store is visible to mutator (or uffd worker threads) as the mutator
     // lock's unlock guarantees that.
     compacting_ = true;
@@ -3192,6 +3337,7 @@ void MarkCompact::ConcurrentlyProcessMovingPage(uint8_t* fault_page,
             CompactPage(first_obj,
                         pre_compact_offset_moving_space_[page_idx],
                         buf,
+                        fault_page,
                         /*needs_memset_zero=*/true);
           } else {
             DCHECK_NE(first_obj, nullptr);
@@ -3605,6 +3751,78 @@ void MarkCompact::UnregisterUffd(uint8_t* start, size_t len) {
       << ". addr:" << static_cast<void*>(start) << " len:" << PrettySize(len);
 }
 
+class MarkCompact::CompactionWorkerTask : public SelfDeletingTask {
+ public:
+  explicit CompactionWorkerTask(MarkCompact* collector) : collector_(collector) {}
+
+  void Run(Thread* self) override {
+    // Like the gc-thread, hold the mutator-lock shared only for the duration
+    // of compaction. Compaction pause is already over, so there's no risk of
+    // blocking a thread-suspension request for long.
+    ReaderMutexLock mu(self, *Locks::mutator_lock_);
+    collector_->CompactMovingPagesFromWorker(self);
+  }
+
+ private:
+  MarkCompact* const collector_;
+};
+
+void MarkCompact::MaybeCreateCompactionThreadPool(Thread* self) {
+  size_t num_threads = heap_->GetConcGCThreadCount();
+  if (num_threads == 0 || heap_->GetThreadPool() != nullptr ||
+      Runtime::Current()->IsZygote() || Runtime::Current()->IsShuttingDown(self)) {
+    return;
+  }
+  heap_->CreateThreadPool(num_threads);
+}
+
+size_t MarkCompact::StartCompactionWorkers(Thread* self) {
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  // Parallel compaction is only worth it when the app is in foreground. In
+  // background we'd rather not compete with other processes for CPU.
+  if (thread_pool == nullptr || !Runtime::Current()->InJankPerceptibleProcessState() ||
+      moving_first_objs_count_ <= kCompactionWorkerChunkPages) {
+    return 0;
+  }
+  size_t num_workers = thread_pool->GetThreadCount();
+  for (size_t i = 0; i < num_workers; i++) {
+    thread_pool->AddTask(self, new CompactionWorkerTask(this));
+  }
+  thread_pool->StartWorkers(self);
+  return num_workers;
+}
+
+void MarkCompact::CompactMovingPagesFromWorker(Thread* self) {
+  // Only the pages which need compaction (or updating in black-dense portion)
+  // are picked. The black-allocated pages are cheap to slide and are left to
+  // gc-thread and mutators.
+  const size_t nr_used_pages = moving_first_objs_count_ + black_page_count_;
+  uint8_t* buf = self->GetThreadLocalGcBuffer();
+  while (true) {
+    size_t begin_idx =
+        compaction_worker_page_idx_.fetch_add(kCompactionWorkerChunkPages, std::memory_order_relaxed);
+    if (begin_idx >= moving_first_objs_count_) {
+      break;
+    }
+    size_t end_idx = std::min(begin_idx + kCompactionWorkerChunkPages, moving_first_objs_count_);
+    for (size_t idx = begin_idx; idx < end_idx; idx++) {
+      if (first_objs_moving_space_[idx].IsNull() ||
+          GetMovingPageState(idx) != PageState::kUnprocessed) {
+        continue;
+      }
+      // Processing the page in kMutatorProcessing state ensures that
+      // FreeFromSpacePages() doesn't release the from-space pages the worker
+      // is reading from.
+      ConcurrentlyProcessMovingPage(moving_space_begin_ + idx * gPageSize,
+                                    buf,
+                                    nr_used_pages,
+                                    /*tolerate_enoent=*/false);
+      // The thread-local buffer is claimed on the first page that needs it.
+      buf = self->GetThreadLocalGcBuffer();
+    }
+  }
+}
+
 void MarkCompact::CompactionPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   {
@@ -3613,7 +3831,15 @@ void MarkCompact::CompactionPhase() {
     RecordFree(ObjectBytePair(freed_objects_, freed_bytes));
   }
 
+  size_t num_workers = StartCompactionWorkers(thread_running_gc_);
   CompactMovingSpace<kCopyMode>(compaction_buffers_map_.Begin());
+  if (num_workers > 0) {
+    // Workers only pick pages which are still unprocessed, and the gc-thread
+    // is done with all of them. So the wait here is at most one chunk long.
+    ThreadPool* thread_pool = heap_->GetThreadPool();
+    thread_pool->Wait(thread_running_gc_, /*do_work=*/false, /*may_hold_locks=*/true);
+    thread_pool->StopWorkers(thread_running_gc_);
+  }
 
   ProcessLinearAlloc();
 
@@ -3770,9 +3996,20 @@ void MarkCompact::MarkRootsCheckpoint(Thread* self, Runtime* runtime) {
   CheckpointMarkThreadRoots check_point(this);
   ThreadList* thread_list = runtime->GetThreadList();
   gc_barrier_.Init(self, 0);
+  // Visiting the roots of suspended threads dominates with many idle threads, so spread it over
+  // the GC thread pool when in foreground. The checkpoint is already run concurrently by the
+  // runnable threads themselves.
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  if (!runtime->InJankPerceptibleProcessState()) {
+    thread_pool = nullptr;
+  }
   // Request the check point is run on all threads returning a count of the threads that must
   // run through the barrier including self.
-  size_t barrier_count = thread_list->RunCheckpoint(&check_point);
+  size_t barrier_count = thread_list->RunCheckpoint(&check_point,
+                                                    /*callback=*/nullptr,
+                                                    /*allow_lock_checking=*/true,
+                                                    /*acquire_mutator_lock=*/false,
+                                                    thread_pool);
   // Release locks then wait for all mutator threads to pass the barrier.
   // If there are no threads to wait which implys that all the checkpoint functions are finished,
   // then no need to release locks.
@@ -3846,10 +4083,43 @@ void MarkCompact::UpdateAndMarkModUnion() {
   }
 }
 
+void MarkCompact::ScanOldGenObjects() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  DCHECK(young_gen_);
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  // Only the objects with their mark-bits set, i.e. the old ones, are visited
+  // in the moving space.
+  card_table->Scan</*kClearCard*/ false>(moving_space_bitmap_,
+                                         moving_space_begin_,
+                                         old_gen_end_,
+                                         ScanObjectVisitor(this),
+                                         accounting::CardTable::kCardAged);
+  card_table->Scan</*kClearCard*/ false>(non_moving_space_bitmap_,
+                                         non_moving_space_->Begin(),
+                                         non_moving_space_->End(),
+                                         ScanObjectVisitor(this),
+                                         accounting::CardTable::kCardAged);
+}
+
+void MarkCompact::MarkNonMovingSpaceAllocStack() {
+  TimingLogger::ScopedTiming t("(Paused)MarkNonMovingSpaceAllocStack", GetTimings());
+  DCHECK(young_gen_);
+  accounting::ObjectStack* stack = heap_->GetAllocationStack();
+  for (StackReference<mirror::Object>* it = stack->Begin(); it != stack->End(); ++it) {
+    mirror::Object* obj = it->AsMirrorPtr();
+    if (obj != nullptr && non_moving_space_bitmap_->HasAddress(obj)) {
+      MarkObjectNonNull(obj);
+    }
+  }
+}
+
 void MarkCompact::MarkReachableObjects() {
   UpdateAndMarkModUnion();
+  if (young_gen_) {
+    ScanOldGenObjects();
+  }
   // Recursively mark all the non-image bits set in the mark bitmap.
-  ProcessMarkStack();
+  ProcessMarkStackParallel();
 }
 
 void MarkCompact::ScanDirtyObjects(bool paused, uint8_t minimum_age) {
@@ -3875,7 +4145,11 @@ void MarkCompact::ScanDirtyObjects(bool paused, uint8_t minimum_age) {
 
 void MarkCompact::RecursiveMarkDirtyObjects(bool paused, uint8_t minimum_age) {
   ScanDirtyObjects(paused, minimum_age);
-  ProcessMarkStack();
+  if (paused) {
+    ProcessMarkStack();
+  } else {
+    ProcessMarkStackParallel();
+  }
 }
 
 void MarkCompact::MarkRoots(VisitRootFlags flags) {
@@ -3937,24 +4211,61 @@ void MarkCompact::MarkingPhase() {
   }
 }
 
+// Per-thread state of parallel marking.
+class MarkCompact::ParallelMarkWorker {
+ public:
+  ParallelMarkWorker() : stack_(kParallelMarkStackSize), bytes_scanned_(0), freed_objects_(0) {}
+
+  void Push(mirror::Object* obj) {
+    if (UNLIKELY(!stack_.Push(obj))) {
+      overflow_.push_back(obj);
+    }
+  }
+
+  mirror::Object* Pop() {
+    mirror::Object* obj = stack_.Pop();
+    if (obj == nullptr && !overflow_.empty()) {
+      obj = overflow_.back();
+      overflow_.pop_back();
+    }
+    return obj;
+  }
+
+  // Work-stealing stack, only the top of which is visible to other threads.
+  accounting::WorkStealingStack<mirror::Object> stack_;
+  // Objects which didn't fit in stack_. Only accessed by the owner.
+  std::vector<mirror::Object*> overflow_;
+  // Thread-local counters, added to the collector's after marking finishes.
+  uint64_t bytes_scanned_;
+  int32_t freed_objects_;
+  // (class, object) pairs to be added to class_after_obj_map_ after marking
+  // finishes.
+  std::vector<std::pair<ObjReference, ObjReference>> class_after_obj_;
+};
+
+template <bool kParallel>
 class MarkCompact::RefFieldsVisitor {
  public:
-  ALWAYS_INLINE explicit RefFieldsVisitor(MarkCompact* const mark_compact)
-    : mark_compact_(mark_compact) {}
+  ALWAYS_INLINE explicit RefFieldsVisitor(MarkCompact* const mark_compact,
+                                          ParallelMarkWorker* worker = nullptr)
+    : mark_compact_(mark_compact), worker_(worker) {
+    DCHECK_EQ(kParallel, worker != nullptr);
+  }
 
   ALWAYS_INLINE void operator()(mirror::Object* obj,
                                 MemberOffset offset,
                                 [[maybe_unused]] bool is_static) const
       REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_) {
-    if (kCheckLocks) {
+    if (kCheckLocks && !kParallel) {
       Locks::mutator_lock_->AssertSharedHeld(Thread::Current());
       Locks::heap_bitmap_lock_->AssertExclusiveHeld(Thread::Current());
     }
-    mark_compact_->MarkObject(obj->GetFieldObject<mirror::Object>(offset), obj, offset);
+    Mark(obj->GetFieldObject<mirror::Object>(offset), obj, offset);
   }
 
   void operator()(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> ref) const ALWAYS_INLINE
       REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_) {
+    // Reference-processor's queues are thread-safe.
     mark_compact_->DelayReferenceReferent(klass, ref);
   }
 
@@ -3968,15 +4279,27 @@ class MarkCompact::RefFieldsVisitor {
   void VisitRoot(mirror::CompressedReference<mirror::Object>* root) const
       REQUIRES(Locks::heap_bitmap_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_) {
-    if (kCheckLocks) {
+    if (kCheckLocks && !kParallel) {
       Locks::mutator_lock_->AssertSharedHeld(Thread::Current());
       Locks::heap_bitmap_lock_->AssertExclusiveHeld(Thread::Current());
     }
-    mark_compact_->MarkObject(root->AsMirrorPtr());
+    Mark(root->AsMirrorPtr(), nullptr, MemberOffset(0));
   }
 
  private:
+  ALWAYS_INLINE void Mark(mirror::Object* ref, mirror::Object* holder, MemberOffset offset) const
+      REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (kParallel) {
+      if (ref != nullptr) {
+        mark_compact_->ParallelMarkObject(ref, holder, offset, worker_);
+      }
+    } else {
+      mark_compact_->MarkObject(ref, holder, offset);
+    }
+  }
+
   MarkCompact* const mark_compact_;
+  ParallelMarkWorker* const worker_;
 };
 
 template <size_t kAlignment>
@@ -3989,30 +4312,55 @@ size_t MarkCompact::LiveWordsBitmap<kAlignment>::LiveBytesInBitmapWord(size_t ch
   return words * kAlignment;
 }
 
-void MarkCompact::UpdateLivenessInfo(mirror::Object* obj, size_t obj_size) {
+template <bool kParallel>
+void MarkCompact::UpdateLivenessInfo(mirror::Object* obj,
+                                     size_t obj_size,
+                                     ParallelMarkWorker* worker) {
   DCHECK(obj != nullptr);
   DCHECK_EQ(obj_size, obj->SizeOf<kDefaultVerifyFlags>());
   uintptr_t obj_begin = reinterpret_cast<uintptr_t>(obj);
-  UpdateClassAfterObjectMap(obj);
+  if (kParallel) {
+    mirror::Class* klass = obj->GetClass<kVerifyNone, kWithoutReadBarrier>();
+    if (UNLIKELY(std::less<mirror::Object*>{}(obj, klass) && HasAddress(klass))) {
+      worker->class_after_obj_.emplace_back(ObjReference::FromMirrorPtr(klass),
+                                            ObjReference::FromMirrorPtr(obj));
+    }
+  } else {
+    UpdateClassAfterObjectMap(obj);
+  }
+  // The first and the last chunk may be shared with other objects, which could
+  // be concurrently getting marked in the parallel case.
+  auto add_to_chunk = [this](size_t idx, uint32_t bytes) {
+    if (kParallel) {
+      reinterpret_cast<std::atomic<uint32_t>*>(chunk_info_vec_ + idx)
+          ->fetch_add(bytes, std::memory_order_relaxed);
+    } else {
+      chunk_info_vec_[idx] += bytes;
+    }
+  };
   size_t size = RoundUp(obj_size, kAlignment);
-  uintptr_t bit_index = live_words_bitmap_->SetLiveWords(obj_begin, size);
+  uintptr_t bit_index = live_words_bitmap_->SetLiveWords<kParallel>(obj_begin, size);
   size_t chunk_idx = (obj_begin - live_words_bitmap_->Begin()) / kOffsetChunkSize;
   // Compute the bit-index within the chunk-info vector word.
   bit_index %= kBitsPerVectorWord;
   size_t first_chunk_portion = std::min(size, (kBitsPerVectorWord - bit_index) * kAlignment);
 
-  chunk_info_vec_[chunk_idx++] += first_chunk_portion;
+  add_to_chunk(chunk_idx++, first_chunk_portion);
   DCHECK_LE(first_chunk_portion, size);
   for (size -= first_chunk_portion; size > kOffsetChunkSize; size -= kOffsetChunkSize) {
     DCHECK_EQ(chunk_info_vec_[chunk_idx], 0u);
     chunk_info_vec_[chunk_idx++] = kOffsetChunkSize;
   }
-  chunk_info_vec_[chunk_idx] += size;
-  freed_objects_--;
+  add_to_chunk(chunk_idx, size);
+  if (kParallel) {
+    worker->freed_objects_--;
+  } else {
+    freed_objects_--;
+  }
 }
 
-template <bool kUpdateLiveWords>
-void MarkCompact::ScanObject(mirror::Object* obj) {
+template <bool kUpdateLiveWords, bool kParallel>
+void MarkCompact::ScanObject(mirror::Object* obj, ParallelMarkWorker* worker) {
   mirror::Class* klass = obj->GetClass<kVerifyNone, kWithoutReadBarrier>();
   // TODO(lokeshgidra): Remove the following condition once b/373609505 is fixed.
   if (UNLIKELY(klass == nullptr)) {
@@ -4044,12 +4392,16 @@ void MarkCompact::ScanObject(mirror::Object* obj) {
   // `UpdateLivenessInfo`. As fetching this value can be expensive, do it once
   // here and pass that information to `UpdateLivenessInfo`.
   size_t obj_size = obj->SizeOf<kDefaultVerifyFlags>();
-  bytes_scanned_ += obj_size;
+  if (kParallel) {
+    worker->bytes_scanned_ += obj_size;
+  } else {
+    bytes_scanned_ += obj_size;
+  }
 
-  RefFieldsVisitor visitor(this);
+  RefFieldsVisitor<kParallel> visitor(this, worker);
   DCHECK(IsMarked(obj)) << "Scanning marked object " << obj << "\n" << heap_->DumpSpaces();
   if (kUpdateLiveWords && HasAddress(obj)) {
-    UpdateLivenessInfo(obj, obj_size);
+    UpdateLivenessInfo<kParallel>(obj, obj_size, worker);
   }
   obj->VisitReferences(visitor, visitor);
 }
@@ -4065,6 +4417,138 @@ void MarkCompact::ProcessMarkStack() {
   }
 }
 
+class MarkCompact::ParallelMarkTask : public SelfDeletingTask {
+ public:
+  ParallelMarkTask(MarkCompact* collector, ParallelMarkWorker* worker)
+      : collector_(collector), worker_(worker) {}
+
+  // The mutator-lock (shared) and heap-bitmap-lock (exclusive) are held by the
+  // gc-thread on our behalf, which waits for the task to finish.
+  void Run([[maybe_unused]] Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    collector_->ParallelMarkLoop(worker_);
+  }
+
+ private:
+  MarkCompact* const collector_;
+  ParallelMarkWorker* const worker_;
+};
+
+void MarkCompact::ProcessMarkStackParallel() {
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  if (thread_pool == nullptr || !Runtime::Current()->InJankPerceptibleProcessState() ||
+      mark_stack_->IsEmpty()) {
+    ProcessMarkStack();
+    return;
+  }
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  const size_t num_workers = thread_pool->GetThreadCount() + 1;
+  while (parallel_mark_workers_.size() < num_workers) {
+    parallel_mark_workers_.emplace_back(new ParallelMarkWorker());
+  }
+  parallel_mark_num_workers_ = num_workers;
+  parallel_mark_stack_idx_.store(0, std::memory_order_relaxed);
+  parallel_mark_active_workers_.store(num_workers, std::memory_order_relaxed);
+  for (size_t i = 1; i < num_workers; i++) {
+    thread_pool->AddTask(thread_running_gc_,
+                         new ParallelMarkTask(this, parallel_mark_workers_[i].get()));
+  }
+  thread_pool->StartWorkers(thread_running_gc_);
+  ParallelMarkLoop(parallel_mark_workers_[0].get());
+  thread_pool->Wait(thread_running_gc_, /*do_work=*/false, /*may_hold_locks=*/true);
+  thread_pool->StopWorkers(thread_running_gc_);
+  // All the objects have been claimed and processed.
+  mark_stack_->Reset();
+  for (size_t i = 0; i < num_workers; i++) {
+    ParallelMarkWorker* worker = parallel_mark_workers_[i].get();
+    DCHECK(worker->stack_.IsEmpty());
+    DCHECK(worker->overflow_.empty());
+    bytes_scanned_ += worker->bytes_scanned_;
+    freed_objects_ += worker->freed_objects_;
+    worker->bytes_scanned_ = 0;
+    worker->freed_objects_ = 0;
+    for (auto [klass, obj] : worker->class_after_obj_) {
+      auto [iter, success] = class_after_obj_map_.try_emplace(klass, obj);
+      if (!success && std::less<mirror::Object*>{}(obj.AsMirrorPtr(), iter->second.AsMirrorPtr())) {
+        iter->second = obj;
+      }
+    }
+    worker->class_after_obj_.clear();
+  }
+}
+
+void MarkCompact::ParallelMarkLoop(ParallelMarkWorker* worker) {
+  const size_t num_workers = parallel_mark_num_workers_;
+  const size_t mark_stack_size = mark_stack_->Size();
+  StackReference<mirror::Object>* const mark_stack_begin = mark_stack_->Begin();
+  // Returns an object to be scanned, if any, from the shared mark-stack or by
+  // stealing from other threads.
+  auto find_work = [&]() -> mirror::Object* {
+    size_t idx = parallel_mark_stack_idx_.load(std::memory_order_relaxed);
+    if (idx < mark_stack_size) {
+      idx = parallel_mark_stack_idx_.fetch_add(kParallelMarkStackChunkSize,
+                                               std::memory_order_relaxed);
+      size_t end = std::min(idx + kParallelMarkStackChunkSize, mark_stack_size);
+      for (; idx < end; idx++) {
+        worker->Push(mark_stack_begin[idx].AsMirrorPtr());
+      }
+      mirror::Object* obj = worker->Pop();
+      if (obj != nullptr) {
+        return obj;
+      }
+    }
+    for (size_t i = 0; i < num_workers; i++) {
+      ParallelMarkWorker* victim = parallel_mark_workers_[i].get();
+      if (victim != worker) {
+        mirror::Object* obj = victim->stack_.Steal();
+        if (obj != nullptr) {
+          return obj;
+        }
+      }
+    }
+    return nullptr;
+  };
+  auto work_available = [&]() {
+    if (parallel_mark_stack_idx_.load(std::memory_order_relaxed) < mark_stack_size) {
+      return true;
+    }
+    for (size_t i = 0; i < num_workers; i++) {
+      if (!parallel_mark_workers_[i]->stack_.IsEmpty()) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  while (true) {
+    mirror::Object* obj = worker->Pop();
+    if (obj == nullptr) {
+      obj = find_work();
+    }
+    if (obj != nullptr) {
+      ScanObject</*kUpdateLiveWords*/ true, /*kParallel*/ true>(obj, worker);
+      continue;
+    }
+    // Out of work. Only a thread which still has some work can generate more
+    // of it. So once every thread is idle, marking is done.
+    parallel_mark_active_workers_.fetch_sub(1, std::memory_order_seq_cst);
+    for (uint32_t i = 0;; i++) {
+      if (work_available()) {
+        parallel_mark_active_workers_.fetch_add(1, std::memory_order_seq_cst);
+        obj = find_work();
+        if (obj != nullptr) {
+          break;
+        }
+        parallel_mark_active_workers_.fetch_sub(1, std::memory_order_seq_cst);
+      }
+      if (parallel_mark_active_workers_.load(std::memory_order_seq_cst) == 0) {
+        return;
+      }
+      BackOff(i);
+    }
+    ScanObject</*kUpdateLiveWords*/ true, /*kParallel*/ true>(obj, worker);
+  }
+}
+
 void MarkCompact::ExpandMarkStack() {
   const size_t new_size = mark_stack_->Capacity() * 2;
   std::vector<StackReference<mirror::Object>> temp(mark_stack_->Begin(),
@@ -4133,6 +4617,16 @@ inline bool MarkCompact::MarkObjectNonNullNoPush(mirror::Object* obj,
   }
 }
 
+inline void MarkCompact::ParallelMarkObject(mirror::Object* obj,
+                                            mirror::Object* holder,
+                                            MemberOffset offset,
+                                            ParallelMarkWorker* worker) {
+  DCHECK(obj != nullptr);
+  if (MarkObjectNonNullNoPush</*kParallel*/true>(obj, holder, offset)) {
+    worker->Push(obj);
+  }
+}
+
 inline void MarkCompact::MarkObject(mirror::Object* obj,
                                     mirror::Object* holder,
                                     MemberOffset offset) {
@@ -4246,15 +4740,59 @@ void MarkCompact::DelayReferenceReferent(ObjPtr<mirror::Class> klass,
   heap_->GetReferenceProcessor()->DelayReferenceReferent(klass, ref, this);
 }
 
+void MarkCompact::UpdateOldGen(bool compacted) {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  DCHECK(use_generational_);
+  if (compacted) {
+    // Everything that survived compaction is promoted. The usual mark-bits of
+    // the black-dense region are retained. Past it, the compacted objects are
+    // packed one after the other and hence can be walked linearly, starting
+    // from the end of the object, if any, straddling black_dense_end_.
+    uint8_t* addr = black_dense_end_;
+    if (black_dense_end_ > moving_space_begin_) {
+      mirror::Object* obj = moving_space_bitmap_->FindPrecedingObject(
+          reinterpret_cast<uintptr_t>(black_dense_end_) - kAlignment,
+          reinterpret_cast<uintptr_t>(moving_space_begin_));
+      if (obj != nullptr) {
+        addr = std::max(addr,
+                        reinterpret_cast<uint8_t*>(obj) + RoundUp(obj->SizeOf(), kAlignment));
+      }
+    }
+    while (addr < post_compact_objs_end_) {
+      mirror::Object* obj = reinterpret_cast<mirror::Object*>(addr);
+      DCHECK(obj->GetClass<kVerifyNone, kWithoutReadBarrier>() != nullptr) << obj;
+      moving_space_bitmap_->Set(obj);
+      addr += RoundUp(obj->SizeOf(), kAlignment);
+    }
+    DCHECK_EQ(addr, post_compact_objs_end_);
+    old_gen_end_ = post_compact_end_;
+    old_gen_objects_ -= freed_objects_;
+  } else {
+    // Nothing moved. The objects allocated before the marking pause are
+    // promoted, and the reachable ones among them are already marked.
+    old_gen_end_ = black_allocations_begin_;
+  }
+  DCHECK_ALIGNED_PARAM(old_gen_end_, gPageSize);
+  DCHECK_GE(old_gen_objects_, 0);
+  black_dense_end_ = old_gen_end_;
+  young_gc_count_ = young_gen_ ? young_gc_count_ + 1 : 0;
+}
+
 void MarkCompact::FinishPhase() {
   GetCurrentIteration()->SetScannedBytes(bytes_scanned_);
   bool is_zygote = Runtime::Current()->IsZygote();
+  const bool compacted = compacting_;
   compacting_ = false;
   marking_done_ = false;
 
   ZeroAndReleaseMemory(compaction_buffers_map_.Begin(), compaction_buffers_map_.Size());
   info_map_.MadviseDontNeedAndZero();
   live_words_bitmap_->ClearBitmap();
+  if (use_generational_ && !is_zygote && !compacted) {
+    // The marked objects below black_allocations_begin_ are promoted as is.
+    // Clear only the bits beyond them.
+    black_dense_end_ = black_allocations_begin_;
+  }
   if (moving_space_begin_ == black_dense_end_) {
     moving_space_bitmap_->Clear();
   } else {
@@ -4263,6 +4801,10 @@ void MarkCompact::FinishPhase() {
     moving_space_bitmap_->ClearRange(reinterpret_cast<mirror::Object*>(black_dense_end_),
                                      reinterpret_cast<mirror::Object*>(moving_space_end_));
   }
+  if (use_generational_ && !is_zygote) {
+    ReaderMutexLock mu(thread_running_gc_, *Locks::mutator_lock_);
+    UpdateOldGen(compacted);
+  }
   bump_pointer_space_->SetBlackDenseRegionSize(black_dense_end_ - moving_space_begin_);
 
   if (UNLIKELY(is_zygote && IsValidFd(uffd_))) {
@@ -22,6 +22,7 @@
 #include <map>
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
 #include "barrier.h"
 #include "base/atomic.h"
@@ -66,10 +67,13 @@ class MarkCompact final : public GarbageCollector {
   // Bitmask for the compaction-done bit in the sigbus_in_progress_count_.
   static constexpr SigbusCounterType kSigbusCounterCompactionDoneMask =
       1u << (BitSizeOf<SigbusCounterType>() - 1);
+  // In generational mode, maximum number of consecutive young cycles before a
+  // full compaction is requested.
+  static constexpr size_t kMaxYoungGcsBetweenFullGcs = 8;
 
-  explicit MarkCompact(Heap* heap);
+  MarkCompact(Heap* heap, bool use_generational);
 
-  ~MarkCompact() {}
+  ~MarkCompact();
 
   void RunPhases() override REQUIRES(!Locks::mutator_lock_, !lock_);
 
@@ -84,7 +88,19 @@ class MarkCompact final : public GarbageCollector {
   bool SigbusHandler(siginfo_t* info) REQUIRES(!lock_) NO_THREAD_SAFETY_ANALYSIS;
 
   GcType GetGcType() const override {
-    return kGcTypeFull;
+    return young_gen_ ? kGcTypeSticky : kGcTypeFull;
+  }
+
+  // Select whether the next cycle collects only the young generation. Has no
+  // effect unless generational mode is enabled and an old generation exists.
+  // Must be called before Run().
+  void SetYoungGen(bool young_gen);
+  // Returns true if the heap is in a state where the next cycle can be a young
+  // one. Full compaction is requested periodically to reclaim garbage that
+  // accumulates in the old generation.
+  bool ShouldDoYoungGc() const {
+    return use_generational_ && old_gen_end_ > moving_space_begin_ &&
+           young_gc_count_ < kMaxYoungGcsBetweenFullGcs;
   }
 
   CollectorType GetCollectorType() const override {
@@ -172,6 +188,7 @@ class MarkCompact final : public GarbageCollector {
   };
 
  private:
+  class ParallelMarkWorker;
   using ObjReference = mirror::CompressedReference<mirror::Object>;
   static constexpr uint32_t kPageStateMask = (1 << BitSizeOf<uint8_t>()) - 1;
   // Number of bits (live-words) covered by a single chunk-info (below)
@@ -203,7 +220,10 @@ class MarkCompact final : public GarbageCollector {
     // Return offset (within the indexed chunk-info) of the nth live word.
     uint32_t FindNthLiveWordOffset(size_t chunk_idx, uint32_t n) const;
     // Sets all bits in the bitmap corresponding to the given range. Also
-    // returns the bit-index of the first word.
+    // returns the bit-index of the first word. If kAtomic is true, then the
+    // boundary words, which may be shared with other objects, are updated
+    // atomically.
+    template <bool kAtomic = false>
     ALWAYS_INLINE uintptr_t SetLiveWords(uintptr_t begin, size_t size);
     // Count number of live words upto the given bit-index. This is to be used
     // to compute the post-compact address of an old reference.
@@ -269,16 +289,35 @@ class MarkCompact final : public GarbageCollector {
   void FinishPhase() REQUIRES(!Locks::mutator_lock_, !Locks::heap_bitmap_lock_, !lock_);
   void MarkingPhase() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::heap_bitmap_lock_);
   void CompactionPhase() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Lazily create the heap's thread-pool to be used for parallel compaction.
+  // Called without holding mutator-lock as it may spawn threads. Not done in
+  // zygote as it must remain single-threaded across forks.
+  void MaybeCreateCompactionThreadPool(Thread* self) REQUIRES(!Locks::mutator_lock_);
+  // Hand out tasks to the heap's thread-pool workers (if any) to compact
+  // moving-space pages in parallel with gc-thread. Returns the number of
+  // workers started.
+  size_t StartCompactionWorkers(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Called by compaction workers. Claims chunks of to-space pages from the
+  // beginning of the moving space (gc-thread compacts from the end) and
+  // processes them exactly like a mutator would in the SIGBUS handler.
+  void CompactMovingPagesFromWorker(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_);
 
   void SweepSystemWeaks(Thread* self, Runtime* runtime, const bool paused)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::heap_bitmap_lock_);
   // Update the reference at given offset in the given object with post-compact
   // address. [begin, end) is moving-space range.
-  ALWAYS_INLINE void UpdateRef(mirror::Object* obj,
-                               MemberOffset offset,
-                               uint8_t* begin,
-                               uint8_t* end) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Returns the post-compact reference.
+  ALWAYS_INLINE mirror::Object* UpdateRef(mirror::Object* obj,
+                                          MemberOffset offset,
+                                          uint8_t* begin,
+                                          uint8_t* end) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Returns true if a post-compact reference points into the young generation
+  // of the next GC cycle, i.e. to an object allocated after the marking pause.
+  bool IsPostCompactYoungRef(mirror::Object* ref) const {
+    uint8_t* addr = reinterpret_cast<uint8_t*>(ref);
+    return addr >= post_compact_end_ && addr < moving_space_end_;
+  }
 
   // Verify that the gc-root is updated only once. Returns false if the update
   // shouldn't be done.
@@ -339,9 +378,14 @@ class MarkCompact final : public GarbageCollector {
   // which must be within 'obj', into the gPageSize sized memory pointed by 'addr'.
   // Then update the references within the copied objects. The boundary objects are
   // partially updated such that only the references that lie in the page are updated.
-  // This is necessary to avoid cascading userfaults.
-  void CompactPage(mirror::Object* obj, uint32_t offset, uint8_t* addr, bool needs_memset_zero)
-      REQUIRES_SHARED(Locks::mutator_lock_);
+  // This is necessary to avoid cascading userfaults. 'to_space_page' is the
+  // moving-space page where 'addr' will eventually be mapped. It is used for
+  // dirtying cards of objects referring to the young generation.
+  void CompactPage(mirror::Object* obj,
+                   uint32_t offset,
+                   uint8_t* addr,
+                   uint8_t* to_space_page,
+                   bool needs_memset_zero) REQUIRES_SHARED(Locks::mutator_lock_);
   // Compact the bump-pointer space. Pass page that should be used as buffer for
   // userfaultfd.
   template <int kMode>
@@ -425,6 +469,18 @@ class MarkCompact final : public GarbageCollector {
   // Traverse through the reachable objects and mark them.
   void MarkReachableObjects() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
+  // In a young cycle, scan the objects of the old generation and non-moving
+  // space which are on aged cards, i.e. may refer to young objects.
+  void ScanOldGenObjects() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
+  // In a young cycle, mark and push the non-moving space objects allocated
+  // since the last GC, as they are considered part of the old generation
+  // without having their references recorded in the card-table.
+  void MarkNonMovingSpaceAllocStack() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
+  // Establish the old generation of the next young cycle at the end of this
+  // cycle by setting the mark-bits of the objects in it.
+  void UpdateOldGen(bool compacted) REQUIRES_SHARED(Locks::mutator_lock_);
   // Scan (only) immune spaces looking for references into the garbage collected
   // spaces.
   void UpdateAndMarkModUnion() REQUIRES_SHARED(Locks::mutator_lock_)
@@ -444,11 +500,25 @@ class MarkCompact final : public GarbageCollector {
       REQUIRES(Locks::heap_bitmap_lock_);
   void ExpandMarkStack() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
+  // Same as ProcessMarkStack(), but drains the mark-stack using the heap's
+  // thread-pool workers, if available, along with the gc-thread. Each thread
+  // has its own work-stealing stack. Must only be called concurrently (not in
+  // a pause). Falls back to ProcessMarkStack() if there are no workers.
+  void ProcessMarkStackParallel() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
+  // Marking loop run by every thread participating in parallel marking. Returns
+  // when all the threads run out of work.
+  void ParallelMarkLoop(ParallelMarkWorker* worker)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
 
   // Scan object for references. If kUpdateLivewords is true then set bits in
-  // the live-words bitmap and add size to chunk-info.
-  template <bool kUpdateLiveWords>
-  void ScanObject(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_)
+  // the live-words bitmap and add size to chunk-info. If kParallel is true,
+  // then 'worker' is where the newly marked objects are pushed and counters are
+  // updated.
+  template <bool kUpdateLiveWords, bool kParallel = false>
+  void ScanObject(mirror::Object* obj, ParallelMarkWorker* worker = nullptr)
+      REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
   // Push objects to the mark-stack right after successfully marking objects.
   void PushOnMarkStack(mirror::Object* obj)
@@ -457,8 +527,13 @@ class MarkCompact final : public GarbageCollector {
 
   // Update the live-words bitmap as well as add the object size to the
   // chunk-info vector. Both are required for computation of post-compact addresses.
-  // Also updates freed_objects_ counter.
-  void UpdateLivenessInfo(mirror::Object* obj, size_t obj_size)
+  // Also updates freed_objects_ counter. If kParallel is true, then the shared
+  // data-structures are updated atomically and the counters in 'worker' are
+  // updated instead.
+  template <bool kParallel = false>
+  void UpdateLivenessInfo(mirror::Object* obj,
+                          size_t obj_size,
+                          ParallelMarkWorker* worker = nullptr)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   void ProcessReferences(Thread* self)
@@ -475,6 +550,15 @@ class MarkCompact final : public GarbageCollector {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
 
+  // Mark the object and push it on the worker's stack. Used during parallel
+  // marking.
+  void ParallelMarkObject(mirror::Object* obj,
+                          mirror::Object* holder,
+                          MemberOffset offset,
+                          ParallelMarkWorker* worker)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
+
   template <bool kParallel>
   bool MarkObjectNonNullNoPush(mirror::Object* obj,
                                mirror::Object* holder = nullptr,
@@ -604,6 +688,16 @@ class MarkCompact final : public GarbageCollector {
   // to synchronize on updated_roots_ in debug-builds.
   Mutex lock_;
   accounting::ObjectStack* mark_stack_;
+  // Per-thread state for parallel marking. Index 0 is used by gc-thread.
+  // Lazily allocated on first use and then retained.
+  std::vector<std::unique_ptr<ParallelMarkWorker>> parallel_mark_workers_;
+  // Number of parallel marking threads participating in the current round.
+  size_t parallel_mark_num_workers_;
+  // Index into mark_stack_ up to which objects have been claimed by parallel
+  // marking threads.
+  std::atomic<size_t> parallel_mark_stack_idx_;
+  // Number of parallel marking threads which still (may) have work.
+  std::atomic<size_t> parallel_mark_active_workers_;
   // Special bitmap wherein all the bits corresponding to an object are set.
   // TODO: make LiveWordsBitmap encapsulated in this class rather than a
   // pointer. We tend to access its members in performance-sensitive
@@ -746,6 +840,11 @@ class MarkCompact final : public GarbageCollector {
   // black_dense_end_) is considered to be densely populated with reachable
   // objects and hence is not compacted.
   uint8_t* black_dense_end_;
+  // In generational mode, [moving_space_begin_, old_gen_end_) is the old
+  // generation, whose objects are retained, with their mark-bits set, across
+  // GC cycles. A young cycle neither compacts nor reclaims the old generation.
+  // Set to moving_space_begin_ when there is no old generation. Page aligned.
+  uint8_t* old_gen_end_;
   // moving-space's end pointer at the marking pause. All allocations beyond
   // this will be considered black in the current GC cycle. Aligned up to page
   // size.
@@ -753,6 +852,8 @@ class MarkCompact final : public GarbageCollector {
   // End of compacted space. Use for computing post-compact addr of black
   // allocated objects. Aligned up to page size.
   uint8_t* post_compact_end_;
+  // End of the last compacted object, i.e. post_compact_end_ before aligning up.
+  uint8_t* post_compact_objs_end_;
   // Cache (black_allocations_begin_ - post_compact_end_) for post-compact
   // address computations.
   ptrdiff_t black_objs_slide_diff_;
@@ -773,6 +874,11 @@ class MarkCompact final : public GarbageCollector {
   // in MarkingPause(). It reaches the correct count only once the marking phase
   // is completed.
   int32_t freed_objects_;
+  // Number of objects in the old generation. Used to exclude them from
+  // freed_objects_ in young cycles.
+  int32_t old_gen_objects_;
+  // Number of young cycles performed since the last full one.
+  size_t young_gc_count_;
   // Userfault file descriptor, accessed only by the GC itself.
   // kFallbackMode value indicates that we are in the fallback mode.
   int uffd_;
@@ -789,8 +895,14 @@ class MarkCompact final : public GarbageCollector {
   // When using SIGBUS feature, this counter is used by mutators to claim a page
   // out of compaction buffers to be used for the entire compaction cycle.
   std::atomic<uint16_t> compaction_buffer_counter_;
+  // Next to-space page index to be claimed by compaction workers.
+  std::atomic<size_t> compaction_worker_page_idx_;
   // True while compacting.
   bool compacting_;
+  // True if young/old generational collection is enabled.
+  const bool use_generational_;
+  // True if the current cycle collects only the young generation.
+  bool young_gen_;
   // Set to true in MarkingPause() to indicate when allocation_stack_ should be
   // checked in IsMarked() for black allocations.
   bool marking_done_;
@@ -812,12 +924,14 @@ class MarkCompact final : public GarbageCollector {
   class CheckpointMarkThreadRoots;
   template <size_t kBufferSize>
   class ThreadRootsVisitor;
-  class RefFieldsVisitor;
+  template <bool kParallel> class RefFieldsVisitor;
   template <bool kCheckBegin, bool kCheckEnd> class RefsUpdateVisitor;
+  class ParallelMarkTask;
   class ArenaPoolPageUpdater;
   class ClassLoaderRootsUpdater;
   class LinearAllocPageUpdater;
   class ImmuneSpaceUpdateObjVisitor;
+  class CompactionWorkerTask;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(MarkCompact);
 };
@@ -16,6 +16,7 @@
 
 #include "mark_sweep.h"
 
+#include <algorithm>
 #include <atomic>
 #include <climits>
 #include <functional>
@@ -41,6 +42,7 @@
 #include "gc/space/space-inl.h"
 #include "mark_sweep-inl.h"
 #include "mirror/object-inl.h"
+#include "mirror/object_array-inl.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
@@ -64,6 +66,12 @@ static constexpr bool kParallelRecursiveMark = true;
 // ProcessMarkStack with very small mark stacks.
 static constexpr size_t kMinimumParallelMarkStackSize = 128;
 static constexpr bool kParallelProcessMarkStack = true;
+// While some thread running mark stack tasks is idle, a task gives half of its local mark stack to
+// the thread pool once it holds at least this many objects, instead of waiting for it to overflow.
+static constexpr size_t kMinimumMarkStackDonationSize = 64;
+// Object arrays with at least twice this many elements are scanned in slices of this size, by
+// separate tasks, so that a single large array does not serialize marking.
+static constexpr int32_t kObjectArraySliceLength = 1024;
 
 // Profiling and information flags.
 static constexpr bool kProfileLargeObjects = false;
@@ -96,6 +104,8 @@ MarkSweep::MarkSweep(Heap* heap, bool is_concurrent, const std::string& name_pre
       current_space_bitmap_(nullptr),
       mark_bitmap_(nullptr),
       mark_stack_(nullptr),
+      mark_stack_tasks_in_flight_(0),
+      mark_stack_thread_count_(0u),
       gc_barrier_(new Barrier(0)),
       mark_stack_lock_("mark sweep mark stack lock", kMarkSweepMarkStackLock),
       is_concurrent_(is_concurrent),
@@ -675,6 +685,7 @@ class MarkSweep::MarkStackTask : public Task {
     if (kCountTasks) {
       ++mark_sweep_->work_chunks_created_;
     }
+    mark_sweep_->mark_stack_tasks_in_flight_.fetch_add(1, std::memory_order_relaxed);
   }
 
   static constexpr size_t kMaxSize = 1 * KB;
@@ -752,6 +763,7 @@ class MarkSweep::MarkStackTask : public Task {
     if (kCountTasks) {
       ++mark_sweep_->work_chunks_deleted_;
     }
+    mark_sweep_->mark_stack_tasks_in_flight_.fetch_sub(1, std::memory_order_relaxed);
   }
 
   MarkSweep* const mark_sweep_;
@@ -765,18 +777,64 @@ class MarkSweep::MarkStackTask : public Task {
       REQUIRES_SHARED(Locks::mutator_lock_) {
     if (UNLIKELY(mark_stack_pos_ == kMaxSize)) {
       // Mark stack overflow, give 1/2 the stack to the thread pool as a new work task.
-      mark_stack_pos_ /= 2;
-      auto* task = new MarkStackTask(thread_pool_,
-                                     mark_sweep_,
-                                     kMaxSize - mark_stack_pos_,
-                                     mark_stack_ + mark_stack_pos_);
-      thread_pool_->AddTask(Thread::Current(), task);
+      DonateHalfOfMarkStack();
     }
     DCHECK(obj != nullptr);
     DCHECK_LT(mark_stack_pos_, kMaxSize);
     mark_stack_[mark_stack_pos_++].Assign(obj);
   }
 
+  void DonateHalfOfMarkStack() REQUIRES_SHARED(Locks::mutator_lock_) {
+    const size_t old_mark_stack_pos = mark_stack_pos_;
+    mark_stack_pos_ /= 2;
+    auto* task = new MarkStackTask(thread_pool_,
+                                   mark_sweep_,
+                                   old_mark_stack_pos - mark_stack_pos_,
+                                   mark_stack_ + mark_stack_pos_);
+    thread_pool_->AddTask(Thread::Current(), task);
+  }
+
+  // If a large object array, mark its class and scan its elements in slices, all but the first
+  // one in separate tasks. Returns whether `obj` was handled.
+  bool MaybeScanObjectArrayInSlices(mirror::Object* obj)
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (kUseFinger || mark_sweep_->mark_stack_thread_count_ <= 1u) {
+      return false;
+    }
+    mirror::Class* klass = obj->GetClass<kVerifyNone, kWithoutReadBarrier>();
+    if (klass->GetClassFlags<kVerifyNone>() != mirror::kClassFlagObjectArray) {
+      return false;
+    }
+    mirror::ObjectArray<mirror::Object>* array =
+        obj->AsObjectArray<mirror::Object, kVerifyNone>().Ptr();
+    const int32_t length = array->GetLength<kVerifyNone>();
+    if (length < 2 * kObjectArraySliceLength) {
+      return false;
+    }
+    MarkObjectParallelVisitor mark_visitor(this, mark_sweep_);
+    mark_visitor(obj, mirror::Object::ClassOffset(), /* is_static= */ false);
+    for (int32_t begin = kObjectArraySliceLength; begin < length; ) {
+      int32_t end = std::min(begin + kObjectArraySliceLength, length);
+      mark_sweep_->AddObjectArraySliceTask(thread_pool_, array, begin, end);
+      begin = end;
+    }
+    MarkObjectArraySlice(array, 0, kObjectArraySliceLength);
+    return true;
+  }
+
+  ALWAYS_INLINE void MarkObjectArraySlice(mirror::ObjectArray<mirror::Object>* array,
+                                          int32_t begin,
+                                          int32_t end)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    MarkObjectParallelVisitor mark_visitor(this, mark_sweep_);
+    for (int32_t i = begin; i != end; ++i) {
+      mark_visitor(array,
+                   mirror::ObjectArray<mirror::Object>::OffsetOfElement(i),
+                   /* is_static= */ false);
+    }
+  }
+
   void Finalize() override {
     delete this;
   }
@@ -809,11 +867,55 @@ class MarkSweep::MarkStackTask : public Task {
         obj = mark_stack_[--mark_stack_pos_].AsMirrorPtr();
       }
       DCHECK(obj != nullptr);
-      visitor(obj);
+      if (!MaybeScanObjectArrayInSlices(obj)) {
+        visitor(obj);
+      }
+      // Share the work with idle threads before it accumulates here.
+      if (!kUseFinger &&
+          mark_stack_pos_ >= kMinimumMarkStackDonationSize &&
+          mark_sweep_->HasIdleMarkStackThreads()) {
+        DonateHalfOfMarkStack();
+      }
     }
   }
 };
 
+class MarkSweep::ObjectArraySliceTask : public MarkStackTask<false> {
+ public:
+  ObjectArraySliceTask(ThreadPool* thread_pool,
+                       MarkSweep* mark_sweep,
+                       mirror::ObjectArray<mirror::Object>* array,
+                       int32_t begin,
+                       int32_t end)
+      : MarkStackTask<false>(thread_pool, mark_sweep, /* mark_stack_size= */ 0u, nullptr),
+        array_(array),
+        begin_(begin),
+        end_(end) {}
+
+ protected:
+  mirror::ObjectArray<mirror::Object>* const array_;
+  const int32_t begin_;
+  const int32_t end_;
+
+  void Finalize() override {
+    delete this;
+  }
+
+  void Run(Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    MarkObjectArraySlice(array_, begin_, end_);
+    // Finish by emptying our local mark stack.
+    MarkStackTask::Run(self);
+  }
+};
+
+void MarkSweep::AddObjectArraySliceTask(ThreadPool* thread_pool,
+                                        mirror::ObjectArray<mirror::Object>* array,
+                                        int32_t begin,
+                                        int32_t end) {
+  thread_pool->AddTask(Thread::Current(),
+                       new ObjectArraySliceTask(thread_pool, this, array, begin, end));
+}
+
 class MarkSweep::CardScanTask : public MarkStackTask<false> {
  public:
   CardScanTask(ThreadPool* thread_pool,
@@ -935,10 +1037,7 @@ void MarkSweep::ScanGrayObjects(bool paused, uint8_t minimum_age) {
     // Note: the card scan below may dirty new cards (and scan them)
     // as a side effect when a Reference object is encountered and
     // queued during the marking. See b/11465268.
-    thread_pool->SetMaxActiveWorkers(thread_count - 1);
-    thread_pool->StartWorkers(self);
-    thread_pool->Wait(self, true, true);
-    thread_pool->StopWorkers(self);
+    RunMarkStackTasks(self, thread_count);
   } else {
     for (const auto& space : GetHeap()->GetContinuousSpaces()) {
       if (space->GetMarkBitmap() != nullptr) {
@@ -1050,10 +1149,7 @@ void MarkSweep::RecursiveMark() {
                                                begin);
             thread_pool->AddTask(self, task);
           }
-          thread_pool->SetMaxActiveWorkers(thread_count - 1);
-          thread_pool->StartWorkers(self);
-          thread_pool->Wait(self, true, true);
-          thread_pool->StopWorkers(self);
+          RunMarkStackTasks(self, thread_count);
         } else {
           // This function does not handle heap end increasing, so we must use the space end.
           uintptr_t begin = reinterpret_cast<uintptr_t>(space->Begin());
@@ -1229,6 +1325,9 @@ void MarkSweep::Sweep(bool swap_bitmaps) {
     live_stack->Reset();
     DCHECK(mark_stack_->IsEmpty());
   }
+  // Sweep the large objects first: each of them is released to the system as soon as it is freed,
+  // so this returns most of the freed memory early instead of after sweeping the malloc spaces.
+  SweepLargeObjects(swap_bitmaps);
   for (const auto& space : GetHeap()->GetContinuousSpaces()) {
     if (space->IsContinuousMemMapAllocSpace()) {
       space::ContinuousMemMapAllocSpace* alloc_space = space->AsContinuousMemMapAllocSpace();
@@ -1238,7 +1337,6 @@ void MarkSweep::Sweep(bool swap_bitmaps) {
       RecordFree(alloc_space->Sweep(swap_bitmaps));
     }
   }
-  SweepLargeObjects(swap_bitmaps);
 }
 
 void MarkSweep::SweepLargeObjects(bool swap_bitmaps) {
@@ -1312,16 +1410,24 @@ void MarkSweep::ProcessMarkStackParallel(size_t thread_count) {
     thread_pool->AddTask(self, new MarkStackTask<false>(thread_pool, this, delta, it));
     it += delta;
   }
-  thread_pool->SetMaxActiveWorkers(thread_count - 1);
-  thread_pool->StartWorkers(self);
-  thread_pool->Wait(self, true, true);
-  thread_pool->StopWorkers(self);
+  RunMarkStackTasks(self, thread_count);
   mark_stack_->Reset();
   CHECK_EQ(work_chunks_created_.load(std::memory_order_seq_cst),
            work_chunks_deleted_.load(std::memory_order_seq_cst))
       << " some of the work chunks were leaked";
 }
 
+void MarkSweep::RunMarkStackTasks(Thread* self, size_t thread_count) {
+  ThreadPool* thread_pool = GetHeap()->GetThreadPool();
+  mark_stack_thread_count_ = thread_count;
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, true);
+  thread_pool->StopWorkers(self);
+  mark_stack_thread_count_ = 0u;
+  DCHECK_EQ(mark_stack_tasks_in_flight_.load(std::memory_order_relaxed), 0);
+}
+
 // Scan anything that's on the mark stack.
 void MarkSweep::ProcessMarkStack(bool paused) {
   TimingLogger::ScopedTiming t(paused ? "(Paused)ProcessMarkStack" : __FUNCTION__, GetTimings());
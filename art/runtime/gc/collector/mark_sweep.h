@@ -34,10 +34,12 @@ namespace art HIDDEN {
 namespace mirror {
 class Class;
 class Object;
+template<class T> class ObjectArray;
 class Reference;
 }  // namespace mirror
 
 class Thread;
+class ThreadPool;
 enum VisitRootFlags : uint8_t;
 
 namespace gc {
@@ -287,6 +289,25 @@ class MarkSweep : public GarbageCollector {
       REQUIRES(!mark_stack_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Run the mark stack tasks added to the heap's thread pool with `thread_count` threads, including
+  // the calling thread, and wait for them to finish.
+  void RunMarkStackTasks(Thread* self, size_t thread_count)
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Add a task marking the elements [begin, end) of `array` to `thread_pool`.
+  void AddObjectArraySliceTask(ThreadPool* thread_pool,
+                               mirror::ObjectArray<mirror::Object>* array,
+                               int32_t begin,
+                               int32_t end);
+
+  // Whether a thread running mark stack tasks is idle, i.e. there are fewer tasks than threads.
+  // Tasks then give part of their work to the thread pool, see `MarkStackTask`.
+  bool HasIdleMarkStackThreads() const {
+    return static_cast<size_t>(mark_stack_tasks_in_flight_.load(std::memory_order_relaxed)) <
+        mark_stack_thread_count_;
+  }
+
   // Used to Get around thread safety annotations. The call is from MarkingPhase and is guarded by
   // IsExclusiveHeld.
   void RevokeAllThreadLocalAllocationStacks(Thread* self) NO_THREAD_SAFETY_ANALYSIS;
@@ -328,6 +349,10 @@ class MarkSweep : public GarbageCollector {
   AtomicInteger overhead_time_;
   AtomicInteger work_chunks_created_;
   AtomicInteger work_chunks_deleted_;
+  // Number of mark stack tasks created and not yet finished, and number of threads running them
+  // in `RunMarkStackTasks()` (zero outside of it).
+  AtomicInteger mark_stack_tasks_in_flight_;
+  size_t mark_stack_thread_count_;
   AtomicInteger mark_null_count_;
   AtomicInteger mark_immune_count_;
   AtomicInteger mark_fastpath_count_;
@@ -346,6 +371,7 @@ class MarkSweep : public GarbageCollector {
   class CheckpointMarkThreadRoots;
   class DelayReferenceReferentVisitor;
   template<bool kUseFinger> class MarkStackTask;
+  class ObjectArraySliceTask;
   class MarkObjectSlowPath;
   class RecursiveMarkTask;
   class ScanObjectParallelVisitor;
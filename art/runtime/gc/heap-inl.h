@@ -269,6 +269,52 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
   return obj.Ptr();
 }
 
+template <typename PreFenceVisitor, typename PostFenceVisitor>
+inline size_t Heap::AllocObjectsInTlab(Thread* self,
+                                       ObjPtr<mirror::Class> klass,
+                                       size_t byte_count,
+                                       size_t max_count,
+                                       AllocatorType allocator,
+                                       const PreFenceVisitor& pre_fence_visitor,
+                                       const PostFenceVisitor& post_fence_visitor) {
+  // TLAB allocations do not use the allocation stack, so the only per-object bookkeeping skipped
+  // here is the instrumented one.
+  static_assert(!AllocatorHasAllocationStack(kAllocatorTypeTLAB));
+  static_assert(!AllocatorHasAllocationStack(kAllocatorTypeRegionTLAB));
+  if (!IsTLABAllocator(allocator) ||
+      ShouldAllocLargeObject(klass, byte_count) ||
+      alloc_listener_.load(std::memory_order_seq_cst) != nullptr ||
+      IsAllocTrackingEnabled() ||
+      gc_stress_mode_ ||
+      Runtime::Current()->HasStatsEnabled()) {
+    return 0u;
+  }
+  byte_count = RoundUp(byte_count, space::BumpPointerSpace::kAlignment);
+  const size_t count = std::min(max_count, self->TlabSize() / byte_count);
+  if (count == 0u) {
+    return 0u;
+  }
+  uint8_t* const begin = reinterpret_cast<uint8_t*>(self->AllocTlab(byte_count * count, count));
+  {
+    ScopedAssertNoThreadSuspension sants("No thread suspension during pre-fence visitor");
+    for (size_t i = 0; i != count; ++i) {
+      mirror::Object* obj = reinterpret_cast<mirror::Object*>(begin + i * byte_count);
+      obj->SetClass(klass);
+      if (kUseBakerReadBarrier) {
+        obj->AssertReadBarrierState();
+      }
+      pre_fence_visitor(obj, byte_count);
+    }
+  }
+  QuasiAtomic::ThreadFenceForConstructor();
+  for (size_t i = 0; i != count; ++i) {
+    mirror::Object* obj = reinterpret_cast<mirror::Object*>(begin + i * byte_count);
+    VerifyObject(obj);
+    post_fence_visitor(obj, i);
+  }
+  return count;
+}
+
 // The size of a thread-local allocation stack in the number of references.
 static constexpr size_t kThreadLocalAllocationStackSize = 128;
 
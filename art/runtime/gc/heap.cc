@@ -16,6 +16,7 @@
 
 #include "heap.h"
 
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -29,6 +30,7 @@
 #include "android-base/stringprintf.h"
 #include "android-base/thread_annotations.h"
 #include "art_field-inl.h"
+#include "art_method-inl.h"
 #include "backtrace_helper.h"
 #include "base/allocator.h"
 #include "base/arena_allocator.h"
@@ -72,7 +74,7 @@
 #include "gc/space/space-inl.h"
 #include "gc/space/zygote_space.h"
 #include "gc/task_processor.h"
-#include "gc/verification.h"
+#include "gc/verification-inl.h"
 #include "gc_pause_listener.h"
 #include "gc_root.h"
 #include "handle_scope-inl.h"
@@ -91,6 +93,7 @@
 #include "mirror/object_array-inl.h"
 #include "mirror/reference-inl.h"
 #include "mirror/var_handle.h"
+#include "monitor_pool.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "oat/image.h"
 #include "obj_ptr-inl.h"
@@ -101,8 +104,10 @@
 #include "runtime.h"
 #include "javaheapprof/javaheapsampler.h"
 #include "scoped_thread_state_change-inl.h"
+#include "stack.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "verify_object-inl.h"
 #include "well_known_classes.h"
 
@@ -310,9 +315,16 @@ Heap::Heap(size_t initial_size,
            bool measure_gc_performance,
            bool use_homogeneous_space_compaction_for_oom,
            bool use_generational_cc,
+           bool use_generational_cmc,
            uint64_t min_interval_homogeneous_space_compaction_by_oom,
            bool dump_region_info_before_gc,
-           bool dump_region_info_after_gc)
+           bool dump_region_info_after_gc,
+           double gc_cpu_budget,
+           uint64_t gc_pause_target_ns,
+           bool attribute_native_gcs,
+           size_t verify_heap_slice_bytes,
+           bool zygote_compaction_remap,
+           bool use_transparent_huge_pages)
     : non_moving_space_(nullptr),
       rosalloc_space_(nullptr),
       dlmalloc_space_(nullptr),
@@ -353,6 +365,7 @@ Heap::Heap(size_t initial_size,
       process_state_update_lock_("process state update lock", kPostMonitorLock),
       min_foreground_target_footprint_(0),
       min_foreground_concurrent_start_bytes_(0),
+      growth_controller_(gc_cpu_budget, gc_pause_target_ns),
       concurrent_start_bytes_(std::numeric_limits<size_t>::max()),
       total_bytes_freed_ever_(0),
       total_objects_freed_ever_(0),
@@ -360,6 +373,8 @@ Heap::Heap(size_t initial_size,
       native_bytes_registered_(0),
       old_native_bytes_allocated_(0),
       native_objects_notified_(0),
+      attribute_native_gcs_(attribute_native_gcs),
+      native_gc_call_sites_lock_("native GC call sites lock", kDefaultMutexLevel),
       num_bytes_freed_revoke_(0),
       num_bytes_alive_after_gc_(0),
       verify_missing_card_marks_(false),
@@ -372,6 +387,12 @@ Heap::Heap(size_t initial_size,
       verify_pre_sweeping_rosalloc_(verify_pre_sweeping_rosalloc),
       verify_post_gc_rosalloc_(verify_post_gc_rosalloc),
       gc_stress_mode_(gc_stress_mode),
+      verify_heap_slice_bytes_(verify_heap_slice_bytes),
+      verify_heap_slice_space_index_(0),
+      verify_heap_slice_cursor_(0),
+      verify_heap_slice_count_(0),
+      verify_heap_slice_rounds_(0),
+      zygote_compaction_remap_(zygote_compaction_remap),
       /* For GC a lot mode, we limit the allocation stacks to be kGcAlotInterval allocations. This
        * causes a lot of GC since we do a GC for alloc whenever the stack is full. When heap
        * verification is enabled, we limit the size of allocation stacks to speed up their
@@ -411,6 +432,7 @@ Heap::Heap(size_t initial_size,
       pending_heap_trim_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
       use_generational_cc_(use_generational_cc),
+      use_generational_cmc_(use_generational_cmc),
       running_collection_is_blocking_(false),
       blocking_gc_count_(0U),
       blocking_gc_time_(0U),
@@ -423,6 +445,7 @@ Heap::Heap(size_t initial_size,
           "blocking gc count rate histogram", 1U, kGcCountRateMaxBucketCount),
       alloc_tracking_enabled_(false),
       alloc_record_depth_(AllocRecordObjectMap::kDefaultAllocStackDepth),
+      alloc_record_sample_interval_(0),
       backtrace_lock_(nullptr),
       seen_backtrace_count_(0u),
       unique_backtrace_count_(0u),
@@ -432,7 +455,10 @@ Heap::Heap(size_t initial_size,
       boot_image_spaces_(),
       boot_images_start_address_(0u),
       boot_images_size_(0u),
-      pre_oome_gc_count_(0u) {
+      pre_oome_gc_count_(0u),
+      tlab_refill_count_(0u),
+      tlab_grow_count_(0u),
+      tlab_shrink_count_(0u) {
   if (VLOG_IS_ON(heap) || VLOG_IS_ON(startup)) {
     LOG(INFO) << "Heap() entering";
   }
@@ -653,6 +679,9 @@ Heap::Heap(size_t initial_size,
     CHECK(region_space_mem_map.IsValid()) << "No region space mem map";
     region_space_ = space::RegionSpace::Create(
         kRegionSpaceName, std::move(region_space_mem_map), use_generational_cc_);
+    if (use_transparent_huge_pages) {
+      region_space_->EnableHugePages();
+    }
     AddSpace(region_space_);
   } else if (IsMovingGc(foreground_collector_type_)) {
     // Create bump pointer spaces.
@@ -731,6 +760,9 @@ Heap::Heap(size_t initial_size,
   card_table_.reset(accounting::CardTable::Create(reinterpret_cast<uint8_t*>(kMinHeapAddress),
                                                   4 * GB - kMinHeapAddress));
   CHECK(card_table_.get() != nullptr) << "Failed to create card table";
+  if (use_transparent_huge_pages) {
+    card_table_->EnableHugePages();
+  }
   if (foreground_collector_type_ == kCollectorTypeCC && kUseTableLookupReadBarrier) {
     rb_table_.reset(new accounting::ReadBarrierTable());
     DCHECK(rb_table_->IsAllCleared());
@@ -796,7 +828,7 @@ Heap::Heap(size_t initial_size,
       garbage_collectors_.push_back(semi_space_collector_);
     }
     if (MayUseCollector(kCollectorTypeCMC)) {
-      mark_compact_ = new collector::MarkCompact(this);
+      mark_compact_ = new collector::MarkCompact(this, use_generational_cmc_);
       garbage_collectors_.push_back(mark_compact_);
     }
     if (MayUseCollector(kCollectorTypeCC)) {
@@ -1034,6 +1066,31 @@ void Heap::IncrementDisableThreadFlip(Thread* self) {
   }
 }
 
+void Heap::PinMovableObject(Thread* self, ObjPtr<mirror::Object> obj) {
+  DCHECK(IsMovableObject(obj));
+  if (gUseReadBarrier && region_space_ != nullptr && region_space_->HasAddress(obj.Ptr())) {
+    // The region is not evacuated while pinned, so there is no need to wait for the thread flip.
+    region_space_->PinRegionOf(obj.Ptr());
+  } else if (!gUseReadBarrier && !gUseUserfaultfd) {
+    IncrementDisableMovingGC(self);
+  } else {
+    // For the CC and CMC collector, we only need to wait for the thread flip rather
+    // than the whole GC to occur thanks to the to-space invariant.
+    IncrementDisableThreadFlip(self);
+  }
+}
+
+void Heap::UnpinMovableObject(Thread* self, ObjPtr<mirror::Object> obj) {
+  DCHECK(IsMovableObject(obj));
+  if (gUseReadBarrier && region_space_ != nullptr && region_space_->HasAddress(obj.Ptr())) {
+    region_space_->UnpinRegionOf(obj.Ptr());
+  } else if (!gUseReadBarrier && !gUseUserfaultfd) {
+    DecrementDisableMovingGC(self);
+  } else {
+    DecrementDisableThreadFlip(self);
+  }
+}
+
 void Heap::EnsureObjectUserfaulted(ObjPtr<mirror::Object> obj) {
   if (gUseUserfaultfd) {
     // Use volatile to ensure that compiler loads from memory to trigger userfaults, if required.
@@ -1307,6 +1364,17 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
   os << "Total blocking GC count: " << GetBlockingGcCount() << "\n";
   os << "Total blocking GC time: " << PrettyDuration(GetBlockingGcTime()) << "\n";
   os << "Total pre-OOME GC count: " << GetPreOomeGcCount() << "\n";
+  {
+    MutexLock mu(Thread::Current(), process_state_update_lock_);
+    if (growth_controller_.IsEnabled()) {
+      growth_controller_.Dump(os);
+    }
+  }
+  if (kUseAdaptiveTlabs) {
+    os << "TLAB refills: " << tlab_refill_count_.load(std::memory_order_relaxed)
+       << " grown: " << tlab_grow_count_.load(std::memory_order_relaxed)
+       << " shrunk: " << tlab_shrink_count_.load(std::memory_order_relaxed) << "\n";
+  }
   {
     MutexLock mu(Thread::Current(), *gc_complete_lock_);
     if (gc_count_rate_histogram_.SampleSize() > 0U) {
@@ -1332,6 +1400,15 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
   os << "Total native bytes at last GC: "
      << old_native_bytes_allocated_.load(std::memory_order_relaxed) << "\n";
 
+  if (attribute_native_gcs_) {
+    DumpNativeGcCallSites(os);
+  }
+
+  task_processor_->DumpStats(os);
+  if (region_space_ != nullptr) {
+    region_space_->DumpLivenessHistogram(os);
+  }
+
   BaseMutex::DumpAll(os);
 }
 
@@ -1354,6 +1431,21 @@ void Heap::ResetGcPerformanceInfo() {
   blocking_gc_count_ = 0;
   blocking_gc_time_ = 0;
   pre_oome_gc_count_.store(0, std::memory_order_relaxed);
+  tlab_refill_count_.store(0, std::memory_order_relaxed);
+  tlab_grow_count_.store(0, std::memory_order_relaxed);
+  tlab_shrink_count_.store(0, std::memory_order_relaxed);
+  {
+    MutexLock mu(Thread::Current(), process_state_update_lock_);
+    growth_controller_.Reset();
+  }
+  {
+    MutexLock mu(Thread::Current(), native_gc_call_sites_lock_);
+    native_gc_call_sites_.clear();
+  }
+  task_processor_->ResetStats(Thread::Current());
+  if (region_space_ != nullptr) {
+    region_space_->ResetLivenessHistogram();
+  }
   gc_count_last_window_ = 0;
   blocking_gc_count_last_window_ = 0;
   last_update_time_gc_count_rate_histograms_ =  // Round down by the window duration.
@@ -1609,6 +1701,8 @@ void Heap::Trim(Thread* self) {
     VLOG(heap) << "Deflating " << count << " monitors took "
         << PrettyDuration(NanoTime() - start_time);
   }
+  // Return the memory of the monitors freed by deflation and by previous GCs.
+  MonitorPool::TrimFreeChunks(self);
   TrimIndirectReferenceTables(self);
   TrimSpaces(self);
   // Trim arenas that may have been used by JIT or verifier.
@@ -2327,6 +2421,9 @@ void Heap::ChangeCollector(CollectorType collector_type) {
         break;
       }
       case kCollectorTypeCMC: {
+        if (use_generational_cmc_) {
+          gc_plan_.push_back(collector::kGcTypeSticky);
+        }
         gc_plan_.push_back(collector::kGcTypeFull);
         if (use_tlab_) {
           ChangeAllocator(kAllocatorTypeTLAB);
@@ -2368,13 +2465,43 @@ void Heap::ChangeCollector(CollectorType collector_type) {
 }
 
 // Special compacting collector which uses sub-optimal bin packing to reduce zygote space size.
+#ifndef __BIONIC__
+#ifndef MREMAP_DONTUNMAP
+#define MREMAP_DONTUNMAP 4
+#endif
+#endif  // __BIONIC__
+
 class ZygoteCompactingCollector final : public collector::SemiSpace {
  public:
-  ZygoteCompactingCollector(gc::Heap* heap, bool is_running_on_memory_tool)
+  // Primitive arrays at least this large have their contents copied by the workers, if any. They
+  // have no references to visit, so the contents are only needed once the compaction is done.
+  static constexpr size_t kMinParallelCopyBytes = 4 * KB;
+  // Number of bytes copied per worker task.
+  static constexpr size_t kParallelCopyTaskBytes = 1 * MB;
+  // Bytes at the start of the arrays copied right away, they cover the header.
+  static constexpr size_t kArrayHeaderCopyBytes = 64;
+
+  ZygoteCompactingCollector(gc::Heap* heap,
+                            bool is_running_on_memory_tool,
+                            ThreadPool* workers,
+                            bool remap_pages)
       : SemiSpace(heap, "zygote collector"),
         bin_live_bitmap_(nullptr),
         bin_mark_bitmap_(nullptr),
-        is_running_on_memory_tool_(is_running_on_memory_tool) {}
+        is_running_on_memory_tool_(is_running_on_memory_tool),
+        workers_(is_running_on_memory_tool ? nullptr : workers),
+        remap_pages_(remap_pages && !is_running_on_memory_tool),
+        pending_copy_bytes_(0),
+        bytes_copied_in_parallel_(0),
+        bytes_remapped_(0),
+        started_workers_(false) {}
+
+  size_t GetBytesCopiedInParallel() const {
+    return bytes_copied_in_parallel_;
+  }
+  size_t GetBytesRemapped() const {
+    return bytes_remapped_;
+  }
 
   void BuildBins(space::ContinuousSpace* space) REQUIRES_SHARED(Locks::mutator_lock_) {
     bin_live_bitmap_ = space->GetLiveBitmap();
@@ -2395,6 +2522,26 @@ class ZygoteCompactingCollector final : public collector::SemiSpace {
   }
 
  private:
+  // A memcpy done by the workers.
+  struct PendingCopy {
+    void* dest;
+    const void* src;
+    size_t size;
+  };
+
+  class CopyTask final : public SelfDeletingTask {
+   public:
+    explicit CopyTask(std::vector<PendingCopy>&& copies) : copies_(std::move(copies)) {}
+    void Run([[maybe_unused]] Thread* self) override {
+      for (const PendingCopy& copy : copies_) {
+        memcpy(copy.dest, copy.src, copy.size);
+      }
+    }
+
+   private:
+    const std::vector<PendingCopy> copies_;
+  };
+
   // Maps from bin sizes to locations.
   std::multimap<size_t, uintptr_t> bins_;
   // Live bitmap of the space which contains the bins.
@@ -2402,6 +2549,109 @@ class ZygoteCompactingCollector final : public collector::SemiSpace {
   // Mark bitmap of the space which contains the bins.
   accounting::ContinuousSpaceBitmap* bin_mark_bitmap_;
   const bool is_running_on_memory_tool_;
+  ThreadPool* const workers_;
+  bool remap_pages_;
+  std::vector<PendingCopy> pending_copies_;
+  size_t pending_copy_bytes_;
+  size_t bytes_copied_in_parallel_;
+  size_t bytes_remapped_;
+  bool started_workers_;
+
+  // Copying the objects keeps our single thread busy. Try to save time on the large primitive
+  // arrays, which make up a good part of the zygote heap.
+  bool IsLargePrimitiveArray(mirror::Object* obj, size_t obj_size)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    return obj_size >= kMinParallelCopyBytes &&
+           obj->GetClass<kVerifyNone, kWithoutReadBarrier>()->IsPrimitiveArray<kVerifyNone>();
+  }
+
+  void FlushPendingCopies() {
+    if (pending_copies_.empty()) {
+      return;
+    }
+    workers_->AddTask(self_, new CopyTask(std::move(pending_copies_)));
+    pending_copies_.clear();
+    pending_copy_bytes_ = 0;
+    if (!started_workers_) {
+      workers_->StartWorkers(self_);
+      started_workers_ = true;
+    }
+  }
+
+  void MarkingPhase() override REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!Locks::heap_bitmap_lock_) {
+    SemiSpace::MarkingPhase();
+    if (workers_ != nullptr) {
+      // The copied arrays must be complete before the mutators resume.
+      TimingLogger::ScopedTiming t("WaitForParallelCopies", GetTimings());
+      FlushPendingCopies();
+      if (started_workers_) {
+        workers_->Wait(self_, /*do_work=*/ true, /*may_hold_locks=*/ true);
+        workers_->StopWorkers(self_);
+      }
+    }
+  }
+
+  // Copy the header of an array with no references to `forward_address` and let the workers copy
+  // the rest.
+  void CopyArrayInParallel(mirror::Object* forward_address, mirror::Object* obj, size_t obj_size) {
+    uint8_t* dest = reinterpret_cast<uint8_t*>(forward_address);
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(obj);
+    const size_t contents_size = obj_size - kArrayHeaderCopyBytes;
+    memcpy(dest, src, kArrayHeaderCopyBytes);
+    pending_copies_.push_back({dest + kArrayHeaderCopyBytes, src + kArrayHeaderCopyBytes,
+                               contents_size});
+    pending_copy_bytes_ += contents_size;
+    bytes_copied_in_parallel_ += contents_size;
+    if (pending_copy_bytes_ >= kParallelCopyTaskBytes) {
+      FlushPendingCopies();
+    }
+  }
+
+  // Place an array with no references which spans at least one full page in the target space at
+  // the same offset within a page, so that we can move its full pages instead of copying them. The
+  // page holding the header is still copied, since the from-space header is used for forwarding.
+  // Returns null if the array should be copied as usual.
+  mirror::Object* RemapArray(mirror::Object* obj, size_t obj_size, size_t alloc_size)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    const uintptr_t src = reinterpret_cast<uintptr_t>(obj);
+    const uintptr_t src_pages_begin = RoundUp(src + 1, gPageSize);
+    const uintptr_t src_pages_end = RoundDown(src + obj_size, gPageSize);
+    if (!remap_pages_ || src_pages_end <= src_pages_begin) {
+      return nullptr;
+    }
+    size_t bytes_allocated, unused_bytes_tl_bulk_allocated;
+    uint8_t* block = reinterpret_cast<uint8_t*>(to_space_->Alloc(
+        self_, alloc_size + gPageSize, &bytes_allocated, nullptr, &unused_bytes_tl_bulk_allocated));
+    if (block == nullptr) {
+      return nullptr;
+    }
+    // The padding before the array is never visited, the zygote space walks its live bitmap.
+    uint8_t* dest = block + ((src - reinterpret_cast<uintptr_t>(block)) & (gPageSize - 1));
+    DCHECK_ALIGNED(dest, kObjectAlignment);
+    uint8_t* dest_pages_begin = dest + (src_pages_begin - src);
+    const size_t pages_size = src_pages_end - src_pages_begin;
+    DCHECK_ALIGNED_PARAM(dest_pages_begin, gPageSize);
+    // The from-space pages are discarded after the compaction anyway.
+    void* ret = mremap(reinterpret_cast<void*>(src_pages_begin),
+                       pages_size,
+                       pages_size,
+                       MREMAP_MAYMOVE | MREMAP_FIXED | MREMAP_DONTUNMAP,
+                       dest_pages_begin);
+    if (ret == MAP_FAILED) {
+      // The source is left untouched on failure, e.g. without kernel support.
+      PLOG(WARNING) << "Failed to remap zygote pages, copying instead";
+      remap_pages_ = false;
+      memcpy(dest_pages_begin, reinterpret_cast<void*>(src_pages_begin), pages_size);
+    } else {
+      bytes_remapped_ += pages_size;
+    }
+    memcpy(dest, obj, src_pages_begin - src);
+    memcpy(dest_pages_begin + pages_size,
+           reinterpret_cast<void*>(src_pages_end),
+           src + obj_size - src_pages_end);
+    return reinterpret_cast<mirror::Object*>(dest);
+  }
 
   void AddBin(size_t size, uintptr_t position) {
     if (is_running_on_memory_tool_) {
@@ -2422,7 +2672,18 @@ class ZygoteCompactingCollector final : public collector::SemiSpace {
       REQUIRES(Locks::heap_bitmap_lock_, Locks::mutator_lock_) {
     size_t obj_size = obj->SizeOf<kDefaultVerifyFlags>();
     size_t alloc_size = RoundUp(obj_size, kObjectAlignment);
-    mirror::Object* forward_address;
+    const bool large_primitive_array = IsLargePrimitiveArray(obj, obj_size);
+    mirror::Object* forward_address =
+        large_primitive_array ? RemapArray(obj, obj_size, alloc_size) : nullptr;
+    if (forward_address != nullptr) {
+      if (to_space_live_bitmap_ != nullptr) {
+        to_space_live_bitmap_->Set(forward_address);
+      } else {
+        GetHeap()->GetNonMovingSpace()->GetLiveBitmap()->Set(forward_address);
+        GetHeap()->GetNonMovingSpace()->GetMarkBitmap()->Set(forward_address);
+      }
+      return forward_address;
+    }
     // Find the smallest bin which we can move obj in.
     auto it = bins_.lower_bound(alloc_size);
     if (it == bins_.end()) {
@@ -2451,7 +2712,11 @@ class ZygoteCompactingCollector final : public collector::SemiSpace {
     }
     // Copy the object over to its new location.
     // Historical note: We did not use `alloc_size` to avoid a Valgrind error.
-    memcpy(reinterpret_cast<void*>(forward_address), obj, obj_size);
+    if (large_primitive_array && workers_ != nullptr) {
+      CopyArrayInParallel(forward_address, obj, obj_size);
+    } else {
+      memcpy(reinterpret_cast<void*>(forward_address), obj, obj_size);
+    }
     if (kUseBakerReadBarrier) {
       obj->AssertReadBarrierState();
       forward_address->AssertReadBarrierState();
@@ -2525,7 +2790,18 @@ void Heap::PreZygoteFork() {
     // Temporarily disable rosalloc verification because the zygote
     // compaction will mess up the rosalloc internal metadata.
     ScopedDisableRosAllocVerification disable_rosalloc_verif(this);
-    ZygoteCompactingCollector zygote_collector(this, is_running_on_memory_tool_);
+    const uint64_t compaction_start_time = NanoTime();
+    // The zygote has no heap thread pool, create one for the compaction only. The runtime waits
+    // for its threads to exit before forking.
+    const bool create_thread_pool = thread_pool_ == nullptr && parallel_gc_threads_ != 0;
+    if (create_thread_pool) {
+      CreateThreadPool(parallel_gc_threads_);
+      WaitForWorkersToBeCreated();
+    }
+    ZygoteCompactingCollector zygote_collector(this,
+                                               is_running_on_memory_tool_,
+                                               thread_pool_.get(),
+                                               zygote_compaction_remap_);
     zygote_collector.BuildBins(non_moving_space_);
     // Create a new bump pointer space which we will compact into.
     space::BumpPointerSpace target_space("zygote bump space", non_moving_space_->End(),
@@ -2578,6 +2854,13 @@ void Heap::PreZygoteFork() {
     non_moving_space_->SetEnd(target_space.End());
     non_moving_space_->SetLimit(target_space.Limit());
     VLOG(heap) << "Create zygote space with size=" << non_moving_space_->Size() << " bytes";
+    if (create_thread_pool) {
+      DeleteThreadPool();
+    }
+    // This is on the boot critical path, always report it. The metrics are reset after forking.
+    LOG(INFO) << "Zygote compaction took " << PrettyDuration(NanoTime() - compaction_start_time)
+              << ", copied " << PrettySize(zygote_collector.GetBytesCopiedInParallel())
+              << " in parallel, remapped " << PrettySize(zygote_collector.GetBytesRemapped());
   }
   // Change the collector to the post zygote one.
   ChangeCollector(foreground_collector_type_);
@@ -2753,7 +3036,9 @@ size_t Heap::GetNativeBytes() {
   // disable GC triggering based on malloc().
   malloc_bytes = 1000;
 #endif
-  return malloc_bytes + native_bytes_registered_.load(std::memory_order_relaxed);
+  // Registrations batched in threads may make the registered bytes temporarily negative.
+  ssize_t registered_bytes = native_bytes_registered_.load(std::memory_order_relaxed);
+  return malloc_bytes + static_cast<size_t>(std::max<ssize_t>(registered_bytes, 0));
   // An alternative would be to get RSS from /proc/self/statm. Empirically, that's no
   // more expensive, and it would allow us to count memory allocated by means other than malloc.
   // However it would change as pages are unmapped and remapped due to memory pressure, among
@@ -2858,6 +3143,7 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
           collector = semi_space_collector_;
           break;
         case kCollectorTypeCMC:
+          mark_compact_->SetYoungGen(gc_type == collector::kGcTypeSticky);
           collector = mark_compact_;
           break;
         case kCollectorTypeCC:
@@ -2901,6 +3187,9 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
                                 << static_cast<size_t>(collector_type_)
                                 << " and gc_type=" << gc_type;
     collector->Run(gc_cause, clear_soft_references || runtime->IsZygote());
+    if (verify_heap_slice_bytes_ != 0) {
+      IncrementalHeapVerification();
+    }
     IncrementFreedEver();
     RequestTrim(self);
     // Collect cleared references.
@@ -3532,8 +3821,12 @@ void Heap::ProcessCards(TimingLogger* timings,
         // The races are we either end up with: Aged card, unaged card. Since we have the
         // checkpoint roots and then we scan / update mod union tables after. We will always
         // scan either card. If we end up with the non aged card, we scan it it in the pause.
-        card_table_->ModifyCardsAtomic(space->Begin(), space->End(), AgeCardVisitor(),
-                                       VoidFunctor());
+        card_table_->ModifyCardsAtomicParallel(Thread::Current(),
+                                               GetThreadPool(),
+                                               space->Begin(),
+                                               space->End(),
+                                               AgeCardVisitor(),
+                                               VoidFunctor());
       }
     }
   }
@@ -3656,6 +3949,124 @@ void Heap::PostGcVerification(collector::GarbageCollector* gc) {
   }
 }
 
+// Check that the references of an object point to valid looking objects. Unlike
+// VerifyReferenceVisitor, this does not depend on the allocation stacks, and works for all the
+// collectors.
+class VerifyHeapSliceVisitor {
+ public:
+  VerifyHeapSliceVisitor(const Verification* verification, size_t* fail_count)
+      : verification_(verification), fail_count_(fail_count) {}
+
+  void operator()(mirror::Object* obj) const REQUIRES_SHARED(Locks::mutator_lock_) {
+    mirror::Class* klass = obj->GetClass<kVerifyNone, kWithoutReadBarrier>();
+    if (!verification_->IsValidClass(klass)) {
+      Fail(obj, mirror::Object::ClassOffset(), klass);
+      // We cannot visit the fields without a valid class.
+      return;
+    }
+    obj->VisitReferences</*kVisitNativeRoots=*/ false, kVerifyNone, kWithoutReadBarrier>(
+        *this, *this);
+  }
+
+  void operator()(ObjPtr<mirror::Object> obj,
+                  MemberOffset offset,
+                  [[maybe_unused]] bool is_static) const REQUIRES_SHARED(Locks::mutator_lock_) {
+    mirror::Object* ref = obj->GetFieldObject<mirror::Object, kVerifyNone, kWithoutReadBarrier>(
+        offset);
+    if (ref != nullptr && !verification_->IsValidObject(ref)) {
+      Fail(obj.Ptr(), offset, ref);
+    }
+  }
+
+  void operator()(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> ref) const
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    operator()(ref, mirror::Reference::ReferentOffset(), /*is_static=*/ false);
+    DCHECK(klass->IsTypeOfReferenceClass());
+  }
+
+  // Native roots are not visited.
+  void VisitRootIfNonNull(
+      [[maybe_unused]] mirror::CompressedReference<mirror::Object>* root) const {}
+  void VisitRoot([[maybe_unused]] mirror::CompressedReference<mirror::Object>* root) const {}
+
+ private:
+  void Fail(mirror::Object* holder, MemberOffset offset, mirror::Object* ref) const
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (*fail_count_ == 0) {
+      // Only log the first failure of a slice, the others are likely related.
+      verification_->LogHeapCorruption(holder, offset, ref, /*fatal=*/ false);
+    }
+    ++*fail_count_;
+  }
+
+  const Verification* const verification_;
+  size_t* const fail_count_;
+};
+
+size_t Heap::VerifyHeapSlice(size_t max_bytes) {
+  Thread* self = Thread::Current();
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
+  size_t fail_count = 0;
+  VerifyHeapSliceVisitor visitor(GetVerification(), &fail_count);
+  size_t remaining = max_bytes;
+  // Visit each space at most once per slice, so that small spaces don't make us loop.
+  for (size_t i = 0; i < continuous_spaces_.size() && remaining != 0; ++i) {
+    if (verify_heap_slice_space_index_ >= continuous_spaces_.size()) {
+      // The spaces may have changed since the last slice, e.g. after the zygote fork.
+      verify_heap_slice_space_index_ = 0;
+      verify_heap_slice_cursor_ = 0;
+      ++verify_heap_slice_rounds_;
+    }
+    space::ContinuousSpace* space = continuous_spaces_[verify_heap_slice_space_index_];
+    accounting::ContinuousSpaceBitmap* bitmap = space->GetLiveBitmap();
+    // The live bitmaps of the region and bump pointer spaces are not kept up to date outside of
+    // the GCs, so we can only verify the spaces with a free list and the image spaces.
+    const bool can_verify = bitmap != nullptr &&
+                            !space->IsRegionSpace() &&
+                            !space->IsBumpPointerSpace();
+    const uintptr_t space_begin = reinterpret_cast<uintptr_t>(space->Begin());
+    const uintptr_t space_end = reinterpret_cast<uintptr_t>(space->End());
+    if (verify_heap_slice_cursor_ < space_begin || verify_heap_slice_cursor_ > space_end) {
+      verify_heap_slice_cursor_ = space_begin;
+    }
+    if (can_verify) {
+      const uintptr_t slice_end =
+          verify_heap_slice_cursor_ + std::min<uintptr_t>(remaining,
+                                                          space_end - verify_heap_slice_cursor_);
+      bitmap->VisitMarkedRange(verify_heap_slice_cursor_, slice_end, visitor);
+      remaining -= slice_end - verify_heap_slice_cursor_;
+      verify_heap_slice_cursor_ = slice_end;
+    } else {
+      verify_heap_slice_cursor_ = space_end;
+    }
+    if (verify_heap_slice_cursor_ == space_end) {
+      ++verify_heap_slice_space_index_;
+    }
+  }
+  ++verify_heap_slice_count_;
+  if (fail_count > 0) {
+    DumpSpaces(LOG_STREAM(ERROR));
+  }
+  return fail_count;
+}
+
+void Heap::IncrementalHeapVerification() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetCurrentGcIteration()->GetTimings());
+  const uint64_t start_time = NanoTime();
+  size_t failures;
+  {
+    ScopedSuspendAll ssa(__FUNCTION__);
+    failures = VerifyHeapSlice(verify_heap_slice_bytes_);
+  }
+  if (failures > 0) {
+    LOG(FATAL) << "Incremental heap verification failed with " << failures << " failures";
+  }
+  VLOG(heap) << "Verified " << PrettySize(verify_heap_slice_bytes_) << " of the heap in "
+             << PrettyDuration(NanoTime() - start_time) << " slices: " << verify_heap_slice_count_
+             << " rounds: " << verify_heap_slice_rounds_;
+}
+
 void Heap::RosAllocVerification(TimingLogger* timings, const char* name) {
   TimingLogger::ScopedTiming t(name, timings);
   for (const auto& space : continuous_spaces_) {
@@ -3789,39 +4200,72 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   const double multiplier = HeapGrowthMultiplier();
   if (gc_type != collector::kGcTypeSticky) {
     // Grow the heap for non sticky GC.
-    uint64_t delta = bytes_allocated * (1.0 / GetTargetHeapUtilization() - 1.0);
-    DCHECK_LE(delta, std::numeric_limits<size_t>::max()) << "bytes_allocated=" << bytes_allocated
-        << " target_utilization_=" << target_utilization_;
-    grow_bytes = std::min(delta, static_cast<uint64_t>(max_free_));
-    grow_bytes = std::max(grow_bytes, static_cast<uint64_t>(min_free_));
-    target_size = bytes_allocated + static_cast<uint64_t>(grow_bytes * multiplier);
+    if (growth_controller_.IsEnabled()) {
+      // The controller accounts for the process state in its budget, so the multiplier is not
+      // applied on top.
+      const std::vector<uint64_t>& pauses = current_gc_iteration_.GetPauseTimes();
+      const uint64_t max_pause_ns =
+          pauses.empty() ? 0u : *std::max_element(pauses.begin(), pauses.end());
+      grow_bytes = growth_controller_.ComputeGrowBytes(NanoTime(),
+                                                       GetBytesAllocatedEver(),
+                                                       current_gc_iteration_.GetDurationNs(),
+                                                       max_pause_ns,
+                                                       CareAboutPauseTimes(),
+                                                       min_free_,
+                                                       max_free_ * foreground_heap_growth_multiplier_);
+      target_size = bytes_allocated + grow_bytes;
+    } else {
+      uint64_t delta = bytes_allocated * (1.0 / GetTargetHeapUtilization() - 1.0);
+      DCHECK_LE(delta, std::numeric_limits<size_t>::max()) << "bytes_allocated=" << bytes_allocated
+          << " target_utilization_=" << target_utilization_;
+      grow_bytes = std::min(delta, static_cast<uint64_t>(max_free_));
+      grow_bytes = std::max(grow_bytes, static_cast<uint64_t>(min_free_));
+      target_size = bytes_allocated + static_cast<uint64_t>(grow_bytes * multiplier);
+    }
     next_gc_type_ = collector::kGcTypeSticky;
   } else {
     collector::GcType non_sticky_gc_type = NonStickyGcType();
-    // Find what the next non sticky collector will be.
-    collector::GarbageCollector* non_sticky_collector = FindCollectorByGcType(non_sticky_gc_type);
-    if (use_generational_cc_) {
-      if (non_sticky_collector == nullptr) {
-        non_sticky_collector = FindCollectorByGcType(collector::kGcTypePartial);
-      }
-      CHECK(non_sticky_collector != nullptr);
-    }
-    double sticky_gc_throughput_adjustment = GetStickyGcThroughputAdjustment(use_generational_cc_);
-
-    // If the throughput of the current sticky GC >= throughput of the non sticky collector, then
-    // do another sticky collection next.
-    // We also check that the bytes allocated aren't over the target_footprint, or
-    // concurrent_start_bytes in case of concurrent GCs, in order to prevent a
-    // pathological case where dead objects which aren't reclaimed by sticky could get accumulated
-    // if the sticky GC throughput always remained >= the full/partial throughput.
     size_t target_footprint = target_footprint_.load(std::memory_order_relaxed);
-    if (current_gc_iteration_.GetEstimatedThroughput() * sticky_gc_throughput_adjustment >=
-        non_sticky_collector->GetEstimatedMeanThroughput() &&
-        non_sticky_collector->NumberOfIterations() > 0 &&
-        bytes_allocated <= (IsGcConcurrent() ? concurrent_start_bytes_ : target_footprint)) {
-      next_gc_type_ = collector::kGcTypeSticky;
+    if (collector_ran == mark_compact_) {
+      // Young and full CMC collections are performed by the same collector
+      // instance, so there is no separate non-sticky collector whose
+      // throughput can be compared against. Instead, rely on the collector to
+      // periodically request a full compaction, and fall back to one as soon
+      // as young collections fail to keep up with the allocation rate.
+      DCHECK(use_generational_cmc_);
+      if (mark_compact_->ShouldDoYoungGc() &&
+          bytes_allocated <= (IsGcConcurrent() ? concurrent_start_bytes_ : target_footprint)) {
+        next_gc_type_ = collector::kGcTypeSticky;
+      } else {
+        next_gc_type_ = non_sticky_gc_type;
+      }
     } else {
-      next_gc_type_ = non_sticky_gc_type;
+      // Find what the next non sticky collector will be.
+      collector::GarbageCollector* non_sticky_collector =
+          FindCollectorByGcType(non_sticky_gc_type);
+      if (use_generational_cc_) {
+        if (non_sticky_collector == nullptr) {
+          non_sticky_collector = FindCollectorByGcType(collector::kGcTypePartial);
+        }
+        CHECK(non_sticky_collector != nullptr);
+      }
+      double sticky_gc_throughput_adjustment =
+          GetStickyGcThroughputAdjustment(use_generational_cc_);
+
+      // If the throughput of the current sticky GC >= throughput of the non sticky collector,
+      // then do another sticky collection next.
+      // We also check that the bytes allocated aren't over the target_footprint, or
+      // concurrent_start_bytes in case of concurrent GCs, in order to prevent a
+      // pathological case where dead objects which aren't reclaimed by sticky could get
+      // accumulated if the sticky GC throughput always remained >= the full/partial throughput.
+      if (current_gc_iteration_.GetEstimatedThroughput() * sticky_gc_throughput_adjustment >=
+              non_sticky_collector->GetEstimatedMeanThroughput() &&
+          non_sticky_collector->NumberOfIterations() > 0 &&
+          bytes_allocated <= (IsGcConcurrent() ? concurrent_start_bytes_ : target_footprint)) {
+        next_gc_type_ = collector::kGcTypeSticky;
+      } else {
+        next_gc_type_ = non_sticky_gc_type;
+      }
     }
     // If we have freed enough memory, shrink the heap back down.
     const size_t adjusted_max_free = static_cast<size_t>(max_free_ * multiplier);
@@ -3963,7 +4407,10 @@ void Heap::RequestConcurrentGCAndSaveObject(Thread* self,
 class Heap::ConcurrentGCTask : public HeapTask {
  public:
   ConcurrentGCTask(uint64_t target_time, GcCause cause, bool force_full, uint32_t gc_num)
-      : HeapTask(target_time), cause_(cause), force_full_(force_full), my_gc_num_(gc_num) {}
+      : HeapTask(target_time, Priority::kHigh),
+        cause_(cause),
+        force_full_(force_full),
+        my_gc_num_(gc_num) {}
   void Run(Thread* self) override {
     Runtime* runtime = Runtime::Current();
     gc::Heap* heap = runtime->GetHeap();
@@ -3972,10 +4419,34 @@ class Heap::ConcurrentGCTask : public HeapTask {
     CHECK_IMPLIES(GCNumberLt(heap->GetCurrentGcNum(), my_gc_num_), runtime->IsShuttingDown(self));
   }
 
+  const void* GetCoalescingKey() const override {
+    return &kCoalescingKey;
+  }
+
+  bool TryCoalesce(HeapTask* other) override {
+    ConcurrentGCTask* other_gc = down_cast<ConcurrentGCTask*>(other);
+    if (!GCNumberLt(my_gc_num_, other_gc->my_gc_num_)) {
+      // We already request that GC.
+      force_full_ = force_full_ || other_gc->force_full_;
+      return true;
+    }
+    if (!GCNumberLt(Runtime::Current()->GetHeap()->GetCurrentGcNum(), my_gc_num_)) {
+      // Our GC already happened, so we would do nothing. Request the new GC instead. We cannot
+      // request a later GC otherwise, since ConcurrentGC() only runs one.
+      cause_ = other_gc->cause_;
+      force_full_ = other_gc->force_full_;
+      my_gc_num_ = other_gc->my_gc_num_;
+      return true;
+    }
+    return false;
+  }
+
  private:
-  const GcCause cause_;
-  const bool force_full_;  // If true, force full (or partial) collection.
-  const uint32_t my_gc_num_;  // Sequence number of requested GC.
+  static constexpr char kCoalescingKey = 0;
+
+  GcCause cause_;
+  bool force_full_;  // If true, force full (or partial) collection.
+  uint32_t my_gc_num_;  // Sequence number of requested GC.
 };
 
 static bool CanAddHeapTask(Thread* self) REQUIRES(!Locks::runtime_shutdown_lock_) {
@@ -4096,12 +4567,17 @@ void Heap::RequestCollectorTransition(CollectorType desired_collector_type, uint
 
 class Heap::HeapTrimTask : public HeapTask {
  public:
-  explicit HeapTrimTask(uint64_t delta_time) : HeapTask(NanoTime() + delta_time) { }
+  explicit HeapTrimTask(uint64_t delta_time)
+      : HeapTask(NanoTime() + delta_time, Priority::kLow) { }
   void Run(Thread* self) override {
     gc::Heap* heap = Runtime::Current()->GetHeap();
     heap->Trim(self);
     heap->ClearPendingTrim(self);
   }
+  // Trim() synchronizes with running GCs itself, like for VMRuntime.trimHeap().
+  bool IsIndependent() const override {
+    return true;
+  }
 };
 
 void Heap::ClearPendingTrim(Thread* self) {
@@ -4263,30 +4739,113 @@ inline void Heap::CheckGCForNative(Thread* self) {
           usleep(kGcWaitSleepMicros);  // Encourage our requested GC to start.
         }
       }
+      if (requested && attribute_native_gcs_) {
+        AttributeNativeGc(self);
+      }
     } else {
+      if (attribute_native_gcs_) {
+        AttributeNativeGc(self);
+      }
       CollectGarbageInternal(NonStickyGcType(), kGcCauseForNativeAlloc, false, starting_gc_num + 1);
     }
   }
 }
 
+void Heap::AttributeNativeGc(Thread* self) {
+  std::string call_site = "<unknown>";
+  {
+    ScopedObjectAccess soa(self);
+    StackVisitor::WalkStack(
+        [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+          ArtMethod* m = stack_visitor->GetMethod();
+          if (m == nullptr || m->IsRuntimeMethod()) {
+            return true;
+          }
+          // Skip the registration APIs themselves to find the subsystem using them.
+          std::string_view descriptor = m->GetDeclaringClassDescriptorView();
+          if (descriptor == "Ldalvik/system/VMRuntime;" ||
+              descriptor.starts_with("Llibcore/util/NativeAllocationRegistry")) {
+            return true;
+          }
+          call_site = m->PrettyMethod();
+          return false;
+        },
+        self,
+        /* context= */ nullptr,
+        art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+  }
+  VLOG(heap) << "Native allocation GC triggered from " << call_site;
+  MutexLock mu(self, native_gc_call_sites_lock_);
+  ++native_gc_call_sites_.GetOrCreate(call_site, []() { return 0u; });
+}
+
+void Heap::DumpNativeGcCallSites(std::ostream& os) {
+  std::vector<std::pair<uint64_t, std::string>> sites;
+  {
+    MutexLock mu(Thread::Current(), native_gc_call_sites_lock_);
+    for (const auto& [site, count] : native_gc_call_sites_) {
+      sites.emplace_back(count, site);
+    }
+  }
+  if (sites.empty()) {
+    return;
+  }
+  std::sort(sites.begin(), sites.end(), std::greater<>());
+  if (sites.size() > kNumNativeGcCallSitesToDump) {
+    sites.resize(kNumNativeGcCallSitesToDump);
+  }
+  os << "Native allocation GCs by call site:\n";
+  for (const auto& [count, site] : sites) {
+    os << "  " << count << " " << site << "\n";
+  }
+}
+
 // About kNotifyNativeInterval allocations have occurred. Check whether we should garbage collect.
 void Heap::NotifyNativeAllocations(JNIEnv* env) {
   native_objects_notified_.fetch_add(kNotifyNativeInterval, std::memory_order_relaxed);
   CheckGCForNative(Thread::ForEnv(env));
 }
 
+void Heap::FlushNativeRegistrations(Thread* self) {
+  ssize_t pending_bytes = self->GetPendingNativeBytes();
+  uint32_t pending_objects = self->GetPendingNativeObjects();
+  if (pending_bytes != 0) {
+    native_bytes_registered_.fetch_add(pending_bytes, std::memory_order_relaxed);
+    self->SetPendingNativeBytes(0);
+  }
+  if (pending_objects != 0) {
+    native_objects_notified_.fetch_add(pending_objects, std::memory_order_relaxed);
+    self->SetPendingNativeObjects(0);
+  }
+}
+
 // Register a native allocation with an explicit size.
 // This should only be done for large allocations of non-malloc memory, which we wouldn't
 // otherwise see.
 void Heap::RegisterNativeAllocation(JNIEnv* env, size_t bytes) {
   // Cautiously check for a wrapped negative bytes argument.
   DCHECK(sizeof(size_t) < 8 || bytes < (std::numeric_limits<size_t>::max() / 2));
-  native_bytes_registered_.fetch_add(bytes, std::memory_order_relaxed);
-  uint32_t objects_notified =
-      native_objects_notified_.fetch_add(1, std::memory_order_relaxed);
-  if (objects_notified % kNotifyNativeInterval == kNotifyNativeInterval - 1
-      || bytes > kCheckImmediatelyThreshold) {
-    CheckGCForNative(Thread::ForEnv(env));
+  Thread* self = Thread::ForEnv(env);
+  // Batch in the thread to avoid contention on the global counters.
+  ssize_t pending_bytes = self->GetPendingNativeBytes() + static_cast<ssize_t>(bytes);
+  uint32_t pending_objects = self->GetPendingNativeObjects() + 1;
+  bool check = bytes > kCheckImmediatelyThreshold;
+  if (check ||
+      pending_bytes >= static_cast<ssize_t>(kNativeRegistrationBatchBytes) ||
+      pending_objects >= kNativeRegistrationBatchObjects) {
+    native_bytes_registered_.fetch_add(pending_bytes, std::memory_order_relaxed);
+    uint32_t objects_notified =
+        native_objects_notified_.fetch_add(pending_objects, std::memory_order_relaxed);
+    // Check if this batch completed an interval of kNotifyNativeInterval objects.
+    check = check ||
+        objects_notified % kNotifyNativeInterval + pending_objects >= kNotifyNativeInterval;
+    pending_bytes = 0;
+    pending_objects = 0;
+  }
+  self->SetPendingNativeBytes(pending_bytes);
+  self->SetPendingNativeObjects(pending_objects);
+  if (check) {
+    CheckGCForNative(self);
   }
   // Heap profiler treats this as a Java allocation with a null object.
   if (GetHeapSampler().IsEnabled()) {
@@ -4294,17 +4853,16 @@ void Heap::RegisterNativeAllocation(JNIEnv* env, size_t bytes) {
   }
 }
 
-void Heap::RegisterNativeFree(JNIEnv*, size_t bytes) {
-  size_t allocated;
-  size_t new_freed_bytes;
-  do {
-    allocated = native_bytes_registered_.load(std::memory_order_relaxed);
-    new_freed_bytes = std::min(allocated, bytes);
-    // We should not be registering more free than allocated bytes.
-    // But correctly keep going in non-debug builds.
-    DCHECK_EQ(new_freed_bytes, bytes);
-  } while (!native_bytes_registered_.CompareAndSetWeakRelaxed(allocated,
-                                                              allocated - new_freed_bytes));
+void Heap::RegisterNativeFree(JNIEnv* env, size_t bytes) {
+  // Frees commonly happen on the reference processing daemons rather than on the allocating
+  // threads, in which case the thread's net balance turns negative.
+  Thread* self = Thread::ForEnv(env);
+  ssize_t pending_bytes = self->GetPendingNativeBytes() - static_cast<ssize_t>(bytes);
+  if (pending_bytes <= -static_cast<ssize_t>(kNativeRegistrationBatchBytes)) {
+    native_bytes_registered_.fetch_sub(-pending_bytes, std::memory_order_relaxed);
+    pending_bytes = 0;
+  }
+  self->SetPendingNativeBytes(pending_bytes);
 }
 
 size_t Heap::GetTotalMemory() const {
@@ -4556,6 +5114,39 @@ void Heap::RemoveGcPauseListener() {
   gc_pause_listener_.store(nullptr, std::memory_order_relaxed);
 }
 
+size_t Heap::AdaptiveTlabSize(Thread* self, size_t default_size, size_t max_size) {
+  // A thread refilling more often than this is considered allocation heavy and
+  // gets a bigger TLAB to amortize the refill cost.
+  static constexpr uint64_t kFastRefillIntervalNs = MsToNs(1);
+  // A thread refilling less often than this is considered mostly idle and gets
+  // a smaller TLAB to avoid holding on to mostly unused memory.
+  static constexpr uint64_t kSlowRefillIntervalNs = MsToNs(500);
+  // TLAB size can be scaled by 2^kMinShift to 2^kMaxShift.
+  static constexpr int8_t kMinShift = -2;
+  static constexpr int8_t kMaxShift = 3;
+
+  tlab_refill_count_.fetch_add(1, std::memory_order_relaxed);
+  const uint64_t now_ns = NanoTime();
+  const uint64_t last_refill_ns = self->GetLastTlabRefillTimeNs();
+  const uint64_t interval_ns = now_ns - last_refill_ns;
+  int8_t shift = self->GetTlabSizeShift();
+  if (last_refill_ns == 0) {
+    // First refill of this thread. Nothing to go by yet.
+  } else if (interval_ns < kFastRefillIntervalNs) {
+    if (shift < kMaxShift && (default_size << (shift + 1)) <= max_size) {
+      shift++;
+      tlab_grow_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+  } else if (interval_ns > kSlowRefillIntervalNs && shift > kMinShift) {
+    shift--;
+    tlab_shrink_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+  self->SetTlabSizeShift(shift);
+  self->SetLastTlabRefillTimeNs(now_ns);
+  size_t size = shift >= 0 ? default_size << shift : default_size >> -shift;
+  return std::min(size, max_size);
+}
+
 mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
                                        AllocatorType allocator_type,
                                        size_t alloc_size,
@@ -4592,7 +5183,12 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     // TODO: for large allocations, which are rare, maybe we should allocate
     // that object and return. There is no need to revoke the current TLAB,
     // particularly if it's mostly unutilized.
-    size_t next_tlab_size = RoundDown(alloc_size + kDefaultTLABSize, gPageSize) - alloc_size;
+    // Don't go below a page as the TLAB size is rounded down to page-size below.
+    size_t default_tlab_size =
+        kUseAdaptiveTlabs
+            ? std::max(AdaptiveTlabSize(self, kDefaultTLABSize, 8 * kDefaultTLABSize), gPageSize)
+            : kDefaultTLABSize;
+    size_t next_tlab_size = RoundDown(alloc_size + default_tlab_size, gPageSize) - alloc_size;
     if (jhp_enabled) {
       next_tlab_size = JHPCalculateNextTlabSize(
           self, next_tlab_size, alloc_size, &take_sample, &bytes_until_sample);
@@ -4619,6 +5215,10 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
                                             grow))) {
         size_t next_pr_tlab_size =
             kUsePartialTlabs ? kPartialTlabSize : gc::space::RegionSpace::kRegionSize;
+        if (kUsePartialTlabs && kUseAdaptiveTlabs) {
+          next_pr_tlab_size =
+              AdaptiveTlabSize(self, next_pr_tlab_size, gc::space::RegionSpace::kRegionSize);
+        }
         if (jhp_enabled) {
           next_pr_tlab_size = JHPCalculateNextTlabSize(
               self, next_pr_tlab_size, alloc_size, &take_sample, &bytes_until_sample);
@@ -4706,7 +5306,17 @@ void Heap::VlogHeapGrowth(size_t old_footprint, size_t new_footprint, size_t all
 class Heap::TriggerPostForkCCGcTask : public HeapTask {
  public:
   explicit TriggerPostForkCCGcTask(uint64_t target_time, uint32_t initial_gc_num) :
-      HeapTask(target_time), initial_gc_num_(initial_gc_num) {}
+      HeapTask(target_time, Priority::kLow), initial_gc_num_(initial_gc_num) {}
+
+  const void* GetCoalescingKey() const override {
+    return &kCoalescingKey;
+  }
+
+  bool TryCoalesce(HeapTask* other) override {
+    // Both would check the same GC number.
+    return down_cast<TriggerPostForkCCGcTask*>(other)->initial_gc_num_ == initial_gc_num_;
+  }
+
   void Run(Thread* self) override {
     gc::Heap* heap = Runtime::Current()->GetHeap();
     if (heap->GetCurrentGcNum() == initial_gc_num_) {
@@ -4726,7 +5336,9 @@ class Heap::ReduceTargetFootprintTask : public HeapTask {
  public:
   explicit ReduceTargetFootprintTask(uint64_t target_time, size_t new_target_sz,
                                      uint32_t initial_gc_num) :
-      HeapTask(target_time), new_target_sz_(new_target_sz), initial_gc_num_(initial_gc_num) {}
+      HeapTask(target_time, Priority::kLow),
+      new_target_sz_(new_target_sz),
+      initial_gc_num_(initial_gc_num) {}
   void Run(Thread* self) override {
     gc::Heap* heap = Runtime::Current()->GetHeap();
     MutexLock mu(self, *(heap->gc_complete_lock_));
@@ -38,6 +38,7 @@
 #include "gc/collector/mark_compact.h"
 #include "gc/collector_type.h"
 #include "gc/gc_cause.h"
+#include "gc/heap_growth_controller.h"
 #include "gc/space/large_object_space.h"
 #include "gc/space/space.h"
 #include "handle.h"
@@ -147,6 +148,9 @@ class Heap {
   static constexpr size_t kDefaultLongGCLogThreshold = MsToNs(100);
   static constexpr size_t kDefaultLongGCLogThresholdGcStress = MsToNs(1000);
   static constexpr size_t kDefaultTLABSize = 32 * KB;
+  // If true, TLAB refill sizes are scaled per thread based on how often the
+  // thread refills its TLAB. See AdaptiveTlabSize().
+  static constexpr bool kUseAdaptiveTlabs = true;
   static constexpr double kDefaultTargetUtilization = 0.6;
   static constexpr double kDefaultHeapGrowthMultiplier = 2.0;
   // Primitive arrays larger than this size are put in the large object space.
@@ -184,6 +188,18 @@ class Heap {
   // make it safe to allocate that many bytes between checks.
   static constexpr size_t kCheckImmediatelyThreshold = (10'000'000 / kNotifyNativeInterval);
 
+  // Native registrations are batched per thread, and only added to the global counters once the
+  // net registered bytes of the thread exceed kNativeRegistrationBatchBytes in either direction,
+  // or after kNativeRegistrationBatchObjects registrations. This bounds the error of
+  // native_bytes_registered_ by kNativeRegistrationBatchBytes per thread.
+  static constexpr size_t kNativeRegistrationBatchBytes = 64 * KB;
+  static constexpr uint32_t kNativeRegistrationBatchObjects = 16;
+  static_assert(kNativeRegistrationBatchObjects <= kNotifyNativeInterval);
+  static_assert(kNativeRegistrationBatchBytes <= kCheckImmediatelyThreshold);
+
+  // Number of call sites reported in DumpGcPerformanceInfo when attributing native GCs.
+  static constexpr size_t kNumNativeGcCallSitesToDump = 10;
+
   // How often we allow heap trimming to happen (nanoseconds).
   static constexpr uint64_t kHeapTrimWait = MsToNs(5000);
 
@@ -238,9 +254,16 @@ class Heap {
        bool measure_gc_performance,
        bool use_homogeneous_space_compaction,
        bool use_generational_cc,
+       bool use_generational_cmc,
        uint64_t min_interval_homogeneous_space_compaction_by_oom,
        bool dump_region_info_before_gc,
-       bool dump_region_info_after_gc);
+       bool dump_region_info_after_gc,
+       double gc_cpu_budget,
+       uint64_t gc_pause_target_ns,
+       bool attribute_native_gcs,
+       size_t verify_heap_slice_bytes,
+       bool zygote_compaction_remap,
+       bool use_transparent_huge_pages);
 
   ~Heap();
 
@@ -299,6 +322,22 @@ class Heap {
                !process_state_update_lock_,
                !Roles::uninterruptible_);
 
+  // Allocate up to `max_count` objects of `byte_count` bytes each back to back in the
+  // thread-local allocation buffer of `self`, with a single constructor fence. The
+  // `pre_fence_visitor` is called on each object before the fence and `post_fence_visitor`
+  // with each object and its index after. Returns the number of objects allocated, which is 0 if
+  // the allocation needs the slow path or is instrumented, in which case the caller is expected
+  // to allocate the remaining objects individually. Never suspends.
+  template <typename PreFenceVisitor, typename PostFenceVisitor>
+  ALWAYS_INLINE size_t AllocObjectsInTlab(Thread* self,
+                                          ObjPtr<mirror::Class> klass,
+                                          size_t byte_count,
+                                          size_t max_count,
+                                          AllocatorType allocator,
+                                          const PreFenceVisitor& pre_fence_visitor,
+                                          const PostFenceVisitor& post_fence_visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   AllocatorType GetCurrentAllocator() const {
     return current_allocator_;
   }
@@ -330,14 +369,23 @@ class Heap {
   // Inform the garbage collector of a non-malloc allocated native memory that might become
   // reclaimable in the future as a result of Java garbage collection.
   void RegisterNativeAllocation(JNIEnv* env, size_t bytes)
-      REQUIRES(!*gc_complete_lock_, !*pending_task_lock_, !process_state_update_lock_);
+      REQUIRES(!*gc_complete_lock_,
+               !*pending_task_lock_,
+               !process_state_update_lock_,
+               !native_gc_call_sites_lock_);
   void RegisterNativeFree(JNIEnv* env, size_t bytes);
 
+  // Add the native registrations batched in `self` to the global counters.
+  void FlushNativeRegistrations(Thread* self);
+
   // Notify the garbage collector of malloc allocations that might be reclaimable
   // as a result of Java garbage collection. Each such call represents approximately
   // kNotifyNativeInterval such allocations.
   void NotifyNativeAllocations(JNIEnv* env)
-      REQUIRES(!*gc_complete_lock_, !*pending_task_lock_, !process_state_update_lock_);
+      REQUIRES(!*gc_complete_lock_,
+               !*pending_task_lock_,
+               !process_state_update_lock_,
+               !native_gc_call_sites_lock_);
 
   uint32_t GetNotifyNativeInterval() {
     return kNotifyNativeInterval;
@@ -364,6 +412,12 @@ class Heap {
       REQUIRES(Locks::mutator_lock_, !*gc_complete_lock_);
   bool VerifyMissingCardMarks()
       REQUIRES(Locks::heap_bitmap_lock_, Locks::mutator_lock_);
+  // Check the references of the objects in the next `max_bytes` of the heap, continuing where the
+  // previous call stopped and rotating through the spaces. Much cheaper than
+  // VerifyHeapReferences(), but only checks that the references and their classes look valid.
+  // Returns how many failures occured.
+  size_t VerifyHeapSlice(size_t max_bytes)
+      REQUIRES(Locks::mutator_lock_, !Locks::heap_bitmap_lock_);
 
   // A weaker test than IsLiveObject or VerifyObject that doesn't require the heap lock,
   // and doesn't abort on error, allowing the caller to report more
@@ -396,6 +450,15 @@ class Heap {
   void ThreadFlipBegin(Thread* self) REQUIRES(!*thread_flip_lock_);
   void ThreadFlipEnd(Thread* self) REQUIRES(!*thread_flip_lock_);
 
+  // Keep the movable object `obj` at its address until `UnpinMovableObject()`, for JNI critical
+  // calls. With the CC collector, this pins the region of `obj` and does not block the GC.
+  // Otherwise, this disables the moving GC or the thread flip, and `obj` must be re-decoded
+  // afterwards as it may have moved while waiting.
+  void PinMovableObject(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*gc_complete_lock_, !*thread_flip_lock_);
+  void UnpinMovableObject(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*gc_complete_lock_, !*thread_flip_lock_);
+
   // Ensures that the obj doesn't cause userfaultfd in JNI critical calls.
   void EnsureObjectUserfaulted(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -574,6 +637,10 @@ class Heap {
     return use_generational_cc_;
   }
 
+  bool GetUseGenerationalCMC() const {
+    return use_generational_cmc_;
+  }
+
   // Returns the number of objects currently allocated.
   size_t GetObjectsAllocated() const
       REQUIRES(!Locks::heap_bitmap_lock_);
@@ -781,8 +848,9 @@ class Heap {
 
   // GC performance measuring
   void DumpGcPerformanceInfo(std::ostream& os)
-      REQUIRES(!*gc_complete_lock_);
-  void ResetGcPerformanceInfo() REQUIRES(!*gc_complete_lock_);
+      REQUIRES(!*gc_complete_lock_, !process_state_update_lock_, !native_gc_call_sites_lock_);
+  void ResetGcPerformanceInfo()
+      REQUIRES(!*gc_complete_lock_, !process_state_update_lock_, !native_gc_call_sites_lock_);
 
   // Thread pool. Create either the given number of threads, or as per the
   // values of conc_gc_threads_ and parallel_gc_threads_.
@@ -930,6 +998,11 @@ class Heap {
   // Reduce the number of bytes to the next sample position by this adjustment.
   void AdjustSampleOffset(size_t adjustment);
 
+  // Returns the size of the next TLAB refill for `self`, by scaling `default_size`
+  // up (for threads which refill frequently) or down (for threads which rarely
+  // allocate), clamped to `max_size`. Also updates the thread's sizing state.
+  size_t AdaptiveTlabSize(Thread* self, size_t default_size, size_t max_size);
+
   // Allocation tracking support
   // Callers to this function use double-checked locking to ensure safety on allocation_records_
   bool IsAllocTrackingEnabled() const {
@@ -950,6 +1023,16 @@ class Heap {
     alloc_record_depth_ = alloc_record_depth;
   }
 
+  // Mean number of bytes between sampled allocation records, zero to use
+  // AllocRecordObjectMap::kSampleIntervalProperty. Takes effect when tracking is enabled.
+  size_t GetAllocTrackerSampleInterval() const {
+    return alloc_record_sample_interval_;
+  }
+
+  void SetAllocTrackerSampleInterval(size_t sample_interval) {
+    alloc_record_sample_interval_ = sample_interval;
+  }
+
   AllocRecordObjectMap* GetAllocationRecords() const REQUIRES(Locks::alloc_tracker_lock_) {
     return allocation_records_.get();
   }
@@ -1092,7 +1175,13 @@ class Heap {
   ALWAYS_INLINE bool ShouldConcurrentGCForJava(size_t new_num_bytes_allocated);
   float NativeMemoryOverTarget(size_t current_native_bytes, bool is_gc_concurrent);
   void CheckGCForNative(Thread* self)
-      REQUIRES(!*pending_task_lock_, !*gc_complete_lock_, !process_state_update_lock_);
+      REQUIRES(!*pending_task_lock_,
+               !*gc_complete_lock_,
+               !process_state_update_lock_,
+               !native_gc_call_sites_lock_);
+  // Record the managed caller of `self` as the cause of a native allocation GC.
+  void AttributeNativeGc(Thread* self) REQUIRES(!native_gc_call_sites_lock_);
+  void DumpNativeGcCallSites(std::ostream& os) REQUIRES(!native_gc_call_sites_lock_);
 
   accounting::ObjectStack* GetMarkStack() {
     return mark_stack_.get();
@@ -1208,6 +1297,9 @@ class Heap {
       REQUIRES(!Locks::mutator_lock_, !*gc_complete_lock_);
   void PostGcVerificationPaused(collector::GarbageCollector* gc)
       REQUIRES(Locks::mutator_lock_, !*gc_complete_lock_);
+  // Suspend all threads and verify the next slice of the heap (-XX:VerifyHeapSlice).
+  void IncrementalHeapVerification()
+      REQUIRES(!Locks::mutator_lock_, !Locks::heap_bitmap_lock_);
 
   // Find a collector based on GC type.
   collector::GarbageCollector* FindCollectorByGcType(collector::GcType gc_type);
@@ -1492,6 +1584,9 @@ class Heap {
   size_t min_foreground_target_footprint_ GUARDED_BY(process_state_update_lock_);
   size_t min_foreground_concurrent_start_bytes_ GUARDED_BY(process_state_update_lock_);
 
+  // Alternative to the target utilization based growth, enabled by -XX:GcCpuBudget.
+  HeapGrowthController growth_controller_ GUARDED_BY(process_state_update_lock_);
+
   // When num_bytes_allocated_ exceeds this amount then a concurrent GC should be requested so that
   // it completes ahead of an allocation failing.
   // A multiple of this is also used to determine when to trigger a GC in response to native
@@ -1511,10 +1606,12 @@ class Heap {
   // TLABS in their entirety, even if they have not yet been parceled out.
   Atomic<size_t> num_bytes_allocated_;
 
-  // Number of registered native bytes allocated. Adjusted after each RegisterNativeAllocation and
-  // RegisterNativeFree. Used to  help determine when to trigger GC for native allocations. Should
-  // not include bytes allocated through the system malloc, since those are implicitly included.
-  Atomic<size_t> native_bytes_registered_;
+  // Number of registered native bytes allocated. Adjusted when flushing the per-thread batches of
+  // RegisterNativeAllocation and RegisterNativeFree. Used to  help determine when to trigger GC
+  // for native allocations. Should not include bytes allocated through the system malloc, since
+  // those are implicitly included. Since frees may be flushed by another thread before the
+  // matching allocations, this is signed and may be temporarily negative.
+  Atomic<ssize_t> native_bytes_registered_;
 
   // Approximately the smallest value of GetNativeBytes() we've seen since the last GC.
   Atomic<size_t> old_native_bytes_allocated_;
@@ -1523,6 +1620,12 @@ class Heap {
   // Allows us to check for GC only roughly every kNotifyNativeInterval allocations.
   Atomic<uint32_t> native_objects_notified_;
 
+  // Whether to record the managed call sites of the registrations that trigger native GCs
+  // (-XX:AttributeNativeGcs), and the number of GCs triggered per call site.
+  const bool attribute_native_gcs_;
+  Mutex native_gc_call_sites_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  SafeMap<std::string, uint64_t> native_gc_call_sites_ GUARDED_BY(native_gc_call_sites_lock_);
+
   // Number of bytes freed by thread local buffer revokes. This will
   // cancel out the ahead-of-time bulk counting of bytes allocated in
   // rosalloc thread-local buffers.  It is temporarily accumulated
@@ -1549,6 +1652,20 @@ class Heap {
   bool verify_post_gc_rosalloc_;
   const bool gc_stress_mode_;
 
+  // If non-zero, the number of bytes of the heap verified after each GC. Only accessed by the
+  // thread running the GC, with all the other threads suspended.
+  const size_t verify_heap_slice_bytes_;
+  // Index in continuous_spaces_ and address where the next slice starts.
+  size_t verify_heap_slice_space_index_;
+  uintptr_t verify_heap_slice_cursor_;
+  // Number of slices verified, and number of times we went through all the spaces.
+  uint64_t verify_heap_slice_count_;
+  uint64_t verify_heap_slice_rounds_;
+
+  // Whether the zygote compaction moves the pages of large arrays instead of copying them
+  // (-XX:ZygoteCompactionRemap).
+  const bool zygote_compaction_remap_;
+
   // RAII that temporarily disables the rosalloc verification during
   // the zygote fork.
   class ScopedDisableRosAllocVerification {
@@ -1693,6 +1810,12 @@ class Heap {
   // for major collections. Set in Heap constructor.
   const bool use_generational_cc_;
 
+  // If true, enable generational collection when using the Concurrent
+  // Mark-Compact (CMC) collector, i.e. use young collections confined to the
+  // objects allocated since the last GC for minor collections and full
+  // compaction for major collections. Set in Heap constructor.
+  const bool use_generational_cmc_;
+
   // True if the currently running collection has made some thread wait.
   bool running_collection_is_blocking_ GUARDED_BY(gc_complete_lock_);
   // The number of blocking GC runs.
@@ -1721,6 +1844,7 @@ class Heap {
   Atomic<bool> alloc_tracking_enabled_;
   std::unique_ptr<AllocRecordObjectMap> allocation_records_;
   size_t alloc_record_depth_;
+  size_t alloc_record_sample_interval_;
 
   // Perfetto Java Heap Profiler support.
   HeapSampler heap_sampler_;
@@ -1752,6 +1876,12 @@ class Heap {
   // The number of times we initiated a GC of last resort to try to avoid an OOME.
   Atomic<uint64_t> pre_oome_gc_count_;
 
+  // Adaptive TLAB sizing statistics: number of TLAB refills, and how many of
+  // them caused the thread's TLAB size to grow or shrink.
+  Atomic<uint64_t> tlab_refill_count_;
+  Atomic<uint64_t> tlab_grow_count_;
+  Atomic<uint64_t> tlab_shrink_count_;
+
   // An installed allocation listener.
   Atomic<AllocationListener*> alloc_listener_;
   // An installed GC Pause listener.
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "heap_growth_controller.h"
+
+#include <algorithm>
+#include <ostream>
+
+#include <android-base/logging.h>
+
+#include "base/time_utils.h"
+#include "base/utils.h"
+
+namespace art HIDDEN {
+namespace gc {
+
+size_t HeapGrowthController::ComputeGrowBytes(uint64_t now_ns,
+                                              uint64_t bytes_allocated_ever,
+                                              uint64_t gc_duration_ns,
+                                              uint64_t max_pause_ns,
+                                              bool jank_perceptible,
+                                              size_t min_free,
+                                              size_t max_free) {
+  DCHECK(IsEnabled());
+  DCHECK_LE(min_free, max_free);
+  // The cumulative count goes backwards when the GC performance info is reset.
+  if (last_gc_end_ns_ != 0 && now_ns > last_gc_end_ns_ &&
+      bytes_allocated_ever >= last_bytes_allocated_ever_) {
+    const double rate = static_cast<double>(bytes_allocated_ever - last_bytes_allocated_ever_) /
+        static_cast<double>(now_ns - last_gc_end_ns_);
+    allocation_rate_ = !has_rate_sample_
+        ? rate
+        : kSmoothingFactor * rate + (1.0 - kSmoothingFactor) * allocation_rate_;
+    has_rate_sample_ = true;
+  }
+  gc_cost_ns_ = !has_cost_sample_
+      ? gc_duration_ns
+      : kSmoothingFactor * gc_duration_ns + (1.0 - kSmoothingFactor) * gc_cost_ns_;
+  has_cost_sample_ = true;
+  last_gc_end_ns_ = now_ns;
+  last_bytes_allocated_ever_ = bytes_allocated_ever;
+  ++num_decisions_;
+
+  const double budget = jank_perceptible ? gc_cpu_budget_
+                                         : std::min(1.0, gc_cpu_budget_ * kBackgroundBudgetFactor);
+  double grow_bytes = allocation_rate_ * gc_cost_ns_ / budget;
+  if (jank_perceptible && pause_target_ns_ != 0 && max_pause_ns > pause_target_ns_) {
+    grow_bytes *= std::max(kMinPauseScale,
+                           static_cast<double>(pause_target_ns_) / max_pause_ns);
+    ++num_pause_limited_;
+  }
+  size_t result;
+  if (grow_bytes <= min_free) {
+    result = min_free;
+    ++num_clamped_to_min_;
+  } else if (grow_bytes >= max_free) {
+    result = max_free;
+    ++num_clamped_to_max_;
+  } else {
+    result = static_cast<size_t>(grow_bytes);
+  }
+  last_grow_bytes_ = result;
+  last_jank_perceptible_ = jank_perceptible;
+  return result;
+}
+
+void HeapGrowthController::Dump(std::ostream& os) const {
+  os << "Heap growth controller: GC CPU budget " << gc_cpu_budget_ * 100.0 << "%";
+  if (pause_target_ns_ != 0) {
+    os << " pause target " << PrettyDuration(pause_target_ns_);
+  }
+  os << "\n";
+  os << "Heap growth decisions: " << num_decisions_
+     << " pause limited: " << num_pause_limited_
+     << " clamped to min free: " << num_clamped_to_min_
+     << " clamped to max free: " << num_clamped_to_max_ << "\n";
+  if (num_decisions_ != 0) {
+    os << "Heap growth last decision: " << PrettySize(last_grow_bytes_)
+       << (last_jank_perceptible_ ? " (foreground)" : " (background)")
+       << " allocation rate " << PrettySize(static_cast<uint64_t>(allocation_rate_ * 1e9)) << "/s"
+       << " GC cost " << PrettyDuration(static_cast<uint64_t>(gc_cost_ns_)) << "\n";
+  }
+}
+
+void HeapGrowthController::Reset() {
+  num_decisions_ = 0;
+  num_pause_limited_ = 0;
+  num_clamped_to_min_ = 0;
+  num_clamped_to_max_ = 0;
+  last_grow_bytes_ = 0;
+  // Keep the smoothed estimates and the last GC end time, they are still valid.
+}
+
+}  // namespace gc
+}  // namespace art
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_HEAP_GROWTH_CONTROLLER_H_
+#define ART_RUNTIME_GC_HEAP_GROWTH_CONTROLLER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <iosfwd>
+
+#include "base/macros.h"
+
+namespace art HIDDEN {
+namespace gc {
+
+// Picks the amount of free space to leave after a GC so that the time spent in GC stays within a
+// fraction of the wall-clock time (the GC CPU budget), instead of using a static target
+// utilization. If the allocation rate is R bytes/s and a GC costs C seconds, leaving F free bytes
+// means a GC every F / R seconds, so the GC overhead is C * R / F and F = C * R / budget.
+// Both R and C are smoothed over recent GCs. If the longest pause of a GC exceeds the pause
+// target, growth is scaled down since pause times grow with the heap.
+// Not thread safe: only called from the thread running the GC, and for dumping.
+class HeapGrowthController {
+ public:
+  // Weight of the latest sample in the exponential moving averages.
+  static constexpr double kSmoothingFactor = 0.3;
+  // In the background, pauses don't matter and memory does, so allow this many times the
+  // foreground budget.
+  static constexpr double kBackgroundBudgetFactor = 2.0;
+  // Never shrink the growth to less than this fraction because of pauses.
+  static constexpr double kMinPauseScale = 0.25;
+
+  HeapGrowthController(double gc_cpu_budget, uint64_t pause_target_ns)
+      : gc_cpu_budget_(gc_cpu_budget), pause_target_ns_(pause_target_ns) {}
+
+  bool IsEnabled() const {
+    return gc_cpu_budget_ > 0.0;
+  }
+
+  // Record a GC that finished at `now_ns`, and return the number of bytes to leave free until the
+  // next one. `bytes_allocated_ever` is the cumulative allocation count, used to measure the
+  // allocation rate since the previous GC. The result is clamped to [min_free, max_free].
+  size_t ComputeGrowBytes(uint64_t now_ns,
+                          uint64_t bytes_allocated_ever,
+                          uint64_t gc_duration_ns,
+                          uint64_t max_pause_ns,
+                          bool jank_perceptible,
+                          size_t min_free,
+                          size_t max_free);
+
+  void Dump(std::ostream& os) const;
+  void Reset();
+
+  double GetAllocationRate() const {
+    return allocation_rate_;
+  }
+  double GetGcCost() const {
+    return gc_cost_ns_;
+  }
+
+ private:
+  const double gc_cpu_budget_;
+  const uint64_t pause_target_ns_;
+
+  // Smoothed allocation rate in bytes per ns.
+  double allocation_rate_ = 0.0;
+  // Smoothed GC duration in ns.
+  double gc_cost_ns_ = 0.0;
+  bool has_rate_sample_ = false;
+  bool has_cost_sample_ = false;
+  uint64_t last_gc_end_ns_ = 0;
+  uint64_t last_bytes_allocated_ever_ = 0;
+
+  // Decision statistics.
+  uint64_t num_decisions_ = 0;
+  uint64_t num_pause_limited_ = 0;
+  uint64_t num_clamped_to_min_ = 0;
+  uint64_t num_clamped_to_max_ = 0;
+  size_t last_grow_bytes_ = 0;
+  bool last_jank_perceptible_ = true;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapGrowthController);
+};
+
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_HEAP_GROWTH_CONTROLLER_H_
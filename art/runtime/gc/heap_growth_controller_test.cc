@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "heap_growth_controller.h"
+
+#include <sstream>
+
+#include "base/globals.h"
+#include "base/time_utils.h"
+#include "gtest/gtest.h"
+
+namespace art HIDDEN {
+namespace gc {
+
+static constexpr size_t kMinFree = 512 * KB;
+static constexpr size_t kMaxFree = 64 * MB;
+
+TEST(HeapGrowthControllerTest, Disabled) {
+  HeapGrowthController controller(/*gc_cpu_budget=*/ 0.0, /*pause_target_ns=*/ 0);
+  EXPECT_FALSE(controller.IsEnabled());
+}
+
+TEST(HeapGrowthControllerTest, Budget) {
+  // 10% budget: allocating 10MB/s with 10ms GCs needs a GC every 100ms, i.e. 1MB of free space.
+  HeapGrowthController controller(/*gc_cpu_budget=*/ 0.1, /*pause_target_ns=*/ 0);
+  ASSERT_TRUE(controller.IsEnabled());
+  uint64_t now = MsToNs(1000);
+  uint64_t allocated = 0;
+  controller.ComputeGrowBytes(now, allocated, MsToNs(10), 0, true, kMinFree, kMaxFree);
+  size_t grow_bytes = 0;
+  for (size_t i = 0; i < 20; ++i) {
+    now += MsToNs(100);
+    allocated += 1 * MB;
+    grow_bytes = controller.ComputeGrowBytes(now, allocated, MsToNs(10), 0, true, kMinFree, kMaxFree);
+  }
+  EXPECT_NEAR(static_cast<double>(grow_bytes), 1.0 * MB, 0.01 * MB);
+
+  // Doubling the allocation rate doubles the free space.
+  for (size_t i = 0; i < 40; ++i) {
+    now += MsToNs(100);
+    allocated += 2 * MB;
+    grow_bytes = controller.ComputeGrowBytes(now, allocated, MsToNs(10), 0, true, kMinFree, kMaxFree);
+  }
+  EXPECT_NEAR(static_cast<double>(grow_bytes), 2.0 * MB, 0.01 * MB);
+
+  // The background budget is larger, so the heap is kept smaller.
+  grow_bytes = controller.ComputeGrowBytes(
+      now + MsToNs(100), allocated + 2 * MB, MsToNs(10), 0, false, kMinFree, kMaxFree);
+  EXPECT_LT(grow_bytes, 1.1 * MB);
+}
+
+TEST(HeapGrowthControllerTest, Clamping) {
+  HeapGrowthController controller(/*gc_cpu_budget=*/ 0.01, /*pause_target_ns=*/ 0);
+  // No allocations: clamp to the minimum.
+  EXPECT_EQ(controller.ComputeGrowBytes(MsToNs(1), 0, MsToNs(1), 0, true, kMinFree, kMaxFree),
+            kMinFree);
+  // Allocating 1GB/s with 100ms GCs at a 1% budget: clamp to the maximum.
+  EXPECT_EQ(controller.ComputeGrowBytes(MsToNs(1001), GB, MsToNs(100), 0, true, kMinFree, kMaxFree),
+            kMaxFree);
+  std::ostringstream oss;
+  controller.Dump(oss);
+  EXPECT_NE(oss.str().find("clamped to min free: 1 clamped to max free: 1"), std::string::npos)
+      << oss.str();
+}
+
+TEST(HeapGrowthControllerTest, PauseTarget) {
+  HeapGrowthController with_target(/*gc_cpu_budget=*/ 0.1, /*pause_target_ns=*/ MsToNs(2));
+  HeapGrowthController without_target(/*gc_cpu_budget=*/ 0.1, /*pause_target_ns=*/ 0);
+  size_t a = 0;
+  size_t b = 0;
+  for (size_t i = 1; i <= 5; ++i) {
+    a = with_target.ComputeGrowBytes(
+        MsToNs(100 * i), 8 * MB * i, MsToNs(10), MsToNs(4), true, kMinFree, kMaxFree);
+    b = without_target.ComputeGrowBytes(
+        MsToNs(100 * i), 8 * MB * i, MsToNs(10), MsToNs(4), true, kMinFree, kMaxFree);
+  }
+  // Pauses twice as long as the target halve the growth.
+  EXPECT_NEAR(static_cast<double>(a), b / 2.0, 1.0);
+}
+
+}  // namespace gc
+}  // namespace art
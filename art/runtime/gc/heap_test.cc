@@ -27,6 +27,7 @@
 #include "mirror/object_array-alloc-inl.h"
 #include "mirror/object_array-inl.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_list.h"
 
 namespace art HIDDEN {
 namespace gc {
@@ -258,6 +259,63 @@ TEST_F(HeapTest, GCMetrics) {
   }
 }
 
+TEST_F(HeapTest, NativeRegistrationBatching) {
+  Thread* self = Thread::Current();
+  JNIEnv* env = self->GetJniEnv();
+  Heap* heap = Runtime::Current()->GetHeap();
+  heap->FlushNativeRegistrations(self);
+  // Small registrations stay in the thread.
+  heap->RegisterNativeAllocation(env, 1 * KB);
+  EXPECT_EQ(self->GetPendingNativeBytes(), static_cast<ssize_t>(1 * KB));
+  EXPECT_EQ(self->GetPendingNativeObjects(), 1u);
+  heap->RegisterNativeFree(env, 3 * KB);
+  EXPECT_EQ(self->GetPendingNativeBytes(), -static_cast<ssize_t>(2 * KB));
+  EXPECT_EQ(self->GetPendingNativeObjects(), 1u);
+  // The batch is flushed after kNativeRegistrationBatchObjects registrations.
+  for (uint32_t i = 1; i < Heap::kNativeRegistrationBatchObjects; ++i) {
+    heap->RegisterNativeAllocation(env, 1);
+  }
+  EXPECT_EQ(self->GetPendingNativeBytes(), 0);
+  EXPECT_EQ(self->GetPendingNativeObjects(), 0u);
+  // Or once the net balance exceeds kNativeRegistrationBatchBytes.
+  heap->RegisterNativeAllocation(env, Heap::kNativeRegistrationBatchBytes);
+  EXPECT_EQ(self->GetPendingNativeBytes(), 0);
+  heap->RegisterNativeFree(env, Heap::kNativeRegistrationBatchBytes);
+  EXPECT_EQ(self->GetPendingNativeBytes(), 0);
+  heap->RegisterNativeFree(env, 1 * KB);
+  heap->FlushNativeRegistrations(self);
+  EXPECT_EQ(self->GetPendingNativeBytes(), 0);
+  EXPECT_EQ(self->GetPendingNativeObjects(), 0u);
+  // Balance the registrations above.
+  heap->RegisterNativeAllocation(env, 3 * KB - (Heap::kNativeRegistrationBatchObjects - 1));
+  heap->FlushNativeRegistrations(self);
+}
+
+TEST_F(HeapTest, VerifyHeapSlice) {
+  Thread* self = Thread::Current();
+  Heap* heap = Runtime::Current()->GetHeap();
+  {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<1> hs(soa.Self());
+    Handle<mirror::ObjectArray<mirror::Object>> array(hs.NewHandle(
+        class_linker_->AllocObjectArray<mirror::Object>(soa.Self(), 16)));
+    ASSERT_TRUE(array != nullptr);
+    for (int32_t i = 0; i < array->GetLength(); ++i) {
+      array->Set(i, array.Get());
+    }
+    heap->CollectGarbage(/* clear_soft_references= */ false);
+  }
+  // Go through the whole heap in small slices.
+  size_t total_bytes = 0;
+  for (const auto& space : heap->GetContinuousSpaces()) {
+    total_bytes += space->Size();
+  }
+  ScopedSuspendAll ssa(__FUNCTION__);
+  for (size_t verified = 0; verified < total_bytes; verified += 64 * KB) {
+    ASSERT_EQ(heap->VerifyHeapSlice(64 * KB), 0u);
+  }
+}
+
 class ZygoteHeapTest : public CommonRuntimeTest {
  public:
   ZygoteHeapTest() {
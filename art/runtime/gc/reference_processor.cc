@@ -16,6 +16,8 @@
 
 #include "reference_processor.h"
 
+#include <sched.h>
+
 #include "art_field-inl.h"
 #include "base/mutex.h"
 #include "base/time_utils.h"
@@ -30,6 +32,7 @@
 #include "nativehelper/scoped_local_ref.h"
 #include "object_callbacks.h"
 #include "reflection.h"
+#include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "task_processor.h"
 #include "thread-inl.h"
@@ -40,6 +43,29 @@ namespace art HIDDEN {
 namespace gc {
 
 static constexpr bool kAsyncReferenceQueueAdd = false;
+// Number of references processed in one slice of incremental reference processing.
+static constexpr size_t kReferenceProcessingSliceSize = 256;
+// Time budget for a slice of concurrent reference processing, after which the
+// gc-thread yields the CPU.
+static constexpr uint64_t kReferenceProcessingSliceBudgetNs = MsToNs(1);
+
+namespace {
+
+// Number of references of a kind processed by the GC, and the time spent.
+struct ReferenceKindStats {
+  uint64_t num_refs = 0;
+  uint64_t duration_ns = 0;
+
+  void Report(metrics::MetricsBase<uint64_t>* count_metric,
+              metrics::MetricsBase<uint64_t>* time_metric) const {
+    if (num_refs > 0) {
+      count_metric->Add(num_refs);
+      time_metric->Add(NsToUs(duration_ns));
+    }
+  }
+};
+
+}  // namespace
 
 ReferenceProcessor::ReferenceProcessor()
     : collector_(nullptr),
@@ -197,10 +223,41 @@ void ReferenceProcessor::Setup(Thread* self,
   clear_soft_references_ = clear_soft_references;
 }
 
+uint32_t ReferenceProcessor::ClearWhiteReferencesIncrementally(ReferenceQueue* queue,
+                                                               bool report_cleared) {
+  uint32_t num_refs = 0;
+  uint64_t slice_start_ns = NanoTime();
+  while (!queue->IsEmpty()) {
+    num_refs += queue->ClearWhiteReferences(
+        &cleared_references_, collector_, report_cleared, kReferenceProcessingSliceSize);
+    if (concurrent_) {
+      uint64_t now_ns = NanoTime();
+      if (now_ns - slice_start_ns > kReferenceProcessingSliceBudgetNs) {
+        sched_yield();
+        slice_start_ns = NanoTime();
+      }
+    }
+  }
+  return num_refs;
+}
+
 // Process reference class instances and schedule finalizations.
 // We advance rp_state_ to signal partial completion for the benefit of GetReferent.
 void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings) {
   TimingLogger::ScopedTiming t(concurrent_ ? __FUNCTION__ : "(Paused)ProcessReferences", timings);
+  ReferenceKindStats soft_stats;
+  ReferenceKindStats weak_stats;
+  ReferenceKindStats finalizer_stats;
+  ReferenceKindStats phantom_stats;
+  // Clear white references in `queue`, accounting the work in `stats`.
+  auto clear_white_references = [this](ReferenceQueue* queue,
+                                       ReferenceKindStats* stats,
+                                       bool report_cleared)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    uint64_t start_ns = NanoTime();
+    stats->num_refs += ClearWhiteReferencesIncrementally(queue, report_cleared);
+    stats->duration_ns += NanoTime() - start_ns;
+  };
   if (!clear_soft_references_) {
     // Forward any additional SoftReferences we discovered late, now that reference access has been
     // inhibited.
@@ -230,8 +287,8 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
   }
   // Clear all remaining soft and weak references with white referents.
   // This misses references only reachable through finalizers.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
+  clear_white_references(&soft_reference_queue_, &soft_stats, /*report_cleared=*/ false);
+  clear_white_references(&weak_reference_queue_, &weak_stats, /*report_cleared=*/ false);
   // Defer PhantomReference processing until we've finished marking through finalizers.
   {
     // TODO: Capture mark state of some system weaks here. If the referent was marked here,
@@ -250,20 +307,24 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
   {
     TimingLogger::ScopedTiming t2(
         concurrent_ ? "EnqueueFinalizerReferences" : "(Paused)EnqueueFinalizerReferences", timings);
+    uint64_t start_ns = NanoTime();
     // Preserve all white objects with finalize methods and schedule them for finalization.
-    FinalizerStats finalizer_stats =
+    FinalizerStats stats =
         finalizer_reference_queue_.EnqueueFinalizerReferences(&cleared_references_, collector_);
     if (ATraceEnabled()) {
       static constexpr size_t kBufSize = 80;
       char buf[kBufSize];
       snprintf(buf, kBufSize, "Marking from %" PRIu32 " / %" PRIu32 " finalizers",
-               finalizer_stats.num_enqueued_, finalizer_stats.num_refs_);
+               stats.num_enqueued_, stats.num_refs_);
       ATraceBegin(buf);
       collector_->ProcessMarkStack();
       ATraceEnd();
     } else {
       collector_->ProcessMarkStack();
     }
+    // Marking through the finalizable objects is accounted to finalizer references.
+    finalizer_stats.num_refs += stats.num_refs_;
+    finalizer_stats.duration_ns += NanoTime() - start_ns;
   }
 
   // Process all soft and weak references with white referents, where the references are reachable
@@ -285,13 +346,11 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
   // finalized object containing pointers to native objects that have already been deallocated.
   // But it can be argued that this is just an instance of the broader rule that it is not safe
   // for finalizers to access otherwise inaccessible finalizable objects.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_,
-                                             /*report_cleared=*/ true);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_,
-                                             /*report_cleared=*/ true);
+  clear_white_references(&soft_reference_queue_, &soft_stats, /*report_cleared=*/ true);
+  clear_white_references(&weak_reference_queue_, &weak_stats, /*report_cleared=*/ true);
 
   // Clear all phantom references with white referents. It's fine to do this just once here.
-  phantom_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
+  clear_white_references(&phantom_reference_queue_, &phantom_stats, /*report_cleared=*/ false);
 
   // At this point all reference queues other than the cleared references should be empty.
   DCHECK(soft_reference_queue_.IsEmpty());
@@ -310,6 +369,22 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
       DisableSlowPath(self);
     }
   }
+
+  metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+  soft_stats.Report(metrics->SoftReferenceProcessedCount(), metrics->SoftReferenceProcessingTime());
+  weak_stats.Report(metrics->WeakReferenceProcessedCount(), metrics->WeakReferenceProcessingTime());
+  finalizer_stats.Report(metrics->FinalizerReferenceProcessedCount(),
+                         metrics->FinalizerReferenceProcessingTime());
+  phantom_stats.Report(metrics->PhantomReferenceProcessedCount(),
+                       metrics->PhantomReferenceProcessingTime());
+  if (VLOG_IS_ON(heap)) {
+    LOG(INFO) << "Processed references: soft=" << soft_stats.num_refs << " ("
+              << PrettyDuration(soft_stats.duration_ns) << ") weak=" << weak_stats.num_refs << " ("
+              << PrettyDuration(weak_stats.duration_ns) << ") finalizer="
+              << finalizer_stats.num_refs << " (" << PrettyDuration(finalizer_stats.duration_ns)
+              << ") phantom=" << phantom_stats.num_refs << " ("
+              << PrettyDuration(phantom_stats.duration_ns) << ")";
+  }
 }
 
 // Process the "referent" field in a java.lang.ref.Reference.  If the referent has not yet been
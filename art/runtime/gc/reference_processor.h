@@ -97,6 +97,12 @@ class ReferenceProcessor {
   // Called by ProcessReferences.
   void DisableSlowPath(Thread* self) REQUIRES(Locks::reference_processor_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
+  // Clear white references in `queue` in slices of bounded size. When processing concurrently, the
+  // gc-thread yields the CPU whenever it exceeds the time budget of a slice, so that a queue with
+  // tens of thousands of references doesn't monopolize a core. Returns the number of references
+  // processed.
+  uint32_t ClearWhiteReferencesIncrementally(ReferenceQueue* queue, bool report_cleared)
+      REQUIRES_SHARED(Locks::mutator_lock_);
   // Wait until reference processing is done.
   void WaitUntilDoneProcessingReferences(Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_)
@@ -131,10 +131,12 @@ size_t ReferenceQueue::GetLength() const {
   return count;
 }
 
-void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
-                                          collector::GarbageCollector* collector,
-                                          bool report_cleared) {
-  while (!IsEmpty()) {
+uint32_t ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
+                                              collector::GarbageCollector* collector,
+                                              bool report_cleared,
+                                              size_t max_refs) {
+  uint32_t num_refs = 0;
+  for (; num_refs < max_refs && !IsEmpty(); ++num_refs) {
     ObjPtr<mirror::Reference> ref = DequeuePendingReference();
     mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
     // do_atomic_update is false because this happens during the reference processing phase where
@@ -161,6 +163,7 @@ void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
     // transaction mode will trigger the read barrier.
     DisableReadBarrierForReference(ref, std::memory_order_relaxed);
   }
+  return num_refs;
 }
 
 FinalizerStats ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
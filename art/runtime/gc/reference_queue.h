@@ -18,6 +18,7 @@
 #define ART_RUNTIME_GC_REFERENCE_QUEUE_H_
 
 #include <iosfwd>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -103,10 +104,13 @@ class ReferenceQueue {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Unlink the reference list clearing references objects with white referents. Cleared references
-  // registered to a reference queue are scheduled for appending by the heap worker thread.
-  void ClearWhiteReferences(ReferenceQueue* cleared_references,
-                            collector::GarbageCollector* collector,
-                            bool report_cleared = false)
+  // registered to a reference queue are scheduled for appending by the heap worker thread. At most
+  // `max_refs` references are processed, which allows callers to process the queue in slices.
+  // Returns the number of references processed.
+  uint32_t ClearWhiteReferences(ReferenceQueue* cleared_references,
+                                collector::GarbageCollector* collector,
+                                bool report_cleared = false,
+                                size_t max_refs = std::numeric_limits<size_t>::max())
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   void Dump(std::ostream& os) const REQUIRES_SHARED(Locks::mutator_lock_);
@@ -40,6 +40,7 @@
 #include "base/file_utils.h"
 #include "base/globals.h"
 #include "base/macros.h"
+#include "base/mem_map.h"
 #include "base/memfd.h"
 #include "base/os.h"
 #include "base/pointer_size.h"
@@ -1069,6 +1070,8 @@ class ImageSpace::Loader {
           auto function = [&](Thread*) {
             const uint64_t start2 = NanoTime();
             ScopedTrace trace("LZ4 decompress block");
+            // Fault in the output in one go, on the worker thread doing the decompression.
+            PopulatePagesForWrite(map.Begin() + block.GetImageOffset(), block.GetImageSize());
             bool result = block.Decompress(/*out_ptr=*/map.Begin(),
                                            /*in_ptr=*/temp_map.Begin(),
                                            error_msg);
@@ -1115,6 +1118,7 @@ class ImageSpace::Loader {
 
         // No other process should race to overwrite the extension in memfd.
         DCHECK_EQ(memcmp(temp_map.Begin(), &image_header, sizeof(ImageHeader)), 0);
+        PopulatePagesForWrite(map.Begin(), temp_map.Size());
         memcpy(map.Begin(), temp_map.Begin(), temp_map.Size());
       }
     }
@@ -3775,15 +3779,17 @@ void ImageSpace::DumpSections(std::ostream& os) const {
   }
 }
 
-void ImageSpace::ReleaseMetadata() {
+size_t ImageSpace::ReleaseMetadata() {
   const ImageSection& metadata = GetImageHeader().GetMetadataSection();
   VLOG(image) << "Releasing " << metadata.Size() << " image metadata bytes";
   // Avoid using ZeroAndReleasePages since the zero fill might not be word atomic.
   uint8_t* const page_begin = AlignUp(Begin() + metadata.Offset(), gPageSize);
   uint8_t* const page_end = AlignDown(Begin() + metadata.End(), gPageSize);
-  if (page_begin < page_end) {
-    CHECK_NE(madvise(page_begin, page_end - page_begin, MADV_DONTNEED), -1) << "madvise failed";
+  if (page_begin >= page_end) {
+    return 0u;
   }
+  CHECK_NE(madvise(page_begin, page_end - page_begin, MADV_DONTNEED), -1) << "madvise failed";
+  return page_end - page_begin;
 }
 
 }  // namespace space
@@ -303,7 +303,8 @@ class ImageSpace : public MemMapSpace {
   // De-initialize the image-space by undoing the effects in Init().
   virtual ~ImageSpace();
 
-  void ReleaseMetadata() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Release the pages of the metadata section. Returns the number of bytes released.
+  size_t ReleaseMetadata() REQUIRES_SHARED(Locks::mutator_lock_);
 
   static void AppendImageChecksum(uint32_t component_count,
                                   uint32_t checksum,
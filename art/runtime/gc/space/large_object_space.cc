@@ -168,10 +168,10 @@ mirror::Object* LargeObjectMapSpace::Alloc(Thread* self, size_t num_bytes,
   }
   DCHECK(bytes_tl_bulk_allocated != nullptr);
   *bytes_tl_bulk_allocated = allocation_size;
-  num_bytes_allocated_ += allocation_size;
-  total_bytes_allocated_ += allocation_size;
-  ++num_objects_allocated_;
-  ++total_objects_allocated_;
+  num_bytes_allocated_.fetch_add(allocation_size, std::memory_order_relaxed);
+  total_bytes_allocated_.fetch_add(allocation_size, std::memory_order_relaxed);
+  num_objects_allocated_.fetch_add(1, std::memory_order_relaxed);
+  total_objects_allocated_.fetch_add(1, std::memory_order_relaxed);
   return obj;
 }
 
@@ -202,10 +202,10 @@ size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
     LOG(FATAL) << "Attempted to free large object " << ptr << " which was not live";
   }
   const size_t map_size = it->second.mem_map.BaseSize();
-  DCHECK_GE(num_bytes_allocated_, map_size);
+  DCHECK_GE(num_bytes_allocated_.load(std::memory_order_relaxed), map_size);
   size_t allocation_size = map_size;
-  num_bytes_allocated_ -= allocation_size;
-  --num_objects_allocated_;
+  num_bytes_allocated_.fetch_sub(allocation_size, std::memory_order_relaxed);
+  num_objects_allocated_.fetch_sub(1, std::memory_order_relaxed);
   large_objects_.erase(it);
   return allocation_size;
 }
@@ -402,6 +402,7 @@ FreeListSpace::FreeListSpace(const std::string& name,
 
 void FreeListSpace::ClampGrowthLimit(size_t new_capacity) {
   MutexLock mu(Thread::Current(), lock_);
+  FlushAllocationCache();
   new_capacity = RoundUp(new_capacity, ObjectAlignment());
   CHECK_LE(new_capacity, Size());
   size_t diff = Size() - new_capacity;
@@ -425,6 +426,9 @@ FreeListSpace::~FreeListSpace() {}
 
 void FreeListSpace::Walk(DlMallocSpace::WalkCallback callback, void* arg) {
   MutexLock mu(Thread::Current(), lock_);
+  // Cached blocks look like allocated objects, return them to the free list so that they are not
+  // reported.
+  FlushAllocationCache();
   const uintptr_t free_end_start = reinterpret_cast<uintptr_t>(end_) - free_end_;
   AllocationInfo* cur_info = &allocation_info_[0];
   const AllocationInfo* end_info = GetAllocationInfoForAddress(free_end_start);
@@ -465,14 +469,26 @@ size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
   DCHECK_GT(allocation_size, 0U);
   DCHECK_ALIGNED_PARAM(allocation_size, ObjectAlignment());
 
-  // madvise the pages without lock
+  // madvise the pages without lock. This also guarantees that blocks handed out from the cache
+  // are zeroed.
   madvise(obj, allocation_size, MADV_DONTNEED);
   if (kIsDebugBuild) {
     // Can't disallow reads since we use them to find next chunks during coalescing.
     CheckedCall(mprotect, __FUNCTION__, obj, allocation_size, PROT_READ);
   }
 
-  MutexLock mu(self, lock_);
+  // Zygote objects go through the free list so that the zygote flag gets cleared.
+  if (!kUseAllocationCache || info->IsZygoteObject() || !FreeToCache(info, allocation_size)) {
+    MutexLock mu(self, lock_);
+    FreeBlock(info, allocation_size);
+  }
+  DCHECK_LE(allocation_size, num_bytes_allocated_.load(std::memory_order_relaxed));
+  num_objects_allocated_.fetch_sub(1, std::memory_order_relaxed);
+  num_bytes_allocated_.fetch_sub(allocation_size, std::memory_order_relaxed);
+  return allocation_size;
+}
+
+void FreeListSpace::FreeBlock(AllocationInfo* info, size_t allocation_size) {
   info->SetByteSize(allocation_size, true);  // Mark as free.
   // Look at the next chunk.
   AllocationInfo* next_info = info->GetNextInfo();
@@ -515,10 +531,64 @@ size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
     info->SetByteSize(new_free_size, true);
     DCHECK_EQ(info->GetNextInfo(), new_free_info);
   }
-  --num_objects_allocated_;
-  DCHECK_LE(allocation_size, num_bytes_allocated_);
-  num_bytes_allocated_ -= allocation_size;
-  return allocation_size;
+}
+
+AllocationInfo* FreeListSpace::AllocFromCache(size_t allocation_size) {
+  const size_t units = allocation_size / ObjectAlignment();
+  if (units > kMaxCachedAllocationUnits) {
+    return nullptr;
+  }
+  for (Atomic<AllocationInfo*>& slot : allocation_cache_[units - 1]) {
+    // Avoid dirtying the cache line of empty slots.
+    if (slot.load(std::memory_order_relaxed) != nullptr) {
+      AllocationInfo* info = slot.exchange(nullptr, std::memory_order_acquire);
+      if (info != nullptr) {
+        DCHECK_EQ(info->ByteSize(), allocation_size);
+        return info;
+      }
+    }
+  }
+  return nullptr;
+}
+
+bool FreeListSpace::FreeToCache(AllocationInfo* info, size_t allocation_size) {
+  const size_t units = allocation_size / ObjectAlignment();
+  if (units > kMaxCachedAllocationUnits) {
+    return false;
+  }
+  for (Atomic<AllocationInfo*>& slot : allocation_cache_[units - 1]) {
+    if (slot.load(std::memory_order_relaxed) == nullptr &&
+        slot.CompareAndSetStrongRelease(nullptr, info)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void FreeListSpace::FlushAllocationCache() {
+  if (!kUseAllocationCache) {
+    return;
+  }
+  for (size_t i = 0; i < kMaxCachedAllocationUnits; ++i) {
+    for (Atomic<AllocationInfo*>& slot : allocation_cache_[i]) {
+      AllocationInfo* info = slot.exchange(nullptr, std::memory_order_acquire);
+      if (info != nullptr) {
+        DCHECK_EQ(info->ByteSize(), (i + 1) * ObjectAlignment());
+        FreeBlock(info, info->ByteSize());
+      }
+    }
+  }
+}
+
+bool FreeListSpace::IsCached(const AllocationInfo* info) const {
+  for (const auto& slots : allocation_cache_) {
+    for (const Atomic<AllocationInfo*>& slot : slots) {
+      if (slot.load(std::memory_order_relaxed) == info) {
+        return true;
+      }
+    }
+  }
+  return false;
 }
 
 size_t FreeListSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
@@ -534,8 +604,44 @@ size_t FreeListSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
 
 mirror::Object* FreeListSpace::Alloc(Thread* self, size_t num_bytes, size_t* bytes_allocated,
                                      size_t* usable_size, size_t* bytes_tl_bulk_allocated) {
-  MutexLock mu(self, lock_);
   const size_t allocation_size = RoundUp(num_bytes, ObjectAlignment());
+  // A cached block already has its AllocationInfo set up for this size.
+  AllocationInfo* new_info = kUseAllocationCache ? AllocFromCache(allocation_size) : nullptr;
+  if (new_info == nullptr) {
+    MutexLock mu(self, lock_);
+    new_info = AllocBlock(allocation_size);
+    if (new_info == nullptr && kUseAllocationCache) {
+      // The cached blocks may be what is preventing a large enough free block from forming.
+      FlushAllocationCache();
+      new_info = AllocBlock(allocation_size);
+    }
+    if (new_info == nullptr) {
+      return nullptr;
+    }
+    // We always put our object at the start of the free block, there cannot be another free
+    // block before it.
+    new_info->SetPrevFreeBytes(0);
+    new_info->SetByteSize(allocation_size, false);
+  }
+  DCHECK(bytes_allocated != nullptr);
+  *bytes_allocated = allocation_size;
+  if (usable_size != nullptr) {
+    *usable_size = allocation_size;
+  }
+  DCHECK(bytes_tl_bulk_allocated != nullptr);
+  *bytes_tl_bulk_allocated = allocation_size;
+  num_objects_allocated_.fetch_add(1, std::memory_order_relaxed);
+  total_objects_allocated_.fetch_add(1, std::memory_order_relaxed);
+  num_bytes_allocated_.fetch_add(allocation_size, std::memory_order_relaxed);
+  total_bytes_allocated_.fetch_add(allocation_size, std::memory_order_relaxed);
+  mirror::Object* obj = reinterpret_cast<mirror::Object*>(GetAddressForAllocationInfo(new_info));
+  if (kIsDebugBuild) {
+    CheckedCall(mprotect, __FUNCTION__, obj, allocation_size, PROT_READ | PROT_WRITE);
+  }
+  return obj;
+}
+
+AllocationInfo* FreeListSpace::AllocBlock(size_t allocation_size) {
   AllocationInfo temp_info;
   temp_info.SetPrevFreeBytes(allocation_size);
   temp_info.SetByteSize(0, false);
@@ -566,27 +672,7 @@ mirror::Object* FreeListSpace::Alloc(Thread* self, size_t num_bytes, size_t* byt
       return nullptr;
     }
   }
-  DCHECK(bytes_allocated != nullptr);
-  *bytes_allocated = allocation_size;
-  if (usable_size != nullptr) {
-    *usable_size = allocation_size;
-  }
-  DCHECK(bytes_tl_bulk_allocated != nullptr);
-  *bytes_tl_bulk_allocated = allocation_size;
-  // Need to do these inside of the lock.
-  ++num_objects_allocated_;
-  ++total_objects_allocated_;
-  num_bytes_allocated_ += allocation_size;
-  total_bytes_allocated_ += allocation_size;
-  mirror::Object* obj = reinterpret_cast<mirror::Object*>(GetAddressForAllocationInfo(new_info));
-  // We always put our object at the start of the free block, there cannot be another free block
-  // before it.
-  if (kIsDebugBuild) {
-    CheckedCall(mprotect, __FUNCTION__, obj, allocation_size, PROT_READ | PROT_WRITE);
-  }
-  new_info->SetPrevFreeBytes(0);
-  new_info->SetByteSize(allocation_size, false);
-  return obj;
+  return new_info;
 }
 
 void FreeListSpace::Dump(std::ostream& os) const {
@@ -604,6 +690,9 @@ void FreeListSpace::Dump(std::ostream& os) const {
     if (cur_info->IsFree()) {
       os << "Free block at address: " << reinterpret_cast<const void*>(address)
          << " of length " << size << " bytes\n";
+    } else if (IsCached(cur_info)) {
+      os << "Cached free block at address: " << reinterpret_cast<const void*>(address)
+         << " of length " << size << " bytes\n";
     } else {
       os << "Large object at address: " << reinterpret_cast<const void*>(address)
          << " of length " << size << " bytes\n";
@@ -624,6 +713,7 @@ bool FreeListSpace::IsZygoteLargeObject([[maybe_unused]] Thread* self, mirror::O
 
 void FreeListSpace::SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mark_bit) {
   MutexLock mu(self, lock_);
+  FlushAllocationCache();
   uintptr_t free_end_start = reinterpret_cast<uintptr_t>(end_) - free_end_;
   for (AllocationInfo* cur_info = GetAllocationInfoForAddress(reinterpret_cast<uintptr_t>(Begin())),
       *end_info = GetAllocationInfoForAddress(free_end_start); cur_info < end_info;
@@ -18,6 +18,7 @@
 #define ART_RUNTIME_GC_SPACE_LARGE_OBJECT_SPACE_H_
 
 #include "base/allocator.h"
+#include "base/atomic.h"
 #include "base/safe_map.h"
 #include "base/tracking_safe_map.h"
 #include "dlmalloc_space.h"
@@ -51,20 +52,16 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
   virtual ~LargeObjectSpace() {}
 
   uint64_t GetBytesAllocated() override {
-    MutexLock mu(Thread::Current(), lock_);
-    return num_bytes_allocated_;
+    return num_bytes_allocated_.load(std::memory_order_relaxed);
   }
   uint64_t GetObjectsAllocated() override {
-    MutexLock mu(Thread::Current(), lock_);
-    return num_objects_allocated_;
+    return num_objects_allocated_.load(std::memory_order_relaxed);
   }
   uint64_t GetTotalBytesAllocated() const {
-    MutexLock mu(Thread::Current(), lock_);
-    return total_bytes_allocated_;
+    return total_bytes_allocated_.load(std::memory_order_relaxed);
   }
   uint64_t GetTotalObjectsAllocated() const {
-    MutexLock mu(Thread::Current(), lock_);
-    return total_objects_allocated_;
+    return total_objects_allocated_.load(std::memory_order_relaxed);
   }
   size_t FreeList(Thread* self, size_t num_ptrs, mirror::Object** ptrs) override;
   // LargeObjectSpaces don't have thread local state.
@@ -133,21 +130,22 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
                             const char* lock_name);
   static void SweepCallback(size_t num_ptrs, mirror::Object** ptrs, void* arg);
 
-  // Used to ensure mutual exclusion when the allocation spaces data structures,
-  // including the allocation counters below, are being modified.
+  // Used to ensure mutual exclusion when the allocation spaces data structures are being modified.
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
   // Number of bytes which have been allocated into the space and not yet freed. The count is also
   // included in the identically named field in Heap. Counts actual allocated (after rounding),
   // not requested, sizes. TODO: It would be cheaper to just maintain total allocated and total
   // free counts.
-  uint64_t num_bytes_allocated_ GUARDED_BY(lock_);
-  uint64_t num_objects_allocated_ GUARDED_BY(lock_);
+  // The counters are atomic so that the FreeListSpace cache paths can update them without
+  // acquiring lock_.
+  Atomic<uint64_t> num_bytes_allocated_;
+  Atomic<uint64_t> num_objects_allocated_;
 
   // Totals for large objects ever allocated, including those that have since been deallocated.
   // Never decremented.
-  uint64_t total_bytes_allocated_ GUARDED_BY(lock_);
-  uint64_t total_objects_allocated_ GUARDED_BY(lock_);
+  Atomic<uint64_t> total_bytes_allocated_;
+  Atomic<uint64_t> total_objects_allocated_;
 
   // Begin and end, may change as more large objects are allocated.
   uint8_t* begin_;
@@ -229,6 +227,26 @@ class FreeListSpace final : public LargeObjectSpace {
   }
   // Removes header from the free blocks set by finding the corresponding iterator and erasing it.
   void RemoveFreePrev(AllocationInfo* info) REQUIRES(lock_);
+  // Carves a block of allocation_size bytes out of the free list or the free end of the space.
+  // Returns null if there is no large enough free block.
+  AllocationInfo* AllocBlock(size_t allocation_size) REQUIRES(lock_);
+  // Returns the block to the free list, coalescing it with its free neighbours.
+  void FreeBlock(AllocationInfo* info, size_t allocation_size) REQUIRES(lock_);
+
+  // Small blocks are recycled through lock-free per-size caches so that threads allocating and
+  // freeing large objects of the same size don't all serialize on lock_. A cached block stays
+  // marked as allocated in its AllocationInfo but is not accounted in the allocation counters.
+  // The caches are flushed back into the free list whenever the whole space needs to be
+  // consistent (Walk(), zygote creation, clamping) or when the free list can't satisfy a request.
+  static constexpr bool kUseAllocationCache = true;
+  // Largest cached block, in units of ObjectAlignment().
+  static constexpr size_t kMaxCachedAllocationUnits = 16;
+  // Number of cached blocks per size.
+  static constexpr size_t kAllocationCacheSlots = 4;
+  AllocationInfo* AllocFromCache(size_t allocation_size);
+  bool FreeToCache(AllocationInfo* info, size_t allocation_size);
+  void FlushAllocationCache() REQUIRES(lock_);
+  bool IsCached(const AllocationInfo* info) const;
   bool IsZygoteLargeObject(Thread* self, mirror::Object* obj) const override;
   void SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mark_bit) override
       REQUIRES(!lock_)
@@ -252,6 +270,9 @@ class FreeListSpace final : public LargeObjectSpace {
   // Free bytes at the end of the space.
   size_t free_end_ GUARDED_BY(lock_);
   FreeBlocks free_blocks_ GUARDED_BY(lock_);
+  // Cached free blocks, indexed by their size in units of ObjectAlignment() minus one. Null
+  // entries are empty slots.
+  Atomic<AllocationInfo*> allocation_cache_[kMaxCachedAllocationUnits][kAllocationCacheSlots];
 };
 
 }  // namespace space
@@ -17,6 +17,7 @@
 #include "large_object_space.h"
 
 #include "base/time_utils.h"
+#include "base/utils.h"
 #include "space_test.h"
 
 namespace art HIDDEN {
@@ -30,6 +31,10 @@ class LargeObjectSpaceTest : public SpaceTest<CommonRuntimeTest> {
   static constexpr size_t kNumThreads = 10;
   static constexpr size_t kNumIterations = 1000;
   void RaceTest();
+
+  static constexpr size_t kMaxScalingThreads = 8;
+  static constexpr size_t kNumScalingIterations = 2000;
+  void ScalingTest();
 };
 
 
@@ -175,6 +180,81 @@ void LargeObjectSpaceTest::RaceTest() {
   }
 }
 
+class AllocScalingTask : public Task {
+ public:
+  AllocScalingTask(size_t iterations, size_t size, LargeObjectSpace* los)
+      : iterations_(iterations), size_(size), los_(los) {}
+
+  void Run(Thread* self) override {
+    static constexpr size_t kLiveObjects = 4;
+    mirror::Object* live[kLiveObjects] = {};
+    for (size_t i = 0; i < iterations_; ++i) {
+      size_t alloc_size, bytes_tl_bulk_allocated;
+      size_t idx = i % kLiveObjects;
+      if (live[idx] != nullptr) {
+        los_->Free(self, live[idx]);
+      }
+      live[idx] = los_->Alloc(self, size_, &alloc_size, nullptr, &bytes_tl_bulk_allocated);
+      CHECK(live[idx] != nullptr);
+      // Recycled blocks must come back zeroed.
+      CHECK_EQ(reinterpret_cast<uint32_t*>(live[idx])[0], 0u);
+      reinterpret_cast<uint32_t*>(live[idx])[0] = 0xdeadbeef;
+    }
+    for (mirror::Object* obj : live) {
+      if (obj != nullptr) {
+        los_->Free(self, obj);
+      }
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  size_t iterations_;
+  size_t size_;
+  LargeObjectSpace* los_;
+};
+
+// Measures alloc/free throughput of the free-list space with an increasing number of threads.
+// Timings are only logged, but the space must be empty once all threads are done.
+void LargeObjectSpaceTest::ScalingTest() {
+  Thread* self = Thread::Current();
+  for (size_t size : {3 * LargeObjectSpace::ObjectAlignment(),
+                      16 * LargeObjectSpace::ObjectAlignment(),
+                      64 * LargeObjectSpace::ObjectAlignment()}) {
+    for (size_t num_threads = 1; num_threads <= kMaxScalingThreads; num_threads *= 2) {
+      std::unique_ptr<LargeObjectSpace> los(
+          space::FreeListSpace::Create("large object space", 128 * MB));
+      std::unique_ptr<ThreadPool> thread_pool(
+          ThreadPool::Create("Large object space scaling thread pool", num_threads));
+      for (size_t i = 0; i < num_threads; ++i) {
+        thread_pool->AddTask(self, new AllocScalingTask(kNumScalingIterations, size, los.get()));
+      }
+      const uint64_t start_time = NanoTime();
+      thread_pool->StartWorkers(self);
+      thread_pool->Wait(self, false, false);
+      const uint64_t duration = NanoTime() - start_time;
+      LOG(INFO) << "FreeListSpace " << PrettySize(size) << " x " << num_threads << " threads: "
+                << PrettyDuration(duration) << " ("
+                << (num_threads * kNumScalingIterations * 1000000000ull) / std::max<uint64_t>(
+                       duration, 1u) << " allocations/s)";
+      EXPECT_EQ(0U, los->GetBytesAllocated());
+      EXPECT_EQ(0U, los->GetObjectsAllocated());
+      EXPECT_EQ(num_threads * kNumScalingIterations, los->GetTotalObjectsAllocated());
+      size_t walked_objects = 0;
+      los->Walk([](void* start, void*, size_t, void* arg) {
+                  if (start != nullptr) {
+                    ++*reinterpret_cast<size_t*>(arg);
+                  }
+                },
+                &walked_objects);
+      EXPECT_EQ(0U, walked_objects);
+    }
+  }
+}
+
 TEST_F(LargeObjectSpaceTest, LargeObjectTest) {
   LargeObjectTest();
 }
@@ -183,6 +263,10 @@ TEST_F(LargeObjectSpaceTest, RaceTest) {
   RaceTest();
 }
 
+TEST_F(LargeObjectSpaceTest, ScalingTest) {
+  ScalingTest();
+}
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
@@ -15,6 +15,13 @@
  */
 #include <deque>
 
+#include <dirent.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "android-base/file.h"
+#include "android-base/parseint.h"
+#include "android-base/strings.h"
 #include "bump_pointer_space-inl.h"
 #include "bump_pointer_space.h"
 #include "base/dumpable.h"
@@ -32,6 +39,19 @@ namespace space {
 // value of the region size, evaculate the region.
 static constexpr uint kEvacuateLivePercentThreshold = 75U;
 
+// The liveness history of a region can override the threshold above. A region whose live percent
+// did not drop by more than kStableLiveDropPercent for kStableRegionCycles evacuation decisions
+// holds long-lived objects, and is not evacuated as long as it is at least
+// kStableRegionLivePercentThreshold percent live: copying it would not free much more next time.
+// A region whose live percent dropped by at least kSparseningDropPercent since the previous
+// decision is evacuated if it is less than kSparseningLivePercentThreshold percent live, instead
+// of waiting for it to become sparse enough.
+static constexpr uint kStableLiveDropPercent = 5U;
+static constexpr uint kStableRegionCycles = 3U;
+static constexpr uint kStableRegionLivePercentThreshold = 50U;
+static constexpr uint kSparseningDropPercent = 20U;
+static constexpr uint kSparseningLivePercentThreshold = 90U;
+
 // Whether we protect the unused and cleared regions.
 static constexpr bool kProtectClearedRegions = kIsDebugBuild;
 
@@ -47,6 +67,30 @@ static constexpr uint32_t kPoisonDeadObject = 0xBADDB01D;  // "BADDROID"
 // Whether we check a region's live bytes count against the region bitmap.
 static constexpr bool kCheckLiveBytesAgainstRegionBitmap = kIsDebugBuild;
 
+// Maximum number of NUMA region pools.
+static constexpr size_t kMaxNumaPools = 8;
+
+// Parse a sysfs CPU list like "0-3,8-11" and call `fn` for every CPU in it.
+template <typename Fn>
+static bool ParseCpuList(const std::string& list, Fn&& fn) {
+  for (const std::string& range : android::base::Split(android::base::Trim(list), ",")) {
+    std::vector<std::string> bounds = android::base::Split(range, "-");
+    uint32_t first;
+    uint32_t last;
+    if (bounds.empty() || bounds.size() > 2 || !android::base::ParseUint(bounds[0], &first)) {
+      return false;
+    }
+    last = first;
+    if (bounds.size() == 2 && !android::base::ParseUint(bounds[1], &last)) {
+      return false;
+    }
+    for (uint32_t cpu = first; cpu <= last; ++cpu) {
+      fn(cpu);
+    }
+  }
+  return true;
+}
+
 MemMap RegionSpace::CreateMemMap(const std::string& name,
                                  size_t capacity,
                                  uint8_t* requested_begin) {
@@ -111,13 +155,16 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
       time_(1U),
       num_regions_(mem_map_.Size() / kRegionSize),
       madvise_time_(0U),
+      use_huge_pages_(false),
       num_non_free_regions_(0U),
       num_evac_regions_(0U),
       max_peak_num_non_free_regions_(0U),
       non_free_region_index_limit_(0U),
       current_region_(&full_region_),
       evac_region_(nullptr),
-      cyclic_alloc_region_index_(0U) {
+      cyclic_alloc_region_index_(0U),
+      num_numa_pools_(1U),
+      num_regions_per_numa_pool_(0U) {
   CHECK_ALIGNED(mem_map_.Size(), kRegionSize);
   CHECK_ALIGNED(mem_map_.Begin(), kRegionSize);
   DCHECK_GT(num_regions_, 0U);
@@ -145,6 +192,62 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
   DCHECK(full_region_.Alloc(kAlignment, &ignored, nullptr, &ignored) == nullptr);
   // Protect the whole region space from the start.
   Protect();
+  if (kNumaAwareRegionAllocation) {
+    InitNumaPools();
+  }
+}
+
+void RegionSpace::InitNumaPools() {
+  static constexpr const char* kNodeDir = "/sys/devices/system/node";
+  long num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+  if (num_cpus <= 0) {
+    return;
+  }
+  std::vector<uint8_t> cpu_to_node(num_cpus, 0u);
+  size_t num_nodes = 0;
+  std::unique_ptr<DIR, int (*)(DIR*)> dir(opendir(kNodeDir), closedir);
+  if (dir == nullptr) {
+    return;
+  }
+  for (dirent* entry = readdir(dir.get()); entry != nullptr; entry = readdir(dir.get())) {
+    std::string_view name(entry->d_name);
+    uint32_t node;
+    if (!name.starts_with("node") ||
+        !android::base::ParseUint(std::string(name.substr(4)), &node) || node >= kMaxNumaPools) {
+      continue;
+    }
+    std::string cpu_list;
+    if (!android::base::ReadFileToString(
+            std::string(kNodeDir) + "/" + std::string(name) + "/cpulist", &cpu_list)) {
+      continue;
+    }
+    bool parsed = ParseCpuList(cpu_list, [&](uint32_t cpu) {
+      if (cpu < cpu_to_node.size()) {
+        cpu_to_node[cpu] = static_cast<uint8_t>(node);
+      }
+    });
+    if (!parsed) {
+      return;
+    }
+    num_nodes = std::max(num_nodes, static_cast<size_t>(node) + 1);
+  }
+  // Each pool should at least be able to hand out a few TLABs.
+  if (num_nodes <= 1 || num_regions_ / num_nodes < 4) {
+    return;
+  }
+  num_numa_pools_ = num_nodes;
+  num_regions_per_numa_pool_ = num_regions_ / num_nodes;
+  cpu_to_numa_pool_ = std::move(cpu_to_node);
+  VLOG(heap) << "RegionSpace: using " << num_numa_pools_ << " NUMA region pools of "
+             << num_regions_per_numa_pool_ << " regions";
+}
+
+size_t RegionSpace::CurrentNumaPool() const {
+  int cpu = sched_getcpu();
+  if (cpu < 0 || static_cast<size_t>(cpu) >= cpu_to_numa_pool_.size()) {
+    return 0;
+  }
+  return cpu_to_numa_pool_[cpu];
 }
 
 size_t RegionSpace::FromSpaceSize() {
@@ -190,10 +293,10 @@ void RegionSpace::Region::SetAsUnevacFromSpace(bool clear_live_bytes) {
   type_ = RegionType::kRegionTypeUnevacFromSpace;
   if (IsNewlyAllocated()) {
     // A newly allocated region set as unevac from-space must be
-    // a large or large tail region.
-    DCHECK(IsLarge() || IsLargeTail()) << static_cast<uint>(state_);
-    // Always clear the live bytes of a newly allocated (large or
-    // large tail) region.
+    // a large, large tail or pinned region.
+    DCHECK(IsLarge() || IsLargeTail() || IsPinned()) << static_cast<uint>(state_);
+    // Always clear the live bytes of a newly allocated (large, large
+    // tail or pinned) region.
     clear_live_bytes = true;
     // Clear the "newly allocated" status here, as we do not want the
     // GC to see it when encountering (and processing) references in the
@@ -218,7 +321,9 @@ bool RegionSpace::Region::GetUseGenerationalCC() {
   return art::Runtime::Current()->GetHeap()->GetUseGenerationalCC();
 }
 
-inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
+inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode,
+                                                   uint32_t time,
+                                                   LivenessHistogram* histogram) {
   // Evacuation mode `kEvacModeNewlyAllocated` is only used during sticky-bit CC collections.
   DCHECK(GetUseGenerationalCC() || (evac_mode != kEvacModeNewlyAllocated));
   DCHECK((IsAllocated() || IsLarge()) && IsInToSpace());
@@ -232,6 +337,11 @@ inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
     // is live, we would just be moving around region-aligned memory.
     return false;
   }
+  if (UNLIKELY(IsPinned())) {
+    // A JNI critical section accesses an object of the region directly and relies on its
+    // address not changing. See `RegionSpace::PinRegionOf()`.
+    return false;
+  }
   if (UNLIKELY(evac_mode == kEvacModeForceAll)) {
     return true;
   }
@@ -265,7 +375,37 @@ inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
       // Side node: live_percent == 0 does not necessarily mean
       // there's no live objects due to rounding (there may be a
       // few).
-      return live_bytes_ * 100U < kEvacuateLivePercentThreshold * bytes_allocated;
+      const uint live_percent = live_bytes_ * 100U / bytes_allocated;
+      bool evacuate = live_bytes_ * 100U < kEvacuateLivePercentThreshold * bytes_allocated;
+      if (prev_live_percent_ != kUnknownLivePercent) {
+        if (live_percent + kStableLiveDropPercent >= prev_live_percent_) {
+          stable_cycles_ = std::min(stable_cycles_ + 1u, static_cast<uint>(UINT8_MAX));
+        } else {
+          stable_cycles_ = 0;
+        }
+        if (evacuate &&
+            stable_cycles_ >= kStableRegionCycles &&
+            live_percent >= kStableRegionLivePercentThreshold) {
+          evacuate = false;
+          ++histogram->num_stable_kept;
+        } else if (!evacuate &&
+                   live_percent + kSparseningDropPercent <= prev_live_percent_ &&
+                   live_percent < kSparseningLivePercentThreshold) {
+          evacuate = true;
+          ++histogram->num_sparsening_evacuated;
+        }
+      }
+      prev_live_percent_ = live_percent;
+      DCHECK_LE(alloc_time_, time);
+      ++histogram->live_percent[std::min(live_percent * LivenessHistogram::kNumLivePercentBuckets /
+                                             100U,
+                                         LivenessHistogram::kNumLivePercentBuckets - 1)];
+      ++histogram->age[std::min<size_t>(time - alloc_time_, LivenessHistogram::kNumAgeBuckets - 1)];
+      ++histogram->num_regions;
+      if (evacuate) {
+        ++histogram->num_evacuated;
+      }
+      return evacuate;
     }
   }
   return false;
@@ -342,7 +482,7 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
         DCHECK((state == RegionState::kRegionStateAllocated ||
                 state == RegionState::kRegionStateLarge) &&
                type == RegionType::kRegionTypeToSpace);
-        bool should_evacuate = r->ShouldBeEvacuated(evac_mode);
+        bool should_evacuate = r->ShouldBeEvacuated(evac_mode, time_, &liveness_histogram_);
         bool is_newly_allocated = r->IsNewlyAllocated();
         if (should_evacuate) {
           r->SetAsFromSpace();
@@ -351,6 +491,18 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
           r->SetAsUnevacFromSpace(clear_live_bytes);
           DCHECK(r->IsInUnevacFromSpace());
         }
+        if (UNLIKELY(state == RegionState::kRegionStateAllocated &&
+                     !should_evacuate &&
+                     is_newly_allocated)) {
+          // A pinned newly allocated region. Like for the newly allocated large
+          // objects below, clear the mark-bits that the marking phase of a 2-phase
+          // full heap GC may have set, so that the live bytes are correctly updated.
+          DCHECK(r->IsPinned());
+          if (use_generational_cc_) {
+            GetMarkBitmap()->ClearRange(reinterpret_cast<mirror::Object*>(r->Begin()),
+                                        reinterpret_cast<mirror::Object*>(r->End()));
+          }
+        }
         if (UNLIKELY(state == RegionState::kRegionStateLarge &&
                      type == RegionType::kRegionTypeToSpace)) {
           prev_large_evacuated = should_evacuate;
@@ -393,15 +545,51 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
   evac_region_ = &full_region_;
 }
 
-static void ZeroAndProtectRegion(uint8_t* begin, uint8_t* end, bool release_eagerly) {
-  ZeroMemory(begin, end - begin, release_eagerly);
+static void ZeroAndProtectRegion(uint8_t* begin,
+                                 uint8_t* end,
+                                 bool release_eagerly,
+                                 bool use_huge_pages = false) {
+  if (release_eagerly && use_huge_pages) {
+    ZeroAndReleaseHugePages(begin, end - begin);
+  } else {
+    ZeroMemory(begin, end - begin, release_eagerly);
+  }
   if (kProtectClearedRegions) {
     CheckedCall(mprotect, __FUNCTION__, begin, end - begin, PROT_NONE);
   }
 }
 
+void RegionSpace::EnableHugePages() {
+  MutexLock mu(Thread::Current(), region_lock_);
+  use_huge_pages_ = GetMemMap()->AdviseHugePages();
+}
+
 void RegionSpace::ReleaseFreeRegions() {
   MutexLock mu(Thread::Current(), region_lock_);
+  if (use_huge_pages_) {
+    // Free regions are already zeroed, so only release the huge pages that are entirely made of
+    // free regions and leave the others intact.
+    const size_t huge_page_size = MemMap::GetHugePageSize();
+    size_t i = 0u;
+    while (i < num_regions_) {
+      if (!regions_[i].IsFree()) {
+        ++i;
+        continue;
+      }
+      uint8_t* begin = regions_[i].Begin();
+      while (i < num_regions_ && regions_[i].IsFree()) {
+        ++i;
+      }
+      uint8_t* end = regions_[i - 1].End();
+      uint8_t* huge_page_begin = AlignUp(begin, huge_page_size);
+      uint8_t* huge_page_end = AlignDown(end, huge_page_size);
+      if (huge_page_begin < huge_page_end) {
+        bool res = madvise(huge_page_begin, huge_page_end - huge_page_begin, MADV_DONTNEED);
+        CHECK_NE(res, -1) << "madvise failed";
+      }
+    }
+    return;
+  }
   for (size_t i = 0u; i < num_regions_; ++i) {
     if (regions_[i].IsFree()) {
       uint8_t* begin = regions_[i].Begin();
@@ -429,9 +617,11 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
   // the lock and loop over the regions to clear the from-space regions and make
   // them availabe for allocation.
   std::deque<std::pair<uint8_t*, uint8_t*>> madvise_list;
+  bool use_huge_pages;
   // Gather memory ranges that need to be madvised.
   {
     MutexLock mu(Thread::Current(), region_lock_);
+    use_huge_pages = use_huge_pages_;
     // Lambda expression `expand_madvise_range` adds a region to the "clear block".
     //
     // As we iterate over from-space regions, we maintain a "clear block", composed of
@@ -497,7 +687,7 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
   // Madvise the memory ranges.
   uint64_t start_time = NanoTime();
   for (const auto &iter : madvise_list) {
-    ZeroAndProtectRegion(iter.first, iter.second, release_eagerly);
+    ZeroAndProtectRegion(iter.first, iter.second, release_eagerly, use_huge_pages);
   }
   madvise_time_ += NanoTime() - start_time;
 
@@ -839,6 +1029,35 @@ void RegionSpace::DumpRegions(std::ostream& os) {
   }
 }
 
+void RegionSpace::DumpLivenessHistogram(std::ostream& os) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  const LivenessHistogram& histogram = liveness_histogram_;
+  if (histogram.num_regions == 0) {
+    return;
+  }
+  os << "Region liveness: " << histogram.num_regions << " regions, evacuated "
+     << histogram.num_evacuated << ", kept stable " << histogram.num_stable_kept
+     << ", evacuated sparsening " << histogram.num_sparsening_evacuated << "\n";
+  os << "Region live percent histogram:";
+  for (size_t i = 0; i < LivenessHistogram::kNumLivePercentBuckets; ++i) {
+    const size_t bucket_size = 100U / LivenessHistogram::kNumLivePercentBuckets;
+    os << " " << i * bucket_size << "-" << (i + 1) * bucket_size << "%:"
+       << histogram.live_percent[i];
+  }
+  os << "\n";
+  os << "Region age histogram (GCs):";
+  for (size_t i = 0; i < LivenessHistogram::kNumAgeBuckets; ++i) {
+    os << " " << i << (i + 1 == LivenessHistogram::kNumAgeBuckets ? "+:" : ":")
+       << histogram.age[i];
+  }
+  os << "\n";
+}
+
+void RegionSpace::ResetLivenessHistogram() {
+  MutexLock mu(Thread::Current(), region_lock_);
+  liveness_histogram_ = LivenessHistogram();
+}
+
 void RegionSpace::DumpNonFreeRegions(std::ostream& os) {
   MutexLock mu(Thread::Current(), region_lock_);
   for (size_t i = 0; i < num_regions_; ++i) {
@@ -975,6 +1194,10 @@ void RegionSpace::Region::Dump(std::ostream& os) const {
        << " (" << PrettySize(longest_consecutive_free_bytes) << ")";
   }
 
+  if (prev_live_percent_ != kUnknownLivePercent) {
+    os << " prev_live_percent=" << static_cast<uint>(prev_live_percent_)
+       << " stable_cycles=" << static_cast<uint>(stable_cycles_);
+  }
   os << " is_newly_allocated=" << std::boolalpha << is_newly_allocated_ << std::noboolalpha
      << " is_a_tlab=" << std::boolalpha << is_a_tlab_ << std::noboolalpha
      << " thread=" << thread_ << '\n';
@@ -1019,6 +1242,7 @@ size_t RegionSpace::AllocationSizeNonvirtual(mirror::Object* obj, size_t* usable
 }
 
 void RegionSpace::Region::Clear(bool zero_and_release_pages) {
+  DCHECK(!IsPinned());
   top_.store(begin_, std::memory_order_relaxed);
   state_ = RegionState::kRegionStateFree;
   type_ = RegionType::kRegionTypeNone;
@@ -1031,6 +1255,8 @@ void RegionSpace::Region::Clear(bool zero_and_release_pages) {
   is_newly_allocated_ = false;
   is_a_tlab_ = false;
   thread_ = nullptr;
+  prev_live_percent_ = kUnknownLivePercent;
+  stable_cycles_ = 0;
 }
 
 void RegionSpace::TraceHeapSize() {
@@ -1042,6 +1268,22 @@ RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
   if (!for_evac && (num_non_free_regions_ + 1) * 2 > num_regions_) {
     return nullptr;
   }
+  if (kNumaAwareRegionAllocation && num_numa_pools_ > 1) {
+    // Prefer the local node's pool. If that's exhausted, then steal from the
+    // other pools, starting with the next one so that the remote allocations
+    // get spread out.
+    const size_t local_pool = CurrentNumaPool();
+    for (size_t i = 0; i < num_numa_pools_; ++i) {
+      size_t pool = (local_pool + i) % num_numa_pools_;
+      size_t begin = pool * num_regions_per_numa_pool_;
+      size_t end = pool + 1 == num_numa_pools_ ? num_regions_ : begin + num_regions_per_numa_pool_;
+      Region* r = AllocateRegionInRange(for_evac, begin, end);
+      if (r != nullptr) {
+        return r;
+      }
+    }
+    return nullptr;
+  }
   for (size_t i = 0; i < num_regions_; ++i) {
     // When using the cyclic region allocation strategy, try to
     // allocate a region starting from the last cyclic allocated
@@ -1052,19 +1294,7 @@ RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
         : i;
     Region* r = &regions_[region_index];
     if (r->IsFree()) {
-      r->Unfree(this, time_);
-      if (use_generational_cc_) {
-        // TODO: Add an explanation for this assertion.
-        DCHECK_IMPLIES(for_evac, !r->is_newly_allocated_);
-      }
-      if (for_evac) {
-        ++num_evac_regions_;
-        TraceHeapSize();
-        // Evac doesn't count as newly allocated.
-      } else {
-        r->SetNewlyAllocated();
-        ++num_non_free_regions_;
-      }
+      ClaimFreeRegion(r, for_evac);
       if (kCyclicRegionAllocation) {
         // Move the cyclic allocation region marker to the region
         // following the one that was just allocated.
@@ -1076,6 +1306,34 @@ RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
   return nullptr;
 }
 
+RegionSpace::Region* RegionSpace::AllocateRegionInRange(bool for_evac, size_t begin, size_t end) {
+  DCHECK_LE(end, num_regions_);
+  for (size_t i = begin; i < end; ++i) {
+    Region* r = &regions_[i];
+    if (r->IsFree()) {
+      ClaimFreeRegion(r, for_evac);
+      return r;
+    }
+  }
+  return nullptr;
+}
+
+void RegionSpace::ClaimFreeRegion(Region* r, bool for_evac) {
+  r->Unfree(this, time_);
+  if (use_generational_cc_) {
+    // TODO: Add an explanation for this assertion.
+    DCHECK_IMPLIES(for_evac, !r->is_newly_allocated_);
+  }
+  if (for_evac) {
+    ++num_evac_regions_;
+    TraceHeapSize();
+    // Evac doesn't count as newly allocated.
+  } else {
+    r->SetNewlyAllocated();
+    ++num_non_free_regions_;
+  }
+}
+
 void RegionSpace::Region::MarkAsAllocated(RegionSpace* region_space, uint32_t alloc_time) {
   DCHECK(IsFree());
   alloc_time_ = alloc_time;
@@ -24,6 +24,7 @@
 
 #include <functional>
 #include <map>
+#include <vector>
 
 namespace art HIDDEN {
 namespace gc {
@@ -43,6 +44,14 @@ namespace space {
 // only enable it in debug mode.
 static constexpr bool kCyclicRegionAllocation = kIsDebugBuild;
 
+// NUMA-aware region allocation. If `true` and the machine has more than one
+// NUMA node, the regions are partitioned into one contiguous pool per node,
+// and region allocation (for TLABs as well as evacuation) first tries the pool
+// of the node on which the requesting thread is running, before falling back
+// to the other pools. Only meant for host-side ART on multi-socket machines.
+// Not compatible with cyclic region allocation.
+static constexpr bool kNumaAwareRegionAllocation = !kIsTargetBuild && !kCyclicRegionAllocation;
+
 // A space that consists of equal-sized regions.
 class RegionSpace final : public ContinuousMemMapAllocSpace {
  public:
@@ -142,6 +151,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // Dump region containing object `obj`. Precondition: `obj` is in the region space.
   void DumpRegionForObject(std::ostream& os, mirror::Object* obj) REQUIRES(!region_lock_);
   EXPORT void DumpNonFreeRegions(std::ostream& os) REQUIRES(!region_lock_);
+  // Dump the live percent and age of the regions seen by the evacuation decisions since the last
+  // reset, and how often the liveness history changed the decision.
+  void DumpLivenessHistogram(std::ostream& os) REQUIRES(!region_lock_);
+  void ResetLivenessHistogram() REQUIRES(!region_lock_);
 
   EXPORT size_t RevokeThreadLocalBuffers(Thread* thread) override REQUIRES(!region_lock_);
   size_t RevokeThreadLocalBuffers(Thread* thread, const bool reuse) REQUIRES(!region_lock_);
@@ -301,6 +314,22 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // objects.
   void ZeroLiveBytesForLargeObject(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Pin the region of `obj` while a JNI critical section accesses `obj` directly. A pinned
+  // region is not evacuated, so `obj` keeps its address without blocking the collections like
+  // disabling the thread flip does. The evacuation decision is made while the mutators are
+  // suspended, so a runnable thread can pin and unpin without synchronizing with the GC.
+  void PinRegionOf(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+    Region* r = RefToRegionUnlocked(obj);
+    DCHECK(!r->IsFree() && !r->IsLargeTail());
+    r->pin_count_.fetch_add(1u, std::memory_order_relaxed);
+  }
+
+  void UnpinRegionOf(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+    Region* r = RefToRegionUnlocked(obj);
+    uint32_t old_pin_count = r->pin_count_.fetch_sub(1u, std::memory_order_relaxed);
+    DCHECK_NE(old_pin_count, 0u);
+  }
+
   // Determine which regions to evacuate and tag them as
   // from-space. Tag the rest as unevacuated from-space.
   void SetFromSpace(accounting::ReadBarrierTable* rb_table,
@@ -387,11 +416,32 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
 
   void ReleaseFreeRegions();
 
+  // Back the space with transparent huge pages. Clearing and trimming then only release whole
+  // huge pages, so that they are not split.
+  void EnableHugePages() REQUIRES(!region_lock_);
+
  private:
   RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
 
+  // Statistics on the regions whose live percent was known when deciding which regions to evacuate.
+  struct LivenessHistogram {
+    static constexpr size_t kNumLivePercentBuckets = 10;
+    // Age in number of GCs since the region was allocated. The last bucket is for older regions.
+    static constexpr size_t kNumAgeBuckets = 8;
+
+    uint64_t live_percent[kNumLivePercentBuckets] = {};
+    uint64_t age[kNumAgeBuckets] = {};
+    uint64_t num_regions = 0;
+    uint64_t num_evacuated = 0;
+    // Regions kept because they were stably dense, and evacuated because they became sparse.
+    uint64_t num_stable_kept = 0;
+    uint64_t num_sparsening_evacuated = 0;
+  };
+
   class Region {
    public:
+    static constexpr uint8_t kUnknownLivePercent = 0xFF;
+
     Region()
         : idx_(static_cast<size_t>(-1)),
           live_bytes_(static_cast<size_t>(-1)),
@@ -404,7 +454,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
           is_newly_allocated_(false),
           is_a_tlab_(false),
           state_(RegionState::kRegionStateAllocated),
-          type_(RegionType::kRegionTypeToSpace) {}
+          type_(RegionType::kRegionTypeToSpace),
+          prev_live_percent_(kUnknownLivePercent),
+          stable_cycles_(0),
+          pin_count_(0u) {}
 
     void Init(size_t idx, uint8_t* begin, uint8_t* end) {
       idx_ = idx;
@@ -419,6 +472,8 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       is_newly_allocated_ = false;
       is_a_tlab_ = false;
       thread_ = nullptr;
+      prev_live_percent_ = kUnknownLivePercent;
+      stable_cycles_ = 0;
       DCHECK_LT(begin, end);
       DCHECK_EQ(static_cast<size_t>(end - begin), kRegionSize);
     }
@@ -486,6 +541,12 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     }
 
     // Large-tail allocated.
+    // Whether a JNI critical section accesses an object of the region directly, in which case
+    // the region is not evacuated. See `RegionSpace::PinRegionOf()`.
+    bool IsPinned() const {
+      return pin_count_.load(std::memory_order_relaxed) != 0u;
+    }
+
     bool IsLargeTail() const {
       bool is_large_tail = (state_ == RegionState::kRegionStateLargeTail);
       if (is_large_tail) {
@@ -557,7 +618,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     }
 
     // Return whether this region should be evacuated. Used by RegionSpace::SetFromSpace.
-    ALWAYS_INLINE bool ShouldBeEvacuated(EvacMode evac_mode);
+    // Updates the liveness history of the region, and `histogram` if the live percent is known.
+    ALWAYS_INLINE bool ShouldBeEvacuated(EvacMode evac_mode,
+                                         uint32_t time,
+                                         LivenessHistogram* histogram);
 
     void AddLiveBytes(size_t live_bytes) {
       DCHECK(GetUseGenerationalCC() || IsInUnevacFromSpace());
@@ -641,6 +705,12 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     bool is_a_tlab_;                    // True if it's a tlab.
     RegionState state_;                 // The region state (see RegionState).
     RegionType type_;                   // The region type (see RegionType).
+    // The live percent when the previous evacuation decision was made, or kUnknownLivePercent.
+    uint8_t prev_live_percent_;
+    // Number of consecutive decisions for which the live percent did not drop significantly.
+    uint8_t stable_cycles_;
+    // Number of JNI critical sections accessing an object of the region.
+    std::atomic<uint32_t> pin_count_;
 
     friend class RegionSpace;
   };
@@ -716,6 +786,16 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   }
 
   EXPORT Region* AllocateRegion(bool for_evac) REQUIRES(region_lock_);
+  // Try to allocate a free region in the index range [`begin`, `end`). Returns
+  // null if there is none.
+  Region* AllocateRegionInRange(bool for_evac, size_t begin, size_t end) REQUIRES(region_lock_);
+  // Turn the free region `r` into an allocated one, updating the counters.
+  void ClaimFreeRegion(Region* r, bool for_evac) REQUIRES(region_lock_);
+  // Set up the per-node region pools if kNumaAwareRegionAllocation is enabled
+  // and there is more than one NUMA node.
+  void InitNumaPools();
+  // Returns the region pool of the NUMA node the calling thread is running on.
+  size_t CurrentNumaPool() const;
   void RevokeThreadLocalBuffersLocked(Thread* thread, bool reuse) REQUIRES(region_lock_);
 
   // Scan region range [`begin`, `end`) in increasing order to try to
@@ -752,6 +832,8 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   uint32_t time_;                  // The time as the number of collections since the startup.
   size_t num_regions_;             // The number of regions in this space.
   uint64_t madvise_time_;          // The amount of time spent in madvise for purging pages.
+  // Whether the space is backed by transparent huge pages.
+  bool use_huge_pages_ GUARDED_BY(region_lock_);
   // The number of non-free regions in this space.
   size_t num_non_free_regions_ GUARDED_BY(region_lock_);
 
@@ -766,6 +848,8 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // The pointer to the region array.
   std::unique_ptr<Region[]> regions_ GUARDED_BY(region_lock_);
 
+  LivenessHistogram liveness_histogram_ GUARDED_BY(region_lock_);
+
   // To hold partially used TLABs which can be reassigned to threads later for
   // utilizing the un-used portion.
   std::multimap<size_t, Region*, std::greater<size_t>> partial_tlabs_ GUARDED_BY(region_lock_);
@@ -785,6 +869,15 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // `kCyclicRegionAllocation` is true.
   size_t cyclic_alloc_region_index_ GUARDED_BY(region_lock_);
 
+  // Number of NUMA region pools. 1 unless NUMA-aware region allocation is
+  // enabled and there are multiple NUMA nodes. Pool `i` consists of regions
+  // [i * num_regions_per_numa_pool_, (i + 1) * num_regions_per_numa_pool_),
+  // with the last pool also getting the remaining regions.
+  size_t num_numa_pools_;
+  size_t num_regions_per_numa_pool_;
+  // CPU number to NUMA region pool mapping.
+  std::vector<uint8_t> cpu_to_numa_pool_;
+
   // Mark bitmap used by the GC.
   accounting::ContinuousSpaceBitmap mark_bitmap_;
 
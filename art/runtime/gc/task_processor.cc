@@ -16,6 +16,8 @@
 
 #include "task_processor.h"
 
+#include <ostream>
+
 #include "base/time_utils.h"
 #include "scoped_thread_state_change-inl.h"
 
@@ -26,7 +28,13 @@ TaskProcessor::TaskProcessor()
     : lock_("Task processor lock", kReferenceProcessorLock),
       cond_("Task processor condition", lock_),
       is_running_(false),
-      running_thread_(nullptr) {
+      running_thread_(nullptr),
+      num_workers_(0),
+      num_tasks_run_(0),
+      num_tasks_coalesced_(0),
+      num_tasks_delegated_(0),
+      total_latency_ns_(0),
+      max_latency_ns_(0) {
 }
 
 TaskProcessor::~TaskProcessor() {
@@ -38,11 +46,48 @@ TaskProcessor::~TaskProcessor() {
   }
 }
 
+bool TaskProcessor::InsertTask(HeapTask* task) {
+  task->enqueue_time_ = NanoTime();
+  const void* key = task->GetCoalescingKey();
+  if (key != nullptr) {
+    for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
+      HeapTask* pending = *it;
+      if (pending->GetCoalescingKey() == key && pending->TryCoalesce(task)) {
+        // The merged task must run no later than the new one would have.
+        if (task->GetTargetRunTime() < pending->GetTargetRunTime()) {
+          tasks_.erase(it);
+          pending->SetTargetRunTime(task->GetTargetRunTime());
+          tasks_.insert(pending);
+        }
+        ++num_tasks_coalesced_;
+        return false;
+      }
+    }
+  }
+  tasks_.insert(task);
+  return true;
+}
+
 void TaskProcessor::AddTask(Thread* self, HeapTask* task) {
   ScopedThreadStateChange tsc(self, ThreadState::kWaitingForTaskProcessor);
-  MutexLock mu(self, lock_);
-  tasks_.insert(task);
-  cond_.Signal(self);
+  bool added;
+  {
+    MutexLock mu(self, lock_);
+    added = InsertTask(task);
+    // Also signal for coalesced tasks, since the target run time may have changed.
+    cond_.Signal(self);
+  }
+  if (!added) {
+    task->Finalize();
+  }
+}
+
+void TaskProcessor::RecordLatency(HeapTask* task, uint64_t current_time) {
+  uint64_t ready_time = std::max(task->GetTargetRunTime(), task->enqueue_time_);
+  uint64_t latency = current_time > ready_time ? current_time - ready_time : 0u;
+  ++num_tasks_run_;
+  total_latency_ns_ += latency;
+  max_latency_ns_ = std::max(max_latency_ns_, latency);
 }
 
 HeapTask* TaskProcessor::GetTask(Thread* self) {
@@ -59,10 +104,22 @@ HeapTask* TaskProcessor::GetTask(Thread* self) {
       const uint64_t current_time = NanoTime();
       HeapTask* task = *tasks_.begin();
       // If we are shutting down, return the task right away without waiting. Otherwise return the
-      // task if it is late enough.
+      // task if it is late enough. Of the tasks ready to run, pick the earliest one with the
+      // highest priority.
       uint64_t target_time = task->GetTargetRunTime();
       if (!is_running_ || target_time <= current_time) {
-        tasks_.erase(tasks_.begin());
+        auto best = tasks_.begin();
+        for (auto it = std::next(best); it != tasks_.end(); ++it) {
+          if (is_running_ && (*it)->GetTargetRunTime() > current_time) {
+            break;
+          }
+          if ((*it)->GetPriority() > (*best)->GetPriority()) {
+            best = it;
+          }
+        }
+        task = *best;
+        tasks_.erase(best);
+        RecordLatency(task, current_time);
         return task;
       }
       DCHECK_GT(target_time, current_time);
@@ -143,17 +200,67 @@ void TaskProcessor::Start(Thread* self) {
   running_thread_ = self;
 }
 
+void TaskProcessor::SetNumWorkers(Thread* self, size_t num_workers) {
+  MutexLock mu(self, lock_);
+  num_workers_ = num_workers;
+}
+
 void TaskProcessor::RunAllTasks(Thread* self) {
+  std::unique_ptr<ThreadPool> workers;
+  {
+    MutexLock mu(self, lock_);
+    if (num_workers_ != 0) {
+      workers.reset(ThreadPool::Create("HeapTaskWorker", num_workers_));
+    }
+  }
+  if (workers != nullptr) {
+    workers->StartWorkers(self);
+  }
   while (true) {
     // Wait and get a task, may be interrupted.
     HeapTask* task = GetTask(self);
     if (task != nullptr) {
+      if (workers != nullptr && task->IsIndependent()) {
+        {
+          MutexLock mu(self, lock_);
+          ++num_tasks_delegated_;
+        }
+        // The pool finalizes the task.
+        workers->AddTask(self, task);
+        continue;
+      }
       task->Run(self);
       task->Finalize();
     } else if (!IsRunning()) {
       break;
     }
   }
+  if (workers != nullptr) {
+    // Finish the delegated tasks before returning.
+    workers->Wait(self, /* do_work= */ true, /* may_hold_locks= */ false);
+    workers->StopWorkers(self);
+  }
+}
+
+void TaskProcessor::DumpStats(std::ostream& os) {
+  MutexLock mu(Thread::Current(), lock_);
+  if (num_tasks_run_ == 0) {
+    return;
+  }
+  os << "Heap tasks run: " << num_tasks_run_
+     << " coalesced: " << num_tasks_coalesced_
+     << " delegated: " << num_tasks_delegated_
+     << " mean latency: " << PrettyDuration(total_latency_ns_ / num_tasks_run_)
+     << " max latency: " << PrettyDuration(max_latency_ns_) << "\n";
+}
+
+void TaskProcessor::ResetStats(Thread* self) {
+  MutexLock mu(self, lock_);
+  num_tasks_run_ = 0;
+  num_tasks_coalesced_ = 0;
+  num_tasks_delegated_ = 0;
+  total_latency_ns_ = 0;
+  max_latency_ns_ = 0;
 }
 
 }  // namespace gc
@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_GC_TASK_PROCESSOR_H_
 #define ART_RUNTIME_GC_TASK_PROCESSOR_H_
 
+#include <iosfwd>
 #include <memory>
 #include <set>
 
@@ -30,11 +31,40 @@ namespace gc {
 
 class HeapTask : public SelfDeletingTask {
  public:
-  explicit HeapTask(uint64_t target_run_time) : target_run_time_(target_run_time) {
+  // Among the tasks whose target run time has passed, the ones with a higher priority run first.
+  enum class Priority : uint8_t {
+    kLow,
+    kNormal,
+    kHigh,
+  };
+
+  explicit HeapTask(uint64_t target_run_time, Priority priority = Priority::kNormal)
+      : target_run_time_(target_run_time), priority_(priority) {
   }
   uint64_t GetTargetRunTime() const {
     return target_run_time_;
   }
+  Priority GetPriority() const {
+    return priority_;
+  }
+
+  // Tasks of the same type which may make each other redundant return the same non-null key,
+  // e.g. the address of a static in the task class. When such a task is added, TryCoalesce() is
+  // called on the pending tasks with the same key.
+  virtual const void* GetCoalescingKey() const {
+    return nullptr;
+  }
+  // Called with the task processor lock held. Returns true if this pending task now also does the
+  // work of `other`, which is then finalized without running. Must not block.
+  virtual bool TryCoalesce([[maybe_unused]] HeapTask* other) {
+    return false;
+  }
+
+  // Whether the task may run concurrently with other heap tasks. Independent tasks are run on the
+  // task processor's workers, if any.
+  virtual bool IsIndependent() const {
+    return false;
+  }
 
  private:
   // Update the updated_target_run_time_, the task processor will re-insert the task when it is
@@ -45,6 +75,9 @@ class HeapTask : public SelfDeletingTask {
 
   // Time in ns at which we want the task to run.
   uint64_t target_run_time_;
+  // Time in ns at which the task was added to the task processor.
+  uint64_t enqueue_time_ = 0;
+  const Priority priority_;
 
   friend class TaskProcessor;
   DISALLOW_IMPLICIT_CONSTRUCTORS(HeapTask);
@@ -69,6 +102,12 @@ class TaskProcessor {
   // If wait is true, and no thread has been registered via Start(), we briefly
   // wait for one to be registered. If we time out, we return true.
   bool IsRunningThread(Thread* t, bool wait = false) REQUIRES(!lock_);
+  // Run independent tasks on a pool of `num_workers` threads, created by RunAllTasks() and
+  // destroyed when it returns. Zero runs all tasks on the task processor thread.
+  void SetNumWorkers(Thread* self, size_t num_workers) REQUIRES(!lock_);
+  // Dump the latency between the target run time of the tasks and their execution.
+  void DumpStats(std::ostream& os) REQUIRES(!lock_);
+  void ResetStats(Thread* self) REQUIRES(!lock_);
 
  private:
   // Wait briefly for running_thread_ to become non-null. Return false on timeout.
@@ -81,11 +120,25 @@ class TaskProcessor {
     }
   };
 
+  // Add `task` unless a pending task coalesces it. Returns true if added.
+  bool InsertTask(HeapTask* task) REQUIRES(lock_);
+  // Record the scheduling latency of `task`, which is about to run.
+  void RecordLatency(HeapTask* task, uint64_t current_time) REQUIRES(lock_);
+
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ConditionVariable cond_ GUARDED_BY(lock_);
   bool is_running_ GUARDED_BY(lock_);
   std::multiset<HeapTask*, CompareByTargetRunTime> tasks_ GUARDED_BY(lock_);
   Thread* running_thread_ GUARDED_BY(lock_);
+  size_t num_workers_ GUARDED_BY(lock_);
+
+  // Statistics. Latencies are measured from the later of the target run time and the enqueue
+  // time, to the time the task is dequeued.
+  uint64_t num_tasks_run_ GUARDED_BY(lock_);
+  uint64_t num_tasks_coalesced_ GUARDED_BY(lock_);
+  uint64_t num_tasks_delegated_ GUARDED_BY(lock_);
+  uint64_t total_latency_ns_ GUARDED_BY(lock_);
+  uint64_t max_latency_ns_ GUARDED_BY(lock_);
 
   DISALLOW_COPY_AND_ASSIGN(TaskProcessor);
 };
@@ -15,6 +15,9 @@
  */
 
 #include "task_processor.h"
+
+#include <sstream>
+
 #include "base/time_utils.h"
 #include "common_runtime_test.h"
 #include "thread-current-inl.h"
@@ -144,5 +147,91 @@ TEST_F(TaskProcessorTest, Ordering) {
   ASSERT_EQ(counter, kNumTasks);
 }
 
+class TestPriorityTask : public HeapTask {
+ public:
+  TestPriorityTask(uint64_t target_time, Priority priority, std::vector<Priority>* order)
+     : HeapTask(target_time, priority), order_(order) {
+  }
+  void Run([[maybe_unused]] Thread* thread) override {
+    order_->push_back(GetPriority());
+  }
+
+ private:
+  std::vector<HeapTask::Priority>* const order_;
+};
+
+TEST_F(TaskProcessorTest, Priority) {
+  const uint64_t current_time = NanoTime();
+  Thread* const self = Thread::Current();
+  TaskProcessor task_processor;
+  task_processor.Stop(self);
+  std::vector<HeapTask::Priority> order;
+  // All tasks are due. The high priority one should run first even though it was due last.
+  task_processor.AddTask(
+      self, new TestPriorityTask(current_time - MsToNs(3), HeapTask::Priority::kLow, &order));
+  task_processor.AddTask(
+      self, new TestPriorityTask(current_time - MsToNs(2), HeapTask::Priority::kNormal, &order));
+  task_processor.AddTask(
+      self, new TestPriorityTask(current_time - MsToNs(1), HeapTask::Priority::kHigh, &order));
+  std::unique_ptr<ThreadPool> thread_pool(ThreadPool::Create("task processor test", 1U));
+  Atomic<bool> done_running(false);
+  thread_pool->AddTask(self, new WorkUntilDoneTask(&task_processor, &done_running));
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, false);
+  ASSERT_TRUE(done_running.load(std::memory_order_seq_cst));
+  ASSERT_EQ(order.size(), 3u);
+  EXPECT_EQ(order[0], HeapTask::Priority::kHigh);
+  EXPECT_EQ(order[1], HeapTask::Priority::kNormal);
+  EXPECT_EQ(order[2], HeapTask::Priority::kLow);
+}
+
+class CoalescingTask : public HeapTask {
+ public:
+  CoalescingTask(uint64_t target_time, size_t* counter)
+     : HeapTask(target_time), counter_(counter) {
+  }
+  void Run([[maybe_unused]] Thread* thread) override {
+    ++*counter_;
+  }
+  const void* GetCoalescingKey() const override {
+    return &kCoalescingKey;
+  }
+  bool TryCoalesce([[maybe_unused]] HeapTask* other) override {
+    return true;
+  }
+
+ private:
+  static constexpr char kCoalescingKey = 0;
+
+  size_t* const counter_;
+};
+
+TEST_F(TaskProcessorTest, Coalescing) {
+  const uint64_t current_time = NanoTime();
+  Thread* const self = Thread::Current();
+  TaskProcessor task_processor;
+  task_processor.Stop(self);
+  size_t counter = 0;
+  size_t other_counter = 0;
+  CoalescingTask* first = new CoalescingTask(current_time + MsToNs(1000), &counter);
+  task_processor.AddTask(self, first);
+  // Coalesced into the first task, which then runs at the earlier time.
+  task_processor.AddTask(self, new CoalescingTask(current_time, &other_counter));
+  EXPECT_EQ(first->GetTargetRunTime(), current_time);
+  // Tasks without a key are not coalesced.
+  task_processor.AddTask(self, new TestOrderTask(current_time, 0u, &other_counter));
+  std::unique_ptr<ThreadPool> thread_pool(ThreadPool::Create("task processor test", 1U));
+  Atomic<bool> done_running(false);
+  thread_pool->AddTask(self, new WorkUntilDoneTask(&task_processor, &done_running));
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, false);
+  ASSERT_TRUE(done_running.load(std::memory_order_seq_cst));
+  EXPECT_EQ(counter, 1u);
+  EXPECT_EQ(other_counter, 1u);
+  std::ostringstream oss;
+  task_processor.DumpStats(oss);
+  EXPECT_NE(oss.str().find("coalesced: 1"), std::string::npos) << oss.str();
+}
+
 }  // namespace gc
 }  // namespace art
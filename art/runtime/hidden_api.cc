@@ -735,6 +735,15 @@ bool ShouldDenyAccessToMember(T* member,
       // If this is a proxy method, look at the interface method instead.
       member = detail::GetInterfaceMemberIfProxy(member);
 
+      // Without side effects, the decision for a boot class path member can be cached.
+      const bool use_decision_cache = access_method == AccessMethod::kNone &&
+                                      member->GetDeclaringClass()->IsBootStrapClassLoaded();
+      AccessDecisionCache* decision_cache = runtime->GetHiddenApiDecisionCache();
+      bool deny_access;
+      if (use_decision_cache && decision_cache->Get(member, &deny_access)) {
+        return deny_access;
+      }
+
       // Decode hidden API access flags from the dex file.
       // This is an O(N) operation scaling with the number of fields/methods
       // in the class. Only do this on slow path and only do it once.
@@ -742,7 +751,11 @@ bool ShouldDenyAccessToMember(T* member,
       DCHECK(api_list.IsValid());
 
       // Member is hidden and caller is not exempted. Enter slow path.
-      return detail::ShouldDenyAccessToMemberImpl(member, api_list, access_method);
+      deny_access = detail::ShouldDenyAccessToMemberImpl(member, api_list, access_method);
+      if (use_decision_cache) {
+        decision_cache->Set(member, deny_access);
+      }
+      return deny_access;
     }
 
     case Domain::kPlatform: {
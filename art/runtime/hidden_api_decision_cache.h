@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_HIDDEN_API_DECISION_CACHE_H_
+#define ART_RUNTIME_HIDDEN_API_DECISION_CACHE_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "base/bit_utils.h"
+#include "base/macros.h"
+
+namespace art HIDDEN {
+namespace hiddenapi {
+
+// Process-wide cache of the hidden API decisions for application code accessing boot
+// class path members that are not public API, when the access is not reported
+// (`AccessMethod::kNone`). Such checks are done for every member when filtering the
+// results of reflective queries, and during linking.
+//
+// The decision only depends on the member and on the hidden API state of the runtime
+// (enforcement policies, exemptions, target SDK version and compat changes). The runtime
+// clears the cache when that state changes. Boot class path members are never unloaded,
+// so their addresses are stable keys.
+//
+// Entries are direct-mapped and hold the member address with the decision in the low
+// bit, so they are read and written with single relaxed atomic accesses and no lock.
+class AccessDecisionCache {
+ public:
+  static constexpr size_t kSize = 512;
+
+  AccessDecisionCache() {
+    Clear();
+  }
+
+  void Clear() {
+    for (std::atomic<uintptr_t>& entry : entries_) {
+      entry.store(0u, std::memory_order_relaxed);
+    }
+  }
+
+  ALWAYS_INLINE bool Get(const void* member, /*out*/ bool* deny_access) const {
+    uintptr_t entry = entries_[IndexOf(member)].load(std::memory_order_relaxed);
+    if ((entry & ~kDenyAccessBit) != reinterpret_cast<uintptr_t>(member)) {
+      return false;
+    }
+    *deny_access = (entry & kDenyAccessBit) != 0u;
+    return true;
+  }
+
+  ALWAYS_INLINE void Set(const void* member, bool deny_access) {
+    uintptr_t entry = reinterpret_cast<uintptr_t>(member) | (deny_access ? kDenyAccessBit : 0u);
+    entries_[IndexOf(member)].store(entry, std::memory_order_relaxed);
+  }
+
+ private:
+  // `ArtField` and `ArtMethod` are at least 4-byte aligned.
+  static constexpr uintptr_t kDenyAccessBit = 1u;
+
+  static ALWAYS_INLINE size_t IndexOf(const void* member) {
+    static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
+    uintptr_t address = reinterpret_cast<uintptr_t>(member);
+    return ((address >> 3) ^ (address >> 12)) & (kSize - 1);
+  }
+
+  std::array<std::atomic<uintptr_t>, kSize> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(AccessDecisionCache);
+};
+
+}  // namespace hiddenapi
+}  // namespace art
+
+#endif  // ART_RUNTIME_HIDDEN_API_DECISION_CACHE_H_
@@ -264,6 +264,33 @@ class HiddenApiTest : public CommonRuntimeTest {
   ArtMethod* class3_method1_i_;
 };
 
+TEST_F(HiddenApiTest, DecisionCacheInvalidatedByPolicyChanges) {
+  ScopedObjectAccess soa(self_);
+  hiddenapi::AccessDecisionCache* cache = runtime_->GetHiddenApiDecisionCache();
+  bool deny_access = false;
+
+  cache->Set(class1_field1_, /* deny_access= */ true);
+  ASSERT_TRUE(cache->Get(class1_field1_, &deny_access));
+  ASSERT_TRUE(deny_access);
+  ASSERT_FALSE(cache->Get(class1_field12_, &deny_access));
+
+  cache->Set(class1_method1_, /* deny_access= */ false);
+  ASSERT_TRUE(cache->Get(class1_method1_, &deny_access));
+  ASSERT_FALSE(deny_access);
+
+  runtime_->SetHiddenApiEnforcementPolicy(hiddenapi::EnforcementPolicy::kJustWarn);
+  ASSERT_FALSE(cache->Get(class1_field1_, &deny_access));
+  ASSERT_FALSE(cache->Get(class1_method1_, &deny_access));
+
+  cache->Set(class1_field1_, /* deny_access= */ true);
+  runtime_->SetTargetSdkVersion(runtime_->GetTargetSdkVersion());
+  ASSERT_FALSE(cache->Get(class1_field1_, &deny_access));
+
+  cache->Set(class1_field1_, /* deny_access= */ true);
+  runtime_->SetHiddenApiExemptions({});
+  ASSERT_FALSE(cache->Get(class1_field1_, &deny_access));
+}
+
 TEST_F(HiddenApiTest, CheckGetActionFromRuntimeFlags) {
   ScopedObjectAccess soa(self_);
 
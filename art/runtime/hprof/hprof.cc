@@ -326,40 +326,30 @@ class EndianOutputBuffered : public EndianOutput {
   }
 
   void HandleU2List(const uint16_t* values, size_t count) override {
-    DCHECK_EQ(length_, buffer_.size());
-    for (size_t i = 0; i < count; ++i) {
-      uint16_t value = *values;
-      buffer_.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-      buffer_.push_back(static_cast<uint8_t>((value >> 0) & 0xFF));
-      values++;
-    }
+    HandleBigEndianList(values, count);
   }
 
   void HandleU4List(const uint32_t* values, size_t count) override {
-    DCHECK_EQ(length_, buffer_.size());
-    for (size_t i = 0; i < count; ++i) {
-      uint32_t value = *values;
-      buffer_.push_back(static_cast<uint8_t>((value >> 24) & 0xFF));
-      buffer_.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-      buffer_.push_back(static_cast<uint8_t>((value >> 8)  & 0xFF));
-      buffer_.push_back(static_cast<uint8_t>((value >> 0)  & 0xFF));
-      values++;
-    }
+    HandleBigEndianList(values, count);
   }
 
   void HandleU8List(const uint64_t* values, size_t count) override {
+    HandleBigEndianList(values, count);
+  }
+
+  // Grow the buffer once for the whole list and store the values in big-endian order, rather
+  // than appending them one byte at a time.
+  template <typename T>
+  void HandleBigEndianList(const T* values, size_t count) {
     DCHECK_EQ(length_, buffer_.size());
+    size_t old_size = buffer_.size();
+    buffer_.resize(old_size + count * sizeof(T));
+    uint8_t* out = buffer_.data() + old_size;
     for (size_t i = 0; i < count; ++i) {
-      uint64_t value = *values;
-      buffer_.push_back(static_cast<uint8_t>((value >> 56) & 0xFF));
-      buffer_.push_back(static_cast<uint8_t>((value >> 48) & 0xFF));
-      buffer_.push_back(static_cast<uint8_t>((value >> 40) & 0xFF));
-      buffer_.push_back(static_cast<uint8_t>((value >> 32) & 0xFF));
-      buffer_.push_back(static_cast<uint8_t>((value >> 24) & 0xFF));
-      buffer_.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-      buffer_.push_back(static_cast<uint8_t>((value >> 8)  & 0xFF));
-      buffer_.push_back(static_cast<uint8_t>((value >> 0)  & 0xFF));
-      values++;
+      T value = values[i];
+      for (size_t byte = sizeof(T); byte != 0u; --byte) {
+        *out++ = static_cast<uint8_t>((value >> ((byte - 1u) * 8u)) & 0xFF);
+      }
     }
   }
 
@@ -388,24 +378,45 @@ class FileEndianOutput final : public EndianOutputBuffered {
   FileEndianOutput(File* fp, size_t reserved_size)
       : EndianOutputBuffered(reserved_size), fp_(fp), errors_(false) {
     DCHECK(fp != nullptr);
+    pending_.reserve(kWriteChunkSize);
   }
   ~FileEndianOutput() {
   }
 
+  // Write the records not written yet to the file.
+  void Flush() {
+    if (!errors_ && !pending_.empty()) {
+      errors_ = !fp_->WriteFully(pending_.data(), pending_.size());
+    }
+    pending_.clear();
+  }
+
   bool Errors() {
     return errors_;
   }
 
  protected:
+  // Heap dump segments are only a few KiB, so coalesce records to write the dump with far fewer
+  // system calls while all threads are suspended.
   void HandleFlush(const uint8_t* buffer, size_t length) override {
-    if (!errors_) {
-      errors_ = !fp_->WriteFully(buffer, length);
+    if (pending_.size() + length > kWriteChunkSize) {
+      Flush();
+    }
+    if (length >= kWriteChunkSize) {
+      if (!errors_) {
+        errors_ = !fp_->WriteFully(buffer, length);
+      }
+      return;
     }
+    pending_.insert(pending_.end(), buffer, buffer + length);
   }
 
  private:
+  static constexpr size_t kWriteChunkSize = 1 * MB;
+
   File* fp_;
   bool errors_;
+  std::vector<uint8_t> pending_;
 };
 
 class VectorEndianOuputput final : public EndianOutputBuffered {
@@ -776,6 +787,7 @@ class Hprof : public SingleRootVisitor {
       FileEndianOutput file_output(file.get(), max_length);
       output_ = &file_output;
       ProcessHeap(true);
+      file_output.Flush();
       okay = !file_output.Errors();
 
       if (okay) {
@@ -829,6 +841,7 @@ class Hprof : public SingleRootVisitor {
       REQUIRES(Locks::mutator_lock_, Locks::alloc_tracker_lock_) {
     gc::AllocRecordObjectMap* records = Runtime::Current()->GetHeap()->GetAllocationRecords();
     CHECK(records != nullptr);
+    records->MergeThreadLocalBuffers(Thread::Current());
     HprofStackTraceSerialNumber next_trace_sn = kHprofNullStackTrace + 1;
     HprofStackFrameId next_frame_id = 0;
     size_t count = 0;
@@ -17,8 +17,11 @@
 #ifndef ART_RUNTIME_IMT_CONFLICT_TABLE_H_
 #define ART_RUNTIME_IMT_CONFLICT_TABLE_H_
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 
+#include "base/bit_utils.h"
 #include "base/casts.h"
 #include "base/macros.h"
 #include "base/pointer_size.h"
@@ -212,6 +215,112 @@ class ImtConflictTable {
   DISALLOW_COPY_AND_ASSIGN(ImtConflictTable);
 };
 
+// Open-addressed hash index of a large ImtConflictTable, used by the conflict trampoline
+// instead of searching all the entries of the table on every call.
+//
+// The index is directly followed in memory by the table it indexes, and holds the same pairs
+// of { interface_method, implementation_method } in its slots. A lookup probes the slots
+// linearly, starting from slot `(interface_method >> kShift) & mask_`, until it finds the
+// interface method or an empty slot. There are `num_entries` more slots than `mask_ + 1`, so
+// the probing never wraps around and always ends at an empty slot, like the search of the
+// table ends at its null marker.
+//
+// The data of a conflict method with a hash index is the address of the index tagged with
+// `kTag` rather than the address of the table. Hash indexes are only created by the runtime
+// for its own pointer size, so images only contain plain tables.
+class ImtConflictHashIndex {
+ public:
+  // Tag of the conflict method data pointing to a hash index.
+  static constexpr uintptr_t kTag = 1u;
+  // The low bits of an ArtMethod* are discarded by the hash.
+  static constexpr size_t kShift = 4u;
+  // Smaller tables are only searched linearly.
+  static constexpr size_t kMinEntries = 8u;
+
+  // Offsets used by the conflict trampolines.
+  static constexpr size_t kMaskOffset = 0u;
+  static constexpr size_t kSlotsOffset = 2u * sizeof(void*);
+
+  // Create an empty index for a table of up to `num_entries` entries, allocated
+  // with `ComputeSize(num_entries)` bytes for the index before the table.
+  explicit ImtConflictHashIndex(size_t num_entries)
+      : mask_(NumHashSlots(num_entries) - 1u),
+        table_(reinterpret_cast<ImtConflictTable*>(
+            reinterpret_cast<uint8_t*>(this) + ComputeSize(num_entries))) {
+    static_assert(offsetof(ImtConflictHashIndex, mask_) == kMaskOffset);
+    static_assert(offsetof(ImtConflictHashIndex, slots_) == kSlotsOffset);
+    std::fill_n(slots_, NumSlots(num_entries) * kMethodCount, nullptr);
+  }
+
+  ImtConflictTable* GetTable() const {
+    return table_;
+  }
+
+  // Add the entries of the table to the index.
+  void Fill() {
+    const PointerSize pointer_size = kRuntimePointerSize;
+    for (size_t i = 0; ; ++i) {
+      ArtMethod* interface_method = table_->GetInterfaceMethod(i, pointer_size);
+      if (interface_method == nullptr) {
+        break;
+      }
+      size_t slot = GetFirstSlot(interface_method);
+      while (slots_[slot * kMethodCount + kMethodInterface] != nullptr) {
+        ++slot;
+      }
+      slots_[slot * kMethodCount + kMethodInterface] = interface_method;
+      slots_[slot * kMethodCount + kMethodImplementation] =
+          table_->GetImplementationMethod(i, pointer_size);
+    }
+  }
+
+  // Lookup the implementation ArtMethod associated to `interface_method`. Return null
+  // if not found.
+  ArtMethod* Lookup(ArtMethod* interface_method) const {
+    for (size_t slot = GetFirstSlot(interface_method); ; ++slot) {
+      ArtMethod* current_interface_method = slots_[slot * kMethodCount + kMethodInterface];
+      if (current_interface_method == nullptr) {
+        return nullptr;
+      }
+      if (current_interface_method == interface_method) {
+        return slots_[slot * kMethodCount + kMethodImplementation];
+      }
+    }
+  }
+
+  // Compute the size in bytes of an index for up to `num_entries` entries, excluding the table.
+  static size_t ComputeSize(size_t num_entries) {
+    return kSlotsOffset + NumSlots(num_entries) * kMethodCount * sizeof(ArtMethod*);
+  }
+
+ private:
+  enum MethodIndex {
+    kMethodInterface,
+    kMethodImplementation,
+    kMethodCount,  // Number of elements in enum.
+  };
+
+  // Keep the index at most half full, so that runs of used slots are short.
+  static size_t NumHashSlots(size_t num_entries) {
+    return RoundUpToPowerOfTwo(2u * num_entries);
+  }
+
+  static size_t NumSlots(size_t num_entries) {
+    return NumHashSlots(num_entries) + num_entries;
+  }
+
+  size_t GetFirstSlot(ArtMethod* interface_method) const {
+    return (reinterpret_cast<uintptr_t>(interface_method) >> kShift) & mask_;
+  }
+
+  const uintptr_t mask_;
+  ImtConflictTable* const table_;
+  // Array of slots that the assembly stubs will iterate over, allocated with the index.
+  ArtMethod* slots_[0];
+
+  DISALLOW_COPY_AND_ASSIGN(ImtConflictHashIndex);
+};
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_IMT_CONFLICT_TABLE_H_
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "imt_conflict_table.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace art HIDDEN {
+
+// Returns fake, but suitably aligned, ArtMethod pointers.
+static ArtMethod* FakeMethod(uintptr_t index) {
+  return reinterpret_cast<ArtMethod*>((index + 1u) << ImtConflictHashIndex::kShift);
+}
+
+TEST(ImtConflictHashIndexTest, Lookup) {
+  constexpr PointerSize kPointerSize = kRuntimePointerSize;
+  for (size_t num_entries : {ImtConflictHashIndex::kMinEntries, 13u, 64u}) {
+    const size_t index_size = ImtConflictHashIndex::ComputeSize(num_entries);
+    const size_t size = index_size + ImtConflictTable::ComputeSize(num_entries, kPointerSize);
+    std::vector<uint64_t> storage(RoundUp(size, sizeof(uint64_t)) / sizeof(uint64_t));
+    ImtConflictHashIndex* index = new (storage.data()) ImtConflictHashIndex(num_entries);
+    ImtConflictTable* table = new (index->GetTable()) ImtConflictTable(num_entries, kPointerSize);
+    ASSERT_EQ(reinterpret_cast<uint8_t*>(storage.data()) + index_size,
+              reinterpret_cast<uint8_t*>(table));
+    // Use interface methods that all map to the same slot, and some that do not collide.
+    for (size_t i = 0; i < num_entries; ++i) {
+      uintptr_t interface_index = (i % 2u == 0u) ? i * 1024u : i;
+      table->SetInterfaceMethod(i, kPointerSize, FakeMethod(interface_index));
+      table->SetImplementationMethod(i, kPointerSize, FakeMethod(interface_index + 1u));
+    }
+    index->Fill();
+    for (size_t i = 0; i < num_entries; ++i) {
+      uintptr_t interface_index = (i % 2u == 0u) ? i * 1024u : i;
+      EXPECT_EQ(FakeMethod(interface_index + 1u), index->Lookup(FakeMethod(interface_index)))
+          << num_entries << " " << i;
+    }
+    EXPECT_EQ(nullptr, index->Lookup(FakeMethod(num_entries * 1024u)));
+    EXPECT_EQ(nullptr, index->Lookup(FakeMethod(num_entries + 1u)));
+  }
+}
+
+}  // namespace art
@@ -17,6 +17,7 @@
 #include "indirect_reference_table-inl.h"
 
 #include "base/bit_utils.h"
+#include "base/casts.h"
 #include "base/globals.h"
 #include "base/mutator_locked_dumpable.h"
 #include "base/systrace.h"
@@ -85,7 +86,8 @@ IndirectReferenceTable::IndirectReferenceTable(IndirectRefKind kind)
       kind_(kind),
       top_index_(0u),
       max_entries_(0u),
-      current_num_holes_(0) {
+      current_num_holes_(0),
+      hole_indexes_() {
   CHECK_NE(kind, kJniTransition);
   CHECK_NE(kind, kLocal);
 }
@@ -149,10 +151,20 @@ void IndirectReferenceTable::ConstexprChecks() {
 // Holes:
 //
 // To keep the IRT compact, we want to fill "holes" created by non-stack-discipline Add & Remove
-// operation sequences. For simplicity and lower memory overhead, we do not use a free list or
-// similar. Instead, we scan for holes, with the expectation that we will find holes fast as they
-// are usually near the end of the table (see the header, TODO: verify this assumption). To avoid
-// scans when there are no holes, the number of known holes should be tracked.
+// operation sequences. Global references are often deleted out of order by many threads, so
+// scanning for holes near the end of the table would make Add linear in the table size while
+// holding the JNI globals lock. Instead, Remove pushes the index of each hole it creates on
+// `hole_indexes_`, and Add pops it. We do not store the links in the entries themselves, so that
+// a hole is still a null reference for the GC and the serial numbers are preserved.
+//
+// Removing the top-most entry also consumes the holes right below it, which would leave stale
+// indexes on the stack. Rather than searching the stack, we skip indexes that are no longer holes
+// when popping them, and drop the whole stack when there are no holes left. The number of known
+// holes is tracked exactly, so that Add does not look at the stack when there are none.
+
+// Upper bound of stale indexes we let `hole_indexes_` accumulate, relative to the table size,
+// before we rebuild it.
+static constexpr size_t kMaxHoleIndexesPerEntry = 2u;
 
 static size_t CountNullEntries(const IrtEntry* table, size_t to) {
   size_t count = 0;
@@ -174,6 +186,35 @@ static inline void CheckHoleCount(IrtEntry* table,
   }
 }
 
+uint32_t IndirectReferenceTable::PopHoleIndex() {
+  DCHECK_NE(current_num_holes_, 0u);
+  while (true) {
+    DCHECK(!hole_indexes_.empty());
+    uint32_t index = hole_indexes_.back();
+    hole_indexes_.pop_back();
+    if (index < top_index_ && table_[index].GetReference()->IsNull()) {
+      return index;
+    }
+    // Stale index of a hole consumed by a removal of the top-most entry.
+  }
+}
+
+void IndirectReferenceTable::PushHoleIndex(uint32_t index) {
+  DCHECK_LT(index, top_index_);
+  DCHECK(table_[index].GetReference()->IsNull());
+  if (UNLIKELY(hole_indexes_.size() >= kMaxHoleIndexesPerEntry * top_index_)) {
+    // Too many stale indexes. Rebuild the stack from the actual holes, lowest index last.
+    hole_indexes_.clear();
+    for (size_t i = top_index_; i != 0u; ) {
+      --i;
+      if (i != index && table_[i].GetReference()->IsNull()) {
+        hole_indexes_.push_back(dchecked_integral_cast<uint32_t>(i));
+      }
+    }
+  }
+  hole_indexes_.push_back(index);
+}
+
 IndirectRef IndirectReferenceTable::Add(ObjPtr<mirror::Object> obj, std::string* error_msg) {
   if (kDebugIRT) {
     LOG(INFO) << "+++ Add: top_index=" << top_index_
@@ -203,16 +244,12 @@ IndirectRef IndirectReferenceTable::Add(ObjPtr<mirror::Object> obj, std::string*
   size_t index;
   if (current_num_holes_ > 0) {
     DCHECK_GT(top_index_, 1U);
-    // Find the first hole; likely to be near the end of the list.
-    IrtEntry* p_scan = &table_[top_index_ - 1];
-    DCHECK(!p_scan->GetReference()->IsNull());
-    --p_scan;
-    while (!p_scan->GetReference()->IsNull()) {
-      DCHECK_GT(p_scan, table_);
-      --p_scan;
-    }
-    index = p_scan - table_;
+    // Reuse the most recently created hole.
+    index = PopHoleIndex();
     current_num_holes_--;
+    if (current_num_holes_ == 0u) {
+      hole_indexes_.clear();
+    }
   } else {
     // Add to the end.
     index = top_index_;
@@ -280,6 +317,9 @@ bool IndirectReferenceTable::Remove(IndirectRef iref) {
         current_num_holes_--;
       }
       top_index_ = collapse_top_index;
+      if (current_num_holes_ == 0u) {
+        hole_indexes_.clear();
+      }
 
       CheckHoleCount(table_, current_num_holes_, top_index_);
     } else {
@@ -301,6 +341,7 @@ bool IndirectReferenceTable::Remove(IndirectRef iref) {
 
     *table_[idx].GetReference() = GcRoot<mirror::Object>(nullptr);
     current_num_holes_++;
+    PushHoleIndex(idx);
     CheckHoleCount(table_, current_num_holes_, top_index_);
     if (kDebugIRT) {
       LOG(INFO) << "+++ left hole at " << idx << ", holes=" << current_num_holes_;
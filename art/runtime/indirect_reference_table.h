@@ -22,6 +22,7 @@
 #include <iosfwd>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include <android-base/logging.h>
 
@@ -99,7 +100,8 @@ const char* GetIndirectRefKindString(IndirectRefKind kind);
 //
 // If we delete entries from the middle of the list, we will be left with "holes".  We track the
 // number of holes so that, when adding new elements, we can quickly decide to do a trivial append
-// or go slot-hunting.
+// or reuse a hole, and we keep the indexes of the holes on a side stack so that reusing one does
+// not need to scan the table.
 //
 // When the top-most entry is removed, any holes immediately below it are also removed. Thus,
 // deletion of an entry may reduce "top_index" by more than one.
@@ -112,8 +114,7 @@ const char* GetIndirectRefKindString(IndirectRefKind kind);
 // detect stale references aren't possible (though we may be able to get similar benefits with other
 // approaches).
 //
-// TODO: consider a "lastDeleteIndex" for quick hole-filling when an add immediately follows a
-// delete.
+// The hole stack is LIFO, so an add that immediately follows a delete reuses the deleted slot.
 
 // We associate a few bits of serial number with each reference, for error checking.
 static constexpr unsigned int kIRTSerialBits = 3;
@@ -309,6 +310,12 @@ class IndirectReferenceTable {
   /* extra debugging checks */
   bool CheckEntry(const char*, IndirectRef, uint32_t) const;
 
+  // Pop the index of a hole from `hole_indexes_`. Requires `current_num_holes_ != 0`.
+  uint32_t PopHoleIndex();
+
+  // Record a new hole at `index`.
+  void PushHoleIndex(uint32_t index);
+
   // Mem map where we store the indirect refs.
   MemMap table_mem_map_;
   // Bottom of the stack. Do not directly access the object references
@@ -325,8 +332,11 @@ class IndirectReferenceTable {
 
   // Some values to retain old behavior with holes.
   // Description of the algorithm is in the .cc file.
-  // TODO: Consider other data structures for compact tables, e.g., free lists.
   size_t current_num_holes_;  // Number of holes in the current / top segment.
+
+  // Indexes of holes, most recent last. May also contain stale indexes of holes that have since
+  // been consumed by lowering the `top_index_`, which are skipped when popped.
+  std::vector<uint32_t> hole_indexes_;
 };
 
 }  // namespace art
@@ -265,4 +265,56 @@ TEST_F(IndirectReferenceTableTest, BasicTest) {
   CheckDump(&irt, 0, 0);
 }
 
+TEST_F(IndirectReferenceTableTest, HoleReuse) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableMax = 20;
+  IndirectReferenceTable irt(kGlobal);
+  std::string error_msg;
+  bool success = irt.Initialize(kTableMax, &error_msg);
+  ASSERT_TRUE(success) << error_msg;
+
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::Class> c =
+      hs.NewHandle(class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;"));
+  ASSERT_TRUE(c != nullptr);
+  Handle<mirror::Object> obj0 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj0 != nullptr);
+
+  IndirectRef refs[5];
+  for (IndirectRef& ref : refs) {
+    ref = irt.Add(obj0.Get(), &error_msg);
+    ASSERT_TRUE(ref != nullptr) << error_msg;
+  }
+
+  // Leave holes at #1 and #3, then remove the top-most entry, which also consumes the hole at #3.
+  ASSERT_TRUE(irt.Remove(refs[1]));
+  ASSERT_TRUE(irt.Remove(refs[3]));
+  ASSERT_TRUE(irt.Remove(refs[4]));
+  ASSERT_EQ(3U, irt.Capacity());
+  CheckDump(&irt, 2, 1);
+
+  // The next entry fills the remaining hole rather than the consumed one.
+  IndirectRef hole_ref = irt.Add(obj0.Get(), &error_msg);
+  ASSERT_TRUE(hole_ref != nullptr) << error_msg;
+  ASSERT_EQ(3U, irt.Capacity()) << "hole not filled";
+  CheckDump(&irt, 3, 1);
+  // The serial number of the reused slot was incremented.
+  EXPECT_NE(hole_ref, refs[1]);
+  EXPECT_FALSE(irt.IsValidReference(refs[1], &error_msg));
+  EXPECT_OBJ_PTR_EQ(obj0.Get(), irt.Get(hole_ref));
+
+  // With no holes left, new entries are appended.
+  IndirectRef top_ref = irt.Add(obj0.Get(), &error_msg);
+  ASSERT_TRUE(top_ref != nullptr) << error_msg;
+  ASSERT_EQ(4U, irt.Capacity());
+  CheckDump(&irt, 4, 1);
+
+  ASSERT_TRUE(irt.Remove(top_ref));
+  ASSERT_TRUE(irt.Remove(refs[2]));
+  ASSERT_TRUE(irt.Remove(hole_ref));
+  ASSERT_TRUE(irt.Remove(refs[0]));
+  ASSERT_EQ(0U, irt.Capacity());
+  CheckDump(&irt, 0, 0);
+}
+
 }  // namespace art
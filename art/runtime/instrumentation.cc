@@ -593,6 +593,64 @@ void InstrumentationInstallStack(Thread* thread, bool deopt_all_frames)
   thread->VerifyStack();
 }
 
+// Updates on stack frames after a single method has been deoptimized. Unlike
+// InstrumentationInstallStack, which flags every JITed frame, this only sets
+// kCheckCallerForDeopt on the JITed frames whose caller is a deoptimized method: the exit hook
+// of a frame only checks whether its direct caller needs a deoptimization, so flagging other
+// frames would only send their returns through the slow exit hook path. Shadow frames of the
+// deoptimized method are updated if dex pc event notification has changed.
+void InstrumentationInstallStackForDeoptimizedMethod(Thread* thread, ArtMethod* method)
+    REQUIRES(Locks::mutator_lock_) {
+  Locks::mutator_lock_->AssertExclusiveHeld(Thread::Current());
+  struct InstallStackVisitor final : public StackVisitor {
+    InstallStackVisitor(Thread* thread_in, Context* context, ArtMethod* method)
+        : StackVisitor(thread_in, context, kInstrumentationStackWalk),
+          method_(method),
+          callee_should_deoptimize_addr_(nullptr) {}
+
+    bool VisitFrame() override REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (IsInInlinedFrame()) {
+        // Exit hooks check the outer method of the caller frame.
+        return true;
+      }
+      uint8_t* callee_should_deoptimize_addr = callee_should_deoptimize_addr_;
+      callee_should_deoptimize_addr_ = nullptr;
+      ArtMethod* m = GetMethod();
+      if (m == nullptr || m->IsRuntimeMethod()) {
+        return true;  // Ignore upcalls and runtime methods.
+      }
+
+      Instrumentation* instrumentation = Runtime::Current()->GetInstrumentation();
+      if (callee_should_deoptimize_addr != nullptr && instrumentation->IsDeoptimized(m)) {
+        *callee_should_deoptimize_addr |=
+            static_cast<uint8_t>(DeoptimizeFlagValue::kCheckCallerForDeopt);
+      }
+
+      if (GetCurrentQuickFrame() == nullptr) {
+        if (m == method_) {
+          GetCurrentShadowFrame()->SetNotifyDexPcMoveEvents(
+              instrumentation->NeedsDexPcEvents(m, GetThread()));
+        }
+        return true;  // Continue.
+      }
+
+      const OatQuickMethodHeader* method_header = GetCurrentOatQuickMethodHeader();
+      if (method_header != nullptr && method_header->HasShouldDeoptimizeFlag()) {
+        callee_should_deoptimize_addr_ = GetShouldDeoptimizeFlagAddr();
+      }
+      return true;  // Continue.
+    }
+
+    ArtMethod* const method_;
+    uint8_t* callee_should_deoptimize_addr_;
+  };
+
+  std::unique_ptr<Context> context(Context::Create());
+  InstallStackVisitor visitor(thread, context.get(), method);
+  visitor.WalkStack(true);
+  thread->VerifyStack();
+}
+
 void UpdateNeedsDexPcEventsOnStack(Thread* thread) REQUIRES(Locks::mutator_lock_) {
   Locks::mutator_lock_->AssertExclusiveHeld(Thread::Current());
 
@@ -678,6 +736,14 @@ void Instrumentation::InstrumentAllThreadStacks(bool force_deopt) {
   }
 }
 
+void Instrumentation::InstrumentAllThreadStacksForDeoptimizedMethod(ArtMethod* method) {
+  run_exit_hooks_ = true;
+  MutexLock mu(Thread::Current(), *Locks::thread_list_lock_);
+  for (Thread* thread : Runtime::Current()->GetThreadList()->GetList()) {
+    InstrumentationInstallStackForDeoptimizedMethod(thread, method);
+  }
+}
+
 static void InstrumentationRestoreStack(Thread* thread) REQUIRES(Locks::mutator_lock_) {
   Locks::mutator_lock_->AssertExclusiveHeld(Thread::Current());
 
@@ -1302,8 +1368,10 @@ void Instrumentation::Deoptimize(ArtMethod* method) {
 
     // Instrument thread stacks to request a check if the caller needs a deoptimization.
     // This isn't a strong deopt. We deopt this method if it is still in the deopt methods list.
-    // If by the time we hit this frame we no longer need a deopt it is safe to continue.
-    InstrumentAllThreadStacks(/* force_deopt= */ false);
+    // If by the time we hit this frame we no longer need a deopt it is safe to continue. Only
+    // the callees of deoptimized methods need the check, so the other frames keep returning
+    // through the fast path.
+    InstrumentAllThreadStacksForDeoptimizedMethod(method);
   }
   CHECK_EQ(method->GetEntryPointFromQuickCompiledCode(), GetQuickToInterpreterBridge());
 }
@@ -575,6 +575,11 @@ class Instrumentation {
   void InstrumentAllThreadStacks(bool force_deopt) REQUIRES(Locks::mutator_lock_)
       REQUIRES(!Locks::thread_list_lock_);
 
+  // Instrument the stacks of all threads after `method` has been deoptimized, so that returns
+  // into frames of deoptimized methods check whether these frames need a deoptimization.
+  void InstrumentAllThreadStacksForDeoptimizedMethod(ArtMethod* method)
+      REQUIRES(Locks::mutator_lock_) REQUIRES(!Locks::thread_list_lock_);
+
   // Force all currently running frames to be deoptimized back to interpreter. This should only be
   // used in cases where basically all compiled code has been invalidated.
   EXPORT void DeoptimizeAllThreadFrames() REQUIRES(art::Locks::mutator_lock_);
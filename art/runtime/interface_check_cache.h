@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_INTERFACE_CHECK_CACHE_H_
+#define ART_RUNTIME_INTERFACE_CHECK_CACHE_H_
+
+#include <array>
+#include <cstdint>
+
+#include "base/bit_utils.h"
+#include "base/casts.h"
+#include "base/macros.h"
+
+namespace art HIDDEN {
+
+// Small thread-local cache of the results of interface checks against classes
+// with many interfaces, for which `Class::Implements()` would otherwise scan the
+// whole `IfTable`. It is used for instance-of and check-cast from the runtime
+// entrypoints, the interpreter and reflection.
+//
+// The entries hold class addresses, so they are only valid for one GC cycle:
+// the cache is cleared when the GC sweeps the interpreter caches, before classes
+// move, and when the number of completed GCs changes, after classes may have been
+// unloaded. All operations must be done from the owning thread, or at a point
+// when the owning thread is suspended.
+class InterfaceCheckCache {
+ public:
+  // Interface checks against classes with fewer interfaces scan the `IfTable`.
+  static constexpr int32_t kMinIfTableCount = 8;
+
+  static constexpr size_t kSize = 64;
+
+  InterfaceCheckCache() {
+    Clear();
+  }
+
+  void Clear() {
+    data_.fill(Entry{});
+  }
+
+  // Look up whether `klass` implements `interface`, for caches filled during the GC
+  // cycle `gc_num`.
+  ALWAYS_INLINE bool Get(uint32_t gc_num,
+                         const void* klass,
+                         const void* interface,
+                         /*out*/ bool* implements) {
+    if (UNLIKELY(gc_num != gc_num_)) {
+      Clear();
+      gc_num_ = gc_num;
+      return false;
+    }
+    const Entry& entry = data_[IndexOf(klass, interface)];
+    if (entry.klass != Compress(klass) ||
+        (entry.interface & ~kImplementsBit) != Compress(interface)) {
+      return false;
+    }
+    *implements = (entry.interface & kImplementsBit) != 0u;
+    return true;
+  }
+
+  ALWAYS_INLINE void Set(uint32_t gc_num,
+                         const void* klass,
+                         const void* interface,
+                         bool implements) {
+    if (UNLIKELY(gc_num != gc_num_)) {
+      Clear();
+      gc_num_ = gc_num;
+    }
+    Entry& entry = data_[IndexOf(klass, interface)];
+    entry.klass = Compress(klass);
+    entry.interface = Compress(interface) | (implements ? kImplementsBit : 0u);
+  }
+
+ private:
+  // Objects are at least 8-byte aligned, so the low bit of the interface address
+  // is free to store the result. A cleared entry never matches a non-null class.
+  static constexpr uint32_t kImplementsBit = 1u;
+
+  struct Entry {
+    uint32_t klass = 0u;
+    uint32_t interface = 0u;
+  };
+
+  // Heap references are 32-bit.
+  static ALWAYS_INLINE uint32_t Compress(const void* ptr) {
+    return dchecked_integral_cast<uint32_t>(reinterpret_cast<uintptr_t>(ptr));
+  }
+
+  static ALWAYS_INLINE size_t IndexOf(const void* klass, const void* interface) {
+    static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
+    uint32_t hash = (Compress(klass) >> 3) ^ (Compress(interface) >> 5);
+    return (hash ^ (hash >> 11)) & (kSize - 1);
+  }
+
+  std::array<Entry, kSize> data_;
+  uint32_t gc_num_ = 0u;
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_INTERFACE_CHECK_CACHE_H_
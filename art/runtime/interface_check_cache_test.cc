@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interface_check_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace art HIDDEN {
+
+static const void* FakeClass(uintptr_t index) {
+  // Classes are 8-byte aligned, and the cache only uses the address.
+  return reinterpret_cast<const void*>(0x10000u + index * 8u);
+}
+
+TEST(InterfaceCheckCacheTest, GetAndSet) {
+  InterfaceCheckCache cache;
+  bool implements = false;
+  EXPECT_FALSE(cache.Get(/*gc_num=*/ 0u, FakeClass(1), FakeClass(2), &implements));
+
+  cache.Set(/*gc_num=*/ 0u, FakeClass(1), FakeClass(2), /*implements=*/ true);
+  cache.Set(/*gc_num=*/ 0u, FakeClass(3), FakeClass(4), /*implements=*/ false);
+  ASSERT_TRUE(cache.Get(/*gc_num=*/ 0u, FakeClass(1), FakeClass(2), &implements));
+  EXPECT_TRUE(implements);
+  ASSERT_TRUE(cache.Get(/*gc_num=*/ 0u, FakeClass(3), FakeClass(4), &implements));
+  EXPECT_FALSE(implements);
+
+  // The key is the (class, interface) pair.
+  EXPECT_FALSE(cache.Get(/*gc_num=*/ 0u, FakeClass(2), FakeClass(1), &implements));
+  EXPECT_FALSE(cache.Get(/*gc_num=*/ 0u, FakeClass(1), FakeClass(4), &implements));
+}
+
+TEST(InterfaceCheckCacheTest, Invalidation) {
+  InterfaceCheckCache cache;
+  bool implements = false;
+  cache.Set(/*gc_num=*/ 0u, FakeClass(1), FakeClass(2), /*implements=*/ true);
+  cache.Clear();
+  EXPECT_FALSE(cache.Get(/*gc_num=*/ 0u, FakeClass(1), FakeClass(2), &implements));
+
+  // Entries from a previous GC cycle are dropped.
+  cache.Set(/*gc_num=*/ 0u, FakeClass(1), FakeClass(2), /*implements=*/ true);
+  EXPECT_FALSE(cache.Get(/*gc_num=*/ 1u, FakeClass(1), FakeClass(2), &implements));
+  EXPECT_FALSE(cache.Get(/*gc_num=*/ 0u, FakeClass(1), FakeClass(2), &implements));
+}
+
+}  // namespace art
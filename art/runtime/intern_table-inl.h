@@ -19,6 +19,9 @@
 
 #include "intern_table.h"
 
+#include <iterator>
+
+#include "base/iteration_range.h"
 #include "dex/utf.h"
 #include "gc/space/image_space.h"
 #include "gc_root-inl.h"
@@ -114,6 +117,7 @@ inline size_t InternTable::AddTableFromMemory(const uint8_t* ptr,
     visitor(set);
     if (!set.empty()) {
       strong_interns_.AddInternStrings(std::move(set), is_boot_image);
+      strong_interns_.PublishFrozenTables();
     }
   }
   return read_count;
@@ -138,14 +142,42 @@ inline void InternTable::Table::AddInternStrings(UnorderedSet&& intern_strings,
   // Keep the order of previous frozen tables unchanged, so that we can can remember
   // the number of searched frozen tables and not search them again.
   DCHECK(!tables_.empty());
-  tables_.insert(tables_.end() - 1, InternalTable(std::move(intern_strings), is_boot_image));
+  tables_.insert(std::prev(tables_.end()), InternalTable(std::move(intern_strings), is_boot_image));
+}
+
+template <typename Key>
+inline ObjPtr<mirror::String> InternTable::Table::FindInFrozenTables(
+    const FrozenTables* frozen_tables, const Key& key, uint32_t hash) {
+  // Search from the last table, as `Find()` does.
+  for (const InternalTable* table : ReverseRange(*frozen_tables)) {
+    auto it = table->set_.FindWithHash(key, hash);
+    if (it != table->set_.end()) {
+      return it->Read();
+    }
+  }
+  return nullptr;
+}
+
+// Search the frozen strong interns without holding the lock. Return the string if found,
+// otherwise return null and set `num_searched_frozen_tables` to the number of tables searched.
+// That number stays valid as frozen tables are only ever added after the searched ones.
+template <typename Key>
+inline ObjPtr<mirror::String> InternTable::LookupStrongInFrozenTables(
+    const Key& key, uint32_t hash, /*out*/ size_t* num_searched_frozen_tables) {
+  const Table::FrozenTables* frozen_tables = strong_interns_.GetFrozenTables();
+  if (frozen_tables == nullptr) {
+    *num_searched_frozen_tables = 0u;
+    return nullptr;
+  }
+  *num_searched_frozen_tables = frozen_tables->size();
+  return strong_interns_.FindInFrozenTables(frozen_tables, key, hash);
 }
 
 template <typename Visitor>
 inline void InternTable::VisitInterns(const Visitor& visitor,
                                       bool visit_boot_images,
                                       bool visit_non_boot_images) {
-  auto visit_tables = [&](dchecked_vector<Table::InternalTable>& tables)
+  auto visit_tables = [&](std::list<Table::InternalTable>& tables)
       NO_THREAD_SAFETY_ANALYSIS {
     for (Table::InternalTable& table : tables) {
       // Determine if we want to visit the table based on the flags.
@@ -163,7 +195,7 @@ inline void InternTable::VisitInterns(const Visitor& visitor,
 
 inline size_t InternTable::CountInterns(bool visit_boot_images, bool visit_non_boot_images) const {
   size_t ret = 0u;
-  auto visit_tables = [&](const dchecked_vector<Table::InternalTable>& tables)
+  auto visit_tables = [&](const std::list<Table::InternalTable>& tables)
       NO_THREAD_SAFETY_ANALYSIS {
     for (const Table::InternalTable& table : tables) {
       // Determine if we want to visit the table based on the flags.
@@ -16,6 +16,7 @@
 
 #include "intern_table-inl.h"
 
+#include <iterator>
 #include <memory>
 
 #include "class_linker.h"
@@ -115,16 +116,29 @@ ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self, ObjPtr<mirror::St
   DCHECK(s != nullptr);
   // `String::GetHashCode()` ensures that the stored hash is calculated.
   uint32_t hash = static_cast<uint32_t>(s->GetHashCode());
+  size_t num_searched_frozen_tables;
+  ObjPtr<mirror::String> result =
+      LookupStrongInFrozenTables(GcRoot<mirror::String>(s), hash, &num_searched_frozen_tables);
+  if (result != nullptr) {
+    return result;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(s, hash);
+  return strong_interns_.Find(s, hash, num_searched_frozen_tables);
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
                                                  uint32_t utf16_length,
                                                  const char* utf8_data) {
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
+  Utf8String string(utf16_length, utf8_data);
+  size_t num_searched_frozen_tables;
+  ObjPtr<mirror::String> result =
+      LookupStrongInFrozenTables(string, hash, &num_searched_frozen_tables);
+  if (result != nullptr) {
+    return result;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(Utf8String(utf16_length, utf8_data), hash);
+  return strong_interns_.Find(string, hash, num_searched_frozen_tables);
 }
 
 ObjPtr<mirror::String> InternTable::LookupWeakLocked(ObjPtr<mirror::String> s) {
@@ -145,6 +159,7 @@ void InternTable::AddNewTable() {
   MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
   weak_interns_.AddNewTable();
   strong_interns_.AddNewTable();
+  strong_interns_.PublishFrozenTables();
 }
 
 ObjPtr<mirror::String> InternTable::InsertStrong(ObjPtr<mirror::String> s, uint32_t hash) {
@@ -254,14 +269,21 @@ ObjPtr<mirror::String> InternTable::InternStrong(uint32_t utf16_length, const ch
   DCHECK(utf8_data != nullptr);
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
   Thread* self = Thread::Current();
-  ObjPtr<mirror::String> s;
+  Utf8String string(utf16_length, utf8_data);
   size_t num_searched_strong_frozen_tables;
+  // Most strings resolved by `const-string` are in the boot image, look them up without the lock.
+  ObjPtr<mirror::String> s =
+      LookupStrongInFrozenTables(string, hash, &num_searched_strong_frozen_tables);
+  if (s != nullptr) {
+    return s;
+  }
   {
     // Try to avoid allocation. If we need to allocate, release the mutex before the allocation.
     MutexLock mu(self, *Locks::intern_table_lock_);
     DCHECK(!strong_interns_.tables_.empty());
+    size_t num_searched = num_searched_strong_frozen_tables;
     num_searched_strong_frozen_tables = strong_interns_.tables_.size() - 1u;
-    s = strong_interns_.Find(Utf8String(utf16_length, utf8_data), hash);
+    s = strong_interns_.Find(string, hash, num_searched);
   }
   if (s != nullptr) {
     return s;
@@ -293,7 +315,13 @@ ObjPtr<mirror::String> InternTable::InternStrong(ObjPtr<mirror::String> s) {
   DCHECK(s != nullptr);
   // `String::GetHashCode()` ensures that the stored hash is calculated.
   uint32_t hash = static_cast<uint32_t>(s->GetHashCode());
-  return Insert(s, hash, /*is_strong=*/ true);
+  size_t num_searched_strong_frozen_tables;
+  ObjPtr<mirror::String> strong = LookupStrongInFrozenTables(
+      GcRoot<mirror::String>(s), hash, &num_searched_strong_frozen_tables);
+  if (strong != nullptr) {
+    return strong;
+  }
+  return Insert(s, hash, /*is_strong=*/ true, num_searched_strong_frozen_tables);
 }
 
 ObjPtr<mirror::String> InternTable::InternWeak(const char* utf8_data) {
@@ -337,7 +365,8 @@ ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s,
                                                 uint32_t hash,
                                                 size_t num_searched_frozen_tables) {
   Locks::intern_table_lock_->AssertHeld(Thread::Current());
-  auto mid = tables_.begin() + num_searched_frozen_tables;
+  DCHECK_LT(num_searched_frozen_tables, tables_.size());
+  auto mid = std::next(tables_.begin(), num_searched_frozen_tables);
   for (Table::InternalTable& table : MakeIterationRange(tables_.begin(), mid)) {
     DCHECK(table.set_.FindWithHash(GcRoot<mirror::String>(s), hash) == table.set_.end());
   }
@@ -353,11 +382,18 @@ ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s,
 }
 
 FLATTEN
-ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string, uint32_t hash) {
+ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string,
+                                                uint32_t hash,
+                                                size_t num_searched_frozen_tables) {
   Locks::intern_table_lock_->AssertHeld(Thread::Current());
+  DCHECK_LT(num_searched_frozen_tables, tables_.size());
+  auto mid = std::next(tables_.begin(), num_searched_frozen_tables);
+  for (InternalTable& table : MakeIterationRange(tables_.begin(), mid)) {
+    DCHECK(table.set_.FindWithHash(string, hash) == table.set_.end());
+  }
   // Search from the last table, assuming that apps shall search for their own
   // strings more often than for boot image strings.
-  for (InternalTable& table : ReverseRange(tables_)) {
+  for (InternalTable& table : ReverseRange(MakeIterationRange(mid, tables_.end()))) {
     auto it = table.set_.FindWithHash(string, hash);
     if (it != table.set_.end()) {
       return it->Read();
@@ -375,6 +411,18 @@ void InternTable::Table::AddNewTable() {
   tables_.push_back(std::move(new_table));
 }
 
+void InternTable::Table::PublishFrozenTables() {
+  DCHECK(!tables_.empty());
+  std::unique_ptr<FrozenTables> frozen_tables(new FrozenTables());
+  frozen_tables->reserve(tables_.size() - 1u);
+  for (auto it = tables_.begin(), end = std::prev(tables_.end()); it != end; ++it) {
+    frozen_tables->push_back(&*it);
+  }
+  // Release the contents of the frozen tables to lock-free readers.
+  frozen_tables_.store(frozen_tables.get(), std::memory_order_release);
+  published_frozen_tables_.push_back(std::move(frozen_tables));
+}
+
 void InternTable::Table::Insert(ObjPtr<mirror::String> s, uint32_t hash) {
   // Always insert the last table, the image tables are before and we avoid inserting into these
   // to prevent dirty pages.
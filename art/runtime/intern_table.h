@@ -17,6 +17,11 @@
 #ifndef ART_RUNTIME_INTERN_TABLE_H_
 #define ART_RUNTIME_INTERN_TABLE_H_
 
+#include <atomic>
+#include <list>
+#include <memory>
+#include <vector>
+
 #include "base/dchecked_vector.h"
 #include "base/gc_visited_arena_pool.h"
 #include "base/hash_set.h"
@@ -236,12 +241,30 @@ class InternTable {
       ART_FRIEND_TEST(InternTableTest, CrossHash);
     };
 
+    // The frozen tables, in the order of `tables_`. They are never modified once frozen, so
+    // a published snapshot can be searched without holding `Locks::intern_table_lock_`.
+    using FrozenTables = std::vector<const InternalTable*>;
+
     Table();
+    // Return the last published snapshot of the frozen tables, or null if there is none.
+    const FrozenTables* GetFrozenTables() const {
+      return frozen_tables_.load(std::memory_order_acquire);
+    }
+    // Search the frozen tables of a snapshot, without holding `Locks::intern_table_lock_`.
+    template <typename Key>
+    ObjPtr<mirror::String> FindInFrozenTables(const FrozenTables* frozen_tables,
+                                              const Key& key,
+                                              uint32_t hash)
+        REQUIRES_SHARED(Locks::mutator_lock_);
+    // Publish a snapshot of the current frozen tables for lock-free lookups.
+    void PublishFrozenTables() REQUIRES(Locks::intern_table_lock_);
     ObjPtr<mirror::String> Find(ObjPtr<mirror::String> s,
                                 uint32_t hash,
                                 size_t num_searched_frozen_tables = 0u)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-    ObjPtr<mirror::String> Find(const Utf8String& string, uint32_t hash)
+    ObjPtr<mirror::String> Find(const Utf8String& string,
+                                uint32_t hash,
+                                size_t num_searched_frozen_tables = 0u)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
     void Insert(ObjPtr<mirror::String> s, uint32_t hash)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
@@ -272,13 +295,26 @@ class InternTable {
 
     // We call AddNewTable when we create the zygote to reduce private dirty pages caused by
     // modifying the zygote intern table. The back of table is modified when strings are interned.
-    dchecked_vector<InternalTable> tables_;
+    // A list keeps the addresses of the frozen tables stable for lock-free lookups.
+    std::list<InternalTable> tables_;
+    // Snapshot of the frozen tables, only published for the strong interns. Frozen weak tables
+    // are still modified by the promotion of weak interns and by sweeping.
+    std::atomic<const FrozenTables*> frozen_tables_ = nullptr;
+    // All the published snapshots, kept until the table is deleted since lock-free readers may
+    // still be using an old one. There are few of them, one per image and one per zygote fork.
+    std::vector<std::unique_ptr<const FrozenTables>> published_frozen_tables_;
 
     friend class InternTable;
     friend class linker::ImageWriter;
     ART_FRIEND_TEST(InternTableTest, CrossHash);
   };
 
+  template <typename Key>
+  ObjPtr<mirror::String> LookupStrongInFrozenTables(const Key& key,
+                                                    uint32_t hash,
+                                                    /*out*/ size_t* num_searched_frozen_tables)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Insert if non null, otherwise return null. Must be called holding the mutator lock.
   ObjPtr<mirror::String> Insert(ObjPtr<mirror::String> s,
                                 uint32_t hash,
@@ -263,4 +263,34 @@ TEST_F(InternTableTest, InternStrongFrozenWeak) {
   ASSERT_TRUE(strong_foo == foo.Get());
 }
 
+TEST_F(InternTableTest, LookupStrongFrozen) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable intern_table;
+  StackHandleScope<3> hs(soa.Self());
+  Handle<mirror::String> foo(hs.NewHandle(intern_table.InternStrong(3, "foo")));
+  ASSERT_TRUE(foo != nullptr);
+
+  // Strings in frozen tables are found without the lock.
+  intern_table.AddNewTable();
+  Handle<mirror::String> bar(hs.NewHandle(intern_table.InternStrong(3, "bar")));
+  ASSERT_TRUE(bar != nullptr);
+  EXPECT_OBJ_PTR_EQ(intern_table.LookupStrong(soa.Self(), 3, "foo"), foo.Get());
+  EXPECT_OBJ_PTR_EQ(intern_table.LookupStrong(soa.Self(), 3, "bar"), bar.Get());
+  EXPECT_OBJ_PTR_EQ(intern_table.InternStrong(3, "foo"), foo.Get());
+  Handle<mirror::String> foo_copy(
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "foo")));
+  ASSERT_TRUE(foo_copy != nullptr);
+  EXPECT_OBJ_PTR_EQ(intern_table.LookupStrong(soa.Self(), foo_copy.Get()), foo.Get());
+  EXPECT_OBJ_PTR_EQ(intern_table.InternStrong(foo_copy.Get()), foo.Get());
+
+  // Freezing again keeps both strings reachable and new strings go to the new table.
+  intern_table.AddNewTable();
+  EXPECT_OBJ_PTR_EQ(intern_table.InternStrong(3, "bar"), bar.Get());
+  EXPECT_TRUE(intern_table.LookupStrong(soa.Self(), 3, "baz") == nullptr);
+  ObjPtr<mirror::String> baz = intern_table.InternStrong(3, "baz");
+  ASSERT_TRUE(baz != nullptr);
+  EXPECT_OBJ_PTR_EQ(intern_table.LookupStrong(soa.Self(), 3, "baz"), baz);
+  EXPECT_EQ(intern_table.StrongSize(), 3u);
+}
+
 }  // namespace art
@@ -28,6 +28,9 @@ inline bool InterpreterCache::Get(Thread* self, const void* key, /* out */ size_
   Entry& entry = data_[IndexOf(key)];
   if (LIKELY(entry.first == key)) {
     *value = entry.second;
+    if (kIsDebugBuild) {
+      ++hit_count_;
+    }
     return true;
   }
   return false;
@@ -38,6 +41,9 @@ inline void InterpreterCache::Set(Thread* self, const void* key, size_t value) {
   // Simple store works here as the cache is always read/written by the owning
   // thread only (or in a stop-the-world pause).
   data_[IndexOf(key)] = Entry{key, value};
+  if (kIsDebugBuild) {
+    ++fill_count_;
+  }
 }
 
 }  // namespace art
@@ -21,6 +21,7 @@
 #include <atomic>
 
 #include "base/bit_utils.h"
+#include "base/globals.h"
 #include "base/macros.h"
 
 namespace art HIDDEN {
@@ -38,6 +39,9 @@ class Thread;
 //   iget/iput: The field offset. The field must be non-volatile.
 //   sget/sput: The ArtField* pointer. The field must be non-volitile.
 //   invoke: The ArtMethod* pointer (before vtable indirection, etc).
+// The keys above are dex instruction pointers. The cache also holds entries keyed by
+// an IMT conflict method with its low bit set, which can never be a dex pc:
+//   The address of the last ImtConflictTable entry used with that conflict method.
 //
 // We ensure consistency of the cache by clearing it
 // whenever any dex file is unloaded.
@@ -70,6 +74,17 @@ class ALIGNED(16) InterpreterCache {
     return data_;
   }
 
+  // Hit and fill counts, maintained only in debug builds. Hits are counted for lookups
+  // from the runtime only, nterp looks up the cache directly from assembly. Fills are
+  // counted for all interpreters as they follow a miss. The counts are not reset by `Clear()`.
+  uint32_t GetHitCount() const {
+    return hit_count_;
+  }
+
+  uint32_t GetFillCount() const {
+    return fill_count_;
+  }
+
  private:
   static ALWAYS_INLINE size_t IndexOf(const void* key) {
     static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
@@ -78,7 +93,11 @@ class ALIGNED(16) InterpreterCache {
     return index;
   }
 
+  // Must be the first member, assembly code uses the cache address to access it.
   std::array<Entry, kSize> data_;
+
+  uint32_t hit_count_ = 0u;
+  uint32_t fill_count_ = 0u;
 };
 
 }  // namespace art
@@ -25,6 +25,7 @@
 #include "dex/dex_instruction_utils.h"
 #include "debugger.h"
 #include "entrypoints/entrypoint_utils-inl.h"
+#include "imt_conflict_table.h"
 #include "interpreter/interpreter_cache-inl.h"
 #include "interpreter/interpreter_common.h"
 #include "interpreter/shadow_frame-inl.h"
@@ -385,6 +386,41 @@ extern "C" size_t NterpGetMethod(Thread* self, ArtMethod* caller, const uint16_t
   }
 }
 
+// Called by nterp for an invoke-interface whose IMT slot holds a runtime method and
+// which missed the conflict cache. Returns the implementation of `interface_method` if
+// `conflict_method` has it in its conflict table, and caches the table entry in the
+// interpreter cache, keyed by `conflict_method` tagged with its low bit so it cannot
+// be mistaken for a dex pc. Otherwise returns `conflict_method` for nterp to call the
+// conflict trampoline, which resolves the call and updates the table.
+//
+// The cached entry stays correct when the table of `conflict_method` is replaced by
+// a larger one: new tables are copies of the old ones with more entries, and old
+// tables are not freed.
+LIBART_PROTECTED
+extern "C" ArtMethod* NterpLookupImtConflict(Thread* self,
+                                             ArtMethod* conflict_method,
+                                             ArtMethod* interface_method)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  DCHECK(conflict_method->IsRuntimeMethod());
+  if (conflict_method->IsImtUnimplementedMethod()) {
+    return conflict_method;
+  }
+  ImtConflictTable* table = conflict_method->GetImtConflictTable(kRuntimePointerSize);
+  for (size_t i = 0; ; ++i) {
+    ArtMethod* current_interface_method = table->GetInterfaceMethod(i, kRuntimePointerSize);
+    if (current_interface_method == nullptr) {
+      return conflict_method;
+    }
+    if (current_interface_method == interface_method) {
+      uintptr_t key = reinterpret_cast<uintptr_t>(conflict_method) | 1u;
+      void** entry = table->AddressOfInterfaceMethod(i, kRuntimePointerSize);
+      self->GetInterpreterCache()->Set(
+          self, reinterpret_cast<const void*>(key), reinterpret_cast<size_t>(entry));
+      return table->GetImplementationMethod(i, kRuntimePointerSize);
+    }
+  }
+}
+
 LIBART_PROTECTED
 extern "C" size_t NterpGetStaticField(Thread* self,
                                       ArtMethod* caller,
@@ -754,6 +754,51 @@ void UnstartedRuntime::UnstartedConstructorNewInstance0(
   }
 }
 
+void UnstartedRuntime::UnstartedEnumGetSharedConstants(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // `Enum.getSharedConstants()` backs `Enum.valueOf()`, `EnumMap` and `EnumSet`, and caches the
+  // constants in a static cache of the boot image which app image class initialization must not
+  // write to. The callers do not modify the returned array, so return the constants from a
+  // direct call to `values()` instead.
+  ObjPtr<mirror::Object> param = shadow_frame->GetVRegReference(arg_offset);
+  if (param == nullptr) {
+    AbortTransactionOrFail(self, "Null-pointer in Enum.getSharedConstants.");
+    return;
+  }
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Class> h_klass(hs.NewHandle(param->AsClass()));
+  if (!h_klass->IsEnum()) {
+    // Not an enum class, the caller gets null like from the cache.
+    return;
+  }
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  std::string temp;
+  std::string signature = StringPrintf("()[%s", h_klass->GetDescriptor(&temp));
+  ArtMethod* values =
+      h_klass->FindClassMethod("values", signature, class_linker->GetImagePointerSize());
+  if (values == nullptr || !values->IsStatic() || values->GetDeclaringClass() != h_klass.Get()) {
+    AbortTransactionOrFail(self,
+                           "Could not find values() of '%s'",
+                           h_klass->PrettyClass().c_str());
+    return;
+  }
+  if (!class_linker->EnsureInitialized(self, h_klass, true, true)) {
+    DCHECK(self->IsExceptionPending());
+    return;
+  }
+  JValue values_result;
+  EnterInterpreterFromInvoke(self, values, /*receiver=*/ nullptr, /*args=*/ nullptr,
+                             &values_result);
+  if (self->IsExceptionPending()) {
+    AbortTransactionOrFail(self,
+                           "Failed in values() of '%s' with %s",
+                           h_klass->PrettyClass().c_str(),
+                           mirror::Object::PrettyTypeOf(self->GetException()).c_str());
+    return;
+  }
+  result->SetL(values_result.GetL());
+}
+
 void UnstartedRuntime::UnstartedJNIExecutableGetParameterTypesInternal(
     Thread* self, ArtMethod*, mirror::Object* receiver, uint32_t*, JValue* result) {
   StackHandleScope<3> hs(self);
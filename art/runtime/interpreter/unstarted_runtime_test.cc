@@ -820,6 +820,38 @@ TEST_F(UnstartedRuntimeTest, GetDeclaringClass) {
   EXPECT_EQ(result.GetL(), nullptr);
 }
 
+TEST_F(UnstartedRuntimeTest, EnumGetSharedConstants) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+
+  JValue result;
+  UniqueDeoptShadowFramePtr shadow_frame = CreateShadowFrame(10, nullptr, 0);
+
+  // A class that is not an enum has no constants.
+  shadow_frame->SetVRegReference(0, GetClassRoot<mirror::Object>());
+  UnstartedEnumGetSharedConstants(self, shadow_frame.get(), &result, 0);
+  EXPECT_EQ(result.GetL(), nullptr);
+  ASSERT_FALSE(self->IsExceptionPending());
+
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Class> state_class = hs.NewHandle(
+      FindClass("Ljava/lang/Thread$State;", ScopedNullHandle<mirror::ClassLoader>()));
+  ASSERT_TRUE(state_class != nullptr);
+  shadow_frame->SetVRegReference(0, state_class.Get());
+  UnstartedEnumGetSharedConstants(self, shadow_frame.get(), &result, 0);
+  ASSERT_FALSE(self->IsExceptionPending());
+  ASSERT_TRUE(result.GetL() != nullptr);
+  ASSERT_TRUE(result.GetL()->IsObjectArray());
+  ObjPtr<mirror::ObjectArray<mirror::Object>> constants =
+      result.GetL()->AsObjectArray<mirror::Object>();
+  // NEW, RUNNABLE, BLOCKED, WAITING, TIMED_WAITING and TERMINATED.
+  EXPECT_EQ(6, constants->GetLength());
+  EXPECT_OBJ_PTR_EQ(state_class.Get(), constants->GetClass()->GetComponentType());
+  for (int32_t i = 0; i != constants->GetLength(); ++i) {
+    EXPECT_OBJ_PTR_EQ(state_class.Get(), constants->Get(i)->GetClass());
+  }
+}
+
 TEST_F(UnstartedRuntimeTest, ThreadLocalGet) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
@@ -19,19 +19,28 @@
 #include <dlfcn.h>
 #include <sys/resource.h>
 
+#include <algorithm>
+#include <limits>
+
 #include "app_info.h"
 #include "art_method-inl.h"
+#include "base/bit_utils.h"
+#include "base/casts.h"
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/memfd.h"
 #include "base/memory_tool.h"
+#include "base/os.h"
 #include "base/pointer_size.h"
 #include "base/runtime_debug.h"
 #include "base/scoped_flock.h"
+#include "base/stl_util.h"
 #include "base/utils.h"
+#include "class_linker.h"
 #include "class_root-inl.h"
 #include "compilation_kind.h"
 #include "debugger.h"
+#include "dex/dex_file_loader.h"
 #include "dex/type_lookup_table.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
@@ -41,7 +50,9 @@
 #include "jit-inl.h"
 #include "jit_code_cache.h"
 #include "jit_create.h"
+#include "jit_persistent_cache.h"
 #include "jni/java_vm_ext.h"
+#include "mirror/dex_cache-inl.h"
 #include "mirror/method_handle_impl.h"
 #include "mirror/var_handle.h"
 #include "oat/image-inl.h"
@@ -52,6 +63,7 @@
 #include "profile/profile_boot_info.h"
 #include "profile/profile_compilation_info.h"
 #include "profile_saver.h"
+#include "profiling_info.h"
 #include "runtime.h"
 #include "runtime_options.h"
 #include "small_pattern_matcher.h"
@@ -66,14 +78,120 @@ namespace jit {
 
 static constexpr bool kEnableOnStackReplacement = true;
 
+// How many times the tier up of a method to optimized code is deferred while the receiver
+// types recorded by its inline caches keep changing.
+static constexpr uint32_t kMaxTierUpDeferrals = 2u;
+// Bound on the methods whose tier up is deferred. Past it, methods tier up immediately.
+static constexpr size_t kMaxPendingTierUps = 4096u;
+// Priority penalty of methods whose inline caches are still changing when they tier up.
+static constexpr size_t kChurningTierUpPriorityShift = 4u;
+
 // JIT compiler
 JitCompilerInterface* Jit::jit_compiler_ = nullptr;
 
+class JitPersistentCacheTask final : public Task {
+ public:
+  JitPersistentCacheTask(JitPersistentCache* persistent_cache, bool save)
+      : persistent_cache_(persistent_cache), save_(save) {}
+
+  void Run(Thread* self) override {
+    if (save_) {
+      std::string error_msg;
+      if (!persistent_cache_->Save(&error_msg)) {
+        LOG(WARNING) << "Failed to save JIT persistent cache: " << error_msg;
+      }
+    } else {
+      persistent_cache_->LoadAndInstall(self, Runtime::Current()->GetJit()->GetCodeCache());
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  JitPersistentCache* const persistent_cache_;
+  const bool save_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitPersistentCacheTask);
+};
+
+class JitStartupProfileTask final : public Task {
+ public:
+  enum class Kind {
+    kPrefetchClasses,
+    kCompileMethods,
+  };
+
+  JitStartupProfileTask(Kind kind,
+                        const std::vector<std::string>& profile_paths,
+                        const std::vector<std::string>& code_paths)
+      : kind_(kind), profile_paths_(profile_paths), code_paths_(code_paths) {}
+
+  void Run(Thread* self) override {
+    // Use the first profile present, the reference profile being the one installed with the
+    // app, for example a cloud profile.
+    for (const std::string& profile_path : profile_paths_) {
+      if (!profile_path.empty() && OS::FileExists(profile_path.c_str())) {
+        Jit* jit = Runtime::Current()->GetJit();
+        if (kind_ == Kind::kPrefetchClasses) {
+          jit->PrefetchStartupClassesFromProfile(self, profile_path, code_paths_);
+        } else {
+          jit->CompileStartupMethodsFromProfile(self, profile_path, code_paths_);
+        }
+        return;
+      }
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  const Kind kind_;
+  const std::vector<std::string> profile_paths_;
+  const std::vector<std::string> code_paths_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitStartupProfileTask);
+};
+
 void Jit::DumpInfo(std::ostream& os) {
   code_cache_->Dump(os);
+  JitPersistentCache* persistent_cache = GetPersistentCache();
+  if (persistent_cache != nullptr) {
+    persistent_cache->DumpInfo(os);
+  }
   cumulative_timings_.Dump(os);
+  if (thread_pool_ != nullptr) {
+    thread_pool_->DumpInfo(os);
+  }
+  {
+    MutexLock mu(Thread::Current(), compilation_memory_lock_);
+    os << "Compilations throttled by the memory budget: " << num_throttled_compilations_ << "\n";
+  }
+  {
+    MutexLock mu(Thread::Current(), osr_entries_lock_);
+    os << "OSR entries: " << num_osr_entry_hits_ << " cached, "
+       << num_osr_entry_misses_ << " decoded\n";
+  }
   MutexLock mu(Thread::Current(), lock_);
   memory_use_.PrintMemoryUse(os);
+  os << "Tier up: " << num_tier_up_stable_ << " stable, "
+     << num_tier_up_churning_ << " churning, "
+     << num_tier_up_deferrals_ << " deferrals, "
+     << tier_up_states_.size() << " pending\n";
+  if (!slowest_compilations_.empty()) {
+    os << "Slowest compilations:\n";
+    for (const CompilationTelemetry& telemetry : slowest_compilations_) {
+      os << "  " << telemetry.method_name
+         << " kind=" << telemetry.compilation_kind
+         << " time=" << PrettyDuration(telemetry.duration_ns)
+         << " arena=" << PrettySize(telemetry.arena_bytes)
+         << " inlined=" << telemetry.inlined_methods
+         << " code=" << PrettySize(telemetry.code_size) << "\n";
+    }
+  }
 }
 
 void Jit::DumpForSigQuit(std::ostream& os) {
@@ -92,7 +210,16 @@ Jit::Jit(JitCodeCache* code_cache, JitOptions* options)
       cumulative_timings_("JIT timings"),
       memory_use_("Memory used for compilation", 16),
       lock_("JIT memory use lock"),
+      compilation_memory_lock_("JIT compilation memory budget lock"),
+      compilation_memory_cond_("JIT compilation memory budget condition",
+                               compilation_memory_lock_),
+      compilation_memory_in_use_(0u),
+      num_throttled_compilations_(0u),
+      osr_entries_lock_("JIT OSR entries lock"),
+      num_osr_entry_hits_(0u),
+      num_osr_entry_misses_(0u),
       zygote_mapping_methods_(),
+      persistent_cache_(nullptr),
       fd_methods_(-1),
       fd_methods_size_(0) {}
 
@@ -153,6 +280,47 @@ bool Jit::TryPatternMatch(ArtMethod* method_to_compile, CompilationKind compilat
   return false;
 }
 
+// Return a rough estimate of the arena memory needed to compile `method`: a fixed cost, and a
+// cost per code unit, higher for optimized compilations as they inline.
+static size_t EstimateCompilationMemory(ArtMethod* method, CompilationKind compilation_kind)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  static constexpr size_t kBaseCompilationMemory = 64 * KB;
+  if (method->IsNative()) {
+    return kBaseCompilationMemory;
+  }
+  size_t bytes_per_code_unit = (compilation_kind == CompilationKind::kBaseline) ? 256u : 1 * KB;
+  return kBaseCompilationMemory +
+      method->DexInstructions().InsnsSizeInCodeUnits() * bytes_per_code_unit;
+}
+
+void Jit::AcquireCompilationMemory(Thread* self, size_t bytes) {
+  auto fits = [&]() REQUIRES(compilation_memory_lock_) {
+    return compilation_memory_in_use_ == 0u ||
+        compilation_memory_in_use_ + bytes <= kCompilationMemoryBudget;
+  };
+  {
+    MutexLock mu(self, compilation_memory_lock_);
+    if (fits()) {
+      compilation_memory_in_use_ += bytes;
+      return;
+    }
+  }
+  ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+  MutexLock mu(self, compilation_memory_lock_);
+  ++num_throttled_compilations_;
+  while (!fits()) {
+    compilation_memory_cond_.Wait(self);
+  }
+  compilation_memory_in_use_ += bytes;
+}
+
+void Jit::ReleaseCompilationMemory(Thread* self, size_t bytes) {
+  MutexLock mu(self, compilation_memory_lock_);
+  DCHECK_GE(compilation_memory_in_use_, bytes);
+  compilation_memory_in_use_ -= bytes;
+  compilation_memory_cond_.Broadcast(self);
+}
+
 bool Jit::CompileMethodInternal(ArtMethod* method,
                                 Thread* self,
                                 CompilationKind compilation_kind,
@@ -227,7 +395,10 @@ bool Jit::CompileMethodInternal(ArtMethod* method,
   VLOG(jit) << "Compiling method "
             << ArtMethod::PrettyMethod(method_to_compile)
             << " kind=" << compilation_kind;
+  size_t compilation_memory = EstimateCompilationMemory(method_to_compile, compilation_kind);
+  AcquireCompilationMemory(self, compilation_memory);
   bool success = jit_compiler_->CompileMethod(self, region, method_to_compile, compilation_kind);
+  ReleaseCompilationMemory(self, compilation_memory);
   code_cache_->DoneCompiling(method_to_compile, self);
   if (!success) {
     VLOG(jit) << "Failed to compile method "
@@ -287,6 +458,45 @@ void Jit::StartProfileSaver(const std::string& profile_filename,
                         ref_profile_filename,
                         code_type);
   }
+  if (options_->UsePersistentCache() &&
+      UseJitCompilation() &&
+      thread_pool_ != nullptr &&
+      !profile_filename.empty() &&
+      GetPersistentCache() == nullptr) {
+    JitPersistentCache* persistent_cache = new JitPersistentCache(profile_filename + ".jitcache");
+    persistent_cache_.store(persistent_cache, std::memory_order_release);
+    // Install the cached code before the compilation of the hot startup methods is requested.
+    thread_pool_->AddTask(Thread::Current(),
+                          new JitPersistentCacheTask(persistent_cache, /*save=*/ false));
+  }
+  // Prefetch the startup classes first, so that they are linked by the time their startup
+  // methods get compiled.
+  if (options_->PrefetchStartupClasses() &&
+      thread_pool_ != nullptr &&
+      code_type == AppInfo::CodeType::kPrimaryApk &&
+      !Runtime::Current()->IsJavaDebuggable()) {
+    thread_pool_->AddTask(Thread::Current(),
+                          new JitStartupProfileTask(JitStartupProfileTask::Kind::kPrefetchClasses,
+                                                    {ref_profile_filename, profile_filename},
+                                                    code_paths));
+  }
+  if (options_->UseStartupProfileJitCompilation() &&
+      UseJitCompilation() &&
+      thread_pool_ != nullptr &&
+      code_type == AppInfo::CodeType::kPrimaryApk &&
+      !Runtime::Current()->IsJavaDebuggable()) {
+    thread_pool_->AddTask(Thread::Current(),
+                          new JitStartupProfileTask(JitStartupProfileTask::Kind::kCompileMethods,
+                                                    {ref_profile_filename, profile_filename},
+                                                    code_paths));
+  }
+}
+
+void Jit::SavePersistentCache(Thread* self) {
+  JitPersistentCache* persistent_cache = GetPersistentCache();
+  if (persistent_cache != nullptr && thread_pool_ != nullptr) {
+    thread_pool_->AddTask(self, new JitPersistentCacheTask(persistent_cache, /*save=*/ true));
+  }
 }
 
 void Jit::StopProfileSaver() {
@@ -310,6 +520,7 @@ Jit::~Jit() {
     Runtime::Current()->DumpDeoptimizations(LOG_STREAM(INFO));
   }
   DeleteThreadPool();
+  delete persistent_cache_.load(std::memory_order_relaxed);
   if (jit_compiler_ != nullptr) {
     delete jit_compiler_;
     jit_compiler_ = nullptr;
@@ -352,6 +563,48 @@ extern "C" void art_quick_osr_stub(void** stack,
                                    const char* shorty,
                                    Thread* self);
 
+Jit::OsrEntry Jit::DecodeOsrEntry(ArtMethod* method,
+                                   const OatQuickMethodHeader* osr_method,
+                                   uint32_t dex_pc) {
+  OsrEntry entry;
+  entry.code = osr_method->GetCode();
+  entry.native_pc_offset = kNoOsrEntry;
+
+  CodeInfo code_info(osr_method);
+  // Find stack map starting at the target dex_pc.
+  StackMap stack_map = code_info.GetOsrStackMapForDexPc(dex_pc);
+  if (!stack_map.IsValid()) {
+    return entry;
+  }
+  entry.native_pc_offset = stack_map.GetNativePcOffset(kRuntimeQuickCodeISA);
+
+  DexRegisterMap vreg_map = code_info.GetDexRegisterMapOf(stack_map);
+  DCHECK_IMPLIES(!vreg_map.empty(),
+                 vreg_map.size() == method->DexInstructionData().RegistersSize());
+  // If we don't have a dex register map, then there are no live dex registers at
+  // this dex pc.
+  for (size_t vreg = 0; vreg < vreg_map.size(); ++vreg) {
+    DexRegisterLocation::Kind location = vreg_map[vreg].GetKind();
+    if (location == DexRegisterLocation::Kind::kNone) {
+      // Dex register is dead or uninitialized.
+      continue;
+    }
+
+    if (location == DexRegisterLocation::Kind::kConstant) {
+      // We skip constants because the compiled code knows how to handle them.
+      continue;
+    }
+
+    DCHECK_EQ(location, DexRegisterLocation::Kind::kInStack);
+    int32_t slot_offset = vreg_map[vreg].GetStackOffsetInBytes();
+    DCHECK_LT(slot_offset, static_cast<int32_t>(osr_method->GetFrameSizeInBytes()));
+    DCHECK_GT(slot_offset, 0);
+    entry.vreg_slots.emplace_back(dchecked_integral_cast<uint16_t>(vreg),
+                                  slot_offset / sizeof(int32_t));
+  }
+  return entry;
+}
+
 OsrData* Jit::PrepareForOsr(ArtMethod* method, uint32_t dex_pc, uint32_t* vregs) {
   if (!kEnableOnStackReplacement) {
     return nullptr;
@@ -366,8 +619,7 @@ OsrData* Jit::PrepareForOsr(ArtMethod* method, uint32_t dex_pc, uint32_t* vregs)
   // Fetch some data before looking up for an OSR method. We don't want thread
   // suspension once we hold an OSR method, as the JIT code cache could delete the OSR
   // method while we are being suspended.
-  CodeItemDataAccessor accessor(method->DexInstructionData());
-  const size_t number_of_vregs = accessor.RegistersSize();
+  Thread* self = Thread::Current();
   std::string method_name(VLOG_IS_ON(jit) ? method->PrettyMethod() : "");
   OsrData* osr_data = nullptr;
 
@@ -378,66 +630,54 @@ OsrData* Jit::PrepareForOsr(ArtMethod* method, uint32_t dex_pc, uint32_t* vregs)
       // No osr method yet, just return to the interpreter.
       return nullptr;
     }
-
-    CodeInfo code_info(osr_method);
-
-    // Find stack map starting at the target dex_pc.
-    StackMap stack_map = code_info.GetOsrStackMapForDexPc(dex_pc);
-    if (!stack_map.IsValid()) {
+    uint32_t code_free_generation = GetCodeCache()->GetCodeFreeGeneration();
+
+    MutexLock mu(self, osr_entries_lock_);
+    auto key = std::make_pair(method, dex_pc);
+    auto it = osr_entries_.find(key);
+    if (it != osr_entries_.end() &&
+        it->second.code == osr_method->GetCode() &&
+        it->second.code_free_generation == code_free_generation) {
+      ++num_osr_entry_hits_;
+    } else {
+      ++num_osr_entry_misses_;
+      OsrEntry entry = DecodeOsrEntry(method, osr_method, dex_pc);
+      entry.code_free_generation = code_free_generation;
+      if (it != osr_entries_.end()) {
+        osr_entries_.erase(it);
+      } else if (osr_entries_.size() == kMaxOsrEntries) {
+        osr_entries_.clear();
+      }
+      it = osr_entries_.emplace(key, std::move(entry)).first;
+    }
+    const OsrEntry& entry = it->second;
+    if (entry.native_pc_offset == kNoOsrEntry) {
       // There is no OSR stack map for this dex pc offset. Just return to the interpreter in the
       // hope that the next branch has one.
       return nullptr;
     }
 
-    // We found a stack map, now fill the frame with dex register values from the interpreter's
-    // shadow frame.
-    DexRegisterMap vreg_map = code_info.GetDexRegisterMapOf(stack_map);
-    DCHECK_EQ(vreg_map.size(), number_of_vregs);
-
-    size_t frame_size = osr_method->GetFrameSizeInBytes();
-
     // Allocate memory to put shadow frame values. The osr stub will copy that memory to
     // stack.
     // Note that we could pass the shadow frame to the stub, and let it copy the values there,
     // but that is engineering complexity not worth the effort for something like OSR.
-    osr_data = reinterpret_cast<OsrData*>(malloc(sizeof(OsrData) + frame_size));
+    size_t frame_size = osr_method->GetFrameSizeInBytes();
+    osr_data = reinterpret_cast<OsrData*>(calloc(1u, sizeof(OsrData) + frame_size));
     if (osr_data == nullptr) {
       return nullptr;
     }
-    memset(osr_data, 0, sizeof(OsrData) + frame_size);
     osr_data->frame_size = frame_size;
 
     // Art ABI: ArtMethod is at the bottom of the stack.
     osr_data->memory[0] = method;
 
-    if (vreg_map.empty()) {
-      // If we don't have a dex register map, then there are no live dex registers at
-      // this dex pc.
-    } else {
-      for (uint16_t vreg = 0; vreg < number_of_vregs; ++vreg) {
-        DexRegisterLocation::Kind location = vreg_map[vreg].GetKind();
-        if (location == DexRegisterLocation::Kind::kNone) {
-          // Dex register is dead or uninitialized.
-          continue;
-        }
-
-        if (location == DexRegisterLocation::Kind::kConstant) {
-          // We skip constants because the compiled code knows how to handle them.
-          continue;
-        }
-
-        DCHECK_EQ(location, DexRegisterLocation::Kind::kInStack);
-
-        int32_t vreg_value = vregs[vreg];
-        int32_t slot_offset = vreg_map[vreg].GetStackOffsetInBytes();
-        DCHECK_LT(slot_offset, static_cast<int32_t>(frame_size));
-        DCHECK_GT(slot_offset, 0);
-        (reinterpret_cast<int32_t*>(osr_data->memory))[slot_offset / sizeof(int32_t)] = vreg_value;
-      }
+    // Fill the frame with the live dex register values from the interpreter's frame.
+    int32_t* slots = reinterpret_cast<int32_t*>(osr_data->memory);
+    for (const std::pair<uint16_t, uint32_t>& vreg_slot : entry.vreg_slots) {
+      slots[vreg_slot.second] = vregs[vreg_slot.first];
     }
 
-    osr_data->native_pc = stack_map.GetNativePcOffset(kRuntimeQuickCodeISA) +
-        osr_method->GetEntryPoint();
+    osr_data->native_pc = entry.native_pc_offset + osr_method->GetEntryPoint();
     VLOG(jit) << "Jumping to "
               << method_name
               << "@"
@@ -521,6 +761,51 @@ void Jit::AddMemoryUsage(ArtMethod* method, size_t bytes) {
   memory_use_.AddValue(bytes);
 }
 
+void Jit::AddCompilationTelemetry(ArtMethod* method,
+                                  CompilationKind compilation_kind,
+                                  uint64_t duration_ns,
+                                  size_t arena_bytes,
+                                  size_t inlined_methods,
+                                  size_t code_size) {
+  metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+  int64_t duration_us = static_cast<int64_t>(NsToUs(duration_ns));
+  switch (compilation_kind) {
+    case CompilationKind::kBaseline:
+      metrics->JitBaselineCompileTime()->Add(duration_us);
+      break;
+    case CompilationKind::kOptimized:
+      metrics->JitOptimizedCompileTime()->Add(duration_us);
+      break;
+    case CompilationKind::kOsr:
+      metrics->JitOsrCompileTime()->Add(duration_us);
+      break;
+  }
+  metrics->JitCompileArenaKb()->Add(static_cast<int64_t>(arena_bytes / KB));
+  metrics->JitCompileInlinedMethods()->Add(static_cast<int64_t>(inlined_methods));
+  metrics->JitCompileCodeSize()->Add(static_cast<int64_t>(code_size));
+
+  auto is_slower = [](const CompilationTelemetry& lhs, const CompilationTelemetry& rhs) {
+    return lhs.duration_ns > rhs.duration_ns;
+  };
+  MutexLock mu(Thread::Current(), lock_);
+  if (slowest_compilations_.size() == kMaxSlowestCompilations &&
+      slowest_compilations_.back().duration_ns >= duration_ns) {
+    return;
+  }
+  CompilationTelemetry telemetry{method->PrettyMethod(),
+                                 compilation_kind,
+                                 duration_ns,
+                                 arena_bytes,
+                                 inlined_methods,
+                                 code_size};
+  auto it = std::upper_bound(
+      slowest_compilations_.begin(), slowest_compilations_.end(), telemetry, is_slower);
+  slowest_compilations_.insert(it, std::move(telemetry));
+  if (slowest_compilations_.size() > kMaxSlowestCompilations) {
+    slowest_compilations_.pop_back();
+  }
+}
+
 void Jit::NotifyZygoteCompilationDone() {
   if (fd_methods_ == -1) {
     return;
@@ -656,10 +941,12 @@ class JitCompileTask final : public Task {
 
   JitCompileTask(ArtMethod* method,
                  TaskKind task_kind,
-                 CompilationKind compilation_kind)
+                 CompilationKind compilation_kind,
+                 uint64_t request_time_ns = 0u)
       : method_(method),
         kind_(task_kind),
-        compilation_kind_(compilation_kind) {
+        compilation_kind_(compilation_kind),
+        request_time_ns_(request_time_ns) {
   }
 
   void Run(Thread* self) override {
@@ -696,10 +983,16 @@ class JitCompileTask final : public Task {
     return compilation_kind_;
   }
 
+  uint64_t GetRequestTimeNs() const {
+    return request_time_ns_;
+  }
+
  private:
   ArtMethod* const method_;
   const TaskKind kind_;
   const CompilationKind compilation_kind_;
+  // When the compilation was first requested, or 0 if not tracked.
+  const uint64_t request_time_ns_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
 };
@@ -874,6 +1167,20 @@ class ZygoteTask final : public Task {
             self, boot_class_path, profile_file, null_handle, /* add_to_queue= */ true);
       }
     }
+    // Compile the boot classpath methods found hot in the running apps but missing from the
+    // boot image profiles once here, so that all apps forked from the zygote share them. The
+    // methods already queued from the profiles above are skipped as pre-compiled.
+    const std::string& zygote_profile = runtime->GetJit()->GetZygoteProfile();
+    if (!zygote_profile.empty() && OS::FileExists(zygote_profile.c_str())) {
+      LOG(INFO) << "JIT Zygote looking at aggregated profile " << zygote_profile;
+      ScopedNullHandle<mirror::ClassLoader> null_handle;
+      added_to_queue += runtime->GetJit()->CompileMethodsFromProfile(
+          self,
+          runtime->GetClassLinker()->GetBootClassPath(),
+          zygote_profile,
+          null_handle,
+          /* add_to_queue= */ true);
+    }
     DCHECK(runtime->GetJit()->InZygoteUsingJit());
     runtime->GetJit()->AddPostBootTask(self, new JitZygoteDoneCompilingTask());
 
@@ -1373,6 +1680,194 @@ uint32_t Jit::CompileMethodsFromProfile(
   return added_to_queue;
 }
 
+// Collect the dex caches of the loaded dex files of `code_paths`.
+static void CollectDexCachesOfCodePaths(Thread* self,
+                                        const std::vector<std::string>& code_paths,
+                                        VariableSizedHandleScope* handles,
+                                        /*out*/ std::vector<Handle<mirror::DexCache>>* dex_caches)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  class CollectDexCaches final : public DexCacheVisitor {
+   public:
+    CollectDexCaches(VariableSizedHandleScope* handles,
+                     const std::vector<std::string>& code_paths,
+                     std::vector<Handle<mirror::DexCache>>* out)
+        : handles_(handles), code_paths_(code_paths), out_(out) {}
+
+    void Visit(ObjPtr<mirror::DexCache> dex_cache)
+        REQUIRES_SHARED(Locks::dex_lock_, Locks::mutator_lock_) override {
+      std::string base_location =
+          DexFileLoader::GetBaseLocation(dex_cache->GetDexFile()->GetLocation());
+      if (ContainsElement(code_paths_, base_location)) {
+        out_->push_back(handles_->NewHandle(dex_cache));
+      }
+    }
+
+   private:
+    VariableSizedHandleScope* const handles_;
+    const std::vector<std::string>& code_paths_;
+    std::vector<Handle<mirror::DexCache>>* const out_;
+  };
+  CollectDexCaches visitor(handles, code_paths, dex_caches);
+  ReaderMutexLock mu(self, *Locks::dex_lock_);
+  Runtime::Current()->GetClassLinker()->VisitDexCaches(&visitor);
+}
+
+uint32_t Jit::PrefetchStartupClassesFromProfile(Thread* self,
+                                                const std::string& profile_path,
+                                                const std::vector<std::string>& code_paths) {
+  // Loading classes may need to run code of the class loader, which the JIT threads
+  // cannot do when the runtime is debuggable.
+  if (!self->CanLoadClasses()) {
+    return 0u;
+  }
+  unix_file::FdFile profile(profile_path, O_RDONLY, /* check_usage= */ false);
+  if (profile.Fd() == -1) {
+    PLOG(WARNING) << "No profile: " << profile_path;
+    return 0u;
+  }
+  ProfileCompilationInfo profile_info;
+  if (!profile_info.Load(profile.Fd())) {
+    LOG(WARNING) << "Could not load profile file: " << profile_path;
+    return 0u;
+  }
+
+  uint64_t start_ns = ThreadCpuNanoTime();
+  ScopedObjectAccess soa(self);
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  VariableSizedHandleScope handles(self);
+  std::vector<Handle<mirror::DexCache>> dex_caches;
+  CollectDexCachesOfCodePaths(self, code_paths, &handles, &dex_caches);
+
+  StackHandleScope<2> hs(self);
+  MutableHandle<mirror::ClassLoader> class_loader = hs.NewHandle<mirror::ClassLoader>(nullptr);
+  MutableHandle<mirror::Class> klass = hs.NewHandle<mirror::Class>(nullptr);
+  uint32_t number_of_classes = 0u;
+  for (Handle<mirror::DexCache> dex_cache : dex_caches) {
+    std::set<dex::TypeIndex> class_types;
+    std::set<uint16_t> unused_methods;
+    if (!profile_info.GetClassesAndMethods(*dex_cache->GetDexFile(),
+                                           &class_types,
+                                           &unused_methods,
+                                           &unused_methods,
+                                           &unused_methods)) {
+      continue;
+    }
+    class_loader.Assign(dex_cache->GetClassLoader());
+    for (dex::TypeIndex type_index : class_types) {
+      // Loading and linking is safe to do ahead of the main thread: the class is inserted
+      // in the class table as soon as it is loaded, and a thread looking it up while it is
+      // being linked waits for its status to reach `kResolved`.
+      klass.Assign(class_linker->ResolveType(type_index, dex_cache, class_loader));
+      if (klass == nullptr) {
+        // The profile can reference classes which are not in the class path anymore.
+        self->ClearException();
+        continue;
+      }
+      ++number_of_classes;
+      // Verify the classes defined by the app. Verification does not run any Java code and
+      // records a soft failure as a status that the main thread handles as usual. Class
+      // initialization is left to the main thread, as it runs app code.
+      if (klass->IsVerified() ||
+          klass->IsArrayClass() ||
+          klass->IsErroneous() ||
+          klass->GetClassLoader() != class_loader.Get()) {
+        continue;
+      }
+      if (class_linker->VerifyClass(self, /* verifier_deps= */ nullptr, klass) ==
+              verifier::FailureKind::kHardFailure) {
+        DCHECK(self->IsExceptionPending());
+        self->ClearException();
+      }
+      DCHECK(!self->IsExceptionPending());
+    }
+  }
+  VLOG(jit) << "Prefetched " << number_of_classes << " startup classes of " << profile_path
+            << " in " << PrettyDuration(ThreadCpuNanoTime() - start_ns);
+  return number_of_classes;
+}
+
+uint32_t Jit::CompileStartupMethodsFromProfile(Thread* self,
+                                               const std::string& profile_path,
+                                               const std::vector<std::string>& code_paths) {
+  unix_file::FdFile profile(profile_path, O_RDONLY, /* check_usage= */ false);
+  if (profile.Fd() == -1) {
+    PLOG(WARNING) << "No profile: " << profile_path;
+    return 0u;
+  }
+  ProfileCompilationInfo profile_info;
+  if (!profile_info.Load(profile.Fd())) {
+    LOG(WARNING) << "Could not load profile file: " << profile_path;
+    return 0u;
+  }
+
+  ScopedObjectAccess soa(self);
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  VariableSizedHandleScope handles(self);
+  std::vector<Handle<mirror::DexCache>> dex_caches;
+  CollectDexCachesOfCodePaths(self, code_paths, &handles, &dex_caches);
+
+  // Order the startup methods by the first startup bin they are in, methods without startup bin
+  // going last.
+  struct StartupMethod {
+    uint32_t bin;
+    size_t dex_cache_index;
+    uint16_t method_index;
+  };
+  std::vector<StartupMethod> startup_methods;
+  for (size_t i = 0; i != dex_caches.size(); ++i) {
+    const DexFile& dex_file = *dex_caches[i]->GetDexFile();
+    std::set<dex::TypeIndex> class_types;
+    std::set<uint16_t> hot_methods;
+    std::set<uint16_t> startup_method_indexes;
+    std::set<uint16_t> post_startup_methods;
+    if (!profile_info.GetClassesAndMethods(dex_file,
+                                           &class_types,
+                                           &hot_methods,
+                                           &startup_method_indexes,
+                                           &post_startup_methods)) {
+      continue;
+    }
+    for (uint16_t method_index : startup_method_indexes) {
+      uint32_t flags =
+          profile_info.GetMethodHotness(MethodReference(&dex_file, method_index)).GetFlags();
+      uint32_t bins = flags & ~(ProfileCompilationInfo::MethodHotness::kFlagStartupBin - 1u);
+      uint32_t bin = (bins != 0u) ? CTZ(bins) : std::numeric_limits<uint32_t>::max();
+      startup_methods.push_back(StartupMethod{bin, i, method_index});
+    }
+  }
+  std::stable_sort(startup_methods.begin(),
+                   startup_methods.end(),
+                   [](const StartupMethod& lhs, const StartupMethod& rhs) {
+                     return lhs.bin < rhs.bin;
+                   });
+
+  StackHandleScope<1> hs(self);
+  MutableHandle<mirror::ClassLoader> class_loader = hs.NewHandle<mirror::ClassLoader>(nullptr);
+  uint32_t added_to_queue = 0u;
+  for (const StartupMethod& startup_method : startup_methods) {
+    Handle<mirror::DexCache> dex_cache = dex_caches[startup_method.dex_cache_index];
+    class_loader.Assign(dex_cache->GetClassLoader());
+    ArtMethod* method =
+        class_linker->ResolveMethodId(startup_method.method_index, dex_cache, class_loader);
+    if (method == nullptr) {
+      self->ClearException();
+      continue;
+    }
+    if (!method->IsCompilable() ||
+        !method->IsInvokable() ||
+        method->IsNative() ||
+        method->GetOatMethodQuickCode(kRuntimePointerSize) != nullptr ||
+        GetCodeCache()->ContainsMethod(method)) {
+      continue;
+    }
+    AddCompileTask(self, method, CompilationKind::kBaseline);
+    ++added_to_queue;
+  }
+  VLOG(jit) << "Added " << added_to_queue << " startup methods of " << profile_path
+            << " to the JIT queue";
+  return added_to_queue;
+}
+
 bool Jit::IgnoreSamplesForMethod(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
   if (method->IsClassInitializer() || !method->IsCompilable()) {
     // We do not want to compile such methods.
@@ -1413,9 +1908,60 @@ void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   // We arrive here after a baseline compiled code has reached its baseline
   // hotness threshold. If we're not only using the baseline compiler, enqueue a compilation
   // task that will compile optimize the method.
-  if (!options_->UseBaselineCompiler()) {
-    AddCompileTask(self, method, CompilationKind::kOptimized);
+  if (options_->UseBaselineCompiler()) {
+    return;
+  }
+
+  // Optimized code is specialized on the receiver types seen by the inline caches, so we wait
+  // for them to stop changing before compiling. The baseline code resets its hotness counter,
+  // so a deferred method comes back here after another optimize threshold of executions.
+  uint64_t now_ns = NanoTime();
+  uint64_t request_time_ns = now_ns;
+  bool churning = false;
+  ProfilingInfo* info = code_cache_->GetProfilingInfo(method, self);
+  if (info != nullptr && info->GetNumberOfInlineCaches() != 0u) {
+    size_t inline_cache_classes = info->GetNumberOfInlineCacheClasses();
+    MutexLock mu(self, lock_);
+    auto it = tier_up_states_.find(method);
+    if (it == tier_up_states_.end()) {
+      if (tier_up_states_.size() < kMaxPendingTierUps) {
+        tier_up_states_.emplace(method, TierUpState{now_ns, inline_cache_classes, 0u});
+        ++num_tier_up_deferrals_;
+        return;
+      }
+    } else {
+      TierUpState& state = it->second;
+      churning = (state.inline_cache_classes != inline_cache_classes);
+      if (churning && state.deferrals < kMaxTierUpDeferrals) {
+        state.inline_cache_classes = inline_cache_classes;
+        ++state.deferrals;
+        ++num_tier_up_deferrals_;
+        return;
+      }
+      request_time_ns = state.first_request_ns;
+      tier_up_states_.erase(it);
+    }
+    if (churning) {
+      ++num_tier_up_churning_;
+    } else {
+      ++num_tier_up_stable_;
+    }
+  }
+
+  uint64_t priority = ComputeTierUpPriority(method, info);
+  if (churning) {
+    // Still seeing new receiver types: the optimized code is likely to be less effective,
+    // or to be invalidated by deoptimization.
+    priority >>= kChurningTierUpPriorityShift;
   }
+  thread_pool_->AddOptimizedTask(self, method, priority, request_time_ns);
+}
+
+uint64_t Jit::ComputeTierUpPriority(ArtMethod* method, ProfilingInfo* info) {
+  // The hotter the loops, and the larger the method, the more we gain by leaving baseline code.
+  uint64_t hotness = 1u + (info != nullptr ? info->GetBranchExecutionCount() : 0u);
+  uint64_t code_units = std::max<uint64_t>(method->DexInstructions().InsnsSizeInCodeUnits(), 1u);
+  return hotness * code_units;
 }
 
 class ScopedSetRuntimeThread {
@@ -1704,6 +2250,12 @@ void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
     } else {
       shared_method_counters_[method] = kIndividualSharedMethodHotnessThreshold;
     }
+    // With sampling hotness, app methods are memory shared methods too and nterp does not mark
+    // them as warm, so do it here for the profile saver. This writes the method once.
+    if (options_->UseSamplingHotness() &&
+        !Runtime::Current()->GetHeap()->IsBootImageAddress(method)) {
+      method->SetPreviouslyWarm();
+    }
   }
 
   if (!method->IsNative() && GetCodeCache()->CanAllocateProfilingInfo()) {
@@ -1801,7 +2353,12 @@ void JitThreadPool::AddTask(Thread* self, ArtMethod* method, CompilationKind kin
         return;
       }
       optimized_enqueued_methods_.insert(method);
-      optimized_queue_.push_back(method);
+      // Methods compiled optimized directly, without baseline code, run in the interpreter
+      // until compiled: compile them before the tier ups.
+      optimized_queue_.push_back(OptimizedRequest{
+          method, std::numeric_limits<uint64_t>::max(), /* request_time_ns= */ 0u});
+      std::push_heap(optimized_queue_.begin(), optimized_queue_.end());
+      max_optimized_queue_depth_ = std::max(max_optimized_queue_depth_, optimized_queue_.size());
       break;
   }
   // If we have any waiters, signal one.
@@ -1810,6 +2367,40 @@ void JitThreadPool::AddTask(Thread* self, ArtMethod* method, CompilationKind kin
   }
 }
 
+void JitThreadPool::AddOptimizedTask(Thread* self,
+                                     ArtMethod* method,
+                                     uint64_t priority,
+                                     uint64_t request_time_ns) {
+  MutexLock mu(self, task_queue_lock_);
+  if (!started_) {
+    return;
+  }
+  if (ContainsElement(optimized_enqueued_methods_, method)) {
+    return;
+  }
+  optimized_enqueued_methods_.insert(method);
+  optimized_queue_.push_back(OptimizedRequest{method, priority, request_time_ns});
+  std::push_heap(optimized_queue_.begin(), optimized_queue_.end());
+  max_optimized_queue_depth_ = std::max(max_optimized_queue_depth_, optimized_queue_.size());
+  if (waiting_count_ != 0) {
+    task_queue_condition_.Signal(self);
+  }
+}
+
+void JitThreadPool::DumpInfo(std::ostream& os) {
+  MutexLock mu(Thread::Current(), task_queue_lock_);
+  os << "JIT queues: " << osr_queue_.size() << " osr, "
+     << baseline_queue_.size() << " baseline, "
+     << optimized_queue_.size() << " optimized (max " << max_optimized_queue_depth_ << ")\n";
+  os << time_to_optimized_us_.Name();
+  if (time_to_optimized_us_.SampleSize() != 0u) {
+    os << ": Avg: " << PrettyDuration(static_cast<uint64_t>(time_to_optimized_us_.Mean()) * 1000)
+       << " Max: " << PrettyDuration(time_to_optimized_us_.Max() * 1000) << "\n";
+  } else {
+    os << ": <no data>\n";
+  }
+}
+
 Task* JitThreadPool::TryGetTaskLocked() {
   if (!started_) {
     return nullptr;
@@ -1827,7 +2418,7 @@ Task* JitThreadPool::TryGetTaskLocked() {
   if (task == nullptr) {
     task = FetchFrom(baseline_queue_, CompilationKind::kBaseline);
     if (task == nullptr) {
-      task = FetchFrom(optimized_queue_, CompilationKind::kOptimized);
+      task = FetchOptimized();
     }
   }
   return task;
@@ -1844,6 +2435,21 @@ Task* JitThreadPool::FetchFrom(std::deque<ArtMethod*>& methods, CompilationKind
   return nullptr;
 }
 
+Task* JitThreadPool::FetchOptimized() {
+  if (!optimized_queue_.empty()) {
+    std::pop_heap(optimized_queue_.begin(), optimized_queue_.end());
+    OptimizedRequest request = optimized_queue_.back();
+    optimized_queue_.pop_back();
+    JitCompileTask* task = new JitCompileTask(request.method,
+                                              JitCompileTask::TaskKind::kCompile,
+                                              CompilationKind::kOptimized,
+                                              request.request_time_ns);
+    current_compilations_.insert(task);
+    return task;
+  }
+  return nullptr;
+}
+
 void JitThreadPool::Remove(JitCompileTask* task) {
   MutexLock mu(Thread::Current(), task_queue_lock_);
   current_compilations_.erase(task);
@@ -1858,6 +2464,12 @@ void JitThreadPool::Remove(JitCompileTask* task) {
     }
     case CompilationKind::kOptimized: {
       optimized_enqueued_methods_.erase(task->GetArtMethod());
+      if (task->GetRequestTimeNs() != 0u) {
+        uint64_t time_to_optimized_us = (NanoTime() - task->GetRequestTimeNs()) / 1000;
+        time_to_optimized_us_.AddValue(time_to_optimized_us);
+        Runtime::Current()->GetMetrics()->JitTimeToOptimizedCode()->Add(
+            static_cast<int64_t>(time_to_optimized_us));
+      }
       break;
     }
   }
@@ -1886,7 +2498,9 @@ void JitThreadPool::VisitRoots(RootVisitor* visitor) {
     //   part of the boot classpath or system server classpath.
     methods.insert(methods.end(), osr_queue_.begin(), osr_queue_.end());
     methods.insert(methods.end(), baseline_queue_.begin(), baseline_queue_.end());
-    methods.insert(methods.end(), optimized_queue_.begin(), optimized_queue_.end());
+    for (const OptimizedRequest& request : optimized_queue_) {
+      methods.push_back(request.method);
+    }
     for (JitCompileTask* task : current_compilations_) {
       methods.push_back(task->GetArtMethod());
     }
@@ -19,6 +19,10 @@
 
 #include <android-base/unique_fd.h>
 
+#include <atomic>
+#include <limits>
+#include <map>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "app_info.h"
@@ -41,6 +45,7 @@ class ArtMethod;
 class ClassLinker;
 class DexFile;
 class OatDexFile;
+class ProfilingInfo;
 class RootVisitor;
 struct RuntimeArgumentMap;
 union JValue;
@@ -59,6 +64,7 @@ class JitCodeCache;
 class JitCompileTask;
 class JitMemoryRegion;
 class JitOptions;
+class JitPersistentCache;
 
 static constexpr int16_t kJitCheckForOSR = -1;
 static constexpr int16_t kJitHotnessDisabled = -2;
@@ -135,6 +141,16 @@ class JitThreadPool : public AbstractThreadPool {
   // Add a custom compilation task in the right queue.
   void AddTask(Thread* self, ArtMethod* method, CompilationKind kind) REQUIRES(!task_queue_lock_);
 
+  // Add an optimized compilation task for a method tiering up from baseline code. The optimized
+  // queue is ordered by `priority`, highest first. `request_time_ns` is when the tier up was
+  // first requested, for reporting the time to optimized code.
+  void AddOptimizedTask(Thread* self,
+                        ArtMethod* method,
+                        uint64_t priority,
+                        uint64_t request_time_ns) REQUIRES(!task_queue_lock_);
+
+  void DumpInfo(std::ostream& os) REQUIRES(!task_queue_lock_);
+
   // Visit the ArtMethods stored in the various queues.
   void VisitRoots(RootVisitor* visitor);
 
@@ -154,16 +170,31 @@ class JitThreadPool : public AbstractThreadPool {
                 size_t num_threads,
                 size_t worker_stack_size)
       // We need peers as we may report the JIT thread, e.g., in the debugger.
-      : AbstractThreadPool(name, num_threads, /* create_peers= */ true, worker_stack_size) {}
+      : AbstractThreadPool(name, num_threads, /* create_peers= */ true, worker_stack_size),
+        time_to_optimized_us_("Time to optimized code (us)", /* initial_bucket_width= */ 1000) {}
+
+  struct OptimizedRequest {
+    ArtMethod* method;
+    uint64_t priority;
+    uint64_t request_time_ns;
+
+    bool operator<(const OptimizedRequest& other) const {
+      return priority < other.priority;
+    }
+  };
 
   // Try to fetch an entry from `methods`. Return null if `methods` is empty.
   Task* FetchFrom(std::deque<ArtMethod*>& methods, CompilationKind kind) REQUIRES(task_queue_lock_);
 
+  // Fetch the optimized request with the highest priority. Return null if there is none.
+  Task* FetchOptimized() REQUIRES(task_queue_lock_);
+
   std::deque<Task*> generic_queue_ GUARDED_BY(task_queue_lock_);
 
   std::deque<ArtMethod*> osr_queue_ GUARDED_BY(task_queue_lock_);
   std::deque<ArtMethod*> baseline_queue_ GUARDED_BY(task_queue_lock_);
-  std::deque<ArtMethod*> optimized_queue_ GUARDED_BY(task_queue_lock_);
+  // A max-heap of optimized requests, ordered by priority.
+  std::vector<OptimizedRequest> optimized_queue_ GUARDED_BY(task_queue_lock_);
 
   // We track the methods that are currently enqueued to avoid
   // adding them to the queue multiple times, which could bloat the
@@ -176,6 +207,10 @@ class JitThreadPool : public AbstractThreadPool {
   // will be removed when JitCompileTask->Finalize is called.
   std::unordered_set<JitCompileTask*> current_compilations_ GUARDED_BY(task_queue_lock_);
 
+  // Statistics on the optimized queue.
+  size_t max_optimized_queue_depth_ GUARDED_BY(task_queue_lock_) = 0u;
+  Histogram<uint64_t> time_to_optimized_us_ GUARDED_BY(task_queue_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(JitThreadPool);
 };
 
@@ -208,6 +243,15 @@ class Jit {
     return jit_compiler_;
   }
 
+  // Return the persistent cache of compiled code, or null if not enabled with
+  // -Xjitpersistentcache or not yet created.
+  JitPersistentCache* GetPersistentCache() const {
+    return persistent_cache_.load(std::memory_order_acquire);
+  }
+
+  // Write the code recorded in the persistent cache to its file, in the background.
+  void SavePersistentCache(Thread* self);
+
   void CreateThreadPool();
   void DeleteThreadPool();
   void WaitForWorkersToBeCreated();
@@ -222,6 +266,17 @@ class Jit {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Record the cost of a successful compilation of `method` in the runtime metrics, and keep
+  // the most expensive compilations for `DumpInfo`.
+  void AddCompilationTelemetry(ArtMethod* method,
+                               CompilationKind compilation_kind,
+                               uint64_t duration_ns,
+                               size_t arena_bytes,
+                               size_t inlined_methods,
+                               size_t code_size)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   int GetThreadPoolPthreadPriority() const {
     return options_->GetThreadPoolPthreadPriority();
   }
@@ -230,6 +285,10 @@ class Jit {
     return options_->GetZygoteThreadPoolPthreadPriority();
   }
 
+  const std::string& GetZygoteProfile() const {
+    return options_->GetZygoteProfile();
+  }
+
   uint16_t HotMethodThreshold() const {
     return options_->GetOptimizeThreshold();
   }
@@ -303,6 +362,7 @@ class Jit {
   // Return the information required to do an OSR jump. Return null if the OSR
   // cannot be done.
   OsrData* PrepareForOsr(ArtMethod* method, uint32_t dex_pc, uint32_t* vregs)
+      REQUIRES(!osr_entries_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // If an OSR compiled version is available for `method`,
@@ -364,6 +424,22 @@ class Jit {
                                          Handle<mirror::ClassLoader> class_loader,
                                          bool add_to_queue);
 
+  // Load, link and verify the classes of `profile_path` which belong to the loaded dex files
+  // of `code_paths`, so that the main thread finds them ready. Return the number of classes
+  // loaded.
+  uint32_t PrefetchStartupClassesFromProfile(Thread* self,
+                                             const std::string& profile_path,
+                                             const std::vector<std::string>& code_paths)
+      REQUIRES(!Locks::mutator_lock_);
+
+  // Add to the JIT queue a baseline compilation of the startup methods of `profile_path`
+  // which belong to the loaded dex files of `code_paths` and have no AOT code, ordered by
+  // their startup bin. Return the number of methods added to the queue.
+  uint32_t CompileStartupMethodsFromProfile(Thread* self,
+                                            const std::string& profile_path,
+                                            const std::vector<std::string>& code_paths)
+      REQUIRES(!Locks::mutator_lock_);
+
   // Register the dex files to the JIT. This is to perform any compilation/optimization
   // at the point of loading the dex files.
   void RegisterDexFiles(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
@@ -387,7 +463,11 @@ class Jit {
   // class path methods.
   void NotifyZygoteCompilationDone();
 
-  EXPORT void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self);
+  // Called by baseline compiled code when its hotness counter reaches the optimize threshold.
+  // The method is queued for optimized compilation once its inline caches have stabilized.
+  EXPORT void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   EXPORT void MaybeEnqueueCompilation(ArtMethod* method, Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -415,6 +495,11 @@ class Jit {
 
   static bool BindCompilerMethods(std::string* error_msg);
 
+  // Return the priority of the optimized compilation of `method`, an estimate of the benefit
+  // of replacing its baseline code.
+  static uint64_t ComputeTierUpPriority(ArtMethod* method, ProfilingInfo* info)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void AddCompileTask(Thread* self,
                       ArtMethod* method,
                       CompilationKind compilation_kind);
@@ -425,6 +510,20 @@ class Jit {
                              bool prejit)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  struct OsrEntry;
+  // Decode the OSR entry of `osr_method` at `dex_pc`.
+  static OsrEntry DecodeOsrEntry(ArtMethod* method,
+                                 const OatQuickMethodHeader* osr_method,
+                                 uint32_t dex_pc)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Reserve `bytes` of the compilation memory budget, waiting while concurrent compilations
+  // use it up. A compilation can always proceed when no other one is running.
+  void AcquireCompilationMemory(Thread* self, size_t bytes)
+      REQUIRES(!compilation_memory_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  void ReleaseCompilationMemory(Thread* self, size_t bytes) REQUIRES(!compilation_memory_lock_);
+
   // JIT compiler
   EXPORT static JitCompilerInterface* jit_compiler_;
 
@@ -435,6 +534,9 @@ class Jit {
   std::unique_ptr<JitThreadPool> thread_pool_;
   std::vector<std::unique_ptr<OatDexFile>> type_lookup_tables_;
 
+  // Set once when the profile saver is started, read by the compiler threads. Owned by the JIT.
+  std::atomic<JitPersistentCache*> persistent_cache_;
+
   Mutex boot_completed_lock_;
   bool boot_completed_ GUARDED_BY(boot_completed_lock_) = false;
   std::deque<Task*> tasks_after_boot_ GUARDED_BY(boot_completed_lock_);
@@ -444,6 +546,33 @@ class Jit {
   Histogram<uint64_t> memory_use_ GUARDED_BY(lock_);
   Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
+  // Estimated arena memory of the compilations in flight, bounded by
+  // `kCompilationMemoryBudget` to avoid peaks of memory use from concurrent large compilations.
+  static constexpr size_t kCompilationMemoryBudget = 32 * MB;
+  Mutex compilation_memory_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  ConditionVariable compilation_memory_cond_ GUARDED_BY(compilation_memory_lock_);
+  size_t compilation_memory_in_use_ GUARDED_BY(compilation_memory_lock_);
+  size_t num_throttled_compilations_ GUARDED_BY(compilation_memory_lock_);
+
+  // The stack slots of the live dex registers at the OSR entry of a compiled method at a dex pc,
+  // decoded from the stack maps once instead of on each OSR transition.
+  struct OsrEntry {
+    // The code the entry was decoded from, valid while the code cache frees no code.
+    const void* code;
+    uint32_t code_free_generation;
+    // The native pc offset to jump to, or `kNoOsrEntry` if there is no OSR stack map at the
+    // dex pc.
+    uint32_t native_pc_offset;
+    // Pairs of dex register and frame slot index, in 32-bit words.
+    std::vector<std::pair<uint16_t, uint32_t>> vreg_slots;
+  };
+  static constexpr uint32_t kNoOsrEntry = std::numeric_limits<uint32_t>::max();
+  static constexpr size_t kMaxOsrEntries = 256u;
+  Mutex osr_entries_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::map<std::pair<ArtMethod*, uint32_t>, OsrEntry> osr_entries_ GUARDED_BY(osr_entries_lock_);
+  size_t num_osr_entry_hits_ GUARDED_BY(osr_entries_lock_);
+  size_t num_osr_entry_misses_ GUARDED_BY(osr_entries_lock_);
+
   // In the JIT zygote configuration, after all compilation is done, the zygote
   // will copy its contents of the boot image to the zygote_mapping_methods_,
   // which will be picked up by processes that will map the memory
@@ -468,6 +597,30 @@ class Jit {
   // between the zygote and apps.
   std::map<ArtMethod*, uint16_t> shared_method_counters_;
 
+  // State of the methods whose tier up to optimized code is deferred until their inline caches
+  // stop changing.
+  struct TierUpState {
+    uint64_t first_request_ns;
+    size_t inline_cache_classes;
+    uint32_t deferrals;
+  };
+  std::unordered_map<ArtMethod*, TierUpState> tier_up_states_ GUARDED_BY(lock_);
+  size_t num_tier_up_deferrals_ GUARDED_BY(lock_) = 0u;
+  size_t num_tier_up_stable_ GUARDED_BY(lock_) = 0u;
+  size_t num_tier_up_churning_ GUARDED_BY(lock_) = 0u;
+
+  // The slowest compilations, sorted by decreasing duration.
+  struct CompilationTelemetry {
+    std::string method_name;
+    CompilationKind compilation_kind;
+    uint64_t duration_ns;
+    size_t arena_bytes;
+    size_t inlined_methods;
+    size_t code_size;
+  };
+  static constexpr size_t kMaxSlowestCompilations = 16u;
+  std::vector<CompilationTelemetry> slowest_compilations_ GUARDED_BY(lock_);
+
   friend class art::jit::JitCompileTask;
 
   DISALLOW_COPY_AND_ASSIGN(Jit);
@@ -22,6 +22,7 @@
 
 #include "arch/context.h"
 #include "art_method-inl.h"
+#include "base/casts.h"
 #include "base/histogram-inl.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/membarrier.h"
@@ -51,6 +52,7 @@
 #include "jit/jit_scoped_code_cache_write.h"
 #include "linear_alloc.h"
 #include "mirror/method_type.h"
+#include "oat/jni_stub_hash_map-inl.h"
 #include "oat/oat_file-inl.h"
 #include "oat/oat_quick_method_header.h"
 #include "object_callbacks.h"
@@ -68,52 +70,18 @@ namespace jit {
 static constexpr size_t kCodeSizeLogThreshold = 50 * KB;
 static constexpr size_t kStackMapSizeLogThreshold = 50 * KB;
 
-class JitCodeCache::JniStubKey {
- public:
-  explicit JniStubKey(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_)
-      : shorty_(method->GetShorty()),
-        is_static_(method->IsStatic()),
-        is_fast_native_(method->IsFastNative()),
-        is_critical_native_(method->IsCriticalNative()),
-        is_synchronized_(method->IsSynchronized()) {
-    DCHECK(!(is_fast_native_ && is_critical_native_));
-  }
-
-  bool operator<(const JniStubKey& rhs) const {
-    if (is_static_ != rhs.is_static_) {
-      return rhs.is_static_;
-    }
-    if (is_synchronized_ != rhs.is_synchronized_) {
-      return rhs.is_synchronized_;
-    }
-    if (is_fast_native_ != rhs.is_fast_native_) {
-      return rhs.is_fast_native_;
-    }
-    if (is_critical_native_ != rhs.is_critical_native_) {
-      return rhs.is_critical_native_;
-    }
-    return strcmp(shorty_, rhs.shorty_) < 0;
-  }
-
-  // Update the shorty to point to another method's shorty. Call this function when removing
-  // the method that references the old shorty from JniCodeData and not removing the entire
-  // JniCodeData; the old shorty may become a dangling pointer when that method is unloaded.
-  void UpdateShorty(ArtMethod* method) const REQUIRES_SHARED(Locks::mutator_lock_) {
-    const char* shorty = method->GetShorty();
-    DCHECK_STREQ(shorty_, shorty);
-    shorty_ = shorty;
-  }
+// Number of entries a code cache collection unlinks or frees before releasing its locks.
+static constexpr size_t kCollectionBatchSize = 64;
 
- private:
-  // The shorty points to a DexFile data and may need to change
-  // to point to the same shorty in a different DexFile.
-  mutable const char* shorty_;
-
-  const bool is_static_;
-  const bool is_fast_native_;
-  const bool is_critical_native_;
-  const bool is_synchronized_;
-};
+// Update the key to the shorty of another method using the stub. Call this function when
+// removing the method that references the old shorty from JniStubData and not removing the
+// entire JniStubData; the old shorty may become a dangling pointer when that method is
+// unloaded. The shorty of `method` may differ from the old one, as methods with shorties
+// which need the same JNI stub share it, see `JniStubKeyEquals`.
+static void UpdateJniStubKey(JniStubKey& key, ArtMethod* method)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  key = JniStubKey(method);
+}
 
 class JitCodeCache::JniStubData {
  public:
@@ -261,9 +229,12 @@ JitCodeCache::JitCodeCache()
     : is_weak_access_enabled_(true),
       inline_cache_cond_("Jit inline cache condition variable", *Locks::jit_lock_),
       reserved_capacity_(GetInitialCapacity() * kReservedCapacityMultiplier),
+      jni_stubs_map_(JniStubKeyHash(Runtime::Current()->GetInstructionSet()),
+                     JniStubKeyEquals(Runtime::Current()->GetInstructionSet())),
       zygote_map_(&shared_region_),
       lock_cond_("Jit code cache condition variable", *Locks::jit_lock_),
       collection_in_progress_(false),
+      code_free_generation_(0u),
       garbage_collect_code_(true),
       number_of_baseline_compilations_(0),
       number_of_optimized_compilations_(0),
@@ -365,6 +336,12 @@ bool JitCodeCache::WaitForPotentialCollectionToComplete(Thread* self) {
   return in_collection;
 }
 
+void JitCodeCache::WaitForPotentialMarkingToComplete(Thread* self) {
+  while (live_bitmap_ != nullptr) {
+    lock_cond_.Wait(self);
+  }
+}
+
 static uintptr_t FromCodeToAllocation(const void* code) {
   size_t alignment = GetInstructionSetCodeAlignment(kRuntimeQuickCodeISA);
   return reinterpret_cast<uintptr_t>(code) - RoundUp(sizeof(OatQuickMethodHeader), alignment);
@@ -486,6 +463,8 @@ void JitCodeCache::FreeCodeAndData(const void* code_ptr) {
     // No need to free, this is shared memory.
     return;
   }
+  // Invalidate data cached for `code_ptr` before the memory can be reused.
+  code_free_generation_.fetch_add(1u, std::memory_order_release);
   uintptr_t allocation = FromCodeToAllocation(code_ptr);
   const uint8_t* data = nullptr;
   if (OatQuickMethodHeader::FromCodePointer(code_ptr)->IsOptimized()) {
@@ -565,7 +544,7 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
         method_headers.insert(OatQuickMethodHeader::FromCodePointer(it->second.GetCode()));
         it = jni_stubs_map_.erase(it);
       } else {
-        it->first.UpdateShorty(it->second.GetMethods().front());
+        UpdateJniStubKey(it->first, it->second.GetMethods().front());
         ++it;
       }
     }
@@ -893,7 +872,7 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
         }
         jni_stubs_map_.erase(it);
       } else {
-        it->first.UpdateShorty(it->second.GetMethods().front());
+        UpdateJniStubKey(it->first, it->second.GetMethods().front());
       }
       zombie_jni_code_.erase(method);
       processed_zombie_jni_code_.erase(method);
@@ -1148,9 +1127,9 @@ bool JitCodeCache::IsAtMaxCapacity() const {
 void JitCodeCache::IncreaseCodeCacheCapacity(Thread* self) {
   ScopedThreadSuspension sts(self, ThreadState::kSuspended);
   MutexLock mu(self, *Locks::jit_lock_);
-  // Wait for a potential collection, as the size of the bitmap used by that collection
-  // is of the current capacity.
-  WaitForPotentialCollectionToComplete(self);
+  // Wait for the marking of a potential collection, as the size of the bitmap used by that
+  // collection is of the current capacity. The sweeping of the collection does not need it.
+  WaitForPotentialMarkingToComplete(self);
   private_region_.IncreaseCodeCacheCapacity();
 }
 
@@ -1158,19 +1137,26 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
   ScopedTrace trace(__FUNCTION__);
   std::unordered_set<OatQuickMethodHeader*> method_headers;
   ScopedDebugDisallowReadBarriers sddrb(self);
-  MutexLock mu(self, *Locks::jit_lock_);
-  // Iterate over all zombie code and remove entries that are not marked.
-  for (auto it = processed_zombie_code_.begin(); it != processed_zombie_code_.end();) {
-    const void* code_ptr = *it;
-    uintptr_t allocation = FromCodeToAllocation(code_ptr);
-    DCHECK(!IsInZygoteExecSpace(code_ptr));
-    if (GetLiveBitmap()->Test(allocation)) {
-      ++it;
-    } else {
-      OatQuickMethodHeader* header = OatQuickMethodHeader::FromCodePointer(code_ptr);
-      method_headers.insert(header);
-      {
-        WriterMutexLock mu2(self, *Locks::jit_mutator_lock_);
+  {
+    MutexLock mu(self, *Locks::jit_lock_);
+    // Iterate over all zombie code and unlink entries that are not marked. Entries are
+    // unlinked in batches, so that `LookupMethodHeader` callers only wait for one batch.
+    auto it = processed_zombie_code_.begin();
+    while (it != processed_zombie_code_.end()) {
+      WriterMutexLock mu2(self, *Locks::jit_mutator_lock_);
+      for (size_t count = 0;
+           count != kCollectionBatchSize && it != processed_zombie_code_.end();
+           ++count) {
+        const void* code_ptr = *it;
+        uintptr_t allocation = FromCodeToAllocation(code_ptr);
+        DCHECK(!IsInZygoteExecSpace(code_ptr));
+        if (GetLiveBitmap()->Test(allocation)) {
+          // Still on a thread stack, keep it for the next collection.
+          ++it;
+          continue;
+        }
+        OatQuickMethodHeader* header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+        method_headers.insert(header);
         auto method_it = method_code_map_.find(header->GetCode());
 
         if (method_it != method_code_map_.end()) {
@@ -1188,36 +1174,77 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
         }
 
         method_code_map_.erase(header->GetCode());
+        VLOG(jit) << "JIT removed " << *it;
+        it = processed_zombie_code_.erase(it);
       }
-      VLOG(jit) << "JIT removed " << *it;
-      it = processed_zombie_code_.erase(it);
     }
-  }
-  for (auto it = processed_zombie_jni_code_.begin(); it != processed_zombie_jni_code_.end();) {
-    WriterMutexLock mu2(self, *Locks::jit_mutator_lock_);
-    ArtMethod* method = *it;
-    auto stub = jni_stubs_map_.find(JniStubKey(method));
-    DCHECK(stub != jni_stubs_map_.end()) << method->PrettyMethod();
-    JniStubData& data = stub->second;
-    DCHECK(data.IsCompiled());
-    DCHECK(ContainsElement(data.GetMethods(), method));
-    if (!GetLiveBitmap()->Test(FromCodeToAllocation(data.GetCode()))) {
-      data.RemoveMethod(method);
-      if (data.GetMethods().empty()) {
-        OatQuickMethodHeader* header = OatQuickMethodHeader::FromCodePointer(data.GetCode());
-        method_headers.insert(header);
-        CHECK(ContainsPc(header));
-        VLOG(jit) << "JIT removed native code of" << method->PrettyMethod();
-        jni_stubs_map_.erase(stub);
+    for (auto it = processed_zombie_jni_code_.begin(); it != processed_zombie_jni_code_.end();) {
+      WriterMutexLock mu2(self, *Locks::jit_mutator_lock_);
+      ArtMethod* method = *it;
+      auto stub = jni_stubs_map_.find(JniStubKey(method));
+      DCHECK(stub != jni_stubs_map_.end()) << method->PrettyMethod();
+      JniStubData& data = stub->second;
+      DCHECK(data.IsCompiled());
+      DCHECK(ContainsElement(data.GetMethods(), method));
+      if (!GetLiveBitmap()->Test(FromCodeToAllocation(data.GetCode()))) {
+        data.RemoveMethod(method);
+        if (data.GetMethods().empty()) {
+          OatQuickMethodHeader* header = OatQuickMethodHeader::FromCodePointer(data.GetCode());
+          method_headers.insert(header);
+          CHECK(ContainsPc(header));
+          VLOG(jit) << "JIT removed native code of" << method->PrettyMethod();
+          jni_stubs_map_.erase(stub);
+        } else {
+          UpdateJniStubKey(stub->first, stub->second.GetMethods().front());
+        }
+        it = processed_zombie_jni_code_.erase(it);
       } else {
-        stub->first.UpdateShorty(stub->second.GetMethods().front());
+        ++it;
       }
-      it = processed_zombie_jni_code_.erase(it);
-    } else {
-      ++it;
     }
+
+    // The code is unreachable from now on: remove its debug info before it gets freed, so
+    // that the debug info keeps matching the compiled methods.
+    for (const OatQuickMethodHeader* header : method_headers) {
+      RemoveNativeDebugInfoForJit(header->GetCode());
+    }
+
+    // We are done with the marking. Let threads waiting to grow the code cache proceed while
+    // we free the unmarked code.
+    live_bitmap_.reset(nullptr);
+    lock_cond_.Broadcast(self);
   }
-  FreeAllMethodHeaders(method_headers);
+  FreeUnlinkedMethodHeaders(self, method_headers);
+}
+
+void JitCodeCache::FreeUnlinkedMethodHeaders(
+    Thread* self, const std::unordered_set<OatQuickMethodHeader*>& method_headers) {
+  if (method_headers.empty()) {
+    return;
+  }
+  // Remove CHA dependencies first, as once the code is freed, the memory can be reused.
+  {
+    MutexLock mu(self, *Locks::cha_lock_);
+    Runtime::Current()->GetClassLinker()->GetClassHierarchyAnalysis()
+        ->RemoveDependentsWithMethodHeaders(method_headers);
+  }
+
+  // Free in batches, to not hold the JIT lock against compiler threads and mutators for the
+  // whole collection.
+  std::vector<const OatQuickMethodHeader*> headers(method_headers.begin(), method_headers.end());
+  for (size_t begin = 0; begin < headers.size(); begin += kCollectionBatchSize) {
+    size_t end = std::min(begin + kCollectionBatchSize, headers.size());
+    MutexLock mu(self, *Locks::jit_lock_);
+    ScopedCodeCacheWrite scc(private_region_);
+    for (size_t i = begin; i != end; ++i) {
+      FreeCodeAndData(headers[i]->GetCode());
+    }
+  }
+
+  // We have potentially removed a lot of debug info. Do maintenance pass to save space.
+  MutexLock mu(self, *Locks::jit_lock_);
+  ScopedCodeCacheWrite scc(private_region_);
+  RepackNativeDebugInfoForJit();
 }
 
 class JitGcTask final : public Task {
@@ -1362,9 +1389,14 @@ void JitCodeCache::DoCollection(Thread* self) {
 
     gc_task_scheduled_ = false;
     MutexLock mu(self, *Locks::jit_lock_);
-    live_bitmap_.reset(nullptr);
+    DCHECK(live_bitmap_ == nullptr);
     collection_in_progress_ = false;
     lock_cond_.Broadcast(self);
+    if (VLOG_IS_ON(jit)) {
+      JitMemoryRegion::FragmentationInfo info = private_region_.GetCodeFragmentation();
+      VLOG(jit) << "JIT code cache fragmentation after collection: "
+                << info.GetFragmentationPercent() << "%, " << info.free_chunks << " free chunks";
+    }
   }
 
   Runtime::Current()->GetJit()->AddTimingLogger(logger);
@@ -1410,6 +1442,12 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
       if (code_ptr != nullptr) {
         return OatQuickMethodHeader::FromCodePointer(code_ptr);
       }
+    } else if (!kIsDebugBuild) {
+      // Debug builds check the method found in `method_code_map_` below.
+      method_header = LookupCachedMethodHeader(pc);
+      if (method_header != nullptr) {
+        return method_header;
+      }
     }
     {
       ReaderMutexLock mu(self, *Locks::jit_mutator_lock_);
@@ -1423,6 +1461,9 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
         if (OatQuickMethodHeader::FromCodePointer(code_ptr)->Contains(pc)) {
           method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
           found_method = it->second;
+          if (PrivateRegionContainsPc(pc_ptr)) {
+            CacheMethodHeader(pc, method_header);
+          }
         }
       }
     }
@@ -1452,6 +1493,42 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
   return method_header;
 }
 
+OatQuickMethodHeader* JitCodeCache::LookupCachedMethodHeader(uintptr_t pc) {
+  uint32_t generation = GetCodeFreeGeneration();
+  if (UNLIKELY(method_header_cache_generation_.load(std::memory_order_acquire) != generation)) {
+    // Some code was freed and cached entries may refer to it. Racing lookups may clear the
+    // cache too, and racing insertions are for live code, so they can be kept.
+    for (std::atomic<uint64_t>& entry : method_header_cache_) {
+      entry.store(0u, std::memory_order_relaxed);
+    }
+    method_header_cache_generation_.store(generation, std::memory_order_release);
+    return nullptr;
+  }
+  uintptr_t begin = reinterpret_cast<uintptr_t>(private_region_.GetExecPages()->Begin());
+  uint32_t pc_offset = dchecked_integral_cast<uint32_t>(pc - begin);
+  uint64_t entry =
+      method_header_cache_[(pc_offset >> 2) % kMethodHeaderCacheSize].load(
+          std::memory_order_relaxed);
+  if (entry == 0u || static_cast<uint32_t>(entry) != pc_offset) {
+    return nullptr;
+  }
+  const void* code_ptr = reinterpret_cast<const void*>(begin + static_cast<uint32_t>(entry >> 32));
+  OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+  DCHECK(method_header->Contains(pc));
+  return method_header;
+}
+
+void JitCodeCache::CacheMethodHeader(uintptr_t pc, const OatQuickMethodHeader* method_header) {
+  uintptr_t begin = reinterpret_cast<uintptr_t>(private_region_.GetExecPages()->Begin());
+  uint32_t pc_offset = dchecked_integral_cast<uint32_t>(pc - begin);
+  uint32_t code_offset = dchecked_integral_cast<uint32_t>(
+      reinterpret_cast<uintptr_t>(method_header->GetCode()) - begin);
+  // The code follows its header in the exec pages, so a valid entry is never zero.
+  DCHECK_NE(code_offset, 0u);
+  method_header_cache_[(pc_offset >> 2) % kMethodHeaderCacheSize].store(
+      (static_cast<uint64_t>(code_offset) << 32) | pc_offset, std::memory_order_relaxed);
+}
+
 OatQuickMethodHeader* JitCodeCache::LookupOsrMethodHeader(ArtMethod* method) {
   Thread* self = Thread::Current();
   ScopedDebugDisallowReadBarriers sddrb(self);
@@ -1690,7 +1767,7 @@ bool JitCodeCache::NotifyCompilationOf(ArtMethod* method,
     bool new_compilation = false;
     if (it == jni_stubs_map_.end()) {
       // Create a new entry to mark the stub as being compiled.
-      it = jni_stubs_map_.Put(key, JniStubData{});
+      it = jni_stubs_map_.insert(std::make_pair(key, JniStubData{})).first;
       new_compilation = true;
     }
     JniStubData* data = &it->second;
@@ -1832,6 +1909,14 @@ void JitCodeCache::InvalidateCompiledCodeFor(ArtMethod* method,
   }
 }
 
+static void DumpFragmentation(std::ostream& os,
+                              const char* name,
+                              const JitMemoryRegion::FragmentationInfo& info) {
+  os << "Current JIT " << name << " cache fragmentation: " << info.GetFragmentationPercent()
+     << "% (" << PrettySize(info.free_bytes) << " free in " << info.free_chunks
+     << " chunks, largest " << PrettySize(info.largest_free_chunk) << ")\n";
+}
+
 void JitCodeCache::Dump(std::ostream& os) {
   MutexLock mu(Thread::Current(), *Locks::jit_lock_);
   os << "Current JIT code cache size (used / resident): "
@@ -1840,6 +1925,8 @@ void JitCodeCache::Dump(std::ostream& os) {
      << "Current JIT data cache size (used / resident): "
      << GetCurrentRegion()->GetUsedMemoryForData() / KB << "KB / "
      << GetCurrentRegion()->GetResidentMemoryForData() / KB << "KB\n";
+  DumpFragmentation(os, "code", GetCurrentRegion()->GetCodeFragmentation());
+  DumpFragmentation(os, "data", GetCurrentRegion()->GetDataFragmentation());
   if (!Runtime::Current()->IsZygote()) {
     os << "Zygote JIT code cache size (at point of fork): "
        << shared_region_.GetUsedMemoryForCode() / KB << "KB / "
@@ -1920,6 +2007,9 @@ void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
   histogram_code_memory_use_.Reset();
   histogram_profiling_info_memory_use_.Reset();
 
+  // Invalidate data cached for the code of the private region, which is replaced below.
+  code_free_generation_.fetch_add(1u, std::memory_order_release);
+
   size_t initial_capacity = runtime->GetJITOptions()->GetCodeCacheInitialCapacity();
   size_t max_capacity = runtime->GetJITOptions()->GetCodeCacheMaxCapacity();
   std::string error_msg;
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
 #define ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <iosfwd>
 #include <memory>
@@ -36,6 +38,7 @@
 #include "base/safe_map.h"
 #include "compilation_kind.h"
 #include "jit_memory_region.h"
+#include "oat/jni_stub_hash_map.h"
 #include "profiling_info.h"
 
 namespace art HIDDEN {
@@ -303,6 +306,12 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return a counter incremented each time code is freed. Data derived from a code pointer can
+  // be cached along with the counter, and is valid while the counter does not change.
+  uint32_t GetCodeFreeGeneration() const {
+    return code_free_generation_.load(std::memory_order_acquire);
+  }
+
   // Removes method from the cache for testing purposes. The caller
   // must ensure that all threads are suspended and the method should
   // not be in any thread's stack.
@@ -436,6 +445,12 @@ class JitCodeCache {
  private:
   JitCodeCache();
 
+  // Look up `pc` in the private region in `method_header_cache_`. Return null on a miss.
+  OatQuickMethodHeader* LookupCachedMethodHeader(uintptr_t pc);
+
+  // Record that `pc` is in the private region code of `method_header`.
+  void CacheMethodHeader(uintptr_t pc, const OatQuickMethodHeader* method_header);
+
   void AddZombieCodeInternal(ArtMethod* method, const void* code_ptr)
       REQUIRES(Locks::jit_mutator_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -452,6 +467,10 @@ class JitCodeCache {
   bool WaitForPotentialCollectionToComplete(Thread* self)
       REQUIRES(Locks::jit_lock_) REQUIRES_SHARED(!Locks::mutator_lock_);
 
+  // If a collection is marking code, wait for it to release its live bitmap.
+  void WaitForPotentialMarkingToComplete(Thread* self)
+      REQUIRES(Locks::jit_lock_) REQUIRES_SHARED(!Locks::mutator_lock_);
+
   // Remove CHA dependents and underlying allocations for entries in `method_headers`.
   void FreeAllMethodHeaders(const std::unordered_set<OatQuickMethodHeader*>& method_headers)
       REQUIRES(Locks::jit_lock_)
@@ -486,10 +505,19 @@ class JitCodeCache {
   // Return whether the code cache's capacity is at its maximum.
   bool IsAtMaxCapacity() const REQUIRES(Locks::jit_lock_);
 
+  // Unlink the zombie code that was not marked, then free it. Code still on a thread stack
+  // is kept for the next collection.
   void RemoveUnmarkedCode(Thread* self)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Remove CHA dependents and underlying allocations for entries in `method_headers`, which
+  // are no longer reachable from the code cache maps. Takes the JIT lock in batches.
+  void FreeUnlinkedMethodHeaders(Thread* self,
+                                 const std::unordered_set<OatQuickMethodHeader*>& method_headers)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES(!Locks::cha_lock_);
+
   void MarkCompiledCodeOnThreadStacks(Thread* self)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -513,7 +541,6 @@ class JitCodeCache {
 
   EXPORT const uint8_t* GetRootTable(const void* code_ptr, uint32_t* number_of_roots = nullptr);
 
-  class JniStubKey;
   class JniStubData;
 
   // Whether the GC allows accessing weaks in inline caches. Note that this
@@ -548,8 +575,9 @@ class JitCodeCache {
   // The GC must ensure that methods in these maps are cleaned up with `RemoveMethodsIn()`
   // before the declaring class memory is freed.
 
-  // Holds compiled code associated with the shorty for a JNI stub.
-  SafeMap<JniStubKey, JniStubData> jni_stubs_map_ GUARDED_BY(Locks::jit_mutator_lock_);
+  // Holds compiled code associated with the shorty for a JNI stub. Methods whose shorties
+  // need the same JNI stub on the target instruction set share the entry.
+  JniStubHashMap<JniStubData> jni_stubs_map_ GUARDED_BY(Locks::jit_mutator_lock_);
 
   // Holds compiled code associated to the ArtMethod.
   SafeMap<const void*, ArtMethod*> method_code_map_ GUARDED_BY(Locks::jit_mutator_lock_);
@@ -585,10 +613,25 @@ class JitCodeCache {
   // Whether there is a code cache collection in progress.
   bool collection_in_progress_ GUARDED_BY(Locks::jit_lock_);
 
+  // Incremented when code is freed, see `GetCodeFreeGeneration()`.
+  std::atomic<uint32_t> code_free_generation_;
+
+  // Lock-free cache of the method headers found by `LookupMethodHeader()` for return pcs in the
+  // private region, so that stack walks do not take the `jit_mutator_lock_` and search the
+  // `method_code_map_` for each JIT-compiled frame whose code is not the method's entrypoint.
+  // An entry packs the offsets of the pc and of the code from the start of the exec pages, so
+  // that it is read and written atomically, and zero is an empty entry. Code containing a pc
+  // that is on a thread stack is not freed, so entries remain valid until code is freed; the
+  // cache is then cleared by the next lookup, as seen by `method_header_cache_generation_`
+  // differing from `code_free_generation_`.
+  static constexpr size_t kMethodHeaderCacheSize = 1024;
+  std::array<std::atomic<uint64_t>, kMethodHeaderCacheSize> method_header_cache_ = {};
+  std::atomic<uint32_t> method_header_cache_generation_ = 0u;
+
   // Whether a GC task is already scheduled.
   std::atomic<bool> gc_task_scheduled_;
 
-  // Bitmap for collecting code and data.
+  // Bitmap for collecting code and data. Only set while a collection is marking code.
   std::unique_ptr<CodeCacheBitmap> live_bitmap_;
 
   // Whether we can do garbage collection. Not 'const' as tests may override this.
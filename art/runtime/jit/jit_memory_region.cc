@@ -19,6 +19,8 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>
+
 #include <android-base/unique_fd.h>
 #include <log/log.h>
 #include "base/bit_utils.h"  // For RoundDown, RoundUp
@@ -463,6 +465,27 @@ bool JitMemoryRegion::CommitData(ArrayRef<const uint8_t> reserved_data,
   return true;
 }
 
+// Callback for mspace_inspect_all that will accumulate the free chunks.
+static void FragmentationCallback(void* start, void* end, size_t used_bytes, void* arg) {
+  if (used_bytes != 0) {
+    return;
+  }
+  JitMemoryRegion::FragmentationInfo* info =
+      reinterpret_cast<JitMemoryRegion::FragmentationInfo*>(arg);
+  size_t size = reinterpret_cast<uint8_t*>(end) - reinterpret_cast<uint8_t*>(start);
+  info->free_bytes += size;
+  info->free_chunks++;
+  info->largest_free_chunk = std::max(info->largest_free_chunk, size);
+}
+
+JitMemoryRegion::FragmentationInfo JitMemoryRegion::GetFragmentation(void* mspace) {
+  FragmentationInfo info;
+  if (mspace != nullptr) {
+    mspace_inspect_all(mspace, FragmentationCallback, &info);
+  }
+  return info;
+}
+
 const uint8_t* JitMemoryRegion::AllocateCode(size_t size) {
   size_t alignment = GetInstructionSetCodeAlignment(kRuntimeISA);
   void* result = mspace_memalign(exec_mspace_, alignment, size);
@@ -179,6 +179,26 @@ class JitMemoryRegion {
     return data_end_;
   }
 
+  // Free memory statistics of the code or data space, to measure its fragmentation.
+  struct FragmentationInfo {
+    size_t free_bytes = 0u;
+    size_t free_chunks = 0u;
+    size_t largest_free_chunk = 0u;
+
+    // Percentage of the free memory which is not in the largest free chunk.
+    size_t GetFragmentationPercent() const {
+      return free_bytes == 0u ? 0u : 100u - (largest_free_chunk * 100u) / free_bytes;
+    }
+  };
+
+  FragmentationInfo GetCodeFragmentation() REQUIRES(Locks::jit_lock_) {
+    return GetFragmentation(exec_mspace_);
+  }
+
+  FragmentationInfo GetDataFragmentation() REQUIRES(Locks::jit_lock_) {
+    return GetFragmentation(data_mspace_);
+  }
+
   template <typename T> T* GetWritableDataAddress(const T* src_ptr) {
     if (!HasDualDataMapping()) {
       return const_cast<T*>(src_ptr);
@@ -187,6 +207,8 @@ class JitMemoryRegion {
   }
 
  private:
+  static FragmentationInfo GetFragmentation(void* mspace);
+
   template <typename T>
   T* TranslateAddress(T* src_ptr, const MemMap& src, const MemMap& dst) {
     CHECK(src.HasAddress(src_ptr)) << reinterpret_cast<const void*>(src_ptr);
@@ -48,6 +48,14 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   jit_options->use_jit_compilation_ = options.GetOrDefault(RuntimeArgumentMap::UseJitCompilation);
   jit_options->use_profiled_jit_compilation_ =
       options.GetOrDefault(RuntimeArgumentMap::UseProfiledJitCompilation);
+  jit_options->use_persistent_cache_ =
+      options.GetOrDefault(RuntimeArgumentMap::UseJitPersistentCache);
+  jit_options->use_startup_profile_jit_compilation_ =
+      options.GetOrDefault(RuntimeArgumentMap::UseStartupProfileJitCompilation);
+  jit_options->prefetch_startup_classes_ =
+      options.GetOrDefault(RuntimeArgumentMap::PrefetchStartupClasses);
+  jit_options->sampling_hotness_period_ms_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITSamplingHotnessPeriodMs);
 
   jit_options->code_cache_initial_capacity_ =
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheInitialCapacity);
@@ -61,6 +69,7 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadPthreadPriority);
   jit_options->zygote_thread_pool_pthread_priority_ =
       options.GetOrDefault(RuntimeArgumentMap::JITZygotePoolThreadPthreadPriority);
+  jit_options->zygote_profile_ = options.GetOrDefault(RuntimeArgumentMap::JITZygoteProfile);
 
   // Set default optimize threshold to aid with checking defaults.
   jit_options->optimize_threshold_ = kIsDebugBuild
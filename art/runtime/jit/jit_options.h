@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_JIT_JIT_OPTIONS_H_
 #define ART_RUNTIME_JIT_JIT_OPTIONS_H_
 
+#include <string>
+
 #include "base/macros.h"
 #include "base/runtime_debug.h"
 #include "profile_saver_options.h"
@@ -93,6 +95,42 @@ class JitOptions {
     return use_profiled_jit_compilation_;
   }
 
+  bool UsePersistentCache() const {
+    return use_persistent_cache_;
+  }
+
+  // Whether to baseline compile at launch the startup methods of the app profile which have no
+  // AOT code.
+  bool UseStartupProfileJitCompilation() const {
+    return use_startup_profile_jit_compilation_;
+  }
+
+  // Whether to load, link and verify at launch the classes of the app profile on the JIT
+  // thread pool, ahead of the main thread.
+  bool PrefetchStartupClasses() const {
+    return prefetch_startup_classes_;
+  }
+
+  // Whether the profile saver gets the non-hot methods of the profile by periodically sampling
+  // the thread stacks, instead of from the hotness counters of the methods. In that mode, all
+  // methods count invocations like memory shared methods, and the counters are not written.
+  bool UseSamplingHotness() const {
+    return sampling_hotness_period_ms_ != 0u;
+  }
+
+  // The period of the stack sampling, in milliseconds. 0 if sampling hotness is disabled.
+  uint32_t GetSamplingHotnessPeriodMs() const {
+    return sampling_hotness_period_ms_;
+  }
+
+  // A boot classpath profile aggregated from the profiles of the running apps, for instance by
+  // merging the boot classpath methods they record with `-Xps-profile-boot-class-path`. In JIT
+  // zygote mode, the zygote compiles its methods in the shared region, in addition to the
+  // methods of the boot image profiles. Empty if none.
+  const std::string& GetZygoteProfile() const {
+    return zygote_profile_;
+  }
+
   void SetUseJitCompilation(bool b) {
     use_jit_compilation_ = b;
   }
@@ -125,6 +163,10 @@ class JitOptions {
 
   bool use_jit_compilation_;
   bool use_profiled_jit_compilation_;
+  bool use_persistent_cache_;
+  bool use_startup_profile_jit_compilation_;
+  bool prefetch_startup_classes_;
+  uint32_t sampling_hotness_period_ms_;
   bool use_baseline_compiler_;
   size_t code_cache_initial_capacity_;
   size_t code_cache_max_capacity_;
@@ -135,11 +177,16 @@ class JitOptions {
   bool dump_info_on_shutdown_;
   int thread_pool_pthread_priority_;
   int zygote_thread_pool_pthread_priority_;
+  std::string zygote_profile_;
   ProfileSaverOptions profile_saver_options_;
 
   JitOptions()
       : use_jit_compilation_(false),
         use_profiled_jit_compilation_(false),
+        use_persistent_cache_(false),
+        use_startup_profile_jit_compilation_(false),
+        prefetch_startup_classes_(false),
+        sampling_hotness_period_ms_(0u),
         use_baseline_compiler_(false),
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
@@ -0,0 +1,400 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_persistent_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <map>
+#include <ostream>
+
+#include "android-base/file.h"
+#include "android-base/stringprintf.h"
+#include "zlib.h"
+
+#include "arch/instruction_set.h"
+#include "art_method-inl.h"
+#include "base/arena_allocator.h"
+#include "base/arena_containers.h"
+#include "base/casts.h"
+#include "base/logging.h"
+#include "base/time_utils.h"
+#include "class_linker.h"
+#include "dex/dex_file.h"
+#include "entrypoints/runtime_asm_entrypoints.h"
+#include "gc/heap.h"
+#include "gc/space/image_space.h"
+#include "handle_scope-inl.h"
+#include "instrumentation.h"
+#include "jit/jit_code_cache.h"
+#include "mirror/class_loader.h"
+#include "mirror/dex_cache-inl.h"
+#include "oat/oat.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+
+namespace art HIDDEN {
+namespace jit {
+
+namespace {
+
+constexpr char kMagic[4] = { 'j', 'p', 'c', '\n' };
+constexpr uint32_t kVersion = 1u;
+
+void AppendU32(std::string* out, uint32_t value) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendBytes(std::string* out, const void* data, size_t size) {
+  AppendU32(out, dchecked_integral_cast<uint32_t>(size));
+  out->append(reinterpret_cast<const char*>(data), size);
+}
+
+class Reader {
+ public:
+  Reader(const char* begin, const char* end) : pos_(begin), end_(end) {}
+
+  bool ReadU32(uint32_t* value) {
+    if (static_cast<size_t>(end_ - pos_) < sizeof(*value)) {
+      return false;
+    }
+    memcpy(value, pos_, sizeof(*value));
+    pos_ += sizeof(*value);
+    return true;
+  }
+
+  template <typename Container>
+  bool ReadBytes(Container* out) {
+    uint32_t size;
+    if (!ReadU32(&size) || static_cast<size_t>(end_ - pos_) < size) {
+      return false;
+    }
+    out->assign(pos_, pos_ + size);
+    pos_ += size;
+    return true;
+  }
+
+  bool IsAtEnd() const {
+    return pos_ == end_;
+  }
+
+ private:
+  const char* pos_;
+  const char* const end_;
+};
+
+}  // namespace
+
+JitPersistentCache::JitPersistentCache(const std::string& filename)
+    : filename_(filename),
+      lock_("JIT persistent cache lock"),
+      recorded_bytes_(0u),
+      num_dropped_(0u),
+      num_loaded_(0u),
+      num_installed_(0u) {}
+
+std::string JitPersistentCache::GetKey() {
+  Runtime* runtime = Runtime::Current();
+  const std::vector<gc::space::ImageSpace*>& image_spaces =
+      runtime->GetHeap()->GetBootImageSpaces();
+  const std::vector<const DexFile*>& boot_class_path =
+      runtime->GetClassLinker()->GetBootClassPath();
+  std::string key = android::base::StringPrintf(
+      "oat=%s isa=%s debuggable=%d native-debuggable=%d bcp=",
+      OatHeader::kOatVersion.data(),
+      GetInstructionSetString(kRuntimeISA),
+      runtime->IsJavaDebuggable() ? 1 : 0,
+      runtime->IsNativeDebuggable() ? 1 : 0);
+  key += gc::space::ImageSpace::GetBootClassPathChecksums(
+      ArrayRef<gc::space::ImageSpace* const>(image_spaces),
+      ArrayRef<const DexFile* const>(boot_class_path));
+  return key;
+}
+
+void JitPersistentCache::AddEntryLocked(Entry&& entry) {
+  size_t size = entry.code.size() + entry.stack_map.size();
+  if (recorded_bytes_ + size > kMaxRecordedBytes) {
+    ++num_dropped_;
+    return;
+  }
+  if (!recorded_methods_.emplace(entry.dex_location, entry.method_index).second) {
+    // Already recorded, e.g. recompiled after a deoptimization. Keep the first version.
+    return;
+  }
+  recorded_bytes_ += size;
+  entries_.push_back(std::move(entry));
+}
+
+void JitPersistentCache::Record(ArtMethod* method,
+                                ArrayRef<const uint8_t> code,
+                                ArrayRef<const uint8_t> stack_map) {
+  const DexFile* dex_file = method->GetDexFile();
+  Entry entry;
+  entry.dex_location = dex_file->GetLocation();
+  entry.dex_checksum = dex_file->GetLocationChecksum();
+  entry.method_index = method->GetDexMethodIndex();
+  entry.code.assign(code.begin(), code.end());
+  entry.stack_map.assign(stack_map.begin(), stack_map.end());
+  MutexLock mu(Thread::Current(), lock_);
+  AddEntryLocked(std::move(entry));
+}
+
+bool JitPersistentCache::Save(std::string* error_msg) {
+  std::string key;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    key = GetKey();
+  }
+  std::string contents(kMagic, sizeof(kMagic));
+  AppendU32(&contents, kVersion);
+  AppendBytes(&contents, key.data(), key.size());
+  size_t num_entries;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    num_entries = entries_.size();
+    AppendU32(&contents, dchecked_integral_cast<uint32_t>(num_entries));
+    for (const Entry& entry : entries_) {
+      AppendBytes(&contents, entry.dex_location.data(), entry.dex_location.size());
+      AppendU32(&contents, entry.dex_checksum);
+      AppendU32(&contents, entry.method_index);
+      AppendBytes(&contents, entry.code.data(), entry.code.size());
+      AppendBytes(&contents, entry.stack_map.data(), entry.stack_map.size());
+    }
+  }
+  uint32_t checksum = adler32(0L, Z_NULL, 0);
+  checksum = adler32(checksum, reinterpret_cast<const Bytef*>(contents.data()), contents.size());
+  AppendU32(&contents, checksum);
+
+  // Write to a temporary file and rename it, so that a concurrent or interrupted save never
+  // leaves a truncated file behind.
+  std::string temp_filename = filename_ + ".tmp";
+  if (!android::base::WriteStringToFile(contents, temp_filename)) {
+    *error_msg = android::base::StringPrintf(
+        "Could not write %s: %s", temp_filename.c_str(), strerror(errno));
+    return false;
+  }
+  if (rename(temp_filename.c_str(), filename_.c_str()) != 0) {
+    *error_msg = android::base::StringPrintf(
+        "Could not rename %s: %s", temp_filename.c_str(), strerror(errno));
+    unlink(temp_filename.c_str());
+    return false;
+  }
+  VLOG(jit) << "Saved " << num_entries << " methods to JIT persistent cache " << filename_;
+  return true;
+}
+
+bool JitPersistentCache::Parse(const std::string& contents,
+                               const std::string& key,
+                               /*out*/ std::vector<Entry>* entries,
+                               /*out*/ std::string* error_msg) {
+  if (contents.size() < sizeof(kMagic) + sizeof(uint32_t) ||
+      memcmp(contents.data(), kMagic, sizeof(kMagic)) != 0) {
+    *error_msg = "Bad magic";
+    return false;
+  }
+  size_t checked_size = contents.size() - sizeof(uint32_t);
+  uint32_t expected_checksum;
+  memcpy(&expected_checksum, contents.data() + checked_size, sizeof(expected_checksum));
+  uint32_t checksum = adler32(0L, Z_NULL, 0);
+  checksum = adler32(checksum, reinterpret_cast<const Bytef*>(contents.data()), checked_size);
+  if (checksum != expected_checksum) {
+    *error_msg = "Bad checksum";
+    return false;
+  }
+  Reader reader(contents.data() + sizeof(kMagic), contents.data() + checked_size);
+  uint32_t version;
+  std::string file_key;
+  if (!reader.ReadU32(&version) || version != kVersion) {
+    *error_msg = "Bad version";
+    return false;
+  }
+  if (!reader.ReadBytes(&file_key) || file_key != key) {
+    *error_msg = "Stale runtime configuration: " + file_key;
+    return false;
+  }
+  uint32_t num_entries;
+  if (!reader.ReadU32(&num_entries)) {
+    *error_msg = "Truncated header";
+    return false;
+  }
+  entries->reserve(num_entries);
+  for (uint32_t i = 0; i != num_entries; ++i) {
+    Entry entry;
+    if (!reader.ReadBytes(&entry.dex_location) ||
+        !reader.ReadU32(&entry.dex_checksum) ||
+        !reader.ReadU32(&entry.method_index) ||
+        !reader.ReadBytes(&entry.code) ||
+        !reader.ReadBytes(&entry.stack_map)) {
+      *error_msg = android::base::StringPrintf("Truncated entry %u", i);
+      return false;
+    }
+    entries->push_back(std::move(entry));
+  }
+  if (!reader.IsAtEnd()) {
+    *error_msg = "Trailing data";
+    return false;
+  }
+  return true;
+}
+
+bool JitPersistentCache::Install(Thread* self,
+                                 JitCodeCache* code_cache,
+                                 ArtMethod* method,
+                                 const Entry& entry) {
+  Runtime* runtime = Runtime::Current();
+  ClassLinker* class_linker = runtime->GetClassLinker();
+  if (!method->IsCompilable() || !method->IsInvokable() || method->IsNative()) {
+    return false;
+  }
+  // Only replace the interpreter, do not override code from the oat file or the code cache.
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  if (!class_linker->IsQuickToInterpreterBridge(entry_point) &&
+      !class_linker->IsNterpEntryPoint(entry_point) &&
+      entry_point != GetQuickResolutionStub()) {
+    return false;
+  }
+  instrumentation::Instrumentation* instrumentation = runtime->GetInstrumentation();
+  if (instrumentation->AreAllMethodsDeoptimized() || instrumentation->IsDeoptimized(method)) {
+    return false;
+  }
+  JitMemoryRegion* region = code_cache->GetCurrentRegion();
+  if (code_cache->IsSharedRegion(*region)) {
+    return false;
+  }
+  if (!code_cache->NotifyCompilationOf(
+          method, self, CompilationKind::kOptimized, /*prejit=*/ true)) {
+    return false;
+  }
+  bool success = false;
+  ArrayRef<const uint8_t> reserved_code;
+  ArrayRef<const uint8_t> reserved_data;
+  if (code_cache->Reserve(self,
+                          region,
+                          entry.code.size(),
+                          entry.stack_map.size(),
+                          /*number_of_roots=*/ 0u,
+                          method,
+                          &reserved_code,
+                          &reserved_data)) {
+    ArenaAllocator allocator(runtime->GetJitArenaPool());
+    ArenaSet<ArtMethod*> cha_single_implementation_list(allocator.Adapter(kArenaAllocCHA));
+    success = code_cache->Commit(self,
+                                 region,
+                                 method,
+                                 reserved_code,
+                                 ArrayRef<const uint8_t>(entry.code),
+                                 reserved_data,
+                                 /*roots=*/ {},
+                                 ArrayRef<const uint8_t>(entry.stack_map),
+                                 /*debug_info=*/ {},
+                                 /*is_full_debug_info=*/ false,
+                                 CompilationKind::kOptimized,
+                                 cha_single_implementation_list);
+    if (!success) {
+      code_cache->Free(self, region, reserved_code.data(), reserved_data.data());
+    }
+  }
+  code_cache->DoneCompiling(method, self);
+  return success;
+}
+
+size_t JitPersistentCache::LoadAndInstall(Thread* self, JitCodeCache* code_cache) {
+  uint64_t start_ns = NanoTime();
+  std::string contents;
+  if (!android::base::ReadFileToString(filename_, &contents)) {
+    VLOG(jit) << "No JIT persistent cache " << filename_;
+    return 0u;
+  }
+  ScopedObjectAccess soa(self);
+  std::vector<Entry> entries;
+  std::string error_msg;
+  if (!Parse(contents, GetKey(), &entries, &error_msg)) {
+    LOG(WARNING) << "Ignoring JIT persistent cache " << filename_ << ": " << error_msg;
+    return 0u;
+  }
+
+  // Find the dex caches of the dex files the entries refer to.
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  VariableSizedHandleScope handles(self);
+  std::map<std::pair<std::string, uint32_t>, Handle<mirror::DexCache>> dex_caches;
+  {
+    class CollectDexCaches final : public DexCacheVisitor {
+     public:
+      CollectDexCaches(VariableSizedHandleScope* handles,
+                       std::map<std::pair<std::string, uint32_t>, Handle<mirror::DexCache>>* out)
+          : handles_(handles), out_(out) {}
+
+      void Visit(ObjPtr<mirror::DexCache> dex_cache)
+          REQUIRES_SHARED(Locks::dex_lock_, Locks::mutator_lock_) override {
+        const DexFile* dex_file = dex_cache->GetDexFile();
+        out_->emplace(std::make_pair(dex_file->GetLocation(), dex_file->GetLocationChecksum()),
+                      handles_->NewHandle(dex_cache));
+      }
+
+     private:
+      VariableSizedHandleScope* const handles_;
+      std::map<std::pair<std::string, uint32_t>, Handle<mirror::DexCache>>* const out_;
+    };
+    CollectDexCaches visitor(&handles, &dex_caches);
+    ReaderMutexLock mu(self, *Locks::dex_lock_);
+    class_linker->VisitDexCaches(&visitor);
+  }
+
+  size_t num_installed = 0u;
+  StackHandleScope<1> hs(self);
+  MutableHandle<mirror::ClassLoader> class_loader = hs.NewHandle<mirror::ClassLoader>(nullptr);
+  for (Entry& entry : entries) {
+    auto it = dex_caches.find(std::make_pair(entry.dex_location, entry.dex_checksum));
+    if (it == dex_caches.end() || entry.method_index >= it->second->GetDexFile()->NumMethodIds()) {
+      continue;
+    }
+    class_loader.Assign(it->second->GetClassLoader());
+    ArtMethod* method =
+        class_linker->ResolveMethodId(entry.method_index, it->second, class_loader);
+    if (method == nullptr) {
+      self->ClearException();
+      continue;
+    }
+    if (Install(self, code_cache, method, entry)) {
+      ++num_installed;
+      // Keep the method in the next version of the file.
+      MutexLock mu(self, lock_);
+      AddEntryLocked(std::move(entry));
+    }
+  }
+  {
+    MutexLock mu(self, lock_);
+    num_loaded_ += entries.size();
+    num_installed_ += num_installed;
+  }
+  VLOG(jit) << "Installed " << num_installed << " of " << entries.size()
+            << " methods from JIT persistent cache " << filename_ << " in "
+            << PrettyDuration(NanoTime() - start_ns);
+  return num_installed;
+}
+
+void JitPersistentCache::DumpInfo(std::ostream& os) {
+  MutexLock mu(Thread::Current(), lock_);
+  os << "JIT persistent cache " << filename_ << ": installed " << num_installed_
+     << " of " << num_loaded_ << " loaded methods, recorded " << entries_.size()
+     << " methods (" << PrettySize(recorded_bytes_) << "), dropped " << num_dropped_ << "\n";
+}
+
+}  // namespace jit
+}  // namespace art
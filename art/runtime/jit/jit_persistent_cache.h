@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_PERSISTENT_CACHE_H_
+#define ART_RUNTIME_JIT_JIT_PERSISTENT_CACHE_H_
+
+#include <iosfwd>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/array_ref.h"
+#include "base/globals.h"
+#include "base/locks.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art HIDDEN {
+
+class ArtMethod;
+class Thread;
+
+namespace jit {
+
+class JitCodeCache;
+
+// A per-app file holding the JIT compiled code of methods, so that the next run of the app can
+// install the code at startup instead of compiling the methods again.
+//
+// Only code which does not depend on the addresses of the process is recorded, i.e. code without
+// JIT roots, inlining, or embedded ArtMethod*, see OptimizingCompiler::JitCompile. The file is
+// keyed by the boot class path checksums, the runtime ISA and the debuggability of the runtime,
+// and each method by the checksum of its dex file, so that stale code is never installed.
+class JitPersistentCache {
+ public:
+  // The maximum amount of code and stack maps recorded.
+  static constexpr size_t kMaxRecordedBytes = 2 * MB;
+
+  explicit JitPersistentCache(const std::string& filename);
+
+  const std::string& GetFilename() const {
+    return filename_;
+  }
+
+  // Record the code and stack maps of `method`, just committed to the code cache.
+  void Record(ArtMethod* method, ArrayRef<const uint8_t> code, ArrayRef<const uint8_t> stack_map)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!lock_);
+
+  // Write the recorded methods to the file, replacing its previous contents.
+  bool Save(std::string* error_msg) REQUIRES(!lock_);
+
+  // Read the file and install the code of the methods whose dex files are loaded in
+  // `code_cache`. Returns the number of methods installed.
+  size_t LoadAndInstall(Thread* self, JitCodeCache* code_cache)
+      REQUIRES(!lock_)
+      REQUIRES(!Locks::mutator_lock_);
+
+  void DumpInfo(std::ostream& os) REQUIRES(!lock_);
+
+ private:
+  struct Entry {
+    std::string dex_location;
+    uint32_t dex_checksum;
+    uint32_t method_index;
+    std::vector<uint8_t> code;
+    std::vector<uint8_t> stack_map;
+  };
+
+  // Return the key identifying the runtime configuration the code was compiled for.
+  static std::string GetKey() REQUIRES_SHARED(Locks::mutator_lock_);
+
+  static bool Parse(const std::string& contents,
+                    const std::string& key,
+                    /*out*/ std::vector<Entry>* entries,
+                    /*out*/ std::string* error_msg);
+
+  bool Install(Thread* self, JitCodeCache* code_cache, ArtMethod* method, const Entry& entry)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  void AddEntryLocked(Entry&& entry) REQUIRES(lock_);
+
+  const std::string filename_;
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::vector<Entry> entries_ GUARDED_BY(lock_);
+  // The dex locations and method indexes of `entries_`.
+  std::set<std::pair<std::string, uint32_t>> recorded_methods_ GUARDED_BY(lock_);
+  size_t recorded_bytes_ GUARDED_BY(lock_);
+  size_t num_dropped_ GUARDED_BY(lock_);
+  size_t num_loaded_ GUARDED_BY(lock_);
+  size_t num_installed_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(JitPersistentCache);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_PERSISTENT_CACHE_H_
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "method_sampler.h"
+
+#include <array>
+#include <ostream>
+
+#include "art_method-inl.h"
+#include "barrier.h"
+#include "base/logging.h"  // For VLOG.
+#include "base/systrace.h"
+#include "base/time_utils.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "stack.h"
+#include "thread-current-inl.h"
+#include "thread_list.h"
+
+namespace art HIDDEN {
+
+class MethodSampler::SampleClosure final : public Closure {
+ public:
+  SampleClosure(MethodSampler* sampler, Barrier* barrier)
+      : sampler_(sampler), barrier_(barrier) {}
+
+  void Run(Thread* thread) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    ScopedTrace trace(__PRETTY_FUNCTION__);
+    DCHECK(thread == Thread::Current() || thread->IsSuspended());
+    std::array<ArtMethod*, kMaxFramesPerThread> methods;
+    size_t count = 0u;
+    StackVisitor::WalkStack(
+        [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+          ArtMethod* method = stack_visitor->GetMethod();
+          if (method == nullptr || method->IsRuntimeMethod()) {
+            return true;
+          }
+          methods[count] = method->GetNonObsoleteMethod();
+          ++count;
+          return count != methods.size();
+        },
+        thread,
+        /* context= */ nullptr,
+        art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+    // Collect the methods before taking the lock, to keep the critical section short as all
+    // threads running the checkpoint add their methods concurrently.
+    if (count != 0u) {
+      sampler_->AddSampledMethods(Thread::Current(), methods.data(), count);
+    }
+    barrier_->Pass(Thread::Current());
+  }
+
+ private:
+  MethodSampler* const sampler_;
+  Barrier* const barrier_;
+};
+
+MethodSampler::MethodSampler(uint32_t period_ms)
+    : period_ms_(period_ms),
+      pthread_(0u),
+      lock_("Method sampler lock", kGenericBottomLock),
+      cond_("Method sampler condition", lock_),
+      started_(false),
+      shutting_down_(false),
+      total_number_of_samples_(0u),
+      total_number_of_sampled_frames_(0u),
+      total_ns_of_sampling_(0u) {
+  DCHECK_NE(period_ms_, 0u);
+}
+
+MethodSampler::~MethodSampler() {
+  DCHECK_EQ(pthread_, 0u) << "The method sampler must be stopped before being deleted";
+}
+
+void MethodSampler::Start() {
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    DCHECK(!started_);
+    started_ = true;
+  }
+  CHECK_PTHREAD_CALL(pthread_create,
+                     (&pthread_, nullptr, &RunSamplerThread, reinterpret_cast<void*>(this)),
+                     "Method sampler thread");
+}
+
+void MethodSampler::Stop() {
+  Thread* self = Thread::Current();
+  {
+    MutexLock mu(self, lock_);
+    if (!started_ || shutting_down_) {
+      return;
+    }
+    shutting_down_ = true;
+    cond_.Signal(self);
+  }
+  // The calling thread is suspended, so it does not hold up the checkpoint the sampler
+  // thread may be running.
+  CHECK_PTHREAD_CALL(pthread_join, (pthread_, nullptr), "Method sampler thread shutdown");
+  pthread_ = 0u;
+}
+
+void* MethodSampler::RunSamplerThread(void* arg) {
+  Runtime* runtime = Runtime::Current();
+  bool attached = runtime->AttachCurrentThread("Method Sampler",
+                                               /*as_daemon=*/true,
+                                               runtime->GetSystemThreadGroup(),
+                                               /*create_peer=*/true);
+  if (!attached) {
+    CHECK(runtime->IsShuttingDown(Thread::Current()));
+    return nullptr;
+  }
+  reinterpret_cast<MethodSampler*>(arg)->Run();
+  runtime->DetachCurrentThread();
+  VLOG(profiler) << "Method sampler shutdown";
+  return nullptr;
+}
+
+void MethodSampler::Run() {
+  Thread* self = Thread::Current();
+  while (true) {
+    {
+      MutexLock mu(self, lock_);
+      if (!shutting_down_) {
+        cond_.TimedWait(self, period_ms_, 0);
+      }
+      if (shutting_down_) {
+        break;
+      }
+    }
+    Sample(self);
+  }
+}
+
+void MethodSampler::Sample(Thread* self) {
+  const uint64_t start_time = NanoTime();
+  Barrier barrier(0);
+  SampleClosure closure(this, &barrier);
+  {
+    ScopedObjectAccess soa(self);
+    size_t threads_running_checkpoint =
+        Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
+    // Now that we have run our checkpoint, move to a suspended state and wait
+    // for other threads to run the checkpoint.
+    ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+    if (threads_running_checkpoint != 0) {
+      barrier.Increment(self, threads_running_checkpoint);
+    }
+  }
+  MutexLock mu(self, lock_);
+  ++total_number_of_samples_;
+  total_ns_of_sampling_ += NanoTime() - start_time;
+}
+
+void MethodSampler::AddSampledMethods(Thread* self, ArtMethod* const* methods, size_t count) {
+  MutexLock mu(self, lock_);
+  sampled_methods_.insert(methods, methods + count);
+  total_number_of_sampled_frames_ += count;
+}
+
+void MethodSampler::TakeSampledMethods(/*out*/std::unordered_set<ArtMethod*>* methods) {
+  MutexLock mu(Thread::Current(), lock_);
+  methods->clear();
+  methods->swap(sampled_methods_);
+}
+
+void MethodSampler::DumpInfo(std::ostream& os) {
+  MutexLock mu(Thread::Current(), lock_);
+  os << "MethodSampler period_ms=" << period_ms_ << '\n'
+     << "MethodSampler total_number_of_samples=" << total_number_of_samples_ << '\n'
+     << "MethodSampler total_number_of_sampled_frames=" << total_number_of_sampled_frames_ << '\n'
+     << "MethodSampler total_ms_of_sampling=" << NsToMs(total_ns_of_sampling_) << '\n';
+}
+
+}  // namespace art
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_METHOD_SAMPLER_H_
+#define ART_RUNTIME_JIT_METHOD_SAMPLER_H_
+
+#include <pthread.h>
+
+#include <iosfwd>
+#include <unordered_set>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art HIDDEN {
+
+class ArtMethod;
+class Thread;
+
+// Periodically samples the Java stacks of all threads and records the methods found on them.
+//
+// This is the source of the "sampled" methods of the profile when the JIT uses sampling hotness
+// (-Xjitsamplinghotness). In that mode, methods keep their hotness counter at the "hot" value and
+// nterp counts invocations in a thread-local counter instead, see `IsMemorySharedMethod()`, so the
+// `ArtMethod`s are not written on every invocation and their cache lines stay clean.
+class MethodSampler {
+ public:
+  explicit MethodSampler(uint32_t period_ms);
+  ~MethodSampler();
+
+  // Start and stop the sampler thread.
+  void Start() REQUIRES(!lock_);
+  void Stop() REQUIRES(!lock_, !Locks::mutator_lock_);
+
+  // Move the methods sampled since the last call to `methods`. Note that a method may have been
+  // unloaded since it was sampled, so the pointers must only be used for lookups.
+  void TakeSampledMethods(/*out*/std::unordered_set<ArtMethod*>* methods) REQUIRES(!lock_);
+
+  void DumpInfo(std::ostream& os) REQUIRES(!lock_);
+
+ private:
+  class SampleClosure;
+
+  // The maximum number of frames, from the top of the stack, recorded for each thread.
+  static constexpr size_t kMaxFramesPerThread = 4u;
+
+  static void* RunSamplerThread(void* arg);
+  void Run() REQUIRES(!lock_, !Locks::mutator_lock_);
+
+  // Record the methods on the stacks of all threads.
+  void Sample(Thread* self) REQUIRES(!lock_, !Locks::mutator_lock_);
+
+  void AddSampledMethods(Thread* self, ArtMethod* const* methods, size_t count) REQUIRES(!lock_);
+
+  const uint32_t period_ms_;
+  pthread_t pthread_;
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  ConditionVariable cond_ GUARDED_BY(lock_);
+  bool started_ GUARDED_BY(lock_);
+  bool shutting_down_ GUARDED_BY(lock_);
+  std::unordered_set<ArtMethod*> sampled_methods_ GUARDED_BY(lock_);
+
+  uint64_t total_number_of_samples_ GUARDED_BY(lock_);
+  uint64_t total_number_of_sampled_frames_ GUARDED_BY(lock_);
+  uint64_t total_ns_of_sampling_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(MethodSampler);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_METHOD_SAMPLER_H_
@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <string>
+#include <unordered_set>
 #include <utility>
 
 #include "android-base/file.h"
@@ -100,12 +101,18 @@ ProfileSaver::ProfileSaver(const ProfileSaverOptions& options, jit::JitCodeCache
       total_number_of_code_cache_queries_(0),
       total_number_of_skipped_writes_(0),
       total_number_of_failed_writes_(0),
+      total_number_of_loads_(0),
+      total_number_of_reused_profiles_(0),
       total_ms_of_sleep_(0),
       total_ns_of_work_(0),
       total_number_of_hot_spikes_(0),
       total_number_of_wake_ups_(0),
       options_(options) {
   DCHECK(options_.IsEnabled());
+  const jit::JitOptions* jit_options = Runtime::Current()->GetJITOptions();
+  if (jit_options->UseSamplingHotness()) {
+    method_sampler_.reset(new MethodSampler(jit_options->GetSamplingHotnessPeriodMs()));
+  }
 }
 
 ProfileSaver::~ProfileSaver() {
@@ -322,12 +329,14 @@ class ProfileSaver::GetClassesAndMethodsHelper {
  public:
   GetClassesAndMethodsHelper(bool startup,
                              const ProfileSaverOptions& options,
-                             const ProfileCompilationInfo::ProfileSampleAnnotation& annotation)
+                             const ProfileCompilationInfo::ProfileSampleAnnotation& annotation,
+                             const std::unordered_set<ArtMethod*>* sampled_methods)
       REQUIRES_SHARED(Locks::mutator_lock_)
       : startup_(startup),
         profile_boot_class_path_(options.GetProfileBootClassPath()),
         extra_flags_(GetExtraMethodHotnessFlags(options)),
         annotation_(annotation),
+        sampled_methods_(sampled_methods),
         arena_stack_(Runtime::Current()->GetArenaPool()),
         allocator_(&arena_stack_),
         class_loaders_(std::nullopt),
@@ -409,6 +418,8 @@ class ProfileSaver::GetClassesAndMethodsHelper {
   const bool profile_boot_class_path_;
   const uint32_t extra_flags_;
   const ProfileCompilationInfo::ProfileSampleAnnotation annotation_;
+  // The methods found by the `MethodSampler`, or null if the JIT does not use sampling hotness.
+  const std::unordered_set<ArtMethod*>* const sampled_methods_;
   ArenaStack arena_stack_;
   ScopedArenaAllocator allocator_;
   std::optional<VariableSizedHandleScope> class_loaders_;
@@ -589,12 +600,20 @@ void ProfileSaver::GetClassesAndMethodsHelper::UpdateProfile(const std::set<std:
   size_t number_of_sampled_methods = 0u;
 
   uint16_t initial_value = Runtime::Current()->GetJITOptions()->GetWarmupThreshold();
+  const std::unordered_set<ArtMethod*>* sampled_methods = sampled_methods_;
   auto get_method_flags = [&](ArtMethod& method) {
     // Mark methods as hot if they are marked as such (warm for the runtime
     // means hot for the profile).
     if (method.PreviouslyWarm()) {
       ++number_of_hot_methods;
       return enum_cast<ProfileCompilationInfo::MethodHotness::Flag>(base_flags | Hotness::kFlagHot);
+    } else if (sampled_methods != nullptr && method.IsMemorySharedMethod()) {
+      // The counter of memory shared methods is always "hot", use the stack samples instead.
+      if (sampled_methods->find(&method) != sampled_methods->end()) {
+        ++number_of_sampled_methods;
+        return enum_cast<ProfileCompilationInfo::MethodHotness::Flag>(base_flags);
+      }
+      return enum_cast<ProfileCompilationInfo::MethodHotness::Flag>(0u);
     } else if (method.CounterHasChanged(initial_value)) {
       ++number_of_sampled_methods;
       return enum_cast<ProfileCompilationInfo::MethodHotness::Flag>(base_flags);
@@ -732,8 +751,16 @@ void ProfileSaver::FetchAndCacheResolvedClassesAndMethods(bool startup) {
       sdp.emplace(profiler_pthread);
     }
 
+    std::unordered_set<ArtMethod*> sampled_methods;
+    if (method_sampler_ != nullptr) {
+      method_sampler_->TakeSampledMethods(&sampled_methods);
+    }
+
     ScopedObjectAccess soa(self);
-    GetClassesAndMethodsHelper helper(startup, options_, GetProfileSampleAnnotation());
+    GetClassesAndMethodsHelper helper(startup,
+                                      options_,
+                                      GetProfileSampleAnnotation(),
+                                      method_sampler_ != nullptr ? &sampled_methods : nullptr);
     helper.CollectClasses(self);
 
     // Release the mutator lock. We shall need to re-acquire the lock for a moment to
@@ -771,6 +798,50 @@ void ProfileSaver::FetchAndCacheResolvedClassesAndMethods(bool startup) {
                  << " sampled methods in " << PrettyDuration(NanoTime() - start_time);
 }
 
+bool ProfileSaver::GetProfileFileStamp(const std::string& filename,
+                                       /*out*/ProfileFileStamp* stamp) {
+  struct stat st;
+  if (stat(filename.c_str(), &st) != 0) {
+    return false;
+  }
+  stamp->device = static_cast<uint64_t>(st.st_dev);
+  stamp->inode = static_cast<uint64_t>(st.st_ino);
+  stamp->size = static_cast<int64_t>(st.st_size);
+  stamp->mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1'000'000'000 + st.st_mtim.tv_nsec;
+  stamp->ctime_ns = static_cast<int64_t>(st.st_ctim.tv_sec) * 1'000'000'000 + st.st_ctim.tv_nsec;
+  return true;
+}
+
+bool ProfileSaver::GetProfileForSave(const std::string& filename,
+                                     /*inout*/SavedProfile* saved_profile) {
+  if (saved_profile->info != nullptr) {
+    ProfileFileStamp stamp;
+    if (GetProfileFileStamp(filename, &stamp) && stamp == saved_profile->stamp) {
+      total_number_of_reused_profiles_++;
+      return true;
+    }
+    // The file was rewritten, cleared or deleted by someone else, e.g. by `artd` or by clearing
+    // the app data. Start again from what is in the file.
+    VLOG(profiler) << "Profile " << filename << " changed since the last save";
+  }
+  saved_profile->info.reset(new ProfileCompilationInfo(
+      Runtime::Current()->GetArenaPool(), /*for_boot_image=*/options_.GetProfileBootClassPath()));
+  // Load the existing profile before saving.
+  // If the file is updated between `Load` and `Save`, the update will be lost. This is
+  // acceptable. The main reason is that the lost entries will eventually come back if the user
+  // keeps using the same methods, or they won't be needed if the user doesn't use the same
+  // methods again.
+  total_number_of_loads_++;
+  if (!GetProfileFileStamp(filename, &saved_profile->stamp) ||
+      !saved_profile->info->Load(filename, /*clear_if_invalid=*/true)) {
+    saved_profile->info.reset();
+    return false;
+  }
+  saved_profile->number_of_methods = saved_profile->info->GetNumberOfMethods();
+  saved_profile->number_of_classes = saved_profile->info->GetNumberOfResolvedClasses();
+  return true;
+}
+
 bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number_of_new_methods) {
   ScopedTrace trace(__PRETTY_FUNCTION__);
 
@@ -826,20 +897,23 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
       total_number_of_code_cache_queries_++;
     }
     {
-      ProfileCompilationInfo info(Runtime::Current()->GetArenaPool(),
-                                  /*for_boot_image=*/options_.GetProfileBootClassPath());
-      // Load the existing profile before saving.
-      // If the file is updated between `Load` and `Save`, the update will be lost. This is
-      // acceptable. The main reason is that the lost entries will eventually come back if the user
-      // keeps using the same methods, or they won't be needed if the user doesn't use the same
-      // methods again.
-      if (!info.Load(filename, /*clear_if_invalid=*/true)) {
+      SavedProfile saved_profile;
+      {
+        MutexLock mu(Thread::Current(), *Locks::profiler_lock_);
+        auto saved_it = saved_profiles_.find(filename);
+        if (saved_it != saved_profiles_.end()) {
+          saved_profile = std::move(saved_it->second);
+          saved_profiles_.erase(saved_it);
+        }
+      }
+      if (!GetProfileForSave(filename, &saved_profile)) {
         LOG(WARNING) << "Could not forcefully load profile " << filename;
         continue;
       }
+      ProfileCompilationInfo& info = *saved_profile.info;
 
-      uint64_t last_save_number_of_methods = info.GetNumberOfMethods();
-      uint64_t last_save_number_of_classes = info.GetNumberOfResolvedClasses();
+      uint64_t last_save_number_of_methods = saved_profile.number_of_methods;
+      uint64_t last_save_number_of_classes = saved_profile.number_of_classes;
       VLOG(profiler) << "last_save_number_of_methods=" << last_save_number_of_methods
                      << " last_save_number_of_classes=" << last_save_number_of_classes
                      << " number of profiled methods=" << profile_methods.size();
@@ -887,6 +961,9 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
                         << " Number of methods: " << delta_number_of_methods
                         << " Number of classes: " << delta_number_of_classes;
           total_number_of_skipped_writes_++;
+          // Keep the new data for the next save.
+          saved_profiles_.erase(filename);
+          saved_profiles_.Put(filename, std::move(saved_profile));
           continue;
         }
 
@@ -905,6 +982,12 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
             profile_cache_.erase(profile_cache_it);
             delete cached_info;
           }
+          if (GetProfileFileStamp(filename, &saved_profile.stamp)) {
+            saved_profile.number_of_methods = info.GetNumberOfMethods();
+            saved_profile.number_of_classes = info.GetNumberOfResolvedClasses();
+            saved_profiles_.erase(filename);
+            saved_profiles_.Put(filename, std::move(saved_profile));
+          }
           if (bytes_written > 0) {
             total_number_of_writes_++;
             total_bytes_written_ += bytes_written;
@@ -1058,6 +1141,10 @@ void ProfileSaver::Start(const ProfileSaverOptions& options,
       "Profile saver thread");
 
   SetProfileSaverThreadPriority(profiler_pthread_, kProfileSaverPthreadPriority);
+
+  if (instance_->method_sampler_ != nullptr) {
+    instance_->method_sampler_->Start();
+  }
 }
 
 void ProfileSaver::Stop(bool dump_info) {
@@ -1086,6 +1173,11 @@ void ProfileSaver::Stop(bool dump_info) {
     profile_saver->period_condition_.Signal(Thread::Current());
   }
 
+  // Stop sampling, the final save below records the last samples.
+  if (profile_saver->method_sampler_ != nullptr) {
+    profile_saver->method_sampler_->Stop();
+  }
+
   // Force save everything before destroying the thread since we want profiler_pthread_ to remain
   // valid.
   profile_saver->ProcessProfilingInfo(/*force_ save=*/ true, /*number_of_new_methods=*/ nullptr);
@@ -1185,10 +1277,15 @@ void ProfileSaver::DumpInfo(std::ostream& os) {
      << total_number_of_code_cache_queries_ << '\n'
      << "ProfileSaver total_number_of_skipped_writes=" << total_number_of_skipped_writes_ << '\n'
      << "ProfileSaver total_number_of_failed_writes=" << total_number_of_failed_writes_ << '\n'
+     << "ProfileSaver total_number_of_loads=" << total_number_of_loads_ << '\n'
+     << "ProfileSaver total_number_of_reused_profiles=" << total_number_of_reused_profiles_ << '\n'
      << "ProfileSaver total_ms_of_sleep=" << total_ms_of_sleep_ << '\n'
      << "ProfileSaver total_ms_of_work=" << NsToMs(total_ns_of_work_) << '\n'
      << "ProfileSaver total_number_of_hot_spikes=" << total_number_of_hot_spikes_ << '\n'
      << "ProfileSaver total_number_of_wake_ups=" << total_number_of_wake_ups_ << '\n';
+  if (method_sampler_ != nullptr) {
+    method_sampler_->DumpInfo(os);
+  }
 }
 
 
@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_JIT_PROFILE_SAVER_H_
 #define ART_RUNTIME_JIT_PROFILE_SAVER_H_
 
+#include <memory>
 #include <utility>
 
 #include "app_info.h"
@@ -24,6 +25,7 @@
 #include "base/safe_map.h"
 #include "dex/method_reference.h"
 #include "jit_code_cache.h"
+#include "method_sampler.h"
 #include "profile/profile_compilation_info.h"
 #include "profile_saver_options.h"
 
@@ -78,6 +80,41 @@ class ProfileSaver {
       REQUIRES(Locks::profiler_lock_, !wait_lock_)
       RELEASE(Locks::profiler_lock_);
 
+  // What a profile file looked like right after the profile saver wrote or read it.
+  struct ProfileFileStamp {
+    uint64_t device = 0u;
+    uint64_t inode = 0u;
+    int64_t size = -1;
+    int64_t mtime_ns = 0;
+    int64_t ctime_ns = 0;
+
+    bool operator==(const ProfileFileStamp& other) const {
+      return device == other.device &&
+             inode == other.inode &&
+             size == other.size &&
+             mtime_ns == other.mtime_ns &&
+             ctime_ns == other.ctime_ns;
+    }
+  };
+
+  // The contents of a tracked profile file as of the last save, plus anything added since by saves
+  // that had too little new data to write. As long as the file is unchanged, saves add to this
+  // profile instead of loading and parsing the whole file again.
+  struct SavedProfile {
+    std::unique_ptr<ProfileCompilationInfo> info;
+    ProfileFileStamp stamp;
+    // The number of methods and classes in the file.
+    uint64_t number_of_methods = 0u;
+    uint64_t number_of_classes = 0u;
+  };
+
+  // Get the stamp of `filename`. Returns false if the file cannot be stat'ed.
+  static bool GetProfileFileStamp(const std::string& filename, /*out*/ProfileFileStamp* stamp);
+
+  // Get the profile to add new data to for `filename`, reusing the saved profile if the file was
+  // not changed by someone else since the last save. Returns false if the profile cannot be loaded.
+  bool GetProfileForSave(const std::string& filename, /*inout*/SavedProfile* saved_profile);
+
   // Processes the existing profiling info from the jit code cache and returns
   // true if it needed to be saved to disk.
   // If number_of_new_methods is not null, after the call it will contain the number of new methods
@@ -156,6 +193,10 @@ class ProfileSaver {
   // to just a few hundreds entries in the ProfileCompilationInfo objects.
   SafeMap<std::string, ProfileCompilationInfo*> profile_cache_ GUARDED_BY(Locks::profiler_lock_);
 
+  // The profiles of the last saves, see `SavedProfile`. Entries are taken out of the map while
+  // they are in use, so a concurrent forced save simply loads the file.
+  SafeMap<std::string, SavedProfile> saved_profiles_ GUARDED_BY(Locks::profiler_lock_);
+
   // Whether or not this is the first ever profile save.
   // Note this is an approximation and is not 100% precise. It relies on checking
   // whether or not the profiles are empty which is not a precise indication
@@ -171,6 +212,8 @@ class ProfileSaver {
   uint64_t total_number_of_code_cache_queries_;
   uint64_t total_number_of_skipped_writes_;
   uint64_t total_number_of_failed_writes_;
+  uint64_t total_number_of_loads_;
+  uint64_t total_number_of_reused_profiles_;
   uint64_t total_ms_of_sleep_;
   uint64_t total_ns_of_work_;
   // TODO(calin): replace with an actual size.
@@ -179,6 +222,9 @@ class ProfileSaver {
 
   const ProfileSaverOptions options_;
 
+  // The stack sampler providing the sampled methods when the JIT uses sampling hotness.
+  std::unique_ptr<MethodSampler> method_sampler_;
+
   friend class ProfileSaverTest;
   friend class ProfileSaverForBootTest;
 
@@ -28,6 +28,8 @@ using Hotness = ProfileCompilationInfo::MethodHotness;
 
 class ProfileSaverTest : public CommonRuntimeTest {
  public:
+  using SavedProfile = ProfileSaver::SavedProfile;
+
   void SetUpRuntimeOptions(RuntimeOptions *options) override {
     // Reset the callbacks so that the runtime doesn't think it's for AOT.
     callbacks_ = nullptr;
@@ -59,6 +61,17 @@ class ProfileSaverTest : public CommonRuntimeTest {
     return profile_saver_->AnnotateSampleFlags(flags);
   }
 
+  // Returns whether the saved profile was reused rather than loaded from the file.
+  bool GetProfileForSave(const std::string& filename, SavedProfile* saved_profile) {
+    uint64_t number_of_loads = profile_saver_->total_number_of_loads_;
+    EXPECT_TRUE(profile_saver_->GetProfileForSave(filename, saved_profile));
+    return profile_saver_->total_number_of_loads_ == number_of_loads;
+  }
+
+  void UpdateStamp(const std::string& filename, SavedProfile* saved_profile) {
+    ASSERT_TRUE(ProfileSaver::GetProfileFileStamp(filename, &saved_profile->stamp));
+  }
+
  protected:
   ProfileSaver* profile_saver_ = nullptr;
 };
@@ -103,4 +116,26 @@ TEST_F(ProfileSaverTest, AnnotateSampleFlags) {
   ASSERT_EQ(Hotness::kFlagHot, actual);
 }
 
+TEST_F(ProfileSaverTest, ReuseSavedProfile) {
+  ScratchFile profile;
+  SavedProfile saved_profile;
+
+  // The first save loads the file.
+  ASSERT_FALSE(GetProfileForSave(profile.GetFilename(), &saved_profile));
+  ASSERT_TRUE(saved_profile.info != nullptr);
+  EXPECT_EQ(0u, saved_profile.number_of_methods);
+
+  // Saving writes the file and updates the stamp. As long as nobody else writes the file, the
+  // next saves use the profile in memory.
+  ASSERT_TRUE(saved_profile.info->Save(profile.GetFd()));
+  UpdateStamp(profile.GetFilename(), &saved_profile);
+  ProfileCompilationInfo* info = saved_profile.info.get();
+  EXPECT_TRUE(GetProfileForSave(profile.GetFilename(), &saved_profile));
+  EXPECT_EQ(info, saved_profile.info.get());
+
+  // Someone else empties the file, so it is loaded again.
+  ASSERT_EQ(0, profile.GetFile()->SetLength(0));
+  EXPECT_FALSE(GetProfileForSave(profile.GetFilename(), &saved_profile));
+}
+
 }  // namespace art
@@ -32,7 +32,8 @@ ProfilingInfo::ProfilingInfo(ArtMethod* method,
         method_(method),
         number_of_inline_caches_(inline_cache_entries.size()),
         number_of_branch_caches_(branch_cache_entries.size()),
-        current_inline_uses_(0) {
+        current_inline_uses_(0),
+        implicit_null_check_faults_(0) {
   InlineCache* inline_caches = GetInlineCaches();
   memset(inline_caches, 0, number_of_inline_caches_ * sizeof(InlineCache));
   for (size_t i = 0; i < number_of_inline_caches_; ++i) {
@@ -112,6 +113,28 @@ BranchCache* ProfilingInfo::GetBranchCache(uint32_t dex_pc) {
   return nullptr;
 }
 
+size_t ProfilingInfo::GetNumberOfInlineCacheClasses() {
+  size_t count = 0u;
+  InlineCache* caches = GetInlineCaches();
+  for (size_t i = 0; i < number_of_inline_caches_; ++i) {
+    for (size_t j = 0; j < InlineCache::kIndividualCacheSize; ++j) {
+      if (!caches[i].classes_[j].IsNull()) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+uint64_t ProfilingInfo::GetBranchExecutionCount() {
+  uint64_t count = 0u;
+  BranchCache* caches = GetBranchCaches();
+  for (size_t i = 0; i < number_of_branch_caches_; ++i) {
+    count += caches[i].GetExecutionCount();
+  }
+  return count;
+}
+
 void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
   InlineCache* cache = GetInlineCache(dex_pc);
   if (cache == nullptr) {
@@ -128,9 +128,20 @@ class ProfilingInfo {
     return method_;
   }
 
+  uint32_t GetNumberOfInlineCaches() const {
+    return number_of_inline_caches_;
+  }
+
   InlineCache* GetInlineCache(uint32_t dex_pc);
   BranchCache* GetBranchCache(uint32_t dex_pc);
 
+  // Return the number of receiver classes recorded in the inline caches. Inline caches only
+  // grow, so this stops changing once the receiver types seen by the method are stable.
+  size_t GetNumberOfInlineCacheClasses() REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Return the number of executions recorded in the branch caches.
+  uint64_t GetBranchExecutionCount();
+
   InlineCache* GetInlineCaches() {
     return reinterpret_cast<InlineCache*>(
         reinterpret_cast<uintptr_t>(this) + sizeof(ProfilingInfo));
@@ -177,7 +188,25 @@ class ProfilingInfo {
 
   static uint16_t GetOptimizeThreshold();
 
+  // Record a NullPointerException thrown by an implicit null check, that is from the fault
+  // handler, in the compiled code of the method. These are much more expensive than explicit
+  // null checks when they do throw, so the JIT uses explicit null checks for the methods that
+  // throw them often, see `HasFrequentImplicitNullCheckFaults()`.
+  void AddImplicitNullCheckFault() {
+    if (implicit_null_check_faults_ != std::numeric_limits<uint16_t>::max()) {
+      implicit_null_check_faults_++;
+    }
+  }
+
+  bool HasFrequentImplicitNullCheckFaults() const {
+    return implicit_null_check_faults_ >= kFrequentImplicitNullCheckFaults;
+  }
+
  private:
+  // The number of NullPointerExceptions from implicit null checks after which the JIT compiles
+  // the method with explicit null checks.
+  static constexpr uint16_t kFrequentImplicitNullCheckFaults = 16u;
+
   ProfilingInfo(ArtMethod* method,
                 const std::vector<uint32_t>& inline_cache_entries,
                 const std::vector<uint32_t>& branch_cache_entries);
@@ -202,6 +231,10 @@ class ProfilingInfo {
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
 
+  // Number of NullPointerExceptions thrown by implicit null checks in the compiled code of the
+  // method. Not atomic, the count only needs to be approximate.
+  uint16_t implicit_null_check_faults_;
+
   // Memory following the object:
   // - Dynamically allocated array of `InlineCache` of size `number_of_inline_caches_`.
   // - Dynamically allocated array of `BranchCache of size `number_of_branch_caches_`.
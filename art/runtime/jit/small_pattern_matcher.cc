@@ -32,6 +32,11 @@ static int32_t ReturnOne() { return 1; }
 static int32_t ReturnFirstArgMethod([[maybe_unused]] ArtMethod* method, int32_t first_arg) {
   return first_arg;
 }
+static int32_t ReturnSecondArgMethod([[maybe_unused]] ArtMethod* method,
+                                     [[maybe_unused]] int32_t first_arg,
+                                     int32_t second_arg) {
+  return second_arg;
+}
 
 template <int offset, typename T>
 static std::conditional_t<(sizeof(T) < sizeof(int32_t)), int32_t, T> ReturnFieldAt(
@@ -98,6 +103,33 @@ static void ConstructorSetFieldObjectAt([[maybe_unused]] ArtMethod* method,
   QuasiAtomic::ThreadFenceForConstructor();
 }
 
+template <int offset, typename unused>
+static int32_t ReturnNegatedBooleanFieldAt([[maybe_unused]] ArtMethod* method, mirror::Object* obj)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  return obj->GetFieldPrimitive<uint8_t, /* kIsVolatile= */ false>(
+      MemberOffset(offset + sizeof(mirror::Object))) ^ 1;
+}
+
+template <int offset, typename T>
+static mirror::Object* SetFieldAtAndReturnThis([[maybe_unused]] ArtMethod* method,
+                                               mirror::Object* obj,
+                                               T value)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  obj->SetFieldPrimitive<T, /* kIsVolatile= */ false>(
+      MemberOffset(offset + sizeof(mirror::Object)), value);
+  return obj;
+}
+
+template <int offset, typename unused>
+static mirror::Object* SetFieldObjectAtAndReturnThis([[maybe_unused]] ArtMethod* method,
+                                                     mirror::Object* obj,
+                                                     mirror::Object* value)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  obj->SetFieldObject</* kTransactionActive */ false>(
+      MemberOffset(offset + sizeof(mirror::Object)), value);
+  return obj;
+}
+
 #define SWITCH_CASE(offset, func, type) \
   case offset:                          \
     return reinterpret_cast<void*>(&func<offset, type>);  // NOLINT [bugprone-macro-parentheses]
@@ -151,9 +183,169 @@ static void ConstructorSetFieldObjectAt([[maybe_unused]] ArtMethod* method,
       return nullptr;                               \
   }
 
+// Resolve the instance field accessed by a trivial method of `method`'s class, and return its
+// offset from the first instance field. Return -1 if the field cannot be accessed by a stub.
+static int32_t GetTrivialInstanceFieldOffset(ArtMethod* method,
+                                             uint16_t field_index,
+                                             bool is_put,
+                                             bool is_object,
+                                             /*out*/ Primitive::Type* field_type)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  Thread* self = Thread::Current();
+  ArtField* field = ResolveFieldWithAccessChecks(self,
+                                                 Runtime::Current()->GetClassLinker(),
+                                                 field_index,
+                                                 method,
+                                                 /* is_static= */ false,
+                                                 is_put,
+                                                 /* resolve_field_type= */ is_put && is_object);
+  if (field == nullptr) {
+    self->ClearException();
+    return -1;
+  }
+  if (field->IsVolatile() || (is_put && field->IsFinal())) {
+    return -1;
+  }
+  int32_t offset = field->GetOffset().Int32Value() - sizeof(mirror::Object);
+  if (offset > 64) {
+    return -1;
+  }
+  *field_type = field->GetTypeAsPrimitiveType();
+  return offset;
+}
+
+// Recognize:
+//   return{-object} v1
+// in an instance method, i.e. returning the first parameter after 'this'.
+static const void* MatchReturnSecondArg(ArtMethod* method, const CodeItemDataAccessor& accessor)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  const Instruction& instruction = accessor.begin().Inst();
+  if (method->IsStatic() ||
+      (instruction.Opcode() != Instruction::RETURN &&
+       instruction.Opcode() != Instruction::RETURN_OBJECT)) {
+    return nullptr;
+  }
+  uint32_t shorty_length;
+  const char* shorty = method->GetShorty(&shorty_length);
+  // The first parameter must be passed in a core register, like the return value.
+  if (shorty_length < 2u || shorty[1] == 'F' || shorty[0] == 'F') {
+    return nullptr;
+  }
+  uint16_t first_param_reg = accessor.RegistersSize() - accessor.InsSize() + 1;
+  if (first_param_reg != instruction.VRegA_11x()) {
+    return nullptr;
+  }
+  return reinterpret_cast<void*>(&ReturnSecondArgMethod);
+}
+
+// Recognize:
+//   iput-{object,wide,boolean} v1, v0, field
+//   return-object v0
+// i.e. a builder style setter.
+static const void* MatchSetterReturningThis(ArtMethod* method,
+                                            const CodeItemDataAccessor& accessor)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (method->IsStatic()) {
+    return nullptr;
+  }
+  uint16_t obj_reg = accessor.RegistersSize() - accessor.InsSize();
+  uint16_t first_param_reg = obj_reg + 1;
+  auto it = accessor.begin();
+  const Instruction& put = it.Inst();
+  bool is_object = false;
+  switch (put.Opcode()) {
+    case Instruction::IPUT_OBJECT:
+      is_object = true;
+      FALLTHROUGH_INTENDED;
+    case Instruction::IPUT:
+    case Instruction::IPUT_BOOLEAN:
+    case Instruction::IPUT_WIDE:
+      break;
+    default:
+      return nullptr;
+  }
+  if (put.VRegB_22c() != obj_reg || put.VRegA_22c() != first_param_reg) {
+    return nullptr;
+  }
+  ++it;
+  const Instruction& ret = it.Inst();
+  if (ret.Opcode() != Instruction::RETURN_OBJECT || ret.VRegA_11x() != obj_reg) {
+    return nullptr;
+  }
+  Primitive::Type field_type;
+  int32_t offset = GetTrivialInstanceFieldOffset(
+      method, put.VRegC_22c(), /* is_put= */ true, is_object, &field_type);
+  if (offset < 0) {
+    return nullptr;
+  }
+  DO_SWITCH(offset, SetFieldObjectAtAndReturnThis, SetFieldAtAndReturnThis, field_type);
+}
+
+// Recognize:
+//   iget-boolean vX, v0, field
+//   xor-int/lit8 vX, vX, 1
+//   return vX
+// i.e. a negated boolean flag.
+static const void* MatchNegatedBooleanGetter(ArtMethod* method,
+                                             const CodeItemDataAccessor& accessor)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (method->IsStatic()) {
+    return nullptr;
+  }
+  uint16_t obj_reg = accessor.RegistersSize() - accessor.InsSize();
+  auto it = accessor.begin();
+  const Instruction& get = it.Inst();
+  if (get.Opcode() != Instruction::IGET_BOOLEAN || get.VRegB_22c() != obj_reg) {
+    return nullptr;
+  }
+  uint16_t dest_reg = get.VRegA_22c();
+  ++it;
+  const Instruction& negate = it.Inst();
+  if (negate.Opcode() != Instruction::XOR_INT_LIT8 ||
+      negate.VRegA_22b() != dest_reg ||
+      negate.VRegB_22b() != dest_reg ||
+      negate.VRegC_22b() != 1) {
+    return nullptr;
+  }
+  ++it;
+  const Instruction& ret = it.Inst();
+  if (ret.Opcode() != Instruction::RETURN || ret.VRegA_11x() != dest_reg) {
+    return nullptr;
+  }
+  Primitive::Type field_type;
+  int32_t offset = GetTrivialInstanceFieldOffset(
+      method, get.VRegC_22c(), /* is_put= */ false, /* is_object= */ false, &field_type);
+  if (offset < 0 || field_type != Primitive::kPrimBoolean) {
+    return nullptr;
+  }
+  DO_SWITCH_OFFSET(offset, ReturnNegatedBooleanFieldAt, uint8_t);
+}
+
+// Patterns tried before the accessor and constructor patterns of `TryMatch`, selected by
+// the number of code units of the method.
+struct TrivialMethodPattern {
+  uint32_t insns_size;
+  const void* (*match)(ArtMethod* method, const CodeItemDataAccessor& accessor);
+};
+
+static constexpr TrivialMethodPattern kTrivialMethodPatterns[] = {
+  { 1u, MatchReturnSecondArg },
+  { 3u, MatchSetterReturningThis },
+  { 5u, MatchNegatedBooleanGetter },
+};
+
 const void* SmallPatternMatcher::TryMatch(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
   CodeItemDataAccessor accessor(*method->GetDexFile(), method->GetCodeItem());
 
+  for (const TrivialMethodPattern& pattern : kTrivialMethodPatterns) {
+    if (pattern.insns_size == accessor.InsnsSizeInCodeUnits()) {
+      const void* stub = pattern.match(method, accessor);
+      if (stub != nullptr) {
+        return stub;
+      }
+    }
+  }
+
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
 
   bool is_recognizable_constructor =
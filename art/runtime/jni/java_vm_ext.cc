@@ -35,6 +35,7 @@
 #include "gc/heap.h"
 #include "gc_root-inl.h"
 #include "indirect_reference_table-inl.h"
+#include "jni_env_ext.h"
 #include "jni_internal.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
@@ -539,6 +540,9 @@ JavaVMExt::JavaVMExt(Runtime* runtime, const RuntimeArgumentMap& runtime_options
                                    *Locks::jni_weak_globals_lock_)),
       env_hooks_lock_("environment hooks lock", art::kGenericBottomLock),
       env_hooks_(),
+      jni_env_cache_lock_("JNIEnv cache lock", art::kGenericBottomLock),
+      jni_env_cache_(),
+      jni_env_cache_enabled_(true),
       enable_allocation_tracking_delta_(
           runtime_options.GetOrDefault(RuntimeArgumentMap::GlobalRefAllocStackTraceLimit)),
       allocation_tracking_enabled_(false),
@@ -554,6 +558,41 @@ bool JavaVMExt::Initialize(std::string* error_msg) {
 
 JavaVMExt::~JavaVMExt() {
   UnloadBootNativeLibraries();
+  DCHECK(jni_env_cache_.empty());
+}
+
+void JavaVMExt::CacheJniEnv(JNIEnvExt* env) {
+  DCHECK_EQ(env->GetVm(), this);
+  if (env->ResetForReuse()) {
+    MutexLock mu(Thread::Current(), jni_env_cache_lock_);
+    if (jni_env_cache_enabled_ && jni_env_cache_.size() != kMaxCachedJniEnvs) {
+      jni_env_cache_.push_back(env);
+      return;
+    }
+  }
+  delete env;
+}
+
+JNIEnvExt* JavaVMExt::TakeCachedJniEnv() {
+  MutexLock mu(Thread::Current(), jni_env_cache_lock_);
+  if (jni_env_cache_.empty()) {
+    return nullptr;
+  }
+  JNIEnvExt* env = jni_env_cache_.back();
+  jni_env_cache_.pop_back();
+  return env;
+}
+
+void JavaVMExt::DeleteCachedJniEnvs() {
+  std::vector<JNIEnvExt*> envs;
+  {
+    MutexLock mu(Thread::Current(), jni_env_cache_lock_);
+    jni_env_cache_enabled_ = false;
+    envs.swap(jni_env_cache_);
+  }
+  for (JNIEnvExt* env : envs) {
+    delete env;
+  }
 }
 
 std::unique_ptr<JavaVMExt> JavaVMExt::Create(Runtime* runtime,
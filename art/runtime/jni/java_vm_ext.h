@@ -37,6 +37,7 @@ class Array;
 
 class ArtMethod;
 class IsMarkedVisitor;
+class JNIEnvExt;
 class Libraries;
 class ParsedOptions;
 class Runtime;
@@ -214,6 +215,18 @@ class JavaVMExt : public JavaVM {
 
   EXPORT void AddEnvironmentHook(GetEnvHook hook) REQUIRES(!env_hooks_lock_);
 
+  // Keep the `JNIEnvExt` of a detached thread for reuse by the next thread that is created or
+  // attached, or delete it if it cannot be reused or the cache is full. Native threads that
+  // attach and detach repeatedly then avoid allocating and initializing a new `JNIEnvExt`.
+  void CacheJniEnv(JNIEnvExt* env) REQUIRES(!jni_env_cache_lock_);
+
+  // Take a `JNIEnvExt` from the cache, or return null if the cache is empty.
+  JNIEnvExt* TakeCachedJniEnv() REQUIRES(!jni_env_cache_lock_);
+
+  // Delete the cached `JNIEnvExt`s and stop caching. Called on runtime shutdown, before
+  // the allocator of the local reference tables is deleted.
+  void DeleteCachedJniEnvs() REQUIRES(!jni_env_cache_lock_);
+
   static bool IsBadJniVersion(int version);
 
   // Return the library search path for the given classloader, if the classloader is of a
@@ -275,6 +288,12 @@ class JavaVMExt : public JavaVM {
   ReaderWriterMutex env_hooks_lock_ BOTTOM_MUTEX_ACQUIRED_AFTER;
   std::vector<GetEnvHook> env_hooks_ GUARDED_BY(env_hooks_lock_);
 
+  // The maximum number of `JNIEnvExt`s kept in `jni_env_cache_`.
+  static constexpr size_t kMaxCachedJniEnvs = 8u;
+  Mutex jni_env_cache_lock_ BOTTOM_MUTEX_ACQUIRED_AFTER;
+  std::vector<JNIEnvExt*> jni_env_cache_ GUARDED_BY(jni_env_cache_lock_);
+  bool jni_env_cache_enabled_ GUARDED_BY(jni_env_cache_lock_);
+
   size_t enable_allocation_tracking_delta_;
   std::atomic<bool> allocation_tracking_enabled_;
   std::atomic<bool> old_allocation_tracking_state_;
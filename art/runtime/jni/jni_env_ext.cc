@@ -60,6 +60,11 @@ jint JNIEnvExt::GetEnvHandler(JavaVMExt* vm, /*out*/void** env, jint version) {
 }
 
 JNIEnvExt* JNIEnvExt::Create(Thread* self_in, JavaVMExt* vm_in, std::string* error_msg) {
+  JNIEnvExt* cached = vm_in->TakeCachedJniEnv();
+  if (cached != nullptr) {
+    cached->Reuse(self_in);
+    return cached;
+  }
   std::unique_ptr<JNIEnvExt> ret(new JNIEnvExt(self_in, vm_in));
   if (!ret->Initialize(error_msg)) {
     return nullptr;
@@ -85,6 +90,25 @@ bool JNIEnvExt::Initialize(std::string* error_msg) {
   return locals_.Initialize(/*max_count=*/ 1u, error_msg);
 }
 
+bool JNIEnvExt::ResetForReuse() {
+  // Keep only the environments that did not grow and that the thread left in a clean state.
+  if (critical_ != 0u ||
+      runtime_deleted_.load(std::memory_order_relaxed) ||
+      !stacked_local_ref_cookies_.empty() ||
+      !locked_objects_.empty() ||
+      monitors_.Size() != 0u) {
+    return false;
+  }
+  return locals_.ResetForReuse();
+}
+
+void JNIEnvExt::Reuse(Thread* self_in) {
+  self_ = self_in;
+  // CheckJNI and the function table override may have changed since the `JNIEnvExt` was
+  // created, so set up the function tables like the constructor does.
+  SetCheckJniEnabled(vm_->IsCheckJniEnabled());
+}
+
 void JNIEnvExt::SetFunctionsToRuntimeShutdownFunctions() {
   functions = GetRuntimeShutdownNativeInterface();
 }
@@ -103,6 +103,10 @@ class JNIEnvExt : public JNIEnv {
   }
   JavaVMExt* GetVm() const { return vm_; }
 
+  // Prepare the `JNIEnvExt` of a detached thread for reuse by another thread. Returns false if
+  // it cannot be reused and should be deleted.
+  bool ResetForReuse();
+
   void SetRuntimeDeleted() { runtime_deleted_.store(true, std::memory_order_relaxed); }
   bool IsRuntimeDeleted() const { return runtime_deleted_.load(std::memory_order_relaxed); }
   bool IsCheckJniEnabled() const { return check_jni_; }
@@ -161,8 +165,12 @@ class JNIEnvExt : public JNIEnv {
   // Initialize the `JNIEnvExt` object.
   bool Initialize(std::string* error_msg);
 
-  // Link to Thread::Current().
-  Thread* const self_;
+  // Reinitialize a `JNIEnvExt` taken from the `JavaVMExt` cache for the thread `self`.
+  void Reuse(Thread* self) REQUIRES(!Locks::jni_function_table_lock_);
+
+  // Link to Thread::Current(). Not 'const' as the `JNIEnvExt` of a detached thread can be
+  // reused for a new thread, see `JavaVMExt::CacheJniEnv()`.
+  Thread* self_;
 
   // The invocation interface JavaVM.
   JavaVMExt* const vm_;
@@ -51,8 +51,9 @@ namespace jni {
 
 constexpr bool kTraceIds = false;
 
-// TODO This whole thing could be done lock & wait free (since we never remove anything from the
-// ids list). It's not clear this would be worthwile though.
+// Encoding already assigned ids goes through the ids arrays in `ClassExt` and decoding goes
+// through the `PublishedIdMap`s, neither of which takes the `jni_id_lock_`. Only assigning new
+// ids, and the deferred allocation handling below, take the lock.
 
 namespace {
 
@@ -262,6 +263,16 @@ template <>
 std::vector<ArtMethod*>& JniIdManager::GetGenericMap<ArtMethod>() {
   return method_id_map_;
 }
+template <>
+JniIdManager::PublishedIdMap<ArtField>& JniIdManager::GetPublishedMap<ArtField>() {
+  return published_field_id_map_;
+}
+
+template <>
+JniIdManager::PublishedIdMap<ArtMethod>& JniIdManager::GetPublishedMap<ArtMethod>() {
+  return published_method_id_map_;
+}
+
 template <>
 size_t JniIdManager::GetLinearSearchStartId<ArtField>(
     [[maybe_unused]] ReflectiveHandle<ArtField> t) {
@@ -381,6 +392,7 @@ uintptr_t JniIdManager::EncodeGenericId(ReflectiveHandle<ArtType> t) {
   vec.reserve(cur_index + 1);
   vec.resize(std::max(vec.size(), cur_index + 1), nullptr);
   vec[cur_index] = t.Get();
+  GetPublishedMap<ArtType>().Set(cur_index, t.Get());
   if (ids.IsNull()) {
     if (kIsDebugBuild && CanUseIdArrays(t)) {
       CHECK_NE(deferred_allocation_refcount_, 0u)
@@ -451,6 +463,7 @@ void JniIdManager::VisitReflectiveTargets(ReflectiveValueVisitor* rvv) {
         rvv->VisitField(old_field, JniIdReflectiveSourceInfo(reinterpret_cast<jfieldID>(id)));
     if (old_field != new_field) {
       *it = new_field;
+      published_field_id_map_.Set(IdToIndex(id), new_field);
       ObjPtr<mirror::Class> old_class(old_field->GetDeclaringClass());
       ObjPtr<mirror::Class> new_class(new_field->GetDeclaringClass());
       ObjPtr<mirror::ClassExt> old_ext_data(old_class->GetExtData());
@@ -504,6 +517,7 @@ void JniIdManager::VisitReflectiveTargets(ReflectiveValueVisitor* rvv) {
         rvv->VisitMethod(old_method, JniIdReflectiveSourceInfo(reinterpret_cast<jmethodID>(id)));
     if (old_method != new_method) {
       *it = new_method;
+      published_method_id_map_.Set(IdToIndex(id), new_method);
       ObjPtr<mirror::Class> old_class(old_method->GetDeclaringClass());
       ObjPtr<mirror::Class> new_class(new_method->GetDeclaringClass());
       ObjPtr<mirror::ClassExt> old_ext_data(old_class->GetExtData());
@@ -532,8 +546,13 @@ void JniIdManager::VisitReflectiveTargets(ReflectiveValueVisitor* rvv) {
 
 template <typename ArtType> ArtType* JniIdManager::DecodeGenericId(uintptr_t t) {
   if (Runtime::Current()->GetJniIdType() == JniIdType::kIndices && (t % 2) == 1) {
-    ReaderMutexLock mu(Thread::Current(), *Locks::jni_id_lock_);
     size_t index = IdToIndex(t);
+    ArtType* published = GetPublishedMap<ArtType>().Get(index);
+    if (LIKELY(published != nullptr)) {
+      return published;
+    }
+    // Not a valid id, or an id whose publication we have not yet seen.
+    ReaderMutexLock mu(Thread::Current(), *Locks::jni_id_lock_);
     DCHECK_GT(GetGenericMap<ArtType>().size(), index);
     return GetGenericMap<ArtType>().at(index);
   } else {
@@ -19,11 +19,13 @@
 
 #include <jni.h>
 
+#include <array>
 #include <atomic>
 #include <vector>
 
 #include "art_field.h"
 #include "art_method.h"
+#include "base/bit_utils.h"
 #include "base/mutex.h"
 #include "gc_root.h"
 #include "jni_id_type.h"
@@ -69,6 +71,64 @@ class JniIdManager {
   EXPORT ObjPtr<mirror::Object> GetPointerMarker() REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
+  // Append-only copy of an id -> field/method map that can be read without the `jni_id_lock_`,
+  // so that decoding index ids is cheap, as encoding already assigned ids is through the ids
+  // arrays in `ClassExt`. Entries live in chunks of doubling size that are never moved or freed
+  // before the manager, and are published with release stores after the entry in the map they
+  // mirror was written under the `jni_id_lock_`.
+  template <typename ArtType>
+  class PublishedIdMap {
+   public:
+    PublishedIdMap() = default;
+
+    ~PublishedIdMap() {
+      for (std::atomic<std::atomic<ArtType*>*>& chunk : chunks_) {
+        delete[] chunk.load(std::memory_order_relaxed);
+      }
+    }
+
+    // Returns null if no entry has been published for `index`.
+    ArtType* Get(size_t index) const {
+      size_t chunk_index = ChunkIndex(index);
+      if (UNLIKELY(chunk_index >= kMaxChunks)) {
+        return nullptr;
+      }
+      std::atomic<ArtType*>* chunk = chunks_[chunk_index].load(std::memory_order_acquire);
+      if (UNLIKELY(chunk == nullptr)) {
+        return nullptr;
+      }
+      return chunk[index - ChunkStart(chunk_index)].load(std::memory_order_acquire);
+    }
+
+    void Set(size_t index, ArtType* value) REQUIRES(Locks::jni_id_lock_) {
+      size_t chunk_index = ChunkIndex(index);
+      CHECK_LT(chunk_index, kMaxChunks) << "Too many JNI ids";
+      std::atomic<ArtType*>* chunk = chunks_[chunk_index].load(std::memory_order_relaxed);
+      if (chunk == nullptr) {
+        // Writers are serialized by the `jni_id_lock_`. The new chunk is all nulls.
+        chunk = new std::atomic<ArtType*>[kFirstChunkSize << chunk_index]();
+        chunks_[chunk_index].store(chunk, std::memory_order_release);
+      }
+      chunk[index - ChunkStart(chunk_index)].store(value, std::memory_order_release);
+    }
+
+   private:
+    static constexpr size_t kFirstChunkSize = 256u;
+    static constexpr size_t kMaxChunks = BitSizeOf<uint32_t>();
+
+    static size_t ChunkIndex(size_t index) {
+      return MostSignificantBit(index / kFirstChunkSize + 1u);
+    }
+
+    static size_t ChunkStart(size_t chunk_index) {
+      return kFirstChunkSize * ((static_cast<size_t>(1u) << chunk_index) - 1u);
+    }
+
+    std::array<std::atomic<std::atomic<ArtType*>*>, kMaxChunks> chunks_ = {};
+
+    DISALLOW_COPY_AND_ASSIGN(PublishedIdMap);
+  };
+
   template <typename ArtType>
   uintptr_t EncodeGenericId(ReflectiveHandle<ArtType> t) REQUIRES(!Locks::jni_id_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -76,6 +136,7 @@ class JniIdManager {
   ArtType* DecodeGenericId(uintptr_t input) REQUIRES(!Locks::jni_id_lock_);
   template <typename ArtType> std::vector<ArtType*>& GetGenericMap()
       REQUIRES(Locks::jni_id_lock_);
+  template <typename ArtType> PublishedIdMap<ArtType>& GetPublishedMap();
   template <typename ArtType> uintptr_t GetNextId(JniIdType id)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::jni_id_lock_);
@@ -92,6 +153,10 @@ class JniIdManager {
   uintptr_t next_field_id_ GUARDED_BY(Locks::jni_id_lock_) = 1u;
   std::vector<ArtField*> field_id_map_ GUARDED_BY(Locks::jni_id_lock_);
 
+  // Lock-free copies of `method_id_map_` and `field_id_map_` for decoding.
+  PublishedIdMap<ArtMethod> published_method_id_map_;
+  PublishedIdMap<ArtField> published_field_id_map_;
+
   // If non-zero indicates that some thread is trying to allocate ids without being able to update
   // the method->id mapping (due to not being able to allocate or something). In this case decode
   // and encode need to do a linear scan of the lists. The ScopedEnableSuspendAllJniIdQueries struct
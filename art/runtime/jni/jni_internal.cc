@@ -2174,13 +2174,7 @@ class JNI {
       if (heap->IsMovableObject(s)) {
         StackHandleScope<1> hs(soa.Self());
         HandleWrapperObjPtr<mirror::String> h(hs.NewHandleWrapper(&s));
-        if (!gUseReadBarrier && !gUseUserfaultfd) {
-          heap->IncrementDisableMovingGC(soa.Self());
-        } else {
-          // For the CC and CMC collector, we only need to wait for the thread flip rather
-          // than the whole GC to occur thanks to the to-space invariant.
-          heap->IncrementDisableThreadFlip(soa.Self());
-        }
+        heap->PinMovableObject(soa.Self(), s);
       }
       // Ensure that the string doesn't cause userfaults in case passed on to
       // the kernel.
@@ -2200,11 +2194,7 @@ class JNI {
     gc::Heap* heap = Runtime::Current()->GetHeap();
     ObjPtr<mirror::String> s = soa.Decode<mirror::String>(java_string);
     if (!s->IsCompressed() && heap->IsMovableObject(s)) {
-      if (!gUseReadBarrier && !gUseUserfaultfd) {
-        heap->DecrementDisableMovingGC(soa.Self());
-      } else {
-        heap->DecrementDisableThreadFlip(soa.Self());
-      }
+      heap->UnpinMovableObject(soa.Self(), s);
     }
     // TODO: For uncompressed strings GetStringCritical() always returns `s->GetValue()`.
     // Should we report an error if the user passes a different `chars`?
@@ -2367,14 +2357,8 @@ class JNI {
     }
     gc::Heap* heap = Runtime::Current()->GetHeap();
     if (heap->IsMovableObject(array)) {
-      if (!gUseReadBarrier && !gUseUserfaultfd) {
-        heap->IncrementDisableMovingGC(soa.Self());
-      } else {
-        // For the CC and CMC collector, we only need to wait for the thread flip rather
-        // than the whole GC to occur thanks to the to-space invariant.
-        heap->IncrementDisableThreadFlip(soa.Self());
-      }
-      // Re-decode in case the object moved since IncrementDisableGC waits for GC to complete.
+      heap->PinMovableObject(soa.Self(), array);
+      // Re-decode in case the object moved since PinMovableObject may wait for GC to complete.
       array = soa.Decode<mirror::Array>(java_array);
     }
     // Ensure that the array doesn't cause userfaults in case passed on to the kernel.
@@ -3024,12 +3008,8 @@ class JNI {
       if (is_copy) {
         delete[] reinterpret_cast<uint64_t*>(elements);
       } else if (heap->IsMovableObject(array)) {
-        // Non copy to a movable object must means that we had disabled the moving GC.
-        if (!gUseReadBarrier && !gUseUserfaultfd) {
-          heap->DecrementDisableMovingGC(soa.Self());
-        } else {
-          heap->DecrementDisableThreadFlip(soa.Self());
-        }
+        // Non copy to a movable object must means that we had pinned the object.
+        heap->UnpinMovableObject(soa.Self(), array);
       }
     }
   }
@@ -1270,6 +1270,25 @@ TEST_F(JniInternalTest, GetReleasePrimitiveArrayCriticalOfWrongType) {
   GetReleasePrimitiveArrayCriticalOfWrongType(true);
 }
 
+TEST_F(JniInternalTest, PrimitiveArrayCriticalDoesNotBlockGc) {
+  if (!gUseReadBarrier) {
+    // Only the CC collector pins the regions, the other collectors block the GC.
+    return;
+  }
+  jbyteArray array = env_->NewByteArray(16);
+  ASSERT_NE(array, nullptr);
+  jboolean is_copy;
+  void* elements = env_->GetPrimitiveArrayCritical(array, &is_copy);
+  ASSERT_NE(elements, nullptr);
+  EXPECT_EQ(is_copy, JNI_FALSE);
+  // The GC runs while the array is in a critical section, and does not move it.
+  Runtime::Current()->GetHeap()->CollectGarbage(/* clear_soft_references= */ false);
+  Runtime::Current()->GetHeap()->CollectGarbage(/* clear_soft_references= */ false);
+  EXPECT_EQ(elements, env_->GetPrimitiveArrayCritical(array, &is_copy));
+  env_->ReleasePrimitiveArrayCritical(array, elements, 0);
+  env_->ReleasePrimitiveArrayCritical(array, elements, 0);
+}
+
 TEST_F(JniInternalTest, GetPrimitiveArrayRegionElementsOfWrongType) {
   GetPrimitiveArrayRegionElementsOfWrongType(false);
   GetPrimitiveArrayRegionElementsOfWrongType(true);
@@ -176,6 +176,21 @@ bool LocalReferenceTable::Initialize(size_t max_count, std::string* error_msg) {
   return (max_count <= kSmallLrtEntries) || Resize(max_count, error_msg);
 }
 
+bool LocalReferenceTable::ResetForReuse() {
+  if (small_table_ == nullptr) {
+    return false;
+  }
+  DCHECK_EQ(max_entries_, kSmallLrtEntries);
+  DCHECK(tables_.empty());
+  previous_state_ = kLRTFirstSegment;
+  segment_state_ = kLRTFirstSegment;
+  free_entries_list_ =
+      FirstFreeField::Update(kFreeListEnd, free_entries_list_ & (1u << kFlagCheckJni));
+  // Clear the entries like `SmallLrtAllocator::Allocate()` does for a new table.
+  std::memset(small_table_, 0, kSmallLrtEntries * sizeof(LrtEntry));
+  return true;
+}
+
 LocalReferenceTable::~LocalReferenceTable() {
   SmallLrtAllocator* small_lrt_allocator =
       max_entries_ != 0u ? Runtime::Current()->GetSmallLrtAllocator() : nullptr;
@@ -324,6 +339,14 @@ IndirectRef LocalReferenceTable::Add(ObjPtr<mirror::Object> obj, std::string* er
         return store_obj(free_entry, "small_table/pruned-free-list");
       }
     }
+  } else if (LIKELY(free_entries_list_ == kEmptyFreeListAndCheckJniDisabled) &&
+             LIKELY(top_index != max_entries_)) {
+    // Fast-path for tables that have grown past the small table, with CheckJNI disabled.
+    // Tables are chained and never moved on growth, so we can index the right one directly.
+    // Threads keep their grown tables, so this is the common path after a JNI-heavy call.
+    LrtEntry* free_entry = GetEntry(top_index);
+    segment_state_.top_index = top_index + 1u;
+    return store_obj(free_entry, "tables/empty-free-list");
   }
   DCHECK(IsCheckJniEnabled() || small_table == nullptr || top_index == kSmallLrtEntries);
 
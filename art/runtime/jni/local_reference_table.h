@@ -361,6 +361,11 @@ class LocalReferenceTable {
   // Release pages past the end of the table that may have previously held references.
   void Trim() REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Remove all references so that the table can be reused by another thread. Returns false,
+  // leaving the table unchanged, if the table has grown past its initial small table. Such
+  // tables should be deleted instead, to release their memory.
+  bool ResetForReuse();
+
   /* Reference validation for CheckJNI and debug build. */
   bool IsValidReference(IndirectRef, /*out*/std::string* error_msg) const
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -1024,5 +1024,79 @@ TEST_F(LocalReferenceTableTest, PruneBeforeTrim) {
   ASSERT_EQ(new_ref, refs[0]);
 }
 
+TEST_F(LocalReferenceTableTest, GrownTablesKeepEntries) {
+  LocalReferenceTable lrt(/*check_jni=*/ false);
+  std::string error_msg;
+  bool success = lrt.Initialize(kSmallLrtEntries, &error_msg);
+  ASSERT_TRUE(success) << error_msg;
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::Class> c = hs.NewHandle(GetClassRoot<mirror::Object>());
+  Handle<mirror::Object> obj0 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj0 != nullptr);
+
+  // Grow the table over several small tables and one bigger table.
+  const size_t refs_per_page = gPageSize / sizeof(LrtEntry);
+  const size_t num_refs = 2 * refs_per_page + 1u;
+  std::vector<IndirectRef> first_round_refs;
+  for (size_t round = 0; round != 2u; ++round) {
+    const LRTSegmentState cookie = lrt.PushFrame();
+    std::vector<IndirectRef> refs;
+    for (size_t i = 0; i != num_refs; ++i) {
+      refs.push_back(lrt.Add((i % 2u == 0u) ? c.Get() : obj0.Get(), &error_msg));
+      ASSERT_TRUE(refs.back() != nullptr) << error_msg;
+    }
+    EXPECT_EQ(lrt.Capacity(), num_refs);
+    // Entries are never moved when the table grows.
+    for (size_t i = 0; i != num_refs; ++i) {
+      ASSERT_OBJ_PTR_EQ((i % 2u == 0u) ? c.Get() : obj0.Get(), lrt.Get(refs[i]));
+    }
+    // Popping the frame drops all references at once and the next round reuses the same entries.
+    lrt.PopFrame(cookie);
+    EXPECT_EQ(lrt.Capacity(), 0u);
+    if (round == 0u) {
+      first_round_refs = std::move(refs);
+    } else {
+      ASSERT_EQ(first_round_refs, refs);
+    }
+  }
+}
+
+TEST_F(LocalReferenceTableTest, ResetForReuse) {
+  for (bool check_jni : {false, true}) {
+    LocalReferenceTable lrt(check_jni);
+    std::string error_msg;
+    bool success = lrt.Initialize(/*max_count=*/ 1u, &error_msg);
+    ASSERT_TRUE(success) << error_msg;
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<1> hs(soa.Self());
+    Handle<mirror::Class> c = hs.NewHandle(GetClassRoot<mirror::Object>());
+
+    // A table that still uses its small table is emptied, including holes and frames,
+    // and can be filled again.
+    IndirectRef iref0 = lrt.Add(c.Get(), &error_msg);
+    ASSERT_TRUE(iref0 != nullptr) << error_msg;
+    IndirectRef iref1 = lrt.Add(c.Get(), &error_msg);
+    ASSERT_TRUE(iref1 != nullptr) << error_msg;
+    ASSERT_TRUE(lrt.Remove(iref0));
+    lrt.PushFrame();
+    ASSERT_TRUE(lrt.Add(c.Get(), &error_msg) != nullptr) << error_msg;
+    ASSERT_TRUE(lrt.ResetForReuse());
+    EXPECT_EQ(lrt.Capacity(), 0u);
+    EXPECT_EQ(lrt.IsCheckJniEnabled(), check_jni);
+    IndirectRef iref2 = lrt.Add(c.Get(), &error_msg);
+    ASSERT_TRUE(iref2 != nullptr) << error_msg;
+    EXPECT_EQ(lrt.Capacity(), 1u);
+    ASSERT_OBJ_PTR_EQ(c.Get(), lrt.Get(iref2));
+
+    // A grown table is not reused.
+    for (size_t i = 0; i != kSmallLrtEntries; ++i) {
+      ASSERT_TRUE(lrt.Add(c.Get(), &error_msg) != nullptr) << error_msg;
+    }
+    EXPECT_FALSE(lrt.ResetForReuse());
+    EXPECT_EQ(lrt.Capacity(), kSmallLrtEntries + 1u);
+  }
+}
+
 }  // namespace jni
 }  // namespace art
@@ -24,8 +24,12 @@
 
 namespace art HIDDEN {
 
-inline void LinearAlloc::SetFirstObject(void* begin, size_t bytes) const {
-  DCHECK(track_allocations_);
+inline LinearAlloc::Shard& LinearAlloc::GetShard(Thread* self) {
+  // Thread ids are small and assigned in sequence, so they spread well over the shards.
+  return shards_[(self != nullptr) ? self->GetThreadId() % kNumShards : 0u];
+}
+
+inline void LinearAlloc::Shard::SetFirstObject(void* begin, size_t bytes) const {
   if (ArenaAllocator::IsRunningOnMemoryTool()) {
     bytes += ArenaAllocator::kMemoryToolRedZoneBytes;
   }
@@ -53,9 +57,11 @@ inline void LinearAlloc::ConvertToNoGcRoots(void* ptr, LinearAllocKind orig_kind
 }
 
 inline void LinearAlloc::SetupForPostZygoteFork(Thread* self) {
-  MutexLock mu(self, lock_);
   DCHECK(track_allocations_);
-  allocator_.ResetCurrentArena();
+  for (Shard& shard : shards_) {
+    MutexLock mu(self, shard.lock_);
+    shard.allocator_.ResetCurrentArena();
+  }
 }
 
 inline void* LinearAlloc::Realloc(Thread* self,
@@ -63,7 +69,11 @@ inline void* LinearAlloc::Realloc(Thread* self,
                                   size_t old_size,
                                   size_t new_size,
                                   LinearAllocKind kind) {
-  MutexLock mu(self, lock_);
+  // The `ptr` may come from another shard, in which case the allocator of this shard
+  // cannot extend it in place and copies it.
+  Shard& shard = GetShard(self);
+  MutexLock mu(self, shard.lock_);
+  shard.allocated_bytes_[static_cast<size_t>(kind)] += new_size;
   if (track_allocations_) {
     if (ptr != nullptr) {
       // Realloc cannot be called on 16-byte aligned as Realloc doesn't guarantee
@@ -77,40 +87,44 @@ inline void* LinearAlloc::Realloc(Thread* self,
       DCHECK_EQ(old_size, 0u);
     }
     new_size += sizeof(TrackingHeader);
-    void* ret = allocator_.Realloc(ptr, old_size, new_size);
+    void* ret = shard.allocator_.Realloc(ptr, old_size, new_size);
     new (ret) TrackingHeader(new_size, kind);
-    SetFirstObject(ret, new_size);
+    shard.SetFirstObject(ret, new_size);
     return static_cast<TrackingHeader*>(ret) + 1;
   } else {
-    return allocator_.Realloc(ptr, old_size, new_size);
+    return shard.allocator_.Realloc(ptr, old_size, new_size);
   }
 }
 
 inline void* LinearAlloc::Alloc(Thread* self, size_t size, LinearAllocKind kind) {
-  MutexLock mu(self, lock_);
+  Shard& shard = GetShard(self);
+  MutexLock mu(self, shard.lock_);
+  shard.allocated_bytes_[static_cast<size_t>(kind)] += size;
   if (track_allocations_) {
     size += sizeof(TrackingHeader);
-    TrackingHeader* storage = new (allocator_.Alloc(size)) TrackingHeader(size, kind);
-    SetFirstObject(storage, size);
+    TrackingHeader* storage = new (shard.allocator_.Alloc(size)) TrackingHeader(size, kind);
+    shard.SetFirstObject(storage, size);
     return storage + 1;
   } else {
-    return allocator_.Alloc(size);
+    return shard.allocator_.Alloc(size);
   }
 }
 
 inline void* LinearAlloc::AllocAlign16(Thread* self, size_t size, LinearAllocKind kind) {
-  MutexLock mu(self, lock_);
+  Shard& shard = GetShard(self);
+  MutexLock mu(self, shard.lock_);
   DCHECK_ALIGNED(size, 16);
+  shard.allocated_bytes_[static_cast<size_t>(kind)] += size;
   if (track_allocations_) {
     size_t mem_tool_bytes = ArenaAllocator::IsRunningOnMemoryTool()
                             ? ArenaAllocator::kMemoryToolRedZoneBytes : 0;
-    uint8_t* ptr = allocator_.CurrentPtr() + sizeof(TrackingHeader);
+    uint8_t* ptr = shard.allocator_.CurrentPtr() + sizeof(TrackingHeader);
     uintptr_t padding =
         RoundUp(reinterpret_cast<uintptr_t>(ptr), 16) - reinterpret_cast<uintptr_t>(ptr);
     DCHECK_LT(padding, 16u);
     size_t required_size = size + sizeof(TrackingHeader) + padding;
 
-    if (allocator_.CurrentArenaUnusedBytes() < required_size + mem_tool_bytes) {
+    if (shard.allocator_.CurrentArenaUnusedBytes() < required_size + mem_tool_bytes) {
       // The allocator will require a new arena, which is expected to be
       // 16-byte aligned.
       static_assert(ArenaAllocator::kArenaAlignment >= 16,
@@ -120,28 +134,48 @@ inline void* LinearAlloc::AllocAlign16(Thread* self, size_t size, LinearAllocKin
     // Using ArenaAllocator's AllocAlign16 now would disturb the alignment by
     // trying to make header 16-byte aligned. The alignment requirements are
     // already addressed here. Now we want allocator to just bump the pointer.
-    ptr = static_cast<uint8_t*>(allocator_.Alloc(required_size));
+    ptr = static_cast<uint8_t*>(shard.allocator_.Alloc(required_size));
     new (ptr) TrackingHeader(required_size, kind, /*is_16_aligned=*/true);
-    SetFirstObject(ptr, required_size);
+    shard.SetFirstObject(ptr, required_size);
     return AlignUp(ptr + sizeof(TrackingHeader), 16);
   } else {
-    return allocator_.AllocAlign16(size);
+    return shard.allocator_.AllocAlign16(size);
   }
 }
 
 inline size_t LinearAlloc::GetUsedMemory() const {
-  MutexLock mu(Thread::Current(), lock_);
-  return allocator_.BytesUsed();
+  size_t used = 0u;
+  for (const Shard& shard : shards_) {
+    MutexLock mu(Thread::Current(), shard.lock_);
+    used += shard.allocator_.BytesUsed();
+  }
+  return used;
+}
+
+inline void LinearAlloc::AddAllocatedBytes(
+    /*inout*/ std::array<size_t, kNumLinearAllocKinds>* bytes) const {
+  for (const Shard& shard : shards_) {
+    MutexLock mu(Thread::Current(), shard.lock_);
+    for (size_t i = 0; i != kNumLinearAllocKinds; ++i) {
+      (*bytes)[i] += shard.allocated_bytes_[i];
+    }
+  }
 }
 
 inline ArenaPool* LinearAlloc::GetArenaPool() {
-  MutexLock mu(Thread::Current(), lock_);
-  return allocator_.GetArenaPool();
+  // All the shards allocate from the same pool.
+  MutexLock mu(Thread::Current(), shards_[0].lock_);
+  return shards_[0].allocator_.GetArenaPool();
 }
 
 inline bool LinearAlloc::Contains(void* ptr) const {
-  MutexLock mu(Thread::Current(), lock_);
-  return allocator_.Contains(ptr);
+  for (const Shard& shard : shards_) {
+    MutexLock mu(Thread::Current(), shard.lock_);
+    if (shard.allocator_.Contains(ptr)) {
+      return true;
+    }
+  }
+  return false;
 }
 
 }  // namespace art
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_LINEAR_ALLOC_H_
 #define ART_RUNTIME_LINEAR_ALLOC_H_
 
+#include <array>
+
 #include "base/arena_allocator.h"
 #include "base/casts.h"
 #include "base/macros.h"
@@ -35,6 +37,9 @@ enum class LinearAllocKind : uint32_t {
   kArtMethod
 };
 
+static constexpr size_t kNumLinearAllocKinds =
+    static_cast<size_t>(LinearAllocKind::kArtMethod) + 1u;
+
 // Header for every allocation in LinearAlloc. The header provides the type
 // and size information to the GC for invoking the right visitor.
 class TrackingHeader final {
@@ -76,48 +81,76 @@ class LinearAlloc {
   static_assert(sizeof(TrackingHeader) == ArenaAllocator::kAlignment);
 
   explicit LinearAlloc(ArenaPool* pool, bool track_allocs)
-      : lock_("linear alloc"), allocator_(pool), track_allocations_(track_allocs) {}
+      : shards_{Shard(pool), Shard(pool), Shard(pool), Shard(pool)},
+        track_allocations_(track_allocs) {}
 
-  void* Alloc(Thread* self, size_t size, LinearAllocKind kind) REQUIRES(!lock_);
-  void* AllocAlign16(Thread* self, size_t size, LinearAllocKind kind) REQUIRES(!lock_);
+  void* Alloc(Thread* self, size_t size, LinearAllocKind kind);
+  void* AllocAlign16(Thread* self, size_t size, LinearAllocKind kind);
 
   // Realloc never frees the input pointer, it is the caller's job to do this if necessary.
-  void* Realloc(Thread* self, void* ptr, size_t old_size, size_t new_size, LinearAllocKind kind)
-      REQUIRES(!lock_);
+  void* Realloc(Thread* self, void* ptr, size_t old_size, size_t new_size, LinearAllocKind kind);
 
   // Allocate an array of structs of type T.
   template<class T>
-  T* AllocArray(Thread* self, size_t elements, LinearAllocKind kind) REQUIRES(!lock_) {
+  T* AllocArray(Thread* self, size_t elements, LinearAllocKind kind) {
     return reinterpret_cast<T*>(Alloc(self, elements * sizeof(T), kind));
   }
 
   // Return the number of bytes used in the allocator.
-  size_t GetUsedMemory() const REQUIRES(!lock_);
+  size_t GetUsedMemory() const;
+
+  // Add the number of bytes requested for each kind, including the old storage of reallocations
+  // but not the tracking headers, to `bytes`.
+  void AddAllocatedBytes(/*inout*/ std::array<size_t, kNumLinearAllocKinds>* bytes) const;
 
-  ArenaPool* GetArenaPool() REQUIRES(!lock_);
+  ArenaPool* GetArenaPool();
   // Force arena allocator to ask for a new arena on next allocation. This
   // is to preserve private/shared clean pages across zygote fork.
-  void SetupForPostZygoteFork(Thread* self) REQUIRES(!lock_);
+  void SetupForPostZygoteFork(Thread* self);
   // Convert the given allocated object into a `no GC-root` so that compaction
   // skips it. Currently only used during class linking for ArtMethod array.
   void ConvertToNoGcRoots(void* ptr, LinearAllocKind orig_kind);
 
   // Return true if the linear alloc contains an address.
-  bool Contains(void* ptr) const REQUIRES(!lock_);
+  bool Contains(void* ptr) const;
 
   // Unsafe version of 'Contains' only to be used when the allocator is going
   // to be deleted.
   bool ContainsUnsafe(void* ptr) const NO_THREAD_SAFETY_ANALYSIS {
-    return allocator_.Contains(ptr);
+    for (const Shard& shard : shards_) {
+      if (shard.allocator_.Contains(ptr)) {
+        return true;
+      }
+    }
+    return false;
   }
 
-  // Set the given object as the first object for all the pages where the
-  // page-beginning overlaps with the object.
-  void SetFirstObject(void* begin, size_t bytes) const REQUIRES(lock_);
-
  private:
-  mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
-  ArenaAllocator allocator_ GUARDED_BY(lock_);
+  // The allocations are spread over a few shards by thread, so that threads loading classes
+  // in parallel do not contend on a single lock. Each shard allocates from its own arenas,
+  // so the objects of an arena still follow each other with their `TrackingHeader`s, as the
+  // compaction of the linear alloc arenas expects. A shard only takes an arena when a thread
+  // first allocates from it.
+  static constexpr size_t kNumShards = 4u;
+
+  class Shard {
+   public:
+    explicit Shard(ArenaPool* pool)
+        : lock_("linear alloc"), allocator_(pool), allocated_bytes_() {}
+
+    // Set the given object as the first object for all the pages where the
+    // page-beginning overlaps with the object.
+    void SetFirstObject(void* begin, size_t bytes) const REQUIRES(lock_);
+
+    mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+    ArenaAllocator allocator_ GUARDED_BY(lock_);
+    std::array<size_t, kNumLinearAllocKinds> allocated_bytes_ GUARDED_BY(lock_);
+  };
+
+  Shard& GetShard(Thread* self);
+
+  Shard shards_[kNumShards];
+  static_assert(kNumShards == 4u, "Update the initialization of `shards_`");
   const bool track_allocations_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(LinearAlloc);
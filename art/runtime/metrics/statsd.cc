@@ -195,6 +195,35 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
     case DatumId::kTimeElapsedDelta:
       return std::make_optional(
           statsd::ART_DATUM_DELTA_REPORTED__KIND__ART_DATUM_DELTA_TIME_ELAPSED_MS);
+    // Not reported to statsd (yet).
+    case DatumId::kJitBaselineCompileTime:
+    case DatumId::kJitOptimizedCompileTime:
+    case DatumId::kJitOsrCompileTime:
+    case DatumId::kJitCompileArenaKb:
+    case DatumId::kJitCompileInlinedMethods:
+    case DatumId::kJitCompileCodeSize:
+    case DatumId::kSoftReferenceProcessedCount:
+    case DatumId::kWeakReferenceProcessedCount:
+    case DatumId::kFinalizerReferenceProcessedCount:
+    case DatumId::kPhantomReferenceProcessedCount:
+    case DatumId::kSoftReferenceProcessingTime:
+    case DatumId::kWeakReferenceProcessingTime:
+    case DatumId::kFinalizerReferenceProcessingTime:
+    case DatumId::kPhantomReferenceProcessingTime:
+    case DatumId::kGcPauseTime:
+    case DatumId::kJitTimeToOptimizedCode:
+    case DatumId::kStartupReleasedImageMetadataBytes:
+    case DatumId::kStartupReleasedLinearAllocBytes:
+    case DatumId::kStartupReleasedArenaPoolBytes:
+    case DatumId::kStartupRuntimeInitTime:
+    case DatumId::kStartupHeapCreationTime:
+    case DatumId::kStartupBootImageMappedKb:
+    case DatumId::kStartupClassLinkerInitTime:
+    case DatumId::kStartupJitCreationTime:
+    case DatumId::kLockContentionWaitTime:
+    case DatumId::kStringsFromUtf16Count:
+    case DatumId::kStringsFromUtf16CompressedCount:
+      return std::nullopt;
   }
 }
 
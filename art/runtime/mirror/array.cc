@@ -61,8 +61,38 @@ static ObjPtr<Array> RecursiveCreateMultiArray(Thread* self,
     return nullptr;
   }
   if (current_dimension + 1 < dimensions->GetLength()) {
+    // When the sub-arrays are the innermost dimension, they all have the same size and can be
+    // allocated together from the thread-local allocation buffer.
+    const bool innermost = current_dimension + 2 == dimensions->GetLength();
+    const int32_t sub_array_length = innermost ? dimensions->Get(current_dimension + 1) : 0;
+    const size_t sub_array_size =
+        innermost ? ComputeArraySize(sub_array_length, h_component_type->GetComponentSizeShift())
+                  : 0u;
+    gc::Heap* heap = Runtime::Current()->GetHeap();
     // Create a new sub-array in every element of the array.
     for (int32_t i = 0; i < array_length; i++) {
+      if (innermost && sub_array_size != 0u) {
+        SetLengthVisitor visitor(sub_array_length);
+        ObjPtr<ObjectArray<Array>> outer = new_array->AsObjectArray<Array>();
+        const int32_t start = i;
+        i += heap->AllocObjectsInTlab(
+            self,
+            h_component_type.Get(),
+            sub_array_size,
+            array_length - i,
+            heap->GetCurrentAllocator(),
+            visitor,
+            [outer, start](mirror::Object* obj, size_t index)
+                REQUIRES_SHARED(Locks::mutator_lock_) {
+              // Use non-transactional mode without check.
+              outer->Set<false, false>(start + index, ObjPtr<Array>::DownCast(obj));
+            });
+        if (i == array_length) {
+          break;
+        }
+      }
+      // Allocate the next sub-array individually. For the innermost dimension, this happens when
+      // the remaining sub-arrays do not fit and may refill the thread-local allocation buffer.
       ObjPtr<Array> sub_array =
           RecursiveCreateMultiArray(self, h_component_type, current_dimension + 1, dimensions);
       if (UNLIKELY(sub_array == nullptr)) {
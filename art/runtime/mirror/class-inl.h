@@ -35,6 +35,7 @@
 #include "hidden_api.h"
 #include "iftable-inl.h"
 #include "imtable.h"
+#include "interface_check_cache.h"
 #include "object-inl.h"
 #include "read_barrier-inl.h"
 #include "runtime.h"
@@ -388,6 +389,9 @@ inline bool Class::Implements(ObjPtr<Class> klass) {
   // recursively all super-interfaces of those interfaces, are listed
   // in iftable_, so we can just do a linear scan through that.
   int32_t iftable_count = GetIfTableCount();
+  if (UNLIKELY(iftable_count >= InterfaceCheckCache::kMinIfTableCount)) {
+    return ImplementsWithCache(klass, iftable_count);
+  }
   ObjPtr<IfTable> iftable = GetIfTable();
   for (int32_t i = 0; i < iftable_count; i++) {
     if (iftable->GetInterface(i) == klass) {
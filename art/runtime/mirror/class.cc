@@ -526,6 +526,33 @@ bool Class::IsThrowableClass() {
   return GetClassRoot<mirror::Throwable>()->IsAssignableFrom(this);
 }
 
+bool Class::ImplementsWithCache(ObjPtr<Class> klass, int32_t iftable_count) {
+  DCHECK_EQ(iftable_count, GetIfTableCount());
+  auto scan_iftable = [&]() REQUIRES_SHARED(Locks::mutator_lock_) {
+    ObjPtr<IfTable> iftable = GetIfTable();
+    for (int32_t i = 0; i < iftable_count; i++) {
+      if (iftable->GetInterface(i) == klass) {
+        return true;
+      }
+    }
+    return false;
+  };
+  Thread* self = Thread::Current();
+  if (UNLIKELY(self == nullptr)) {
+    return scan_iftable();
+  }
+  InterfaceCheckCache* cache = self->GetInterfaceCheckCache();
+  uint32_t gc_num = Runtime::Current()->GetHeap()->GetCurrentGcNum();
+  bool implements;
+  if (cache->Get(gc_num, this, klass.Ptr(), &implements)) {
+    DCHECK_EQ(implements, scan_iftable());
+    return implements;
+  }
+  implements = scan_iftable();
+  cache->Set(gc_num, this, klass.Ptr(), implements);
+  return implements;
+}
+
 template <typename SignatureType>
 static inline ArtMethod* FindInterfaceMethodWithSignature(ObjPtr<Class> klass,
                                                           std::string_view name,
@@ -672,6 +672,11 @@ class EXPORT MANAGED Class final : public Object {
   // Check if this class implements a given interface.
   bool Implements(ObjPtr<Class> klass) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Check if this class, with `iftable_count` interfaces, implements a given interface,
+  // using the thread-local `InterfaceCheckCache`.
+  EXPORT bool ImplementsWithCache(ObjPtr<Class> klass, int32_t iftable_count)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Checks if 'klass' is a redefined version of this.
   bool IsObsoleteVersionOf(ObjPtr<Class> klass) REQUIRES_SHARED(Locks::mutator_lock_);
 
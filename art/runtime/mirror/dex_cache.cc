@@ -193,6 +193,7 @@ bool DexCache::ShouldAllocateFullArrayAtStartup() {
 
   const OatDexFile* oat_dex_file = GetDexFile()->GetOatDexFile();
   if (oat_dex_file != nullptr &&
+      oat_dex_file->GetOatFile() != nullptr &&
       CompilerFilter::IsAotCompilationEnabled(oat_dex_file->GetOatFile()->GetCompilerFilter())) {
     // We only allocate full arrays for dex files where we do not have
     // compilation.
@@ -202,6 +203,22 @@ bool DexCache::ShouldAllocateFullArrayAtStartup() {
   return true;
 }
 
+bool DexCache::ShouldPromoteToFullArray() {
+  Runtime* runtime = Runtime::Current();
+  if (runtime->IsAotCompiler()) {
+    // To save on memory in dex2oat, we keep the hashed arrays.
+    return false;
+  }
+
+  if (runtime->GetStartupLinearAlloc() != nullptr) {
+    // During startup, and in the zygote, the choice between hashed and full arrays
+    // is made by `ShouldAllocateFullArrayAtStartup()`.
+    return false;
+  }
+
+  return true;
+}
+
 void DexCache::UnlinkStartupCaches() {
   if (GetDexFile() == nullptr) {
     // Unused dex cache.
@@ -141,6 +141,23 @@ template <typename T, size_t size> class NativeDexCachePairArray {
     SetNativePair(entries_, SlotIndex(index), value);
   }
 
+  // Returns whether storing the entry for `index` evicts the entry of another index.
+  bool IsConflict(uint32_t index) {
+    uint32_t slot = SlotIndex(index);
+    size_t old_index = GetNativePair(entries_, slot).index;
+    return old_index != index && old_index != NativeDexCachePair<T>::InvalidIndexForSlot(slot);
+  }
+
+  // Increments the number of conflicting stores and returns the new count. The count
+  // is kept in the extra slot allocated after the entries.
+  uint32_t IncrementConflicts() {
+    auto* count = reinterpret_cast<std::atomic<uint32_t>*>(&entries_[size]);
+    return count->fetch_add(1u, std::memory_order_relaxed) + 1u;
+  }
+
+  // Number of slots to allocate, including the one holding the conflict count.
+  static constexpr size_t kNumSlots = size + 1u;
+
  private:
   NativeDexCachePair<T> GetNativePair(std::atomic<NativeDexCachePair<T>>* pair_array, size_t idx) {
     auto* array = reinterpret_cast<AtomicPair<uintptr_t>*>(pair_array);
@@ -195,6 +212,23 @@ template <typename T, size_t size> class DexCachePairArray {
     }
   }
 
+  // Returns whether storing the entry for `index` evicts the entry of another index.
+  bool IsConflict(uint32_t index) {
+    uint32_t slot = SlotIndex(index);
+    uint32_t old_index = entries_[slot].load(std::memory_order_relaxed).index;
+    return old_index != index && old_index != DexCachePair<T>::InvalidIndexForSlot(slot);
+  }
+
+  // Increments the number of conflicting stores and returns the new count. The count
+  // is kept in the extra slot allocated after the entries.
+  uint32_t IncrementConflicts() {
+    auto* count = reinterpret_cast<std::atomic<uint32_t>*>(&entries_[size]);
+    return count->fetch_add(1u, std::memory_order_relaxed) + 1u;
+  }
+
+  // Number of slots to allocate, including the one holding the conflict count.
+  static constexpr size_t kNumSlots = size + 1u;
+
  private:
   uint32_t SlotIndex(uint32_t index) {
     return index % size;
@@ -392,6 +426,10 @@ class MANAGED DexCache final : public Object {
     return number_of_elements <= dex_cache_size;
   }
 
+  // Number of stores evicting the entry of another index, per slot of a hashed array,
+  // after which we switch to a full array for that kind of entries.
+  static constexpr uint32_t kConflictsPerSlotForFullArray = 4u;
+
 
 // NOLINTBEGIN(bugprone-macro-parentheses)
 #define DEFINE_ARRAY(name, array_kind, getter_setter, type, ids, alloc_kind) \
@@ -436,7 +474,7 @@ class MANAGED DexCache final : public Object {
       REQUIRES_SHARED(Locks::mutator_lock_) { \
     return reinterpret_cast<pair_kind ##Array<type, size>*>( \
         AllocArray<std::atomic<pair_kind<type>>>( \
-            getter_setter ##Offset(), size, alloc_kind)); \
+            getter_setter ##Offset(), pair_kind ##Array<type, size>::kNumSlots, alloc_kind)); \
   } \
   template<VerifyObjectFlags kVerifyFlags = kDefaultVerifyFlags> \
   size_t Num ##getter_setter() REQUIRES_SHARED(Locks::mutator_lock_) { \
@@ -479,6 +517,13 @@ class MANAGED DexCache final : public Object {
           pairs = Allocate ##getter_setter(); \
           pairs->Set(index, resolved); \
         } \
+      } else if (UNLIKELY(pairs->IsConflict(index)) && \
+                 pairs->IncrementConflicts() >= kConflictsPerSlotForFullArray * pair_size && \
+                 ShouldPromoteToFullArray()) { \
+        /* Too many collisions, switch to a full array. Entries still in the hashed */ \
+        /* array get resolved again on their next use. */ \
+        array = Allocate ##getter_setter ##Array(); \
+        array->Set(index, resolved); \
       } else { \
         pairs->Set(index, resolved); \
       } \
@@ -486,7 +531,9 @@ class MANAGED DexCache final : public Object {
   } \
   void Unlink ##getter_setter ##ArrayIfStartup() \
       REQUIRES_SHARED(Locks::mutator_lock_) { \
-    if (!ShouldAllocateFullArray(GetDexFile()->ids(), pair_size)) { \
+    /* A full array allocated alongside a hashed array was promoted and is kept. */ \
+    if (!ShouldAllocateFullArray(GetDexFile()->ids(), pair_size) && \
+        Get ##getter_setter() == nullptr) { \
       Set ##getter_setter ##Array(nullptr) ; \
     } \
   }
@@ -573,6 +620,10 @@ class MANAGED DexCache final : public Object {
   // the runtime and oat files.
   bool ShouldAllocateFullArrayAtStartup() REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns whether we can replace a hashed array with many conflicts with a full
+  // array, given the current state of the runtime.
+  bool ShouldPromoteToFullArray() REQUIRES_SHARED(Locks::mutator_lock_);
+
   HeapReference<ClassLoader> class_loader_;
   HeapReference<String> location_;
 
@@ -72,6 +72,36 @@ TEST_F(DexCacheMethodHandlesTest, Open) {
   EXPECT_EQ(0u, dex_cache->NumResolvedMethodTypes());
 }
 
+TEST_F(DexCacheTest, PromoteToFullArrayOnConflicts) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<1> hs(soa.Self());
+  ASSERT_TRUE(java_lang_dex_file_ != nullptr);
+  Handle<DexCache> dex_cache(
+      hs.NewHandle(class_linker_->AllocAndInitializeDexCache(
+          soa.Self(), *java_lang_dex_file_, /*class_loader=*/nullptr)));
+  ASSERT_TRUE(dex_cache != nullptr);
+  constexpr uint32_t kCacheSize = DexCache::kDexCacheMethodCacheSize;
+  ASSERT_GT(java_lang_dex_file_->NumMethodIds(), kCacheSize);
+
+  // Hashed arrays are only promoted once startup has completed.
+  std::unique_ptr<LinearAlloc> startup_linear_alloc(runtime_->ReleaseStartupLinearAlloc());
+  ArtMethod* method = runtime_->GetResolutionMethod();
+
+  // Alternate between two method indexes that map to the same slot.
+  constexpr uint32_t kThreshold = DexCache::kConflictsPerSlotForFullArray * kCacheSize;
+  for (uint32_t i = 0; i <= kThreshold; ++i) {
+    EXPECT_EQ(nullptr, dex_cache->GetResolvedMethodsArray());
+    dex_cache->SetResolvedMethodsEntry((i % 2u) * kCacheSize, method);
+  }
+  ASSERT_NE(nullptr, dex_cache->GetResolvedMethodsArray());
+  EXPECT_EQ(method, dex_cache->GetResolvedMethodsEntry(kThreshold % 2u * kCacheSize));
+  EXPECT_EQ(java_lang_dex_file_->NumMethodIds(), dex_cache->NumResolvedMethodsArray());
+
+  // A promoted array is not a startup array.
+  dex_cache->UnlinkStartupCaches();
+  EXPECT_NE(nullptr, dex_cache->GetResolvedMethodsArray());
+}
+
 TEST_F(DexCacheTest, TestResolvedFieldAccess) {
   ScopedObjectAccess soa(Thread::Current());
   jobject jclass_loader(LoadDex("Packages"));
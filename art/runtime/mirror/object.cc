@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <sched.h>
+
 #include <ctime>
 
 #include "object.h"
@@ -116,10 +118,22 @@ void Object::CopyRawObjectData(uint8_t* dst_bytes,
 ObjPtr<Object> Object::CopyObject(ObjPtr<mirror::Object> dest,
                                   ObjPtr<mirror::Object> src,
                                   size_t num_bytes) {
+  bool needs_read_barrier = gUseReadBarrier;
+  if (gUseReadBarrier && kUseBakerReadBarrier) {
+    uintptr_t fake_address_dependency;
+    if (!ReadBarrier::IsGray(src.Ptr(), &fake_address_dependency)) {
+      // The references of a non-gray `src` are not from-space references. The fake address
+      // dependency orders the raw copy below after the gray check.
+      DCHECK_EQ(fake_address_dependency, 0U);
+      src.Assign(reinterpret_cast<mirror::Object*>(
+          reinterpret_cast<uintptr_t>(src.Ptr()) | fake_address_dependency));
+      needs_read_barrier = false;
+    }
+  }
   // Copy everything but the header.
   CopyRawObjectData(reinterpret_cast<uint8_t*>(dest.Ptr()), src, num_bytes - sizeof(Object));
 
-  if (gUseReadBarrier) {
+  if (needs_read_barrier) {
     // We need a RB here. After copying the whole object above, copy references fields one by one
     // again with a RB to make sure there are no from space refs. TODO: Optimize this later?
     CopyReferenceFieldsWithReadBarrierVisitor visitor(dest);
@@ -188,6 +202,7 @@ void Object::SetHashCodeSeed(uint32_t new_seed) {
 template <bool kAllowInflation>
 int32_t Object::IdentityHashCodeHelper() {
   ObjPtr<Object> current_this = this;  // The this pointer may get invalidated by thread suspension.
+  size_t yield_count = 0;
   while (true) {
     LockWord lw = current_this->GetLockWord(false);
     switch (lw.GetState()) {
@@ -207,9 +222,18 @@ int32_t Object::IdentityHashCodeHelper() {
         if (!kAllowInflation) {
           return 0;
         }
+        Thread* self = Thread::Current();
+        // A thin lock held by another thread is usually released soon. Like `MonitorEnter()`,
+        // yield for a while and then install the hash in the unlocked lock word, instead of
+        // suspending the owner to inflate a monitor only to hold the hash code.
+        if (lw.ThinLockOwner() != self->GetThreadId() &&
+            yield_count < Runtime::Current()->GetMaxSpinsBeforeThinLockInflation()) {
+          ++yield_count;
+          sched_yield();
+          break;
+        }
         // Inflate the thin lock to a monitor and stick the hash code inside of the monitor. May
         // fail spuriously.
-        Thread* self = Thread::Current();
         StackHandleScope<1> hs(self);
         Handle<mirror::Object> h_this(hs.NewHandle(current_this));
         Monitor::InflateThinLocked(self, h_this, lw, GenerateIdentityHashCode());
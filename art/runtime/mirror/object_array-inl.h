@@ -101,122 +101,111 @@ inline ObjPtr<T> ObjectArray<T>::GetWithoutChecks(int32_t i) {
 }
 
 template<class T>
-inline void ObjectArray<T>::AssignableMemmove(int32_t dst_pos,
-                                              ObjPtr<ObjectArray<T>> src,
-                                              int32_t src_pos,
-                                              int32_t count) {
-  if (kIsDebugBuild) {
-    for (int i = 0; i < count; ++i) {
-      // The get will perform the VerifyObject.
-      src->GetWithoutChecks(src_pos + i);
+inline bool ObjectArray<T>::CanCopyWithoutReadBarrier(/*inout*/ ObjPtr<ObjectArray<T>>* src) {
+  if (!gUseReadBarrier) {
+    return true;
+  }
+  if (kUseBakerReadBarrier) {
+    uintptr_t fake_address_dependency;
+    if (!ReadBarrier::IsGray(src->Ptr(), &fake_address_dependency)) {
+      DCHECK_EQ(fake_address_dependency, 0U);
+      src->Assign(reinterpret_cast<ObjectArray<T>*>(
+          reinterpret_cast<uintptr_t>(src->Ptr()) | fake_address_dependency));
+      return true;
     }
   }
-  // Perform the memmove using int memmove then perform the write barrier.
+  return false;
+}
+
+template<class T>
+inline void ObjectArray<T>::CopyReferenceWords(uint32_t* dst,
+                                               const uint32_t* src,
+                                               size_t count,
+                                               bool copy_forward) {
   static_assert(sizeof(HeapReference<T>) == sizeof(uint32_t),
                 "art::mirror::HeapReference<T> and uint32_t have different sizes.");
-  // TODO: Optimize this later?
-  // We can't use memmove since it does not handle read barriers and may do by per byte copying.
-  // See b/32012820.
-  const bool copy_forward = (src != this) || (dst_pos < src_pos) || (dst_pos - src_pos >= count);
+  // We can't use memmove since it may do by per byte copying and the GC may read the
+  // references concurrently. See b/32012820. Copy whole words instead, two at a time when
+  // `dst` and `src` have the same alignment modulo 8, as aligned 64-bit loads and stores do
+  // not tear on 64-bit targets. The words are the encoded references, so this is also
+  // correct with heap poisoning.
+  auto copy_word = [](uint32_t* d, const uint32_t* s) ALWAYS_INLINE {
+    reinterpret_cast<Atomic<uint32_t>*>(d)->store(
+        reinterpret_cast<const Atomic<uint32_t>*>(s)->load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+  };
+  auto copy_double_word = [](uint32_t* d, const uint32_t* s) ALWAYS_INLINE {
+    reinterpret_cast<Atomic<uint64_t>*>(d)->store(
+        reinterpret_cast<const Atomic<uint64_t>*>(s)->load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+  };
+  const bool wide = sizeof(void*) == sizeof(uint64_t) &&
+      IsAligned<sizeof(uint64_t)>(reinterpret_cast<uintptr_t>(dst) -
+                                  reinterpret_cast<uintptr_t>(src));
   if (copy_forward) {
-    // Forward copy.
-    bool baker_non_gray_case = false;
-    if (gUseReadBarrier && kUseBakerReadBarrier) {
-      uintptr_t fake_address_dependency;
-      if (!ReadBarrier::IsGray(src.Ptr(), &fake_address_dependency)) {
-        baker_non_gray_case = true;
-        DCHECK_EQ(fake_address_dependency, 0U);
-        src.Assign(reinterpret_cast<ObjectArray<T>*>(
-            reinterpret_cast<uintptr_t>(src.Ptr()) | fake_address_dependency));
-        for (int i = 0; i < count; ++i) {
-          // We can skip the RB here because 'src' isn't gray.
-          ObjPtr<T> obj = src->template GetWithoutChecks<kDefaultVerifyFlags, kWithoutReadBarrier>(
-              src_pos + i);
-          SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
-        }
+    size_t i = 0u;
+    if (wide) {
+      if (count != 0u && !IsAligned<sizeof(uint64_t)>(dst)) {
+        copy_word(dst, src);
+        i = 1u;
       }
-    }
-    if (!baker_non_gray_case) {
-      for (int i = 0; i < count; ++i) {
-        // We need a RB here. ObjectArray::GetWithoutChecks() contains a RB.
-        ObjPtr<T> obj = src->GetWithoutChecks(src_pos + i);
-        SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
+      for (; i + 2u <= count; i += 2u) {
+        copy_double_word(dst + i, src + i);
       }
     }
+    for (; i != count; ++i) {
+      copy_word(dst + i, src + i);
+    }
   } else {
-    // Backward copy.
-    bool baker_non_gray_case = false;
-    if (gUseReadBarrier && kUseBakerReadBarrier) {
-      uintptr_t fake_address_dependency;
-      if (!ReadBarrier::IsGray(src.Ptr(), &fake_address_dependency)) {
-        baker_non_gray_case = true;
-        DCHECK_EQ(fake_address_dependency, 0U);
-        src.Assign(reinterpret_cast<ObjectArray<T>*>(
-            reinterpret_cast<uintptr_t>(src.Ptr()) | fake_address_dependency));
-        for (int i = count - 1; i >= 0; --i) {
-          // We can skip the RB here because 'src' isn't gray.
-          ObjPtr<T> obj = src->template GetWithoutChecks<kDefaultVerifyFlags, kWithoutReadBarrier>(
-              src_pos + i);
-          SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
-        }
+    // The overlapping backward copy also reads each word pair before overwriting it, as
+    // `dst - src` is then a multiple of 8 bytes.
+    size_t i = count;
+    if (wide) {
+      if (i != 0u && !IsAligned<sizeof(uint64_t)>(dst + i)) {
+        --i;
+        copy_word(dst + i, src + i);
       }
-    }
-    if (!baker_non_gray_case) {
-      for (int i = count - 1; i >= 0; --i) {
-        // We need a RB here. ObjectArray::GetWithoutChecks() contains a RB.
-        ObjPtr<T> obj = src->GetWithoutChecks(src_pos + i);
-        SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
+      for (; i >= 2u; i -= 2u) {
+        copy_double_word(dst + i - 2u, src + i - 2u);
       }
     }
-  }
-  WriteBarrier::ForArrayWrite(this, dst_pos, count);
-  if (kIsDebugBuild) {
-    for (int i = 0; i < count; ++i) {
-      // The get will perform the VerifyObject.
-      GetWithoutChecks(dst_pos + i);
+    for (; i != 0u; --i) {
+      copy_word(dst + i - 1u, src + i - 1u);
     }
   }
 }
 
 template<class T>
-inline void ObjectArray<T>::AssignableMemcpy(int32_t dst_pos,
-                                             ObjPtr<ObjectArray<T>> src,
-                                             int32_t src_pos,
-                                             int32_t count) {
+inline void ObjectArray<T>::AssignableMemmove(int32_t dst_pos,
+                                              ObjPtr<ObjectArray<T>> src,
+                                              int32_t src_pos,
+                                              int32_t count) {
   if (kIsDebugBuild) {
     for (int i = 0; i < count; ++i) {
       // The get will perform the VerifyObject.
       src->GetWithoutChecks(src_pos + i);
     }
   }
-  // Perform the memmove using int memcpy then perform the write barrier.
-  static_assert(sizeof(HeapReference<T>) == sizeof(uint32_t),
-                "art::mirror::HeapReference<T> and uint32_t have different sizes.");
-  // TODO: Optimize this later?
-  // We can't use memmove since it does not handle read barriers and may do by per byte copying.
-  // See b/32012820.
-  bool baker_non_gray_case = false;
-  if (gUseReadBarrier && kUseBakerReadBarrier) {
-    uintptr_t fake_address_dependency;
-    if (!ReadBarrier::IsGray(src.Ptr(), &fake_address_dependency)) {
-      baker_non_gray_case = true;
-      DCHECK_EQ(fake_address_dependency, 0U);
-      src.Assign(reinterpret_cast<ObjectArray<T>*>(
-          reinterpret_cast<uintptr_t>(src.Ptr()) | fake_address_dependency));
-      for (int i = 0; i < count; ++i) {
-        // We can skip the RB here because 'src' isn't gray.
-        ObjPtr<Object> obj =
-            src->template GetWithoutChecks<kDefaultVerifyFlags, kWithoutReadBarrier>(src_pos + i);
-        SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
-      }
-    }
-  }
-  if (!baker_non_gray_case) {
+  const bool copy_forward = (src != this) || (dst_pos < src_pos) || (dst_pos - src_pos >= count);
+  if (CanCopyWithoutReadBarrier(&src)) {
+    // One range-level check for the read barrier, then a bulk copy of the reference words.
+    CopyReferenceWords(
+        reinterpret_cast<uint32_t*>(GetRawData(sizeof(HeapReference<T>), dst_pos)),
+        reinterpret_cast<const uint32_t*>(src->GetRawData(sizeof(HeapReference<T>), src_pos)),
+        count,
+        copy_forward);
+  } else if (copy_forward) {
     for (int i = 0; i < count; ++i) {
       // We need a RB here. ObjectArray::GetWithoutChecks() contains a RB.
       ObjPtr<T> obj = src->GetWithoutChecks(src_pos + i);
       SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
     }
+  } else {
+    for (int i = count - 1; i >= 0; --i) {
+      // We need a RB here. ObjectArray::GetWithoutChecks() contains a RB.
+      ObjPtr<T> obj = src->GetWithoutChecks(src_pos + i);
+      SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
+    }
   }
   WriteBarrier::ForArrayWrite(this, dst_pos, count);
   if (kIsDebugBuild) {
@@ -227,6 +216,15 @@ inline void ObjectArray<T>::AssignableMemcpy(int32_t dst_pos,
   }
 }
 
+template<class T>
+inline void ObjectArray<T>::AssignableMemcpy(int32_t dst_pos,
+                                             ObjPtr<ObjectArray<T>> src,
+                                             int32_t src_pos,
+                                             int32_t count) {
+  DCHECK(src != this || dst_pos + count <= src_pos || src_pos + count <= dst_pos);
+  AssignableMemmove(dst_pos, src, src_pos, count);
+}
+
 template<class T>
 template<bool kTransactionActive>
 inline void ObjectArray<T>::AssignableCheckingMemcpy(int32_t dst_pos,
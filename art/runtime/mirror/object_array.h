@@ -147,6 +147,18 @@ class MANAGED ObjectArray: public Array {
   }
 
  private:
+  // Returns whether the references of `src` can be read without read barriers, that is if the
+  // collector does not use them or `src` is not gray. Then `src` carries the fake address
+  // dependency that orders the reads of its references after the gray check.
+  static bool CanCopyWithoutReadBarrier(/*inout*/ ObjPtr<ObjectArray<T>>* src)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Copy `count` references as words, without read or write barriers.
+  static void CopyReferenceWords(uint32_t* dst,
+                                 const uint32_t* src,
+                                 size_t count,
+                                 bool copy_forward);
+
   // TODO fix thread safety analysis broken by the use of template. This should be
   // REQUIRES_SHARED(Locks::mutator_lock_).
   template<typename Visitor>
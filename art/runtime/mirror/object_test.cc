@@ -19,6 +19,8 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <memory>
+#include <set>
+#include <vector>
 
 #include "array-alloc-inl.h"
 #include "array-inl.h"
@@ -156,6 +158,33 @@ TEST_F(ObjectTest, AllocObjectArray) {
                     klass->GetDirectInterface(1));
 }
 
+TEST_F(ObjectTest, AssignableMemmove) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  constexpr int32_t kLength = 17;
+  Handle<ObjectArray<Object>> elements(
+      hs.NewHandle(AllocObjectArray<Object>(soa.Self(), kLength)));
+  for (int32_t i = 0; i != kLength; ++i) {
+    ObjPtr<String> s = String::AllocFromModifiedUtf8(soa.Self(), "element");
+    ASSERT_TRUE(s != nullptr);
+    elements->Set<false>(i, s);
+  }
+  Handle<ObjectArray<Object>> array(hs.NewHandle(AllocObjectArray<Object>(soa.Self(), kLength)));
+  // Overlapping copies in both directions, with all the relative alignments of the positions.
+  for (int32_t src_pos = 0; src_pos != 4; ++src_pos) {
+    for (int32_t dst_pos = 0; dst_pos != 4; ++dst_pos) {
+      int32_t count = kLength - std::max(src_pos, dst_pos);
+      array->AssignableMemcpy(0, elements.Get(), 0, kLength);
+      array->AssignableMemmove(dst_pos, array.Get(), src_pos, count);
+      for (int32_t i = 0; i != kLength; ++i) {
+        int32_t expected = (i >= dst_pos && i < dst_pos + count) ? i - dst_pos + src_pos : i;
+        EXPECT_OBJ_PTR_EQ(elements->Get(expected), array->Get(i))
+            << src_pos << " " << dst_pos << " " << i;
+      }
+    }
+  }
+}
+
 TEST_F(ObjectTest, AllocArray) {
   ScopedObjectAccess soa(Thread::Current());
   StackHandleScope<2> hs(soa.Self());
@@ -399,6 +428,38 @@ TEST_F(ObjectTest, CreateMultiArray) {
   }
 }
 
+TEST_F(ObjectTest, CreateMultiArrayInnermostDimension) {
+  ScopedObjectAccess soa(Thread::Current());
+
+  StackHandleScope<3> hs(soa.Self());
+  Handle<Class> long_class(hs.NewHandle(class_linker_->FindSystemClass(soa.Self(), "J")));
+  Handle<IntArray> dims(hs.NewHandle(IntArray::Alloc(soa.Self(), 3)));
+  // Enough innermost arrays to not fit in a single thread-local allocation buffer.
+  dims->Set<false>(0, 3);
+  dims->Set<false>(1, 1000);
+  dims->Set<false>(2, 17);
+  Handle<Array> multi = hs.NewHandle(Array::CreateMultiArray(soa.Self(), long_class, dims));
+  ASSERT_TRUE(multi != nullptr);
+  std::set<Array*> seen;
+  for (int32_t i = 0; i < 3; ++i) {
+    ObjPtr<ObjectArray<Array>> middle =
+        multi->AsObjectArray<Array>()->Get(i)->AsObjectArray<Array>();
+    ASSERT_EQ(1000, middle->GetLength());
+    for (int32_t j = 0; j < 1000; ++j) {
+      ObjPtr<LongArray> inner = middle->Get(j)->AsLongArray();
+      ASSERT_EQ(17, inner->GetLength());
+      EXPECT_TRUE(seen.insert(inner.Ptr()).second);
+      for (int32_t k = 0; k < 17; ++k) {
+        EXPECT_EQ(0, inner->Get(k));
+      }
+      inner->Set<false>(16, j);
+    }
+    for (int32_t j = 0; j < 1000; ++j) {
+      EXPECT_EQ(j, middle->Get(j)->AsLongArray()->Get(16));
+    }
+  }
+}
+
 TEST_F(ObjectTest, StaticFieldFromCode) {
   // pretend we are trying to access 'Static.s0' from StaticsFromCode.<clinit>
   ScopedObjectAccess soa(Thread::Current());
@@ -530,6 +591,34 @@ TEST_F(ObjectTest, StringLength) {
   EXPECT_EQ(string->GetModifiedUtf8Length(), 7);
 }
 
+TEST_F(ObjectTest, StringAllASCII) {
+  // Cover every position of a non-ASCII char in and after the first 64-bit word of chars.
+  for (int length = 0; length != 20; ++length) {
+    std::vector<uint16_t> chars(length, 'a');
+    std::vector<uint8_t> bytes(length, 'a');
+    EXPECT_TRUE(String::AllASCII(chars.data(), length));
+    EXPECT_TRUE(String::AllASCII(bytes.data(), length));
+    for (int i = 0; i != length; ++i) {
+      for (uint16_t c : {0x0u, 0x80u, 0xffu, 0x100u, 0x7f00u, 0xffffu}) {
+        chars[i] = c;
+        EXPECT_FALSE(String::AllASCII(chars.data(), length)) << length << " " << i << " " << c;
+        chars[i] = 'a';
+        if (c <= 0xffu) {
+          bytes[i] = static_cast<uint8_t>(c);
+          EXPECT_FALSE(String::AllASCII(bytes.data(), length)) << length << " " << i << " " << c;
+          bytes[i] = 'a';
+        }
+      }
+      chars[i] = 0x7fu;
+      bytes[i] = 0x1u;
+      EXPECT_TRUE(String::AllASCII(chars.data(), length));
+      EXPECT_TRUE(String::AllASCII(bytes.data(), length));
+      chars[i] = 'a';
+      bytes[i] = 'a';
+    }
+  }
+}
+
 TEST_F(ObjectTest, DescriptorCompare) {
   // Two classloaders conflicts in compile_time_class_paths_.
   ScopedObjectAccess soa(Thread::Current());
@@ -279,6 +279,7 @@ inline ObjPtr<String> String::AllocFromUtf16ByteArray(Thread* self,
       }
     }
   }
+  RecordUtf16Compression(compressible);
   const int32_t length_with_flag = String::GetFlaggedCount(char_count, compressible);
   SetStringCountAndUtf16BytesVisitor visitor(length_with_flag, array, offset);
   return Alloc<kIsInstrumented>(self, length_with_flag, allocator_type, visitor);
@@ -294,6 +295,7 @@ inline ObjPtr<String> String::AllocFromCharArray(Thread* self,
   DCHECK_GE(array->GetLength(), count);
   const bool compressible = kUseStringCompression &&
                             String::AllASCII<uint16_t>(array->GetData() + offset, count);
+  RecordUtf16Compression(compressible);
   const int32_t length_with_flag = String::GetFlaggedCount(count, compressible);
   SetStringCountAndValueVisitorFromCharArray visitor(length_with_flag, array, offset);
   return Alloc<kIsInstrumented>(self, length_with_flag, allocator_type, visitor);
@@ -18,6 +18,9 @@
 
 #include "string.h"
 
+#include <cstring>
+#include <limits>
+
 #include "android-base/stringprintf.h"
 
 #include "class-inl.h"
@@ -108,7 +111,23 @@ inline int32_t String::GetModifiedUtf8Length() {
 template<typename MemoryType>
 inline bool String::AllASCII(const MemoryType* chars, const int length) {
   static_assert(std::is_unsigned<MemoryType>::value, "Expecting unsigned MemoryType");
-  for (int i = 0; i < length; ++i) {
+  static_assert(sizeof(MemoryType) < sizeof(uint64_t));
+  // Check a 64-bit word of chars at a time: no char may have a bit above 0x7f set, and then
+  // a char is zero exactly when subtracting one from it borrows into its top bit.
+  constexpr int kCharsPerWord = sizeof(uint64_t) / sizeof(MemoryType);
+  constexpr uint64_t kLowBits =
+      std::numeric_limits<uint64_t>::max() / std::numeric_limits<MemoryType>::max();
+  constexpr uint64_t kNonASCIIBits = ~(kLowBits * 0x7fu);
+  constexpr uint64_t kTopBits = kLowBits << (BitSizeOf<MemoryType>() - 1u);
+  int i = 0;
+  for (; i + kCharsPerWord <= length; i += kCharsPerWord) {
+    uint64_t word;
+    memcpy(&word, chars + i, sizeof(word));
+    if ((word & kNonASCIIBits) != 0u || ((word - kLowBits) & ~word & kTopBits) != 0u) {
+      return false;
+    }
+  }
+  for (; i < length; ++i) {
     if (!IsASCII(chars[i])) {
       return false;
     }
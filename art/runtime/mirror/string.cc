@@ -207,6 +207,14 @@ ObjPtr<String> String::DoRepeat(Thread* self, Handle<String> h_this, int32_t cou
   return Alloc(self, length_with_flag, allocator_type, visitor);
 }
 
+void String::RecordUtf16Compression(bool compressible) {
+  metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+  metrics->StringsFromUtf16Count()->AddOne();
+  if (compressible) {
+    metrics->StringsFromUtf16CompressedCount()->AddOne();
+  }
+}
+
 ObjPtr<String> String::AllocFromUtf16(Thread* self,
                                       int32_t utf16_length,
                                       const uint16_t* utf16_data_in) {
@@ -214,6 +222,7 @@ ObjPtr<String> String::AllocFromUtf16(Thread* self,
   gc::AllocatorType allocator_type = Runtime::Current()->GetHeap()->GetCurrentAllocator();
   const bool compressible = kUseStringCompression &&
                             String::AllASCII<uint16_t>(utf16_data_in, utf16_length);
+  RecordUtf16Compression(compressible);
   int32_t length_with_flag = String::GetFlaggedCount(utf16_length, compressible);
 
   auto visitor = [=](ObjPtr<Object> obj, size_t usable_size) REQUIRES_SHARED(Locks::mutator_lock_) {
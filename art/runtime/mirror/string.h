@@ -249,6 +249,9 @@ class MANAGED String final : public Object {
 
   static bool DexFileStringAllASCII(const char* chars, const int length);
 
+  // Count a string created from UTF-16 chars in the metrics, and whether it could be compressed.
+  EXPORT static void RecordUtf16Compression(bool compressible);
+
   ALWAYS_INLINE static bool IsCompressed(int32_t count) {
     return GetCompressionFlagFromCount(count) == StringCompressionFlag::kCompressed;
   }
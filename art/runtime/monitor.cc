@@ -16,6 +16,7 @@
 
 #include <android-base/properties.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "android-base/stringprintf.h"
@@ -97,6 +98,8 @@ void Monitor::Init(uint32_t lock_profiling_threshold,
 Monitor::Monitor(Thread* self, Thread* owner, ObjPtr<mirror::Object> obj, int32_t hash_code)
     : monitor_lock_("a monitor lock", kMonitorLock),
       num_waiters_(0),
+      spin_iterations_(Mutex::kDefaultMaxWaitIterations),
+      spin_probe_count_(0u),
       owner_(owner),
       lock_count_(0),
       obj_(GcRoot<mirror::Object>(obj)),
@@ -131,6 +134,8 @@ Monitor::Monitor(Thread* self,
                  MonitorId id)
     : monitor_lock_("a monitor lock", kMonitorLock),
       num_waiters_(0),
+      spin_iterations_(Mutex::kDefaultMaxWaitIterations),
+      spin_probe_count_(0u),
       owner_(owner),
       lock_count_(0),
       obj_(GcRoot<mirror::Object>(obj)),
@@ -426,7 +431,7 @@ bool Monitor::TryLock(Thread* self, bool spin) {
     lock_count_++;
     CHECK_NE(lock_count_, 0u);  // Abort on overflow.
   } else {
-    bool success = spin ? monitor_lock_.ExclusiveTryLockWithSpinning(self)
+    bool success = spin ? TryLockMonitorLockWithAdaptiveSpinning(self)
         : monitor_lock_.ExclusiveTryLock(self);
     if (!success) {
       return false;
@@ -443,6 +448,26 @@ bool Monitor::TryLock(Thread* self, bool spin) {
   return true;
 }
 
+bool Monitor::TryLockMonitorLockWithAdaptiveSpinning(Thread* self) {
+  if (monitor_lock_.ExclusiveTryLock(self)) {
+    return true;
+  }
+  uint32_t spin_iterations = spin_iterations_.load(std::memory_order_relaxed);
+  if (spin_iterations == 0u) {
+    // Spinning failed recently, so the lock is typically held for longer than a spin. Block
+    // right away, but probe once in a while in case the lock is held for shorter periods now.
+    if (spin_probe_count_.fetch_add(1u, std::memory_order_relaxed) % kSpinProbeInterval != 0u) {
+      return false;
+    }
+    spin_iterations = Mutex::kDefaultMaxWaitIterations;
+  }
+  bool success = monitor_lock_.ExclusiveTryLockWithSpinning(self, spin_iterations);
+  spin_iterations_.store(success ? std::min(2u * spin_iterations, kMaxSpinIterations)
+                                 : spin_iterations / 2u,
+                         std::memory_order_relaxed);
+  return success;
+}
+
 template <LockReason reason>
 void Monitor::Lock(Thread* self) {
   bool called_monitors_callback = false;
@@ -1618,7 +1643,8 @@ uint32_t Monitor::GetOwnerThreadId() {
 
 MonitorList::MonitorList()
     : allow_new_monitors_(true), monitor_list_lock_("MonitorList lock", kMonitorListLock),
-      monitor_add_condition_("MonitorList disallow condition", monitor_list_lock_) {
+      monitor_add_condition_("MonitorList disallow condition", monitor_list_lock_),
+      num_deflated_(0u) {
 }
 
 MonitorList::~MonitorList() {
@@ -1714,9 +1740,21 @@ size_t MonitorList::DeflateMonitors() {
   MonitorDeflateVisitor visitor;
   Locks::mutator_lock_->AssertExclusiveHeld(visitor.self_);
   SweepMonitorList(&visitor);
+  {
+    MutexLock mu(visitor.self_, monitor_list_lock_);
+    num_deflated_ += visitor.deflate_count_;
+  }
   return visitor.deflate_count_;
 }
 
+void MonitorList::DumpForSigQuit(std::ostream& os) {
+  {
+    MutexLock mu(Thread::Current(), monitor_list_lock_);
+    os << "Monitors: " << list_.size() << " inflated, " << num_deflated_ << " deflated\n";
+  }
+  MonitorPool::DumpForSigQuit(os);
+}
+
 MonitorInfo::MonitorInfo(ObjPtr<mirror::Object> obj) : owner_(nullptr), entry_count_(0) {
   DCHECK(obj != nullptr);
   LockWord lock_word = obj->GetLockWord(true);
@@ -238,6 +238,10 @@ class Monitor {
       TRY_ACQUIRE(true, monitor_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Try to acquire `monitor_lock_`, spinning for a period adapted to how long the lock was
+  // recently held when contended.
+  bool TryLockMonitorLockWithAdaptiveSpinning(Thread* self) TRY_ACQUIRE(true, monitor_lock_);
+
   template<LockReason reason = LockReason::kForLock>
   void Lock(Thread* self)
       ACQUIRE(monitor_lock_)
@@ -332,6 +336,19 @@ class Monitor {
   // monitor acquisition. Prevents deflation.
   std::atomic<size_t> num_waiters_;
 
+  // Bounds on how long to spin for a contended `monitor_lock_`, in wait iterations of
+  // `Mutex::ExclusiveTryLockWithSpinning()`.
+  static constexpr uint32_t kMaxSpinIterations = 4 * Mutex::kDefaultMaxWaitIterations;
+  // When spinning is disabled, try it again once in this many contended acquisitions.
+  static constexpr uint32_t kSpinProbeInterval = 16;
+
+  // How long to spin for a contended `monitor_lock_`. Doubled whenever spinning acquires the
+  // lock and halved whenever it fails, down to zero for locks held longer than a spin. Only
+  // a heuristic, so it is updated without synchronization.
+  std::atomic<uint32_t> spin_iterations_;
+  // Counts contended acquisitions while `spin_iterations_` is zero.
+  std::atomic<uint32_t> spin_probe_count_;
+
   // Which thread currently owns the lock? monitor_lock_ only keeps the tid.
   // Only set while holding monitor_lock_. Non-locking readers only use it to
   // compare to self or for debugging.
@@ -459,6 +476,7 @@ class MonitorList {
   // Returns how many monitors were deflated.
   size_t DeflateMonitors() REQUIRES(!monitor_list_lock_) REQUIRES(Locks::mutator_lock_);
   EXPORT size_t Size() REQUIRES(!monitor_list_lock_);
+  void DumpForSigQuit(std::ostream& os) REQUIRES(!monitor_list_lock_);
 
   using Monitors = std::list<Monitor*, TrackingAllocator<Monitor*, kAllocatorTagMonitorList>>;
 
@@ -471,6 +489,8 @@ class MonitorList {
   Mutex monitor_list_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ConditionVariable monitor_add_condition_ GUARDED_BY(monitor_list_lock_);
   Monitors list_ GUARDED_BY(monitor_list_lock_);
+  // Number of monitors deflated so far.
+  size_t num_deflated_ GUARDED_BY(monitor_list_lock_);
 
   friend class Monitor;
   DISALLOW_COPY_AND_ASSIGN(MonitorList);
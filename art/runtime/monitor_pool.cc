@@ -29,7 +29,7 @@ class Object;
 
 MonitorPool::MonitorPool()
     : current_chunk_list_index_(0), num_chunks_(0), current_chunk_list_capacity_(0),
-    first_free_(nullptr) {
+    num_released_chunks_total_(0), first_free_(nullptr) {
   for (size_t i = 0; i < kMaxChunkLists; ++i) {
     monitor_chunks_[i] = nullptr;  // Not absolutely required, but ...
   }
@@ -41,6 +41,14 @@ MonitorPool::MonitorPool()
 void MonitorPool::AllocateChunk() {
   DCHECK(first_free_ == nullptr);
 
+  // Reuse the entry of a released chunk, if any.
+  if (!released_chunks_.empty()) {
+    auto [list_index, index_in_list] = released_chunks_.back();
+    released_chunks_.pop_back();
+    InitializeChunk(list_index, index_in_list);
+    return;
+  }
+
   // Do we need to allocate another chunk list?
   if (num_chunks_ == current_chunk_list_capacity_) {
     if (current_chunk_list_capacity_ != 0U) {
@@ -56,6 +64,14 @@ void MonitorPool::AllocateChunk() {
     num_chunks_ = 0;
   }
 
+  num_chunks_++;
+  InitializeChunk(current_chunk_list_index_, num_chunks_ - 1);
+}
+
+void MonitorPool::InitializeChunk(size_t list_index, size_t index_in_list) {
+  DCHECK(first_free_ == nullptr);
+  DCHECK_EQ(monitor_chunks_[list_index][index_in_list], 0U);
+
   // Allocate the chunk.
   void* chunk = allocator_.allocate(kChunkSize);
   // Check we allocated memory.
@@ -64,16 +80,15 @@ void MonitorPool::AllocateChunk() {
   CHECK_EQ(0U, reinterpret_cast<uintptr_t>(chunk) % kMonitorAlignment);
 
   // Add the chunk.
-  monitor_chunks_[current_chunk_list_index_][num_chunks_] = reinterpret_cast<uintptr_t>(chunk);
-  num_chunks_++;
+  monitor_chunks_[list_index][index_in_list] = reinterpret_cast<uintptr_t>(chunk);
 
   // Set up the free list
   Monitor* last = reinterpret_cast<Monitor*>(reinterpret_cast<uintptr_t>(chunk) +
                                              (kChunkCapacity - 1) * kAlignedMonitorSize);
   last->next_free_ = nullptr;
   // Eagerly compute id.
-  last->monitor_id_ = OffsetToMonitorId(current_chunk_list_index_* (kMaxListSize * kChunkSize)
-      + (num_chunks_ - 1) * kChunkSize + (kChunkCapacity - 1) * kAlignedMonitorSize);
+  last->monitor_id_ = OffsetToMonitorId(list_index * (kMaxListSize * kChunkSize)
+      + index_in_list * kChunkSize + (kChunkCapacity - 1) * kAlignedMonitorSize);
   for (size_t i = 0; i < kChunkCapacity - 1; ++i) {
     Monitor* before = reinterpret_cast<Monitor*>(reinterpret_cast<uintptr_t>(last) -
                                                  kAlignedMonitorSize);
@@ -95,8 +110,10 @@ void MonitorPool::FreeInternal() {
     DCHECK_NE(monitor_chunks_[i], static_cast<uintptr_t*>(nullptr));
     for (size_t j = 0; j < ChunkListCapacity(i); ++j) {
       if (i < current_chunk_list_index_ || j < num_chunks_) {
-        DCHECK_NE(monitor_chunks_[i][j], 0U);
-        allocator_.deallocate(reinterpret_cast<uint8_t*>(monitor_chunks_[i][j]), kChunkSize);
+        // Released chunks have a zero entry.
+        if (monitor_chunks_[i][j] != 0U) {
+          allocator_.deallocate(reinterpret_cast<uint8_t*>(monitor_chunks_[i][j]), kChunkSize);
+        }
       } else {
         DCHECK_EQ(monitor_chunks_[i][j], 0U);
       }
@@ -156,4 +173,50 @@ void MonitorPool::ReleaseMonitorsToPool(Thread* self, MonitorList::Monitors* mon
   }
 }
 
+void MonitorPool::TrimFreeChunksInPool(Thread* self) {
+  MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
+  // Count the free monitors of each chunk.
+  std::vector<uint16_t> free_counts(ChunkIndex(current_chunk_list_index_, num_chunks_), 0u);
+  for (Monitor* mon = first_free_; mon != nullptr; mon = mon->next_free_) {
+    ++free_counts[ChunkIndexOfMonitorId(mon->monitor_id_)];
+  }
+  std::vector<uintptr_t> chunks_to_release;
+  for (size_t i = 0; i <= current_chunk_list_index_; ++i) {
+    size_t num_chunks = (i == current_chunk_list_index_) ? num_chunks_ : ChunkListCapacity(i);
+    for (size_t j = 0; j < num_chunks; ++j) {
+      if (free_counts[ChunkIndex(i, j)] == kChunkCapacity) {
+        DCHECK_NE(monitor_chunks_[i][j], 0U);
+        chunks_to_release.push_back(monitor_chunks_[i][j]);
+        monitor_chunks_[i][j] = 0U;
+        released_chunks_.emplace_back(i, j);
+      }
+    }
+  }
+  if (chunks_to_release.empty()) {
+    return;
+  }
+  // Remove the monitors of the released chunks from the free list, before releasing the memory
+  // holding the list.
+  Monitor** link = &first_free_;
+  for (Monitor* mon = first_free_; mon != nullptr; mon = mon->next_free_) {
+    if (free_counts[ChunkIndexOfMonitorId(mon->monitor_id_)] != kChunkCapacity) {
+      *link = mon;
+      link = &mon->next_free_;
+    }
+  }
+  *link = nullptr;
+  for (uintptr_t chunk : chunks_to_release) {
+    allocator_.deallocate(reinterpret_cast<uint8_t*>(chunk), kChunkSize);
+  }
+  num_released_chunks_total_ += chunks_to_release.size();
+  VLOG(monitor) << "Released " << chunks_to_release.size() << " free monitor chunks";
+}
+
+void MonitorPool::DumpForSigQuitInPool(std::ostream& os) {
+  MutexLock mu(Thread::Current(), *Locks::allocated_monitor_ids_lock_);
+  size_t num_chunks = ChunkIndex(current_chunk_list_index_, num_chunks_);
+  os << "Monitor pool: " << (num_chunks - released_chunks_.size()) << " chunks of "
+     << kChunkSize << " bytes in use, " << num_released_chunks_total_ << " released\n";
+}
+
 }  // namespace art
@@ -21,8 +21,12 @@
 
 #include "base/allocator.h"
 #include "base/macros.h"
+#include <ostream>
+
 #ifdef __LP64__
 #include <stdint.h>
+#include <utility>
+#include <vector>
 #include "base/atomic.h"
 #include "runtime.h"
 #else
@@ -75,6 +79,24 @@ class MonitorPool {
 #endif
   }
 
+  // Return the memory of the chunks which only hold free monitors. On 32-bit, monitors are
+  // allocated individually and already returned when released.
+  static void TrimFreeChunks(Thread* self) {
+#ifndef __LP64__
+    UNUSED(self);
+#else
+    GetMonitorPool()->TrimFreeChunksInPool(self);
+#endif
+  }
+
+  static void DumpForSigQuit(std::ostream& os) {
+#ifndef __LP64__
+    UNUSED(os);
+#else
+    GetMonitorPool()->DumpForSigQuitInPool(os);
+#endif
+  }
+
   static Monitor* MonitorFromMonitorId(MonitorId mon_id) {
 #ifndef __LP64__
     return reinterpret_cast<Monitor*>(mon_id << LockWord::kMonitorIdAlignmentShift);
@@ -122,6 +144,13 @@ class MonitorPool {
 
   void AllocateChunk() REQUIRES(Locks::allocated_monitor_ids_lock_);
 
+  // Set up the free list of the monitors of a newly allocated chunk.
+  void InitializeChunk(size_t list_index, size_t index_in_list)
+      REQUIRES(Locks::allocated_monitor_ids_lock_);
+
+  void TrimFreeChunksInPool(Thread* self) REQUIRES(!Locks::allocated_monitor_ids_lock_);
+  void DumpForSigQuitInPool(std::ostream& os) REQUIRES(!Locks::allocated_monitor_ids_lock_);
+
   // Release all chunks and metadata. This is done on shutdown, where threads have been destroyed,
   // so ignore thead-safety analysis.
   void FreeInternal() NO_THREAD_SAFETY_ANALYSIS;
@@ -185,6 +214,16 @@ class MonitorPool {
     return kInitialChunkStorage << index;
   }
 
+  // Index of a chunk among all the chunks of all the chunk lists.
+  static constexpr size_t ChunkIndex(size_t list_index, size_t index_in_list) {
+    return ChunkListCapacity(list_index) - kInitialChunkStorage + index_in_list;
+  }
+
+  static constexpr size_t ChunkIndexOfMonitorId(MonitorId id) {
+    size_t chunk_number = MonitorIdToOffset(id) / kChunkSize;
+    return ChunkIndex(chunk_number / kMaxListSize, chunk_number % kMaxListSize);
+  }
+
   // TODO: There are assumptions in the code that monitor addresses are 8B aligned (>>3).
   static constexpr size_t kMonitorAlignment = 8;
   // Size of a monitor, rounded up to a multiple of alignment.
@@ -227,7 +266,9 @@ class MonitorPool {
   // Updates to monitor_chunks_ are guarded by allocated_monitor_ids_lock_ .
   // No field in this entire data structure is ever updated once a monitor id whose lookup
   // requires it has been made visible to another thread.  Thus readers never race with
-  // updates, in spite of the fact that they acquire no locks.
+  // updates, in spite of the fact that they acquire no locks. A chunk is only released when all
+  // its monitors are free, so no live monitor id refers to it, and its entry is then zero until
+  // the chunk is allocated again.
   uintptr_t* monitor_chunks_[kMaxChunkLists];  //  uintptr_t is really a Monitor* .
   // Highest currently used index in monitor_chunks_ . Used for newly allocated chunks.
   size_t current_chunk_list_index_ GUARDED_BY(Locks::allocated_monitor_ids_lock_);
@@ -237,6 +278,13 @@ class MonitorPool {
   // ChunkListCapacity(current_chunk_list_index_).
   size_t current_chunk_list_capacity_ GUARDED_BY(Locks::allocated_monitor_ids_lock_);
 
+  // Entries of monitor_chunks_ whose chunks were released, as (list index, index in list).
+  // They are allocated again before growing monitor_chunks_.
+  std::vector<std::pair<size_t, size_t>> released_chunks_
+      GUARDED_BY(Locks::allocated_monitor_ids_lock_);
+  // Number of chunks released so far.
+  size_t num_released_chunks_total_ GUARDED_BY(Locks::allocated_monitor_ids_lock_);
+
   using Allocator = TrackingAllocator<uint8_t, kAllocatorTagMonitorPool>;
   Allocator allocator_;
 
@@ -124,4 +124,46 @@ TEST_F(MonitorPoolTest, MonitorPoolTest) {
   }
 }
 
+TEST_F(MonitorPoolTest, TrimFreeChunks) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+
+  // Create enough monitors to fill several chunks.
+  std::vector<Monitor*> monitors;
+  for (size_t i = 0; i < 1000; ++i) {
+    monitors.push_back(MonitorPool::CreateMonitor(self, self, nullptr, static_cast<int32_t>(i)));
+  }
+
+  // Release all but a few monitors, so that most chunks are free, and trim.
+  std::vector<Monitor*> kept;
+  for (size_t i = 0; i < monitors.size(); ++i) {
+    if (i % 300 == 0) {
+      kept.push_back(monitors[i]);
+    } else {
+      MonitorPool::ReleaseMonitor(self, monitors[i]);
+    }
+  }
+  MonitorPool::TrimFreeChunks(self);
+  for (Monitor* mon : kept) {
+    VerifyMonitor(mon, self);
+  }
+
+  // New monitors reuse the released chunks.
+  monitors.clear();
+  for (size_t i = 0; i < 1000; ++i) {
+    Monitor* mon = MonitorPool::CreateMonitor(self, self, nullptr, static_cast<int32_t>(i));
+    VerifyMonitor(mon, self);
+    monitors.push_back(mon);
+  }
+  for (Monitor* mon : kept) {
+    VerifyMonitor(mon, self);
+    MonitorPool::ReleaseMonitor(self, mon);
+  }
+  for (Monitor* mon : monitors) {
+    VerifyMonitor(mon, self);
+    MonitorPool::ReleaseMonitor(self, mon);
+  }
+  MonitorPool::TrimFreeChunks(self);
+}
+
 }  // namespace art
@@ -450,6 +450,7 @@ static jboolean DexFile_closeDexFile(JNIEnv* env, jclass, jobject cookie) {
           // Clear the element in the array so that we can call close again.
           long_dex_files->Set(i, 0);
           class_linker->RemoveDexFromCaches(*dex_file);
+          runtime->GetOatFileManager().DeleteTypeLookupTable(dex_file);
           delete dex_file;
         } else {
           all_deleted = false;
@@ -276,6 +276,7 @@ static void VMRuntime_setDisabledCompatChangesNative(JNIEnv* env, jobject,
     }
   }
   Runtime::Current()->GetCompatFramework().SetDisabledCompatChanges(disabled_compat_changes_set);
+  Runtime::Current()->GetHiddenApiDecisionCache()->Clear();
 }
 
 static inline size_t clamp_to_size_t(jlong n) {
@@ -317,6 +318,10 @@ static jlong VMRuntime_getFinalizerTimeoutMs(JNIEnv*, jobject) {
   return Runtime::Current()->GetFinalizerTimeoutMs();
 }
 
+static jint VMRuntime_getFinalizerWorkers(JNIEnv*, jobject) {
+  return Runtime::Current()->GetFinalizerWorkers();
+}
+
 static void VMRuntime_registerSensitiveThread(JNIEnv*, jobject) {
   Runtime::Current()->RegisterSensitiveThread();
 }
@@ -563,6 +568,7 @@ static JNINativeMethod gMethods[] = {
   NATIVE_METHOD(VMRuntime, registerNativeFree, "(J)V"),
   NATIVE_METHOD(VMRuntime, getNotifyNativeInterval, "()I"),
   NATIVE_METHOD(VMRuntime, getFinalizerTimeoutMs, "()J"),
+  NATIVE_METHOD(VMRuntime, getFinalizerWorkers, "()I"),
   NATIVE_METHOD(VMRuntime, notifyNativeAllocationsInternal, "()V"),
   NATIVE_METHOD(VMRuntime, notifyStartupCompleted, "()V"),
   NATIVE_METHOD(VMRuntime, registerSensitiveThread, "()V"),
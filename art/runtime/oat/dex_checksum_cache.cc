@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dex_checksum_cache.h"
+
+#include "base/unix_file/fd_file.h"
+#include "dex/art_dex_file_loader.h"
+
+namespace art HIDDEN {
+
+DexChecksumCache& DexChecksumCache::GetInstance() {
+  // Intentionally leaked, to avoid running a destructor at exit while other threads use it.
+  static DexChecksumCache* instance = new DexChecksumCache();
+  return *instance;
+}
+
+bool DexChecksumCache::Entry::Matches(const struct stat& st) const {
+  return size == st.st_size && mtime.tv_sec == st.st_mtim.tv_sec &&
+         mtime.tv_nsec == st.st_mtim.tv_nsec && ctime.tv_sec == st.st_ctim.tv_sec &&
+         ctime.tv_nsec == st.st_ctim.tv_nsec;
+}
+
+bool DexChecksumCache::GetMultiDexChecksum(const std::string& location,
+                                           int fd,
+                                           /*out*/ std::optional<uint32_t>* checksum,
+                                           /*out*/ std::string* error_msg,
+                                           /*out*/ bool* only_contains_uncompressed_dex) {
+  // The stat is taken before reading the file, so that a change made while reading it
+  // invalidates the cached checksums.
+  struct stat st;
+  bool use_cache =
+      (fd >= 0 ? fstat(fd, &st) : stat(location.c_str(), &st)) == 0 && S_ISREG(st.st_mode);
+  if (use_cache) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = entries_.find({st.st_dev, st.st_ino});
+    if (it != entries_.end() && it->second.Matches(st)) {
+      *checksum = it->second.checksum;
+      if (only_contains_uncompressed_dex != nullptr) {
+        *only_contains_uncompressed_dex = it->second.only_contains_uncompressed_dex;
+      }
+      return true;
+    }
+  }
+
+  File file(fd, /*check_usage=*/false);
+  ArtDexFileLoader dex_loader(&file, location);
+  bool uncompressed = false;
+  bool success = dex_loader.GetMultiDexChecksum(checksum, error_msg, &uncompressed);
+  file.Release();  // Don't close the file, it belongs to the caller.
+  if (!success) {
+    return false;
+  }
+  if (only_contains_uncompressed_dex != nullptr) {
+    *only_contains_uncompressed_dex = uncompressed;
+  }
+
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  if (use_cache && now.tv_sec - st.st_ctim.tv_sec >= kMinSecondsSinceChange) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (entries_.size() >= kMaxEntries) {
+      entries_.clear();
+    }
+    entries_.insert_or_assign({st.st_dev, st.st_ino}, Entry(st, *checksum, uncompressed));
+  }
+  return true;
+}
+
+void DexChecksumCache::Clear() {
+  std::lock_guard<std::mutex> lock(mu_);
+  entries_.clear();
+}
+
+size_t DexChecksumCache::Size() {
+  std::lock_guard<std::mutex> lock(mu_);
+  return entries_.size();
+}
+
+}  // namespace art
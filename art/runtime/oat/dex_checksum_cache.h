@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_OAT_DEX_CHECKSUM_CACHE_H_
+#define ART_RUNTIME_OAT_DEX_CHECKSUM_CACHE_H_
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "base/macros.h"
+
+namespace art HIDDEN {
+
+// Process-wide cache of the multidex checksums of dex and zip files.
+//
+// Computing the checksums requires opening the zip file and reading its central directory, which
+// is otherwise repeated for every class loader, every class loader context element and every
+// dexopt query on the same APK. It is shared by `OatFileAssistant` and `ClassLoaderContext`.
+// Entries are keyed by device and inode, and validated against the size, modification time and
+// status change time of the file.
+class DexChecksumCache {
+ public:
+  EXPORT static DexChecksumCache& GetInstance();
+
+  // Same as `ArtDexFileLoader::GetMultiDexChecksum()` for the file at `location`, or for `fd` if it
+  // is not -1. Errors are not cached. `fd` is not closed.
+  EXPORT bool GetMultiDexChecksum(const std::string& location,
+                                  int fd,
+                                  /*out*/ std::optional<uint32_t>* checksum,
+                                  /*out*/ std::string* error_msg,
+                                  /*out*/ bool* only_contains_uncompressed_dex = nullptr);
+
+  // Removes all entries. Only used by tests.
+  EXPORT void Clear();
+
+  EXPORT size_t Size();
+
+ private:
+  static constexpr size_t kMaxEntries = 1024;
+  // A file changed in the last few seconds may be changed again without updating its timestamps,
+  // whose granularity is coarser than a nanosecond on most file systems. Such files are not cached.
+  static constexpr time_t kMinSecondsSinceChange = 2;
+
+  struct Entry {
+    Entry(const struct stat& st, std::optional<uint32_t> c, bool uncompressed)
+        : size(st.st_size),
+          mtime(st.st_mtim),
+          ctime(st.st_ctim),
+          checksum(c),
+          only_contains_uncompressed_dex(uncompressed) {}
+
+    bool Matches(const struct stat& st) const;
+
+    off_t size;
+    struct timespec mtime;
+    struct timespec ctime;
+    std::optional<uint32_t> checksum;
+    bool only_contains_uncompressed_dex;
+  };
+
+  DexChecksumCache() = default;
+
+  std::mutex mu_;
+  std::map<std::pair<dev_t, ino_t>, Entry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(DexChecksumCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_OAT_DEX_CHECKSUM_CACHE_H_
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dex_checksum_cache.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include "common_runtime_test.h"
+#include "dex/art_dex_file_loader.h"
+#include "gtest/gtest.h"
+
+namespace art HIDDEN {
+
+class DexChecksumCacheTest : public CommonRuntimeTest {
+ protected:
+  void SetUp() override {
+    CommonRuntimeTest::SetUp();
+    DexChecksumCache::GetInstance().Clear();
+  }
+
+  static std::optional<uint32_t> GetChecksumFromLoader(const std::string& location) {
+    ArtDexFileLoader dex_file_loader(location);
+    std::optional<uint32_t> checksum;
+    std::string error_msg;
+    EXPECT_TRUE(dex_file_loader.GetMultiDexChecksum(&checksum, &error_msg)) << error_msg;
+    return checksum;
+  }
+};
+
+TEST_F(DexChecksumCacheTest, MatchesDexFileLoader) {
+  DexChecksumCache& cache = DexChecksumCache::GetInstance();
+  for (const char* name : {"Main", "MultiDex"}) {
+    std::string location = GetTestDexFileName(name);
+    std::optional<uint32_t> expected = GetChecksumFromLoader(location);
+    ASSERT_TRUE(expected.has_value());
+    // The second query may be answered from the cache.
+    for (int i = 0; i != 2; ++i) {
+      std::optional<uint32_t> checksum;
+      std::string error_msg;
+      ASSERT_TRUE(cache.GetMultiDexChecksum(location, /*fd=*/ -1, &checksum, &error_msg))
+          << error_msg;
+      EXPECT_EQ(expected, checksum) << name;
+    }
+  }
+}
+
+TEST_F(DexChecksumCacheTest, WithFd) {
+  std::string location = GetTestDexFileName("MultiDex");
+  std::optional<uint32_t> expected = GetChecksumFromLoader(location);
+  int fd = open(location.c_str(), O_RDONLY | O_CLOEXEC);
+  ASSERT_GE(fd, 0);
+  std::optional<uint32_t> checksum;
+  std::string error_msg;
+  ASSERT_TRUE(DexChecksumCache::GetInstance().GetMultiDexChecksum(
+      location, fd, &checksum, &error_msg)) << error_msg;
+  EXPECT_EQ(expected, checksum);
+  // The file descriptor belongs to the caller.
+  EXPECT_EQ(0, close(fd));
+}
+
+TEST_F(DexChecksumCacheTest, RecentlyChangedFileIsNotCached) {
+  ScratchDir scratch_dir;
+  std::string location = scratch_dir.GetPath() + "MultiDex.jar";
+  ASSERT_TRUE(std::filesystem::copy_file(GetTestDexFileName("MultiDex"), location));
+  std::optional<uint32_t> checksum;
+  std::string error_msg;
+  DexChecksumCache& cache = DexChecksumCache::GetInstance();
+  ASSERT_TRUE(cache.GetMultiDexChecksum(location, /*fd=*/ -1, &checksum, &error_msg))
+      << error_msg;
+  EXPECT_EQ(GetChecksumFromLoader(location), checksum);
+  EXPECT_EQ(0u, cache.Size());
+}
+
+TEST_F(DexChecksumCacheTest, MissingFile) {
+  ScratchDir scratch_dir;
+  std::string location = scratch_dir.GetPath() + "missing.jar";
+  std::optional<uint32_t> checksum;
+  std::string error_msg;
+  DexChecksumCache& cache = DexChecksumCache::GetInstance();
+  EXPECT_FALSE(cache.GetMultiDexChecksum(location, /*fd=*/ -1, &checksum, &error_msg));
+  EXPECT_FALSE(error_msg.empty());
+  EXPECT_EQ(0u, cache.Size());
+}
+
+}  // namespace art
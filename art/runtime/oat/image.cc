@@ -16,6 +16,7 @@
 
 #include "image.h"
 
+#include <atomic>
 #include <lz4.h>
 #include <lz4hc.h>
 #include <sstream>
@@ -26,16 +27,19 @@
 
 #include "base/bit_utils.h"
 #include "base/length_prefixed_array.h"
+#include "base/time_utils.h"
 #include "base/utils.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/object_array.h"
+#include "thread-current-inl.h"
+#include "thread_pool.h"
 
 namespace art HIDDEN {
 
 const uint8_t ImageHeader::kImageMagic[] = { 'a', 'r', 't', '\n' };
-// Revert dex cache change.
-const uint8_t ImageHeader::kImageVersion[] = { '1', '1', '8', '\0' };
+// Add ArraysSupport.vectorizedMismatch intrinsic.
+const uint8_t ImageHeader::kImageVersion[] = { '1', '1', '9', '\0' };
 
 ImageHeader::ImageHeader(uint32_t image_reservation_size,
                          uint32_t component_count,
@@ -338,6 +342,7 @@ bool ImageHeader::WriteData(const ImageFileGuard& image_file,
                             ImageHeader::StorageMode image_storage_mode,
                             uint32_t max_image_block_size,
                             bool update_checksum,
+                            ThreadPool* thread_pool,
                             std::string* error_msg) {
   const bool is_compressed = image_storage_mode != ImageHeader::kStorageModeUncompressed;
   dchecked_vector<std::pair<uint32_t, uint32_t>> block_sources;
@@ -365,19 +370,49 @@ bool ImageHeader::WriteData(const ImageFileGuard& image_file,
                              sizeof(ImageHeader));
   }
 
-  // Copy and compress blocks.
+  // Compress blocks. Blocks are independent, so they can be compressed in parallel.
+  // The compressed data is then written and checksummed in order below.
+  dchecked_vector<dchecked_vector<uint8_t>> compressed_data;
+  if (is_compressed) {
+    const uint64_t compress_start_time = NanoTime();
+    compressed_data.resize(block_sources.size());
+    Thread* const self = Thread::Current();
+    const bool use_parallel = thread_pool != nullptr && block_sources.size() > 1u;
+    std::atomic<bool> failed_compression(false);
+    for (size_t i = 0, size = block_sources.size(); i != size; ++i) {
+      auto function = [&, i](Thread*) {
+        ArrayRef<const uint8_t> raw_image_data(data + block_sources[i].first,
+                                               block_sources[i].second);
+        if (!CompressData(raw_image_data, image_storage_mode, &compressed_data[i])) {
+          failed_compression.store(true, std::memory_order_relaxed);
+        }
+      };
+      if (use_parallel) {
+        thread_pool->AddTask(self, new FunctionTask(std::move(function)));
+      } else {
+        function(self);
+      }
+    }
+    if (use_parallel) {
+      thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ false);
+    }
+    if (failed_compression.load(std::memory_order_relaxed)) {
+      *error_msg = "Error compressing data for " + image_file->GetPath();
+      return false;
+    }
+    VLOG(image) << "Compressed " << block_sources.size() << " blocks with "
+                << image_storage_mode << (use_parallel ? " in parallel" : "") << " in "
+                << PrettyDuration(NanoTime() - compress_start_time);
+  }
+
+  // Copy blocks.
   uint32_t out_offset = sizeof(ImageHeader);
-  for (const std::pair<uint32_t, uint32_t> block : block_sources) {
+  for (size_t i = 0, size = block_sources.size(); i != size; ++i) {
+    const std::pair<uint32_t, uint32_t> block = block_sources[i];
     ArrayRef<const uint8_t> raw_image_data(data + block.first, block.second);
-    dchecked_vector<uint8_t> compressed_data;
     ArrayRef<const uint8_t> image_data;
     if (is_compressed) {
-      if (!CompressData(raw_image_data, image_storage_mode, &compressed_data)) {
-        *error_msg = "Error compressing data for " +
-            image_file->GetPath() + ": " + std::string(strerror(errno));
-        return false;
-      }
-      image_data = ArrayRef<const uint8_t>(compressed_data);
+      image_data = ArrayRef<const uint8_t>(compressed_data[i]);
     } else {
       image_data = raw_image_data;
       // For uncompressed, preserve alignment since the image will be directly mapped.
@@ -33,6 +33,7 @@ namespace art HIDDEN {
 class ArtField;
 class ArtMethod;
 class ImageFileGuard;
+class ThreadPool;
 
 template <class MirrorType> class ObjPtr;
 
@@ -112,6 +113,10 @@ class PACKED(8) ImageHeader {
       return data_size_;
     }
 
+    uint32_t GetImageOffset() const {
+      return image_offset_;
+    }
+
     uint32_t GetImageSize() const {
       return image_size_;
     }
@@ -429,13 +434,16 @@ class PACKED(8) ImageHeader {
   }
 
   // Helper for writing `data` and `bitmap_data` into `image_file`, following
-  // the information stored in this header and passed as arguments.
+  // the information stored in this header and passed as arguments. If
+  // `thread_pool` is not null, blocks are compressed in parallel on its
+  // workers and the calling thread.
   EXPORT bool WriteData(const ImageFileGuard& image_file,
                         const uint8_t* data,
                         const uint8_t* bitmap_data,
                         ImageHeader::StorageMode image_storage_mode,
                         uint32_t max_image_block_size,
                         bool update_checksum,
+                        ThreadPool* thread_pool,
                         std::string* error_msg);
 
  private:
@@ -76,7 +76,8 @@ OatHeader::OatHeader(InstructionSet instruction_set,
       quick_imt_conflict_trampoline_offset_(0),
       quick_resolution_trampoline_offset_(0),
       quick_to_interpreter_bridge_offset_(0),
-      nterp_trampoline_offset_(0) {
+      nterp_trampoline_offset_(0),
+      startup_code_end_offset_(0) {
   // Don't want asserts in header as they would be checked in each file that includes it. But the
   // fields are private, so we check inside a method.
   static_assert(decltype(magic_)().size() == kOatMagic.size(),
@@ -339,6 +340,20 @@ void OatHeader::SetNterpTrampolineOffset(uint32_t offset) {
   nterp_trampoline_offset_ = offset;
 }
 
+uint32_t OatHeader::GetStartupCodeEndOffset() const {
+  DCHECK(IsValid());
+  CHECK(startup_code_end_offset_ == 0u || startup_code_end_offset_ > executable_offset_);
+  return startup_code_end_offset_;
+}
+
+void OatHeader::SetStartupCodeEndOffset(uint32_t offset) {
+  CHECK(offset == 0u || offset > executable_offset_);
+  DCHECK(IsValid());
+  DCHECK_EQ(startup_code_end_offset_, 0U) << offset;
+
+  startup_code_end_offset_ = offset;
+}
+
 uint32_t OatHeader::GetKeyValueStoreSize() const {
   CHECK(IsValid());
   return key_value_store_size_;
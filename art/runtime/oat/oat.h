@@ -44,8 +44,8 @@ std::ostream& operator<<(std::ostream& stream, StubType stub_type);
 class EXPORT PACKED(4) OatHeader {
  public:
   static constexpr std::array<uint8_t, 4> kOatMagic { { 'o', 'a', 't', '\n' } };
-  // Last oat version changed reason: Revert "arm64: Store resolved MethodType-s in .bss"
-  static constexpr std::array<uint8_t, 4> kOatVersion{{'2', '5', '3', '\0'}};
+  // Last oat version changed reason: Record the end of the startup code in the header.
+  static constexpr std::array<uint8_t, 4> kOatVersion{{'2', '5', '4', '\0'}};
 
   static constexpr const char* kDex2OatCmdLineKey = "dex2oat-cmdline";
   static constexpr const char* kDebuggableKey = "debuggable";
@@ -58,6 +58,7 @@ class EXPORT PACKED(4) OatHeader {
   static constexpr const char* kConcurrentCopying = "concurrent-copying";
   static constexpr const char* kCompilationReasonKey = "compilation-reason";
   static constexpr const char* kRequiresImage = "requires-image";
+  static constexpr const char* kFastNativeMethodsKey = "fast-native-methods";
 
   static constexpr const char kTrueValue[] = "true";
   static constexpr const char kFalseValue[] = "false";
@@ -107,6 +108,11 @@ class EXPORT PACKED(4) OatHeader {
   const void* GetNterpTrampoline() const;
   uint32_t GetNterpTrampolineOffset() const;
   void SetNterpTrampolineOffset(uint32_t offset);
+  // The end of the code of the profile startup methods, which the profile-guided code layout
+  // places at the start of the executable section. Zero if the code was not laid out with a
+  // profile or there are no startup methods.
+  uint32_t GetStartupCodeEndOffset() const;
+  void SetStartupCodeEndOffset(uint32_t offset);
 
   InstructionSet GetInstructionSet() const;
   uint32_t GetInstructionSetFeaturesBitmap() const;
@@ -155,6 +161,7 @@ class EXPORT PACKED(4) OatHeader {
   uint32_t quick_resolution_trampoline_offset_;
   uint32_t quick_to_interpreter_bridge_offset_;
   uint32_t nterp_trampoline_offset_;
+  uint32_t startup_code_end_offset_;
 
   uint32_t key_value_store_size_;
   uint8_t key_value_store_[0];  // note variable width data at end
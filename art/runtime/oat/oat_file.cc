@@ -640,6 +640,16 @@ bool OatFileBase::Setup(int zip_fd,
     return false;
   }
 
+  const char* fast_native_methods =
+      GetOatHeader().GetStoreValueByKey(OatHeader::kFastNativeMethodsKey);
+  if (fast_native_methods != nullptr) {
+    Split(fast_native_methods, '\n', &fast_native_methods_);
+    if (!std::is_sorted(fast_native_methods_.begin(), fast_native_methods_.end())) {
+      *error_msg = ErrorPrintf("unsorted fast native methods");
+      return false;
+    }
+  }
+
   size_t oat_dex_files_offset = GetOatHeader().GetOatDexFilesOffset();
   if (oat_dex_files_offset < GetOatHeader().GetHeaderSize() || oat_dex_files_offset > Size()) {
     *error_msg = ErrorPrintf("invalid oat dex files offset: %zu is not in [%zu, %zu]",
@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_OAT_OAT_FILE_H_
 #define ART_RUNTIME_OAT_OAT_FILE_H_
 
+#include <algorithm>
 #include <list>
 #include <memory>
 #include <string>
@@ -205,6 +206,17 @@ class OatFile {
 
   const char* GetCompilationReason() const;
 
+  // Returns whether the native method `method`, named like "LFoo;->bar(I)V", is in the list of
+  // native methods that dex2oat compiled as @FastNative, see `dex2oat --fast-native-methods`.
+  bool IsFastNativeMethod(std::string_view method) const {
+    return !fast_native_methods_.empty() && std::binary_search(
+        fast_native_methods_.begin(), fast_native_methods_.end(), method);
+  }
+
+  bool HasFastNativeMethods() const {
+    return !fast_native_methods_.empty();
+  }
+
   const std::string& GetLocation() const {
     return location_;
   }
@@ -479,6 +491,10 @@ class OatFile {
   // Mapping info for DexFiles in the BCP.
   std::vector<BssMappingInfo> bcp_bss_info_;
 
+  // The sorted names of the native methods compiled as @FastNative without the annotation,
+  // backed by the key-value store of the oat header.
+  std::vector<std::string_view> fast_native_methods_;
+
   // NOTE: We use a std::string_view as the key type to avoid a memory allocation on every
   // lookup with a const char* key. The std::string_view doesn't own its backing storage,
   // therefore we're using the OatFile's stored dex location as the backing storage
@@ -47,6 +47,7 @@
 #include "exec_utils.h"
 #include "gc/heap.h"
 #include "gc/space/image_space.h"
+#include "dex_checksum_cache.h"
 #include "image.h"
 #include "oat.h"
 #include "oat_file_assistant_context.h"
@@ -708,19 +709,20 @@ bool OatFileAssistant::GetRequiredDexChecksum(std::optional<uint32_t>* checksum,
   if (!required_dex_checksums_attempted_) {
     required_dex_checksums_attempted_ = true;
 
-    File file(zip_fd_, /*check_usage=*/false);
-    ArtDexFileLoader dex_loader(&file, dex_location_);
     std::optional<uint32_t> checksum2;
     std::string error2;
-    if (dex_loader.GetMultiDexChecksum(
-            &checksum2, &error2, &zip_file_only_contains_uncompressed_dex_)) {
+    DexChecksumCache& cache = DexChecksumCache::GetInstance();
+    if (cache.GetMultiDexChecksum(dex_location_,
+                                  zip_fd_,
+                                  &checksum2,
+                                  &error2,
+                                  &zip_file_only_contains_uncompressed_dex_)) {
       cached_required_dex_checksums_ = checksum2;
       cached_required_dex_checksums_error_ = std::nullopt;
     } else {
       cached_required_dex_checksums_ = std::nullopt;
       cached_required_dex_checksums_error_ = error2;
     }
-    file.Release();  // Don't close the file yet (we have only read the checksum).
   }
 
   if (cached_required_dex_checksums_error_.has_value()) {
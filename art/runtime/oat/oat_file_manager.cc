@@ -17,18 +17,25 @@
 #include "oat_file_manager.h"
 
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <queue>
+#include <thread>
 #include <vector>
 
 #include "android-base/file.h"
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
 #include "art_field-inl.h"
+#include "art_method-inl.h"
+#include "base/bit_utils_iterator.h"
 #include "base/bit_vector-inl.h"
 #include "base/file_utils.h"
+#include "base/length_prefixed_array.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/mutex-inl.h"
 #include "base/sdk_version.h"
@@ -40,14 +47,21 @@
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_loader.h"
 #include "dex/dex_file_tracking_registrar.h"
+#include "dex/dex_file_verifier.h"
+#include "dex/type_lookup_table.h"
 #include "gc/scoped_gc_critical_section.h"
 #include "gc/space/image_space.h"
+#include "gc_root-inl.h"
 #include "handle_scope-inl.h"
+#include "index_bss_mapping.h"
 #include "jit/jit.h"
 #include "jni/java_vm_ext.h"
 #include "jni/jni_internal.h"
 #include "mirror/class_loader.h"
+#include "mirror/dex_cache-inl.h"
+#include "mirror/method_type.h"
 #include "mirror/object-inl.h"
+#include "mirror/string.h"
 #include "oat_file.h"
 #include "oat_file_assistant.h"
 #include "obj_ptr-inl.h"
@@ -59,6 +73,7 @@
 #include "vdex_file.h"
 #include "verifier/verifier_deps.h"
 #include "well_known_classes.h"
+#include "write_barrier-inl.h"
 
 namespace art HIDDEN {
 
@@ -112,6 +127,78 @@ void OatFileManager::UnRegisterAndDeleteOatFile(const OatFile* oat_file) {
   compare.release();  // NOLINT b/117926937
 }
 
+void OatFileManager::DeleteTypeLookupTable(const DexFile* dex_file) {
+  WriterMutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
+  type_lookup_tables_.erase(dex_file);
+}
+
+bool OatFileManager::CreateTypeLookupTables(
+    const std::vector<std::unique_ptr<const DexFile>>& dex_files,
+    bool verify,
+    /*out*/ std::string* error_msg) {
+  ScopedTrace trace(__FUNCTION__);
+  // Verifying and indexing the dex files of a multidex APK is independent work which only reads
+  // the dex files, so spread it over a few threads. The threads are not attached to the runtime.
+  std::vector<TypeLookupTable> type_lookup_tables(dex_files.size());
+  std::vector<std::string> error_msgs(dex_files.size());
+  std::vector<uint8_t> verified(dex_files.size(), 1u);
+  auto process = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i != end; ++i) {
+      const DexFile* dex_file = dex_files[i].get();
+      // NB: Dex verifier does not understand the compact dex format.
+      if (verify && !dex_file->IsCompactDexFile()) {
+        ScopedTrace verify_trace("Verify dex file " + dex_file->GetLocation());
+        static constexpr bool kVerifyChecksum = true;
+        if (!dex::Verify(
+                dex_file, dex_file->GetLocation().c_str(), kVerifyChecksum, &error_msgs[i])) {
+          verified[i] = 0u;
+          continue;
+        }
+      }
+      type_lookup_tables[i] = TypeLookupTable::Create(*dex_file);
+    }
+  };
+  const size_t num_threads = std::min(dex_files.size(), kDexFileOpeningThreads);
+  if (num_threads <= 1u) {
+    process(0u, dex_files.size());
+  } else {
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1u);
+    for (size_t t = 1u; t != num_threads; ++t) {
+      threads.emplace_back(process,
+                           t * dex_files.size() / num_threads,
+                           (t + 1u) * dex_files.size() / num_threads);
+    }
+    process(0u, dex_files.size() / num_threads);
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+  // Report the first failure in dex file order, as a sequential verification would.
+  for (size_t i = 0; i != dex_files.size(); ++i) {
+    if (verified[i] == 0u) {
+      *error_msg = std::move(error_msgs[i]);
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i != dex_files.size(); ++i) {
+    const std::unique_ptr<const DexFile>& dex_file = dex_files[i];
+    DCHECK(dex_file->GetOatDexFile() == nullptr);
+    TypeLookupTable type_lookup_table = std::move(type_lookup_tables[i]);
+    if (!type_lookup_table.Valid()) {
+      // No class defs, or too many for a lookup table.
+      continue;
+    }
+    auto oat_dex_file = std::make_unique<OatDexFile>(std::move(type_lookup_table));
+    dex_file->SetOatDexFile(oat_dex_file.get());
+    WriterMutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
+    // Replace any table left behind by a deleted dex file at the same address.
+    type_lookup_tables_[dex_file.get()] = std::move(oat_dex_file);
+  }
+  return true;
+}
+
 const OatFile* OatFileManager::FindOpenedOatFileFromDexLocation(
     const std::string& dex_base_location) const {
   ReaderMutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
@@ -160,6 +247,7 @@ OatFileManager::~OatFileManager() {
   // Explicitly clear oat_files_ since the OatFile destructor calls back into OatFileManager for
   // UnRegisterOatFileLocation.
   oat_files_.clear();
+  type_lookup_tables_.clear();
 }
 
 std::vector<const OatFile*> OatFileManager::RegisterImageOatFiles(
@@ -192,6 +280,36 @@ bool OatFileManager::ShouldLoadAppImage() const {
   return true;
 }
 
+// Madvise the oat file for startup. With a profile-guided code layout, only the data and the
+// startup code at the start of the executable section are prefetched, and the readahead is
+// disabled for the rest of the code, so that page faults in rarely executed code do not pull
+// the code around it into the page cache.
+static void MadviseOatFile(const OatFile& oat_file, size_t madvise_size_limit) {
+  VLOG(oat) << "Madvising oat file: " << oat_file.GetLocation();
+  uint32_t startup_code_end = oat_file.GetOatHeader().GetStartupCodeEndOffset();
+  if (startup_code_end == 0u || !oat_file.IsExecutable()) {
+    Runtime::MadviseFileForRange(madvise_size_limit,
+                                 oat_file.Size(),
+                                 oat_file.Begin(),
+                                 oat_file.End(),
+                                 oat_file.GetLocation());
+    return;
+  }
+  DCHECK_LE(startup_code_end, oat_file.Size());
+  Runtime::MadviseFileForRange(madvise_size_limit,
+                               startup_code_end,
+                               oat_file.Begin(),
+                               oat_file.Begin() + startup_code_end,
+                               oat_file.GetLocation());
+  uint8_t* cold_code_begin =
+      AlignUp(const_cast<uint8_t*>(oat_file.Begin()) + startup_code_end, gPageSize);
+  uint8_t* cold_code_end = AlignDown(const_cast<uint8_t*>(oat_file.End()), gPageSize);
+  if (cold_code_begin < cold_code_end &&
+      madvise(cold_code_begin, cold_code_end - cold_code_begin, MADV_RANDOM) != 0) {
+    PLOG(WARNING) << "Failed to madvise cold code of " << oat_file.GetLocation();
+  }
+}
+
 std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
     const char* dex_location,
     jobject class_loader,
@@ -270,13 +388,7 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
       // Load the dex files from the oat file.
       bool added_image_space = false;
       if (should_madvise) {
-        VLOG(oat) << "Madvising oat file: " << oat_file->GetLocation();
-        size_t madvise_size_limit = runtime->GetMadviseWillNeedSizeOdex();
-        Runtime::MadviseFileForRange(madvise_size_limit,
-                                     oat_file->Size(),
-                                     oat_file->Begin(),
-                                     oat_file->End(),
-                                     oat_file->GetLocation());
+        MadviseOatFile(*oat_file, runtime->GetMadviseWillNeedSizeOdex());
       }
 
       ScopedTrace app_image_timing("AppImage:Loading");
@@ -468,10 +580,14 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
     std::string error_msg;
     static constexpr bool kVerifyChecksum = true;
     ArtDexFileLoader dex_file_loader(dex_location);
-    if (!dex_file_loader.Open(Runtime::Current()->IsVerificationEnabled(),
+    // The dex files are verified by `CreateTypeLookupTables()`, in parallel.
+    if (!dex_file_loader.Open(/*verify=*/ false,
                               kVerifyChecksum,
                               /*out*/ &error_msg,
-                              &dex_files)) {
+                              &dex_files) ||
+        !CreateTypeLookupTables(
+            dex_files, Runtime::Current()->IsVerificationEnabled(), &error_msg)) {
+      dex_files.clear();
       ScopedTrace fail_to_open_dex_from_apk("FailedToOpenDexFilesFromApk");
       LOG(WARNING) << error_msg;
       error_msgs->push_back("Failed to open dex files from " + std::string(dex_location)
@@ -688,13 +804,18 @@ static bool UnlinkLeastRecentlyUsedVdexIfNeeded(const std::string& vdex_path_to_
   return true;
 }
 
-class BackgroundVerificationTask final : public Task {
+// State shared by the tasks verifying, one dex file each, the dex files passed to
+// `OatFileManager::RunBackgroundVerification()`. The last task to finish writes the
+// vdex file with the dependencies recorded by all of them.
+class BackgroundVerification {
  public:
-  BackgroundVerificationTask(const std::vector<const DexFile*>& dex_files,
-                             jobject class_loader,
-                             const std::string& vdex_path)
+  BackgroundVerification(const std::vector<const DexFile*>& dex_files,
+                         jobject class_loader,
+                         const std::string& vdex_path)
       : dex_files_(dex_files),
-        vdex_path_(vdex_path) {
+        vdex_path_(vdex_path),
+        dex_file_deps_(dex_files.size()),
+        remaining_tasks_(dex_files.size()) {
     Thread* const self = Thread::Current();
     ScopedObjectAccess soa(self);
     // Create a global ref for `class_loader` because it will be accessed from a different thread.
@@ -702,60 +823,49 @@ class BackgroundVerificationTask final : public Task {
     CHECK(class_loader_ != nullptr);
   }
 
-  ~BackgroundVerificationTask() {
+  ~BackgroundVerification() {
     Thread* const self = Thread::Current();
     ScopedObjectAccess soa(self);
     soa.Vm()->DeleteGlobalRef(self, class_loader_);
   }
 
-  void Run(Thread* self) override {
-    std::string error_msg;
-    ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
-    verifier::VerifierDeps verifier_deps(dex_files_);
-
-    // Iterate over all classes and verify them.
-    for (const DexFile* dex_file : dex_files_) {
-      for (uint32_t cdef_idx = 0; cdef_idx < dex_file->NumClassDefs(); cdef_idx++) {
-        const dex::ClassDef& class_def = dex_file->GetClassDef(cdef_idx);
-
-        // Take handles inside the loop. The background verification is low priority
-        // and we want to minimize the risk of blocking anyone else.
-        ScopedObjectAccess soa(self);
-        StackHandleScope<2> hs(self);
-        Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
-            soa.Decode<mirror::ClassLoader>(class_loader_)));
-        Handle<mirror::Class> h_class =
-            hs.NewHandle(class_linker->FindClass(self, *dex_file, class_def.class_idx_, h_loader));
-
-        if (h_class == nullptr) {
-          DCHECK(self->IsExceptionPending());
-          self->ClearException();
-          continue;
-        }
-
-        if (&h_class->GetDexFile() != dex_file) {
-          // There is a different class in the class path or a parent class loader
-          // with the same descriptor. This `h_class` is not resolvable, skip it.
-          continue;
-        }
+  const std::vector<const DexFile*>& GetDexFiles() const {
+    return dex_files_;
+  }
 
-        DCHECK(h_class->IsResolved()) << h_class->PrettyDescriptor();
-        class_linker->VerifyClass(self, &verifier_deps, h_class);
-        if (self->IsExceptionPending()) {
-          // ClassLinker::VerifyClass can throw, but the exception isn't useful here.
-          self->ClearException();
-        }
+  jobject GetClassLoader() const {
+    return class_loader_;
+  }
 
-        DCHECK(h_class->IsVerified() || h_class->IsErroneous())
-            << h_class->PrettyDescriptor() << ": state=" << h_class->GetStatus();
+  // Called when the task for the dex file at `index` is finalized, with null `verifier_deps`
+  // if the task did not run. Returns whether this was the last task, in which case the
+  // caller must delete this object.
+  bool FinishDexFile(size_t index, std::unique_ptr<verifier::VerifierDeps> verifier_deps) {
+    dex_file_deps_[index] = std::move(verifier_deps);
+    if (remaining_tasks_.fetch_sub(1u, std::memory_order_acq_rel) != 1u) {
+      return false;
+    }
+    WriteVdex();
+    return true;
+  }
 
-        if (h_class->IsVerified()) {
-          verifier_deps.RecordClassVerified(*dex_file, class_def);
-        }
-      }
+ private:
+  void WriteVdex() {
+    if (std::any_of(dex_file_deps_.begin(),
+                    dex_file_deps_.end(),
+                    [](const std::unique_ptr<verifier::VerifierDeps>& deps) {
+                      return deps == nullptr;
+                    })) {
+      // Some tasks were removed from the thread pool without running.
+      return;
+    }
+    verifier::VerifierDeps verifier_deps(dex_files_);
+    for (size_t i = 0; i != dex_files_.size(); ++i) {
+      verifier_deps.TakeDexFileDeps(dex_file_deps_[i].get(), *dex_files_[i]);
     }
 
     // Delete old vdex files if there are too many in the folder.
+    std::string error_msg;
     if (!UnlinkLeastRecentlyUsedVdexIfNeeded(vdex_path_, &error_msg)) {
       LOG(ERROR) << "Could not unlink old vdex files " << vdex_path_ << ": " << error_msg;
       return;
@@ -771,14 +881,83 @@ class BackgroundVerificationTask final : public Task {
     }
   }
 
+  const std::vector<const DexFile*> dex_files_;
+  jobject class_loader_;
+  const std::string vdex_path_;
+  // Each task only writes the entry of its own dex file.
+  std::vector<std::unique_ptr<verifier::VerifierDeps>> dex_file_deps_;
+  std::atomic<size_t> remaining_tasks_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundVerification);
+};
+
+class BackgroundVerificationTask final : public Task {
+ public:
+  BackgroundVerificationTask(BackgroundVerification* verification, size_t dex_file_index)
+      : verification_(verification),
+        dex_file_index_(dex_file_index) {}
+
+  void Run(Thread* self) override {
+    ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+    const DexFile* dex_file = verification_->GetDexFiles()[dex_file_index_];
+    // Only record the dependencies of our dex file. Classes of other dex files can be
+    // verified here as supertypes of our classes. Their own task then verifies them
+    // again to record their dependencies, see `ClassLinker::VerifyClass()`.
+    verifier_deps_ = std::make_unique<verifier::VerifierDeps>(
+        std::vector<const DexFile*>{dex_file});
+
+    // Iterate over all classes and verify them.
+    for (uint32_t cdef_idx = 0; cdef_idx < dex_file->NumClassDefs(); cdef_idx++) {
+      const dex::ClassDef& class_def = dex_file->GetClassDef(cdef_idx);
+
+      // Take handles inside the loop. The background verification is low priority
+      // and we want to minimize the risk of blocking anyone else.
+      ScopedObjectAccess soa(self);
+      StackHandleScope<2> hs(self);
+      Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
+          soa.Decode<mirror::ClassLoader>(verification_->GetClassLoader())));
+      Handle<mirror::Class> h_class =
+          hs.NewHandle(class_linker->FindClass(self, *dex_file, class_def.class_idx_, h_loader));
+
+      if (h_class == nullptr) {
+        DCHECK(self->IsExceptionPending());
+        self->ClearException();
+        continue;
+      }
+
+      if (&h_class->GetDexFile() != dex_file) {
+        // There is a different class in the class path or a parent class loader
+        // with the same descriptor. This `h_class` is not resolvable, skip it.
+        continue;
+      }
+
+      DCHECK(h_class->IsResolved()) << h_class->PrettyDescriptor();
+      class_linker->VerifyClass(self, verifier_deps_.get(), h_class);
+      if (self->IsExceptionPending()) {
+        // ClassLinker::VerifyClass can throw, but the exception isn't useful here.
+        self->ClearException();
+      }
+
+      DCHECK(h_class->IsVerified() || h_class->IsErroneous())
+          << h_class->PrettyDescriptor() << ": state=" << h_class->GetStatus();
+
+      if (h_class->IsVerified()) {
+        verifier_deps_->RecordClassVerified(*dex_file, class_def);
+      }
+    }
+  }
+
   void Finalize() override {
+    if (verification_->FinishDexFile(dex_file_index_, std::move(verifier_deps_))) {
+      delete verification_;
+    }
     delete this;
   }
 
  private:
-  const std::vector<const DexFile*> dex_files_;
-  jobject class_loader_;
-  const std::string vdex_path_;
+  BackgroundVerification* const verification_;
+  const size_t dex_file_index_;
+  std::unique_ptr<verifier::VerifierDeps> verifier_deps_;
 
   DISALLOW_COPY_AND_ASSIGN(BackgroundVerificationTask);
 };
@@ -848,18 +1027,255 @@ void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>
     return;
   }
 
-  {
-    WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
-    if (verification_thread_pool_ == nullptr) {
-      verification_thread_pool_.reset(
-          ThreadPool::Create("Verification thread pool", /* num_threads= */ 1));
-      verification_thread_pool_->StartWorkers(self);
+  EnsureBackgroundThreadPool(self);
+  // Verify the dex files of a multidex container in parallel.
+  BackgroundVerification* verification =
+      new BackgroundVerification(dex_files, class_loader, GetVdexFilename(odex_filename));
+  for (size_t i = 0; i != dex_files.size(); ++i) {
+    verification_thread_pool_->AddTask(self, new BackgroundVerificationTask(verification, i));
+  }
+}
+
+void OatFileManager::EnsureBackgroundThreadPool(Thread* self) {
+  WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
+  if (verification_thread_pool_ == nullptr) {
+    verification_thread_pool_.reset(ThreadPool::Create(
+        "Verification thread pool", /* num_threads= */ kBackgroundVerificationThreads));
+    verification_thread_pool_->StartWorkers(self);
+  }
+}
+
+// Calls `visitor(index, bss_offset)` for each index mapped to a .bss slot by `mapping`.
+template <typename Visitor>
+static void VisitBssMapping(const IndexBssMapping* mapping,
+                            uint32_t number_of_indexes,
+                            size_t slot_size,
+                            const Visitor& visitor) {
+  if (mapping == nullptr) {
+    return;
+  }
+  size_t index_bits = IndexBssMappingEntry::IndexBits(number_of_indexes);
+  for (const IndexBssMappingEntry& entry : *mapping) {
+    uint32_t index = entry.GetIndex(index_bits);
+    uint32_t mask = entry.GetMask(index_bits);
+    size_t bss_offset = entry.bss_offset - POPCOUNT(mask) * slot_size;
+    for (uint32_t n : LowToHighBits(mask)) {
+      visitor(index - (32u - index_bits) + n, bss_offset);
+      bss_offset += slot_size;
     }
+    DCHECK_EQ(bss_offset, entry.bss_offset);
+    visitor(index, bss_offset);
   }
-  verification_thread_pool_->AddTask(self, new BackgroundVerificationTask(
-      dex_files,
-      class_loader,
-      GetVdexFilename(odex_filename)));
+}
+
+// Resolves the .bss entries of a dex file, like the entrypoints called by the compiled code
+// do on the first use of each entry, see `OatFileManager::PreResolveBssEntriesInBackground()`.
+class BssPreResolutionTask final : public Task {
+ public:
+  BssPreResolutionTask(const DexFile* dex_file, ObjPtr<mirror::ClassLoader> class_loader)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      : dex_file_(dex_file),
+        oat_file_(dex_file->GetOatDexFile()->GetOatFile()) {
+    Thread* const self = Thread::Current();
+    // Create a global ref for `class_loader` because it will be accessed from a different thread.
+    // This also keeps the dex file and the oat file alive.
+    class_loader_ = Runtime::Current()->GetJavaVM()->AddGlobalRef(self, class_loader);
+  }
+
+  ~BssPreResolutionTask() {
+    Thread* const self = Thread::Current();
+    ScopedObjectAccess soa(self);
+    soa.Vm()->DeleteGlobalRef(self, class_loader_);
+  }
+
+  void Run(Thread* self) override {
+    ScopedTrace trace(__PRETTY_FUNCTION__);
+    if (class_loader_ == nullptr) {
+      return;
+    }
+    ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+    const OatDexFile* oat_dex_file = dex_file_->GetOatDexFile();
+    ScopedObjectAccess soa(self);
+    StackHandleScope<2> hs(self);
+    Handle<mirror::ClassLoader> class_loader =
+        hs.NewHandle(soa.Decode<mirror::ClassLoader>(class_loader_));
+    Handle<mirror::DexCache> dex_cache = hs.NewHandle(class_linker->FindDexCache(self, *dex_file_));
+    DCHECK(dex_cache->GetClassLoader() == class_loader.Get());
+
+    // Resolution failures are left to the compiled code, which throws the exception on the
+    // first use of the entry.
+    auto clear_exception = [self]() {
+      if (self->IsExceptionPending()) {
+        self->ClearException();
+      }
+    };
+
+    VisitBssMapping(
+        oat_dex_file->GetMethodBssMapping(),
+        dex_file_->NumMethodIds(),
+        static_cast<size_t>(kRuntimePointerSize),
+        [&](uint32_t method_idx, size_t bss_offset) REQUIRES_SHARED(Locks::mutator_lock_) {
+          // The method was resolved to the same method when compiling the call, so the
+          // checks of the invoke type and access done by the resolution trampoline pass.
+          ArtMethod* method = class_linker->ResolveMethodId(method_idx, dex_cache, class_loader);
+          if (method != nullptr) {
+            StoreMethod(bss_offset, method);
+          }
+          clear_exception();
+          self->AllowThreadSuspension();
+        });
+    auto visit_types = [&](const IndexBssMapping* mapping, auto can_store)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      VisitBssMapping(
+          mapping,
+          dex_file_->NumTypeIds(),
+          sizeof(GcRoot<mirror::Class>),
+          [&](uint32_t type_idx, size_t bss_offset) REQUIRES_SHARED(Locks::mutator_lock_) {
+            ObjPtr<mirror::Class> klass =
+                class_linker->ResolveType(dex::TypeIndex(type_idx), dex_cache, class_loader);
+            if (klass != nullptr && can_store(klass)) {
+              StoreObject(bss_offset, klass, class_loader.Get());
+            }
+            clear_exception();
+            self->AllowThreadSuspension();
+          });
+    };
+    // Store the types in the public and package .bss entries as `StoreTypeInBss()` does.
+    visit_types(oat_dex_file->GetTypeBssMapping(), [](ObjPtr<mirror::Class>) { return true; });
+    visit_types(oat_dex_file->GetPublicTypeBssMapping(),
+                [](ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_) {
+                  return klass->IsPublic();
+                });
+    visit_types(oat_dex_file->GetPackageTypeBssMapping(),
+                [&](ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_) {
+                  return klass->IsPublic() || klass->GetClassLoader() == class_loader.Get();
+                });
+    VisitBssMapping(
+        oat_dex_file->GetStringBssMapping(),
+        dex_file_->NumStringIds(),
+        sizeof(GcRoot<mirror::String>),
+        [&](uint32_t string_idx, size_t bss_offset) REQUIRES_SHARED(Locks::mutator_lock_) {
+          ObjPtr<mirror::String> string =
+              class_linker->ResolveString(dex::StringIndex(string_idx), dex_cache);
+          if (string != nullptr) {
+            StoreObject(bss_offset, string, class_loader.Get());
+          }
+          clear_exception();
+          self->AllowThreadSuspension();
+        });
+    VisitBssMapping(
+        oat_dex_file->GetMethodTypeBssMapping(),
+        dex_file_->NumProtoIds(),
+        sizeof(GcRoot<mirror::MethodType>),
+        [&](uint32_t proto_idx, size_t bss_offset) REQUIRES_SHARED(Locks::mutator_lock_) {
+          ObjPtr<mirror::MethodType> method_type = class_linker->ResolveMethodType(
+              self, dex::ProtoIndex(proto_idx), dex_cache, class_loader);
+          if (method_type != nullptr) {
+            StoreObject(bss_offset, method_type, class_loader.Get());
+          }
+          clear_exception();
+          self->AllowThreadSuspension();
+        });
+    VLOG(oat) << "Pre-resolved " << num_stored_entries_ << " .bss entries for "
+              << dex_file_->GetLocation();
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  void StoreMethod(size_t bss_offset, ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK_ALIGNED(bss_offset, static_cast<size_t>(kRuntimePointerSize));
+    std::atomic<ArtMethod*>* entry = reinterpret_cast<std::atomic<ArtMethod*>*>(
+        const_cast<uint8_t*>(oat_file_->BssBegin() + bss_offset));
+    DCHECK_GE(reinterpret_cast<ArtMethod**>(entry), oat_file_->GetBssMethods().data());
+    DCHECK_LT(reinterpret_cast<ArtMethod**>(entry),
+              oat_file_->GetBssMethods().data() + oat_file_->GetBssMethods().size());
+    // Entries not resolved yet hold the resolution method.
+    ArtMethod* existing = entry->load(std::memory_order_relaxed);
+    if (existing->IsRuntimeMethod() &&
+        entry->compare_exchange_strong(existing, method, std::memory_order_release)) {
+      ++num_stored_entries_;
+    }
+  }
+
+  void StoreObject(size_t bss_offset,
+                   ObjPtr<mirror::Object> object,
+                   ObjPtr<mirror::ClassLoader> class_loader)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK_ALIGNED(bss_offset, sizeof(GcRoot<mirror::Object>));
+    GcRoot<mirror::Object>* slot = reinterpret_cast<GcRoot<mirror::Object>*>(
+        const_cast<uint8_t*>(oat_file_->BssBegin() + bss_offset));
+    DCHECK_GE(slot, oat_file_->GetBssGcRoots().data());
+    DCHECK_LT(slot, oat_file_->GetBssGcRoots().data() + oat_file_->GetBssGcRoots().size());
+    std::atomic<GcRoot<mirror::Object>>* atomic_slot =
+        reinterpret_cast<std::atomic<GcRoot<mirror::Object>>*>(slot);
+    GcRoot<mirror::Object> expected(nullptr);
+    if (atomic_slot->compare_exchange_strong(
+            expected, GcRoot<mirror::Object>(object), std::memory_order_release)) {
+      // We need a write barrier for the class loader that holds the GC roots in the .bss.
+      WriteBarrier::ForEveryFieldWrite(class_loader);
+      ++num_stored_entries_;
+    } else {
+      // Each slot serves to store exactly one Class, String or MethodType.
+      DCHECK_EQ(object, expected.Read());
+    }
+  }
+
+  const DexFile* const dex_file_;
+  const OatFile* const oat_file_;
+  jobject class_loader_;
+  size_t num_stored_entries_ = 0u;
+
+  DISALLOW_COPY_AND_ASSIGN(BssPreResolutionTask);
+};
+
+void OatFileManager::PreResolveBssEntriesInBackground(const DexFile& dex_file,
+                                                      ObjPtr<mirror::ClassLoader> class_loader) {
+  Runtime* const runtime = Runtime::Current();
+  Thread* const self = Thread::Current();
+  DCHECK(class_loader != nullptr);
+
+  const OatDexFile* oat_dex_file = dex_file.GetOatDexFile();
+  if (oat_dex_file == nullptr || oat_dex_file->GetOatFile() == nullptr) {
+    return;
+  }
+  const OatFile* oat_file = oat_dex_file->GetOatFile();
+  if (!oat_file->IsExecutable() ||
+      oat_file->BssSize() == 0u ||
+      !CompilerFilter::DependsOnProfile(oat_file->GetCompilerFilter())) {
+    // Only code compiled for a profile is known to run early, so that resolving all its
+    // .bss entries is worth it.
+    return;
+  }
+  if (oat_dex_file->GetMethodBssMapping() == nullptr &&
+      oat_dex_file->GetTypeBssMapping() == nullptr &&
+      oat_dex_file->GetPublicTypeBssMapping() == nullptr &&
+      oat_dex_file->GetPackageTypeBssMapping() == nullptr &&
+      oat_dex_file->GetStringBssMapping() == nullptr &&
+      oat_dex_file->GetMethodTypeBssMapping() == nullptr) {
+    return;
+  }
+
+  if (runtime->IsAotCompiler() || runtime->IsJavaDebuggable()) {
+    // Threads created by ThreadPool ("runtime threads") are not allowed to load
+    // classes when debuggable, see `RunBackgroundVerification()`.
+    return;
+  }
+
+  if (!IsSdkVersionSetAndAtLeast(runtime->GetTargetSdkVersion(), SdkVersion::kQ)) {
+    // Do not run for legacy apps as they may depend on the previous class loader behaviour.
+    return;
+  }
+
+  if (runtime->IsShuttingDown(self)) {
+    // Not allowed to create new threads during runtime shutdown.
+    return;
+  }
+
+  EnsureBackgroundThreadPool(self);
+  verification_thread_pool_->AddTask(self, new BssPreResolutionTask(&dex_file, class_loader));
 }
 
 void OatFileManager::WaitForWorkersToBeCreated() {
@@ -27,6 +27,7 @@
 #include "base/locks.h"
 #include "base/macros.h"
 #include "jni.h"
+#include "obj_ptr.h"
 
 namespace art HIDDEN {
 
@@ -36,10 +37,16 @@ class ImageSpace;
 }  // namespace space
 }  // namespace gc
 
+namespace mirror {
+class ClassLoader;
+}  // namespace mirror
+
 class ClassLoaderContext;
 class DexFile;
 class MemMap;
+class OatDexFile;
 class OatFile;
+class Thread;
 class ThreadPool;
 
 // Class for dealing with oat file management.
@@ -62,6 +69,10 @@ class OatFileManager {
   void UnRegisterAndDeleteOatFile(const OatFile* oat_file)
       REQUIRES(!Locks::oat_file_manager_lock_);
 
+  // Delete the type lookup table created for a dex file opened without an oat file, if any.
+  // Must be called before deleting the dex file.
+  void DeleteTypeLookupTable(const DexFile* dex_file) REQUIRES(!Locks::oat_file_manager_lock_);
+
   // Find the first opened oat file with the same location, returns null if there are none.
   EXPORT const OatFile* FindOpenedOatFileFromOatLocation(const std::string& oat_location) const
       REQUIRES(!Locks::oat_file_manager_lock_);
@@ -128,6 +139,14 @@ class OatFileManager {
   void RunBackgroundVerification(const std::vector<const DexFile*>& dex_files,
                                  jobject class_loader);
 
+  // Spawn a background task which resolves the .bss entries of the code compiled for `dex_file`,
+  // when compiled with a profile. The .bss entries of such code are the types, strings and
+  // methods its hot and startup methods reference, which otherwise each take a slow path on
+  // their first use. Called when `dex_file` is registered with `class_loader`.
+  void PreResolveBssEntriesInBackground(const DexFile& dex_file,
+                                        ObjPtr<mirror::ClassLoader> class_loader)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::oat_file_manager_lock_);
+
   // Wait for thread pool workers to be created. This is used during shutdown as
   // threads are not allowed to attach while runtime is in shutdown lock.
   void WaitForWorkersToBeCreated();
@@ -141,6 +160,12 @@ class OatFileManager {
   // Wait for all background verification tasks to finish. This is only used by tests.
   EXPORT void WaitForBackgroundVerificationTasks();
 
+  // Number of threads verifying dex files in the background.
+  static constexpr size_t kBackgroundVerificationThreads = 2u;
+
+  // Maximum number of threads verifying the dex files of an APK opened without an oat file.
+  static constexpr size_t kDexFileOpeningThreads = 4u;
+
   // Maximum number of anonymous vdex files kept in the process' data folder.
   static constexpr size_t kAnonymousVdexCacheSize = 8u;
 
@@ -161,13 +186,29 @@ class OatFileManager {
   // Return true if we should attempt to load the app image.
   bool ShouldLoadAppImage() const;
 
+  // Create the thread pool running background tasks, if not created yet.
+  void EnsureBackgroundThreadPool(Thread* self) REQUIRES(!Locks::oat_file_manager_lock_);
+
+  // To speed up class lookups, create type lookup tables for dex files opened without an
+  // oat file. The runtime vdex written after background verification contains the tables,
+  // so later loads of the same dex files map them instead. If `verify`, the dex files are
+  // verified first and the first verification failure, in dex file order, is returned.
+  bool CreateTypeLookupTables(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
+                              bool verify,
+                              /*out*/ std::string* error_msg)
+      REQUIRES(!Locks::oat_file_manager_lock_);
+
   std::set<std::unique_ptr<const OatFile>> oat_files_ GUARDED_BY(Locks::oat_file_manager_lock_);
 
+  // Lookup-table-only oat dex files, see `CreateTypeLookupTables()`.
+  std::unordered_map<const DexFile*, std::unique_ptr<OatDexFile>> type_lookup_tables_
+      GUARDED_BY(Locks::oat_file_manager_lock_);
+
   // Only use the compiled code in an OAT file when the file is on /system. If the OAT file
   // is not on /system, don't load it "executable".
   bool only_use_system_oat_files_;
 
-  // Single-thread pool used to run the verifier in the background.
+  // Thread pool used to run the verifier and the .bss pre-resolution in the background.
   std::unique_ptr<ThreadPool> verification_thread_pool_;
 
   DISALLOW_COPY_AND_ASSIGN(OatFileManager);
@@ -16,6 +16,7 @@
 
 #include "stack_map.h"
 
+#include <atomic>
 #include <iomanip>
 #include <stdint.h>
 
@@ -80,19 +81,63 @@ CodeInfo CodeInfo::DecodeInlineInfoOnly(const OatQuickMethodHeader* header) {
   return copy;
 }
 
+// Process-wide table of stack map row hints for recent native pc lookups, indexed by a hash
+// of the stack map table address and the native pc. The hints are only a guess: each one is
+// validated against the encoded stack maps before use, so stale entries (e.g. for freed JIT
+// code) and races between threads only cost a fallback to the binary search.
+static constexpr size_t kStackMapLookupHintsSize = 4096;
+static std::atomic<uint32_t> gStackMapLookupHints[kStackMapLookupHintsSize];
+
+ALWAYS_INLINE static std::atomic<uint32_t>& GetStackMapLookupHint(uintptr_t table_address,
+                                                                  uint32_t packed_pc) {
+  size_t hash = (table_address ^ (table_address >> 16)) * 31u + packed_pc;
+  hash ^= hash >> 12;
+  return gStackMapLookupHints[hash % kStackMapLookupHintsSize];
+}
+
 StackMap CodeInfo::GetStackMapForNativePcOffset(uintptr_t pc, InstructionSet isa) const {
   uint32_t packed_pc = StackMap::PackNativePc(pc, isa);
+  // The kind and the native pc are adjacent columns, load them together.
+  static_assert(StackMap::kPackedNativePc == StackMap::kKind + 1u);
+  auto is_lookup_result = [packed_pc](const StackMap& sm) ALWAYS_INLINE {
+    auto [kind_value, sm_packed_pc] = sm.GetColumns<StackMap::kKind, 2u>();
+    StackMap::Kind kind = static_cast<StackMap::Kind>(kind_value);
+    return sm_packed_pc == packed_pc &&
+           (kind == StackMap::Kind::Default || kind == StackMap::Kind::OSR);
+  };
+
+  // For methods with many stack maps, try the row found by a previous lookup first. The hinted
+  // row is the result of the search below only if it matches and if it is the first stack map
+  // with the given native pc. Otherwise, a non-matching row could precede it.
+  uint32_t num_rows = stack_maps_.NumRows();
+  bool use_hint = num_rows >= kMinStackMapsForLookupHint;
+  std::atomic<uint32_t>* hint = nullptr;
+  if (use_hint) {
+    hint = &GetStackMapLookupHint(stack_maps_.DataBitAddress(), packed_pc);
+    uint32_t row = hint->load(std::memory_order_relaxed);
+    if (row < num_rows) {
+      StackMap stack_map = stack_maps_.GetRow(row);
+      if (is_lookup_result(stack_map) &&
+          (row == 0u || stack_maps_.GetRow(row - 1u).GetPackedNativePc() != packed_pc)) {
+        return stack_map;
+      }
+    }
+  }
+
   // Binary search.  All catch stack maps are stored separately at the end.
   auto it = std::partition_point(
       stack_maps_.begin(),
       stack_maps_.end(),
       [packed_pc](const StackMap& sm) {
-        return sm.GetPackedNativePc() < packed_pc && sm.GetKind() != StackMap::Kind::Catch;
+        auto [kind, sm_packed_pc] = sm.GetColumns<StackMap::kKind, 2u>();
+        return sm_packed_pc < packed_pc && kind != StackMap::Kind::Catch;
       });
   // Start at the lower bound and iterate over all stack maps with the given native pc.
   for (; it != stack_maps_.end() && (*it).GetNativePcOffset(isa) == pc; ++it) {
-    StackMap::Kind kind = static_cast<StackMap::Kind>((*it).GetKind());
-    if (kind == StackMap::Kind::Default || kind == StackMap::Kind::OSR) {
+    if (is_lookup_result(*it)) {
+      if (use_hint) {
+        hint->store((*it).Row(), std::memory_order_relaxed);
+      }
       return *it;
     }
   }
@@ -231,8 +231,10 @@ class DexRegisterInfo : public BitTableAccessor<2> {
   BIT_TABLE_COLUMN(1, PackedValue)
 
   ALWAYS_INLINE DexRegisterLocation GetLocation() const {
-    DexRegisterLocation::Kind kind = static_cast<DexRegisterLocation::Kind>(GetKind());
-    return DexRegisterLocation(kind, UnpackValue(kind, GetPackedValue()));
+    static_assert(kPackedValue == kKind + 1u);
+    auto [kind_value, packed_value] = GetColumns<kKind, 2u>();
+    DexRegisterLocation::Kind kind = static_cast<DexRegisterLocation::Kind>(kind_value);
+    return DexRegisterLocation(kind, UnpackValue(kind, packed_value));
   }
 
   static uint32_t PackValue(DexRegisterLocation::Kind kind, uint32_t value) {
@@ -468,9 +470,15 @@ class CodeInfo {
     return stack_maps_.GetInvalidRow();
   }
 
+  // Returns the stack map for the given native pc, or an invalid row if there is none.
+  // Lookups in methods with at least `kMinStackMapsForLookupHint` stack maps are accelerated
+  // by a process-wide table of validated hints, so that repeated stack walks through the same
+  // call sites (exception delivery, GC root visiting, stack traces) avoid the binary search.
   EXPORT StackMap GetStackMapForNativePcOffset(uintptr_t pc,
                                                InstructionSet isa = kRuntimeQuickCodeISA) const;
 
+  static constexpr uint32_t kMinStackMapsForLookupHint = 16;
+
   // Dump this CodeInfo object on `vios`.
   // `code_offset` is the (absolute) native PC of the compiled method.
   EXPORT void Dump(VariableIndentationOutputStream* vios,
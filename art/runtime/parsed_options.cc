@@ -167,6 +167,27 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:ForegroundHeapGrowthMultiplier=_")
           .WithType<double>().WithRange(0.1, 5.0)
           .IntoKey(M::ForegroundHeapGrowthMultiplier)
+      .Define("-XX:GcCpuBudget=_")
+          .WithType<double>().WithRange(0.0, 0.5)
+          .IntoKey(M::GcCpuBudget)
+      .Define("-XX:GcPauseTarget=_")  // in ms
+          .WithType<MillisecondsToNanoseconds>()  // store as ns
+          .IntoKey(M::GcPauseTarget)
+      .Define("-XX:AttributeNativeGcs:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::AttributeNativeGcs)
+      .Define("-XX:VerifyHeapSlice=_")
+          .WithType<MemoryKiB>()
+          .IntoKey(M::VerifyHeapSlice)
+      .Define("-XX:ZygoteCompactionRemap:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::ZygoteCompactionRemap)
+      .Define("-XX:UseTransparentHugePages:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::UseTransparentHugePages)
       .Define("-XX:LowMemoryMode")
           .IntoKey(M::LowMemoryMode)
       .Define("-Xjitthreshold:_")
@@ -203,15 +224,24 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:ParallelGCThreads=_")
           .WithType<unsigned int>()
           .IntoKey(M::ParallelGCThreads)
+      .Define("-XX:HeapTaskWorkers=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::HeapTaskWorkers)
       .Define("-XX:ConcGCThreads=_")
           .WithType<unsigned int>()
           .IntoKey(M::ConcGCThreads)
       .Define("-XX:FinalizerTimeoutMs=_")
           .WithType<unsigned int>()
           .IntoKey(M::FinalizerTimeoutMs)
+      .Define("-XX:FinalizerWorkers=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::FinalizerWorkers)
       .Define("-XX:MaxSpinsBeforeThinLockInflation=_")
           .WithType<unsigned int>()
           .IntoKey(M::MaxSpinsBeforeThinLockInflation)
+      .Define("-XX:LockContentionSamplingInterval=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::LockContentionSamplingInterval)
       .Define("-XX:LongPauseLogThreshold=_")  // in ms
           .WithType<MillisecondsToNanoseconds>()  // store as ns
           .IntoKey(M::LongPauseLogThreshold)
@@ -265,6 +295,21 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::UseProfiledJitCompilation)
+      .Define("-Xjitpersistentcache:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::UseJitPersistentCache)
+      .Define("-Xjitstartupprofile:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::UseStartupProfileJitCompilation)
+      .Define("-Xprefetchstartupclasses:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::PrefetchStartupClasses)
+      .Define("-Xjitsamplinghotness:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITSamplingHotnessPeriodMs)
       .Define("-Xjitinitialsize:_")
           .WithType<MemoryKiB>()
           .IntoKey(M::JITCodeCacheInitialCapacity)
@@ -286,6 +331,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitzygotepthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITZygotePoolThreadPthreadPriority)
+      .Define("-Xjitzygoteprofile:_")
+          .WithType<std::string>()
+          .IntoKey(M::JITZygoteProfile)
       .Define("-Xjitsaveprofilinginfo")
           .WithType<ProfileSaverOptions>()
           .AppendValues()
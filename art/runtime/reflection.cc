@@ -832,6 +832,53 @@ void InvokeConstructor(const ScopedObjectAccessAlreadyRunnable& soa,
   InvokeMethodImpl(soa, constructor, np_method, receiver, objects, &shorty, &result);
 }
 
+// Returns the object that `valueOf()` returns for `value` if it is in the boxing cache of
+// `src_class`, or null otherwise.
+static ObjPtr<mirror::Object> LookupBoxingCache(Primitive::Type src_class, const JValue& value)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ArtField* cache_field;
+  int64_t low = -128;
+  int64_t primitive_value;
+  switch (src_class) {
+    case Primitive::kPrimByte:
+      cache_field = WellKnownClasses::java_lang_Byte_ByteCache_cache;
+      primitive_value = value.GetB();
+      break;
+    case Primitive::kPrimChar:
+      cache_field = WellKnownClasses::java_lang_Character_CharacterCache_cache;
+      low = 0;
+      primitive_value = value.GetC();
+      break;
+    case Primitive::kPrimShort:
+      cache_field = WellKnownClasses::java_lang_Short_ShortCache_cache;
+      primitive_value = value.GetS();
+      break;
+    case Primitive::kPrimInt:
+      cache_field = WellKnownClasses::java_lang_Integer_IntegerCache_cache;
+      primitive_value = value.GetI();
+      break;
+    case Primitive::kPrimLong:
+      cache_field = WellKnownClasses::java_lang_Long_LongCache_cache;
+      primitive_value = value.GetJ();
+      break;
+    default:
+      return nullptr;
+  }
+  // The caches are filled by the class initializers run by `ClassLinker::RunRootClinits()`.
+  // The upper bound of the `Integer` cache is configurable, so use the length of the cache.
+  ObjPtr<mirror::ObjectArray<mirror::Object>> cache =
+      ObjPtr<mirror::ObjectArray<mirror::Object>>::DownCast(
+          cache_field->GetObject(cache_field->GetDeclaringClass()));
+  if (UNLIKELY(cache == nullptr)) {
+    return nullptr;
+  }
+  uint64_t index = static_cast<uint64_t>(primitive_value) - static_cast<uint64_t>(low);
+  if (index >= static_cast<uint64_t>(cache->GetLength())) {
+    return nullptr;
+  }
+  return cache->GetWithoutChecks(static_cast<int32_t>(index));
+}
+
 ObjPtr<mirror::Object> BoxPrimitive(Primitive::Type src_class, const JValue& value) {
   if (src_class == Primitive::kPrimNot) {
     return value.GetL();
@@ -841,6 +888,12 @@ ObjPtr<mirror::Object> BoxPrimitive(Primitive::Type src_class, const JValue& val
     return nullptr;
   }
 
+  // Avoid invoking `valueOf()` for the small values that it returns from a boxing cache.
+  ObjPtr<mirror::Object> cached_box = LookupBoxingCache(src_class, value);
+  if (cached_box != nullptr) {
+    return cached_box;
+  }
+
   ArtMethod* m = nullptr;
   const char* shorty;
   switch (src_class) {
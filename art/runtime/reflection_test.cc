@@ -28,6 +28,7 @@
 #include "mirror/class-alloc-inl.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "scoped_thread_state_change-inl.h"
+#include "well_known_classes.h"
 
 namespace art HIDDEN {
 
@@ -604,4 +605,32 @@ TEST_F(ReflectionTest, NonStaticSumDoubleDoubleDoubleDoubleDoubleMethod) {
   InvokeSumDoubleDoubleDoubleDoubleDoubleMethod(false);
 }
 
+TEST_F(ReflectionTest, BoxPrimitiveUsesBoxingCache) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<4> hs(soa.Self());
+  JValue value;
+
+  // Small values come from the boxing caches, like `valueOf()` would return them.
+  value.SetI(42);
+  Handle<mirror::Object> cached_int = hs.NewHandle(BoxPrimitive(Primitive::kPrimInt, value));
+  ASSERT_TRUE(cached_int != nullptr);
+  EXPECT_OBJ_PTR_EQ(cached_int.Get(), BoxPrimitive(Primitive::kPrimInt, value));
+  EXPECT_EQ(42, WellKnownClasses::java_lang_Integer_value->GetInt(cached_int.Get()));
+  value.SetJ(-128);
+  Handle<mirror::Object> cached_long = hs.NewHandle(BoxPrimitive(Primitive::kPrimLong, value));
+  ASSERT_TRUE(cached_long != nullptr);
+  EXPECT_OBJ_PTR_EQ(cached_long.Get(), BoxPrimitive(Primitive::kPrimLong, value));
+  EXPECT_EQ(-128, WellKnownClasses::java_lang_Long_value->GetLong(cached_long.Get()));
+
+  // Other values are boxed in a new object.
+  value.SetI(1000);
+  Handle<mirror::Object> boxed_int = hs.NewHandle(BoxPrimitive(Primitive::kPrimInt, value));
+  ASSERT_TRUE(boxed_int != nullptr);
+  EXPECT_EQ(1000, WellKnownClasses::java_lang_Integer_value->GetInt(boxed_int.Get()));
+  value.SetC(0xffff);
+  Handle<mirror::Object> boxed_char = hs.NewHandle(BoxPrimitive(Primitive::kPrimChar, value));
+  ASSERT_TRUE(boxed_char != nullptr);
+  EXPECT_EQ(0xffff, WellKnownClasses::java_lang_Character_value->GetChar(boxed_char.Get()));
+}
+
 }  // namespace art
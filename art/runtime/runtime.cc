@@ -58,6 +58,7 @@
 #include "base/dumpable.h"
 #include "base/file_utils.h"
 #include "base/flags.h"
+#include "base/lock_contention_profiler.h"
 #include "base/malloc_arena_pool.h"
 #include "base/mem_map_arena_pool.h"
 #include "base/memory_tool.h"
@@ -205,6 +206,10 @@ static constexpr double kLowMemoryMaxLoadFactor = 0.8;
 static constexpr double kNormalMinLoadFactor = 0.4;
 static constexpr double kNormalMaxLoadFactor = 0.7;
 
+// Free JIT arenas kept resident between compilations, enough for most compilations to not
+// fault in new pages.
+static constexpr size_t kJitArenaPoolRetainedBytes = 2 * MB;
+
 #ifdef ART_PAGE_SIZE_AGNOSTIC
 // Declare the constant as ALWAYS_HIDDEN to ensure it isn't visible from outside libart.so.
 const size_t PageSize::value_ ALWAYS_HIDDEN = GetPageSizeSlow();
@@ -506,6 +511,9 @@ Runtime::~Runtime() {
   delete thread_list_;
   thread_list_ = nullptr;
 
+  // The cached `JNIEnvExt`s of detached threads use the `small_lrt_allocator_`.
+  java_vm_->DeleteCachedJniEnvs();
+
   // Delete the JIT after thread list to ensure that there is no remaining threads which could be
   // accessing the instrumentation when we delete it.
   if (jit_ != nullptr) {
@@ -856,6 +864,14 @@ void Runtime::PreZygoteFork() {
     class_linker_->VisitClasses(&visitor);
   }
   heap_->PreZygoteFork();
+  {
+    // The heap may have used worker threads to compact the zygote space.
+    Thread* self = Thread::Current();
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    tl->WaitForUnregisterToComplete(self);
+    CHECK_EQ(tl->Size(), 1u);
+    WaitUntilSingleThreaded();
+  }
   PreZygoteForkNativeBridge();
 }
 
@@ -1274,9 +1290,12 @@ void Runtime::InitNonZygoteOrPostFork(
   }
 
   // Reset the gc performance data and metrics at zygote fork so that the events from
-  // before fork aren't attributed to an app.
+  // before fork aren't attributed to an app. Without a zygote, the metrics, including the
+  // startup phases, belong to this process and are kept.
   heap_->ResetGcPerformanceInfo();
-  GetMetrics()->Reset();
+  if (finished_starting_) {
+    GetMetrics()->Reset();
+  }
 
   if (AreMetricsInitialized()) {
     // Now that we know if we are an app or system server, reload the metrics reporter config
@@ -1529,7 +1548,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   using Opt = RuntimeArgumentMap;
   Opt runtime_options(std::move(runtime_options_in));
-  ScopedTrace trace(__FUNCTION__);
+  metrics::ScopedStartupPhase phase{__FUNCTION__, GetMetrics()->StartupRuntimeInitTime()};
   CHECK_EQ(static_cast<size_t>(sysconf(_SC_PAGE_SIZE)), gPageSize);
 
   // Reload all the flags value (from system properties and device configs).
@@ -1658,8 +1677,11 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   image_compiler_options_ = runtime_options.ReleaseOrDefault(Opt::ImageCompilerOptions);
 
   finalizer_timeout_ms_ = runtime_options.GetOrDefault(Opt::FinalizerTimeoutMs);
+  finalizer_workers_ = std::max(1u, runtime_options.GetOrDefault(Opt::FinalizerWorkers));
   max_spins_before_thin_lock_inflation_ =
       runtime_options.GetOrDefault(Opt::MaxSpinsBeforeThinLockInflation);
+  LockContentionProfiler::SetSamplingInterval(
+      runtime_options.GetOrDefault(Opt::LockContentionSamplingInterval));
 
   monitor_list_ = new MonitorList;
   monitor_pool_ = MonitorPool::Create();
@@ -1744,6 +1766,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   // Generational CC collection is currently only compatible with Baker read barriers.
   bool use_generational_cc = kUseBakerReadBarrier && xgc_option.generational_cc;
+  bool use_generational_cmc = gUseUserfaultfd && xgc_option.generational_cmc;
 
   // Cache the apex versions.
   InitializeApexVersions();
@@ -1753,49 +1776,66 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                         (gUseUserfaultfd ? BackgroundGcOption(gc::kCollectorTypeCMCBackground) :
                                            runtime_options.GetOrDefault(Opt::BackgroundGc));
 
-  heap_ = new gc::Heap(runtime_options.GetOrDefault(Opt::MemoryInitialSize),
-                       runtime_options.GetOrDefault(Opt::HeapGrowthLimit),
-                       runtime_options.GetOrDefault(Opt::HeapMinFree),
-                       runtime_options.GetOrDefault(Opt::HeapMaxFree),
-                       runtime_options.GetOrDefault(Opt::HeapTargetUtilization),
-                       foreground_heap_growth_multiplier,
-                       runtime_options.GetOrDefault(Opt::StopForNativeAllocs),
-                       runtime_options.GetOrDefault(Opt::MemoryMaximumSize),
-                       runtime_options.GetOrDefault(Opt::NonMovingSpaceCapacity),
-                       GetBootClassPath(),
-                       GetBootClassPathLocations(),
-                       GetBootClassPathFiles(),
-                       GetBootClassPathImageFiles(),
-                       GetBootClassPathVdexFiles(),
-                       GetBootClassPathOatFiles(),
-                       image_locations_,
-                       instruction_set_,
-                       // Override the collector type to CC if the read barrier config.
-                       gUseReadBarrier ? gc::kCollectorTypeCC : xgc_option.collector_type_,
-                       background_gc,
-                       runtime_options.GetOrDefault(Opt::LargeObjectSpace),
-                       runtime_options.GetOrDefault(Opt::LargeObjectThreshold),
-                       runtime_options.GetOrDefault(Opt::ParallelGCThreads),
-                       runtime_options.GetOrDefault(Opt::ConcGCThreads),
-                       runtime_options.Exists(Opt::LowMemoryMode),
-                       runtime_options.GetOrDefault(Opt::LongPauseLogThreshold),
-                       runtime_options.GetOrDefault(Opt::LongGCLogThreshold),
-                       runtime_options.Exists(Opt::IgnoreMaxFootprint),
-                       runtime_options.GetOrDefault(Opt::AlwaysLogExplicitGcs),
-                       runtime_options.GetOrDefault(Opt::UseTLAB),
-                       xgc_option.verify_pre_gc_heap_,
-                       xgc_option.verify_pre_sweeping_heap_,
-                       xgc_option.verify_post_gc_heap_,
-                       xgc_option.verify_pre_gc_rosalloc_,
-                       xgc_option.verify_pre_sweeping_rosalloc_,
-                       xgc_option.verify_post_gc_rosalloc_,
-                       xgc_option.gcstress_,
-                       xgc_option.measure_,
-                       runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
-                       use_generational_cc,
-                       runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
-                       runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
-                       runtime_options.Exists(Opt::DumpRegionInfoAfterGC));
+  {
+    // Creating the heap includes mapping the boot image and opening its oat files.
+    metrics::ScopedStartupPhase phase{"CreateHeap", GetMetrics()->StartupHeapCreationTime()};
+    heap_ = new gc::Heap(runtime_options.GetOrDefault(Opt::MemoryInitialSize),
+                         runtime_options.GetOrDefault(Opt::HeapGrowthLimit),
+                         runtime_options.GetOrDefault(Opt::HeapMinFree),
+                         runtime_options.GetOrDefault(Opt::HeapMaxFree),
+                         runtime_options.GetOrDefault(Opt::HeapTargetUtilization),
+                         foreground_heap_growth_multiplier,
+                         runtime_options.GetOrDefault(Opt::StopForNativeAllocs),
+                         runtime_options.GetOrDefault(Opt::MemoryMaximumSize),
+                         runtime_options.GetOrDefault(Opt::NonMovingSpaceCapacity),
+                         GetBootClassPath(),
+                         GetBootClassPathLocations(),
+                         GetBootClassPathFiles(),
+                         GetBootClassPathImageFiles(),
+                         GetBootClassPathVdexFiles(),
+                         GetBootClassPathOatFiles(),
+                         image_locations_,
+                         instruction_set_,
+                         // Override the collector type to CC if the read barrier config.
+                         gUseReadBarrier ? gc::kCollectorTypeCC : xgc_option.collector_type_,
+                         background_gc,
+                         runtime_options.GetOrDefault(Opt::LargeObjectSpace),
+                         runtime_options.GetOrDefault(Opt::LargeObjectThreshold),
+                         runtime_options.GetOrDefault(Opt::ParallelGCThreads),
+                         runtime_options.GetOrDefault(Opt::ConcGCThreads),
+                         runtime_options.Exists(Opt::LowMemoryMode),
+                         runtime_options.GetOrDefault(Opt::LongPauseLogThreshold),
+                         runtime_options.GetOrDefault(Opt::LongGCLogThreshold),
+                         runtime_options.Exists(Opt::IgnoreMaxFootprint),
+                         runtime_options.GetOrDefault(Opt::AlwaysLogExplicitGcs),
+                         runtime_options.GetOrDefault(Opt::UseTLAB),
+                         xgc_option.verify_pre_gc_heap_,
+                         xgc_option.verify_pre_sweeping_heap_,
+                         xgc_option.verify_post_gc_heap_,
+                         xgc_option.verify_pre_gc_rosalloc_,
+                         xgc_option.verify_pre_sweeping_rosalloc_,
+                         xgc_option.verify_post_gc_rosalloc_,
+                         xgc_option.gcstress_,
+                         xgc_option.measure_,
+                         runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
+                         use_generational_cc,
+                         use_generational_cmc,
+                         runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
+                         runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
+                         runtime_options.Exists(Opt::DumpRegionInfoAfterGC),
+                         runtime_options.GetOrDefault(Opt::GcCpuBudget),
+                         runtime_options.GetOrDefault(Opt::GcPauseTarget),
+                         runtime_options.GetOrDefault(Opt::AttributeNativeGcs),
+                         runtime_options.GetOrDefault(Opt::VerifyHeapSlice),
+                         runtime_options.GetOrDefault(Opt::ZygoteCompactionRemap),
+                         runtime_options.GetOrDefault(Opt::UseTransparentHugePages));
+  }
+  const uint32_t boot_images_kb = heap_->GetBootImagesSize() / KB;
+  GetMetrics()->StartupBootImageMappedKb()->Add(boot_images_kb);
+  ATraceIntegerValue("Boot image mapped KiB", static_cast<int32_t>(boot_images_kb));
+  // The runtime thread is not attached yet.
+  heap_->GetTaskProcessor()->SetNumWorkers(/*self=*/ nullptr,
+                                           runtime_options.GetOrDefault(Opt::HeapTaskWorkers));
 
   dump_gc_performance_on_shutdown_ = runtime_options.Exists(Opt::DumpGCPerformanceOnShutdown);
 
@@ -1846,11 +1886,15 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   // can't be trimmed as easily.
   const bool use_malloc = IsAotCompiler();
   if (use_malloc) {
-    arena_pool_.reset(new MallocArenaPool());
+    // Compiling with dex2oat fills most arenas, so fault their pages in as they are allocated.
+    arena_pool_.reset(new MallocArenaPool(/* populate_new_arenas= */ true));
     jit_arena_pool_.reset(new MallocArenaPool());
   } else {
     arena_pool_.reset(new MemMapArenaPool(/* low_4gb= */ false));
-    jit_arena_pool_.reset(new MemMapArenaPool(/* low_4gb= */ false, "CompilerMetadata"));
+    MemMapArenaPool* jit_arena_pool =
+        new MemMapArenaPool(/* low_4gb= */ false, "CompilerMetadata");
+    jit_arena_pool->SetRetainedBytes(kJitArenaPoolRetainedBytes);
+    jit_arena_pool_.reset(jit_arena_pool);
   }
 
   // For 64 bit compilers, it needs to be in low 4GB in the case where we are cross compiling for a
@@ -1961,7 +2005,12 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
         runtime_options.GetOrDefault(Opt::FastClassNotFoundException));
   }
   if (GetHeap()->HasBootImageSpace()) {
-    bool result = class_linker_->InitFromBootImage(&error_msg);
+    bool result;
+    {
+      metrics::ScopedStartupPhase phase{"InitFromBootImage",
+                                        GetMetrics()->StartupClassLinkerInitTime()};
+      result = class_linker_->InitFromBootImage(&error_msg);
+    }
     if (!result) {
       LOG(ERROR) << "Could not initialize from image: " << error_msg;
       return false;
@@ -2457,6 +2506,7 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
   thread_list_->DumpForSigQuit(os);
   GetClassLinker()->DumpForSigQuit(os);
   GetInternTable()->DumpForSigQuit(os);
+  GetMonitorList()->DumpForSigQuit(os);
   GetJavaVM()->DumpForSigQuit(os);
   GetHeap()->DumpForSigQuit(os);
   oat_file_manager_->DumpForSigQuit(os);
@@ -2471,6 +2521,7 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
   os << "\n";
 
   BaseMutex::DumpAll(os);
+  LockContentionProfiler::Dump(os);
 
   // Inform anyone else who is interested in SigQuit.
   {
@@ -2992,6 +3043,7 @@ void Runtime::CreateJit() {
     return;
   }
 
+  metrics::ScopedStartupPhase phase{__FUNCTION__, GetMetrics()->StartupJitCreationTime()};
   std::string error_msg;
   bool profiling_only = !jit_options_->UseJitCompilation();
   jit_code_cache_.reset(jit::JitCodeCache::Create(profiling_only,
@@ -3315,6 +3367,11 @@ bool Runtime::NotifyStartupCompleted() {
 
   ProfileSaver::NotifyStartupCompleted();
 
+  if (jit_ != nullptr) {
+    // The startup methods have been compiled by now, keep them for the next startup.
+    jit_->SavePersistentCache(Thread::Current());
+  }
+
   if (AreMetricsInitialized()) {
     metrics_reporter_->NotifyStartupCompleted();
   }
@@ -40,6 +40,7 @@
 #include "dex/dex_file_types.h"
 #include "experimental_flags.h"
 #include "gc_root.h"
+#include "hidden_api_decision_cache.h"
 #include "instrumentation.h"
 #include "jdwp_provider.h"
 #include "jni/jni_id_manager.h"
@@ -395,6 +396,10 @@ class Runtime {
     return finalizer_timeout_ms_;
   }
 
+  unsigned int GetFinalizerWorkers() const {
+    return finalizer_workers_;
+  }
+
   gc::Heap* GetHeap() const {
     return heap_;
   }
@@ -659,6 +664,7 @@ class Runtime {
 
   void SetHiddenApiEnforcementPolicy(hiddenapi::EnforcementPolicy policy) {
     hidden_api_policy_ = policy;
+    hidden_api_decision_cache_.Clear();
   }
 
   hiddenapi::EnforcementPolicy GetHiddenApiEnforcementPolicy() const {
@@ -675,6 +681,7 @@ class Runtime {
 
   void SetTestApiEnforcementPolicy(hiddenapi::EnforcementPolicy policy) {
     test_api_policy_ = policy;
+    hidden_api_decision_cache_.Clear();
   }
 
   hiddenapi::EnforcementPolicy GetTestApiEnforcementPolicy() const {
@@ -683,12 +690,19 @@ class Runtime {
 
   void SetHiddenApiExemptions(const std::vector<std::string>& exemptions) {
     hidden_api_exemptions_ = exemptions;
+    hidden_api_decision_cache_.Clear();
   }
 
   const std::vector<std::string>& GetHiddenApiExemptions() {
     return hidden_api_exemptions_;
   }
 
+  // Cleared by the setters of the hidden API state above. Must also be cleared when
+  // changing the disabled compat changes.
+  hiddenapi::AccessDecisionCache* GetHiddenApiDecisionCache() {
+    return &hidden_api_decision_cache_;
+  }
+
   void SetDedupeHiddenApiWarnings(bool value) {
     dedupe_hidden_api_warnings_ = value;
   }
@@ -739,6 +753,7 @@ class Runtime {
 
   void SetTargetSdkVersion(uint32_t version) {
     target_sdk_version_ = version;
+    hidden_api_decision_cache_.Clear();
   }
 
   uint32_t GetTargetSdkVersion() const {
@@ -1250,6 +1265,11 @@ class Runtime {
   // Finalizers running for longer than this many milliseconds abort the runtime.
   unsigned int finalizer_timeout_ms_;
 
+  // The number of threads the finalizer daemon runs finalizers on. Each finalizer reference is
+  // dequeued from the finalizer queue by exactly one worker, so each finalizer still runs once,
+  // and the finalizer timeout applies to each worker separately.
+  unsigned int finalizer_workers_;
+
   gc::Heap* heap_;
 
   std::unique_ptr<ArenaPool> jit_arena_pool_;
@@ -1462,6 +1482,9 @@ class Runtime {
   // as if SDK.
   std::vector<std::string> hidden_api_exemptions_;
 
+  // Cached hidden API decisions for application callers, see `AccessDecisionCache`.
+  hiddenapi::AccessDecisionCache hidden_api_decision_cache_;
+
   // Do not warn about the same hidden API access violation twice.
   // This is only used for testing.
   bool dedupe_hidden_api_warnings_;
@@ -29,15 +29,18 @@
 #include "base/bit_utils.h"
 #include "base/file_utils.h"
 #include "base/length_prefixed_array.h"
+#include "base/logging.h"  // For VLOG.
 #include "base/scoped_flock.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
 #include "base/unix_file/fd_file.h"
 #include "base/utils.h"
+#include "class_linker.h"
 #include "class_loader_context.h"
 #include "class_loader_utils.h"
 #include "class_root-inl.h"
 #include "dex/class_accessor-inl.h"
+#include "dex/dex_file_loader.h"
 #include "gc/space/image_space.h"
 #include "mirror/object-inl.h"
 #include "mirror/object-refvisitor-inl.h"
@@ -50,6 +53,7 @@
 #include "oat/oat.h"
 #include "profile/profile_compilation_info.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread.h"
 #include "vdex_file.h"
 
 namespace art HIDDEN {
@@ -1727,7 +1731,7 @@ class RuntimeImageHelper {
     }
 
     const OatDexFile* oat_dex_file = dex_caches[0]->GetDexFile()->GetOatDexFile();
-    if (oat_dex_file == nullptr) {
+    if (oat_dex_file == nullptr || oat_dex_file->GetOatFile() == nullptr) {
       // We need a .oat file for loading an app image;
       dex_caches.clear();
       return;
@@ -1871,6 +1875,82 @@ static bool EnsureDirectoryExists(const std::string& directory, std::string* err
   return true;
 }
 
+bool RuntimeImage::ShouldWriteImage(const std::string& dex_location) {
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  ScopedObjectAccess soa(Thread::Current());
+  const gc::space::ImageSpace* app_image_space = nullptr;
+  for (gc::space::ContinuousSpace* space : heap->GetContinuousSpaces()) {
+    if (space->IsImageSpace() &&
+        space->AsImageSpace()->GetImageHeader().IsAppImage() &&
+        space->AsImageSpace()->GetOatFile()->GetOatDexFiles()[0]->GetDexFileLocation() ==
+            dex_location) {
+      app_image_space = space->AsImageSpace();
+      break;
+    }
+  }
+  if (app_image_space == nullptr) {
+    return true;
+  }
+  if (app_image_space->GetImageFilename() != GetRuntimeImagePath(dex_location)) {
+    // The app image was generated by dex2oat, don't replace it.
+    return false;
+  }
+
+  // A class not in the image can only be written to the next image if its super classes can too.
+  // Classes extending classes of another class loader would never make it to the image, so do not
+  // count them, as they would otherwise trigger a new image on every run.
+  auto can_be_in_image = [&](ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (; klass != nullptr; klass = klass->GetSuperClass()) {
+      if (heap->ObjectIsInBootImageSpace(klass)) {
+        return true;
+      }
+      if (klass->IsBootStrapClassLoaded() || klass->IsProxyClass() || klass->IsErroneous() ||
+          DexFileLoader::GetBaseLocation(klass->GetDexFile().GetLocation()) != dex_location) {
+        return false;
+      }
+    }
+    return true;
+  };
+  size_t num_image_classes = 0u;
+  size_t num_new_classes = 0u;
+  ClassFuncVisitor visitor([&](ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (klass->IsBootStrapClassLoaded() || klass->IsArrayClass() || !klass->IsResolved()) {
+      return true;
+    }
+    if (app_image_space->HasAddress(klass.Ptr())) {
+      ++num_image_classes;
+    } else if (can_be_in_image(klass)) {
+      ++num_new_classes;
+    }
+    return true;
+  });
+  Runtime::Current()->GetClassLinker()->VisitClasses(&visitor);
+  VLOG(image) << "Runtime app image for " << dex_location << " has " << num_image_classes
+              << " classes, " << num_new_classes << " classes were loaded outside of it";
+  return num_new_classes >= kMinNewClassesForUpdate &&
+         num_new_classes * 100u >= num_image_classes * kMinNewClassesPercentForUpdate;
+}
+
+// Lowers the priority of the current thread for the duration of the scope.
+class ScopedLowPriority {
+ public:
+  ScopedLowPriority() : self_(Thread::Current()), old_priority_(self_->GetNativePriority()) {
+    if (old_priority_ > kMinThreadPriority) {
+      self_->SetNativePriority(kMinThreadPriority);
+    }
+  }
+
+  ~ScopedLowPriority() {
+    if (old_priority_ > kMinThreadPriority) {
+      self_->SetNativePriority(old_priority_);
+    }
+  }
+
+ private:
+  Thread* const self_;
+  const int old_priority_;
+};
+
 bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
   if (gPageSize != kMinPageSize) {
     *error_msg = "Writing runtime image is only supported on devices with 4K page size";
@@ -1894,6 +1974,10 @@ bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
   }
 
   ScopedTrace write_image_trace("Writing runtime image to disk");
+  // Generating the image holds the mutator lock, so it runs at the priority of the caller to not
+  // delay thread suspensions. Compressing and writing the image does not, and the app should not
+  // compete for CPU with it.
+  ScopedLowPriority low_priority;
 
   const std::string path = GetRuntimeImagePath(image->GetDexLocation());
   if (!EnsureDirectoryExists(android::base::Dirname(path), error_msg)) {
@@ -1928,6 +2012,7 @@ bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
           kImageStorageMode,
           kMaxImageBlockSize,
           /* update_checksum= */ false,
+          /* thread_pool= */ nullptr,
           error_msg)) {
     return false;
   }
@@ -28,6 +28,15 @@ class RuntimeImage {
     // Writes an app image for the currently running process.
   static bool WriteImageToDisk(std::string* error_msg);
 
+  // Returns whether an app image should be written for the primary APK `dex_location`: either it
+  // was started without an app image, or with a runtime app image and it has since loaded at least
+  // `kMinNewClassesForUpdate` classes, and `kMinNewClassesPercentForUpdate`% of the classes in the
+  // image, which the image does not contain.
+  static bool ShouldWriteImage(const std::string& dex_location);
+
+  static constexpr size_t kMinNewClassesForUpdate = 100u;
+  static constexpr size_t kMinNewClassesPercentForUpdate = 10u;
+
   // Gets the path where a runtime-generated app image is stored.
   //
   // If any of the arguments is a valid glob (a pattern that contains '**' or those documented in
@@ -404,9 +404,9 @@ class StackVisitor {
   mutable std::pair<const OatQuickMethodHeader*, CodeInfo> cur_inline_info_;
   mutable std::pair<uintptr_t, StackMap> cur_stack_map_;
 
+ protected:
   uint8_t* GetShouldDeoptimizeFlagAddr() const REQUIRES_SHARED(Locks::mutator_lock_);
 
- protected:
   Context* const context_;
   const bool check_suspended_;
 };
@@ -16,6 +16,9 @@
 
 #include "startup_completed_task.h"
 
+#include <algorithm>
+
+#include "base/arena_allocator.h"
 #include "base/systrace.h"
 #include "class_linker.h"
 #include "gc/heap.h"
@@ -58,7 +61,7 @@ void StartupCompletedTask::Run(Thread* self) {
       CompilerFilter::Filter filter;
       if (CompilerFilter::ParseCompilerFilter(compiler_filter.c_str(), &filter) &&
           !CompilerFilter::IsAotCompilationEnabled(filter) &&
-          !runtime->GetHeap()->HasAppImageSpaceFor(primary_apk_path)) {
+          RuntimeImage::ShouldWriteImage(primary_apk_path)) {
         std::string error_msg;
         if (!RuntimeImage::WriteImageToDisk(&error_msg)) {
           LOG(DEBUG) << "Could not write temporary image to disk " << error_msg;
@@ -66,8 +69,23 @@ void StartupCompletedTask::Run(Thread* self) {
       }
     }
 
-    ScopedObjectAccess soa(self);
-    DeleteStartupDexCaches(self, /* called_by_gc= */ false);
+    {
+      ScopedObjectAccess soa(self);
+      DeleteStartupDexCaches(self, /* called_by_gc= */ false);
+    }
+
+    // Class verification and JIT compilation during startup leave free arenas behind.
+    ScopedTrace trace("Trim arena pools");
+    size_t released_bytes = 0u;
+    for (ArenaPool* arena_pool : {runtime->GetArenaPool(), runtime->GetJitArenaPool()}) {
+      if (arena_pool != nullptr) {
+        const size_t bytes_before = arena_pool->GetBytesAllocated();
+        arena_pool->TrimMaps();
+        released_bytes += bytes_before - std::min(bytes_before, arena_pool->GetBytesAllocated());
+      }
+    }
+    VLOG(startup) << "Released " << released_bytes << " bytes of free arenas";
+    runtime->GetMetrics()->StartupReleasedArenaPoolBytes()->Add(released_bytes);
   }
 
   // Delete the thread pool used for app image loading since startup is assumed to be completed.
@@ -128,20 +146,25 @@ void StartupCompletedTask::DeleteStartupDexCaches(Thread* self, bool called_by_g
 
   // At this point, we know no other thread can see the arrays, nor the GC. So
   // we can safely release them.
+  size_t released_metadata_bytes = 0u;
   for (gc::space::ContinuousSpace* space : runtime->GetHeap()->GetContinuousSpaces()) {
     if (space->IsImageSpace()) {
       gc::space::ImageSpace* image_space = space->AsImageSpace();
       if (image_space->GetImageHeader().IsAppImage()) {
-        image_space->ReleaseMetadata();
+        released_metadata_bytes += image_space->ReleaseMetadata();
       }
     }
   }
+  runtime->GetMetrics()->StartupReleasedImageMetadataBytes()->Add(released_metadata_bytes);
 
   if (startup_linear_alloc != nullptr) {
     ScopedTrace trace2("Delete startup linear alloc");
     ArenaPool* arena_pool = startup_linear_alloc->GetArenaPool();
+    const size_t released_linear_alloc_bytes = startup_linear_alloc->GetUsedMemory();
     startup_linear_alloc.reset();
     arena_pool->TrimMaps();
+    VLOG(startup) << "Released " << released_linear_alloc_bytes << " bytes of startup linear alloc";
+    runtime->GetMetrics()->StartupReleasedLinearAllocBytes()->Add(released_linear_alloc_bytes);
   }
 }
 
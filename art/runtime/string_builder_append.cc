@@ -82,7 +82,7 @@ class StringBuilderAppend::Builder {
                                CharType* data,
                                int64_t value) REQUIRES_SHARED(Locks::mutator_lock_);
 
-  int32_t ConvertFpArgs() REQUIRES_SHARED(Locks::mutator_lock_);
+  int64_t ConvertArgs(/*inout*/ bool* compressible) REQUIRES_SHARED(Locks::mutator_lock_);
 
   template <typename CharType>
   void StoreData(ObjPtr<mirror::String> new_string, CharType* data) const
@@ -234,9 +234,10 @@ inline CharType* StringBuilderAppend::Builder::AppendInt64(ObjPtr<mirror::String
   return data + length;
 }
 
-int32_t StringBuilderAppend::Builder::ConvertFpArgs() {
-  int32_t fp_args_length = 0u;
+int64_t StringBuilderAppend::Builder::ConvertArgs(/*inout*/ bool* compressible) {
+  int64_t converted_args_length = 0u;
   const uint32_t* current_arg = args_;
+  size_t handle_index = 0u;
   size_t fp_arg_index = 0u;
   for (uint32_t f = format_; f != 0u; f >>= kBitsPerArg) {
     DCHECK_LE(f & kArgMask, static_cast<uint32_t>(Argument::kLast));
@@ -244,6 +245,28 @@ int32_t StringBuilderAppend::Builder::ConvertFpArgs() {
     ObjPtr<mirror::Object> converter;
     switch (static_cast<Argument>(f & kArgMask)) {
       case Argument::kString:
+        ++handle_index;
+        break;
+      case Argument::kObject: {
+        // Call `String.valueOf(obj)`. The conversions are done in the order of the original
+        // `StringBuilder.append()` calls, so the `toString()` calls are made in the same order.
+        // The result replaces the object in its handle; a null `toString()` result gives "null".
+        DCHECK_LT(handle_index, hs_.Size());
+        ObjPtr<mirror::String> str = WellKnownClasses::java_lang_String_valueOf
+            ->InvokeStatic<'L', 'L'>(hs_.Self(), hs_.GetReference(handle_index));
+        if (UNLIKELY(hs_.Self()->IsExceptionPending())) {
+          return -1;
+        }
+        hs_.SetReference(handle_index, str);
+        ++handle_index;
+        if (str != nullptr) {
+          converted_args_length += str->GetLength();
+          *compressible = *compressible && str->IsCompressed();
+        } else {
+          converted_args_length += kNullLength;
+        }
+        break;
+      }
       case Argument::kBoolean:
       case Argument::kChar:
       case Argument::kInt:
@@ -272,7 +295,6 @@ int32_t StringBuilderAppend::Builder::ConvertFpArgs() {
       }
       case Argument::kStringBuilder:
       case Argument::kCharArray:
-      case Argument::kObject:
         LOG(FATAL) << "Unimplemented arg format: 0x" << std::hex
             << (f & kArgMask) << " full format: 0x" << std::hex << format_;
         UNREACHABLE();
@@ -325,20 +347,20 @@ int32_t StringBuilderAppend::Builder::ConvertFpArgs() {
         }
       }
       converted_fp_arg_lengths_[fp_arg_index] = length;
-      fp_args_length += length;
+      converted_args_length += length;
       ++fp_arg_index;
     }
     ++current_arg;
     DCHECK_LE(fp_arg_index, kMaxArgs);
   }
-  return fp_args_length;
+  return converted_args_length;
 }
 
 inline int32_t StringBuilderAppend::Builder::CalculateLengthWithFlag() {
   static_assert(static_cast<size_t>(Argument::kEnd) == 0u, "kEnd must be 0.");
   bool compressible = mirror::kUseStringCompression;
   uint64_t length = 0u;
-  bool has_fp_args = false;
+  bool needs_conversion = false;
   const uint32_t* current_arg = args_;
   for (uint32_t f = format_; f != 0u; f >>= kBitsPerArg) {
     DCHECK_LE(f & kArgMask, static_cast<uint32_t>(Argument::kLast));
@@ -381,12 +403,16 @@ inline int32_t StringBuilderAppend::Builder::CalculateLengthWithFlag() {
       case Argument::kFloat:
         // Conversion shall be performed in a separate pass because it calls back to
         // managed code and we need to convert reference arguments to `Handle<>`s first.
-        has_fp_args = true;
+        needs_conversion = true;
+        break;
+      case Argument::kObject:
+        // Move the reference to a `Handle<>` now and convert it in the separate pass.
+        hs_.NewHandle(reinterpret_cast32<mirror::Object*>(*current_arg));
+        needs_conversion = true;
         break;
 
       case Argument::kStringBuilder:
       case Argument::kCharArray:
-      case Argument::kObject:
         LOG(FATAL) << "Unimplemented arg format: 0x" << std::hex
             << (f & kArgMask) << " full format: 0x" << std::hex << format_;
         UNREACHABLE();
@@ -398,14 +424,14 @@ inline int32_t StringBuilderAppend::Builder::CalculateLengthWithFlag() {
     ++current_arg;
   }
 
-  if (UNLIKELY(has_fp_args)) {
-    // Call Java helpers to convert FP args.
-    int32_t fp_args_length = ConvertFpArgs();
-    if (fp_args_length == -1) {
+  if (UNLIKELY(needs_conversion)) {
+    // Call Java helpers to convert FP and object args.
+    int64_t converted_args_length = ConvertArgs(&compressible);
+    if (converted_args_length == -1) {
       return -1;
     }
-    DCHECK_GT(fp_args_length, 0);
-    length += fp_args_length;
+    DCHECK_GE(converted_args_length, 0);
+    length += converted_args_length;
   }
 
   if (length > std::numeric_limits<int32_t>::max()) {
@@ -428,7 +454,9 @@ inline void StringBuilderAppend::Builder::StoreData(ObjPtr<mirror::String> new_s
   for (uint32_t f = format_; f != 0u; f >>= kBitsPerArg) {
     DCHECK_LE(f & kArgMask, static_cast<uint32_t>(Argument::kLast));
     switch (static_cast<Argument>(f & kArgMask)) {
-      case Argument::kString: {
+      case Argument::kString:
+      case Argument::kObject: {
+        // Object arguments have been replaced with their `String.valueOf()` in `ConvertArgs()`.
         DCHECK_LT(handle_index, hs_.Size());
         ObjPtr<mirror::String> str =
             ObjPtr<mirror::String>::DownCast(hs_.GetReference(handle_index));
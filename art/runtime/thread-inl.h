@@ -425,9 +425,9 @@ inline ThreadState Thread::TransitionFromSuspendedToRunnable(bool fail_on_suspen
   return static_cast<ThreadState>(old_state);
 }
 
-inline mirror::Object* Thread::AllocTlab(size_t bytes) {
+inline mirror::Object* Thread::AllocTlab(size_t bytes, size_t num_objects) {
   DCHECK_GE(TlabSize(), bytes);
-  ++tlsPtr_.thread_local_objects;
+  tlsPtr_.thread_local_objects += num_objects;
   mirror::Object* ret = reinterpret_cast<mirror::Object*>(tlsPtr_.thread_local_pos);
   tlsPtr_.thread_local_pos += bytes;
   return ret;
@@ -67,6 +67,7 @@
 #include "entrypoints/quick/runtime_entrypoints_list.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/heap_bitmap-inl.h"
+#include "gc/allocation_record.h"
 #include "gc/allocator/rosalloc.h"
 #include "gc/heap.h"
 #include "gc/space/space-inl.h"
@@ -1538,9 +1539,10 @@ bool Thread::PassActiveSuspendBarriers() {
       // suspend_count_lock_.
       return false;
     }
-    if (tlsPtr_.active_suspendall_barrier != nullptr) {
+    AtomicInteger* const suspendall_barrier = tlsPtr_.active_suspendall_barrier;
+    if (suspendall_barrier != nullptr) {
       // We have at most one active active_suspendall_barrier. See thread.h comment.
-      pass_barriers.push_back(tlsPtr_.active_suspendall_barrier);
+      pass_barriers.push_back(suspendall_barrier);
       tlsPtr_.active_suspendall_barrier = nullptr;
     }
     for (WrappedSuspend1Barrier* w = tlsPtr_.active_suspend1_barriers; w != nullptr; w = w->next_) {
@@ -1561,6 +1563,9 @@ bool Thread::PassActiveSuspendBarriers() {
       if (old_val != 1) {
         // We're done with it.
         barrier = nullptr;
+      } else if (barrier == suspendall_barrier) {
+        // We are the last thread to acknowledge the SuspendAll; record it for its diagnostics.
+        Runtime::Current()->GetThreadList()->last_suspend_all_arrival_ = this;
       }
     }
   }
@@ -2149,6 +2154,13 @@ void Thread::DumpState(std::ostream& os, const Thread* thread, pid_t tid) {
     os << "  | stack=" << reinterpret_cast<void*>(thread->GetStackBegin<kNativeStackType>())
         << "-" << reinterpret_cast<void*>(thread->GetStackEnd<kNativeStackType>())
         << " stackSize=" << PrettySize(thread->GetStackSize<kNativeStackType>()) << "\n";
+    if (kIsDebugBuild) {
+      // Cumulative interpreter cache statistics, see `InterpreterCache`.
+      InterpreterCache* cache = const_cast<Thread*>(thread)->GetInterpreterCache();
+      os << "  | interpreter cache=" << InterpreterCache::kSize
+          << " hits=" << cache->GetHitCount()
+          << " fills=" << cache->GetFillCount() << "\n";
+    }
     // Dump the held mutexes.
     os << "  | held mutexes=";
     for (size_t i = 0; i < kLockLevelCount; ++i) {
@@ -2685,6 +2697,11 @@ void Thread::Destroy(bool should_run_callbacks) {
   {
     ScopedObjectAccess soa(self);
     Runtime::Current()->GetHeap()->RevokeThreadLocalBuffers(this);
+    Runtime::Current()->GetHeap()->FlushNativeRegistrations(this);
+
+    if (UNLIKELY(alloc_record_buffer_ != nullptr)) {
+      gc::AllocRecordObjectMap::FlushThreadLocalBuffer(self, self);
+    }
 
     if (UNLIKELY(self->GetMethodTraceBuffer() != nullptr)) {
       Trace::FlushThreadBuffer(self);
@@ -2703,8 +2720,9 @@ Thread::~Thread() {
   CHECK(tlsPtr_.opeer == nullptr);
   bool initialized = (tlsPtr_.jni_env != nullptr);  // Did Thread::Init run?
   if (initialized) {
-    delete tlsPtr_.jni_env;
+    JNIEnvExt* jni_env = tlsPtr_.jni_env;
     tlsPtr_.jni_env = nullptr;
+    jni_env->GetVm()->CacheJniEnv(jni_env);
   }
   CHECK_NE(GetState(), ThreadState::kRunnable);
   CHECK(!ReadFlag(ThreadFlag::kCheckpointRequest));
@@ -2734,6 +2752,7 @@ Thread::~Thread() {
   delete tlsPtr_.deps_or_stack_trace_sample.stack_trace_sample;
 
   CHECK_EQ(tlsPtr_.method_trace_buffer, nullptr);
+  delete alloc_record_buffer_;
 
   Runtime::Current()->GetHeap()->AssertThreadLocalBuffersAreRevoked(this);
 
@@ -2947,16 +2966,14 @@ void Thread::SetClassLoaderOverride(jobject class_loader_override) {
 
 using ArtMethodDexPcPair = std::pair<ArtMethod*, uint32_t>;
 
-// Counts the stack trace depth and also fetches the first max_saved_frames frames.
+// Counts the stack trace depth and also fetches the frames if `saved_frames` is not null.
 class FetchStackTraceVisitor : public StackVisitor {
  public:
   explicit FetchStackTraceVisitor(Thread* thread,
-                                  ArtMethodDexPcPair* saved_frames = nullptr,
-                                  size_t max_saved_frames = 0)
+                                  std::vector<ArtMethodDexPcPair>* saved_frames = nullptr)
       REQUIRES_SHARED(Locks::mutator_lock_)
       : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kIncludeInlinedFrames),
-        saved_frames_(saved_frames),
-        max_saved_frames_(max_saved_frames) {}
+        saved_frames_(saved_frames) {}
 
   bool VisitFrame() override REQUIRES_SHARED(Locks::mutator_lock_) {
     // We want to skip frames up to and including the exception's constructor.
@@ -2969,9 +2986,8 @@ class FetchStackTraceVisitor : public StackVisitor {
     }
     if (!skipping_) {
       if (!m->IsRuntimeMethod()) {  // Ignore runtime frames (in particular callee save).
-        if (depth_ < max_saved_frames_) {
-          saved_frames_[depth_].first = m;
-          saved_frames_[depth_].second = m->IsProxyMethod() ? dex::kDexNoIndex : GetDexPc();
+        if (saved_frames_ != nullptr) {
+          saved_frames_->emplace_back(m, m->IsProxyMethod() ? dex::kDexNoIndex : GetDexPc());
         }
         ++depth_;
       }
@@ -2993,8 +3009,7 @@ class FetchStackTraceVisitor : public StackVisitor {
   uint32_t depth_ = 0;
   uint32_t skip_depth_ = 0;
   bool skipping_ = true;
-  ArtMethodDexPcPair* saved_frames_;
-  const size_t max_saved_frames_;
+  std::vector<ArtMethodDexPcPair>* const saved_frames_;
 
   DISALLOW_COPY_AND_ASSIGN(FetchStackTraceVisitor);
 };
@@ -3115,31 +3130,39 @@ class BuildInternalStackTraceVisitor : public StackVisitor {
 
 ObjPtr<mirror::ObjectArray<mirror::Object>> Thread::CreateInternalStackTrace(
     const ScopedObjectAccessAlreadyRunnable& soa) const {
-  // Compute depth of stack, save frames if possible to avoid needing to recompute many.
-  constexpr size_t kMaxSavedFrames = 256;
-  std::unique_ptr<ArtMethodDexPcPair[]> saved_frames(new ArtMethodDexPcPair[kMaxSavedFrames]);
-  FetchStackTraceVisitor count_visitor(const_cast<Thread*>(this),
-                                       &saved_frames[0],
-                                       kMaxSavedFrames);
+  // Compute depth of stack and save all the frames, so that the stack is walked only once.
+  // The frames are saved in a buffer reused by the calling thread across exceptions. Take
+  // it from the thread while in use: allocating the trace may throw an OOME, which creates
+  // its own stack trace.
+  Thread* self = soa.Self();
+  std::vector<ArtMethodDexPcPair> saved_frames = std::move(self->stack_trace_frames_);
+  DCHECK(saved_frames.empty());
+  FetchStackTraceVisitor count_visitor(const_cast<Thread*>(this), &saved_frames);
   count_visitor.WalkStack();
   const uint32_t depth = count_visitor.GetDepth();
   const uint32_t skip_depth = count_visitor.GetSkipDepth();
+  DCHECK_EQ(depth, saved_frames.size());
+  auto release_saved_frames = [&]() {
+    // Keep the buffer for the next exception unless it grew for an unusually deep stack.
+    constexpr size_t kMaxRetainedFrames = 1024;
+    if (saved_frames.capacity() <= kMaxRetainedFrames) {
+      saved_frames.clear();
+      self->stack_trace_frames_ = std::move(saved_frames);
+    }
+  };
 
   // Build internal stack trace.
   BuildInternalStackTraceVisitor build_trace_visitor(
       soa.Self(), const_cast<Thread*>(this), skip_depth);
   if (!build_trace_visitor.Init(depth)) {
+    release_saved_frames();
     return nullptr;  // Allocation failed.
   }
-  // If we saved all of the frames we don't even need to do the actual stack walk. This is faster
-  // than doing the stack walk twice.
-  if (depth < kMaxSavedFrames) {
-    for (size_t i = 0; i < depth; ++i) {
-      build_trace_visitor.AddFrame(saved_frames[i].first, saved_frames[i].second);
-    }
-  } else {
-    build_trace_visitor.WalkStack();
+  // We saved all of the frames, so we don't need to do the actual stack walk again.
+  for (const ArtMethodDexPcPair& frame : saved_frames) {
+    build_trace_visitor.AddFrame(frame.first, frame.second);
   }
+  release_saved_frames();
 
   mirror::ObjectArray<mirror::Object>* trace = build_trace_visitor.GetInternalStackTrace();
   if (kIsDebugBuild) {
@@ -4513,6 +4536,9 @@ void Thread::VisitRoots(RootVisitor* visitor) {
   tlsPtr_.jni_env->VisitJniLocalRoots(visitor, RootInfo(kRootJNILocal, thread_id));
   tlsPtr_.jni_env->VisitMonitorRoots(visitor, RootInfo(kRootJNIMonitor, thread_id));
   HandleScopeVisitRoots(visitor, thread_id);
+  if (alloc_record_buffer_ != nullptr) {
+    alloc_record_buffer_->VisitRoots(visitor, thread_id);
+  }
   // Visit roots for deoptimization.
   if (tlsPtr_.stacked_shadow_frame_record != nullptr) {
     RootCallbackVisitor visitor_to_callback(visitor, thread_id);
@@ -4624,8 +4650,15 @@ static void SweepCacheEntry(IsMarkedVisitor* visitor, const Instruction* inst, s
 
 void Thread::SweepInterpreterCache(IsMarkedVisitor* visitor) {
   for (InterpreterCache::Entry& entry : GetInterpreterCache()->GetArray()) {
+    if ((reinterpret_cast<uintptr_t>(entry.first) & 1u) != 0u) {
+      // IMT conflict entries, keyed by a tagged runtime method, hold no references.
+      continue;
+    }
     SweepCacheEntry(visitor, reinterpret_cast<const Instruction*>(entry.first), &entry.second);
   }
+  // The interface check cache is keyed by class addresses, which may change after this point.
+  GetInterfaceCheckCache()->Clear();
+  GetCatchBlockCache()->Clear();
 }
 
 // FIXME: clang-r433403 reports the below function exceeds frame size limit.
@@ -4860,6 +4893,8 @@ void Thread::ClearAllInterpreterCaches() {
   static struct ClearInterpreterCacheClosure : Closure {
     void Run(Thread* thread) override {
       thread->GetInterpreterCache()->Clear(thread);
+      thread->GetInterfaceCheckCache()->Clear();
+      thread->GetCatchBlockCache()->Clear();
     }
   } closure;
   Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
@@ -33,10 +33,12 @@
 #include "base/pointer_size.h"
 #include "base/safe_map.h"
 #include "base/value_object.h"
+#include "catch_block_cache.h"
 #include "entrypoints/jni/jni_entrypoints.h"
 #include "entrypoints/quick/quick_entrypoints.h"
 #include "handle.h"
 #include "handle_scope.h"
+#include "interface_check_cache.h"
 #include "interpreter/interpreter_cache.h"
 #include "interpreter/shadow_frame.h"
 #include "javaheapprof/javaheapsampler.h"
@@ -57,6 +59,7 @@ class AndroidLocalUnwinder;
 namespace art HIDDEN {
 
 namespace gc {
+class AllocRecordThreadLocalBuffer;
 namespace accounting {
 template<class T> class AtomicStack;
 }  // namespace accounting
@@ -268,6 +271,10 @@ class ThreadExitFlag {
 // This should match RosAlloc::kNumThreadLocalSizeBrackets.
 static constexpr size_t kNumRosAllocThreadLocalSizeBracketsInThread = 16;
 
+// This should match RosAlloc::kNumMagazineSizeBrackets and RosAlloc::kMagazineCapacity.
+static constexpr size_t kNumRosAllocMagazineSizeBracketsInThread = 8;
+static constexpr size_t kRosAllocMagazineCapacityInThread = 8;
+
 static constexpr size_t kSharedMethodHotnessThreshold = 0x1fff;
 
 // Thread's stack layout for implicit stack overflow checks:
@@ -1492,8 +1499,25 @@ class EXPORT Thread {
   // to adjust to post-compact addresses.
   void AdjustTlab(size_t slide_bytes);
 
-  // Doesn't check that there is room.
-  mirror::Object* AllocTlab(size_t bytes);
+  // State for adaptive TLAB sizing. See gc::Heap::AdaptiveTlabSize().
+  int8_t GetTlabSizeShift() const {
+    return tlab_size_shift_;
+  }
+
+  void SetTlabSizeShift(int8_t shift) {
+    tlab_size_shift_ = shift;
+  }
+
+  uint64_t GetLastTlabRefillTimeNs() const {
+    return last_tlab_refill_time_ns_;
+  }
+
+  void SetLastTlabRefillTimeNs(uint64_t time_ns) {
+    last_tlab_refill_time_ns_ = time_ns;
+  }
+
+  // Doesn't check that there is room. The `bytes` may hold `num_objects` objects back to back.
+  mirror::Object* AllocTlab(size_t bytes, size_t num_objects = 1u);
   void SetTlab(uint8_t* start, uint8_t* end, uint8_t* limit);
   bool HasTlab() const;
   void ResetTlab();
@@ -1548,6 +1572,48 @@ class EXPORT Thread {
     tlsPtr_.rosalloc_runs[index] = run;
   }
 
+  // Slots cached for the RosAlloc size brackets right above the thread-local run brackets. See
+  // gc::allocator::RosAlloc::AllocFromMagazine().
+  void** GetRosAllocMagazine(size_t index) {
+    return rosalloc_magazine_slots_[index];
+  }
+
+  size_t GetRosAllocMagazineSize(size_t index) const {
+    return rosalloc_magazine_sizes_[index];
+  }
+
+  void SetRosAllocMagazineSize(size_t index, size_t size) {
+    DCHECK_LE(size, kRosAllocMagazineCapacityInThread);
+    rosalloc_magazine_sizes_[index] = static_cast<uint8_t>(size);
+  }
+
+  // Sampled allocation records which are not yet in the heap's gc::AllocRecordObjectMap.
+  gc::AllocRecordThreadLocalBuffer* GetAllocRecordBuffer() const {
+    return alloc_record_buffer_;
+  }
+
+  void SetAllocRecordBuffer(gc::AllocRecordThreadLocalBuffer* buffer) {
+    alloc_record_buffer_ = buffer;
+  }
+
+  // Native registrations not yet added to the heap's counters, see
+  // gc::Heap::RegisterNativeAllocation().
+  ssize_t GetPendingNativeBytes() const {
+    return pending_native_bytes_;
+  }
+
+  void SetPendingNativeBytes(ssize_t bytes) {
+    pending_native_bytes_ = bytes;
+  }
+
+  uint32_t GetPendingNativeObjects() const {
+    return pending_native_objects_;
+  }
+
+  void SetPendingNativeObjects(uint32_t objects) {
+    pending_native_objects_ = objects;
+  }
+
   template <StackType stack_type>
   bool ProtectStack(bool fatal_on_error = true);
   template <StackType stack_type>
@@ -1638,6 +1704,14 @@ class EXPORT Thread {
     return &interpreter_cache_;
   }
 
+  ALWAYS_INLINE InterfaceCheckCache* GetInterfaceCheckCache() {
+    return &interface_check_cache_;
+  }
+
+  ALWAYS_INLINE CatchBlockCache* GetCatchBlockCache() {
+    return &catch_block_cache_;
+  }
+
   // Clear all thread-local interpreter caches.
   //
   // Since the caches are keyed by memory pointer to dex instructions, this must be
@@ -2451,6 +2525,35 @@ class EXPORT Thread {
   // Note that it is not in the packed struct, may not be accessed for cross compilation.
   uintptr_t poison_object_cookie_ = 0;
 
+  // Log2 of the factor by which this thread's TLAB refills are scaled relative
+  // to the heap's default TLAB size. Adjusted based on the refill frequency.
+  int8_t tlab_size_shift_ = 0;
+  // Time of the last TLAB refill, used to estimate the allocation rate.
+  uint64_t last_tlab_refill_time_ns_ = 0;
+
+  // RosAlloc slots pre-allocated for this thread, and the number of valid entries per bracket.
+  void* rosalloc_magazine_slots_[kNumRosAllocMagazineSizeBracketsInThread]
+                                [kRosAllocMagazineCapacityInThread] = {};
+  uint8_t rosalloc_magazine_sizes_[kNumRosAllocMagazineSizeBracketsInThread] = {};
+
+  // Owned allocation sampler state and pending records, created when allocation tracking samples.
+  gc::AllocRecordThreadLocalBuffer* alloc_record_buffer_ = nullptr;
+
+  // Small thread-local cache of interface checks against classes with many interfaces.
+  InterfaceCheckCache interface_check_cache_;
+
+  // Small thread-local cache of catch handler lookups.
+  CatchBlockCache catch_block_cache_;
+
+  // Frames collected by `CreateInternalStackTrace()`, kept to avoid reallocating the buffer
+  // for every exception created by this thread.
+  std::vector<std::pair<ArtMethod*, uint32_t>> stack_trace_frames_;
+
+  // Net native bytes registered minus freed, and number of native registrations, by this thread
+  // since they were last added to the heap's counters.
+  ssize_t pending_native_bytes_ = 0;
+  uint32_t pending_native_objects_ = 0;
+
   // Pending extra checkpoints if checkpoint_function_ is already used.
   std::list<Closure*> checkpoint_overflow_ GUARDED_BY(Locks::thread_suspend_count_lock_);
 
@@ -50,6 +50,7 @@
 #include "obj_ptr-inl.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread.h"
+#include "thread_pool.h"
 #include "trace.h"
 #include "unwindstack/AndroidUnwinder.h"
 #include "well_known_classes.h"
@@ -73,6 +74,9 @@ ThreadList::ThreadList(uint64_t thread_suspend_timeout_ns)
     : suspend_all_count_(0),
       unregistering_count_(0),
       suspend_all_histogram_("suspend all histogram", 16, 64),
+      slowest_suspend_all_ns_(0),
+      last_suspend_all_arrival_(nullptr),
+      suspend_all_holdouts_(0),
       long_suspend_(false),
       shut_down_(false),
       thread_suspend_timeout_ns_(thread_suspend_timeout_ns),
@@ -138,6 +142,9 @@ void ThreadList::DumpForSigQuit(std::ostream& os) {
       suspend_all_histogram_.CreateHistogram(&data);
       suspend_all_histogram_.PrintConfidenceIntervals(os, 0.99, data);  // Dump time to suspend.
     }
+    if (!slowest_suspend_all_.empty()) {
+      os << "Slowest suspend all: " << slowest_suspend_all_ << "\n";
+    }
   }
   bool dump_native_stack = Runtime::Current()->GetDumpNativeStackOnSigQuit();
   Dump(os, dump_native_stack);
@@ -300,11 +307,43 @@ NO_RETURN static void UnsafeLogFatalForThreadSuspendAllTimeout() {
 }
 #endif
 
+// Minimum number of suspended threads for which we run checkpoints on a thread pool, below which
+// the cost of waking up the workers is not worth it.
+static constexpr size_t kMinParallelCheckpointThreads = 8;
+
+// Runs a checkpoint for suspended threads, taking them from a shared list until it is exhausted.
+class ParallelCheckpointTask final : public Task {
+ public:
+  ParallelCheckpointTask(Closure* checkpoint_function,
+                         const std::vector<Thread*>* threads,
+                         std::atomic<size_t>* next_index)
+      : checkpoint_function_(checkpoint_function), threads_(threads), next_index_(next_index) {}
+
+  // The caller of RunCheckpoint holds the mutator lock on our behalf, if needed.
+  void Run([[maybe_unused]] Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    for (size_t i = next_index_->fetch_add(1, std::memory_order_relaxed); i < threads_->size();
+         i = next_index_->fetch_add(1, std::memory_order_relaxed)) {
+      checkpoint_function_->Run((*threads_)[i]);
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  Closure* const checkpoint_function_;
+  const std::vector<Thread*>* const threads_;
+  std::atomic<size_t>* const next_index_;
+};
+
 size_t ThreadList::RunCheckpoint(Closure* checkpoint_function,
                                  Closure* callback,
                                  bool allow_lock_checking,
-                                 bool acquire_mutator_lock) {
+                                 bool acquire_mutator_lock,
+                                 ThreadPool* thread_pool) {
   Thread* self = Thread::Current();
+  DCHECK(thread_pool == nullptr || !acquire_mutator_lock);
   Locks::mutator_lock_->AssertNotExclusiveHeld(self);
   Locks::thread_list_lock_->AssertNotHeld(self);
   Locks::thread_suspend_count_lock_->AssertNotHeld(self);
@@ -363,6 +402,17 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function,
   }
 
   size_t nthreads = remaining_threads.size();
+  // Suspended threads whose checkpoints are run on the thread pool once all are collected.
+  std::vector<Thread*> batched_threads;
+  std::vector<Thread*> pool_threads;
+  if (thread_pool != nullptr && nthreads >= kMinParallelCheckpointThreads) {
+    batched_threads.reserve(nthreads);
+    for (ThreadPoolWorker* worker : thread_pool->GetWorkers()) {
+      pool_threads.push_back(worker->GetThread());
+    }
+  } else {
+    thread_pool = nullptr;
+  }
   size_t starting_thread = 0;
   size_t next_starting_thread;  // First possible remaining non-null entry in remaining_threads.
   // Run the checkpoint for the suspended threads.
@@ -412,6 +462,17 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function,
           }
         }  // O.w. the checkpoint will not access Java data structures, and doesn't care whether
            // the flip function has been called.
+        if (thread_pool != nullptr &&
+            std::find(pool_threads.begin(), pool_threads.end(), thread) == pool_threads.end()) {
+          // Keep the thread suspended, its checkpoint runs on the thread pool below. The pool
+          // workers themselves are handled here, so that none of them visits its own thread.
+          batched_threads.push_back(thread);
+          Locks::thread_list_lock_->Lock(self);
+          Locks::thread_suspend_count_lock_->Lock(self);
+          thread->UnregisterThreadExitFlag(&tefs[i]);
+          remaining_threads[i] = nullptr;
+          continue;
+        }
         checkpoint_function->Run(thread);
         if (acquire_mutator_lock) {
           {
@@ -448,6 +509,30 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function,
     starting_thread = next_starting_thread;
   } while (starting_thread != nthreads);
 
+  if (!batched_threads.empty()) {
+    Locks::thread_suspend_count_lock_->Unlock(self);
+    Locks::thread_list_lock_->Unlock(self);
+    {
+      ScopedTrace trace("Run checkpoints in parallel");
+      std::atomic<size_t> next_index(0);
+      // One task per worker, plus one for us. Each task runs until the list is exhausted.
+      size_t num_tasks = std::min(thread_pool->GetThreadCount() + 1, batched_threads.size());
+      for (size_t i = 0; i < num_tasks; ++i) {
+        thread_pool->AddTask(
+            self, new ParallelCheckpointTask(checkpoint_function, &batched_threads, &next_index));
+      }
+      thread_pool->StartWorkers(self);
+      thread_pool->Wait(self, /*do_work=*/true, /*may_hold_locks=*/true);
+      thread_pool->StopWorkers(self);
+    }
+    Locks::thread_list_lock_->Lock(self);
+    Locks::thread_suspend_count_lock_->Lock(self);
+    for (Thread* thread : batched_threads) {
+      thread->DecrementSuspendCount(self);
+    }
+    Thread::resume_cond_->Broadcast(self);
+  }
+
   // Finally run the checkpoint on ourself. We will already have run the flip function, if we're
   // runnable.
   Locks::thread_list_lock_->Unlock(self);
@@ -829,6 +914,27 @@ std::optional<std::string> ThreadList::WaitForSuspendBarrier(AtomicInteger* barr
                          "";
 }
 
+std::string ThreadList::DescribeSuspendAll(Thread* self,
+                                           uint64_t suspend_time,
+                                           uint64_t barrier_time,
+                                           uint64_t mutator_lock_time) {
+  std::ostringstream oss;
+  oss << PrettyDuration(suspend_time) << " (waiting for threads: " << PrettyDuration(barrier_time)
+      << ", acquiring mutator lock: " << PrettyDuration(mutator_lock_time) << ")";
+  MutexLock mu(self, *Locks::thread_suspend_count_lock_);
+  oss << ", " << suspend_all_holdouts_ << " threads not yet suspended at request";
+  Thread* last = last_suspend_all_arrival_;
+  if (last != nullptr) {
+    // The thread has passed the barrier and cannot resume or exit until ResumeAll, so its name
+    // and state are stable.
+    std::string name;
+    last->GetThreadName(name);
+    oss << ", last to suspend: \"" << name << "\" tid=" << last->GetTid()
+        << " state=" << last->GetState();
+  }
+  return oss.str();
+}
+
 void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
   Thread* self = Thread::Current();
 
@@ -842,6 +948,7 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
     const uint64_t start_time = NanoTime();
 
     SuspendAllInternal(self);
+    const uint64_t barrier_time = NanoTime();
     // All threads are known to have suspended (but a thread may still own the mutator lock)
     // Make sure this thread grabs exclusive access to the mutator lock and its protected data.
 #if HAVE_TIMED_RWLOCK
@@ -867,7 +974,15 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
     const uint64_t suspend_time = end_time - start_time;
     suspend_all_histogram_.AdjustAndAddValue(suspend_time);
     if (suspend_time > kLongThreadSuspendThreshold) {
-      LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(suspend_time);
+      std::string breakdown = DescribeSuspendAll(self,
+                                                 suspend_time,
+                                                 barrier_time - start_time,
+                                                 end_time - barrier_time);
+      LOG(WARNING) << "Suspending all threads took: " << breakdown;
+      if (suspend_time > slowest_suspend_all_ns_) {
+        slowest_suspend_all_ns_ = suspend_time;
+        slowest_suspend_all_ = std::move(breakdown);
+      }
     }
 
     if (kDebugLocking) {
@@ -921,7 +1036,13 @@ void ThreadList::SuspendAllInternal(Thread* self, SuspendReason reason) {
         bool found_myself = false;
         // Update global suspend all state for attaching threads.
         ++suspend_all_count_;
-        pending_threads.store(list_.size() - (self == nullptr ? 0 : 1), std::memory_order_relaxed);
+        const int32_t num_others = static_cast<int32_t>(list_.size()) - (self == nullptr ? 0 : 1);
+        pending_threads.store(num_others, std::memory_order_relaxed);
+        last_suspend_all_arrival_ = nullptr;
+        // Barrier decrements on behalf of already suspended threads are batched into a single
+        // atomic update below, so that the common case of many idle threads (binder pools, thread
+        // pool workers) does not pay for one contended read-modify-write per thread.
+        int32_t num_already_suspended = 0;
         // Increment everybody else's suspend count.
         for (const auto& thread : list_) {
           if (thread == self) {
@@ -936,7 +1057,7 @@ void ThreadList::SuspendAllInternal(Thread* self, SuspendReason reason) {
               // suspend_count_lock_, and it will notice that kActiveSuspendBarrier has already
               // been cleared if and when it acquires the lock in PassActiveSuspendBarriers().
               DCHECK_EQ(thread->tlsPtr_.active_suspendall_barrier, &pending_threads);
-              pending_threads.fetch_sub(1, std::memory_order_seq_cst);
+              ++num_already_suspended;
               thread->tlsPtr_.active_suspendall_barrier = nullptr;
               if (!thread->HasActiveSuspendBarrier()) {
                 thread->AtomicClearFlag(ThreadFlag::kActiveSuspendBarrier);
@@ -952,6 +1073,13 @@ void ThreadList::SuspendAllInternal(Thread* self, SuspendReason reason) {
             // are thus properly ordered, even for relaxed accesses.
           }
         }
+        // The barrier may be reached here. Only we wait on it, so no futex wake is required.
+        // Running threads decrementing it concurrently cannot see it drop to zero early, since
+        // it still counts all the already suspended threads until this point.
+        if (num_already_suspended != 0) {
+          pending_threads.fetch_sub(num_already_suspended, std::memory_order_seq_cst);
+        }
+        suspend_all_holdouts_ = static_cast<size_t>(num_others - num_already_suspended);
         self->AtomicSetFlag(ThreadFlag::kSuspensionImmune, std::memory_order_relaxed);
         DCHECK(self == nullptr || found_myself);
         break;
@@ -19,6 +19,7 @@
 
 #include <bitset>
 #include <list>
+#include <string>
 #include <vector>
 
 #include "barrier.h"
@@ -42,6 +43,7 @@ class Closure;
 class IsMarkedVisitor;
 class RootVisitor;
 class Thread;
+class ThreadPool;
 class TimingLogger;
 enum VisitRootFlags : uint8_t;
 
@@ -138,11 +140,19 @@ class ThreadList {
   // threads must act on that. It is possible that on return there will be threads which have not,
   // and will not, run the checkpoint_function, and neither have/will any of their ancestors.
   //
+  // If thread_pool is not null, the checkpoints of suspended threads are run in parallel on its
+  // workers and the calling thread, instead of serially on the calling thread. The caller must
+  // own the pool, and the checkpoint function must then be safe to run concurrently from any
+  // thread, as it already is for checkpoints run by runnable threads themselves. The suspended
+  // threads stay suspended until all their checkpoints are done. Not supported together with
+  // acquire_mutator_lock.
+  //
   // TODO: Is it possible to simplify mutator_lock handling here? Should this wait for completion?
   EXPORT size_t RunCheckpoint(Closure* checkpoint_function,
                               Closure* callback = nullptr,
                               bool allow_lock_checking = true,
-                              bool acquire_mutator_lock = false)
+                              bool acquire_mutator_lock = false,
+                              ThreadPool* thread_pool = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
   // Convenience version of the above to disable lock checking inside Run function. Hopefully this
@@ -273,6 +283,14 @@ class ThreadList {
                      int attempt_of_4) RELEASE(Locks::thread_list_lock_)
       RELEASE_SHARED(Locks::mutator_lock_);
 
+  // Describes the time-to-safepoint breakdown of a slow SuspendAll, including the slowest thread
+  // to acknowledge the request.
+  std::string DescribeSuspendAll(Thread* self,
+                                 uint64_t suspend_time,
+                                 uint64_t barrier_time,
+                                 uint64_t mutator_lock_time)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_suspend_count_lock_);
+
   void SuspendAllInternal(Thread* self, SuspendReason reason = SuspendReason::kInternal)
       REQUIRES(!Locks::thread_list_lock_,
                !Locks::thread_suspend_count_lock_,
@@ -299,6 +317,21 @@ class ThreadList {
   // by mutator lock ensures no thread can read when another thread is modifying it.
   Histogram<uint64_t> suspend_all_histogram_ GUARDED_BY(Locks::mutator_lock_);
 
+  // Time-to-safepoint breakdown of the slowest SuspendAll so far, reported on SIGQUIT. Empty until
+  // a SuspendAll takes longer than kLongThreadSuspendThreshold.
+  uint64_t slowest_suspend_all_ns_ GUARDED_BY(Locks::mutator_lock_);
+  std::string slowest_suspend_all_ GUARDED_BY(Locks::mutator_lock_);
+
+  // The thread whose suspension passed the barrier of the ongoing or last SuspendAll, i.e. the
+  // slowest thread to reach a suspended state, or null if all threads were already suspended when
+  // the request was made. Threads cannot be deleted while suspended, so this is valid until the
+  // matching ResumeAll.
+  Thread* last_suspend_all_arrival_ GUARDED_BY(Locks::thread_suspend_count_lock_);
+
+  // Number of threads that were not suspended yet when the ongoing or last SuspendAll request was
+  // made, and thus had to acknowledge it themselves.
+  size_t suspend_all_holdouts_ GUARDED_BY(Locks::thread_suspend_count_lock_);
+
   // Whether or not the current thread suspension is long.
   bool long_suspend_;
 
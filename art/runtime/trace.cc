@@ -22,6 +22,7 @@
 #include "android-base/macros.h"
 #include "android-base/stringprintf.h"
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/casts.h"
 #include "base/leb128.h"
 #include "base/os.h"
@@ -96,7 +97,6 @@ static constexpr const char* kTracerInstrumentationKey = "Tracer";
 
 Trace* Trace::the_trace_ = nullptr;
 pthread_t Trace::sampling_pthread_ = 0U;
-std::unique_ptr<std::vector<ArtMethod*>> Trace::temp_stack_trace_;
 
 
 static TraceAction DecodeTraceAction(uint32_t tmid) {
@@ -353,16 +353,6 @@ class MethodInfoWriterTask final : public TraceWriterTask {
   }
 };
 
-std::vector<ArtMethod*>* Trace::AllocStackTrace() {
-  return (temp_stack_trace_.get() != nullptr)  ? temp_stack_trace_.release() :
-      new std::vector<ArtMethod*>();
-}
-
-void Trace::FreeStackTrace(std::vector<ArtMethod*>* stack_trace) {
-  stack_trace->clear();
-  temp_stack_trace_.reset(stack_trace);
-}
-
 static uint16_t GetTraceVersion(TraceClockSource clock_source, int version) {
   if (version == Trace::kFormatV1) {
     return (clock_source == TraceClockSource::kDual) ? kTraceVersionDualClock :
@@ -437,23 +427,36 @@ uint32_t Trace::GetClockOverheadNanoSeconds() {
   return static_cast<uint32_t>(elapsed_us / 32);
 }
 
-static void GetSample(Thread* thread, void* arg) REQUIRES_SHARED(Locks::mutator_lock_) {
-  std::vector<ArtMethod*>* const stack_trace = Trace::AllocStackTrace();
-  StackVisitor::WalkStack(
-      [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
-        ArtMethod* m = stack_visitor->GetMethod();
-        // Ignore runtime frames (in particular callee save).
-        if (!m->IsRuntimeMethod()) {
-          stack_trace->push_back(m);
-        }
-        return true;
-      },
-      thread,
-      /* context= */ nullptr,
-      art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
-  Trace* the_trace = reinterpret_cast<Trace*>(arg);
-  the_trace->CompareAndUpdateStackTrace(thread, stack_trace);
-}
+// Samples the stack of a thread. This runs as a checkpoint, so each runnable thread walks its own
+// stack at its next suspend point while the other threads keep running, and the stacks of
+// suspended threads are walked by the sampling thread.
+class GetSampleClosure final : public Closure {
+ public:
+  GetSampleClosure(Trace* trace, Barrier* barrier) : trace_(trace), barrier_(barrier) {}
+
+  void Run(Thread* thread) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(thread == Thread::Current() || thread->IsSuspended());
+    std::vector<ArtMethod*>* const stack_trace = new std::vector<ArtMethod*>();
+    StackVisitor::WalkStack(
+        [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+          ArtMethod* m = stack_visitor->GetMethod();
+          // Ignore runtime frames (in particular callee save).
+          if (!m->IsRuntimeMethod()) {
+            stack_trace->push_back(m);
+          }
+          return true;
+        },
+        thread,
+        /* context= */ nullptr,
+        art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+    trace_->CompareAndUpdateStackTrace(thread, stack_trace);
+    barrier_->Pass(Thread::Current());
+  }
+
+ private:
+  Trace* const trace_;
+  Barrier* const barrier_;
+};
 
 static void ClearThreadStackTraceAndClockBase(Thread* thread, [[maybe_unused]] void* arg) {
   thread->SetTraceClockBase(0);
@@ -464,7 +467,7 @@ static void ClearThreadStackTraceAndClockBase(Thread* thread, [[maybe_unused]] v
 
 void Trace::CompareAndUpdateStackTrace(Thread* thread,
                                        std::vector<ArtMethod*>* stack_trace) {
-  CHECK_EQ(pthread_self(), sampling_pthread_);
+  DCHECK(thread == Thread::Current() || thread->IsSuspended());
   std::vector<ArtMethod*>* old_stack_trace = thread->GetStackTraceSample();
   // Update the thread's stack trace sample.
   thread->SetStackTraceSample(stack_trace);
@@ -496,7 +499,7 @@ void Trace::CompareAndUpdateStackTrace(Thread* thread,
     for (; rit != stack_trace->rend(); ++rit) {
       LogMethodTraceEvent(thread, *rit, kTraceMethodEnter, thread_clock_diff, timestamp_counter);
     }
-    FreeStackTrace(old_stack_trace);
+    delete old_stack_trace;
   }
 }
 
@@ -520,15 +523,18 @@ void* Trace::RunSamplingThread(void* arg) {
       }
     }
     {
-      // Avoid a deadlock between a thread doing garbage collection
-      // and the profile sampling thread, by blocking GC when sampling
-      // thread stacks (see b/73624630).
-      gc::ScopedGCCriticalSection gcs(self,
-                                      art::gc::kGcCauseInstrumentation,
-                                      art::gc::kCollectorTypeInstrumentation);
-      ScopedSuspendAll ssa(__FUNCTION__);
-      MutexLock mu(self, *Locks::thread_list_lock_);
-      runtime->GetThreadList()->ForEach(GetSample, the_trace);
+      // Sample the threads with a checkpoint rather than suspending all of them, so that each
+      // thread only pauses for the walk of its own stack.
+      Barrier barrier(0);
+      GetSampleClosure closure(the_trace, &barrier);
+      ScopedObjectAccess soa(self);
+      size_t threads_running_checkpoint = runtime->GetThreadList()->RunCheckpoint(&closure);
+      // Wait for the other threads to run the checkpoint, so that no sample is taken once the
+      // trace is stopped.
+      ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+      if (threads_running_checkpoint != 0) {
+        barrier.Increment(self, threads_running_checkpoint);
+      }
     }
   }
 
@@ -1152,6 +1158,19 @@ std::string TraceWriter::CreateSummary(int flags) {
   os << StringPrintf("elapsed-time-usec=%" PRIu64 "\n", elapsed);
   if (trace_output_mode_ != TraceOutputMode::kStreaming) {
     os << StringPrintf("num-method-calls=%zd\n", num_records_);
+  } else {
+    MutexLock mu(Thread::Current(), buffer_pool_lock_);
+    if (num_dropped_records_ != 0u) {
+      // Entries dropped because the writer could not keep up with the traced threads.
+      os << StringPrintf("num-dropped-method-calls=%zd\n", num_dropped_records_);
+      os << "dropped-method-calls-by-thread=";
+      const char* separator = "";
+      for (const auto& [tid, num_records] : dropped_records_) {
+        os << separator << tid << ":" << num_records;
+        separator = ",";
+      }
+      os << "\n";
+    }
   }
   os << StringPrintf("clock-call-overhead-nsec=%d\n", clock_overhead_ns_);
   os << StringPrintf("vm=art\n");
@@ -1513,16 +1532,30 @@ void TraceWriter::InitializeTraceBuffers() {
   CHECK(trace_buffer_.get() != nullptr);
 }
 
-uintptr_t* TraceWriter::AcquireTraceBuffer(size_t tid) {
-  Thread* self = Thread::Current();
-
-  // Fast path, check if there is a free buffer in the pool
+uintptr_t* TraceWriter::TryAcquireTraceBuffer(size_t tid) {
   for (size_t index = 0; index < owner_tids_.size(); index++) {
     size_t owner = 0;
     if (owner_tids_[index].compare_exchange_strong(owner, tid)) {
       return trace_buffer_.get() + index * kPerThreadBufSize;
     }
   }
+  return nullptr;
+}
+
+void TraceWriter::RecordDroppedEntries(Thread* self, size_t tid, size_t num_records) {
+  MutexLock mu(self, buffer_pool_lock_);
+  dropped_records_.GetOrCreate(tid, []() { return static_cast<size_t>(0u); }) += num_records;
+  num_dropped_records_ += num_records;
+}
+
+uintptr_t* TraceWriter::AcquireTraceBuffer(size_t tid) {
+  Thread* self = Thread::Current();
+
+  // Fast path, check if there is a free buffer in the pool
+  uintptr_t* free_buffer = TryAcquireTraceBuffer(tid);
+  if (free_buffer != nullptr) {
+    return free_buffer;
+  }
 
   // Increment a counter so we know how many threads are potentially suspended in the tracing code.
   // We need this when stopping tracing. We need to wait for all these threads to finish executing
@@ -1653,6 +1686,24 @@ void TraceWriter::FlushBuffer(Thread* thread, bool is_sync, bool release) {
       thread->SetMethodTraceBufferCurrentEntry(kPerThreadBufSize);
     }
   } else {
+    uintptr_t* new_buffer = nullptr;
+    if (!release) {
+      // Never wait for the writer in the traced thread. If all the pool buffers are queued for
+      // writing, the writer cannot keep up, so drop the entries and reuse the buffer rather than
+      // queueing more.
+      new_buffer = TryAcquireTraceBuffer(tid);
+      if (new_buffer == nullptr) {
+        Thread* self = Thread::Current();
+        if (thread_pool_->GetTaskCount(self) >= owner_tids_.size()) {
+          size_t num_records = (kPerThreadBufSize - current_offset) / GetNumEntries(clock_source_);
+          RecordDroppedEntries(self, tid, num_records);
+          thread->SetMethodTraceBufferCurrentEntry(kPerThreadBufSize);
+          return;
+        }
+        // The writer is not behind, there are just more threads than pool buffers.
+        new_buffer = new uintptr_t[kPerThreadBufSize];
+      }
+    }
     int old_index = GetMethodTraceIndex(method_trace_entries);
     // The TraceWriterTask takes the ownership of the buffer and releases the buffer once the
     // entries are flushed.
@@ -1662,7 +1713,7 @@ void TraceWriter::FlushBuffer(Thread* thread, bool is_sync, bool release) {
     if (release) {
       thread->SetMethodTraceBuffer(nullptr, 0);
     } else {
-      thread->SetMethodTraceBuffer(AcquireTraceBuffer(tid), kPerThreadBufSize);
+      thread->SetMethodTraceBuffer(new_buffer, kPerThreadBufSize);
     }
   }
 
@@ -1847,8 +1898,8 @@ void Trace::LogMethodTraceEvent(Thread* thread,
                                 uint32_t thread_clock_diff,
                                 uint64_t timestamp_counter) {
   // This method is called in both tracing modes (method and sampling). In sampling mode, this
-  // method is only called by the sampling thread. In method tracing mode, it can be called
-  // concurrently.
+  // method is called from the sampling checkpoint, either by the thread itself or by the sampling
+  // thread while the thread is suspended. In method tracing mode, it can be called concurrently.
 
   uintptr_t* method_trace_buffer = thread->GetMethodTraceBuffer();
   uintptr_t** current_entry_ptr = thread->GetTraceBufferCurrEntryPtr();
@@ -214,7 +214,8 @@ class TraceWriter {
   // returns a pointer to the new buffer where the entries should be recorded.
   // In streaming mode, we just flush the per-thread buffer. The buffer is flushed asynchronously
   // on a thread pool worker. This creates a new buffer and updates the per-thread buffer pointer
-  // and returns a pointer to the newly created buffer.
+  // and returns a pointer to the newly created buffer. If the writer is behind, the entries are
+  // dropped and counted instead, and the existing buffer is reused, so the thread never waits.
   // In non-streaming mode, buffers from all threads are flushed to see if there's enough room
   // in the centralized buffer before recording new entries. We just flush these buffers
   // synchronously and reuse the existing buffer. Since this mode is mostly deprecated we want to
@@ -279,6 +280,9 @@ class TraceWriter {
   uintptr_t* AcquireTraceBuffer(size_t tid) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!trace_writer_lock_);
 
+  // Returns a free buffer from the pool, or null if there is none. This never waits.
+  uintptr_t* TryAcquireTraceBuffer(size_t tid);
+
   // Returns the index corresponding to the start of the current_buffer. We allocate one large
   // buffer and assign parts of it for each thread.
   int GetMethodTraceIndex(uintptr_t* current_buffer);
@@ -360,6 +364,11 @@ class TraceWriter {
                    size_t buffer_size,
                    size_t required_size);
 
+  // Counts the `num_records` entries of the thread `tid` dropped in streaming mode when the writer
+  // is behind.
+  void RecordDroppedEntries(Thread* self, size_t tid, size_t num_records)
+      REQUIRES(!buffer_pool_lock_);
+
   // Flush tracing buffers from all the threads.
   void FlushAllThreadBuffers() REQUIRES(!Locks::thread_list_lock_) REQUIRES(!trace_writer_lock_);
 
@@ -429,6 +438,11 @@ class TraceWriter {
   std::atomic<size_t> num_waiters_for_buffer_;
   std::atomic<bool> finish_tracing_ = false;
 
+  // Number of entries dropped per thread and in total in streaming mode, when all the pool buffers
+  // were waiting to be written. Reported in the summary.
+  SafeMap<size_t, size_t> dropped_records_ GUARDED_BY(buffer_pool_lock_);
+  size_t num_dropped_records_ GUARDED_BY(buffer_pool_lock_) = 0u;
+
   // Lock to protect common data structures accessed from multiple threads like
   // art_method_id_map_, thread_id_map_.
   Mutex trace_writer_lock_;
@@ -566,11 +580,6 @@ class Trace final : public instrumentation::InstrumentationListener, public Clas
 
   TraceClockSource GetClockSource() { return clock_source_; }
 
-  // Reuse an old stack trace if it exists, otherwise allocate a new one.
-  static std::vector<ArtMethod*>* AllocStackTrace();
-  // Clear and store an old stack trace for later use.
-  static void FreeStackTrace(std::vector<ArtMethod*>* stack_trace);
-
   static TraceOutputMode GetOutputMode() REQUIRES(!Locks::trace_lock_);
   static TraceMode GetMode() REQUIRES(!Locks::trace_lock_);
   static size_t GetBufferSize() REQUIRES(!Locks::trace_lock_);
@@ -623,9 +632,6 @@ class Trace final : public instrumentation::InstrumentationListener, public Clas
   // Sampling thread, non-zero when sampling.
   static pthread_t sampling_pthread_;
 
-  // Used to remember an unused stack trace to avoid re-allocation during sampling.
-  static std::unique_ptr<std::vector<ArtMethod*>> temp_stack_trace_;
-
   // Flags enabling extra tracing of things such as alloc counts.
   const int flags_;
 
@@ -128,19 +128,27 @@ void TraceProfiler::Stop() {
 
 uint8_t* TraceProfiler::DumpBuffer(uint32_t thread_id,
                                    uintptr_t* method_trace_entries,
+                                   uintptr_t* current_entry,
                                    uint8_t* buffer,
                                    std::unordered_set<ArtMethod*>& methods) {
   // Encode header at the end once we compute the number of records.
   uint8_t* curr_buffer_ptr = buffer + kAlwaysOnTraceHeaderSize;
 
+  // Entries are recorded at decreasing addresses and wrap around from the start of the buffer to
+  // the end, so the newest entry is at `current_entry`. Dump the entries from the oldest to the
+  // newest, starting below `current_entry`. With a long running profile the buffer has usually
+  // wrapped around and these are the entries recorded just before the dump.
+  size_t current_index = current_entry - method_trace_entries;
+  DCHECK_LE(current_index, kAlwaysOnTraceBufSize);
   int num_records = 0;
   uintptr_t prev_method_action_encoding = 0;
   int prev_action = -1;
-  for (size_t i = kAlwaysOnTraceBufSize - 1; i > 0; i-=1) {
+  for (size_t count = 1; count <= kAlwaysOnTraceBufSize; ++count) {
+    size_t i = (current_index + kAlwaysOnTraceBufSize - count) % kAlwaysOnTraceBufSize;
     uintptr_t method_action_encoding = method_trace_entries[i];
-    // 0 value indicates the rest of the entries are empty.
+    // 0 value indicates an empty entry, below `current_entry` if the buffer has not wrapped.
     if (method_action_encoding == 0) {
-      break;
+      continue;
     }
 
     int action = method_action_encoding & ~kMaskTraceAction;
@@ -246,8 +254,11 @@ void TraceProfiler::Dump(std::unique_ptr<File>&& trace_file) {
       }
       curr_buffer_ptr = buffer_ptr;
     }
-    curr_buffer_ptr =
-        DumpBuffer(thread->GetTid(), method_trace_entries, curr_buffer_ptr, traced_methods);
+    curr_buffer_ptr = DumpBuffer(thread->GetTid(),
+                                 method_trace_entries,
+                                 *thread->GetTraceBufferCurrEntryPtr(),
+                                 curr_buffer_ptr,
+                                 traced_methods);
     // Reset the buffer and continue profiling. We need to set the buffer to
     // zeroes, since we use a circular buffer and detect empty entries by
     // checking for zeroes.
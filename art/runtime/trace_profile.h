@@ -61,13 +61,15 @@ class TraceProfiler {
   // Dumps the events from all threads into the trace_file.
   static void Dump(std::unique_ptr<File>&& trace_file);
 
-  // This method goes over all the events in the thread_buffer and stores the encoded event in the
-  // buffer. It returns the pointer to the next free entry in the buffer.
+  // This method goes over all the events in the thread_buffer, from the oldest to the newest one
+  // at current_entry, and stores the encoded event in the buffer. It returns the pointer to the
+  // next free entry in the buffer.
   // This also records the ArtMethods from the events in the thread_buffer in a set. This set is
   // used to dump the information about the methods once buffers from all threads have been
   // processed.
   static uint8_t* DumpBuffer(uint32_t thread_id,
                              uintptr_t* thread_buffer,
+                             uintptr_t* current_entry,
                              uint8_t* buffer /* out */,
                              std::unordered_set<ArtMethod*>& methods /* out */);
 
@@ -16,6 +16,7 @@
 
 #include "method_verifier-inl.h"
 
+#include <atomic>
 #include <ostream>
 
 #include "android-base/stringprintf.h"
@@ -73,6 +74,11 @@ using android::base::StringPrintf;
 
 static constexpr bool kTimeVerifyMethod = !kIsDebugBuild;
 
+// Number of methods verified in a single straight-line pass and with the full code flow
+// verification, see `MethodVerifier::GetVerificationPathCounts()`.
+static std::atomic<uint32_t> gStraightLineMethodCount(0u);
+static std::atomic<uint32_t> gCodeFlowMethodCount(0u);
+
 PcToRegisterLineTable::PcToRegisterLineTable(ArenaAllocator& allocator)
     : register_lines_(allocator.Adapter(kArenaAllocVerifier)) {}
 
@@ -159,6 +165,7 @@ class MethodVerifier final : public ::art::verifier::MethodVerifier {
        verify_to_dump_(verify_to_dump),
        allow_thread_suspension_(reg_types->CanSuspend()),
        is_constructor_(false),
+       has_branches_(false),
        api_level_(api_level == 0 ? std::numeric_limits<uint32_t>::max() : api_level) {
     DCHECK_EQ(dex_cache->GetDexFile(), reg_types->GetDexFile())
         << dex_cache->GetDexFile()->GetLocation() << " / "
@@ -509,6 +516,12 @@ class MethodVerifier final : public ::art::verifier::MethodVerifier {
   template <bool kMonitorDexPCs>
   bool CodeFlowVerifyMethod() REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Code flow verification for methods without branches, switches and try blocks. Each
+  // instruction can only be reached from the previous one, so a single pass in code order
+  // visits all reachable instructions once, without any register line merges.
+  template <bool kMonitorDexPCs>
+  bool CodeFlowVerifyStraightLineMethod() REQUIRES_SHARED(Locks::mutator_lock_);
+
   /*
    * Perform verification for a single instruction.
    *
@@ -1094,6 +1107,10 @@ class MethodVerifier final : public ::art::verifier::MethodVerifier {
   // Note: this flag is only valid once Verify() has started.
   bool is_constructor_;
 
+  // Whether the method has branch or switch instructions. Only valid once the instructions
+  // have been verified.
+  bool has_branches_;
+
   // API level, for dependent checks. Note: we do not use '0' for unset here, to simplify checks.
   // Instead, unset level should correspond to max().
   const uint32_t api_level_;
@@ -1472,6 +1489,8 @@ bool MethodVerifier<kVerifierDebug>::VerifyInstructions() {
     } else if (inst->Opcode() == Instruction::CHECK_CAST) {
       // The dex-to-dex compiler wants type information to elide check-casts.
       GetModifiableInstructionFlags(dex_pc).SetCompileTimeInfoPoint();
+    } else if (inst->IsBranch() || inst->IsSwitch()) {
+      has_branches_ = true;
     }
   }
   return true;
@@ -1896,9 +1915,18 @@ bool MethodVerifier<kVerifierDebug>::VerifyCodeFlow() {
   flags_.have_pending_runtime_throw_failure_ = false;
 
   /* Perform code flow verification. */
-  bool res = LIKELY(monitor_enter_dex_pcs_ == nullptr)
-                 ? CodeFlowVerifyMethod</*kMonitorDexPCs=*/ false>()
-                 : CodeFlowVerifyMethod</*kMonitorDexPCs=*/ true>();
+  bool res;
+  if (!has_branches_ && code_item_accessor_.TriesSize() == 0u) {
+    gStraightLineMethodCount.fetch_add(1u, std::memory_order_relaxed);
+    res = LIKELY(monitor_enter_dex_pcs_ == nullptr)
+              ? CodeFlowVerifyStraightLineMethod</*kMonitorDexPCs=*/ false>()
+              : CodeFlowVerifyStraightLineMethod</*kMonitorDexPCs=*/ true>();
+  } else {
+    gCodeFlowMethodCount.fetch_add(1u, std::memory_order_relaxed);
+    res = LIKELY(monitor_enter_dex_pcs_ == nullptr)
+              ? CodeFlowVerifyMethod</*kMonitorDexPCs=*/ false>()
+              : CodeFlowVerifyMethod</*kMonitorDexPCs=*/ true>();
+  }
   if (UNLIKELY(!res)) {
     DCHECK_NE(failures_.size(), 0U);
     return false;
@@ -2265,6 +2293,45 @@ bool MethodVerifier<kVerifierDebug>::CodeFlowVerifyMethod() {
   return true;
 }
 
+template <bool kVerifierDebug>
+template <bool kMonitorDexPCs>
+bool MethodVerifier<kVerifierDebug>::CodeFlowVerifyStraightLineMethod() {
+  DCHECK(!has_branches_);
+  DCHECK_EQ(code_item_accessor_.TriesSize(), 0u);
+  const uint32_t insns_size = code_item_accessor_.InsnsSizeInCodeUnits();
+
+  // The first instruction is the only branch target, with the argument types.
+  work_line_->CopyFromLine(reg_table_.GetLine(0));
+  uint32_t insn_idx = 0u;
+  while (true) {
+    if (allow_thread_suspension_) {
+      self_->AllowThreadSuspension();
+    }
+    work_insn_idx_ = insn_idx;
+    if (kMonitorDexPCs && UNLIKELY(work_insn_idx_ == interesting_dex_pc_)) {
+      HandleMonitorDexPcsWorkLine(monitor_enter_dex_pcs_, work_line_.get());
+    }
+    uint32_t start_guess = insn_idx;
+    if (!CodeFlowVerifyInstruction(&start_guess)) {
+      std::string prepend(dex_file_->PrettyMethod(dex_method_idx_));
+      prepend += " failed to verify: ";
+      PrependToLastFailMessage(prepend);
+      return false;
+    }
+    GetModifiableInstructionFlags(insn_idx).SetVisited();
+    GetModifiableInstructionFlags(insn_idx).ClearChanged();
+    // The instruction marks the next one as changed if execution can continue there, as
+    // there is no register line to merge into.
+    const Instruction& inst = code_item_accessor_.InstructionAt(insn_idx);
+    uint32_t next_insn_idx = insn_idx + inst.SizeInCodeUnits();
+    if (next_insn_idx >= insns_size || !GetInstructionFlags(next_insn_idx).IsChanged()) {
+      break;
+    }
+    insn_idx = next_insn_idx;
+  }
+  return true;
+}
+
 // Setup a register line for the given return instruction.
 template <bool kVerifierDebug>
 static void AdjustReturnLine(MethodVerifier<kVerifierDebug>* verifier,
@@ -5098,6 +5165,12 @@ bool MethodVerifier<kVerifierDebug>::PotentiallyMarkRuntimeThrow() {
 }  // namespace
 }  // namespace impl
 
+void MethodVerifier::GetVerificationPathCounts(/*out*/ uint32_t* straight_line_count,
+                                               /*out*/ uint32_t* code_flow_count) {
+  *straight_line_count = gStraightLineMethodCount.load(std::memory_order_relaxed);
+  *code_flow_count = gCodeFlowMethodCount.load(std::memory_order_relaxed);
+}
+
 inline ClassLinker* MethodVerifier::GetClassLinker() const {
   return reg_types_.GetClassLinker();
 }
@@ -117,6 +117,11 @@ class MethodVerifier {
                                                           uint32_t dex_pc)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Get the number of methods verified so far in this process with a single straight-line
+  // pass, for methods without branches and try blocks, and with the full code flow analysis.
+  EXPORT static void GetVerificationPathCounts(/*out*/ uint32_t* straight_line_count,
+                                               /*out*/ uint32_t* code_flow_count);
+
   const DexFile& GetDexFile() const {
     DCHECK(dex_file_ != nullptr);
     return *dex_file_;
@@ -104,5 +104,21 @@ TEST_F(MethodVerifierTest, VerificationTimeMetrics) {
   ASSERT_GT(CounterValue(*class_verification_count), original_count);
 }
 
+// Make sure libcore has methods verified with each of the code flow verification paths.
+TEST_F(MethodVerifierTest, VerificationPathCounts) {
+  ScopedObjectAccess soa(Thread::Current());
+  ASSERT_TRUE(java_lang_dex_file_ != nullptr);
+  uint32_t original_straight_line_count;
+  uint32_t original_code_flow_count;
+  MethodVerifier::GetVerificationPathCounts(&original_straight_line_count,
+                                            &original_code_flow_count);
+  VerifyDexFile(*java_lang_dex_file_);
+  uint32_t straight_line_count;
+  uint32_t code_flow_count;
+  MethodVerifier::GetVerificationPathCounts(&straight_line_count, &code_flow_count);
+  ASSERT_GT(straight_line_count, original_straight_line_count);
+  ASSERT_GT(code_flow_count, original_code_flow_count);
+}
+
 }  // namespace verifier
 }  // namespace art
@@ -76,6 +76,19 @@ void VerifierDeps::MergeWith(std::unique_ptr<VerifierDeps> other,
   }
 }
 
+void VerifierDeps::TakeDexFileDeps(VerifierDeps* other, const DexFile& dex_file) {
+  DCHECK(other != nullptr);
+  auto my_it = dex_deps_.find(&dex_file);
+  auto other_it = other->dex_deps_.find(&dex_file);
+  DCHECK(my_it != dex_deps_.end());
+  DCHECK(other_it != other->dex_deps_.end());
+  // Outside the AOT compiler, extra strings are recorded in the `DexFileDeps` referencing
+  // them, see `GetIdFromString()`, so they move along.
+  DCHECK(Runtime::Current()->GetCompilerCallbacks() == nullptr);
+  my_it->second = std::move(other_it->second);
+  other->dex_deps_.erase(other_it);
+}
+
 VerifierDeps::DexFileDeps* VerifierDeps::GetDexFileDeps(const DexFile& dex_file) {
   auto it = dex_deps_.find(&dex_file);
   return (it == dex_deps_.end()) ? nullptr : it->second.get();
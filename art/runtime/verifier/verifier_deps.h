@@ -77,6 +77,11 @@ class VerifierDeps {
   EXPORT void MergeWith(std::unique_ptr<VerifierDeps> other,
                         const std::vector<const DexFile*>& dex_files);
 
+  // Replace the dependencies of `dex_file` with the ones recorded by `other`, which
+  // are moved out of `other`. Both `VerifierDeps` must contain `dex_file`. Not supported
+  // in the AOT compiler, which records extra strings in the main `VerifierDeps` only.
+  void TakeDexFileDeps(VerifierDeps* other, const DexFile& dex_file);
+
   // Record information that a class was verified.
   // Note that this function is different from MaybeRecordVerificationStatus() which
   // looks up thread-local VerifierDeps first.
@@ -88,6 +88,7 @@ ArtMethod* WellKnownClasses::java_lang_RuntimeException_init;
 ArtMethod* WellKnownClasses::java_lang_Short_valueOf;
 ArtMethod* WellKnownClasses::java_lang_StackOverflowError_init;
 ArtMethod* WellKnownClasses::java_lang_String_charAt;
+ArtMethod* WellKnownClasses::java_lang_String_valueOf;
 ArtMethod* WellKnownClasses::java_lang_Thread_dispatchUncaughtException;
 ArtMethod* WellKnownClasses::java_lang_Thread_init;
 ArtMethod* WellKnownClasses::java_lang_Thread_run;
@@ -597,6 +598,12 @@ void WellKnownClasses::InitFieldsAndMethodsOnly(JNIEnv* env) {
   ObjPtr<mirror::Class> j_l_String = GetClassRoot<mirror::String>(class_linker);
   java_lang_String_charAt = CacheMethod(
       j_l_String, /*is_static=*/ false, "charAt", "(I)C", pointer_size);
+  java_lang_String_valueOf = CacheMethod(
+      j_l_String,
+      /*is_static=*/ true,
+      "valueOf",
+      "(Ljava/lang/Object;)Ljava/lang/String;",
+      pointer_size);
 
   java_lang_Thread_dispatchUncaughtException = CacheMethod(
       j_l_Thread.Get(),
@@ -925,6 +932,7 @@ void WellKnownClasses::Clear() {
   java_lang_Short_valueOf = nullptr;
   java_lang_StackOverflowError_init = nullptr;
   java_lang_String_charAt = nullptr;
+  java_lang_String_valueOf = nullptr;
   java_lang_Thread_dispatchUncaughtException = nullptr;
   java_lang_Thread_init = nullptr;
   java_lang_Thread_run = nullptr;
@@ -134,6 +134,7 @@ struct EXPORT WellKnownClasses {
   static ArtMethod* java_lang_Short_valueOf;
   static ArtMethod* java_lang_StackOverflowError_init;  // Only for the declaring class.
   static ArtMethod* java_lang_String_charAt;
+  static ArtMethod* java_lang_String_valueOf;
   static ArtMethod* java_lang_Thread_dispatchUncaughtException;
   static ArtMethod* java_lang_Thread_init;
   static ArtMethod* java_lang_Thread_run;
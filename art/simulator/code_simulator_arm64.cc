@@ -48,6 +48,7 @@ CodeSimulatorArm64::CodeSimulatorArm64()
 
   simulator_ = new Simulator(decoder_, stdout, std::move(stack));
   simulator_->SetVectorLengthInBits(kArm64DefaultSVEVectorLength);
+  decoder_->AppendVisitor(&instruction_counter_);
 }
 
 CodeSimulatorArm64::~CodeSimulatorArm64() {
@@ -58,6 +59,7 @@ CodeSimulatorArm64::~CodeSimulatorArm64() {
 
 void CodeSimulatorArm64::RunFrom(intptr_t code_buffer) {
   DCHECK(kCanSimulate);
+  instruction_counter_.Reset();
   simulator_->RunFrom(reinterpret_cast<const Instruction*>(code_buffer));
 }
 
@@ -76,5 +78,10 @@ int64_t CodeSimulatorArm64::GetCReturnInt64() const {
   return simulator_->ReadXRegister(0);
 }
 
+uint64_t CodeSimulatorArm64::GetExecutedInstructionCount() const {
+  DCHECK(kCanSimulate);
+  return instruction_counter_.GetCount();
+}
+
 }  // namespace arm64
 }  // namespace art
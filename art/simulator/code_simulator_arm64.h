@@ -43,11 +43,31 @@ class CodeSimulatorArm64 : public CodeSimulator {
   int32_t GetCReturnInt32() const override;
   int64_t GetCReturnInt64() const override;
 
+  uint64_t GetExecutedInstructionCount() const override;
+
  private:
+  // A decoder visitor counting the instructions decoded, that is executed, by the simulator.
+  class InstructionCounter : public vixl::aarch64::DecoderVisitor {
+   public:
+    InstructionCounter() : count_(0u) {}
+
+    void Visit([[maybe_unused]] vixl::aarch64::Metadata* metadata,
+               [[maybe_unused]] const vixl::aarch64::Instruction* instr) override {
+      ++count_;
+    }
+
+    uint64_t GetCount() const { return count_; }
+    void Reset() { count_ = 0u; }
+
+   private:
+    uint64_t count_;
+  };
+
   CodeSimulatorArm64();
 
   vixl::aarch64::Decoder* decoder_;
   vixl::aarch64::Simulator* simulator_;
+  InstructionCounter instruction_counter_;
 
   // TODO: Enable CodeSimulatorArm64 for more host ISAs once Simulator supports them.
   static constexpr bool kCanSimulate = (kRuntimeISA == InstructionSet::kX86_64);
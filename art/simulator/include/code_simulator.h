@@ -35,6 +35,10 @@ class CodeSimulator {
   virtual int32_t GetCReturnInt32() const = 0;
   virtual int64_t GetCReturnInt64() const = 0;
 
+  // Get the number of instructions executed by the last `RunFrom()`. Unlike timings, this is
+  // deterministic, so it can be used to compare the code generated by different compilers.
+  virtual uint64_t GetExecutedInstructionCount() const = 0;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(CodeSimulator);
 };
@@ -0,0 +1,230 @@
+#!/usr/bin/python3
+#
+# Copyright (C) 2026 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+#
+# This script measures the compile throughput of dex2oat on the host. It compiles a fixed corpus
+# of dex/jar/apk files with every combination of the given compiler filters and thread counts,
+# using compile-jar.py, and reports:
+#  - the wall and cpu time and the number of compiled methods per second,
+#  - the OptimizingCompilerStats counters (--dump-stats),
+#  - the peak arena memory of the compiler driver,
+#  - the size of the output oat file.
+#
+# With --pass-timings, one more run of each combination is done with --dump-pass-timings to
+# report the time spent in each optimization pass. It is a separate run since dumping the timings
+# of every method slows down the compilation.
+#
+# The arena memory per ArenaAllocKind of the methods that use the most arena memory is only
+# reported by a dex2oat built with kArenaAllocatorCountAllocations set to true.
+#
+# Example:
+#   art/tools/dex2oat-benchmark.py --compiler-filter speed --compiler-filter speed-profile \
+#       --threads 1 --threads 8 --repeat 5 --json results.json --corpus corpus.txt
+#
+
+import argparse
+import collections
+import json
+import os
+import os.path
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+COMPILE_JAR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "compile-jar.py")
+
+# Strips the prefix of the host logging, e.g. "dex2oatd I 10-14 12:00:00 1 1 dex2oat.cc:2928] ".
+LOG_LINE_RE = re.compile(r"^\S+ [VDIWEF] \S+ \S+\s+\d+\s+\d+ \S+\] (.*)$")
+COMPLETION_RE = re.compile(r"^dex2oat took .* \(threads: \d+\) arena alloc=\S+ \((\d+)B\)")
+COMPILED_RE = re.compile(r"^Attempted compilation of (\d+) methods: \S+ \((\d+)\) compiled\.")
+OPT_STAT_RE = re.compile(r"^OptStat#(\S+): (\d+)$")
+PASS_TIMING_RE = re.compile(r"^\s+([\d.]+)(ns|us|ms|s)(?:/[\d.]+(?:ns|us|ms|s))? (\S+)$")
+ARENA_KIND_RE = re.compile(r"^(\S+)\s+(\d+)$")
+NS_PER_UNIT = {"ns": 1, "us": 1000, "ms": 1000 * 1000, "s": 1000 * 1000 * 1000}
+
+
+def parse_args():
+  parser = argparse.ArgumentParser(
+      description="measure the dex2oat compile throughput for a fixed corpus",
+      epilog="Unrecognized options are passed on to compile-jar.py unmodified.")
+  parser.add_argument(
+      "--compiler-filter",
+      action="append",
+      default=[],
+      help="compiler filter to measure, can be repeated. Defaults to speed")
+  parser.add_argument(
+      "--threads",
+      action="append",
+      type=int,
+      default=[],
+      help="number of dex2oat threads to measure, can be repeated. Defaults to 1")
+  parser.add_argument(
+      "--repeat",
+      action="store",
+      type=int,
+      default=3,
+      help="number of runs of each combination, the median is reported. Defaults to 3")
+  parser.add_argument(
+      "--pass-timings",
+      action="store_true",
+      default=False,
+      help="also report the time spent in each optimization pass")
+  parser.add_argument(
+      "--corpus",
+      action="store",
+      help="file listing the dex/jar/apk files of the corpus, one per line")
+  parser.add_argument(
+      "--json",
+      action="store",
+      type=argparse.FileType("w"),
+      default=None,
+      help="file to write the results to, in JSON")
+  parser.add_argument(
+      "dex_files", help="dex/jar/apk files of the corpus", nargs="*", metavar="DEX")
+  return parser.parse_known_args()
+
+
+def get_corpus(args):
+  corpus = list(args.dex_files)
+  if args.corpus is not None:
+    with open(args.corpus) as corpus_file:
+      for line in corpus_file:
+        line = line.strip()
+        if line and not line.startswith("#"):
+          corpus.append(line)
+  if not corpus:
+    sys.exit("No dex file to compile, use --corpus or pass the files on the command line.")
+  return corpus
+
+
+def get_log_messages(output):
+  for line in output.splitlines():
+    match = LOG_LINE_RE.match(line)
+    yield match.group(1) if match else line
+
+
+def compile_corpus(corpus, compiler_filter, threads, extra_args, dex2oat_args):
+  """Compiles the corpus once and returns the wall time in ns and the dex2oat log."""
+  with tempfile.TemporaryDirectory() as tmp_dir:
+    odex_file = os.path.join(tmp_dir, "corpus.odex")
+    command = [sys.executable, COMPILE_JAR, "--odex-file={}".format(odex_file)] + extra_args + [
+        "--compiler-filter={}".format(compiler_filter),
+        "-j{}".format(threads),
+    ] + dex2oat_args + corpus
+    start_ns = time.monotonic_ns()
+    res = subprocess.run(command, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    wall_ns = time.monotonic_ns() - start_ns
+    if res.returncode != 0:
+      sys.exit("Compilation failed:\n{}".format(res.stderr))
+    return wall_ns, os.path.getsize(odex_file), res.stderr
+
+
+def parse_run(output):
+  result = {"opt_stats": {}, "arena_peak_bytes": None, "compiled_methods": None}
+  for message in get_log_messages(output):
+    match = COMPLETION_RE.match(message)
+    if match:
+      result["arena_peak_bytes"] = int(match.group(1))
+      continue
+    match = COMPILED_RE.match(message)
+    if match:
+      result["compiled_methods"] = int(match.group(2))
+      continue
+    match = OPT_STAT_RE.match(message)
+    if match:
+      result["opt_stats"][match.group(1)] = int(match.group(2))
+  return result
+
+
+def parse_pass_timings(output):
+  """Sums the per-method timings of each pass, and keeps the peak arena memory of each kind."""
+  pass_ns = collections.Counter()
+  arena_kind_peak_bytes = {}
+  in_allocation_by_kind = False
+  for message in get_log_messages(output):
+    if message.startswith("===== Allocation by kind"):
+      in_allocation_by_kind = True
+      continue
+    if in_allocation_by_kind:
+      match = ARENA_KIND_RE.match(message)
+      if match:
+        kind, size = match.group(1), int(match.group(2))
+        arena_kind_peak_bytes[kind] = max(arena_kind_peak_bytes.get(kind, 0), size)
+        continue
+      in_allocation_by_kind = False
+    match = PASS_TIMING_RE.match(message)
+    if match:
+      pass_ns[match.group(3)] += int(float(match.group(1)) * NS_PER_UNIT[match.group(2)])
+  return dict(pass_ns), arena_kind_peak_bytes
+
+
+def run_benchmark(corpus, compiler_filter, threads, args, extra_args):
+  runs = []
+  for _ in range(args.repeat):
+    wall_ns, oat_size, output = compile_corpus(
+        corpus, compiler_filter, threads, extra_args, ["--dump-stats"])
+    run = parse_run(output)
+    run["wall_ns"] = wall_ns
+    run["oat_size"] = oat_size
+    runs.append(run)
+  wall_ns = statistics.median(run["wall_ns"] for run in runs)
+  last_run = runs[-1]
+  compiled_methods = last_run["compiled_methods"] or 0
+  result = {
+      "compiler_filter": compiler_filter,
+      "threads": threads,
+      "median_wall_ms": wall_ns / 1e6,
+      "compiled_methods": compiled_methods,
+      "methods_per_second": compiled_methods * 1e9 / wall_ns,
+      "arena_peak_bytes": max((run["arena_peak_bytes"] or 0) for run in runs),
+      "oat_size": last_run["oat_size"],
+      "opt_stats": last_run["opt_stats"],
+  }
+  if args.pass_timings:
+    _, _, output = compile_corpus(
+        corpus, compiler_filter, threads, extra_args, ["--dump-pass-timings"])
+    result["pass_ns"], result["arena_kind_peak_bytes"] = parse_pass_timings(output)
+  return result
+
+
+def print_result(result):
+  print("{compiler_filter} -j{threads}: {median_wall_ms:.1f}ms, {compiled_methods} methods, "
+        "{methods_per_second:.1f} methods/s, arena peak {arena_peak_bytes}B, "
+        "oat size {oat_size}B".format(**result))
+  for name, ns in sorted(result.get("pass_ns", {}).items(), key=lambda item: -item[1]):
+    print("  {:>12.3f}ms {}".format(ns / 1e6, name))
+  for kind, size in sorted(result.get("arena_kind_peak_bytes", {}).items()):
+    print("  {:>12}B {}".format(size, kind))
+
+
+def main():
+  args, extra_args = parse_args()
+  corpus = get_corpus(args)
+  results = []
+  for compiler_filter in args.compiler_filter or ["speed"]:
+    for threads in args.threads or [1]:
+      result = run_benchmark(corpus, compiler_filter, threads, args, extra_args)
+      print_result(result)
+      results.append(result)
+  if args.json is not None:
+    json.dump({"corpus": corpus, "repeat": args.repeat, "results": results}, args.json, indent=2)
+
+
+if __name__ == "__main__":
+  main()
@@ -16,10 +16,12 @@
 
 #include <android-base/file.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <set>
 #include <sstream>
+#include <thread>
 
 #include "base/mem_map.h"
 #include "dex/code_item_accessors-inl.h"
@@ -56,9 +58,11 @@ class DexAnalyze {
         << "    -analyze-strings (Analyze string data)\n"
         << "    -analyze-debug-info (Analyze debug info)\n"
         << "    -new-bytecode (Bytecode optimizations)\n"
+        << "    -decode-instructions (Time instruction decoding)\n"
         << "    -i (Ignore Dex checksum and verification failures)\n"
         << "    -a (Run all experiments)\n"
         << "    -n <int> (run experiment with 1 .. n as argument)\n"
+        << "    -j <int> (read and verify up to <int> input files in parallel)\n"
         << "    -d (Dump on per Dex basis)\n"
         << "    -v (quiet(0) to everything(2))\n";
     return kExitCodeUsageError;
@@ -93,6 +97,16 @@ class DexAnalyze {
           std::istringstream iss(argv[i + 1]);
           iss >> experiment_max_;
           ++i;
+        } else if (arg == "-j") {
+          if (i + 1 >= argc) {
+            return Usage(argv);
+          }
+          std::istringstream iss(argv[i + 1]);
+          iss >> thread_count_;
+          if (thread_count_ == 0u) {
+            return Usage(argv);
+          }
+          ++i;
         } else if (arg == "-count-indices") {
           exp_count_indices_ = true;
         } else if (arg == "-analyze-strings") {
@@ -101,6 +115,8 @@ class DexAnalyze {
           exp_debug_info_ = true;
         } else if (arg == "-new-bytecode") {
           exp_bytecode_ = true;
+        } else if (arg == "-decode-instructions") {
+          exp_decode_instructions_ = true;
         } else if (arg == "-d") {
           dump_per_input_dex_ = true;
         } else if (!arg.empty() && arg[0] == '-') {
@@ -125,11 +141,43 @@ class DexAnalyze {
     bool exp_analyze_strings_ = false;
     bool exp_debug_info_ = false;
     bool exp_bytecode_ = false;
+    bool exp_decode_instructions_ = false;
     bool run_all_experiments_ = false;
     uint64_t experiment_max_ = 1u;
+    size_t thread_count_ = 1u;
     std::vector<std::string> filenames_;
   };
 
+  // An input file, with the dex files opened from it.
+  struct InputFile {
+    std::string content;
+    std::vector<std::unique_ptr<const DexFile>> dex_files;
+    std::string error_msg;
+    int exit_code = 0;
+  };
+
+  static void OpenInputFile(const std::string& filename,
+                            const Options& options,
+                            /*out*/ InputFile* input) {
+    // TODO: once added, use an API to android::base to read a std::vector<uint8_t>.
+    if (!android::base::ReadFileToString(filename, &input->content)) {
+      input->error_msg = "ReadFileToString failed for " + filename;
+      input->exit_code = kExitCodeFailedToOpenFile;
+      return;
+    }
+    DexFileLoaderErrorCode error_code;
+    DexFileLoader dex_file_loader(
+        reinterpret_cast<const uint8_t*>(input->content.data()), input->content.size(), filename);
+    if (!dex_file_loader.Open(options.run_dex_file_verifier_,
+                              options.verify_checksum_,
+                              &error_code,
+                              &input->error_msg,
+                              &input->dex_files)) {
+      input->error_msg = "OpenAll failed for " + filename + " with " + input->error_msg;
+      input->exit_code = kExitCodeFailedToOpenDex;
+    }
+  }
+
   class Analysis {
    public:
     explicit Analysis(const Options* options) : options_(options) {
@@ -145,6 +193,9 @@ class DexAnalyze {
       if (options->run_all_experiments_ || options->exp_debug_info_) {
         experiments_.emplace_back(new AnalyzeDebugInfo);
       }
+      if (options->run_all_experiments_ || options->exp_decode_instructions_) {
+        experiments_.emplace_back(new DecodeInstructions);
+      }
       if (options->run_all_experiments_ || options->exp_bytecode_) {
         for (size_t i = 0; i < options->experiment_max_; ++i) {
           uint64_t exp_value = 0u;
@@ -197,37 +248,41 @@ class DexAnalyze {
       return result;
     }
 
-    DexFileLoaderErrorCode error_code;
-    std::string error_msg;
     Analysis cumulative(&options);
-    for (const std::string& filename : options.filenames_) {
-      std::string content;
-      // TODO: once added, use an API to android::base to read a std::vector<uint8_t>.
-      if (!android::base::ReadFileToString(filename, &content)) {
-        LOG(ERROR) << "ReadFileToString failed for " + filename << std::endl;
-        return kExitCodeFailedToOpenFile;
+    const std::vector<std::string>& filenames = options.filenames_;
+    // Read and verify the input files in batches of `thread_count_` files, as that is most of
+    // the time for large inputs, then run the experiments on them in the input order.
+    for (size_t begin = 0; begin < filenames.size(); begin += options.thread_count_) {
+      const size_t end = std::min(filenames.size(), begin + options.thread_count_);
+      std::vector<InputFile> inputs(end - begin);
+      std::vector<std::thread> threads;
+      for (size_t i = begin + 1; i < end; ++i) {
+        threads.emplace_back(OpenInputFile, std::cref(filenames[i]), std::cref(options),
+                             &inputs[i - begin]);
       }
-      std::vector<std::unique_ptr<const DexFile>> dex_files;
-      DexFileLoader dex_file_loader(
-          reinterpret_cast<const uint8_t*>(content.data()), content.size(), filename);
-      if (!dex_file_loader.Open(options.run_dex_file_verifier_,
-                                options.verify_checksum_,
-                                &error_code,
-                                &error_msg,
-                                &dex_files)) {
-        LOG(ERROR) << "OpenAll failed for " + filename << " with " << error_msg << std::endl;
-        return kExitCodeFailedToOpenDex;
+      OpenInputFile(filenames[begin], options, &inputs[0]);
+      for (std::thread& thread : threads) {
+        thread.join();
       }
-      if (options.dump_per_input_dex_) {
-        Analysis current(&options);
-        if (!current.ProcessDexFiles(dex_files)) {
-          LOG(ERROR) << "Failed to process " << filename << " with error " << error_msg;
-          return kExitCodeFailedToProcessDex;
+
+      for (size_t i = begin; i < end; ++i) {
+        const std::string& filename = filenames[i];
+        InputFile& input = inputs[i - begin];
+        if (input.exit_code != 0) {
+          LOG(ERROR) << input.error_msg << std::endl;
+          return input.exit_code;
+        }
+        if (options.dump_per_input_dex_) {
+          Analysis current(&options);
+          if (!current.ProcessDexFiles(input.dex_files)) {
+            LOG(ERROR) << "Failed to process " << filename;
+            return kExitCodeFailedToProcessDex;
+          }
+          LOG(INFO) << "Analysis for " << filename << std::endl;
+          current.Dump(LOG_STREAM(INFO));
         }
-        LOG(INFO) << "Analysis for " << filename << std::endl;
-        current.Dump(LOG_STREAM(INFO));
+        cumulative.ProcessDexFiles(input.dex_files);
       }
-      cumulative.ProcessDexFiles(dex_files);
     }
     LOG(INFO) << "Cumulative analysis for " << cumulative.dex_count_ << " DEX files" << std::endl;
     cumulative.Dump(LOG_STREAM(INFO));
@@ -24,10 +24,12 @@
 #include <vector>
 
 #include "android-base/stringprintf.h"
+#include "base/time_utils.h"
 #include "dex/class_accessor-inl.h"
 #include "dex/class_iterator.h"
 #include "dex/code_item_accessors-inl.h"
 #include "dex/dex_instruction-inl.h"
+#include "dex/dex_instruction_stream.h"
 #include "dex/standard_dex_file.h"
 #include "dex/utf-inl.h"
 
@@ -618,5 +620,53 @@ void CodeMetrics::Dump(std::ostream& os, uint64_t total_size) const {
   os << "Low arg savings: " << Percent(low_arg_total * 2, total_size) << "\n";
 }
 
+void DecodeInstructions::ProcessDexFile(const DexFile& dex_file) {
+  DexInstructionStream<> stream;
+  for (ClassAccessor accessor : dex_file.GetClasses()) {
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      const CodeItemInstructionAccessor instructions = method.GetInstructions();
+      uint64_t start = NanoTime();
+      for (size_t pass = 0; pass < kPasses; ++pass) {
+        for (const DexInstructionPcPair& inst : instructions) {
+          accessor_checksum_ += inst->Opcode();
+          accessor_checksum_ += inst->VRegA();
+          if (inst->HasVRegB()) {
+            accessor_checksum_ += inst->VRegB();
+          }
+          if (inst->HasVRegC()) {
+            accessor_checksum_ += inst->VRegC();
+          }
+        }
+      }
+      uint64_t decode_start = NanoTime();
+      accessor_ns_ += decode_start - start;
+      stream.Decode(instructions);
+      uint64_t stream_start = NanoTime();
+      stream_decode_ns_ += stream_start - decode_start;
+      for (size_t pass = 0; pass < kPasses; ++pass) {
+        for (size_t i = 0, size = stream.Size(); i != size; ++i) {
+          stream_checksum_ += stream.Opcode(i);
+          stream_checksum_ += stream.VRegA(i);
+          stream_checksum_ += stream.VRegB(i);
+          stream_checksum_ += stream.VRegC(i);
+        }
+      }
+      stream_ns_ += NanoTime() - stream_start;
+      instructions_ += stream.Size();
+    }
+  }
+}
+
+void DecodeInstructions::Dump(std::ostream& os, [[maybe_unused]] uint64_t total_size) const {
+  if (accessor_checksum_ != stream_checksum_) {
+    // Only expected for truncated code items, with `-i`.
+    os << "Decoded operands differ\n";
+  }
+  os << "Decoded instructions: " << instructions_ << " in " << kPasses << " passes\n";
+  os << "Accessor time: " << PrettyDuration(accessor_ns_) << "\n";
+  os << "Stream decode time: " << PrettyDuration(stream_decode_ns_) << "\n";
+  os << "Stream time: " << PrettyDuration(stream_ns_) << "\n";
+}
+
 }  // namespace dexanalyze
 }  // namespace art
@@ -172,6 +172,26 @@ class CodeMetrics : public Experiment {
   uint64_t move_result_savings_ = 0u;
 };
 
+// Compare the time spent reading instruction operands with the per-call accessors against
+// decoding each code item once into a `DexInstructionStream`. Analyses like the verifier visit
+// instructions several times, `kPasses` approximates that.
+class DecodeInstructions : public Experiment {
+ public:
+  void ProcessDexFile(const DexFile& dex_file) override;
+
+  void Dump(std::ostream& os, uint64_t total_size) const override;
+
+ private:
+  static constexpr size_t kPasses = 4;
+  uint64_t instructions_ = 0u;
+  uint64_t accessor_ns_ = 0u;
+  uint64_t stream_decode_ns_ = 0u;
+  uint64_t stream_ns_ = 0u;
+  // Sum of the operands, so that the compiler cannot drop the loops.
+  uint64_t accessor_checksum_ = 0u;
+  uint64_t stream_checksum_ = 0u;
+};
+
 }  // namespace dexanalyze
 }  // namespace art
 
@@ -138,19 +138,13 @@ static void DataDumpRequestCb(jvmtiEnv* jvmti) {
         class_counts[null_class_name]++;
       } else {
         CHECK_JVMTI(jvmti->SetTag(obj.get(), referenced_object_tag));
-        jlong size = 0;
-        if (obj.get() != nullptr) {
-          char* class_name_tmp;
-          ScopedLocalRef<jclass> obj_klass(env, env->GetObjectClass(obj.get()));
-          CHECK_JVMTI(jvmti->GetClassSignature(obj_klass.get(), &class_name_tmp, nullptr));
-          CHECK_JVMTI(jvmti->GetObjectSize(obj.get(), &size));
-          class_name = class_name_tmp;
-          CHECK_JVMTI(jvmti->Deallocate(reinterpret_cast<unsigned char*>(class_name_tmp)));
-        }
-        if (class_sizes.find(class_name) == class_counts.end()) {
-          class_sizes[class_name] = 0;
-          class_counts[class_name] = 0;
-        }
+        // The sizes are computed below, once per referenced object.
+        char* class_name_tmp;
+        ScopedLocalRef<jclass> obj_klass(env, env->GetObjectClass(obj.get()));
+        CHECK_JVMTI(jvmti->GetClassSignature(obj_klass.get(), &class_name_tmp, nullptr));
+        class_name = class_name_tmp;
+        CHECK_JVMTI(jvmti->Deallocate(reinterpret_cast<unsigned char*>(class_name_tmp)));
+        class_sizes.emplace(class_name, 0u);
         class_counts[class_name]++;
       }
     }
@@ -34,18 +34,27 @@ namespace art {
 void PreciseHiddenApiFinder::RunInternal(
     const std::vector<std::unique_ptr<VeridexResolver>>& resolvers,
     const ClassFilter& class_filter,
-    const std::function<void(VeridexResolver*, const ClassAccessor::Method&)>& action) {
+    const std::function<std::vector<ReflectAccessInfo>(
+        VeridexResolver*, const ClassAccessor::Method&)>& analysis) {
+  std::vector<std::pair<VeridexResolver*, ClassAccessor::Method>> methods;
   for (const std::unique_ptr<VeridexResolver>& resolver : resolvers) {
     for (ClassAccessor accessor : resolver->GetDexFile().GetClasses()) {
       if (class_filter.Matches(accessor.GetDescriptor())) {
         for (const ClassAccessor::Method& method : accessor.GetMethods()) {
           if (method.GetCodeItem() != nullptr) {
-            action(resolver.get(), method);
+            methods.emplace_back(resolver.get(), method);
           }
         }
       }
     }
   }
+  std::vector<std::vector<ReflectAccessInfo>> uses(methods.size());
+  ParallelFor(methods.size(), thread_count_, [&](size_t i) {
+    uses[i] = analysis(methods[i].first, methods[i].second);
+  });
+  for (size_t i = 0; i < methods.size(); ++i) {
+    AddUsesAt(uses[i], methods[i].second.GetReference());
+  }
 }
 
 void PreciseHiddenApiFinder::AddUsesAt(const std::vector<ReflectAccessInfo>& accesses,
@@ -64,10 +73,10 @@ void PreciseHiddenApiFinder::Run(const std::vector<std::unique_ptr<VeridexResolv
   // Collect reflection uses.
   RunInternal(resolvers,
               class_filter,
-              [this] (VeridexResolver* resolver, const ClassAccessor::Method& method) {
+              [] (VeridexResolver* resolver, const ClassAccessor::Method& method) {
     FlowAnalysisCollector collector(resolver, method);
     collector.Run();
-    AddUsesAt(collector.GetUses(), method.GetReference());
+    return collector.GetUses();
   });
 
   // For non-final reflection uses, do a limited fixed point calculation over the code to try
@@ -81,11 +90,11 @@ void PreciseHiddenApiFinder::Run(const std::vector<std::unique_ptr<VeridexResolv
         = std::move(abstract_uses_);
     RunInternal(resolvers,
                 class_filter,
-                [this, current_uses] (VeridexResolver* resolver,
-                                      const ClassAccessor::Method& method) {
+                [&current_uses] (VeridexResolver* resolver,
+                                 const ClassAccessor::Method& method) {
       FlowAnalysisSubstitutor substitutor(resolver, method, current_uses);
       substitutor.Run();
-      AddUsesAt(substitutor.GetUses(), method.GetReference());
+      return substitutor.GetUses();
     });
   }
 }
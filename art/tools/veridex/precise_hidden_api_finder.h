@@ -37,26 +37,31 @@ class VeridexResolver;
  */
 class PreciseHiddenApiFinder {
  public:
-  explicit PreciseHiddenApiFinder(const HiddenApi& hidden_api) : hidden_api_(hidden_api) {}
+  PreciseHiddenApiFinder(const HiddenApi& hidden_api, size_t thread_count)
+      : hidden_api_(hidden_api), thread_count_(thread_count) {}
 
   // Iterate over the dex files associated with the passed resolvers to report
-  // hidden API uses.
+  // hidden API uses. With more than one thread, all the resolvers must have been
+  // pre-resolved, see `VeridexResolver::PreResolve()`.
   void Run(const std::vector<std::unique_ptr<VeridexResolver>>& app_resolvers,
            const ClassFilter& app_class_filter);
 
   void Dump(std::ostream& os, HiddenApiStats* stats);
 
  private:
-  // Run over all methods of all dex files, and call `action` on each.
+  // Run over all methods of all dex files, call `analysis` on each, and add the uses it returns.
+  // The analyses run on `thread_count_` threads, but the uses are added in method order.
   void RunInternal(
       const std::vector<std::unique_ptr<VeridexResolver>>& resolvers,
       const ClassFilter& class_filter,
-      const std::function<void(VeridexResolver*, const ClassAccessor::Method&)>& action);
+      const std::function<std::vector<ReflectAccessInfo>(
+          VeridexResolver*, const ClassAccessor::Method&)>& analysis);
 
   // Add uses found in method `ref`.
   void AddUsesAt(const std::vector<ReflectAccessInfo>& accesses, MethodReference ref);
 
   const HiddenApi& hidden_api_;
+  const size_t thread_count_;
 
   std::map<MethodReference, std::vector<ReflectAccessInfo>> concrete_uses_;
   std::map<MethodReference, std::vector<ReflectAccessInfo>> abstract_uses_;
@@ -268,7 +268,9 @@ VeriMethod VeridexResolver::GetMethod(uint32_t method_index) {
     method_info = LookupMethodIn(*kls,
                                  dex_file_.GetMethodName(method_id),
                                  dex_file_.GetMethodSignature(method_id));
-    method_infos_[method_index] = method_info;
+    if (method_info != nullptr) {
+      method_infos_[method_index] = method_info;
+    }
   }
   return method_info;
 }
@@ -286,7 +288,9 @@ VeriField VeridexResolver::GetField(uint32_t field_index) {
     field_info = LookupFieldIn(*kls,
                                dex_file_.GetFieldName(field_id),
                                dex_file_.GetFieldTypeDescriptor(field_id));
-    field_infos_[field_index] = field_info;
+    if (field_info != nullptr) {
+      field_infos_[field_index] = field_info;
+    }
   }
   return field_info;
 }
@@ -311,4 +315,16 @@ void VeridexResolver::ResolveAll() {
   }
 }
 
+void VeridexResolver::PreResolve() {
+  for (uint32_t i = 0; i < dex_file_.NumTypeIds(); ++i) {
+    GetVeriClass(dex::TypeIndex(i));
+  }
+  for (uint32_t i = 0; i < dex_file_.NumMethodIds(); ++i) {
+    GetMethod(i);
+  }
+  for (uint32_t i = 0; i < dex_file_.NumFieldIds(); ++i) {
+    GetField(i);
+  }
+}
+
 }  // namespace art
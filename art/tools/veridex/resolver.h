@@ -74,6 +74,11 @@ class VeridexResolver {
   // Resolve all type_id/method_id/field_id.
   void ResolveAll();
 
+  // Resolve all type_id/method_id/field_id without reporting the unresolved ones. Once this
+  // has run for all resolvers, the lookups above do not modify the caches anymore, so they can
+  // be used from multiple threads.
+  void PreResolve();
+
   // The dex file this resolver is associated to.
   const DexFile& GetDexFile() const {
     return dex_file_;
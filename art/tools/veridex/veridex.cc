@@ -20,6 +20,7 @@
 #include <android-base/strings.h>
 
 #include <cstdlib>
+#include <iterator>
 #include <sstream>
 #include <string_view>
 
@@ -75,6 +76,7 @@ static const char* kImprecise = "--imprecise";
 static const char* kTargetSdkVersion = "--target-sdk-version=";
 static const char* kAppClassFilter = "--app-class-filter=";
 static const char* kExcludeApiListsOption = "--exclude-api-lists=";
+static const char* kThreadsOption = "--threads=";
 
 struct VeridexOptions {
   const char* dex_file = nullptr;
@@ -84,6 +86,7 @@ struct VeridexOptions {
   int target_sdk_version = 29; /* Q */
   std::vector<std::string> app_class_name_filter;
   std::vector<std::string> exclude_api_lists;
+  size_t thread_count = 1;
 };
 
 static const char* Substr(const char* str, int index) {
@@ -113,6 +116,8 @@ static void ParseArgs(VeridexOptions* options, int argc, char** argv) {
     } else if (arg.starts_with(kExcludeApiListsOption)) {
       options->exclude_api_lists = android::base::Split(
           Substr(argv[i], strlen(kExcludeApiListsOption)), ",");
+    } else if (arg.starts_with(kThreadsOption)) {
+      options->thread_count = std::max(atoi(Substr(argv[i], strlen(kThreadsOption))), 1);
     } else {
       LOG(ERROR) << "Unknown command line argument: " << argv[i];
     }
@@ -151,24 +156,20 @@ class Veridex {
 
     // Read the boot classpath.
     std::vector<std::string> boot_classpath = Split(options.core_stubs, ':');
-    boot_content.resize(boot_classpath.size());
-    uint32_t i = 0;
-    for (const std::string& str : boot_classpath) {
-      if (!Load(str, boot_content[i++], &boot_dex_files, &error_msg)) {
-        LOG(ERROR) << error_msg;
-        return 1;
-      }
+    if (!LoadAll(boot_classpath,
+                 options.thread_count,
+                 &boot_content,
+                 &boot_dex_files,
+                 &error_msg)) {
+      LOG(ERROR) << error_msg;
+      return 1;
     }
 
     // Read the apps dex files.
     std::vector<std::string> app_files = Split(options.dex_file, ':');
-    app_content.resize(app_files.size());
-    i = 0;
-    for (const std::string& str : app_files) {
-      if (!Load(str, app_content[i++], &app_dex_files, &error_msg)) {
-        LOG(ERROR) << error_msg;
-        return 1;
-      }
+    if (!LoadAll(app_files, options.thread_count, &app_content, &app_dex_files, &error_msg)) {
+      LOG(ERROR) << error_msg;
+      return 1;
     }
 
     // Resolve classes/methods/fields defined in each dex file.
@@ -248,7 +249,16 @@ class Veridex {
     api_finder.Dump(std::cout, &stats, !options.precise);
 
     if (options.precise) {
-      PreciseHiddenApiFinder precise_api_finder(hidden_api);
+      if (options.thread_count > 1u) {
+        // Fill the resolver caches up front, so that the flow analysis only reads them.
+        for (const std::unique_ptr<VeridexResolver>& resolver : boot_resolvers) {
+          resolver->PreResolve();
+        }
+        for (const std::unique_ptr<VeridexResolver>& resolver : app_resolvers) {
+          resolver->PreResolve();
+        }
+      }
+      PreciseHiddenApiFinder precise_api_finder(hidden_api, options.thread_count);
       precise_api_finder.Run(app_resolvers, app_class_filter);
       precise_api_finder.Dump(std::cout, &stats);
     }
@@ -317,6 +327,30 @@ class Veridex {
     return true;
   }
 
+  // Load `filenames` on up to `thread_count` threads. The dex files are added in the order of
+  // `filenames`, as with sequential calls to `Load()`.
+  static bool LoadAll(const std::vector<std::string>& filenames,
+                      size_t thread_count,
+                      /*out*/ std::vector<std::string>* contents,
+                      /*out*/ std::vector<std::unique_ptr<const DexFile>>* dex_files,
+                      /*out*/ std::string* error_msg) {
+    contents->resize(filenames.size());
+    std::vector<std::vector<std::unique_ptr<const DexFile>>> loaded(filenames.size());
+    std::vector<std::string> error_msgs(filenames.size());
+    std::vector<uint8_t> success(filenames.size());
+    ParallelFor(filenames.size(), thread_count, [&](size_t i) {
+      success[i] = Load(filenames[i], (*contents)[i], &loaded[i], &error_msgs[i]);
+    });
+    for (size_t i = 0; i < filenames.size(); ++i) {
+      if (!success[i]) {
+        *error_msg = std::move(error_msgs[i]);
+        return false;
+      }
+      std::move(loaded[i].begin(), loaded[i].end(), std::back_inserter(*dex_files));
+    }
+    return true;
+  }
+
   static void Resolve(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
                       DexResolverMap& resolver_map,
                       TypeMap& type_map,
@@ -17,7 +17,11 @@
 #ifndef ART_TOOLS_VERIDEX_VERIDEX_H_
 #define ART_TOOLS_VERIDEX_VERIDEX_H_
 
+#include <algorithm>
+#include <atomic>
 #include <map>
+#include <thread>
+#include <vector>
 
 #include "dex/primitive.h"
 
@@ -29,6 +33,29 @@ struct ClassDef;
 
 static int gTargetSdkVersion = 1000;  // Will be initialized after parsing options.
 
+/**
+ * Calls `fn(i)` for each `i` in [0, count) on up to `thread_count` threads, including the
+ * calling one. The indexes are handed out dynamically, so `fn` must write its results to
+ * per-index storage for the caller to merge in order.
+ */
+template <typename Fn>
+void ParallelFor(size_t count, size_t thread_count, const Fn& fn) {
+  std::atomic<size_t> next(0u);
+  auto worker = [&]() {
+    for (size_t i = next.fetch_add(1u); i < count; i = next.fetch_add(1u)) {
+      fn(i);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < std::min(thread_count, count); ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
 /**
  * Abstraction for fields defined in dex files. Currently, that's a pointer into their
  * `encoded_field` description.